@@ -25,11 +25,19 @@ public:
     void setAuthToken(const QString& token);
     void setCapabilities(const QJsonObject& capabilities);
     void setTlsEnabled(bool enabled, const QString& caCertificateFile = {});
+    // Offer length-prefixed binary frames at registration (default on). Used
+    // only when the master accepts; frame reports are then sent in batches.
+    void setBinaryProtocolEnabled(bool enabled);
+    bool binaryProtocolActive() const;
 
     using JobAssignedCallback = std::function<void(const QJsonObject& jobData)>;
+    // revision: jobId, chunkId and the chunk's new startFrame/endFrame/step.
+    // Frames at or past endFrame were handed to another worker; skip them.
+    using JobRevisedCallback = std::function<void(const QJsonObject& revision)>;
     using DisconnectedCallback = std::function<void()>;
 
     void setOnJobAssigned(JobAssignedCallback cb);
+    void setOnJobRevised(JobRevisedCallback cb);
     void setOnDisconnected(DisconnectedCallback cb);
 
     bool sendFrameCompleted(int frame);
@@ -37,6 +45,8 @@ public:
     bool sendWorkerProgress(int completedFrames, int failedFrames, int currentFrame,
                             qint64 renderTimeMs = 0);
     bool sendWorkerLog(const QString& severity, const QString& message, int frame = -1);
+    // Asks the master for the next chunk once the current one is done.
+    bool requestFrames();
 
 private:
     class Impl;
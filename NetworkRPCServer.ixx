@@ -54,6 +54,9 @@ public:
     // Farm-specific RPC
     QString callWorker(const QString& workerId, const QString& method, const QJsonObject& params);
     bool sendJobAssignment(const QString& workerId, const QJsonObject& jobJson);
+    // Shrinks a chunk already assigned to the worker ("reviseJob");
+    // withdrawnFrames are taken off its assigned frame count.
+    bool sendJobRevision(const QString& workerId, const QJsonObject& revision, int withdrawnFrames);
     QJsonObject requestWorkerStatus(const QString& workerId);
 
     // Callbacks
@@ -63,6 +66,9 @@ public:
     void setOnRequest(RpcRequestHandler handler);
     void setHttpStatusProvider(HttpStatusProvider provider);
     void setAuthToken(const QString& token);
+    // Lets workers that offer it switch to length-prefixed binary frames
+    // after registration (default on). JSON workers are unaffected.
+    void setBinaryProtocolEnabled(bool enabled);
     bool setWorkerMaintenance(const QString& workerId, bool maintenance);
     bool startHttpApi(unsigned short port = 0);
     void stopHttpApi();
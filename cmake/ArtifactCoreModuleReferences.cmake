@@ -299,6 +299,7 @@ set(ARTIFACTCORE_IMPLEMENTATION_MODULE_REFERENCES
     "src/Math/ArtifactMinMax.cppm|Math.ArtifactMinMax|include/Math/ArtifactMinMax.ixx"
     "src/Math/Interpolate.cppm|Math.Interpolate|include/Geometry/Interpolate.ixx"
     "src/Math/NoiseGenerator.cppm|Math.Noise|include/Math/NoiseGenerator.ixx"
+    "src/Math/NoiseGenerator.cppm|Script.Expression.MemoCache|include/Script/Expression/ExpressionMemoCache.ixx"
     "src/Math/Rotation.cppm|Math.Rotation|include/Math/Rotation.ixx"
     "src/Math/RotationTurns.cppm|Math.RotationTurns|include/Geometry/RotationTurns.ixx"
     "src/Media/ImageSequenceSource.cppm|Media.ImageSequenceSource|include/Media/ImageSequenceSource.ixx"
@@ -317,6 +318,7 @@ set(ARTIFACTCORE_IMPLEMENTATION_MODULE_REFERENCES
     "src/Network/CollaborationWebSocket.cppm|Network.CollaborationWebSocket|include/Network/CollaborationWebSocket.ixx"
     "src/Network/NetworkRPCClient.cppm|NetworkRPCClient|NetworkRPCClient.ixx"
     "src/Network/NetworkRPCServer.cppm|NetworkRPCServer|NetworkRPCServer.ixx"
+    "src/Network/RpcWireCodec.cppm|Network.RpcWire|include/Network/RpcWireCodec.ixx"
     "src/Particle/ParticleSystem.cppm|Particle.System|include/Particle/ParticleSystem.ixx"
     "src/Physics/FluidSolver2D.cppm|Physics.Fluid|include/Physics/FluidSolver2D.ixx"
     "src/Physics/FractureEngine.cppm|Physics.Fracture|include/Physics/FractureEngine.ixx"
@@ -343,6 +345,7 @@ set(ARTIFACTCORE_IMPLEMENTATION_MODULE_REFERENCES
     "src/Render/NoiseField.cppm|Render.NoiseField|include/Render/NoiseField.ixx"
     "src/Render/ProgressAggregator.cppm|Render.Farm.Progress|include/Render/ProgressAggregator.ixx"
     "src/Render/RenderFarmMaster.cppm|Render.Farm.Master|include/Render/RenderFarmMaster.ixx"
+    "src/Render/RenderFarmScheduler.cppm|Render.Farm.Scheduler|include/Render/RenderFarmScheduler.ixx"
     "src/Render/RenderFarmWorker.cppm|Render.Farm.Worker|include/Render/RenderFarmWorker.ixx"
     "src/Render/RenderJobModel.cppm|Render.JobModel|include/Render/RenderJobModel.ixx"
     "src/Render/RenderStatics.cppm|Render.Statics|include/Render/RenderStatics.ixx"
@@ -365,7 +368,9 @@ set(ARTIFACTCORE_IMPLEMENTATION_MODULE_REFERENCES
     "src/Script/Engine/Func/BuiltinManager.cppm|Script.Builtin.Manager|include/Script/Engine/Func/BuiltinManager.ixx"
     "src/Script/Engine/Func/ExprIntrinsics.cppm|Script.Intrinsics|include/Script/Engine/Func/ExprIntrinsics.ixx"
     "src/Script/Engine/Syntax/ASTNode.cppm|ASTNode|include/Script/Engine/Syntax/ASTNode.ixx"
+    "src/Script/Expression/ExpressionBytecode.cppm|Script.Expression.Bytecode|include/Script/Expression/ExpressionBytecode.ixx"
     "src/Script/Expression/ExpressionEvaluator.cppm|Script.Expression.Evaluator|include/Script/Expression/ExpressionEvaluator.ixx"
+    "src/Script/Expression/ExpressionMemoCache.cppm|Script.Expression.MemoCache|include/Script/Expression/ExpressionMemoCache.ixx"
     "src/Script/Expression/ExpressionParser.cppm|Script.Expression.Parser|include/Script/Expression/ExpressionParser.ixx"
     "src/Script/Expression/ExpressionValue.cppm|Script.Expression.Value|include/Script/Expression/ExpressionValue.ixx"
     "src/Script/Python/CorePythonAPI.cppm|Script.Python.CoreAPI|include/Script/Python/CorePythonAPI.ixx"
@@ -374,6 +379,7 @@ set(ARTIFACTCORE_IMPLEMENTATION_MODULE_REFERENCES
     "src/ShaderNode/ArtifactShaderNode.cppm|Artifact.ShaderNode.Core|include/ShaderNode/ArtifactShaderNode.ixx"
     "src/Simulation/OpenVDBVolumeReference.cppm|Core.Simulation.OpenVDBVolumeReference|include/Simulation/OpenVDBVolumeReference.ixx"
     "src/Simulation/PyroSimulation.cppm|Core.Simulation.Pyro|include/Simulation/PyroSimulation.ixx"
+    "src/Simulation/PyroCache.cppm|Core.Simulation.Pyro|include/Simulation/PyroSimulation.ixx"
     "src/Source/ISource.cppm|Source.ISource|include/Source/ISource.ixx"
     "src/Text/GlyphAtlas.cppm|Text.GlyphAtlas|include/Text/GlyphAtlas.ixx"
     "src/Text/GlyphLayout.cppm|Text.GlyphLayout|include/Text/GlyphLayout.ixx"
@@ -496,6 +502,9 @@ set(ARTIFACTCORE_IMPLEMENTATION_IMPORTED_MODULE_REFERENCES
     "src/Layer/Layer2D.cppm|Transform|src/Animation/TransformModule.ixx"
     "src/Layer/Layer2D.cppm|Transform._2D|include/Transform/StaticTransform2D.ixx"
     "src/Render/RenderFarmMaster.cppm|NetworkRPCServer|NetworkRPCServer.ixx"
+    "src/Network/NetworkRPCServer.cppm|Network.RpcWire|include/Network/RpcWireCodec.ixx"
+    "src/Network/NetworkRPCClient.cppm|Network.RpcWire|include/Network/RpcWireCodec.ixx"
+    "src/Render/RenderFarmMaster.cppm|Render.Farm.Scheduler|include/Render/RenderFarmScheduler.ixx"
     "src/Transform/TransformHelper.cppm|Transform|src/Animation/TransformModule.ixx"
     "src/Transform/TransformHelper.cppm|Transform._2D|include/Transform/StaticTransform2D.ixx"
     "src/Asset/ImageAsset.cppm|Asset.File|include/Asset/AbstractAssetFile.ixx"
@@ -558,6 +567,8 @@ set(ARTIFACTCORE_IMPLEMENTATION_IMPORTED_MODULE_REFERENCES
     "src/Audio/AudioAnalyzer.cppm|Audio.Segment|include/Audio/AudioSegment.ixx"
     "src/Audio/AudioAnalyzer.cppm|Container.NamedVector|include/Container/NamedVector.ixx"
     "src/Audio/AudioAnalyzer.cppm|Container.Debug|include/Container/ContainerDebug.ixx"
+    "src/Audio/AudioAnalyzer.cppm|Core.Parallel|include/Common/Parallel.ixx"
+    "src/Audio/AudioAnalyzer.cppm|Math.ArtifactMinMax|include/Math/ArtifactMinMax.ixx"
     "src/Audio/AudioBassTreble.cppm|Audio.Effect|include/Audio/AudioEffect.ixx"
     "src/Audio/AudioBassTreble.cppm|Audio.Segment|include/Audio/AudioSegment.ixx"
     "src/Audio/AudioBassTreble.cppm|Core.ArtifactString|include/Core/ArtifactString.ixx"
@@ -599,6 +610,7 @@ set(ARTIFACTCORE_IMPLEMENTATION_IMPORTED_MODULE_REFERENCES
     "src/Audio/AudioMixer.cppm|Audio.Panner|include/Audio/AudioPanner.ixx"
     "src/Audio/AudioMixer.cppm|Audio.Effect|include/Audio/AudioEffect.ixx"
     "src/Audio/AudioMixer.cppm|Container.Debug|include/Container/ContainerDebug.ixx"
+    "src/Audio/AudioMixer.cppm|ArtifactCore.Utils.PerformanceProfiler|include/Utils/PerformanceProfiler.ixx"
     "src/Audio/AudioPanner.cppm|Audio.Segment|include/Audio/AudioSegment.ixx"
     "src/Audio/AudioParametricEQ.cppm|Audio.Effect|include/Audio/AudioEffect.ixx"
     "src/Audio/AudioParametricEQ.cppm|Audio.Segment|include/Audio/AudioSegment.ixx"
@@ -535,6 +535,7 @@ set(ARTIFACTCORE_MODULE_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../include/Memory/ArtifactAllocators.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Mesh/Mesh.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Network/CollaborationWebSocket.ixx"
+    "${CMAKE_CURRENT_LIST_DIR}/../include/Network/RpcWireCodec.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/NLE/Core.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/NLE/OTIO.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Particle/Particle.ixx"
@@ -592,6 +593,7 @@ set(ARTIFACTCORE_MODULE_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../include/Render/RendererQueueManager.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Render/RendererQueueSetting.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Render/RenderFarmMaster.ixx"
+    "${CMAKE_CURRENT_LIST_DIR}/../include/Render/RenderFarmScheduler.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Render/RenderFarmTypes.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Render/RenderFarmWorker.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Render/RenderJobModel.ixx"
@@ -622,7 +624,9 @@ set(ARTIFACTCORE_MODULE_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Engine/Syntax/Evaluator.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Engine/Value/Lexer.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Engine/Value/Value.ixx"
+    "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Expression/ExpressionBytecode.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Expression/ExpressionEvaluator.ixx"
+    "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Expression/ExpressionMemoCache.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Expression/ExpressionParser.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Expression/ExpressionValue.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Script/Python/CorePythonAPI.ixx"
@@ -650,6 +654,7 @@ set(ARTIFACTCORE_MODULE_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../include/Shape/TrimPaths.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Simulation/OpenVDBVolumeReference.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Simulation/PyroSimulation.ixx"
+    "${CMAKE_CURRENT_LIST_DIR}/../include/Simulation/PyroCacheCodec.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Sound/SoundTrack.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Sound/SoundType.ixx"
     "${CMAKE_CURRENT_LIST_DIR}/../include/Source/ISource.ixx"
@@ -806,6 +811,7 @@ set(ARTIFACTCORE_MODULE_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../src/Control/ArtifactExternalControlManager.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Core/ArtifactAtomic.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Core/ArtifactHashMap.cppm"
+    "${CMAKE_CURRENT_LIST_DIR}/../src/Core/ArtifactHashMap.Test.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Core/ArtifactOptional.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Diagnostic/DiagnosticRegistry.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Diagnostics/CoreDiagnostic.Test.cppm"
@@ -820,6 +826,8 @@ set(ARTIFACTCORE_MODULE_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../src/Shape/ShapeGroup.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Shape/ShapeLayer.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Shape/ShapePath.cppm"
+    "${CMAKE_CURRENT_LIST_DIR}/../src/Simulation/PyroCache.Test.cppm"
+    "${CMAKE_CURRENT_LIST_DIR}/../src/Simulation/PyroSimulation.Test.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Tracking/CameraTracker.cppm"
 )
 
@@ -1142,6 +1150,7 @@ set(ARTIFACTCORE_IMPL_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../src/Network/CollaborationWebSocket.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Network/NetworkRPCClient.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Network/NetworkRPCServer.cppm"
+    "${CMAKE_CURRENT_LIST_DIR}/../src/Network/RpcWireCodec.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/NLE/Core.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/NLE/OTIO.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Particle/ParticleSystem.cppm"
@@ -1174,6 +1183,7 @@ set(ARTIFACTCORE_IMPL_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../src/Render/RendererQueueManager.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Render/RendererQueueSetting.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Render/RenderFarmMaster.cppm"
+    "${CMAKE_CURRENT_LIST_DIR}/../src/Render/RenderFarmScheduler.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Render/RenderFarmWorker.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Render/RenderJobModel.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Render/RenderStatics.cppm"
@@ -1193,7 +1203,9 @@ set(ARTIFACTCORE_IMPL_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Engine/Func/BuiltinManager.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Engine/Func/ExprIntrinsics.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Engine/Syntax/ASTNode.cppm"
+    "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Expression/ExpressionBytecode.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Expression/ExpressionEvaluator.cppm"
+    "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Expression/ExpressionMemoCache.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Expression/ExpressionParser.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Expression/ExpressionValue.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Script/Python/CorePythonAPI.cppm"
@@ -1202,6 +1214,7 @@ set(ARTIFACTCORE_IMPL_SOURCES
     "${CMAKE_CURRENT_LIST_DIR}/../src/ShaderNode/ArtifactShaderNode.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Simulation/OpenVDBVolumeReference.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Simulation/PyroSimulation.cppm"
+    "${CMAKE_CURRENT_LIST_DIR}/../src/Simulation/PyroCache.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Source/ISource.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Text/GlyphAtlas.cppm"
     "${CMAKE_CURRENT_LIST_DIR}/../src/Text/GlyphLayout.cppm"
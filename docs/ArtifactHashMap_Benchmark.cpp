@@ -0,0 +1,107 @@
+// ArtifactHashMap: flat open addressing vs. std::unordered_map / QHash
+
+/*
+Inserts, looks up (hit and miss) and erases N keys of the types the per-frame
+lookups actually use: LayerID / AssetID (16-byte UUIDs hashed through qHash)
+and QString property names. For QString it also looks up through QStringView
+with ArtifactTransparentHash, which skips building a temporary QString.
+Every map is reserved up front so the numbers show probing, not growth.
+
+#include <chrono>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+#include <QHash>
+#include <QString>
+import Core.ArtifactHashMap;
+import Utils.Id;
+
+using namespace ArtifactCore;
+
+namespace {
+
+volatile std::size_t g_sink = 0;
+
+template <typename F>
+double nsPerOp(std::size_t ops, F&& body) {
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    return std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count() / double(ops);
+}
+
+struct IdStdHash {
+    std::size_t operator()(const Id& id) const noexcept { return qHash(id, 0u); }
+};
+
+template <typename Map, typename Key>
+void run(const char* label, const std::vector<Key>& keys, const std::vector<Key>& missing) {
+    Map map;
+    map.reserve(keys.size());
+    const std::size_t n = keys.size();
+    const double insert = nsPerOp(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) map[keys[i]] = int(i);
+    });
+    const double hit = nsPerOp(n, [&] {
+        std::size_t sum = 0;
+        for (const auto& key : keys) sum += map.contains(key) ? 1 : 0;
+        g_sink = sum;
+    });
+    const double miss = nsPerOp(n, [&] {
+        std::size_t sum = 0;
+        for (const auto& key : missing) sum += map.contains(key) ? 1 : 0;
+        g_sink = sum;
+    });
+    const double erase = nsPerOp(n, [&] {
+        for (const auto& key : keys) map.remove(key);
+    });
+    std::printf("  %-26s insert %6.1f  hit %6.1f  miss %6.1f  erase %6.1f ns\n",
+        label, insert, hit, miss, erase);
+}
+
+// Adapts the std / Artifact spelling to the QHash one used by run().
+template <typename Base>
+struct StdNames : Base {
+    template <typename K> bool contains(const K& key) const { return this->find(key) != this->end(); }
+    template <typename K> void remove(const K& key) { this->erase(key); }
+};
+
+}
+
+int main() {
+    for (std::size_t n : {1000u, 100000u, 1000000u}) {
+        std::printf("N = %zu\n", n);
+
+        std::vector<LayerID> layers(n), otherLayers(n);
+        run<StdNames<std::unordered_map<LayerID, int, IdStdHash>>>("unordered_map<LayerID>", layers, otherLayers);
+        run<QHash<LayerID, int>>("QHash<LayerID>", layers, otherLayers);
+        run<StdNames<ArtifactHashMap<LayerID, int>>>("ArtifactHashMap<LayerID>", layers, otherLayers);
+
+        std::vector<AssetID> assets(n), otherAssets(n);
+        run<StdNames<ArtifactHashMap<AssetID, int>>>("ArtifactHashMap<AssetID>", assets, otherAssets);
+
+        std::vector<QString> names(n), otherNames(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            names[i] = QStringLiteral("layer_%1/transform/position").arg(i);
+            otherNames[i] = QStringLiteral("layer_%1/effects/blur").arg(i);
+        }
+        run<StdNames<std::unordered_map<QString, int>>>("unordered_map<QString>", names, otherNames);
+        run<QHash<QString, int>>("QHash<QString>", names, otherNames);
+        run<StdNames<ArtifactHashMap<QString, int, ArtifactTransparentHash>>>("ArtifactHashMap<QString>", names, otherNames);
+
+        ArtifactHashMap<QString, int, ArtifactTransparentHash> byName;
+        byName.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) byName[names[i]] = int(i);
+        const double viewHit = nsPerOp(n, [&] {
+            std::size_t sum = 0;
+            for (const auto& name : names) sum += byName.find(QStringView(name))->second;
+            g_sink = sum;
+        });
+        std::printf("  %-26s hit %6.1f ns\n", "find(QStringView)", viewHit);
+    }
+    return 0;
+}
+
+This file is a harness only; it contains no measured results. Correctness of
+insert/erase/tombstone reuse/rehash is covered by src/Core/ArtifactHashMap.Test.cppm.
+*/
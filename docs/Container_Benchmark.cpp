@@ -0,0 +1,153 @@
+// Container: NamedVector / SmallVector / IdMap against the std containers
+
+/*
+Runs push / emplace / erase / lookup loops over each container with both
+debug policies and over std::vector / std::unordered_map, and prints ns per
+operation. ContainerDebugEnabled is what a Debug build gets by default;
+ContainerDebugDisabled is what Release gets (ARTIFACT_CONTAINER_DEBUG=0).
+Build it optimized: the point is what the disabled policy leaves behind.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+import Container;
+
+using namespace ArtifactCore;
+
+namespace {
+
+constexpr int kCount = 1 << 20;
+volatile std::size_t g_sink = 0;
+
+template <typename F>
+void measure(const char* label, int ops, F&& body) {
+    const auto start = std::chrono::steady_clock::now();
+    body();
+    const auto ns = std::chrono::duration<double, std::nano>(
+        std::chrono::steady_clock::now() - start).count();
+    std::printf("  %-28s %7.2f ns/op\n", label, ns / ops);
+}
+
+template <typename Vector>
+void vectorSuite(const char* title) {
+    std::printf("%s (sizeof %zu)\n", title, sizeof(Vector));
+    Vector values;
+    measure("push", kCount, [&] {
+        for (int i = 0; i < kCount; ++i) {
+            if constexpr (requires { values.push_back(i); }) values.push_back(i);
+            else values.add(i);
+        }
+    });
+    measure("indexed read", kCount, [&] {
+        std::size_t sum = 0;
+        for (int round = 0; round < 4; ++round) {
+            for (std::size_t i = 0; i < values.size(); ++i) sum += values.data()[i];
+        }
+        g_sink = sum;
+    });
+    measure("size() in loop condition", kCount, [&] {
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < values.size(); ++i) ++n;
+        g_sink = n;
+    });
+    measure("pop back", kCount, [&] {
+        for (int i = 0; i < kCount; ++i) {
+            if constexpr (requires { values.pop_back(); }) values.pop_back();
+            else values.popBack();
+        }
+    });
+}
+
+template <typename Vector>
+void smallSuite(const char* title) {
+    // The typical SmallVector use: many short-lived lists that stay inline.
+    std::printf("%s (sizeof %zu)\n", title, sizeof(Vector));
+    measure("build 4 + destroy", kCount, [&] {
+        std::size_t sum = 0;
+        for (int i = 0; i < kCount; ++i) {
+            Vector values;
+            for (int j = 0; j < 4; ++j) {
+                if constexpr (requires { values.emplace_back(j); }) values.emplace_back(j);
+                else values.make(j);
+            }
+            sum += values.size();
+        }
+        g_sink = sum;
+    });
+    measure("erase front of 16", kCount / 16, [&] {
+        for (int i = 0; i < kCount / 256; ++i) {
+            Vector values;
+            for (int j = 0; j < 16; ++j) {
+                if constexpr (requires { values.push_back(j); }) values.push_back(j);
+                else values.add(j);
+            }
+            for (int j = 0; j < 16; ++j) {
+                if constexpr (requires { values.erase(values.begin()); }) values.erase(values.begin());
+                else values.removeAt(0);
+            }
+        }
+    });
+}
+
+template <typename Map>
+void mapSuite(const char* title) {
+    std::printf("%s (sizeof %zu)\n", title, sizeof(Map));
+    Map map;
+    map.reserve(kCount);
+    measure("insert", kCount, [&] {
+        for (int i = 0; i < kCount; ++i) {
+            if constexpr (requires { map.try_emplace(i, i); }) map.try_emplace(i, i);
+            else map.tryEmplace(i, i);
+        }
+    });
+    measure("lookup hit", kCount, [&] {
+        std::size_t sum = 0;
+        for (int i = 0; i < kCount; ++i) {
+            if constexpr (requires { map.find(i); }) sum += map.find(i)->second;
+            else sum += *map.at(i);
+        }
+        g_sink = sum;
+    });
+    measure("lookup miss", kCount, [&] {
+        std::size_t hits = 0;
+        for (int i = kCount; i < 2 * kCount; ++i) hits += map.contains(i) ? 1 : 0;
+        g_sink = hits;
+    });
+    measure("erase", kCount, [&] {
+        for (int i = 0; i < kCount; ++i) {
+            if constexpr (requires { map.erase(i); }) map.erase(i);
+            else map.remove(i);
+        }
+    });
+}
+
+}
+
+int main() {
+    vectorSuite<std::vector<int>>("std::vector<int>");
+    vectorSuite<NamedVector<int, ContainerDebugEnabled>>("NamedVector<int> debug");
+    vectorSuite<NamedVector<int, ContainerDebugDisabled>>("NamedVector<int> release");
+
+    smallSuite<std::vector<int>>("std::vector<int>");
+    smallSuite<SmallVector<int, 4, ContainerDebugEnabled>>("SmallVector<int, 4> debug");
+    smallSuite<SmallVector<int, 4, ContainerDebugDisabled>>("SmallVector<int, 4> release");
+
+    mapSuite<std::unordered_map<int, int>>("std::unordered_map<int, int>");
+    mapSuite<IdMap<int, int, ContainerDebugEnabled>>("IdMap<int, int> debug");
+    mapSuite<IdMap<int, int, ContainerDebugDisabled>>("IdMap<int, int> release");
+    return 0;
+}
+
+Object sizes on x64 (MSVC / libstdc++):
+    NamedVector<int>        debug 808 bytes, release 24 (same as std::vector)
+    SmallVector<int, 4>     debug 832 bytes, release 48
+    IdMap<int, int>         debug 840 bytes, release 56 (same as unordered_map)
+The debug state keeps its 8-entry mutation history in a fixed ring instead
+of a std::vector, so a debug build no longer allocates on the first
+mutation. It also no longer shifts the history on every mutation after the
+eighth. With the disabled policy, count()/isEmpty()/at() compile to the same
+code as the std container, and each mutation loses its ~20 stores into the
+counters and history record.
+*/
@@ -0,0 +1,73 @@
+// Logger: producer-side throughput from 32 threads
+
+/*
+Each thread logs through one of the three entry points. The program reports
+calls per second on the producer side and how many records reached the sinks
+or were dropped. Run it with and without install() to compare the async
+backend with the synchronous path: each appendLog() used to take the logger
+mutex and format and flush one file line.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <QByteArray>
+#include <QCoreApplication>
+import Diagnostics.Logger;
+
+using namespace ArtifactCore;
+
+namespace {
+constexpr LogFormatSite kDecodeSite{ "frame %1 decoded in %2 ms by %3",
+                                     LogLevel::Debug, LogCategory::MediaDecode };
+}
+
+int main(int argc, char** argv) {
+    QCoreApplication app(argc, argv);
+    auto* logger = Logger::instance();
+    const bool async = argc < 2 || QByteArray(argv[1]) != "--sync";
+    if (async) logger->install();
+
+    constexpr int kThreads = 32;
+    constexpr int kCallsPerThread = 100000;
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([logger, t]() {
+            for (int i = 0; i < kCallsPerThread; ++i) {
+                switch (i % 3) {
+                case 0: logger->logDeferred(kDecodeSite, i, i, 0.25 * i, "prores"); break;
+                case 1: logger->tryFastLog(LogLevel::Info, LogCategory::RenderVP, "tile done", i); break;
+                default: logger->appendLog(LogLevel::Debug, QStringLiteral("worker %1").arg(t)); break;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    logger->flush();
+
+    const AsyncLogStats stats = logger->asyncStats();
+    std::printf("%s: %.2f M calls/s, enqueued %llu, drained %llu, dropped %llu\n",
+        async ? "async" : "sync", kThreads * kCallsPerThread / seconds / 1e6,
+        static_cast<unsigned long long>(stats.enqueued),
+        static_cast<unsigned long long>(stats.drained),
+        static_cast<unsigned long long>(stats.dropped));
+    logger->uninstall();
+    return 0;
+}
+
+Per-call cost on the producer side with the async backend:
+    logDeferred   copies at most 6 raw arguments (<= 40 bytes each) into the
+                  thread's ring; QString::arg formatting happens on the drain thread
+    tryFastLog    one strlen + memcpy of up to 192 bytes
+    appendLog     two QString reference-count increments
+    All three also read two clocks and do one release store. They take no
+    lock after a thread's first call.
+The drain thread writes a batch to the memory and file sinks under a single
+lock and flushes the file once per batch, not once per line. When a thread's
+256-record ring is full, Debug and Info records are dropped and counted, and
+the drain thread logs a "records dropped" warning. Warnings and errors fall
+back to the synchronous path instead.
+*/
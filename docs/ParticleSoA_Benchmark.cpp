@@ -0,0 +1,74 @@
+// ParticleSystem: SoA chunked update vs. the AoS pool loop
+
+/*
+Seeds N long-lived particles with random positions and velocities, adds
+gravity, wind, vortex, drag and a ground plane, and times ten
+ParticleSystem::update() calls per storage mode. In AoS mode each particle
+walks every field and collider in turn. In SoA mode the system splits the
+columns into 4096-particle chunks, runs them through Parallel::ForRange and
+applies each field to a whole chunk at a time (SSE2 where the field is a
+plain add or scale). Nothing dies here, so the numbers leave out compaction
+and sub-emitter spawning.
+
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+import Particle;
+import Particle.System;
+import Memory.SharedPtr;
+
+using namespace ArtifactCore;
+
+int main() {
+    for (int n : {100000, 1000000}) {
+        for (auto mode : {ParticleStorageMode::AoS, ParticleStorageMode::SoA}) {
+            std::mt19937 rng(5);
+            std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+
+            ParticleSystem system;
+            system.setMaxParticles(n);
+            system.addForceField(std::make_shared<GravityForce>());
+            system.addForceField(std::make_shared<WindForce>());
+            system.addForceField(std::make_shared<VortexForce>());
+            system.addForceField(std::make_shared<DragForce>());
+            auto ground = std::make_shared<PlaneCollider>();
+            ground->setHeight(-3.0f);
+            system.addCollider(ground);
+
+            system.setStorageMode(mode);
+            for (int i = 0; i < n; ++i) {
+                Particle p;
+                p.position = {dist(rng), dist(rng), dist(rng)};
+                p.velocity = {dist(rng), dist(rng), dist(rng)};
+                p.lifetime = 100.0f;
+                if (mode == ParticleStorageMode::SoA) {
+                    system.getSoA().push(p);
+                } else {
+                    system.getPool()[system.getPool().spawn()] = p;
+                }
+            }
+
+            system.update(1.0 / 60.0);
+            double total = 0.0;
+            for (int frame = 0; frame < 10; ++frame) {
+                system.update(1.0 / 60.0);
+                total += system.getStatistics().simulationTimeMs;
+            }
+            std::printf("N = %7d  %s  %.2f ms/frame\n", n,
+                mode == ParticleStorageMode::SoA ? "SoA" : "AoS", total / 10.0);
+        }
+    }
+    return 0;
+}
+
+This file is a harness only; it contains no measured results.
+
+A force pass reads and writes three float columns instead of dragging the
+whole Particle record through the cache; attributes the update loop never
+touches live in ParticleSoA::cold. Particles that expire in a frame skip
+forces, integration and collision before compact() drops them. The chunks
+run in parallel on more cores. Each chunk has its own spawn queue and the
+queues are merged in chunk order, so sub-emitter output does not depend on
+the thread count.
+*/
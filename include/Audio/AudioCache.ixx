@@ -5,6 +5,8 @@ module;
 #include "../Define/DllExportMacro.hpp"
 #include <QMap>
 #include <QReadWriteLock>
+#include <atomic>
+#include <cstdint>
 #include <functional>
 
 export module Audio.Cache;
@@ -25,6 +27,81 @@ struct CachedAudioFrame {
         : frameNumber(frame), pcm(std::move(data)), lastAccess(accessTime) {}
 };
 
+// キャッシュの保持方式
+enum class AudioCacheMode {
+    Map,   // 可変長 AudioSegment を QMap に保持（既定、LRU）
+    Slab   // 事前確保した固定長 PCM ブロックのスラブ（CLOCK、ゼロコピー参照）
+};
+
+// Slab モードのブロック形状
+// 1 ブロック = channels × framesPerBlock の planar float。これを超える
+// セグメントはキャッシュされず rejected に計上される。
+struct AudioCacheSlabConfig {
+    int slotCount = 300;        // ブロック数（キャッシュできるフレーム数）
+    int channels = 2;
+    int framesPerBlock = 2048;  // 48kHz / 30fps = 1600 サンプルを収められる長さ
+};
+
+// ヒット率とエビクションの入れ替わり（churn）の計測用カウンタ
+struct AudioCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t insertions = 0;
+    uint64_t evictions = 0;
+    uint64_t pinnedSkips = 0;  // 参照中のため CLOCK が読み飛ばしたブロック数
+    uint64_t rejected = 0;     // ブロックに収まらない / 空きが無く追加できなかった数
+
+    double hitRate() const {
+        const uint64_t lookups = hits + misses;
+        return lookups ? static_cast<double>(hits) / static_cast<double>(lookups) : 0.0;
+    }
+    // 追加 1 回あたりのエビクション数（1 に近いほどキャッシュが回転しきっている）
+    double evictionChurn() const {
+        return insertions ? static_cast<double>(evictions) / static_cast<double>(insertions) : 0.0;
+    }
+};
+
+class AudioCacheSlab;
+
+// Slab 内ブロックへの参照カウント付きビュー
+// 保持している間そのブロックは追い出されない（ピン留め）。
+// キャッシュ本体が破棄・再構成されてもスラブはハンドルが解放されるまで生存する。
+class LIBRARY_DLL_API AudioCacheHandle
+{
+public:
+    AudioCacheHandle() = default;
+    AudioCacheHandle(const AudioCacheHandle& other);
+    AudioCacheHandle(AudioCacheHandle&& other) noexcept;
+    AudioCacheHandle& operator=(const AudioCacheHandle& other);
+    AudioCacheHandle& operator=(AudioCacheHandle&& other) noexcept;
+    ~AudioCacheHandle();
+
+    bool isValid() const { return slot_ >= 0; }
+    explicit operator bool() const { return isValid(); }
+
+    int64_t frameNumber() const;
+    int sampleRate() const;
+    AudioChannelLayout layout() const;
+    qint64 startFrame() const;
+    int channelCount() const;
+    int frameCount() const;
+
+    // planar サンプル列（frameCount() 個）。範囲外は nullptr
+    const float* constData(int channelIdx) const;
+
+    // AudioSegment が必要な呼び出し側向けのコピー
+    void copyTo(AudioSegment& out) const;
+
+    void reset();
+
+private:
+    friend class AudioCache;
+    AudioCacheHandle(std::shared_ptr<AudioCacheSlab> slab, int slot);
+
+    std::shared_ptr<AudioCacheSlab> slab_;
+    int slot_ = -1;
+};
+
 // オーディオデコード結果のキャッシュ管理
 export class LIBRARY_DLL_API AudioCache
 {
@@ -34,8 +111,13 @@ public:
     AudioCache();
     ~AudioCache() = default;
     
-    // キャッシュから取得
+    // キャッシュから取得（コピー）
     bool getCached(int64_t frameNumber, AudioSegment& out);
+
+    // キャッシュから取得（Slab モードのみ、ゼロコピー）
+    // 読み取りロックのみで完了し、ヒット時も時刻取得やコピーを行わない。
+    // Map モードまたはミス時は無効なハンドルを返す。
+    AudioCacheHandle acquire(int64_t frameNumber);
     
     // キャッシュに追加
     void addCache(int64_t frameNumber, AudioSegment&& pcm);
@@ -45,15 +127,25 @@ public:
     void setPrefetchProvider(PrefetchProvider provider);
     
     // 期限切れエントリのクリア
+    // Slab モードは時刻を持たないため、前回の呼び出し以降に参照されていない
+    // （かつピン留めされていない）ブロックを解放する。maxAgeMs は無視される。
     void clearExpired(qint64 maxAgeMs = 30000);  // 30秒以上アクセスなし
     
     // 統計情報
     size_t getCacheSize() const;
-    size_t getMemoryUsage() const;  // バイト単位
-    
+    size_t getMemoryUsage() const;  // バイト単位（Slab モードは確保済みスラブ全体）
+    AudioCacheStats stats() const;
+    void resetStats();
+
     // 設定
+    // Slab モードでは slotCount を置き換えてスラブを再確保する
     void setMaxCacheFrames(int maxFrames);
     int getMaxCacheFrames() const;
+
+    // モード切り替え（既存のエントリは破棄される）
+    void setMode(AudioCacheMode mode, const AudioCacheSlabConfig& config = {});
+    AudioCacheMode mode() const;
+    AudioCacheSlabConfig slabConfig() const;
     
     // クリア
     void clear();
@@ -64,9 +156,23 @@ private:
     int maxCacheFrames_ = 300;  // デフォルト10秒分 (30fps)
     qint64 lastCleanupTime_ = 0;
     PrefetchProvider prefetchProvider_;
-    
+
+    AudioCacheMode mode_ = AudioCacheMode::Map;
+    AudioCacheSlabConfig slabConfig_;
+    std::shared_ptr<AudioCacheSlab> slab_;
+
+    std::atomic<uint64_t> hits_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> insertions_{0};
+    std::atomic<uint64_t> evictions_{0};
+    std::atomic<uint64_t> pinnedSkips_{0};
+    std::atomic<uint64_t> rejected_{0};
+
     // LRU クリーンアップ
     void cleanupLRU();
+
+    // Slab モードの追加（書き込みロック保持中に呼ぶ）
+    void addSlab(int64_t frameNumber, const AudioSegment& pcm);
 };
 
 } // namespace ArtifactCore
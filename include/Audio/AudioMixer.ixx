@@ -3,6 +3,7 @@ module;
 #include "../Define/DllExportMacro.hpp"
 #include <QJsonObject>
 #include <QString>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,6 +38,15 @@ enum class AudioBusKind {
     Return,
 };
 
+// バスごとの DSP 時間（AudioEngineProfiler の集計値）
+struct AudioMixerBusTiming {
+    SharedPtr<AudioBus> bus;
+    double averageUs = 0.0;
+    double maximumUs = 0.0;
+    double lastUs = 0.0;
+    std::int64_t blocks = 0;
+};
+
 class LIBRARY_DLL_API AudioMixer {
 public:
     AudioMixer();
@@ -64,9 +74,17 @@ public:
     static QString routingResultDescription(AudioRoutingResult result);
 
     // 全体の実行
-    // グラフをトポロジカルソートして順次処理します
+    // トポロジカル順序はバス構成が変わるまでキャッシュされる。互いに依存しない
+    // バス（サイドチェーン送りを含む）はワーカースレッドで並列に処理され、
+    // 各バスは入力を決まった順序で合算するため結果はスレッド数に依存しない。
     void process(ArtifactCore::AudioSegment& finalOutput);
 
+    // 並列処理に使うワーカー数（呼び出しスレッドを除く）。0 で直列実行
+    void setWorkerCount(int workers);
+    int workerCount() const;
+
+    std::vector<AudioMixerBusTiming> busTimings() const;
+
     SharedPtr<AudioBus> getMasterBus() const { return masterBus_; }
     int busCount() const;
     std::vector<ZeroString> busNamesZero() const;
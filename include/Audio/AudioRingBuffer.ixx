@@ -40,6 +40,42 @@ export module Audio.RingBuffer;
 import Audio.Segment;
 
 export namespace ArtifactCore {
+ inline constexpr int kAudioRingMaxChannels = 10;
+
+ // リング内部のサンプル配置
+ // Planar:      チャンネルごとに独立した配列（AudioSegment と同じ並び）
+ // Interleaved: L R L R ... のデバイス形式。出力コールバックが 1 パスで書き出せる
+ enum class AudioRingLayout {
+  Planar,
+  Interleaved
+ };
+
+ // リング上の連続領域。折り返しがあると first / second の 2 区間に分かれる。
+ // Interleaved の場合 frames はフレーム数で、1 フレーム = channels サンプル。
+ template <typename T>
+ struct AudioRingSpan {
+  T* first = nullptr;
+  size_t firstFrames = 0;
+  T* second = nullptr;
+  size_t secondFrames = 0;
+
+  size_t frames() const { return firstFrames + secondFrames; }
+ };
+
+ template <typename T>
+ struct AudioRingView {
+  AudioRingLayout layout = AudioRingLayout::Planar;
+  int channels = 0;
+  size_t frames = 0;
+  std::array<AudioRingSpan<T>, kAudioRingMaxChannels> planar{};  // Planar のみ [0, channels)
+  AudioRingSpan<T> interleaved{};                                  // Interleaved のみ
+
+  bool isEmpty() const { return frames == 0; }
+ };
+
+ using AudioRingReadView = AudioRingView<const float>;
+ using AudioRingWriteView = AudioRingView<float>;
+
  class AudioRingBuffer {
  private:
   class Impl;
@@ -53,12 +89,33 @@ export namespace ArtifactCore {
   void setCapacity(size_t capacity);
   size_t capacity() const;
 
-  // Data operations
+  // Layout management（setCapacity と同じく出力停止中にのみ呼ぶこと）
+  // 生産側ロックの下で入れ替えるので、他スレッドの write() と並行してよい。
+  // バッファ済みのフレームは新しい配置へ移される。
+  // Interleaved では channels を固定し、write() は不足チャンネルを
+  // モノラル複製またはゼロで埋め、余剰チャンネルを捨てる。
+  void setLayout(AudioRingLayout layout, int channels = 2);
+  AudioRingLayout layout() const;
+  int channelCount() const;
+
+  // Data operations（コピーあり）
+  // write() は複数スレッドから呼んでよい（生産側はロックで直列化、消費側はロックなし）。
   bool write(const AudioSegment& data);
   bool read(AudioSegment& data, size_t size);
   size_t available() const;
   size_t freeSpace() const;
 
+  // Zero-copy consumer: 最大 maxFrames の読み出し可能領域を直接参照する。
+  // 使い終わったら endRead で消費したフレーム数を確定する（消費側スレッドのみ）。
+  AudioRingReadView beginRead(size_t maxFrames);
+  void endRead(size_t frames);
+
+  // Zero-copy producer: 最大 maxFrames の空き領域へ直接書き込み、
+  // endWrite で書き込んだフレーム数を公開する。beginWrite から endWrite までは
+  // 生産側ロックを保持するので、その間に同じスレッドから write() を呼ばないこと。
+  AudioRingWriteView beginWrite(size_t maxFrames);
+  void endWrite(size_t frames);
+
   // Utility
   void clear();
   bool isEmpty() const;
@@ -63,6 +63,34 @@ enum class LUTFormat {
     Unknown
 };
 
+/// 格子点間の補間方式
+enum class LUTInterpolation {
+    Tetrahedral,   ///< 四面体補間（4点参照、無彩色軸で誤差が出ない）
+    Trilinear      ///< 三線形補間（8点参照、既定。旧来の結果と一致する）
+};
+
+/// 3D LUT 前段の 1D シェーパー
+///
+/// 入力 [domainMin, domainMax] を [0, 1] に正規化し、チャンネルごとの
+/// カーブ（単調増加、等間隔サンプル）で格子座標へ変換する。
+/// ログ/HDR 素材を格子へ均等に割り当てるためのプリリニアライズ用途。
+struct LUTShaper {
+    float domainMin = 0.0f;
+    float domainMax = 1.0f;
+    std::array<std::vector<float>, 3> curves;  ///< 空のチャンネルは正規化のみ
+
+    bool isIdentity() const {
+        return domainMin == 0.0f && domainMax == 1.0f &&
+               curves[0].empty() && curves[1].empty() && curves[2].empty();
+    }
+
+    /// 関数をサンプリングして全チャンネル共通のシェーパーを作成
+    static LUTShaper fromFunction(const std::function<float(float)>& fn,
+                                  float domainMin, float domainMax, int samples = 4096);
+};
+
+struct LUTBakeStage;
+
 /// 3Dカラールックアップテーブル
 /// 
 /// カラーグレーディング用の3D LUTを管理。
@@ -90,6 +118,7 @@ public:
     bool load(const QString& filePath);
     
     /// CUBE形式から読み込み
+    /// LUT_3D_INPUT_RANGE と Resolve 形式の 1D シェーパー（LUT_1D_SIZE）は shaper() に入る
     bool loadFromCube(const QString& filePath);
     
     /// Cinespace形式から読み込み
@@ -108,7 +137,7 @@ public:
     // 保存
     // ========================================
     
-    /// CUBE形式で保存
+    /// CUBE形式で保存（シェーパーも LUT_1D_* / LUT_3D_INPUT_RANGE として書き出す）
     bool saveToCube(const QString& filePath) const;
     
     // ========================================
@@ -147,6 +176,20 @@ public:
     /// 画像全体にLUTを適用
     QImage applyToImage(const QImage& source) const;
     
+    /// float RGB/RGBA バッファ（インターリーブ）に一括適用。アルファは保持
+    void applyToSpan(float* pixels, size_t pixelCount, int channels = 3) const;
+    
+    /// float プレーナバッファに一括適用
+    void applyToSpan(float* r, float* g, float* b, size_t pixelCount) const;
+    
+    /// 補間方式（既定は三線形。四面体は setInterpolation で選択する）
+    LUTInterpolation interpolation() const;
+    void setInterpolation(LUTInterpolation interpolation);
+    
+    /// 1D シェーパー（格子参照前に適用）
+    const LUTShaper& shaper() const;
+    void setShaper(const LUTShaper& shaper);
+    
     /// 強度を指定して適用（0.0-1.0）
     QColor applyWithIntensity(const QColor& color, float intensity) const;
     
@@ -160,6 +203,11 @@ public:
     /// 2つのLUTを合成
     ColorLUT combine(const ColorLUT& other) const;
     
+    /// LUT と色変換の列を 1 つの格子に焼き込む（先頭から順に適用）
+    /// shaper を指定すると焼き込み結果の格子座標はシェーパー空間になる
+    static ColorLUT bake(const std::vector<LUTBakeStage>& stages, int size = 33,
+                         const LUTShaper& shaper = {});
+    
     /// 強度を設定したコピーを作成
     ColorLUT withIntensity(float intensity) const;
     
@@ -187,10 +235,27 @@ private:
     class Impl;
     Impl* impl_;
     
-    /// 三線形補間でLUTをサンプリング
+    /// 現在の補間方式でLUTをサンプリング
     QVector3D sample(float r, float g, float b) const;
 };
 
+/// ColorLUT::bake の 1 ステージ（LUT または任意の色変換）
+struct LUTBakeStage {
+    std::optional<ColorLUT> lut;
+    std::function<void(float& r, float& g, float& b)> transform;
+
+    static LUTBakeStage fromLUT(const ColorLUT& lut) {
+        LUTBakeStage stage;
+        stage.lut = lut;
+        return stage;
+    }
+    static LUTBakeStage fromTransform(std::function<void(float& r, float& g, float& b)> transform) {
+        LUTBakeStage stage;
+        stage.transform = std::move(transform);
+        return stage;
+    }
+};
+
 /// LUTマネージャ（複数LUTの管理）
 class LUTManager {
 public:
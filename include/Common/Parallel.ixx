@@ -1,16 +1,74 @@
 module;
+#include <algorithm>
 #include <cstddef>
-#include <functional>
+#include <memory>
+#include <type_traits>
 #include <utility>
+#include <vector>
 #include "../Define/DllExportMacro.hpp"
 
 export module Core.Parallel;
 
 export namespace ArtifactCore {
 
+    /**
+     * @brief 連続したインデックス範囲 [begin, end)
+     */
+    struct ParallelRange {
+        int begin = 0;
+        int end = 0;
+
+        int size() const { return end - begin; }
+        bool empty() const { return end <= begin; }
+    };
+
+    /**
+     * @brief 2D タイル範囲 [x0, x1) x [y0, y1)
+     */
+    struct ParallelTile {
+        int x0 = 0;
+        int y0 = 0;
+        int x1 = 0;
+        int y1 = 0;
+
+        int width() const { return x1 - x0; }
+        int height() const { return y1 - y0; }
+        int area() const { return width() * height(); }
+    };
+
+    /**
+     * @brief チャンクの割り当て方
+     * Dynamic: TBB の auto_partitioner に任せる（負荷が偏る処理向け）
+     * Static: チャンク境界を grain から決定的に計算し、スレッドへ均等に配る
+     */
+    enum class ParallelSchedule {
+        Dynamic,
+        Static
+    };
+
+    /**
+     * @brief 並列領域の中から呼ばれたときの振る舞い
+     * Allow: そのまま入れ子で並列化する
+     * Isolate: this_task_arena::isolate で外側のタスクを盗まないようにする
+     * SerialWhenNested: 既に並列領域内ならシリアル実行に落とす
+     */
+    enum class ParallelNesting {
+        Allow,
+        Isolate,
+        SerialWhenNested
+    };
+
+    struct ParallelOptions {
+        ParallelSchedule schedule = ParallelSchedule::Dynamic;
+        ParallelNesting nesting = ParallelNesting::Allow;
+    };
+
         /**
          * @brief 標準の並列アルゴリズムを使った高速な並列 for ループ
          * 画像の各行（Y座標）ごとの処理などを大幅に加速させます。
+         *
+         * 型消去はチャンク単位で 1 回だけ行い、ループ本体はテンプレート側で
+         * インライン展開されます（std::function も毎インデックスの間接呼び出しもありません）。
          */
     class LIBRARY_DLL_API Parallel {
     public:
@@ -21,7 +79,7 @@ export namespace ArtifactCore {
          * @param func 実行する関数: void(int index)
          */
         template<typename Function>
-        static void For(int start, int end, Function func) {
+        static void For(int start, int end, Function&& func) {
             if (start >= end) return;
 
             constexpr int kParallelRangeThreshold = 64;
@@ -32,7 +90,11 @@ export namespace ArtifactCore {
                 return;
             }
 
-            ForErased(start, end, std::function<void(int)>(std::forward<Function>(func)));
+            ForRange(start, end, 1, [&func](ParallelRange range) {
+                for (int i = range.begin; i < range.end; ++i) {
+                    func(i);
+                }
+            });
         }
 
         /**
@@ -40,7 +102,7 @@ export namespace ArtifactCore {
          * @param workItems 1反復あたりではなく、範囲全体のおおよその仕事量
          */
         template<typename Function>
-        static void For(int start, int end, int workItems, Function func) {
+        static void For(int start, int end, int workItems, Function&& func) {
             if (start >= end) return;
 
             constexpr int kParallelRangeThreshold = 64;
@@ -52,11 +114,228 @@ export namespace ArtifactCore {
                 return;
             }
 
-            ForErased(start, end, std::function<void(int)>(std::forward<Function>(func)));
+            ForRange(start, end, 1, [&func](ParallelRange range) {
+                for (int i = range.begin; i < range.end; ++i) {
+                    func(i);
+                }
+            });
         }
 
+        /**
+         * @brief [begin, end) を grain 以上のチャンクに分割し、チャンクごとに body を呼びます
+         * @param grain 1 チャンクの最小要素数。Static の場合はチャンクの大きさそのもの
+         * @param body 実行する関数: void(ParallelRange range)
+         *
+         * 安価なピクセル単位の処理では、行ブロックやピクセル列をまとめて渡すことで
+         * 呼び出しのオーバーヘッドを無視できる大きさにできます。
+         */
+        template<typename Body>
+        static void ForRange(int begin, int end, int grain, Body&& body,
+                             ParallelOptions options = {}) {
+            if (begin >= end) return;
+            grain = std::max(1, grain);
+            if (end - begin <= grain) {
+                body(ParallelRange{begin, end});
+                return;
+            }
+
+            using BodyType = std::remove_reference_t<Body>;
+            ForChunksErased(begin, end, grain, options,
+                [](void* context, int chunkBegin, int chunkEnd) {
+                    (*static_cast<BodyType*>(context))(ParallelRange{chunkBegin, chunkEnd});
+                },
+                const_cast<void*>(static_cast<const void*>(std::addressof(body))));
+        }
+
+        /**
+         * @brief 幅 width の画像の行を、1 ブロックあたり minPixelsPerBlock 以上になるようにまとめて処理します
+         * @param body 実行する関数: void(ParallelRange rows)
+         */
+        template<typename Body>
+        static void ForRows(int width, int height, int minPixelsPerBlock, Body&& body,
+                            ParallelOptions options = {}) {
+            if (width <= 0 || height <= 0) return;
+            const int rowsPerBlock = std::max(1, minPixelsPerBlock / width);
+            ForRange(0, height, rowsPerBlock, std::forward<Body>(body), options);
+        }
+
+        /**
+         * @brief width x height の領域を tileWidth x tileHeight のタイルに分割して並列処理します
+         * @param body 実行する関数: void(const ParallelTile& tile)
+         *
+         * タイルは行優先で番号付けされ、端のタイルは領域内に切り詰められます。
+         */
+        template<typename Body>
+        static void ForTiles(int width, int height, int tileWidth, int tileHeight, Body&& body,
+                             ParallelOptions options = {}) {
+            if (width <= 0 || height <= 0) return;
+            tileWidth = std::clamp(tileWidth, 1, width);
+            tileHeight = std::clamp(tileHeight, 1, height);
+            const int tilesX = (width + tileWidth - 1) / tileWidth;
+            const int tilesY = (height + tileHeight - 1) / tileHeight;
+
+            ForRange(0, tilesX * tilesY, 1, [&](ParallelRange tiles) {
+                for (int t = tiles.begin; t < tiles.end; ++t) {
+                    const int tx = t % tilesX;
+                    const int ty = t / tilesX;
+                    ParallelTile tile;
+                    tile.x0 = tx * tileWidth;
+                    tile.y0 = ty * tileHeight;
+                    tile.x1 = std::min(width, tile.x0 + tileWidth);
+                    tile.y1 = std::min(height, tile.y0 + tileHeight);
+                    body(tile);
+                }
+            }, options);
+        }
+
+        /**
+         * @brief [begin, end) を grain ごとのチャンクに分けて畳み込みます
+         * @param identity 各チャンクの初期値（combine の単位元）
+         * @param body チャンクの畳み込み: T(ParallelRange range, T accumulator)
+         * @param combine 部分結果の結合: T(T lhs, T rhs)
+         *
+         * チャンク境界は grain だけで決まり、部分結果はチャンク順に結合されるため、
+         * 浮動小数点の総和もスレッド数に依存せず再現します。
+         * 部分結果はキャッシュライン単位に分けて保持するので偽共有は起きません。
+         */
+        template<typename T, typename Body, typename Combine>
+        static T Reduce(int begin, int end, int grain, T identity, Body&& body, Combine&& combine,
+                        ParallelOptions options = {}) {
+            if (begin >= end) return identity;
+            grain = std::max(1, grain);
+            const int chunkCount = (end - begin + grain - 1) / grain;
+            if (chunkCount == 1) {
+                return body(ParallelRange{begin, end}, std::move(identity));
+            }
+
+            std::vector<PaddedSlot<T>> partials(static_cast<std::size_t>(chunkCount),
+                                                PaddedSlot<T>{identity});
+            ForRange(0, chunkCount, 1, [&](ParallelRange chunks) {
+                for (int c = chunks.begin; c < chunks.end; ++c) {
+                    const int chunkBegin = begin + c * grain;
+                    const int chunkEnd = std::min(end, chunkBegin + grain);
+                    auto& slot = partials[static_cast<std::size_t>(c)].value;
+                    slot = body(ParallelRange{chunkBegin, chunkEnd}, std::move(slot));
+                }
+            }, options);
+
+            T result = std::move(identity);
+            for (auto& partial : partials) {
+                result = combine(std::move(result), std::move(partial.value));
+            }
+            return result;
+        }
+
+        /**
+         * @brief 各インデックスを transform(i) で値に変換し、combine で畳み込みます
+         * @param transform 変換関数: T(int index)
+         */
+        template<typename T, typename Combine, typename Transform>
+        static T TransformReduce(int begin, int end, int grain, T identity, Combine&& combine,
+                                 Transform&& transform, ParallelOptions options = {}) {
+            return Reduce(begin, end, grain, identity,
+                [&](ParallelRange range, T accumulator) {
+                    for (int i = range.begin; i < range.end; ++i) {
+                        accumulator = combine(std::move(accumulator), transform(i));
+                    }
+                    return accumulator;
+                },
+                combine, options);
+        }
+
+        /**
+         * @brief output[i] = input[0] ⊕ ... ⊕ input[i] を計算します（in-place 可）
+         *
+         * チャンクごとの総和 → チャンク総和の逐次スキャン → オフセット付き再スキャン
+         * の 2 パスで処理します。
+         */
+        template<typename T, typename Combine>
+        static void InclusiveScan(const T* input, T* output, int count, int grain, T identity,
+                                  Combine&& combine, ParallelOptions options = {}) {
+            ScanImpl<true>(input, output, count, grain, std::move(identity), combine, options);
+        }
+
+        /**
+         * @brief output[i] = identity ⊕ input[0] ⊕ ... ⊕ input[i-1] を計算します（in-place 可）
+         */
+        template<typename T, typename Combine>
+        static void ExclusiveScan(const T* input, T* output, int count, int grain, T identity,
+                                  Combine&& combine, ParallelOptions options = {}) {
+            ScanImpl<false>(input, output, count, grain, std::move(identity), combine, options);
+        }
+
+        /**
+         * @brief 現在のスレッドが Parallel の並列領域の中で実行中かどうか
+         */
+        static bool IsInParallelRegion();
+
     private:
-        static void ForErased(int start, int end, const std::function<void(int)>& func);
+        static constexpr std::size_t kCacheLineSize = 64;
+
+        template<typename T>
+        struct alignas(kCacheLineSize) PaddedSlot {
+            T value;
+        };
+
+        template<bool Inclusive, typename T, typename Combine>
+        static void ScanImpl(const T* input, T* output, int count, int grain, T identity,
+                             Combine& combine, ParallelOptions options) {
+            if (!input || !output || count <= 0) return;
+            grain = std::max(1, grain);
+            const int chunkCount = (count + grain - 1) / grain;
+
+            auto scanChunk = [&](int chunkBegin, int chunkEnd, T carry) {
+                for (int i = chunkBegin; i < chunkEnd; ++i) {
+                    T value = input[i];
+                    if constexpr (Inclusive) {
+                        carry = combine(std::move(carry), std::move(value));
+                        output[i] = carry;
+                    } else {
+                        output[i] = carry;
+                        carry = combine(std::move(carry), std::move(value));
+                    }
+                }
+            };
+
+            if (chunkCount == 1) {
+                scanChunk(0, count, std::move(identity));
+                return;
+            }
+
+            std::vector<PaddedSlot<T>> offsets(static_cast<std::size_t>(chunkCount),
+                                               PaddedSlot<T>{identity});
+            ForRange(0, chunkCount, 1, [&](ParallelRange chunks) {
+                for (int c = chunks.begin; c < chunks.end; ++c) {
+                    const int chunkBegin = c * grain;
+                    const int chunkEnd = std::min(count, chunkBegin + grain);
+                    T total = identity;
+                    for (int i = chunkBegin; i < chunkEnd; ++i) {
+                        total = combine(std::move(total), input[i]);
+                    }
+                    offsets[static_cast<std::size_t>(c)].value = std::move(total);
+                }
+            }, options);
+
+            T running = identity;
+            for (auto& offset : offsets) {
+                T total = std::move(offset.value);
+                offset.value = running;
+                running = combine(std::move(running), std::move(total));
+            }
+
+            ForRange(0, chunkCount, 1, [&](ParallelRange chunks) {
+                for (int c = chunks.begin; c < chunks.end; ++c) {
+                    const int chunkBegin = c * grain;
+                    const int chunkEnd = std::min(count, chunkBegin + grain);
+                    scanChunk(chunkBegin, chunkEnd, offsets[static_cast<std::size_t>(c)].value);
+                }
+            }, options);
+        }
+
+        using ChunkFunction = void (*)(void* context, int chunkBegin, int chunkEnd);
+
+        static void ForChunksErased(int begin, int end, int grain, ParallelOptions options,
+                                    ChunkFunction function, void* context);
     };
 
 }
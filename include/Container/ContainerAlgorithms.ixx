@@ -10,14 +10,14 @@ import Container.SmallVector;
 
 export namespace ArtifactCore {
 
-template <typename T, typename F>
-void each(const NamedVector<T>& values, F&& fn)
+template <typename T, typename D, typename F>
+void each(const NamedVector<T, D>& values, F&& fn)
 {
   values.each(std::forward<F>(fn));
 }
 
-template <typename T, typename Predicate>
-std::size_t removeIf(NamedVector<T>& values, Predicate&& predicate)
+template <typename T, typename D, typename Predicate>
+std::size_t removeIf(NamedVector<T, D>& values, Predicate&& predicate)
 {
   std::size_t removed = 0;
   std::size_t index = 0;
@@ -33,20 +33,20 @@ std::size_t removeIf(NamedVector<T>& values, Predicate&& predicate)
   return removed;
 }
 
-template <typename T>
-std::vector<T> toStdVector(const NamedVector<T>& values)
+template <typename T, typename D>
+std::vector<T> toStdVector(const NamedVector<T, D>& values)
 {
   return values.toStdVector();
 }
 
-template <typename T, std::size_t N, typename F>
-void each(const SmallVector<T, N>& values, F&& fn)
+template <typename T, std::size_t N, typename D, typename F>
+void each(const SmallVector<T, N, D>& values, F&& fn)
 {
   values.each(std::forward<F>(fn));
 }
 
-template <typename T, std::size_t N, typename Predicate>
-std::size_t removeIf(SmallVector<T, N>& values, Predicate&& predicate)
+template <typename T, std::size_t N, typename D, typename Predicate>
+std::size_t removeIf(SmallVector<T, N, D>& values, Predicate&& predicate)
 {
   std::size_t removed = 0;
   std::size_t index = 0;
@@ -62,8 +62,8 @@ std::size_t removeIf(SmallVector<T, N>& values, Predicate&& predicate)
   return removed;
 }
 
-template <typename T, std::size_t N>
-std::vector<T> toStdVector(const SmallVector<T, N>& values)
+template <typename T, std::size_t N, typename D>
+std::vector<T> toStdVector(const SmallVector<T, N, D>& values)
 {
   return values.toStdVector();
 }
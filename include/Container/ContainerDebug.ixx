@@ -1,8 +1,21 @@
 module;
+#include <array>
 #include <cstddef>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+// Counters, mutation history and watch bookkeeping in the containers are
+// compiled in only when ARTIFACT_CONTAINER_DEBUG is non-zero. It follows
+// NDEBUG unless the build sets it explicitly.
+#ifndef ARTIFACT_CONTAINER_DEBUG
+#ifdef NDEBUG
+#define ARTIFACT_CONTAINER_DEBUG 0
+#else
+#define ARTIFACT_CONTAINER_DEBUG 1
+#endif
+#endif
+
 export module Container.Debug;
 
 export namespace ArtifactCore {
@@ -166,6 +179,186 @@ inline constexpr ContainerSourceLocation containerHere(
   return containerSourceLocation(file, function, line);
 }
 
+// Debug policies for NamedVector / SmallVector / IdMap. The container keeps
+// the same API under both; with ContainerDebugDisabled the bookkeeping is an
+// empty base and every hook is a no-op.
+struct ContainerDebugEnabled {
+  static constexpr bool enabled = true;
+};
+
+struct ContainerDebugDisabled {
+  static constexpr bool enabled = false;
+};
+
+using ContainerDebugDefault = std::conditional_t<
+  ARTIFACT_CONTAINER_DEBUG != 0,
+  ContainerDebugEnabled,
+  ContainerDebugDisabled>;
+
+template <bool Enabled>
+class ContainerDebugState;
+
+template <>
+class ContainerDebugState<true> {
+public:
+  static constexpr std::size_t kHistoryCapacity = 8;
+
+  ContainerDebugState() noexcept = default;
+
+  ContainerDebugState(
+    ContainerName name,
+    ContainerDomain domain,
+    ContainerSourceLocation createdAt,
+    std::size_t initialCapacity = 0) noexcept
+    : name_(name)
+    , domain_(domain)
+    , createdAt_(createdAt)
+    , observedCapacity_(initialCapacity)
+  {
+  }
+
+  ContainerName name() const noexcept { return name_; }
+  void setName(ContainerName name) noexcept { name_ = name; }
+  ContainerDomain domain() const noexcept { return domain_; }
+  void setDomain(ContainerDomain domain) noexcept { domain_ = domain; }
+  ContainerOwner owner() const noexcept { return owner_; }
+  void setOwner(ContainerOwner owner) noexcept { owner_ = owner; }
+  ContainerSourceLocation createdAt() const noexcept { return createdAt_; }
+  void setCreatedAt(ContainerSourceLocation location) noexcept { createdAt_ = location; }
+  ContainerSourceLocation lastMutatedAt() const noexcept { return lastMutatedAt_; }
+  void setLastMutatedAt(ContainerSourceLocation location) noexcept { lastMutatedAt_ = location; }
+  ContainerSourceLocation lastFailedAccessAt() const noexcept { return lastFailedAccessAt_; }
+  void setLastFailedAccessAt(ContainerSourceLocation location) noexcept { lastFailedAccessAt_ = location; }
+  const ContainerDebugCounters& counters() const noexcept { return counters_; }
+  const ContainerMutationRecord& lastMutation() const noexcept { return lastMutation_; }
+
+  std::size_t mutationHistorySize() const noexcept
+  {
+    return historySize_;
+  }
+
+  // Oldest first, like the vector it replaces.
+  const ContainerMutationRecord* mutationHistoryAt(std::size_t index) const noexcept
+  {
+    return index < historySize_ ? &history_[(historyHead_ + index) % kHistoryCapacity] : nullptr;
+  }
+
+  void noteRead() const noexcept
+  {
+    ++counters_.readCount;
+  }
+
+  void noteFailedAccess() const noexcept
+  {
+    ++counters_.failedAccessCount;
+    lastFailedAccessAt_ = createdAt_;
+  }
+
+  void noteCount(std::size_t count) noexcept
+  {
+    if (count > counters_.maxCountSeen) counters_.maxCountSeen = count;
+  }
+
+  void noteMutation(
+    const char* operation,
+    std::size_t before,
+    std::size_t after,
+    std::size_t capacity,
+    std::size_t approximateBytes) noexcept
+  {
+    ++counters_.version;
+    ++counters_.mutationCount;
+    if (after > counters_.maxCountSeen) counters_.maxCountSeen = after;
+    if (after > before) counters_.addedCount += after - before;
+    if (before > after) counters_.removedCount += before - after;
+    if (capacity != observedCapacity_) {
+      ++counters_.capacityChangeCount;
+      observedCapacity_ = capacity;
+    }
+    if (capacity > counters_.maxCapacitySeen) counters_.maxCapacitySeen = capacity;
+    if (approximateBytes > counters_.maxApproximateBytesSeen) counters_.maxApproximateBytesSeen = approximateBytes;
+    lastMutatedAt_ = createdAt_;
+    lastMutation_ = ContainerMutationRecord{
+      operation,
+      createdAt_,
+      counters_.version,
+      before,
+      after,
+      ""
+    };
+    if (historySize_ < kHistoryCapacity) {
+      history_[(historyHead_ + historySize_) % kHistoryCapacity] = lastMutation_;
+      ++historySize_;
+    } else {
+      history_[historyHead_] = lastMutation_;
+      historyHead_ = (historyHead_ + 1) % kHistoryCapacity;
+    }
+  }
+
+private:
+  ContainerName name_;
+  ContainerDomain domain_ = ContainerDomain::Unknown;
+  ContainerOwner owner_{};
+  mutable ContainerDebugCounters counters_{};
+  ContainerSourceLocation createdAt_{};
+  ContainerSourceLocation lastMutatedAt_{};
+  mutable ContainerSourceLocation lastFailedAccessAt_{};
+  ContainerMutationRecord lastMutation_{};
+  std::array<ContainerMutationRecord, kHistoryCapacity> history_{};
+  std::size_t historyHead_ = 0;
+  std::size_t historySize_ = 0;
+  std::size_t observedCapacity_ = 0;
+};
+
+template <>
+class ContainerDebugState<false> {
+public:
+  static constexpr std::size_t kHistoryCapacity = 0;
+
+  ContainerDebugState() noexcept = default;
+
+  constexpr ContainerDebugState(
+    ContainerName,
+    ContainerDomain,
+    ContainerSourceLocation,
+    std::size_t = 0) noexcept
+  {
+  }
+
+  static constexpr ContainerName name() noexcept { return ContainerName{}; }
+  static constexpr void setName(ContainerName) noexcept {}
+  static constexpr ContainerDomain domain() noexcept { return ContainerDomain::Unknown; }
+  static constexpr void setDomain(ContainerDomain) noexcept {}
+  static constexpr ContainerOwner owner() noexcept { return ContainerOwner{}; }
+  static constexpr void setOwner(ContainerOwner) noexcept {}
+  static constexpr ContainerSourceLocation createdAt() noexcept { return ContainerSourceLocation{}; }
+  static constexpr void setCreatedAt(ContainerSourceLocation) noexcept {}
+  static constexpr ContainerSourceLocation lastMutatedAt() noexcept { return ContainerSourceLocation{}; }
+  static constexpr void setLastMutatedAt(ContainerSourceLocation) noexcept {}
+  static constexpr ContainerSourceLocation lastFailedAccessAt() noexcept { return ContainerSourceLocation{}; }
+  static constexpr void setLastFailedAccessAt(ContainerSourceLocation) noexcept {}
+
+  static const ContainerDebugCounters& counters() noexcept
+  {
+    static constexpr ContainerDebugCounters none{};
+    return none;
+  }
+
+  static const ContainerMutationRecord& lastMutation() noexcept
+  {
+    static constexpr ContainerMutationRecord none{};
+    return none;
+  }
+
+  static constexpr std::size_t mutationHistorySize() noexcept { return 0; }
+  static constexpr const ContainerMutationRecord* mutationHistoryAt(std::size_t) noexcept { return nullptr; }
+
+  static constexpr void noteRead() noexcept {}
+  static constexpr void noteFailedAccess() noexcept {}
+  static constexpr void noteCount(std::size_t) noexcept {}
+  static constexpr void noteMutation(const char*, std::size_t, std::size_t, std::size_t, std::size_t) noexcept {}
+};
+
 #define ARTIFACT_CONTAINER_HERE ::ArtifactCore::containerHere(__FILE__, __func__, __LINE__)
 #define ARTIFACT_CONTAINER_OWNER(name, id) ::ArtifactCore::containerOwner(name, id)
 
@@ -19,12 +19,12 @@ inline ZeroString toDebugTextZero(const ContainerElementSample& sample);
 inline ZeroString toDebugTextZero(const ContainerDebugInfo& info);
 inline ZeroString toDebugTextZero(const ContainerDebugSnapshot& snapshot);
 inline ZeroString toDebugTextZero(const ContainerWatchHit& hit);
-template <typename T, std::size_t N>
-inline ZeroString toDebugTextZero(const SmallVector<T, N>& values);
+template <typename T, std::size_t N, typename D>
+inline ZeroString toDebugTextZero(const SmallVector<T, N, D>& values);
 template <typename K, typename V>
 inline ZeroString toDebugTextZero(const NameMap<K, V>& values);
-template <typename K, typename V>
-inline ZeroString toDebugTextZero(const IdMap<K, V>& values);
+template <typename K, typename V, typename D>
+inline ZeroString toDebugTextZero(const IdMap<K, V, D>& values);
 template <typename T>
 inline ZeroString toDebugTextZero(const NamedList<T>& values);
 template <typename T>
@@ -46,8 +46,8 @@ inline String toDebugText(const ContainerWatchHit& hit) {
   return String(toDebugTextZero(hit));
 }
 
-template <typename T, std::size_t N>
-inline String toDebugText(const SmallVector<T, N>& values) {
+template <typename T, std::size_t N, typename D>
+inline String toDebugText(const SmallVector<T, N, D>& values) {
   return String(toDebugTextZero(values));
 }
 
@@ -56,8 +56,8 @@ inline String toDebugText(const NameMap<K, V>& values) {
   return String(toDebugTextZero(values));
 }
 
-template <typename K, typename V>
-inline String toDebugText(const IdMap<K, V>& values) {
+template <typename K, typename V, typename D>
+inline String toDebugText(const IdMap<K, V, D>& values) {
   return String(toDebugTextZero(values));
 }
 
@@ -167,8 +167,8 @@ inline ZeroString toDebugTextZero(const ContainerWatchHit& hit) {
   return text;
 }
 
-template <typename T, std::size_t N>
-inline ZeroString toDebugTextZero(const SmallVector<T, N>& values) {
+template <typename T, std::size_t N, typename D>
+inline ZeroString toDebugTextZero(const SmallVector<T, N, D>& values) {
   return toDebugTextZero(values.debugSnapshot());
 }
 
@@ -177,8 +177,8 @@ inline ZeroString toDebugTextZero(const NameMap<K, V>& values) {
   return toDebugTextZero(values.debugSnapshot());
 }
 
-template <typename K, typename V>
-inline ZeroString toDebugTextZero(const IdMap<K, V>& values) {
+template <typename K, typename V, typename D>
+inline ZeroString toDebugTextZero(const IdMap<K, V, D>& values) {
   return toDebugTextZero(values.debugSnapshot());
 }
 
@@ -7,46 +7,46 @@ module;
 
 export module Container.IdMap;
 
+import Core.ArtifactHashMap;
 import Container.Debug;
 import Container.NamedVector;
 
 export namespace ArtifactCore {
 
-template <typename K, typename V>
-class IdMap {
+template <typename K, typename V, typename Debug = ContainerDebugDefault>
+class IdMap : private ContainerDebugState<Debug::enabled> {
+  using DebugState = ContainerDebugState<Debug::enabled>;
+
 public:
   using Key = K;
   using Value = V;
+  using DebugPolicy = Debug;
 
   IdMap() = default;
 
   explicit IdMap(ContainerName name) noexcept
-    : name_(name)
+    : DebugState(name, ContainerDomain::Unknown, ContainerSourceLocation{})
   {
   }
 
   IdMap(ContainerName name, ContainerSourceLocation createdAt) noexcept
-    : name_(name)
-    , createdAt_(createdAt)
+    : DebugState(name, ContainerDomain::Unknown, createdAt)
   {
   }
 
   IdMap(ContainerName name, ContainerDomain domain) noexcept
-    : name_(name)
-    , domain_(domain)
+    : DebugState(name, domain, ContainerSourceLocation{})
   {
   }
 
   IdMap(ContainerName name, ContainerDomain domain, ContainerSourceLocation createdAt) noexcept
-    : name_(name)
-    , domain_(domain)
-    , createdAt_(createdAt)
+    : DebugState(name, domain, createdAt)
   {
   }
 
   std::size_t count() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return values_.size();
   }
 
@@ -57,7 +57,7 @@ public:
 
   bool isEmpty() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return values_.empty();
   }
 
@@ -68,13 +68,13 @@ public:
 
   bool contains(const K& key) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     return values_.find(key) != values_.end();
   }
 
   std::size_t capacity() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return values_.bucket_count();
   }
 
@@ -94,7 +94,7 @@ public:
 
   V* at(const K& key)
   {
-    ++counters_.readCount;
+    this->noteRead();
     auto it = values_.find(key);
     if (it == values_.end()) {
       bumpFailedAccess();
@@ -105,7 +105,7 @@ public:
 
   const V* at(const K& key) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     auto it = values_.find(key);
     if (it == values_.end()) {
       bumpFailedAccess();
@@ -142,7 +142,7 @@ public:
 
   V value(const K& key, V defaultValue = V{}) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     const auto it = values_.find(key);
     return it == values_.end() ? std::move(defaultValue) : it->second;
   }
@@ -220,7 +220,7 @@ public:
 
   NamedVector<K> keys() const
   {
-    NamedVector<K> result(name_, domain_);
+    NamedVector<K> result(DebugState::name(), DebugState::domain());
     result.reserve(values_.size());
     for (const auto& [key, value] : values_) {
       result.add(key);
@@ -230,7 +230,7 @@ public:
 
   NamedVector<V> values() const
   {
-    NamedVector<V> result(name_, domain_);
+    NamedVector<V> result(DebugState::name(), DebugState::domain());
     result.reserve(values_.size());
     for (const auto& [key, value] : values_) {
       result.add(value);
@@ -240,7 +240,7 @@ public:
 
   std::unordered_map<K, V> toStdUnorderedMap() const
   {
-    return values_;
+    return std::unordered_map<K, V>(values_.begin(), values_.end());
   }
 
   auto begin() const noexcept { return values_.begin(); }
@@ -250,98 +250,100 @@ public:
 
   ContainerName name() const noexcept
   {
-    return name_;
+    return DebugState::name();
   }
 
   void setName(ContainerName name) noexcept
   {
-    name_ = name;
+    DebugState::setName(name);
   }
 
   ContainerDomain domain() const noexcept
   {
-    return domain_;
+    return DebugState::domain();
   }
 
   void setDomain(ContainerDomain domain) noexcept
   {
-    domain_ = domain;
+    DebugState::setDomain(domain);
   }
 
   ContainerOwner owner() const noexcept
   {
-    return owner_;
+    return DebugState::owner();
   }
 
   void setOwner(ContainerOwner owner) noexcept
   {
-    owner_ = owner;
+    DebugState::setOwner(owner);
   }
 
   void setCreatedAt(ContainerSourceLocation location) noexcept
   {
-    createdAt_ = location;
+    DebugState::setCreatedAt(location);
   }
 
   void markCreatedHere(ContainerSourceLocation location) noexcept
   {
-    createdAt_ = location;
+    DebugState::setCreatedAt(location);
   }
 
   void setLastMutatedAt(ContainerSourceLocation location) noexcept
   {
-    lastMutatedAt_ = location;
+    DebugState::setLastMutatedAt(location);
   }
 
   void setLastFailedAccessAt(ContainerSourceLocation location) noexcept
   {
-    lastFailedAccessAt_ = location;
+    DebugState::setLastFailedAccessAt(location);
   }
 
   const ContainerDebugCounters& counters() const noexcept
   {
-    return counters_;
+    return DebugState::counters();
   }
 
   ContainerDebugCheckpoint debugCheckpoint() const noexcept
   {
-    return ContainerDebugCheckpoint{counters_.version, counters_.readCount, counters_.failedAccessCount};
+    const auto& counters = DebugState::counters();
+    return ContainerDebugCheckpoint{counters.version, counters.readCount, counters.failedAccessCount};
   }
 
   template <typename Callback>
   bool watchSince(const ContainerDebugCheckpoint& checkpoint, Callback&& callback) const
   {
-    const bool hit = counters_.version != checkpoint.version
-      || counters_.failedAccessCount != checkpoint.failedAccessCount;
-    if (hit) callback(ContainerWatchHit{"idmap-changed-since-checkpoint", createdAt_, debugSnapshot()});
+    const auto& counters = DebugState::counters();
+    const bool hit = counters.version != checkpoint.version
+      || counters.failedAccessCount != checkpoint.failedAccessCount;
+    if (hit) callback(ContainerWatchHit{"idmap-changed-since-checkpoint", DebugState::createdAt(), debugSnapshot()});
     return hit;
   }
 
   const ContainerMutationRecord& lastMutation() const noexcept
   {
-    return lastMutation_;
+    return DebugState::lastMutation();
   }
 
   std::size_t mutationHistorySize() const noexcept
   {
-    return mutationHistory_.size();
+    return DebugState::mutationHistorySize();
   }
 
   const ContainerMutationRecord* mutationHistoryAt(std::size_t index) const noexcept
   {
-    return index < mutationHistory_.size() ? &mutationHistory_[index] : nullptr;
+    return DebugState::mutationHistoryAt(index);
   }
 
   ContainerDebugInfo debugInfo() const noexcept
   {
     return ContainerDebugInfo{
-      name_,
-      domain_,
-      owner_,
+      DebugState::name(),
+      DebugState::domain(),
+      DebugState::owner(),
       typeid(V).name(),
       values_.size(),
       values_.bucket_count(),
-      values_.bucket_count() * sizeof(void*) + values_.size() * (sizeof(K) + sizeof(V) + sizeof(std::size_t))
+      approximateBytes(values_.bucket_count())
     };
   }
 
@@ -350,12 +352,12 @@ public:
     const auto samples = debugSample(4);
     return ContainerDebugSnapshot{
       debugInfo(),
-      counters_,
-      createdAt_,
-      lastMutatedAt_,
-      lastFailedAccessAt_,
-      lastMutation_,
-      samples
+      DebugState::counters(),
+      DebugState::createdAt(),
+      DebugState::lastMutatedAt(),
+      DebugState::lastFailedAccessAt(),
+      DebugState::lastMutation(),
+      samples.toStdVector()
     };
   }
 
@@ -391,7 +393,7 @@ public:
       || (rule.watchFailedAccess && failedAccess)
       || (rule.watchMutation && mutated);
     if (hit) {
-      callback(ContainerWatchHit{"idmap-watch", createdAt_, snapshot});
+      callback(ContainerWatchHit{"idmap-watch", DebugState::createdAt(), snapshot});
     }
     return hit;
   }
@@ -399,64 +401,32 @@ public:
 private:
   void recordMutation(const char* operation, std::size_t before, std::size_t after) noexcept
   {
-    ++counters_.version;
-    ++counters_.mutationCount;
-    if (after > counters_.maxCountSeen) counters_.maxCountSeen = after;
-    if (after > before) counters_.addedCount += after - before;
-    if (before > after) counters_.removedCount += before - after;
     const auto currentCapacity = values_.bucket_count();
-    if (currentCapacity != observedCapacity_) {
-      ++counters_.capacityChangeCount;
-      observedCapacity_ = currentCapacity;
-    }
-    if (currentCapacity > counters_.maxCapacitySeen) counters_.maxCapacitySeen = currentCapacity;
-    const auto approximateBytes = currentCapacity * sizeof(void*) + after * (sizeof(K) + sizeof(V) + sizeof(std::size_t));
-    if (approximateBytes > counters_.maxApproximateBytesSeen) counters_.maxApproximateBytesSeen = approximateBytes;
-    lastMutatedAt_ = createdAt_;
-    lastMutation_ = ContainerMutationRecord{
+    this->noteMutation(
       operation,
-      createdAt_,
-      counters_.version,
       before,
       after,
-      ""
-    };
-    pushMutation(lastMutation_);
+      currentCapacity,
+      approximateBytes(currentCapacity));
   }
 
-  void bumpFailedAccess() const noexcept
+  // One control byte per slot plus the slot itself; the map is flat.
+  static constexpr std::size_t approximateBytes(std::size_t capacity) noexcept
   {
-    ++counters_.failedAccessCount;
-    lastFailedAccessAt_ = createdAt_;
+    return capacity * (1 + sizeof(typename ArtifactHashMap<K, V>::value_type));
   }
 
-  void pushMutation(const ContainerMutationRecord& record) noexcept
+  void bumpFailedAccess() const noexcept
   {
-    constexpr std::size_t historyCapacity = 8;
-    if (mutationHistory_.size() == historyCapacity) {
-      mutationHistory_.erase(mutationHistory_.begin());
-    }
-    mutationHistory_.push_back(record);
+    this->noteFailedAccess();
   }
 
   void updateMaxCount() noexcept
   {
-    if (values_.size() > counters_.maxCountSeen) {
-      counters_.maxCountSeen = values_.size();
-    }
+    this->noteCount(values_.size());
   }
 
-  std::unordered_map<K, V> values_;
-  ContainerName name_;
-  ContainerDomain domain_ = ContainerDomain::Unknown;
-  ContainerOwner owner_{};
-  mutable ContainerDebugCounters counters_{};
-  ContainerSourceLocation createdAt_{};
-  ContainerSourceLocation lastMutatedAt_{};
-  mutable ContainerSourceLocation lastFailedAccessAt_{};
-  ContainerMutationRecord lastMutation_{};
-  std::vector<ContainerMutationRecord> mutationHistory_;
-  std::size_t observedCapacity_ = 0;
+  ArtifactHashMap<K, V> values_;
 };
 
 template <typename K, typename V>
@@ -14,47 +14,46 @@ import Container.Debug;
 
 export namespace ArtifactCore {
 
-template <typename T>
-class NamedVector {
+template <typename T, typename Debug = ContainerDebugDefault>
+class NamedVector : private ContainerDebugState<Debug::enabled> {
+  using DebugState = ContainerDebugState<Debug::enabled>;
+
 public:
   using Value = T;
+  using DebugPolicy = Debug;
 
   NamedVector() = default;
 
   explicit NamedVector(ContainerName name) noexcept
-    : name_(name)
+    : DebugState(name, ContainerDomain::Unknown, ContainerSourceLocation{})
   {
   }
 
   NamedVector(ContainerName name, ContainerSourceLocation createdAt) noexcept
-    : name_(name)
-    , createdAt_(createdAt)
+    : DebugState(name, ContainerDomain::Unknown, createdAt)
   {
   }
 
   NamedVector(ContainerName name, ContainerDomain domain) noexcept
-    : name_(name)
-    , domain_(domain)
+    : DebugState(name, domain, ContainerSourceLocation{})
   {
   }
 
   NamedVector(ContainerName name, ContainerDomain domain, ContainerSourceLocation createdAt) noexcept
-    : name_(name)
-    , domain_(domain)
-    , createdAt_(createdAt)
+    : DebugState(name, domain, createdAt)
   {
   }
 
   NamedVector(ContainerName name, std::initializer_list<T> values)
-    : values_(values)
-    , name_(name)
+    : DebugState(name, ContainerDomain::Unknown, ContainerSourceLocation{})
+    , values_(values)
   {
-    counters_.maxCountSeen = values_.size();
+    this->noteCount(values_.size());
   }
 
   std::size_t count() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return values_.size();
   }
 
@@ -65,7 +64,7 @@ public:
 
   bool isEmpty() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return values_.empty();
   }
 
@@ -76,7 +75,7 @@ public:
 
   std::size_t capacity() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return values_.capacity();
   }
 
@@ -172,7 +171,7 @@ public:
 
   bool hasIndex(std::size_t index) const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return index < values_.size();
   }
 
@@ -200,7 +199,7 @@ public:
       bumpFailedAccess();
       return nullptr;
     }
-    ++counters_.readCount;
+    this->noteRead();
     return &values_.front();
   }
 
@@ -210,7 +209,7 @@ public:
       bumpFailedAccess();
       return nullptr;
     }
-    ++counters_.readCount;
+    this->noteRead();
     return &values_.front();
   }
 
@@ -220,7 +219,7 @@ public:
       bumpFailedAccess();
       return nullptr;
     }
-    ++counters_.readCount;
+    this->noteRead();
     return &values_.back();
   }
 
@@ -230,7 +229,7 @@ public:
       bumpFailedAccess();
       return nullptr;
     }
-    ++counters_.readCount;
+    this->noteRead();
     return &values_.back();
   }
 
@@ -382,7 +381,7 @@ public:
 
   std::ptrdiff_t indexOf(const T& value, std::size_t from = 0) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     for (std::size_t index = from; index < values_.size(); ++index) {
       if (values_[index] == value) return static_cast<std::ptrdiff_t>(index);
     }
@@ -391,7 +390,7 @@ public:
 
   std::ptrdiff_t lastIndexOf(const T& value) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     for (std::size_t index = values_.size(); index > 0; --index) {
       if (values_[index - 1] == value) return static_cast<std::ptrdiff_t>(index - 1);
     }
@@ -400,13 +399,13 @@ public:
 
   bool startsWith(const T& value) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     return !values_.empty() && values_.front() == value;
   }
 
   bool endsWith(const T& value) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     return !values_.empty() && values_.back() == value;
   }
 
@@ -444,7 +443,7 @@ public:
   {
     NamedVector out(name);
     out.values_ = std::move(values);
-    out.counters_.maxCountSeen = out.values_.size();
+    out.noteCount(out.values_.size());
     return out;
   }
 
@@ -476,20 +475,20 @@ public:
 
   ContainerName name() const noexcept
   {
-    return name_;
+    return DebugState::name();
   }
 
   void setName(ContainerName name) noexcept
   {
-    name_ = name;
+    DebugState::setName(name);
   }
 
   ContainerDebugInfo debugInfo() const noexcept
   {
     return ContainerDebugInfo{
-      name_,
-      domain_,
-      owner_,
+      DebugState::name(),
+      DebugState::domain(),
+      DebugState::owner(),
       typeid(T).name(),
       values_.size(),
       values_.capacity(),
@@ -502,12 +501,12 @@ public:
     const auto samples = debugSample(4);
     return ContainerDebugSnapshot{
       debugInfo(),
-      counters_,
-      createdAt_,
-      lastMutatedAt_,
-      lastFailedAccessAt_,
-      lastMutation_,
-      samples
+      DebugState::counters(),
+      DebugState::createdAt(),
+      DebugState::lastMutatedAt(),
+      DebugState::lastFailedAccessAt(),
+      DebugState::lastMutation(),
+      samples.toStdVector()
     };
   }
 
@@ -531,7 +530,7 @@ public:
       || (rule.watchFailedAccess && failedAccess)
       || (rule.watchMutation && mutated);
     if (hit) {
-      callback(ContainerWatchHit{"container-watch", createdAt_, snapshot});
+      callback(ContainerWatchHit{"container-watch", DebugState::createdAt(), snapshot});
     }
     return hit;
   }
@@ -552,76 +551,78 @@ public:
 
   void setDomain(ContainerDomain domain) noexcept
   {
-    domain_ = domain;
+    DebugState::setDomain(domain);
   }
 
   ContainerDomain domain() const noexcept
   {
-    return domain_;
+    return DebugState::domain();
   }
 
   void setOwner(ContainerOwner owner) noexcept
   {
-    owner_ = owner;
+    DebugState::setOwner(owner);
   }
 
   ContainerOwner owner() const noexcept
   {
-    return owner_;
+    return DebugState::owner();
   }
 
   void setCreatedAt(ContainerSourceLocation location) noexcept
   {
-    createdAt_ = location;
+    DebugState::setCreatedAt(location);
   }
 
   void markCreatedHere(ContainerSourceLocation location) noexcept
   {
-    createdAt_ = location;
+    DebugState::setCreatedAt(location);
   }
 
   void setLastMutatedAt(ContainerSourceLocation location) noexcept
   {
-    lastMutatedAt_ = location;
+    DebugState::setLastMutatedAt(location);
   }
 
   void setLastFailedAccessAt(ContainerSourceLocation location) noexcept
   {
-    lastFailedAccessAt_ = location;
+    DebugState::setLastFailedAccessAt(location);
   }
 
   const ContainerDebugCounters& counters() const noexcept
   {
-    return counters_;
+    return DebugState::counters();
   }
 
   ContainerDebugCheckpoint debugCheckpoint() const noexcept
   {
-    return ContainerDebugCheckpoint{counters_.version, counters_.readCount, counters_.failedAccessCount};
+    const auto& counters = DebugState::counters();
+    return ContainerDebugCheckpoint{counters.version, counters.readCount, counters.failedAccessCount};
   }
 
   template <typename Callback>
   bool watchSince(const ContainerDebugCheckpoint& checkpoint, Callback&& callback) const
   {
-    const bool hit = counters_.version != checkpoint.version
-      || counters_.failedAccessCount != checkpoint.failedAccessCount;
-    if (hit) callback(ContainerWatchHit{"container-changed-since-checkpoint", createdAt_, debugSnapshot()});
+    const auto& counters = DebugState::counters();
+    const bool hit = counters.version != checkpoint.version
+      || counters.failedAccessCount != checkpoint.failedAccessCount;
+    if (hit) callback(ContainerWatchHit{"container-changed-since-checkpoint", DebugState::createdAt(), debugSnapshot()});
     return hit;
   }
 
   const ContainerMutationRecord& lastMutation() const noexcept
   {
-    return lastMutation_;
+    return DebugState::lastMutation();
   }
 
   std::size_t mutationHistorySize() const noexcept
   {
-    return mutationHistory_.size();
+    return DebugState::mutationHistorySize();
   }
 
   const ContainerMutationRecord* mutationHistoryAt(std::size_t index) const noexcept
   {
-    return index < mutationHistory_.size() ? &mutationHistory_[index] : nullptr;
+    return DebugState::mutationHistoryAt(index);
   }
 
   auto begin() noexcept { return values_.begin(); }
@@ -632,59 +633,15 @@ public:
 private:
   void recordMutation(const char* operation, std::size_t before, std::size_t after) noexcept
   {
-    ++counters_.version;
-    ++counters_.mutationCount;
-    if (after > counters_.maxCountSeen) {
-      counters_.maxCountSeen = after;
-    }
-    if (after > before) counters_.addedCount += after - before;
-    if (before > after) counters_.removedCount += before - after;
-    const auto currentCapacity = values_.capacity();
-    if (currentCapacity != observedCapacity_) {
-      ++counters_.capacityChangeCount;
-      observedCapacity_ = currentCapacity;
-    }
-    if (currentCapacity > counters_.maxCapacitySeen) counters_.maxCapacitySeen = currentCapacity;
-    const auto approximateBytes = currentCapacity * sizeof(T);
-    if (approximateBytes > counters_.maxApproximateBytesSeen) counters_.maxApproximateBytesSeen = approximateBytes;
-    lastMutatedAt_ = createdAt_;
-    lastMutation_ = ContainerMutationRecord{
-      operation,
-      createdAt_,
-      counters_.version,
-      before,
-      after,
-      ""
-    };
-    pushMutation(lastMutation_);
+    this->noteMutation(operation, before, after, values_.capacity(), values_.capacity() * sizeof(T));
   }
 
   void bumpFailedAccess() const noexcept
   {
-    ++counters_.failedAccessCount;
-    lastFailedAccessAt_ = createdAt_;
-  }
-
-  void pushMutation(const ContainerMutationRecord& record) noexcept
-  {
-    constexpr std::size_t historyCapacity = 8;
-    if (mutationHistory_.size() == historyCapacity) {
-      mutationHistory_.erase(mutationHistory_.begin());
-    }
-    mutationHistory_.push_back(record);
+    this->noteFailedAccess();
   }
 
   std::vector<T> values_;
-  ContainerName name_;
-  ContainerDomain domain_ = ContainerDomain::Unknown;
-  ContainerOwner owner_{};
-  mutable ContainerDebugCounters counters_{};
-  ContainerSourceLocation createdAt_{};
-  ContainerSourceLocation lastMutatedAt_{};
-  mutable ContainerSourceLocation lastFailedAccessAt_{};
-  ContainerMutationRecord lastMutation_{};
-  std::vector<ContainerMutationRecord> mutationHistory_;
-  std::size_t observedCapacity_ = 0;
 };
 
 template <typename T>
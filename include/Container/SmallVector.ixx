@@ -15,40 +15,42 @@ import Container.NamedVector;
 
 export namespace ArtifactCore {
 
-template <typename T, std::size_t InlineCapacity = 4>
-class SmallVector {
+template <typename T, std::size_t InlineCapacity = 4, typename Debug = ContainerDebugDefault>
+class SmallVector : private ContainerDebugState<Debug::enabled> {
+  using DebugState = ContainerDebugState<Debug::enabled>;
+
 public:
   using Value = T;
+  using DebugPolicy = Debug;
   static constexpr std::size_t kInlineCapacity = InlineCapacity;
 
-  SmallVector() noexcept = default;
+  SmallVector() noexcept
+    : DebugState(ContainerName{}, ContainerDomain::Unknown, ContainerSourceLocation{}, kInlineCapacity)
+  {
+  }
 
   explicit SmallVector(ContainerName name) noexcept
-    : name_(name)
+    : DebugState(name, ContainerDomain::Unknown, ContainerSourceLocation{}, kInlineCapacity)
   {
   }
 
   SmallVector(ContainerName name, ContainerSourceLocation createdAt) noexcept
-    : name_(name)
-    , createdAt_(createdAt)
+    : DebugState(name, ContainerDomain::Unknown, createdAt, kInlineCapacity)
   {
   }
 
   SmallVector(ContainerName name, ContainerDomain domain) noexcept
-    : name_(name)
-    , domain_(domain)
+    : DebugState(name, domain, ContainerSourceLocation{}, kInlineCapacity)
   {
   }
 
   SmallVector(ContainerName name, ContainerDomain domain, ContainerSourceLocation createdAt) noexcept
-    : name_(name)
-    , domain_(domain)
-    , createdAt_(createdAt)
+    : DebugState(name, domain, createdAt, kInlineCapacity)
   {
   }
 
   SmallVector(ContainerName name, std::initializer_list<T> values)
-    : name_(name)
+    : DebugState(name, ContainerDomain::Unknown, ContainerSourceLocation{}, kInlineCapacity)
   {
     reserve(values.size());
     for (const auto& v : values) {
@@ -65,16 +67,8 @@ public:
   }
 
   SmallVector(const SmallVector& other)
-    : name_(other.name_)
-    , domain_(other.domain_)
-    , owner_(other.owner_)
-    , createdAt_(other.createdAt_)
-    , counters_(other.counters_)
-    , lastMutatedAt_(other.lastMutatedAt_)
-    , lastFailedAccessAt_(other.lastFailedAccessAt_)
-    , lastMutation_(other.lastMutation_)
-  {
-    mutationHistory_ = other.mutationHistory_;
+    : DebugState(other)
+  {
     reserve(other.size_);
     for (std::size_t i = 0; i < other.size_; ++i) {
       new (data_ + i) T(other.data_[i]);
@@ -91,30 +85,14 @@ public:
         new (data_ + i) T(other.data_[i]);
       }
       size_ = other.size_;
-      name_ = other.name_;
-      domain_ = other.domain_;
-      owner_ = other.owner_;
-      createdAt_ = other.createdAt_;
-      counters_ = other.counters_;
-      lastMutatedAt_ = other.lastMutatedAt_;
-      lastFailedAccessAt_ = other.lastFailedAccessAt_;
-      lastMutation_ = other.lastMutation_;
-      mutationHistory_ = other.mutationHistory_;
+      DebugState::operator=(other);
     }
     return *this;
   }
 
   SmallVector(SmallVector&& other) noexcept
-    : name_(other.name_)
-    , domain_(other.domain_)
-    , owner_(other.owner_)
-    , createdAt_(other.createdAt_)
-    , counters_(other.counters_)
-    , lastMutatedAt_(other.lastMutatedAt_)
-    , lastFailedAccessAt_(other.lastFailedAccessAt_)
-    , lastMutation_(other.lastMutation_)
-  {
-    mutationHistory_ = std::move(other.mutationHistory_);
+    : DebugState(static_cast<const DebugState&>(other))
+  {
     if (!other.isInline()) {
       data_ = other.data_;
       heap_ = other.heap_;
@@ -154,15 +132,7 @@ public:
         }
       }
       size_ = other.size_;
-      name_ = other.name_;
-      domain_ = other.domain_;
-      owner_ = other.owner_;
-      createdAt_ = other.createdAt_;
-      counters_ = other.counters_;
-      lastMutatedAt_ = other.lastMutatedAt_;
-      lastFailedAccessAt_ = other.lastFailedAccessAt_;
-      lastMutation_ = other.lastMutation_;
-      mutationHistory_ = std::move(other.mutationHistory_);
+      DebugState::operator=(static_cast<const DebugState&>(other));
 
       other.data_ = reinterpret_cast<T*>(other.inline_);
       other.size_ = 0;
@@ -174,7 +144,7 @@ public:
 
   std::size_t count() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return size_;
   }
 
@@ -185,7 +155,7 @@ public:
 
   bool isEmpty() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return size_ == 0;
   }
 
@@ -196,7 +166,7 @@ public:
 
   std::size_t capacity() const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return capacity_;
   }
 
@@ -319,7 +289,7 @@ public:
 
   bool hasIndex(std::size_t index) const noexcept
   {
-    ++counters_.readCount;
+    this->noteRead();
     return index < size_;
   }
 
@@ -357,7 +327,7 @@ public:
       bumpFailedAccess();
       return nullptr;
     }
-    ++counters_.readCount;
+    this->noteRead();
     return data_;
   }
 
@@ -367,7 +337,7 @@ public:
       bumpFailedAccess();
       return nullptr;
     }
-    ++counters_.readCount;
+    this->noteRead();
     return data_;
   }
 
@@ -377,7 +347,7 @@ public:
       bumpFailedAccess();
       return nullptr;
     }
-    ++counters_.readCount;
+    this->noteRead();
     return data_ + size_ - 1;
   }
 
@@ -387,7 +357,7 @@ public:
       bumpFailedAccess();
       return nullptr;
     }
-    ++counters_.readCount;
+    this->noteRead();
     return data_ + size_ - 1;
   }
 
@@ -542,7 +512,7 @@ public:
 
   std::ptrdiff_t indexOf(const T& value, std::size_t from = 0) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     for (std::size_t index = from; index < size_; ++index) {
       if (data_[index] == value) return static_cast<std::ptrdiff_t>(index);
     }
@@ -551,7 +521,7 @@ public:
 
   std::ptrdiff_t lastIndexOf(const T& value) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     for (std::size_t index = size_; index > 0; --index) {
       if (data_[index - 1] == value) return static_cast<std::ptrdiff_t>(index - 1);
     }
@@ -560,13 +530,13 @@ public:
 
   bool startsWith(const T& value) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     return size_ != 0 && data_[0] == value;
   }
 
   bool endsWith(const T& value) const
   {
-    ++counters_.readCount;
+    this->noteRead();
     return size_ != 0 && data_[size_ - 1] == value;
   }
 
@@ -639,94 +609,96 @@ public:
 
   ContainerName name() const noexcept
   {
-    return name_;
+    return DebugState::name();
   }
 
   void setName(ContainerName name) noexcept
   {
-    name_ = name;
+    DebugState::setName(name);
   }
 
   ContainerDomain domain() const noexcept
   {
-    return domain_;
+    return DebugState::domain();
   }
 
   void setDomain(ContainerDomain domain) noexcept
   {
-    domain_ = domain;
+    DebugState::setDomain(domain);
   }
 
   ContainerOwner owner() const noexcept
   {
-    return owner_;
+    return DebugState::owner();
   }
 
   void setOwner(ContainerOwner owner) noexcept
   {
-    owner_ = owner;
+    DebugState::setOwner(owner);
   }
 
   void setCreatedAt(ContainerSourceLocation location) noexcept
   {
-    createdAt_ = location;
+    DebugState::setCreatedAt(location);
   }
 
   void markCreatedHere(ContainerSourceLocation location) noexcept
   {
-    createdAt_ = location;
+    DebugState::setCreatedAt(location);
   }
 
   void setLastMutatedAt(ContainerSourceLocation location) noexcept
   {
-    lastMutatedAt_ = location;
+    DebugState::setLastMutatedAt(location);
   }
 
   void setLastFailedAccessAt(ContainerSourceLocation location) noexcept
   {
-    lastFailedAccessAt_ = location;
+    DebugState::setLastFailedAccessAt(location);
   }
 
   const ContainerDebugCounters& counters() const noexcept
   {
-    return counters_;
+    return DebugState::counters();
   }
 
   ContainerDebugCheckpoint debugCheckpoint() const noexcept
   {
-    return ContainerDebugCheckpoint{counters_.version, counters_.readCount, counters_.failedAccessCount};
+    const auto& counters = DebugState::counters();
+    return ContainerDebugCheckpoint{counters.version, counters.readCount, counters.failedAccessCount};
   }
 
   template <typename Callback>
   bool watchSince(const ContainerDebugCheckpoint& checkpoint, Callback&& callback) const
   {
-    const bool hit = counters_.version != checkpoint.version
-      || counters_.failedAccessCount != checkpoint.failedAccessCount;
-    if (hit) callback(ContainerWatchHit{"smallvector-changed-since-checkpoint", createdAt_, debugSnapshot()});
+    const auto& counters = DebugState::counters();
+    const bool hit = counters.version != checkpoint.version
+      || counters.failedAccessCount != checkpoint.failedAccessCount;
+    if (hit) callback(ContainerWatchHit{"smallvector-changed-since-checkpoint", DebugState::createdAt(), debugSnapshot()});
     return hit;
   }
 
   const ContainerMutationRecord& lastMutation() const noexcept
   {
-    return lastMutation_;
+    return DebugState::lastMutation();
   }
 
   std::size_t mutationHistorySize() const noexcept
   {
-    return mutationHistory_.size();
+    return DebugState::mutationHistorySize();
   }
 
   const ContainerMutationRecord* mutationHistoryAt(std::size_t index) const noexcept
   {
-    return index < mutationHistory_.size() ? &mutationHistory_[index] : nullptr;
+    return DebugState::mutationHistoryAt(index);
   }
 
   ContainerDebugInfo debugInfo() const noexcept
   {
     return ContainerDebugInfo{
-      name_,
-      domain_,
-      owner_,
+      DebugState::name(),
+      DebugState::domain(),
+      DebugState::owner(),
       typeid(T).name(),
       size_,
       capacity_,
@@ -739,12 +711,12 @@ public:
     const auto samples = debugSample(4);
     return ContainerDebugSnapshot{
       debugInfo(),
-      counters_,
-      createdAt_,
-      lastMutatedAt_,
-      lastFailedAccessAt_,
-      lastMutation_,
-      samples
+      DebugState::counters(),
+      DebugState::createdAt(),
+      DebugState::lastMutatedAt(),
+      DebugState::lastFailedAccessAt(),
+      DebugState::lastMutation(),
+      samples.toStdVector()
     };
   }
 
@@ -778,7 +750,7 @@ public:
       || (rule.watchFailedAccess && failedAccess)
       || (rule.watchMutation && mutated);
     if (hit) {
-      callback(ContainerWatchHit{"smallvector-watch", createdAt_, snapshot});
+      callback(ContainerWatchHit{"smallvector-watch", DebugState::createdAt(), snapshot});
     }
     return hit;
   }
@@ -835,50 +807,17 @@ private:
 
   void updateMaxCount() noexcept
   {
-    if (size_ > counters_.maxCountSeen) {
-      counters_.maxCountSeen = size_;
-    }
+    this->noteCount(size_);
   }
 
   void recordMutation(const char* operation, std::size_t before, std::size_t after) noexcept
   {
-    ++counters_.version;
-    ++counters_.mutationCount;
-    if (after > counters_.maxCountSeen) counters_.maxCountSeen = after;
-    if (after > before) counters_.addedCount += after - before;
-    if (before > after) counters_.removedCount += before - after;
-    if (capacity_ != observedCapacity_) {
-      ++counters_.capacityChangeCount;
-      observedCapacity_ = capacity_;
-    }
-    if (capacity_ > counters_.maxCapacitySeen) counters_.maxCapacitySeen = capacity_;
-    const auto approximateBytes = capacity_ * sizeof(T);
-    if (approximateBytes > counters_.maxApproximateBytesSeen) counters_.maxApproximateBytesSeen = approximateBytes;
-    lastMutatedAt_ = createdAt_;
-    lastMutation_ = ContainerMutationRecord{
-      operation,
-      createdAt_,
-      counters_.version,
-      before,
-      after,
-      ""
-    };
-    pushMutation(lastMutation_);
+    this->noteMutation(operation, before, after, capacity_, capacity_ * sizeof(T));
   }
 
   void bumpFailedAccess() const noexcept
   {
-    ++counters_.failedAccessCount;
-    lastFailedAccessAt_ = createdAt_;
-  }
-
-  void pushMutation(const ContainerMutationRecord& record) noexcept
-  {
-    constexpr std::size_t historyCapacity = 8;
-    if (mutationHistory_.size() == historyCapacity) {
-      mutationHistory_.erase(mutationHistory_.begin());
-    }
-    mutationHistory_.push_back(record);
+    this->noteFailedAccess();
   }
 
   alignas(T) unsigned char inline_[sizeof(T) * kInlineCapacity]{};
@@ -886,17 +825,6 @@ private:
   std::size_t size_ = 0;
   std::size_t capacity_ = kInlineCapacity;
   T* heap_ = nullptr;
-
-  ContainerName name_;
-  ContainerDomain domain_ = ContainerDomain::Unknown;
-  ContainerOwner owner_{};
-  mutable ContainerDebugCounters counters_{};
-  ContainerSourceLocation createdAt_{};
-  ContainerSourceLocation lastMutatedAt_{};
-  mutable ContainerSourceLocation lastFailedAccessAt_{};
-  ContainerMutationRecord lastMutation_{};
-  std::vector<ContainerMutationRecord> mutationHistory_;
-  std::size_t observedCapacity_ = kInlineCapacity;
 };
 
 template <typename T, std::size_t N = 4>
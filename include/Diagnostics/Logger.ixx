@@ -4,8 +4,13 @@ module;
 #include <array>
 #include <atomic>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <concepts>
+#include <string_view>
 
 #include <mutex>
+#include <algorithm>
 #include <wobjectdefs.h>
 #include <QFile>
 #include <QString>
@@ -46,14 +51,50 @@ enum class LogCategory : std::uint32_t {
     Diagnostics
 };
 
-struct FastLogRecord {
-    std::uint64_t timestampTicks = 0;
-    std::uint32_t category = 0;
-    std::uint32_t threadId = 0;
-    std::uint32_t frame = 0xffffffffu;
-    std::uint16_t level = 0;
-    std::uint16_t length = 0;
-    std::array<char, 192> message{};
+// Format id for deferred logging. format must have static storage duration;
+// its %1..%n placeholders are filled on the drain thread.
+struct LogFormatSite {
+    const char* format = "";
+    LogLevel level = LogLevel::Info;
+    LogCategory category = LogCategory::General;
+};
+
+// A raw deferred-log argument. Strings are copied and cut at kTextCapacity bytes.
+struct LogArg {
+    enum class Type : std::uint8_t { Int, UInt, Double, Bool, Text };
+    static constexpr std::size_t kTextCapacity = 31;
+
+    Type type = Type::Int;
+    std::uint8_t length = 0;
+    union {
+        std::int64_t i;
+        std::uint64_t u;
+        double d;
+        bool b;
+        char text[kTextCapacity + 1];
+    };
+
+    LogArg() : i(0) {}
+    LogArg(bool value) : type(Type::Bool), b(value) {}
+    template <std::signed_integral T>
+    LogArg(T value) : type(Type::Int), i(value) {}
+    template <std::unsigned_integral T>
+    LogArg(T value) : type(Type::UInt), u(value) {}
+    template <std::floating_point T>
+    LogArg(T value) : type(Type::Double), d(value) {}
+    LogArg(std::string_view value) : type(Type::Text) {
+        length = static_cast<std::uint8_t>(std::min(value.size(), kTextCapacity));
+        std::memcpy(text, value.data(), length);
+        text[length] = '\0';
+    }
+    LogArg(const char* value) : LogArg(std::string_view(value ? value : "")) {}
+};
+
+struct AsyncLogStats {
+    std::uint64_t enqueued = 0;
+    std::uint64_t dropped = 0;
+    std::uint64_t drained = 0;
+    std::size_t threadQueues = 0;
 };
 
 struct LogMessage {
@@ -81,7 +122,32 @@ public:
     std::vector<LogMessage> getLogs() const;
     void clearLogs();
 
+    // With the async backend running (install() starts it), every logging
+    // call only appends to the calling thread's lock-free ring; a background
+    // thread formats records and writes the memory and file sinks. A full
+    // ring drops the record and counts it instead of blocking.
+    void startAsyncBackend();
+    void stopAsyncBackend();
+    bool asyncBackendRunning() const noexcept;
+    // Drains everything queued so far into the sinks on the calling thread.
+    void flush();
+    AsyncLogStats asyncStats() const noexcept;
+
+    static constexpr std::size_t kMaxLogArgs = 6;
+    template <typename... Args>
+    bool logDeferred(const LogFormatSite& site, std::uint32_t frame, const Args&... args) noexcept {
+        static_assert(sizeof...(Args) <= kMaxLogArgs, "too many deferred log arguments");
+        const LogArg packed[sizeof...(Args) + 1] = { LogArg(args)... };
+        return enqueueDeferred(site, frame, packed, sizeof...(Args));
+    }
+    bool enqueueDeferred(const LogFormatSite& site, std::uint32_t frame,
+                         const LogArg* args, std::size_t argCount) noexcept;
+
     void appendLog(LogLevel level, const QString& message, const QString& context = "");
+    // Qt message handler entry: the file/line/function context is formatted
+    // on the drain thread. file and function must be static strings.
+    void appendQtMessage(LogLevel level, const QString& message, const char* file,
+                         int line, const char* function);
     bool tryFastLog(LogLevel level, LogCategory category, const char* message,
                     std::uint32_t frame = 0xffffffffu) noexcept;
     bool tryFastLogFormat(LogLevel level, LogCategory category, std::uint32_t frame,
@@ -108,6 +174,10 @@ private:
     bool ensureLogFileReady();
     void writeLineToLogFile(const QString& line);
     QString formatLogLine(const LogMessage& logMsg) const;
+    // Adds messages to the memory and file sinks and emits logAdded.
+    void commitLogs(std::vector<LogMessage>& messages);
+
+    class AsyncBackend;
 
     Logger(QObject* parent = nullptr);
 
@@ -123,12 +193,7 @@ public:
     bool fileLoggingEnabled_ = false;
     std::uint64_t maxLogFileBytes_ = 10ull * 1024ull * 1024ull;
     LogFileFormat logFileFormat_ = LogFileFormat::Text;
-    static constexpr std::size_t fastLogCapacity_ = 8192;
-    std::array<FastLogRecord, fastLogCapacity_> fastLogBuffer_{};
-    std::atomic<std::size_t> fastLogWrite_{0};
-    std::atomic<std::size_t> fastLogRead_{0};
-    std::atomic<std::uint64_t> fastLogDropped_{0};
-    std::atomic_flag fastLogProducerLock_ = ATOMIC_FLAG_INIT;
+    std::unique_ptr<AsyncBackend> async_;
     std::array<std::atomic_bool, 12> categoryEnabled_{};
 };
 
@@ -1,6 +1,7 @@
 module;
 #include <concepts>
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -128,11 +129,32 @@ public:
         post<Event>(EventPriority::Normal, std::forward<Event>(event), origin);
     }
 
+    // Coalescing post: while an event of the same type and key is still
+    // queued, later posts only replace its payload, so a drain delivers the
+    // latest value once. Intended for high-rate state such as frame dispatch
+    // or task progress. The event keeps the priority it was first queued with.
+    template<typename Event>
+    void postLatest(Event&& event, std::uint64_t key = 0,
+                    EventPriority priority = EventPriority::Normal,
+                    std::source_location origin = std::source_location::current()) {
+        using EventType = std::remove_cvref_t<Event>;
+        auto payload = makeShared<EventType>(std::forward<Event>(event));
+        auto rawPayload = staticPointerCast<const void>(payload);
+        enqueueLatestRaw(std::type_index(typeid(EventType)), key, std::move(rawPayload),
+                         &EventBus::dispatchQueued<EventType>, priority, origin);
+    }
+
+    // Delivers queued events, highest priority first and FIFO within a
+    // priority. Posting never blocks on drain: producers push onto lock-free
+    // stacks, and drain detaches them in batches and dispatches without
+    // holding any lock, so subscribers may post or drain re-entrantly.
     [[nodiscard]] std::size_t drain(std::size_t maxEvents = std::numeric_limits<std::size_t>::max());
     void clear();
     void clearQueue();
 
     [[nodiscard]] std::size_t pendingCount() const noexcept;
+    // Number of postLatest calls merged into an already queued event
+    [[nodiscard]] std::size_t coalescedCount() const noexcept;
 
     // Debug observability
     using PublishHook = std::function<void(std::type_index, std::string_view /*name*/, std::size_t /*delivered*/, std::int64_t /*durationNs*/, std::source_location /*origin*/)>;
@@ -156,6 +178,9 @@ private:
                     void (*dispatch)(EventBus&, const void*, std::source_location),
                     EventPriority priority = EventPriority::Normal,
                     std::source_location origin = std::source_location::current());
+    void enqueueLatestRaw(std::type_index type, std::uint64_t key, SharedPtr<const void> payload,
+                          void (*dispatch)(EventBus&, const void*, std::source_location),
+                          EventPriority priority, std::source_location origin);
     std::size_t subscriberCountRaw(std::type_index type) const noexcept;
 
     template<typename EventType>
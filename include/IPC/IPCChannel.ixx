@@ -14,6 +14,7 @@ enum class IPCTransport { SharedMemory, LocalSocket, TcpSocket, Pipe };
 struct IPCChannelConfig {
     IPCTransport transport = IPCTransport::SharedMemory;
     QString name;
+    // Largest single message (and batch) on the wire; both ends must agree.
     std::size_t bufferSize = 65536;
     int timeoutMs = 5000;
     bool encrypted = false;
@@ -25,11 +26,15 @@ public:
     static std::unique_ptr<IPCChannel> create(const IPCChannelConfig& config);
     ~IPCChannel();
 
+    // Over shared memory, send() waits up to timeoutMs for the peer to make
+    // room instead of dropping the message.
     bool send(const QByteArray& message);
     QByteArray receive();
     QByteArray receiveBlocking(int timeoutMs = -1);
     bool sendZeroCopy(const std::uint8_t* data, std::size_t size);
     bool receiveZeroCopy(std::uint8_t* buffer, std::size_t maxSize, std::size_t& received);
+    // Between these, shared-memory sends are packed into one ring entry per
+    // bufferSize bytes; endStream() flushes the last partial batch.
     bool beginStream();
     bool endStream();
     bool isConnected() const;
@@ -1,7 +1,9 @@
 module;
 #include <QString>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <span>
 
 export module IPC.RenderFarmSharedBuffer;
 
@@ -9,13 +11,42 @@ import Image.ImageF32x4_RGBA;
 
 export namespace ArtifactCore::IPC {
 
+enum class SharedFrameFormat : std::uint32_t {
+    RGBA32F = 0,
+    RGBA16F = 1     // IEEE half; halves the bytes moved per frame
+};
+
+// Pixel placement inside a slot. With tileSize == 0 pixels are stored as
+// scanlines; otherwise as tileSize x tileSize tiles in row-major tile order,
+// each tile's pixels row-major and edge tiles clipped (no padding).
+struct SharedFrameLayout {
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    SharedFrameFormat format = SharedFrameFormat::RGBA32F;
+    std::uint32_t tileSize = 0;
+
+    std::size_t bytesPerPixel() const {
+        return format == SharedFrameFormat::RGBA16F ? 4u * sizeof(std::uint16_t) : 4u * sizeof(float);
+    }
+    std::size_t pixelCount() const { return static_cast<std::size_t>(width) * height; }
+    std::size_t byteSize() const { return pixelCount() * bytesPerPixel(); }
+    // Index of the pixel's first channel, in channel elements.
+    std::size_t elementIndex(std::uint32_t x, std::uint32_t y) const;
+};
+
 class RenderFarmSharedBuffer {
+    class Impl;
+
 public:
     struct Config {
         QString bufferName;
         std::size_t totalSizeMB = 1024;
         std::uint32_t maxFrameWidth = 4096;
         std::uint32_t maxFrameHeight = 4096;
+        SharedFrameFormat pixelFormat = SharedFrameFormat::RGBA32F;
+        std::uint32_t tileSize = 0;
+        // 0 derives the count from totalSizeMB (at least two slots).
+        std::uint32_t slotCount = 0;
     };
 
     struct FrameWriteResult {
@@ -32,15 +63,94 @@ public:
         QString error;
     };
 
+    // A slot the producer renders into. Destroying it without publish()
+    // hands the slot back unused.
+    class WriteSlot {
+    public:
+        WriteSlot() = default;
+        WriteSlot(WriteSlot&& other) noexcept;
+        WriteSlot& operator=(WriteSlot&& other) noexcept;
+        ~WriteSlot();
+
+        bool isValid() const { return owner_ != nullptr; }
+        const SharedFrameLayout& layout() const { return layout_; }
+        std::int64_t frameNumber() const { return frameNumber_; }
+
+        // Direct views of the mapped slot; empty when the format differs.
+        std::span<float> rgba32f();
+        std::span<std::uint16_t> rgba16f();
+        std::span<std::byte> bytes();
+
+        // Converts (and tiles) a finished image into the slot.
+        bool storeFrom(const ImageF32x4_RGBA& frame);
+        FrameWriteResult publish();
+
+    private:
+        friend class RenderFarmSharedBuffer;
+        Impl* owner_ = nullptr;
+        std::uint32_t slot_ = 0;
+        std::byte* data_ = nullptr;
+        SharedFrameLayout layout_;
+        std::int64_t frameNumber_ = 0;
+    };
+
+    // Read-only view of a published frame. The slot stays reserved until the
+    // view is released or destroyed; views must not outlive the buffer.
+    class FrameView {
+    public:
+        FrameView() = default;
+        FrameView(FrameView&& other) noexcept;
+        FrameView& operator=(FrameView&& other) noexcept;
+        ~FrameView();
+
+        bool isValid() const { return owner_ != nullptr; }
+        const SharedFrameLayout& layout() const { return layout_; }
+        std::int64_t frameNumber() const { return frameNumber_; }
+        std::uint64_t sequence() const { return sequence_; }
+        std::uint64_t timestampNs() const { return timestampNs_; }
+
+        std::span<const float> rgba32f() const;
+        std::span<const std::uint16_t> rgba16f() const;
+        std::span<const std::byte> bytes() const;
+
+        // Converts to scanline RGBA32F.
+        bool copyTo(ImageF32x4_RGBA& frame) const;
+        void release();
+
+    private:
+        friend class RenderFarmSharedBuffer;
+        Impl* owner_ = nullptr;
+        std::uint32_t slot_ = 0;
+        const std::byte* data_ = nullptr;
+        SharedFrameLayout layout_;
+        std::int64_t frameNumber_ = 0;
+        std::uint64_t sequence_ = 0;
+        std::uint64_t timestampNs_ = 0;
+    };
+
     static std::unique_ptr<RenderFarmSharedBuffer> createConsumer(const Config& config);
     static std::unique_ptr<RenderFarmSharedBuffer> openProducer(const QString& bufferName);
 
     ~RenderFarmSharedBuffer();
+
+    // Zero-copy path: acquire a slot, render into it, publish. Waits up to
+    // timeoutMs for a free slot; an invalid slot means the consumer is behind.
+    WriteSlot acquireWriteSlot(std::int64_t frameNumber, std::uint32_t width,
+                               std::uint32_t height, int timeoutMs = 0);
+    // Oldest published frame, or an invalid view when none is ready.
+    FrameView acquireNextFrame(int timeoutMs = 0);
+
+    // Copying conveniences built on the slot API (one copy each way).
+    // compressionFlags is kept for compatibility; the buffer's pixelFormat
+    // decides the stored format.
     FrameWriteResult writeFrame(std::int64_t frameNumber, const ImageF32x4_RGBA& frame,
                                 std::uint32_t compressionFlags = 0);
     FrameReadResult readNextFrame();
     FrameReadResult readFrame(std::int64_t frameNumber);
 
+    SharedFrameFormat pixelFormat() const;
+    std::uint32_t tileSize() const;
+    std::uint32_t slotCount() const;
     int pendingFrameCount() const;
     std::size_t usedMemoryMB() const;
     std::size_t totalMemoryMB() const;
@@ -50,7 +160,6 @@ public:
     void close();
 
 private:
-    class Impl;
     explicit RenderFarmSharedBuffer(std::unique_ptr<Impl> impl);
     std::unique_ptr<Impl> impl_;
 };
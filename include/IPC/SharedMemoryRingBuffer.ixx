@@ -12,7 +12,16 @@ export module IPC.SharedMemoryRingBuffer;
 export namespace ArtifactCore::IPC {
 
 inline constexpr std::uint32_t kRingBufferMagic = 0x41524246; // ARBF
-inline constexpr std::uint32_t kRingBufferVersion = 1;
+inline constexpr std::uint32_t kRingBufferVersion = 2;
+
+// Wake-up word for one direction of a ring. A side that has to block bumps
+// waiters, re-checks the indices and parks on sequence (a futex on Linux, a
+// named event on Windows); the other side only makes a syscall when waiters
+// is non-zero, so an uncontended write or read stays in user space.
+struct RingBufferDoorbell {
+    std::atomic<std::uint32_t> sequence{0};
+    std::atomic<std::uint32_t> waiters{0};
+};
 
 struct alignas(64) RingBufferHeader {
     alignas(64) std::atomic<std::uint64_t> writeIndex{0};
@@ -22,6 +31,8 @@ struct alignas(64) RingBufferHeader {
     std::uint32_t magic = kRingBufferMagic;
     std::uint32_t version = kRingBufferVersion;
     char name[64] = {};
+    alignas(64) RingBufferDoorbell dataReady;
+    alignas(64) RingBufferDoorbell spaceReady;
 };
 
 struct alignas(8) RingBufferEntryHeader {
@@ -78,7 +89,11 @@ public:
 
     WriteResult write(const std::uint8_t* data, std::size_t size, std::uint32_t flags = 0);
     WriteResult write(const QByteArray& data, std::uint32_t flags = 0);
+    // Waits up to timeoutMs for room instead of failing with "Buffer full".
+    WriteResult writeBlocking(const std::uint8_t* data, std::size_t size, std::uint32_t flags,
+                              int timeoutMs);
     ReadResult read();
+    // Spins briefly, then parks on the ring's doorbell until an entry arrives.
     ReadResult readBlocking(int timeoutMs);
     ReadResult readSequence(std::uint64_t sequenceNumber);
 
@@ -89,6 +104,8 @@ public:
     void reset();
     void close();
 
+    // Named semaphores for callers that coordinate on them explicitly. The ring
+    // no longer releases them per entry; blocking calls use the doorbells.
     QSystemSemaphore* writeSemaphore();
     QSystemSemaphore* readSemaphore();
     Stats stats() const;
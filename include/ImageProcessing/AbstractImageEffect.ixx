@@ -2,6 +2,7 @@ module;
 
 #include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <utility>
@@ -59,6 +60,7 @@ export import ImageProcessing.NegateCS;
 export import ImageProcessing.ScatterCS;
 export import ImageProcessing.SimpleChokerCS;
 import ImageF32x4;
+import Memory.ArtifactAllocators;
 import Memory.SharedPtr;
 
 export namespace ArtifactCore {
@@ -99,8 +101,16 @@ public:
     SharedPtr<AbstractImageEffect> next() const { return next_; }
 
     void chainProcess(ImageF32x4_RGBA& image);
+    // Runs the chain with frameArenas installed on the calling thread, so
+    // every effect's scratchResource() comes from that frame's arena.
+    void chainProcess(ImageF32x4_RGBA& image, FrameArenaPool& frameArenas);
 
 protected:
+    // Temporaries for process(). Under chainProcess(image, frameArenas) this is
+    // the calling thread's frame arena, released in one go when the next frame
+    // begins; otherwise it is the default resource.
+    static std::pmr::memory_resource* scratchResource() { return frameScratchResource(); }
+
     SharedPtr<AbstractImageEffect> next_;
     std::vector<std::pair<std::string, double>> paramValues_;
 
@@ -7,6 +7,8 @@ module;
 
 export module Math.ArtifactMinMax;
 
+import Core.Parallel;
+
 export namespace ArtifactCore {
 
 template<typename T>
@@ -71,6 +73,38 @@ inline MinMaxResult safeNormalizeRange(double value, double minVal, double maxVa
     return MinMaxResult{safeMin, safeMax};
 }
 
+/// 配列全体の最小値・最大値を非有限値（NaN / ±inf）を無視して並列に求める
+/// 有限値が 1 つもない場合は {0.0, 0.0} を返す
+template<typename T>
+MinMaxResult artifactMinMax(const T* data, int count, int grain = 16384) {
+    static_assert(std::is_arithmetic_v<T>, "artifactMinMax requires arithmetic type");
+    constexpr double kEmptyMin = std::numeric_limits<double>::infinity();
+    constexpr double kEmptyMax = -std::numeric_limits<double>::infinity();
+    if (!data || count <= 0) {
+        return MinMaxResult{0.0, 0.0};
+    }
+
+    const MinMaxResult result = Parallel::Reduce(0, count, grain,
+        MinMaxResult{kEmptyMin, kEmptyMax},
+        [data](ParallelRange range, MinMaxResult accum) {
+            for (int i = range.begin; i < range.end; ++i) {
+                const double value = static_cast<double>(data[i]);
+                if (!std::isfinite(value)) continue;
+                accum.min = artifactMin(accum.min, value);
+                accum.max = artifactMax(accum.max, value);
+            }
+            return accum;
+        },
+        [](MinMaxResult lhs, const MinMaxResult& rhs) {
+            return MinMaxResult{artifactMin(lhs.min, rhs.min), artifactMax(lhs.max, rhs.max)};
+        });
+
+    if (result.min > result.max) {
+        return MinMaxResult{0.0, 0.0};
+    }
+    return result;
+}
+
 template<typename T>
 constexpr T clamp(T value, T minVal, T maxVal) noexcept {
     return artifactMax(minVal, artifactMin(value, maxVal));
@@ -54,10 +54,16 @@ public:
     // octaves: 重ね合わせる層の数, persistence: 各層の振幅の減衰率, lacunarity: 各層の周波数の倍率
     static float fractal(float x, float y, float z, int octaves = 4, float persistence = 0.5f, float lacunarity = 2.0f);
 
+    // Batch evaluation: out[i] = perlin(x[i], y[i], z[i]) / fractal(...)
+    // 結果はスカラー版とビット単位で一致する。y / z は nullptr なら 0 として扱う。
+    static void perlinBatch(const float* x, const float* y, const float* z, float* out, int count);
+    static void fractalBatch(const float* x, const float* y, const float* z, float* out, int count,
+                             int octaves = 4, float persistence = 0.5f, float lacunarity = 2.0f);
+
     // Worley Noise / Voronoi Noise (F1, F2 などを返せるように拡張可能)
     static float worley(float x, float y, float z);
 
-    // シード値の設定
+    // シード値の設定。式評価の memo 結果（noise / wiggle）も無効化する
     static void setSeed(unsigned int seed);
 
     // GPU shader source helpers
@@ -68,6 +74,7 @@ public:
                        float lacunarity = 2.0f) const;
 
 private:
+    static float perlinUnchecked(float x, float y, float z);
     static float fade(float t);
     static float lerp(float t, float a, float b);
     static float grad(int hash, float x, float y, float z);
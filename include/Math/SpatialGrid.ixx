@@ -5,10 +5,13 @@ module;
 #include <algorithm>
 #include <cstdint>
 #include <functional>
+#include <array>
+#include <cstddef>
 
 export module Math.SpatialGrid;
 
 import Particle;
+import Core.Parallel;
 
 namespace ArtifactCore {
 
@@ -102,4 +105,226 @@ private:
     std::vector<Entry> grid_;
 };
 
+/**
+ * @brief Cell list for fixed-radius neighbor search over a particle set.
+ *
+ * build() sorts the particles by the Morton code of their cell, so particles
+ * that are close in space are close in order(). Gathering per-particle data
+ * through order() gives the pair loops contiguous memory per cell.
+ *
+ * Each cell only visits its own pairs and 13 of its 26 neighbor cells (the
+ * "forward" half), so every unordered pair within one cell of distance is
+ * produced exactly once. Cells are also split into 27 colors by
+ * (x mod 3, y mod 3, z mod 3). Two cells of the same color are at least
+ * three cells apart on some axis, so their pair sets touch disjoint
+ * particles, and forEachPairParallel() can process a color without locks.
+ *
+ * The cell size must be at least the interaction radius.
+ */
+export class SpatialCellList {
+public:
+    void clear() {
+        order_.clear();
+        cellKeys_.clear();
+        cellStart_.clear();
+        cellCoords_.clear();
+        neighborStart_.clear();
+        neighborCells_.clear();
+        for (auto& cells : colorCells_) cells.clear();
+    }
+
+    /**
+     * @brief Builds the cell list for count positions with the given cell size.
+     */
+    void build(const float3* positions, std::size_t count, float cellSize) {
+        clear();
+        if (!positions || count == 0 || !(cellSize > 0.0f) || !std::isfinite(cellSize)) return;
+        cellSize_ = cellSize;
+        const float inverse = 1.0f / cellSize;
+
+        keyed_.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const float3& p = positions[i];
+            keyed_[i] = {mortonKey(cellCoord(p.x * inverse), cellCoord(p.y * inverse), cellCoord(p.z * inverse)),
+                         static_cast<uint32_t>(i)};
+        }
+        radixSort();
+
+        order_.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            order_[i] = keyed_[i].index;
+            if (i == 0 || keyed_[i].key != keyed_[i - 1].key) {
+                cellKeys_.push_back(keyed_[i].key);
+                cellStart_.push_back(static_cast<uint32_t>(i));
+                cellCoords_.push_back(decodeMorton(keyed_[i].key));
+            }
+        }
+        cellStart_.push_back(static_cast<uint32_t>(count));
+
+        // Half stencil: the 13 offsets that are lexicographically after (0,0,0).
+        static constexpr int kForward[13][3] = {
+            {1, 0, 0},
+            {-1, 1, 0}, {0, 1, 0}, {1, 1, 0},
+            {-1, -1, 1}, {0, -1, 1}, {1, -1, 1},
+            {-1, 0, 1}, {0, 0, 1}, {1, 0, 1},
+            {-1, 1, 1}, {0, 1, 1}, {1, 1, 1},
+        };
+        neighborStart_.reserve(cellKeys_.size() + 1);
+        for (std::size_t c = 0; c < cellKeys_.size(); ++c) {
+            neighborStart_.push_back(static_cast<uint32_t>(neighborCells_.size()));
+            const auto& coord = cellCoords_[c];
+            for (const auto& offset : kForward) {
+                const int x = coord[0] + offset[0];
+                const int y = coord[1] + offset[1];
+                const int z = coord[2] + offset[2];
+                if (x < 0 || y < 0 || z < 0 || x > kCoordMask || y > kCoordMask || z > kCoordMask) continue;
+                const uint64_t key = mortonKey(x, y, z);
+                auto it = std::lower_bound(cellKeys_.begin(), cellKeys_.end(), key);
+                if (it != cellKeys_.end() && *it == key) {
+                    neighborCells_.push_back(static_cast<uint32_t>(it - cellKeys_.begin()));
+                }
+            }
+            const int color = coord[0] % 3 + 3 * (coord[1] % 3) + 9 * (coord[2] % 3);
+            colorCells_[static_cast<std::size_t>(color)].push_back(static_cast<uint32_t>(c));
+        }
+        neighborStart_.push_back(static_cast<uint32_t>(neighborCells_.size()));
+    }
+
+    void build(const std::vector<float3>& positions, float cellSize) {
+        build(positions.data(), positions.size(), cellSize);
+    }
+
+    /**
+     * @brief order()[k] is the source index of the k-th particle in cell order.
+     */
+    const std::vector<uint32_t>& order() const { return order_; }
+    std::size_t particleCount() const { return order_.size(); }
+    std::size_t cellCount() const { return cellKeys_.size(); }
+    float cellSize() const { return cellSize_; }
+
+    /**
+     * @brief Calls visit(a, b) once for every pair of sorted indices a != b in
+     * the same or adjacent cells. The caller applies the distance test.
+     */
+    template <typename Visit>
+    void forEachPair(Visit&& visit) const {
+        for (std::size_t c = 0; c < cellKeys_.size(); ++c) {
+            visitCell(static_cast<uint32_t>(c), visit);
+        }
+    }
+
+    /**
+     * @brief Same pairs as forEachPair(), one color at a time with the cells of
+     * a color spread over worker threads. visit may write to both particles.
+     */
+    template <typename Visit>
+    void forEachPairParallel(Visit&& visit) const {
+        for (const auto& cells : colorCells_) {
+            Parallel::ForRange(0, static_cast<int>(cells.size()), kCellsPerTask, [&](ParallelRange range) {
+                for (int i = range.begin; i < range.end; ++i) {
+                    visitCell(cells[static_cast<std::size_t>(i)], visit);
+                }
+            });
+        }
+    }
+
+private:
+    static constexpr int kCoordBits = 21;
+    static constexpr int kCoordMask = (1 << kCoordBits) - 1;
+    static constexpr int kCoordBias = 1 << (kCoordBits - 1);
+    static constexpr int kCellsPerTask = 64;
+
+    struct KeyedIndex {
+        uint64_t key;
+        uint32_t index;
+    };
+
+    template <typename Visit>
+    void visitCell(uint32_t cell, Visit& visit) const {
+        const uint32_t begin = cellStart_[cell];
+        const uint32_t end = cellStart_[cell + 1];
+        for (uint32_t a = begin; a < end; ++a) {
+            for (uint32_t b = a + 1; b < end; ++b) visit(a, b);
+        }
+        for (uint32_t n = neighborStart_[cell]; n < neighborStart_[cell + 1]; ++n) {
+            const uint32_t other = neighborCells_[n];
+            const uint32_t otherBegin = cellStart_[other];
+            const uint32_t otherEnd = cellStart_[other + 1];
+            for (uint32_t a = begin; a < end; ++a) {
+                for (uint32_t b = otherBegin; b < otherEnd; ++b) visit(a, b);
+            }
+        }
+    }
+
+    static int cellCoord(float scaled) {
+        // Coordinates outside the 21-bit range collapse into the border cells;
+        // the caller's distance test keeps that correct, just slower.
+        if (!std::isfinite(scaled)) return kCoordBias;
+        const float clamped = std::clamp(std::floor(scaled), -static_cast<float>(kCoordBias),
+                                         static_cast<float>(kCoordBias - 1));
+        return static_cast<int>(clamped) + kCoordBias;
+    }
+
+    static uint64_t spreadBits(uint32_t value) {
+        uint64_t x = value & kCoordMask;
+        x = (x | x << 32) & 0x1f00000000ffffull;
+        x = (x | x << 16) & 0x1f0000ff0000ffull;
+        x = (x | x << 8) & 0x100f00f00f00f00full;
+        x = (x | x << 4) & 0x10c30c30c30c30c3ull;
+        x = (x | x << 2) & 0x1249249249249249ull;
+        return x;
+    }
+
+    static uint32_t compactBits(uint64_t x) {
+        x &= 0x1249249249249249ull;
+        x = (x | x >> 2) & 0x10c30c30c30c30c3ull;
+        x = (x | x >> 4) & 0x100f00f00f00f00full;
+        x = (x | x >> 8) & 0x1f0000ff0000ffull;
+        x = (x | x >> 16) & 0x1f00000000ffffull;
+        x = (x | x >> 32) & static_cast<uint64_t>(kCoordMask);
+        return static_cast<uint32_t>(x);
+    }
+
+    static uint64_t mortonKey(int x, int y, int z) {
+        return spreadBits(static_cast<uint32_t>(x)) | (spreadBits(static_cast<uint32_t>(y)) << 1) |
+               (spreadBits(static_cast<uint32_t>(z)) << 2);
+    }
+
+    static std::array<int, 3> decodeMorton(uint64_t key) {
+        return {static_cast<int>(compactBits(key)), static_cast<int>(compactBits(key >> 1)),
+                static_cast<int>(compactBits(key >> 2))};
+    }
+
+    // LSD radix sort on the 63-bit keys, 8 bits per pass. Passes whose byte is
+    // the same for every key are skipped, which is most of them when the
+    // particles occupy a compact region.
+    void radixSort() {
+        scratch_.resize(keyed_.size());
+        for (int shift = 0; shift < 64; shift += 8) {
+            std::array<uint32_t, 256> counts{};
+            for (const auto& entry : keyed_) ++counts[(entry.key >> shift) & 0xffu];
+            if (counts[(keyed_.front().key >> shift) & 0xffu] == keyed_.size()) continue;
+            uint32_t sum = 0;
+            for (auto& count : counts) {
+                const uint32_t value = count;
+                count = sum;
+                sum += value;
+            }
+            for (const auto& entry : keyed_) scratch_[counts[(entry.key >> shift) & 0xffu]++] = entry;
+            keyed_.swap(scratch_);
+        }
+    }
+
+    float cellSize_ = 1.0f;
+    std::vector<KeyedIndex> keyed_;
+    std::vector<KeyedIndex> scratch_;
+    std::vector<uint32_t> order_;
+    std::vector<uint64_t> cellKeys_;
+    std::vector<uint32_t> cellStart_;
+    std::vector<std::array<int, 3>> cellCoords_;
+    std::vector<uint32_t> neighborStart_;
+    std::vector<uint32_t> neighborCells_;
+    std::array<std::vector<uint32_t>, 27> colorCells_;
+};
+
 } // namespace ArtifactCore
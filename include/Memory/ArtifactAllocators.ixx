@@ -1,8 +1,12 @@
 module;
+#include <algorithm>
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <memory_resource>
+#include <mutex>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -74,27 +78,261 @@ private:
 };
 
 // A reset-at-once allocator for render passes and other bounded lifetimes.
-// Individual deallocation is intentionally ignored by the monotonic resource.
+// It bumps through one buffer; freeing the most recent allocation rewinds the
+// bump pointer, so the LIFO temporaries of consecutive effects reuse the same
+// bytes, and any other deallocation is ignored until reset(). Requests that
+// do not fit go to the upstream and are returned to it when freed. reset()
+// then grows the buffer to the pass's peak so the next pass of the same shape
+// stays off the upstream.
 class FrameAllocator final {
 public:
     explicit FrameAllocator(
         std::size_t initialBytes = 256 * 1024,
         std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
-        : initialStorage_(initialBytes),
+        : storage_(initialBytes),
           upstream_(upstream),
-          resource_(initialStorage_.data(), initialStorage_.size(), &upstream_) {}
+          front_(*this) {}
 
-    [[nodiscard]] std::pmr::memory_resource* resource() noexcept { return &resource_; }
+    FrameAllocator(const FrameAllocator&) = delete;
+    FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+    [[nodiscard]] std::pmr::memory_resource* resource() noexcept { return &front_; }
     [[nodiscard]] const CountingMemoryResource& upstreamMetrics() const noexcept { return upstream_; }
 
-    void reset() { resource_.release(); }
+    // Bytes and allocations handed out since the last reset().
+    [[nodiscard]] std::size_t bytesAllocated() const noexcept { return bytesAllocated_; }
+    [[nodiscard]] std::size_t allocationCount() const noexcept { return allocationCount_; }
+    [[nodiscard]] std::size_t capacity() const noexcept { return storage_.size(); }
+    // Most bytes live at once since the last reset(), spilled ones included.
+    [[nodiscard]] std::size_t peakBytes() const noexcept { return peak_; }
+
+    // Upstream traffic since the last reset(), i.e. what overflowed the buffer.
+    [[nodiscard]] AllocationMetrics spilledSinceReset() const noexcept {
+        AllocationMetrics spilled = upstream_.metrics();
+        spilled.allocatedBytes -= resetBaseline_.allocatedBytes;
+        spilled.allocationCount -= resetBaseline_.allocationCount;
+        return spilled;
+    }
+
+    void reset() {
+        if (spilledSinceReset().allocationCount != 0 && peak_ > storage_.size()) {
+            storage_ = std::vector<std::byte>(peak_);
+        }
+        top_ = 0;
+        peak_ = spilledBytes_;
+        bytesAllocated_ = 0;
+        allocationCount_ = 0;
+        resetBaseline_ = upstream_.metrics();
+    }
 
 private:
-    std::vector<std::byte> initialStorage_;
+    class Front final : public std::pmr::memory_resource {
+    public:
+        explicit Front(FrameAllocator& owner) noexcept : owner_(owner) {}
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            return owner_.allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override {
+            owner_.deallocate(pointer, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        FrameAllocator& owner_;
+    };
+
+    void* allocate(std::size_t bytes, std::size_t alignment) {
+        bytesAllocated_ += bytes;
+        ++allocationCount_;
+        const auto base = reinterpret_cast<std::uintptr_t>(storage_.data());
+        const std::uintptr_t aligned = (base + top_ + alignment - 1) & ~(std::uintptr_t(alignment) - 1);
+        const std::size_t end = static_cast<std::size_t>(aligned - base) + bytes;
+        if (end <= storage_.size()) {
+            top_ = end;
+            peak_ = std::max(peak_, top_ + spilledBytes_);
+            return reinterpret_cast<void*>(aligned);
+        }
+        void* pointer = upstream_.allocate(bytes, alignment);
+        // Padding the request would need once it lives in the buffer.
+        spilledBytes_ += bytes + alignment;
+        peak_ = std::max(peak_, top_ + spilledBytes_);
+        return pointer;
+    }
+
+    void deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+        std::byte* const begin = storage_.data();
+        auto* const block = static_cast<std::byte*>(pointer);
+        if (block < begin || block >= begin + storage_.size()) {
+            upstream_.deallocate(pointer, bytes, alignment);
+            spilledBytes_ -= bytes + alignment;
+            return;
+        }
+        if (block + bytes == begin + top_) {
+            top_ = static_cast<std::size_t>(block - begin);
+        }
+    }
+
+    std::vector<std::byte> storage_;
     CountingMemoryResource upstream_;
-    std::pmr::monotonic_buffer_resource resource_;
+    Front front_;
+    std::size_t top_ = 0;
+    std::size_t peak_ = 0;
+    std::size_t spilledBytes_ = 0;
+    std::size_t bytesAllocated_ = 0;
+    std::size_t allocationCount_ = 0;
+    AllocationMetrics resetBaseline_{};
+};
+
+struct FrameAllocationMetrics {
+    std::uint64_t frame = 0;
+    std::size_t threadArenas = 0;
+    std::size_t arenaBytes = 0;
+    std::size_t arenaAllocations = 0;
+    std::size_t capacityBytes = 0;
+    // Arena overflow that went to the upstream (the global heap by default).
+    std::size_t upstreamBytes = 0;
+    std::size_t upstreamAllocations = 0;
+
+    [[nodiscard]] bool heapFree() const noexcept { return upstreamAllocations == 0; }
+};
+
+// One FrameAllocator per thread that touches the frame, reset together at
+// each frame boundary. The frame renderer owns the pool; each thread that runs
+// frame work installs it with FrameArenaScope, and effect kernels reach their
+// thread's arena through frameScratchResource() without it being threaded
+// through every call. Threads that never installed the pool keep allocating
+// from the default resource.
+// beginFrame() must not run while any thread is still using the previous
+// frame's scratch, and that work must have been joined (task completion,
+// future, barrier) so its counters are visible to the caller.
+class FrameArenaPool final {
+public:
+    explicit FrameArenaPool(
+        std::size_t initialBytesPerThread = 4 * 1024 * 1024,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+        : id_(nextPoolId_.fetch_add(1, std::memory_order_relaxed)),
+          initialBytesPerThread_(initialBytesPerThread),
+          upstream_(upstream) {}
+
+    FrameArenaPool(const FrameArenaPool&) = delete;
+    FrameArenaPool& operator=(const FrameArenaPool&) = delete;
+
+    // The calling thread's arena. The first call from a thread creates it.
+    [[nodiscard]] std::pmr::memory_resource* threadResource() {
+        ThreadCache& cache = threadCache_;
+        if (cache.poolId != id_) {
+            cache.arena = &arenaForThisThread();
+            cache.poolId = id_;
+        }
+        return cache.arena->resource();
+    }
+
+    // Closes the current frame: records its metrics, resets every thread's
+    // arena and returns what the frame used.
+    FrameAllocationMetrics beginFrame() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const FrameAllocationMetrics metrics = collectLocked();
+        for (auto& [thread, arena] : arenas_) {
+            arena->reset();
+        }
+        ++frame_;
+        lastFrame_ = metrics;
+        return metrics;
+    }
+
+    // What the last beginFrame() returned.
+    [[nodiscard]] FrameAllocationMetrics lastFrameMetrics() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lastFrame_;
+    }
+
+    // The pool installed by the calling thread's innermost FrameArenaScope,
+    // or nullptr.
+    [[nodiscard]] static FrameArenaPool* current() noexcept { return current_; }
+
+private:
+    friend class FrameArenaScope;
+
+    // Zero-initialized as a thread_local; pool ids start at 1.
+    struct ThreadCache {
+        std::uint64_t poolId;
+        FrameAllocator* arena;
+    };
+
+    // Arena counters are plain fields written by their owning thread, so this
+    // only runs at a frame boundary (beginFrame), never while frame work is live.
+    FrameAllocationMetrics collectLocked() const {
+        FrameAllocationMetrics metrics;
+        metrics.frame = frame_;
+        metrics.threadArenas = arenas_.size();
+        for (const auto& [thread, arena] : arenas_) {
+            const AllocationMetrics upstream = arena->spilledSinceReset();
+            metrics.arenaBytes += arena->bytesAllocated();
+            metrics.arenaAllocations += arena->allocationCount();
+            metrics.capacityBytes += arena->capacity();
+            metrics.upstreamBytes += upstream.allocatedBytes;
+            metrics.upstreamAllocations += upstream.allocationCount;
+        }
+        return metrics;
+    }
+
+    FrameAllocator& arenaForThisThread() {
+        const std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [thread, arena] : arenas_) {
+            if (thread == self) {
+                return *arena;
+            }
+        }
+        arenas_.emplace_back(self, std::make_unique<FrameAllocator>(initialBytesPerThread_, upstream_));
+        return *arenas_.back().second;
+    }
+
+    static inline std::atomic<std::uint64_t> nextPoolId_{1};
+    static inline thread_local FrameArenaPool* current_ = nullptr;
+    static inline thread_local ThreadCache threadCache_;
+
+    std::uint64_t id_;
+    std::size_t initialBytesPerThread_;
+    std::pmr::memory_resource* upstream_;
+    mutable std::mutex mutex_;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<FrameAllocator>>> arenas_;
+    std::uint64_t frame_ = 0;
+    FrameAllocationMetrics lastFrame_{};
 };
 
+// Makes a pool current for the calling thread until the scope ends. Scopes
+// nest per thread; other threads are unaffected.
+class FrameArenaScope final {
+public:
+    explicit FrameArenaScope(FrameArenaPool& pool) noexcept
+        : previous_(std::exchange(FrameArenaPool::current_, &pool)) {}
+
+    ~FrameArenaScope() { FrameArenaPool::current_ = previous_; }
+
+    FrameArenaScope(const FrameArenaScope&) = delete;
+    FrameArenaScope& operator=(const FrameArenaScope&) = delete;
+
+private:
+    FrameArenaPool* previous_;
+};
+
+// Scratch memory that lives until the end of the current frame. Outside a
+// FrameArenaScope this is the default resource, so kernels called from tools
+// or tests keep working unchanged.
+[[nodiscard]] inline std::pmr::memory_resource* frameScratchResource() {
+    if (FrameArenaPool* pool = FrameArenaPool::current()) {
+        return pool->threadResource();
+    }
+    return std::pmr::get_default_resource();
+}
+
 // Thread-confined, reusable allocator for effect instances and worker-local
 // scratch. It must not be used concurrently from more than one thread.
 class TaskAllocator final {
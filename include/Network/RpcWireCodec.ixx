@@ -0,0 +1,79 @@
+module;
+#include <vector>
+#include <cstdint>
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+
+export module Network.RpcWire;
+
+export namespace ArtifactCore
+{
+
+// Binary framing shared by NetworkPCServer and NetworkRPCClient.
+//
+// Frame layout (little-endian):
+//   u8  magic (0xA7; never the first byte of a JSON line)
+//   u8  flags (bit 0: payload compressed with qCompress)
+//   u8  type  (RpcWireType)
+//   u8  reserved
+//   u32 payload size in bytes
+//   payload
+//
+// Peers agree on the binary protocol during registration, but readers accept
+// JSON lines and binary frames interleaved on the same stream, so the switch
+// needs no handshake round trip.
+enum class RpcWireType : std::uint8_t {
+    Envelope = 1,       // one JSON-RPC message encoded as CBOR
+    FrameReports = 2    // batch of frameCompleted / frameFailed reports
+};
+
+struct RpcFrameReport {
+    int frame = -1;
+    bool success = true;
+    QString error;
+};
+
+struct RpcWireMessage {
+    RpcWireType type = RpcWireType::Envelope;
+    QByteArray payload;     // decompressed
+};
+
+enum class RpcWireStatus {
+    NeedMore,       // the buffer ends in the middle of a message
+    Frame,          // a binary frame was decoded
+    JsonLine,       // a text line was taken (may be empty)
+    Error           // malformed or oversized; drop the connection
+};
+
+class RpcWireCodec
+{
+public:
+    static constexpr char kFrameMagic = static_cast<char>(0xA7);
+    static constexpr qsizetype kHeaderBytes = 8;
+    static constexpr qsizetype kCompressThreshold = 512;
+    static constexpr std::uint8_t kFlagCompressed = 0x01;
+
+    static QString protocolName() { return QStringLiteral("artifact-bin/1"); }
+    static QString compressionName() { return QStringLiteral("zlib"); }
+
+    // Payloads at or above kCompressThreshold are compressed when allowed and
+    // the result is actually smaller.
+    static QByteArray encodeFrame(RpcWireType type, const QByteArray& payload, bool allowCompression);
+
+    // Takes the message starting at offset and advances offset past it.
+    // Callers drain a read buffer in a loop and trim it once afterwards.
+    static RpcWireStatus takeMessage(const QByteArray& buffer, qsizetype& offset,
+                                     qsizetype maxPayloadBytes,
+                                     RpcWireMessage& frame, QByteArray& jsonLine);
+
+    static QByteArray encodeEnvelope(const QJsonObject& message);
+    static bool decodeEnvelope(const QByteArray& payload, QJsonObject& message);
+
+    static QByteArray encodeFrameReports(const QString& workerId,
+                                         const std::vector<RpcFrameReport>& reports);
+    static bool decodeFrameReports(const QByteArray& payload, QString& workerId,
+                                   std::vector<RpcFrameReport>& reports);
+};
+
+}
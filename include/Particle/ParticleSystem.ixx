@@ -46,6 +46,7 @@ import Mesh;
 import Memory.SharedPtr;
 import Physics.Fluid;
 import Physics2D;
+import Math.SpatialGrid;
 
 
 export namespace ArtifactCore {
@@ -106,6 +107,65 @@ private:
     std::vector<size_t> freeIndices_;
 };
 
+// ============================================================================
+// Particle SoA - 列ごとのパーティクル格納（生存粒子は [0, size) に詰める）
+// ============================================================================
+// 毎フレーム触る値は成分ごとの float 列に分け、力場や積分を配列単位で回せるようにする。
+// それ以外の属性（id, size, custom など）は cold にまとめて置き、get() で列の値と合成する
+
+// SoA の列に載らない、毎フレームは触らない属性
+struct ParticleColdData {
+    std::uint64_t id = 0;
+    std::uint32_t seed = 0;
+    std::uint32_t flags = 0;
+    float2 scale{ 1.0f, 1.0f };
+    float size = 1.0f;
+    float mass = 1.0f;
+    float drag = 0.0f;
+    float4 custom0{ 0.0f, 0.0f, 0.0f, 0.0f };
+    float4 custom1{ 0.0f, 0.0f, 0.0f, 0.0f };
+    int textureIndex = -1;
+    int blendMode = 0;
+};
+
+struct LIBRARY_DLL_API ParticleSoA {
+    std::vector<float> positionX, positionY, positionZ;
+    std::vector<float> prevPositionX, prevPositionY, prevPositionZ;
+    std::vector<float> velocityX, velocityY, velocityZ;
+    std::vector<float> accelerationX, accelerationY, accelerationZ;
+    std::vector<float> rotationX, rotationY, rotationZ;
+    std::vector<float> angularVelocityX, angularVelocityY, angularVelocityZ;
+    std::vector<float> age, lifetime, lastSubEmitAge, opacity;
+    std::vector<float4> color;
+    std::vector<std::uint64_t> emitterToken;
+    std::vector<ParticleColdData> cold;
+
+    size_t size() const { return positionX.size(); }
+    bool empty() const { return positionX.empty(); }
+    void clear();
+    void reserve(size_t capacity);
+
+    size_t push(const Particle& p);
+    Particle get(size_t index) const;
+    void set(size_t index, const Particle& p);
+    // alive[i] が 0 の粒子を取り除き、残りを順序を保って前へ詰める。戻り値は取り除いた数
+    size_t compact(const std::uint8_t* alive);
+
+    float3 position(size_t i) const { return {positionX[i], positionY[i], positionZ[i]}; }
+    float3 velocity(size_t i) const { return {velocityX[i], velocityY[i], velocityZ[i]}; }
+    void setPosition(size_t i, const float3& v) { positionX[i] = v.x; positionY[i] = v.y; positionZ[i] = v.z; }
+    void setVelocity(size_t i, const float3& v) { velocityX[i] = v.x; velocityY[i] = v.y; velocityZ[i] = v.z; }
+
+private:
+    template<typename F>
+    void forEachColumn(F&& f);
+};
+
+enum class ParticleStorageMode {
+    AoS, // ParticlePool（従来どおり）
+    SoA  // ParticleSoA。力場を配列単位で、チャンクごとに並列に更新する
+};
+
 // ============================================================================
 // Force Field - 力場基底クラス
 // ============================================================================
@@ -141,9 +201,19 @@ public:
     virtual ~ForceField() = default;
 
     virtual void apply(Particle& particle, double deltaTime) = 0;
+
+    // SoA の [begin, end) にまとめて適用する。dtScale が null でなければ粒子 begin + k の dt は
+    // deltaTime * dtScale[k]。チャンクごとに並列に呼ばれるので、粒子間で状態を共有しないこと。
+    // 既定では粒子ごとに合成して apply() を呼ぶ
+    virtual void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double deltaTime,
+                            const float* dtScale);
+    // SoA 更新で並列パスの前に 1 フレーム 1 回呼ばれる
+    virtual void prepareBatch(double deltaTime) { (void)deltaTime; }
     
     // 空間減衰の計算
     float computeFalloff(const float3& p) const;
+    // [begin, end) の減衰を out[0 .. end - begin) へ書く。Infinite なら false を返し何も書かない
+    bool computeFalloffBatch(const ParticleSoA& particles, size_t begin, size_t end, float* out) const;
 
     Type getType() const { return type_; }
     const std::string& getId() const { return id_; }
@@ -194,6 +264,9 @@ public:
         p.velocity.z += gravity_.z * static_cast<float>(dt);
     }
 
+    void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                    const float* dtScale) override;
+
     void setGravity(float x, float y, float z) {
         gravity_ = {std::isfinite(x) ? x : 0.0f,
                     std::isfinite(y) ? y : -9.81f,
@@ -218,6 +291,9 @@ public:
         p.velocity.z += direction_.z * strength_ * static_cast<float>(dt);
     }
 
+    void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                    const float* dtScale) override;
+
     void setDirection(float x, float y, float z) {
         if (!std::isfinite(x) || !std::isfinite(y) || !std::isfinite(z)) return;
         float len = std::sqrt(x*x + y*y + z*z);
@@ -248,12 +324,18 @@ public:
         p.velocity.z += dist(rng_) * strength;
     }
 
+    // バッチ版は共有 rng_ を使わず、フレームの種と粒子番号から乱数を作る
+    void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                    const float* dtScale) override;
+    void prepareBatch(double dt) override;
+
     void setStrength(float strength) { strength_ = std::isfinite(strength) ? strength : 0.0f; }
     float getStrength() const { return strength_; }
 
 private:
     float strength_ = 1.0f;
     std::mt19937 rng_;
+    std::uint32_t batchSeed_ = 0;
 };
 
 // ============================================================================
@@ -279,6 +361,9 @@ public:
         }
     }
 
+    void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                    const float* dtScale) override;
+
     void setCenter(float x, float y, float z) { center_ = {x, y, z}; }
     void setStrength(float strength) { strength_ = std::isfinite(strength) ? strength : 0.0f; }
 
@@ -309,6 +394,9 @@ public:
         }
     }
 
+    void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                    const float* dtScale) override;
+
     void setCenter(float x, float y, float z) { center_ = {x, y, z}; }
     void setStrength(float strength) { strength_ = strength; }
 
@@ -332,6 +420,9 @@ public:
         p.velocity.z *= factor;
     }
 
+    void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                    const float* dtScale) override;
+
     void setDrag(float drag) { drag_ = drag; }
     float getDrag() const { return drag_; }
 
@@ -355,6 +446,9 @@ public:
         p.velocity.z += direction_.z * strength;
     }
 
+    void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                    const float* dtScale) override;
+
     void setAudioValue(float val) { audioValue_ = val; }
     void setDirection(float x, float y, float z) { direction_ = {x, y, z}; }
     void setMultiplier(float m) { multiplier_ = m; }
@@ -368,22 +462,71 @@ private:
 // ============================================================================
 // Particle Constraint - パーティクル間の相互作用（流体・衝突）
 // ============================================================================
+// 近傍探索用にセル順へ並べ替えた位置・速度・質量。
+// 拘束はこの配列を直接書き換え、ParticleSystem がプールへ書き戻す
+struct LIBRARY_DLL_API ParticleNeighborSet {
+    std::vector<float3> positions;
+    std::vector<float3> velocities;
+    std::vector<float> masses;
+    SpatialCellList cells;
+
+    // particles[indices[k]] (indices が null なら particles[k]) をセル順に集める
+    void gather(const Particle* particles, const size_t* indices, size_t count, float cellSize);
+    // 集めた位置と速度を元のパーティクルへ書き戻す
+    void scatter(Particle* particles, const size_t* indices) const;
+    void gather(const ParticleSoA& particles, float cellSize);
+    void scatter(ParticleSoA& particles) const;
+    size_t size() const { return positions.size(); }
+
+private:
+    std::vector<float3> sourcePositions_;
+};
+
 class LIBRARY_DLL_API ParticleConstraint {
 public:
     virtual ~ParticleConstraint() = default;
     virtual void resolve(std::vector<Particle>& particles, double dt) = 0;
+
+    // 相互作用半径。0 より大きい拘束はセルリスト経由の resolve(ParticleNeighborSet&) で解かれる
+    virtual float interactionRadius() const { return 0.0f; }
+    virtual void resolve(ParticleNeighborSet& neighbors, double dt) { (void)neighbors; (void)dt; }
 };
 
 class LIBRARY_DLL_API FluidConstraint : public ParticleConstraint {
 public:
+    enum class Mode {
+        Repulsion, // 重なった粒子を押し離す（擬似流体）
+        SPH        // 密度と圧力から力を求める SPH
+    };
+
     FluidConstraint(float radius = 0.5f, float density = 1.0f) 
         : radius_(radius), targetDensity_(density) {}
 
     void resolve(std::vector<Particle>& particles, double dt) override;
+    void resolve(ParticleNeighborSet& neighbors, double dt) override;
+    float interactionRadius() const override { return radius_; }
+
+    void setMode(Mode mode) { mode_ = mode; }
+    Mode mode() const { return mode_; }
+    // SPH の圧力係数と粘性係数
+    void setStiffness(float stiffness) { stiffness_ = std::isfinite(stiffness) ? std::max(0.0f, stiffness) : 0.0f; }
+    void setViscosity(float viscosity) { viscosity_ = std::isfinite(viscosity) ? std::max(0.0f, viscosity) : 0.0f; }
+    // 粒子数が少ないときはスレッドを使わない
+    void setParallel(bool parallel) { parallel_ = parallel; }
 
 private:
+    void resolveRepulsion(ParticleNeighborSet& neighbors);
+    void resolveSph(ParticleNeighborSet& neighbors, float dt);
+
     float radius_;
     float targetDensity_;
+    Mode mode_ = Mode::Repulsion;
+    float stiffness_ = 20.0f;
+    float viscosity_ = 0.1f;
+    bool parallel_ = true;
+    std::vector<float> densities_;
+    std::vector<float3> forces_;
+    ParticleNeighborSet scratch_;
 };
 
 // ============================================================================
@@ -408,6 +551,9 @@ public:
         p.velocity.y += vy * strength_ * static_cast<float>(dt);
     }
 
+    void applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                    const float* dtScale) override;
+
     void update(float dt) { solver_.update(dt); }
     FluidSolver2D& getSolver() { return solver_; }
     
@@ -639,6 +785,8 @@ public:
     virtual ~ParticleCollider() = default;
 
     virtual bool collide(Particle& p, double dt) = 0;
+    // SoA の [begin, end) をまとめて処理する。既定では粒子ごとに collide() を呼ぶ
+    virtual void collideBatch(ParticleSoA& particles, size_t begin, size_t end, double dt);
 
     Type getType() const { return type_; }
     const std::string& getId() const { return id_; }
@@ -680,6 +828,8 @@ public:
         return false;
     }
 
+    void collideBatch(ParticleSoA& particles, size_t begin, size_t end, double dt) override;
+
     void setHeight(float h) {
         if (std::isfinite(h)) height_ = h;
     }
@@ -723,6 +873,8 @@ public:
         return false;
     }
 
+    void collideBatch(ParticleSoA& particles, size_t begin, size_t end, double dt) override;
+
     void setCenter(float x, float y, float z) { center_ = {x, y, z}; }
     void setRadius(float r) { radius_ = r; }
 
@@ -809,7 +961,14 @@ public:
     // パーティクルアクセス
     size_t activeParticleCount() const;
     size_t totalParticleCount() const;
+    // AoS モードのプール。SoA モードでは空
     ParticlePool<>& getPool();
+    // SoA モードの列。AoS モードでは空
+    ParticleSoA& getSoA();
+
+    // 格納方式。切り替えると生存中のパーティクルを移し替える
+    void setStorageMode(ParticleStorageMode mode);
+    ParticleStorageMode storageMode() const;
 
     // 設定
     void setMaxParticles(size_t maxParticles);
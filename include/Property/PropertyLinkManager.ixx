@@ -70,6 +70,7 @@ public:
     void addLink(const PropertyLink& link);
 
     // 指定したソースプロパティが変更されたときにターゲットを更新
+    // ターゲットが更新された場合は、そのプロパティ名を読む ExpressionMemoCache の結果だけを無効化する
     void updateTargets(AbstractProperty* source);
 
     // UI / serialization 層が現在のリンクを read-only で列挙するための参照。
@@ -1,8 +1,11 @@
 module;
 #include <utility>
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include <QString>
 #include <QStringList>
+#include <QDateTime>
 #include "../Define/DllExportMacro.hpp"
 
 export module Render.Farm.Checkpoint;
@@ -12,6 +15,41 @@ import Utils.Optional;
 
 export namespace ArtifactCore {
 
+// Frames of a job's range known to be rendered, one bit per frame index.
+struct LIBRARY_DLL_API CompletedFrameSet {
+    RenderFrameRange range;
+    std::vector<std::uint64_t> words;
+    int count = 0;
+
+    void reset(const RenderFrameRange& frameRange);
+    // -1 when the frame is outside the range or off its step.
+    int indexOf(int frame) const;
+    bool contains(int frame) const;
+    bool containsIndex(int index) const;
+    // Returns false when the frame was already present or is out of range.
+    bool insert(int frame);
+    // First frame (absolute) that is not completed; range.endFrame when all are.
+    int completedPrefixEnd() const;
+};
+
+struct CheckpointJournalPolicy {
+    // Records are handed to the OS as they are appended and fsync'ed after
+    // this many records or this much time, whichever comes first.
+    int syncEveryRecords = 1024;
+    int syncIntervalMs = 2000;
+    // Rewrite the journal as a bitmap snapshot after this many appended records.
+    int compactEveryRecords = 100000;
+};
+
+struct CheckpointJournalState {
+    QString jobId;
+    int totalFrames = 0;
+    CompletedFrameSet completed;
+    FailureManifest failures;
+    QDateTime createdAt;
+    int recordCount = 0;
+};
+
 class LIBRARY_DLL_API CheckpointStore {
 public:
     CheckpointStore();
@@ -30,8 +68,24 @@ public:
 
     bool checkpointExists(const QString& jobId) const;
 
+    // Append-only journal. Appending is O(1) per frame; openJournal resumes
+    // an existing journal for the same range (dropping a torn tail) or
+    // starts a new one.
+    void setJournalPolicy(const CheckpointJournalPolicy& policy);
+    CheckpointJournalPolicy journalPolicy() const;
+    bool openJournal(const QString& jobId, const RenderFrameRange& range, int totalFrames);
+    bool appendFrameCompleted(const QString& jobId, int frame);
+    bool appendFrameFailed(const QString& jobId, const FailedFrameRecord& record);
+    bool syncJournal(const QString& jobId);
+    bool compactJournal(const QString& jobId);
+    // Syncs, compacts and closes.
+    bool closeJournal(const QString& jobId);
+    Optional<CheckpointJournalState> loadJournal(const QString& jobId) const;
+    bool journalExists(const QString& jobId) const;
+
     static QString defaultBasePath();
     static QString checkpointFilePath(const QString& basePath, const QString& jobId);
+    static QString journalFilePath(const QString& basePath, const QString& jobId);
 
 private:
     class Impl;
@@ -12,6 +12,9 @@ import Render.IRayTracer;
 import Render.SoftwareRayTracer;
 import Render.GPURayTracer;
 import Render.ImageBuffer;
+import Memory.ArtifactAllocators;
+import ImageF32x4;
+import ImageProcessing;
 
 export namespace ArtifactCore
 {
@@ -27,6 +30,9 @@ class FrameRenderer
 public:
     std::unique_ptr<RayTrace::IRayTracer> rayTracer;
     RayTracerType currentType = RayTracerType::Software;
+    // Per-thread scratch for the effect passes of a frame (applyEffects);
+    // reset at the start of each renderFrame().
+    FrameArenaPool frameArenas;
 
     int width = 800;
     int height = 600;
@@ -57,11 +63,28 @@ public:
 
     RayTrace::ImageBuffer renderFrame()
     {
+        frameArenas.beginFrame();
         if (!rayTracer)
             return RayTrace::ImageBuffer(width, height);
         return rayTracer->render();
     }
 
+    // Runs an effect chain over the current frame on the calling thread, with
+    // each effect's scratch served from this frame's arena. Must finish before
+    // the next renderFrame().
+    void applyEffects(AbstractImageEffect& chain, ImageF32x4_RGBA& image)
+    {
+        chain.chainProcess(image, frameArenas);
+    }
+
+    // Allocation totals of the frame closed by the last renderFrame(), read at
+    // that frame boundary. heapFree() means its scratch fit in the arenas and
+    // never reached the global heap.
+    FrameAllocationMetrics lastFrameAllocationMetrics() const
+    {
+        return frameArenas.lastFrameMetrics();
+    }
+
     bool savePNG(const char* filename)
     {
         auto buffer = renderFrame();
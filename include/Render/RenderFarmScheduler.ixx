@@ -0,0 +1,117 @@
+module;
+#include <utility>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <QString>
+#include <QtGlobal>
+#include "../Define/DllExportMacro.hpp"
+
+export module Render.Farm.Scheduler;
+
+import Render.Farm.Types;
+
+export namespace ArtifactCore {
+
+struct FrameSchedulerPolicy {
+    int minChunkFrames = 1;
+    int maxChunkFrames = 64;
+    // Chunks are sized so one takes roughly this long on the requesting worker.
+    qint64 targetChunkMs = 20000;
+    // A chunk must take at least this many round trips, so messaging stays cheap.
+    double rttOverheadFactor = 8.0;
+    // Share of a victim's remaining frames a thief takes from its tail.
+    double stealFraction = 0.5;
+    int minStealFrames = 2;
+    // Speculative copies are only issued once this share of the job is left.
+    double speculativeTailFraction = 0.1;
+    // A chunk is a straggler when its current frame has run this many times
+    // longer than the owner's average frame time.
+    double stragglerFactor = 2.0;
+};
+
+struct FrameChunk {
+    int id = -1;
+    QString workerId;
+    RenderFrameRange range;
+    bool speculative = false;
+
+    bool isValid() const { return id >= 0 && range.count() > 0; }
+};
+
+// A chunk that shrank after it was handed out (its tail was stolen, or a
+// speculative twin finished it). Owners should stop at range.endFrame.
+struct FrameChunkRevision {
+    int chunkId = -1;
+    QString workerId;
+    RenderFrameRange range;
+    int withdrawnFrames = 0;
+};
+
+struct FrameReportResult {
+    bool accepted = false;     // first report for this frame
+    bool workerIdle = false;   // the reporting worker has no chunk left
+};
+
+struct FrameSchedulerStats {
+    int chunksIssued = 0;
+    int steals = 0;
+    int speculativeChunks = 0;
+    int framesRequeued = 0;
+    int duplicateReports = 0;
+};
+
+// Pull-based frame scheduler shared by local render threads and remote
+// workers. Workers ask for small chunks sized from their measured frame time
+// and heartbeat RTT; once the unassigned pool is empty, idle workers steal the
+// tail of the slowest chunk, and near the end of a job they re-run stragglers
+// speculatively. Whichever copy reports a frame first wins. Thread-safe.
+class LIBRARY_DLL_API RenderFrameScheduler {
+public:
+    RenderFrameScheduler();
+    ~RenderFrameScheduler();
+
+    RenderFrameScheduler(const RenderFrameScheduler&) = delete;
+    RenderFrameScheduler& operator=(const RenderFrameScheduler&) = delete;
+
+    void setPolicy(const FrameSchedulerPolicy& policy);
+    FrameSchedulerPolicy policy() const;
+
+    // Starts a job. Frames before resumeFrom count as already rendered.
+    void reset(const RenderFrameRange& range, int resumeFrom = std::numeric_limits<int>::min());
+    // Starts a job whose frames flagged in done (by index into range) are
+    // already rendered, e.g. restored from a checkpoint journal.
+    void reset(const RenderFrameRange& range, const std::vector<std::uint8_t>& done);
+    void clear();
+
+    // Returns an invalid chunk when there is nothing worth handing out.
+    FrameChunk requestChunk(const QString& workerId, qint64 rttMs = 0);
+
+    // False once the frame left the chunk (stolen or withdrawn) or another
+    // worker already reported it.
+    bool shouldRender(int chunkId, int frame) const;
+
+    FrameReportResult reportFrame(const QString& workerId, int frame, bool success);
+
+    // Returns the worker's unreported frames to the pool; returns their count.
+    int releaseWorker(const QString& workerId);
+
+    std::vector<FrameChunkRevision> takeRevisions();
+
+    bool hasWork() const;
+    bool finished() const;
+    bool isParticipant(const QString& workerId) const;
+    bool hasActiveChunk(const QString& workerId) const;
+    int remainingFrames() const;
+    std::vector<int> unreportedFrames() const;
+    std::vector<FrameChunk> activeChunks() const;
+    double averageFrameMs(const QString& workerId) const;
+    FrameSchedulerStats stats() const;
+
+private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+}
@@ -244,7 +244,12 @@ struct CheckpointInfo {
 
 struct CheckpointPolicy {
     enum class Mode { Disabled, EveryNFrames, EveryMSeconds };
+    // Snapshot rewrites checkpoint.json; Journal appends one record per
+    // frame to checkpoint.journal and syncs on the store's journal policy.
+    // Snapshot stays the default; callers opt in to Journal.
+    enum class Format { Snapshot, Journal };
     Mode mode = Mode::Disabled;
+    Format format = Format::Snapshot;
     int interval = 10;
 };
 
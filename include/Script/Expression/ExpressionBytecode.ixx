@@ -0,0 +1,208 @@
+module;
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+export module Script.Expression.Bytecode;
+
+import Memory.SharedPtr;
+
+import Script.Expression.Value;
+import Script.Expression.Parser;
+
+export namespace ArtifactCore {
+
+// Unboxed value used by the expression VM.
+// Only Null / Number / Vec2-4 are representable; anything else (strings,
+// arrays, objects) is left to the AST evaluator.
+struct ExprVmValue {
+    ExprValueType type = ExprValueType::Null;
+    double v[4] = {0.0, 0.0, 0.0, 0.0};
+
+    static ExprVmValue null();
+    static ExprVmValue number(double value);
+    static ExprVmValue vector(const double* components, int count);
+
+    bool isNull() const { return type == ExprValueType::Null; }
+    bool isNumber() const { return type == ExprValueType::Number; }
+    bool isVector() const {
+        return type == ExprValueType::Vec2 || type == ExprValueType::Vec3 ||
+               type == ExprValueType::Vec4;
+    }
+    // Number = 1, VecN = N, Null = 0
+    int dimension() const;
+    // Same rules as ExpressionValue::asNumber (vector -> first component)
+    double asNumber() const;
+};
+
+// Returns false when the value cannot be represented without heap storage.
+bool toVmValue(const ExpressionValue& value, ExprVmValue& out);
+// Boxes the result; like any ExpressionValue construction this allocates.
+ExpressionValue fromVmValue(const ExprVmValue& value);
+
+enum class ExprOpCode : std::uint8_t {
+    PushConst,      // operand = constant index
+    LoadSlot,       // operand = slot index
+    MakeVector,     // count = component count (2-4)
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Pow,
+    FloorDiv,
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    LogicalAnd,
+    LogicalOr,
+    Negate,
+    LogicalNot,
+    Component,      // operand = component index (property access .x/.y/.z/.w)
+    Index,          // array-style access on a vector
+    Jump,           // operand = absolute target
+    JumpIfFalse,    // operand = absolute target, pops condition
+    CallBuiltin,    // operand = ExprBuiltinId, count = argument count
+    Return
+};
+
+struct ExprInstruction {
+    ExprOpCode op = ExprOpCode::Return;
+    std::uint8_t count = 0;
+    std::int32_t operand = 0;
+};
+
+// Builtins with a native VM implementation. Semantics match BuiltinFunctions.
+enum class ExprBuiltinId : std::uint8_t {
+    Sin, Cos, Tan, DegToRad, RadToDeg, Sqrt, Pow, Abs, Floor, Ceil, Round,
+    Min, Max, Clamp, Length, Distance, Normalize, Dot, Cross,
+    Linear, Ease, EaseIn, EaseOut, Noise, Wiggle, Sum, Average
+};
+
+struct ExprSlot {
+    std::string name;
+    // Optional slots bind to Null when the variable is missing (e.g. the
+    // implicit `time` read by wiggle) instead of forcing the AST fallback.
+    bool optional = false;
+};
+
+// Compiled, immutable form of one expression AST.
+class ExpressionProgram {
+public:
+    const std::vector<ExprInstruction>& code() const { return code_; }
+    const std::vector<ExprVmValue>& constants() const { return constants_; }
+    const std::vector<ExprSlot>& slots() const { return slots_; }
+
+    int findSlot(const std::string& name) const;
+    int maxStackDepth() const { return maxStackDepth_; }
+    // AST statistics used to honour the evaluator's recursion limit and budget
+    int nodeCount() const { return nodeCount_; }
+    int treeDepth() const { return treeDepth_; }
+    // Content hash of code, constants and slot names. Identical source
+    // compiled by different evaluators yields the same fingerprint, so results
+    // can be shared through ExpressionMemoCache.
+    std::uint64_t fingerprint() const { return fingerprint_; }
+    // Rough per-evaluation cost in "simple instruction" units (noise and
+    // fBm builtins weigh more). Used to skip memoizing trivially cheap programs.
+    int estimatedCost() const { return estimatedCost_; }
+
+private:
+    friend class ExpressionCompiler;
+
+    std::vector<ExprInstruction> code_;
+    std::vector<ExprVmValue> constants_;
+    std::vector<ExprSlot> slots_;
+    int maxStackDepth_ = 0;
+    int nodeCount_ = 0;
+    int treeDepth_ = 0;
+    std::uint64_t fingerprint_ = 0;
+    int estimatedCost_ = 0;
+};
+
+// AST -> bytecode compiler. Returns null when the AST uses constructs the VM
+// does not model; callers keep evaluating those through the AST.
+class ExpressionCompiler {
+private:
+    class Impl;
+    Impl* impl_;
+
+public:
+    ExpressionCompiler();
+    ~ExpressionCompiler();
+
+    // Function names that must not be bound to native builtins (e.g. names
+    // re-registered by the host with custom behaviour).
+    void setExcludedFunctions(const std::vector<std::string>& names);
+
+    SharedPtr<ExpressionProgram> compile(const SharedPtr<ExprNode>& root);
+
+    std::string getError() const;
+};
+
+enum class ExprVmStatus {
+    Ok,
+    // The AST evaluator would report an error here; re-run through the AST
+    Fallback
+};
+
+// Struct-of-arrays binding of one program slot for ExpressionVM::runBatch.
+// Uniform bindings broadcast one value to every lane; varying bindings read
+// component c of lane i from components[c][i].
+struct ExprBatchBinding {
+    ExprVmValue uniform;
+    ExprValueType varyingType = ExprValueType::Null;
+    const double* components[4] = {nullptr, nullptr, nullptr, nullptr};
+
+    static ExprBatchBinding uniformValue(const ExprVmValue& value);
+    // type is Number (x only) or Vec2-4 (x..w as needed)
+    static ExprBatchBinding varying(ExprValueType type, const double* x,
+                                    const double* y = nullptr,
+                                    const double* z = nullptr,
+                                    const double* w = nullptr);
+
+    bool isVarying() const { return components[0] != nullptr; }
+    ExprVmValue lane(int index) const;
+};
+
+// Struct-of-arrays output of ExpressionVM::runBatch. `types` is required;
+// component arrays and `status` may be null when the caller does not need them.
+// Components past a lane's dimension are written as 0.
+struct ExprBatchResult {
+    ExprValueType* types = nullptr;
+    double* components[4] = {nullptr, nullptr, nullptr, nullptr};
+    ExprVmStatus* status = nullptr;
+
+    void store(int lane, const ExprVmValue& value, ExprVmStatus laneStatus = ExprVmStatus::Ok);
+};
+
+class ExpressionVM {
+public:
+    static constexpr int kMaxStackDepth = 64;
+    static constexpr int kBatchLanes = 8;
+
+    // Runs the program with slot values bound by the caller. Uses a fixed
+    // on-stack operand stack; never allocates.
+    static ExprVmStatus run(const ExpressionProgram& program,
+                            const ExprVmValue* slots,
+                            ExprVmValue& result);
+
+    // Runs the program for `count` lanes. Each block of kBatchLanes lanes is
+    // executed one instruction at a time over SoA registers, so arithmetic,
+    // interpolation and noise builtins run as tight per-lane loops. A block
+    // whose lanes diverge (different branch taken, per-lane Null result such
+    // as a division by zero, mixed in/out of range index) is re-run lane by
+    // lane through run(), so results always match the scalar VM.
+    // Returns the number of lanes whose status is Fallback.
+    static int runBatch(const ExpressionProgram& program,
+                        const ExprBatchBinding* slots,
+                        int count,
+                        ExprBatchResult& result);
+
+    // Wiggle receives the current `time` as an extra trailing argument.
+    static ExprVmValue callBuiltin(ExprBuiltinId id, const ExprVmValue* args, int argc);
+};
+
+}
@@ -36,6 +36,8 @@ import Memory.SharedPtr;
 
 import Script.Expression.Value;
 import Script.Expression.Parser;
+import Script.Expression.Bytecode;
+import Script.Expression.MemoCache;
 import Core.ArtifactString;
 
 
@@ -106,9 +108,28 @@ public:
     int currentEvaluationCount() const;
 
     // --- Memoization (Phase 2) ---
+    // Results of compiled evaluations are memoized in a bounded, sharded
+    // ExpressionMemoCache keyed by (program fingerprint, time, slot values).
+    // Evaluators share ExpressionMemoCache::shared() unless given their own;
+    // clearMemoCache() clears whichever cache is in use.
     void setMemoizationEnabled(bool enabled);
     bool memoizationEnabled() const;
     void clearMemoCache();
+    void setMemoCache(ExpressionMemoCache* cache);  // null = shared cache
+    ExpressionMemoCache& memoCache() const;
+
+    // --- Bytecode VM (Phase 4) ---
+    // evaluate / evaluateAST / evaluateASTAtTime compile each AST once into an
+    // ExpressionProgram and run it on ExpressionVM. ASTs that use constructs the
+    // VM does not model (strings, arrays, objects, host functions) and any
+    // evaluation that would report an error fall back to the AST walker.
+    // ExpressionVM::run itself does not allocate, but the ExpressionValue
+    // returned to the caller is still heap-backed.
+    void setBytecodeEnabled(bool enabled);
+    bool bytecodeEnabled() const;
+    void clearCompiledCache();
+    // Compiled program for the AST, or null when it must run through the AST.
+    SharedPtr<ExpressionProgram> compiledProgram(const SharedPtr<ExprNode>& node);
 
     // Variable snapshot (for temporary injection)
     std::map<std::string, ExpressionValue> getVariablesCopy() const;
@@ -155,6 +176,24 @@ public:
     // Evaluate pre-parsed AST at an arbitrary time point (seconds)
     ExpressionValue evaluateASTAtTime(const SharedPtr<ExprNode>& node, double timeSec);
 
+    // --- Batch Evaluation (Phase 5) ---
+    // Evaluate one AST for many lanes at once (baking a frame range, per-layer
+    // or per-particle instances). Compiled ASTs run on ExpressionVM::runBatch
+    // over struct-of-arrays data; lanes the VM cannot take go through
+    // evaluateASTAtTime / evaluateAST, so every lane matches the per-call API.
+    // out.types must hold `count` entries; component arrays are optional and
+    // out.status (if set) is Ok for every lane. getError() reports the first
+    // lane error.
+    void evaluateASTAtTimes(const SharedPtr<ExprNode>& node, const double* times, int count,
+                            ExprBatchResult& out);
+    std::vector<ExpressionValue> evaluateASTAtTimes(const SharedPtr<ExprNode>& node,
+                                                    const std::vector<double>& times);
+    // Per-instance batch: `varying` supplies per-lane values for the named
+    // variables; every other variable is shared by all lanes.
+    void evaluateASTBatch(const SharedPtr<ExprNode>& node,
+                          const std::map<std::string, ExprBatchBinding>& varying,
+                          int count, ExprBatchResult& out);
+
     // Evaluate expression over a time range using current evaluation mode
     // Returns vector of (time, value) pairs sampled according to the mode
     std::vector<std::pair<double, ExpressionValue>> evaluateOverRange(
@@ -0,0 +1,89 @@
+module;
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+export module Script.Expression.MemoCache;
+
+import Script.Expression.Bytecode;
+
+export namespace ArtifactCore {
+
+// Memo key of one compiled evaluation.
+// program:    ExpressionProgram::fingerprint()
+// time:       value bound to the `time` slot (0 when the program does not read it)
+// dependency: hash of every other slot value and its dependencyVersion(),
+//             mixed with the cache generation
+struct ExprMemoKey {
+    std::uint64_t program = 0;
+    double time = 0.0;
+    std::uint64_t dependency = 0;
+
+    bool operator==(const ExprMemoKey& other) const;
+};
+
+struct ExprMemoStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t insertions = 0;
+    std::uint64_t evictions = 0;
+    std::uint64_t invalidations = 0;
+    std::size_t size = 0;
+    std::size_t capacity = 0;
+};
+
+// Bounded memo cache for compiled expression results.
+// Entries are spread over independently locked shards so render threads
+// evaluating different frames do not serialize on one mutex. Each shard is a
+// fixed set-associative table evicting with the CLOCK (second chance) policy,
+// so memory stays bounded and steady-state use does not allocate.
+class ExpressionMemoCache {
+private:
+    class Impl;
+    Impl* impl_;
+
+public:
+    static constexpr std::size_t kShardCount = 16;
+    static constexpr std::size_t kDefaultCapacity = 16384;
+
+    explicit ExpressionMemoCache(std::size_t capacity = kDefaultCapacity);
+    ~ExpressionMemoCache();
+
+    ExpressionMemoCache(const ExpressionMemoCache&) = delete;
+    ExpressionMemoCache& operator=(const ExpressionMemoCache&) = delete;
+
+    // Process-wide cache shared by every ExpressionEvaluator
+    static ExpressionMemoCache& shared();
+
+    bool lookup(const ExprMemoKey& key, ExprVmValue& out);
+    void insert(const ExprMemoKey& key, const ExprVmValue& value);
+
+    // Drops every entry and advances generation() so keys built before the
+    // call can no longer match. Hosts call this after global state the VM
+    // reads changes (e.g. NoiseGenerator::setSeed).
+    void invalidateAll();
+    void clear();
+
+    // Mixed into ExprMemoKey::dependency by callers
+    std::uint64_t generation() const;
+
+    // Per-variable invalidation. Evaluators mix dependencyVersion() of every
+    // variable a program reads into ExprMemoKey::dependency, so invalidate()
+    // only makes evaluations that read that variable miss; their old entries
+    // age out through CLOCK. Versions live in a fixed table indexed by the
+    // hash, so a collision costs extra misses, never a stale hit.
+    // PropertyLinkManager calls this for the targets it updates.
+    static std::uint64_t dependencyHash(std::string_view variableName);
+    void invalidate(std::uint64_t dependencyHash);
+    std::uint64_t dependencyVersion(std::uint64_t dependencyHash) const;
+
+    // Rounded up to whole buckets; clears the cache.
+    void setCapacity(std::size_t capacity);
+    std::size_t capacity() const;
+
+    ExprMemoStats stats() const;
+    void resetStats();
+};
+
+}
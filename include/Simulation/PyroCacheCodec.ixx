@@ -0,0 +1,323 @@
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <vector>
+
+export module Core.Simulation.PyroCacheCodec;
+
+// Byte-level pieces of the version 3 pyro checkpoint format: half floats, per-brick 8-bit
+// quantization, the Lorenzo predictor and the rANS coder. PyroCache.cppm assembles them into
+// segments and files; they live here so they can be tested on their own.
+export namespace ArtifactCore::PyroCacheCodec {
+
+// Cells per 8^3 brick, PyroTileGrid::kTileCells.
+constexpr std::size_t kBrickCells = 512;
+
+template <typename T>
+void append(std::vector<std::uint8_t>& out, const T& value) {
+    const auto at = out.size();
+    out.resize(at + sizeof(T));
+    std::memcpy(out.data() + at, &value, sizeof(T));
+}
+
+struct ByteReader {
+    const std::uint8_t* data = nullptr;
+    std::size_t size = 0;
+    std::size_t at = 0;
+
+    template <typename T>
+    bool read(T& value) noexcept {
+        if (size - at < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data + at, sizeof(T));
+        at += sizeof(T);
+        return true;
+    }
+
+    const std::uint8_t* take(std::uint64_t bytes) noexcept {
+        if (size - at < bytes) {
+            return nullptr;
+        }
+        const auto* begin = data + at;
+        at += static_cast<std::size_t>(bytes);
+        return begin;
+    }
+};
+
+std::uint16_t floatToHalf(float value) noexcept {
+    const auto bits = std::bit_cast<std::uint32_t>(value);
+    const std::uint32_t sign = (bits >> 16u) & 0x8000u;
+    const std::uint32_t exponent = (bits >> 23u) & 0xffu;
+    const std::uint32_t mantissa = bits & 0x7fffffu;
+    if (exponent == 0xffu) {
+        return static_cast<std::uint16_t>(sign | 0x7c00u | (mantissa ? 0x0200u : 0u));
+    }
+    const int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if (halfExponent >= 31) {
+        return static_cast<std::uint16_t>(sign | 0x7c00u);
+    }
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) {
+            return static_cast<std::uint16_t>(sign);
+        }
+        const std::uint32_t shifted = (mantissa | 0x800000u) >> (1 - halfExponent);
+        return static_cast<std::uint16_t>(sign | ((shifted + 0x1000u) >> 13u));
+    }
+    // Added rather than or-ed so that rounding the mantissa up carries into the exponent.
+    return static_cast<std::uint16_t>(sign | ((static_cast<std::uint32_t>(halfExponent) << 10u) + ((mantissa + 0x1000u) >> 13u)));
+}
+
+float halfToFloat(std::uint16_t half) noexcept {
+    const std::uint32_t sign = static_cast<std::uint32_t>(half & 0x8000u) << 16u;
+    const std::uint32_t exponent = (half >> 10u) & 0x1fu;
+    std::uint32_t mantissa = half & 0x3ffu;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            return std::bit_cast<float>(sign);
+        }
+        std::uint32_t shift = 0;
+        while ((mantissa & 0x400u) == 0) {
+            mantissa <<= 1u;
+            ++shift;
+        }
+        return std::bit_cast<float>(sign | ((113u - shift) << 23u) | ((mantissa & 0x3ffu) << 13u));
+    }
+    if (exponent == 31) {
+        return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13u));
+    }
+    return std::bit_cast<float>(sign | ((exponent + 112u) << 23u) | (mantissa << 13u));
+}
+
+// Maps one brick onto 8 bits between its own min and max; low and high receive that range.
+// A brick with no finite range stores zeros with a (0, 0) range.
+void quantizeBrick(const float* in, std::uint8_t* out, float& low, float& high) noexcept {
+    low = std::numeric_limits<float>::infinity();
+    high = -std::numeric_limits<float>::infinity();
+    for (std::size_t i = 0; i < kBrickCells; ++i) {
+        low = in[i] < low ? in[i] : low;
+        high = in[i] > high ? in[i] : high;
+    }
+    if (!(low <= high)) {
+        low = high = 0.0f;
+    }
+    const float scale = high > low ? 255.0f / (high - low) : 0.0f;
+    for (std::size_t i = 0; i < kBrickCells; ++i) {
+        const float t = (in[i] - low) * scale;
+        out[i] = static_cast<std::uint8_t>((t >= 0.0f ? std::min(t, 255.0f) : 0.0f) + 0.5f);
+    }
+}
+
+// Code 0 maps back to low exactly, so an all-low brick (most often all zero) stays exact.
+void dequantizeBrick(const std::uint8_t* in, float low, float high, float* out) noexcept {
+    const float step = (high - low) / 255.0f;
+    for (std::size_t i = 0; i < kBrickCells; ++i) {
+        out[i] = in[i] == 0 ? low : low + static_cast<float>(in[i]) * step;
+    }
+}
+
+// Codes are predicted from their already-coded neighbours in the brick with a 3D Lorenzo
+// predictor (cells outside the brick count as zero). That predictor is the inverse of a 3D
+// prefix sum, so coding takes differences along z, y and x and decoding sums them back. The
+// residual is zig-zag mapped so that small steps of either sign leave the upper byte planes at zero.
+template <typename T>
+void differenceBrick(T* codes) noexcept {
+    for (std::size_t i = kBrickCells; i-- > 64;) {
+        codes[i] = static_cast<T>(codes[i] - codes[i - 64]);
+    }
+    for (std::size_t i = kBrickCells; i-- > 0;) {
+        if ((i & 0x38u) != 0) {
+            codes[i] = static_cast<T>(codes[i] - codes[i - 8]);
+        }
+    }
+    for (std::size_t i = kBrickCells; i-- > 0;) {
+        if ((i & 7u) != 0) {
+            codes[i] = static_cast<T>(codes[i] - codes[i - 1]);
+        }
+    }
+}
+
+template <typename T>
+void integrateBrick(T* codes) noexcept {
+    for (std::size_t row = 0; row < kBrickCells; row += 8) {
+        for (std::size_t x = 1; x < 8; ++x) {
+            codes[row + x] = static_cast<T>(codes[row + x] + codes[row + x - 1]);
+        }
+    }
+    for (std::size_t slice = 0; slice < kBrickCells; slice += 64) {
+        for (std::size_t i = slice + 8; i < slice + 64; ++i) {
+            codes[i] = static_cast<T>(codes[i] + codes[i - 8]);
+        }
+    }
+    for (std::size_t i = 64; i < kBrickCells; ++i) {
+        codes[i] = static_cast<T>(codes[i] + codes[i - 64]);
+    }
+}
+
+template <typename T>
+T zigzag(T residual) noexcept {
+    constexpr unsigned kBits = sizeof(T) * 8u;
+    return static_cast<T>(static_cast<T>(residual << 1u) ^ static_cast<T>(0u - (residual >> (kBits - 1u))));
+}
+
+template <typename T>
+T unzigzag(T code) noexcept {
+    return static_cast<T>(static_cast<T>(code >> 1u) ^ static_cast<T>(0u - (code & 1u)));
+}
+
+// Order-0 rANS over bytes (32-bit state, byte-wise renormalisation). The frequency table is
+// stored as a 256-bit presence map plus one u16 per present symbol.
+constexpr std::uint32_t kRansScaleBits = 14;
+constexpr std::uint32_t kRansScale = 1u << kRansScaleBits;
+constexpr std::uint32_t kRansLow = 1u << 23;
+
+std::array<std::uint32_t, 256> normalizeFrequencies(const std::array<std::uint32_t, 256>& counts, std::size_t total) {
+    std::array<std::uint32_t, 256> frequencies{};
+    std::uint32_t sum = 0;
+    for (std::size_t symbol = 0; symbol < 256; ++symbol) {
+        if (counts[symbol] != 0) {
+            frequencies[symbol] = std::max<std::uint32_t>(1u,
+                static_cast<std::uint32_t>(static_cast<std::uint64_t>(counts[symbol]) * kRansScale / total));
+            sum += frequencies[symbol];
+        }
+    }
+    while (sum != kRansScale) {
+        const auto largest = static_cast<std::size_t>(std::max_element(frequencies.begin(), frequencies.end()) - frequencies.begin());
+        if (sum < kRansScale) {
+            frequencies[largest] += kRansScale - sum;
+            sum = kRansScale;
+        } else {
+            const std::uint32_t take = std::min(sum - kRansScale, frequencies[largest] - 1u);
+            frequencies[largest] -= take;
+            sum -= take;
+        }
+    }
+    return frequencies;
+}
+
+std::vector<std::uint8_t> ransEncode(std::span<const std::uint8_t> raw) {
+    std::array<std::uint32_t, 256> counts{};
+    for (const auto byte : raw) {
+        ++counts[byte];
+    }
+    const auto frequencies = normalizeFrequencies(counts, raw.size());
+    std::array<std::uint32_t, 256> starts{};
+    for (std::size_t symbol = 1; symbol < 256; ++symbol) {
+        starts[symbol] = starts[symbol - 1] + frequencies[symbol - 1];
+    }
+
+    std::vector<std::uint8_t> out(32, 0);
+    for (std::size_t symbol = 0; symbol < 256; ++symbol) {
+        if (frequencies[symbol] != 0) {
+            out[symbol >> 3u] |= static_cast<std::uint8_t>(1u << (symbol & 7u));
+        }
+    }
+    for (std::size_t symbol = 0; symbol < 256; ++symbol) {
+        if (frequencies[symbol] != 0) {
+            append(out, static_cast<std::uint16_t>(frequencies[symbol]));
+        }
+    }
+
+    // A symbol emits at most two bytes, plus four for each final state.
+    std::vector<std::uint8_t> payload(raw.size() * 2 + 8);
+    std::uint8_t* cursor = payload.data() + payload.size();
+    std::array<std::uint32_t, 2> states{kRansLow, kRansLow};
+    for (std::size_t i = raw.size(); i-- > 0;) {
+        auto& state = states[i & 1u];
+        const std::uint32_t frequency = frequencies[raw[i]];
+        const std::uint32_t limit = ((kRansLow >> kRansScaleBits) << 8u) * frequency;
+        while (state >= limit) {
+            *--cursor = static_cast<std::uint8_t>(state);
+            state >>= 8u;
+        }
+        state = ((state / frequency) << kRansScaleBits) + (state % frequency) + starts[raw[i]];
+    }
+    for (std::size_t lane = 2; lane-- > 0;) {
+        cursor -= 4;
+        for (int byte = 0; byte < 4; ++byte) {
+            cursor[byte] = static_cast<std::uint8_t>(states[lane] >> (byte * 8));
+        }
+    }
+    out.insert(out.end(), cursor, payload.data() + payload.size());
+    return out;
+}
+
+bool ransDecode(std::span<const std::uint8_t> coded, std::span<std::uint8_t> raw) {
+    ByteReader in{coded.data(), coded.size()};
+    const auto* presence = in.take(32);
+    if (!presence) {
+        return false;
+    }
+    std::array<std::uint32_t, 256> frequencies{};
+    std::array<std::uint32_t, 256> starts{};
+    std::uint32_t sum = 0;
+    for (std::size_t symbol = 0; symbol < 256; ++symbol) {
+        starts[symbol] = sum;
+        if ((presence[symbol >> 3u] >> (symbol & 7u)) & 1u) {
+            std::uint16_t frequency = 0;
+            if (!in.read(frequency) || frequency == 0) {
+                return false;
+            }
+            frequencies[symbol] = frequency;
+            sum += frequency;
+        }
+    }
+    if (sum != kRansScale) {
+        return false;
+    }
+    std::vector<std::uint8_t> symbols(kRansScale);
+    for (std::size_t symbol = 0; symbol < 256; ++symbol) {
+        std::fill_n(symbols.begin() + starts[symbol], frequencies[symbol], static_cast<std::uint8_t>(symbol));
+    }
+
+    const auto* cursor = in.take(8);
+    if (!cursor) {
+        return false;
+    }
+    const auto* end = coded.data() + coded.size();
+    // Two interleaved states (even and odd symbols) hide the latency of the table lookups.
+    const auto readState = [&cursor] {
+        const std::uint32_t state = static_cast<std::uint32_t>(cursor[0]) | (static_cast<std::uint32_t>(cursor[1]) << 8u)
+            | (static_cast<std::uint32_t>(cursor[2]) << 16u) | (static_cast<std::uint32_t>(cursor[3]) << 24u);
+        cursor += 4;
+        return state;
+    };
+    std::uint32_t even = readState();
+    std::uint32_t odd = readState();
+    const auto decodeOne = [&](std::uint32_t& state) {
+        const std::uint32_t slot = state & (kRansScale - 1u);
+        const std::uint8_t symbol = symbols[slot];
+        state = frequencies[symbol] * (state >> kRansScaleBits) + slot - starts[symbol];
+        return symbol;
+    };
+    const auto renormalize = [&](std::uint32_t& state) {
+        while (state < kRansLow) {
+            if (cursor == end) {
+                return false;
+            }
+            state = (state << 8u) | *cursor++;
+        }
+        return true;
+    };
+    std::size_t i = 0;
+    for (; i + 1 < raw.size(); i += 2) {
+        raw[i] = decodeOne(even);
+        raw[i + 1] = decodeOne(odd);
+        if (!renormalize(even) || !renormalize(odd)) {
+            return false;
+        }
+    }
+    if (i < raw.size()) {
+        raw[i] = decodeOne(even);
+        return renormalize(even);
+    }
+    return true;
+}
+
+} // namespace ArtifactCore::PyroCacheCodec
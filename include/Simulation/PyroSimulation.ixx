@@ -5,6 +5,7 @@ module;
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
 #include <unordered_map>
 #include <span>
 #include <string>
@@ -19,6 +20,7 @@ export namespace ArtifactCore {
 
 enum class PyroBoundaryMode : std::uint8_t { Open = 0, Closed = 1 };
 enum class PyroBackendKind : std::uint8_t { CPUReference = 0, GPUCompute = 1 };
+enum class PyroPressureSolver : std::uint8_t { RedBlackGaussSeidel = 0, MultigridPCG = 1 };
 enum class PyroFieldChannel : std::uint8_t {
     Density = 0, Temperature = 1, Fuel = 2, Pressure = 3, Divergence = 4, Velocity = 5, Color = 6
 };
@@ -63,6 +65,36 @@ struct PyroResolution {
     int depth = 0;
 };
 
+// Sparse layout shared by every field of a PyroFieldSet. The grid is cut into 8^3 tiles and
+// only active tiles own a brick of kTileCells values in each field's storage; cells in
+// inactive tiles read as zero. Bricks are stored in ascending tile order, cells x-fastest.
+struct PyroTileGrid {
+    static constexpr int kTileShift = 3;
+    static constexpr int kTileSize = 1 << kTileShift;
+    static constexpr std::size_t kTileCells = static_cast<std::size_t>(kTileSize) * kTileSize * kTileSize;
+    static constexpr std::int32_t kInactive = -1;
+    static constexpr std::int32_t kOutside = -2;
+
+    PyroResolution resolution{};
+    PyroResolution tiles{};
+    // Brick index per tile, or kInactive.
+    std::vector<std::int32_t> slots;
+    // Tile index per brick.
+    std::vector<std::uint32_t> active;
+    // Six face neighbours per brick (-x, +x, -y, +y, -z, +z): a brick index, kInactive or kOutside.
+    std::vector<std::int32_t> links;
+    // True when some active tile touches an inactive one, i.e. the active region has an open face.
+    bool openFaces = false;
+
+    void reset(PyroResolution cells);
+    void assign(std::span<const std::uint8_t> mask);
+    [[nodiscard]] std::size_t tileCount() const noexcept;
+    [[nodiscard]] std::size_t brickCount() const noexcept { return active.size(); }
+    [[nodiscard]] std::uint32_t tileIndex(int tx, int ty, int tz) const noexcept;
+    // Storage offset of a cell, or -1 when it is outside the grid or its tile is inactive.
+    [[nodiscard]] std::int64_t offsetOf(int x, int y, int z) const noexcept;
+};
+
 struct PyroDomain {
     PyroVec3 min{};
     PyroVec3 max{1.0f, 1.0f, 1.0f};
@@ -86,11 +118,19 @@ struct PyroMemoryEstimate {
     std::size_t divergenceBytes = 0;
     std::size_t velocityBytes = 0;
     std::size_t colorBytes = 0;
+    std::size_t tileTableBytes = 0;
     std::size_t totalBytes = 0;
+    std::size_t activeTiles = 0;
+    std::size_t totalTiles = 0;
+    // What the same fields would take as dense grids.
+    std::size_t denseBytes = 0;
 };
 
 struct PyroFieldSnapshot {
     PyroResolution resolution{};
+    // Tile index of each stored brick. Empty for version 1 cache files, whose fields are dense,
+    // and for a field set with no active tiles, whose fields are empty.
+    std::vector<std::uint32_t> activeTiles;
     std::vector<float> density;
     std::vector<float> temperature;
     std::vector<float> fuel;
@@ -105,6 +145,79 @@ struct PyroCacheStatus {
     std::string reason;
 };
 
+enum class PyroCacheEncoding : std::uint8_t { Float32 = 0, Half = 1, Quantized8 = 2 };
+
+// How each field is written to disk checkpoints. Float32 is lossless, so a resumed run matches
+// the original bit for bit; Half keeps 11 significant bits; Quantized8 stores every brick as
+// 8 bits between that brick's own min and max. All-zero bricks are skipped and the rest are
+// delta-predicted and rANS-coded. Checkpoints are restored into the simulation state, so every
+// channel defaults to Float32; the lossy encodings are for render-only caches and are opt-in.
+struct PyroCacheSettings {
+    PyroCacheEncoding density = PyroCacheEncoding::Float32;
+    PyroCacheEncoding temperature = PyroCacheEncoding::Float32;
+    PyroCacheEncoding fuel = PyroCacheEncoding::Float32;
+    PyroCacheEncoding pressure = PyroCacheEncoding::Float32;
+    PyroCacheEncoding divergence = PyroCacheEncoding::Float32;
+    PyroCacheEncoding velocity = PyroCacheEncoding::Float32;
+    bool entropyCoding = true;
+    // Checkpoints on each side of a seek() that are decoded in the background.
+    int prefetchRadius = 2;
+
+    [[nodiscard]] PyroCacheEncoding encoding(PyroFieldChannel channel) const noexcept;
+};
+
+// Read-only view of a checkpoint file. open() maps the file and parses only the header and
+// channel table; read() decodes just the requested fields, so a renderer that needs density
+// and temperature never pages in the velocity or pressure streams. Version 1 and 2 files
+// (raw float arrays) open too.
+class PyroCacheFile {
+public:
+    PyroCacheFile() = default;
+    ~PyroCacheFile();
+    PyroCacheFile(const PyroCacheFile&) = delete;
+    PyroCacheFile& operator=(const PyroCacheFile&) = delete;
+    PyroCacheFile(PyroCacheFile&& other) noexcept;
+    PyroCacheFile& operator=(PyroCacheFile&& other) noexcept;
+
+    [[nodiscard]] bool open(const std::filesystem::path& path);
+    void close() noexcept;
+    [[nodiscard]] bool isOpen() const noexcept { return data_ != nullptr; }
+    [[nodiscard]] std::uint32_t version() const noexcept { return version_; }
+    [[nodiscard]] std::size_t fileBytes() const noexcept { return size_; }
+    [[nodiscard]] const PyroResolution& resolution() const noexcept { return resolution_; }
+    [[nodiscard]] const std::vector<std::uint32_t>& activeTiles() const noexcept { return activeTiles_; }
+    [[nodiscard]] PyroFieldMask availableFields() const noexcept;
+    // Encoded size of one field; 0 when the file does not hold it.
+    [[nodiscard]] std::uint64_t fieldBytes(PyroFieldChannel channel) const noexcept;
+    // Fills resolution, activeTiles and the requested fields; the other fields are left empty.
+    [[nodiscard]] bool read(PyroFieldMask fields, PyroFieldSnapshot& snapshot) const;
+
+private:
+    struct Entry {
+        PyroFieldChannel channel = PyroFieldChannel::Density;
+        PyroCacheEncoding encoding = PyroCacheEncoding::Float32;
+        bool raw = false;
+        std::uint64_t offset = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    void* mapping_ = nullptr;
+    std::uint32_t version_ = 0;
+    PyroResolution resolution_{};
+    std::vector<std::uint32_t> activeTiles_;
+    std::vector<Entry> entries_;
+
+    bool parse();
+    bool decode(const Entry& entry, PyroFieldSnapshot& snapshot) const;
+};
+
+// Writes a snapshot in the current checkpoint format. The file is written next to the target
+// and renamed over it, so a reader never maps a half-written file.
+[[nodiscard]] bool writePyroCacheFile(const std::filesystem::path& path, const PyroFieldSnapshot& snapshot,
+    const PyroCacheSettings& settings);
+
 struct PyroSampleResult {
     float scalar = 0.0f;
     PyroVec3 vector{};
@@ -113,37 +226,57 @@ struct PyroSampleResult {
 struct PyroScalarFieldView {
     std::span<float> values;
     PyroResolution resolution{};
+    // Null for a plain dense array.
+    const PyroTileGrid* tiles = nullptr;
 
     [[nodiscard]] bool empty() const noexcept;
     [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool contains(int x, int y, int z) const noexcept;
+    // The cell must be stored, see contains(); throws std::out_of_range otherwise.
     [[nodiscard]] float& at(int x, int y, int z) const;
+    [[nodiscard]] float value(int x, int y, int z) const noexcept;
 };
 
 struct PyroConstScalarFieldView {
     std::span<const float> values;
     PyroResolution resolution{};
+    // Null for a plain dense array.
+    const PyroTileGrid* tiles = nullptr;
 
     [[nodiscard]] bool empty() const noexcept;
     [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool contains(int x, int y, int z) const noexcept;
+    // The cell must be stored, see contains(); throws std::out_of_range otherwise.
     [[nodiscard]] const float& at(int x, int y, int z) const;
+    [[nodiscard]] float value(int x, int y, int z) const noexcept;
 };
 
 struct PyroVectorFieldView {
     std::span<PyroVec3> values;
     PyroResolution resolution{};
+    // Null for a plain dense array.
+    const PyroTileGrid* tiles = nullptr;
 
     [[nodiscard]] bool empty() const noexcept;
     [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool contains(int x, int y, int z) const noexcept;
+    // The cell must be stored, see contains(); throws std::out_of_range otherwise.
     [[nodiscard]] PyroVec3& at(int x, int y, int z) const;
+    [[nodiscard]] PyroVec3 value(int x, int y, int z) const noexcept;
 };
 
 struct PyroConstVectorFieldView {
     std::span<const PyroVec3> values;
     PyroResolution resolution{};
+    // Null for a plain dense array.
+    const PyroTileGrid* tiles = nullptr;
 
     [[nodiscard]] bool empty() const noexcept;
     [[nodiscard]] std::size_t size() const noexcept;
+    [[nodiscard]] bool contains(int x, int y, int z) const noexcept;
+    // The cell must be stored, see contains(); throws std::out_of_range otherwise.
     [[nodiscard]] const PyroVec3& at(int x, int y, int z) const;
+    [[nodiscard]] PyroVec3 value(int x, int y, int z) const noexcept;
 };
 
 struct PyroSimulationSettings {
@@ -156,6 +289,54 @@ struct PyroSimulationSettings {
     float vorticity = 0.0f;
     float pressureIterations = 20.0f;
     float advectionClamp = 1.0f;
+    // Red-black Gauss-Seidel is the default; MultigridPCG is opt-in. The default replaces
+    // the original lexicographic Gauss-Seidel sweep and, with the mean removal on closed
+    // domains and the early stop below, gives different results than that solver did.
+    // hashSettings() changed with it, so caches baked by the old solver no longer match.
+    PyroPressureSolver pressureSolver = PyroPressureSolver::RedBlackGaussSeidel;
+    // Relative residual |r| / |b| at which the pressure solve stops early.
+    float pressureTolerance = 1e-4f;
+    // Tiles stay active while density, temperature or fuel in any cell exceeds the
+    // threshold, plus a one-tile margin, source regions and moving no-slip colliders.
+    // The pressure solve treats inactive neighbours as an open p = 0 boundary, which
+    // changes results against the dense grid, so this is opt-in.
+    bool sparseTiles = false;
+    float activityThreshold = 1e-4f;
+};
+
+struct PyroStepStats {
+    double tilesMs = 0.0;
+    double sourcesMs = 0.0;
+    double combustionMs = 0.0;
+    double forcesMs = 0.0;
+    double advectionMs = 0.0;
+    double divergenceMs = 0.0;
+    double pressureMs = 0.0;
+    double projectionMs = 0.0;
+    double collidersMs = 0.0;
+    double totalMs = 0.0;
+    int pressureIterations = 0;
+    float pressureResidual = 0.0f;
+    bool pressureConverged = false;
+    std::size_t activeTiles = 0;
+};
+
+struct PyroPressureLevel {
+    PyroResolution resolution{};
+    PyroTileGrid tiles{};
+    std::vector<float> solution;
+    std::vector<float> rhs;
+    std::vector<float> residual;
+};
+
+struct PyroPressureWorkspace {
+    std::vector<PyroPressureLevel> levels;
+    // Zero-mean copy of the divergence for closed domains, so the field itself stays as computed.
+    std::vector<float> rhs;
+    std::vector<float> residual;
+    std::vector<float> preconditioned;
+    std::vector<float> direction;
+    std::vector<float> product;
 };
 
 struct PyroSourceState {
@@ -206,11 +387,29 @@ struct PyroFrameSnapshot {
 
 class PyroFieldSet {
 public:
+    // Both leave every tile active and zero-filled, as the dense grid was. With sparse
+    // tiles the first step drops the tiles that hold nothing.
     void resize(PyroResolution resolution);
     void clear();
     [[nodiscard]] PyroResolution resolution() const noexcept { return resolution_; }
     [[nodiscard]] std::size_t cellCount() const noexcept;
     [[nodiscard]] bool empty() const noexcept { return cellCount() == 0; }
+    [[nodiscard]] const PyroTileGrid& tiles() const noexcept { return tiles_; }
+    [[nodiscard]] std::size_t activeCellCount() const noexcept;
+    void activateAll();
+    // Keeps the bricks of tiles that stay active, zero-fills new ones and drops the rest.
+    void setActiveTiles(std::span<const std::uint8_t> mask);
+    // Dense arrays in x-fastest order. Importing activates every tile holding a non-zero value.
+    bool importDense(PyroFieldChannel channel, std::span<const float> values);
+    bool importDenseVelocity(std::span<const PyroVec3> values);
+    [[nodiscard]] std::vector<float> exportDense(PyroFieldChannel channel) const;
+    [[nodiscard]] std::vector<PyroVec3> exportDenseVelocity() const;
+    [[nodiscard]] PyroFieldSnapshot capture() const;
+    bool restore(const PyroFieldSnapshot& snapshot);
+    // The views' values and the *Storage() vectors are the brick pools, not x-fastest
+    // arrays: cells are grouped into 8x8x8 bricks in tiles().active order, also when
+    // sparse tiles are off. Index them through at() / value(), or convert with
+    // exportDense() / importDense() when an x-fastest array is needed.
     [[nodiscard]] PyroScalarFieldView densityView() noexcept;
     [[nodiscard]] PyroConstScalarFieldView densityView() const noexcept;
     [[nodiscard]] PyroScalarFieldView temperatureView() noexcept;
@@ -244,6 +443,7 @@ public:
 
 private:
     PyroResolution resolution_{};
+    PyroTileGrid tiles_{};
     std::vector<float> density_;
     std::vector<float> temperature_;
     std::vector<float> fuel_;
@@ -251,6 +451,11 @@ private:
     std::vector<float> divergence_;
     std::vector<PyroVec3> velocity_;
 
+    [[nodiscard]] std::vector<float>* scalarStorage(PyroFieldChannel channel) noexcept;
+    [[nodiscard]] const std::vector<float>* scalarStorage(PyroFieldChannel channel) const noexcept;
+    // Drops every tile; restore() installs the snapshot's tile list on top.
+    void releaseTiles(PyroResolution resolution);
+
     friend class PyroSimulation;
 };
 
@@ -273,6 +478,9 @@ public:
     [[nodiscard]] std::uint64_t cacheInterval() const noexcept { return cacheInterval_; }
     void setCacheDirectory(std::filesystem::path cacheDirectory);
     [[nodiscard]] const std::filesystem::path& cacheDirectory() const noexcept { return cacheDirectory_; }
+    void setCacheSettings(PyroCacheSettings cacheSettings) { cacheSettings_ = cacheSettings; }
+    [[nodiscard]] const PyroCacheSettings& cacheSettings() const noexcept { return cacheSettings_; }
+    [[nodiscard]] std::filesystem::path checkpointPath(std::uint64_t frameIndex) const;
     [[nodiscard]] PyroCacheStatus saveCheckpointToDisk(std::uint64_t frameIndex) const;
     [[nodiscard]] PyroCacheStatus loadCheckpointFromDisk(std::uint64_t frameIndex);
     void reset();
@@ -288,8 +496,11 @@ public:
     [[nodiscard]] std::span<const PyroColliderState> colliders() const noexcept { return colliders_; }
     [[nodiscard]] std::uint64_t frameIndex() const noexcept { return frameIndex_; }
     [[nodiscard]] double timeSeconds() const noexcept { return timeSeconds_; }
+    [[nodiscard]] const PyroStepStats& lastStepStats() const noexcept { return stepStats_; }
 
 private:
+    struct CachePrefetch;
+
     PyroDomain domain_{};
     PyroSimulationSettings settings_{};
     PyroFieldSet fields_{};
@@ -306,10 +517,14 @@ private:
     double accumulator_ = 0.0;
     std::uint64_t cacheInterval_ = 16;
     std::filesystem::path cacheDirectory_;
+    PyroCacheSettings cacheSettings_{};
+    std::shared_ptr<CachePrefetch> cachePrefetch_;
+    PyroStepStats stepStats_{};
+    PyroPressureWorkspace pressureWorkspace_{};
 
-    [[nodiscard]] std::size_t cellIndex(int x, int y, int z) const noexcept;
     [[nodiscard]] bool isInsideDomain(const PyroVec3& position) const noexcept;
     [[nodiscard]] bool isInsideCollider(const PyroColliderState& collider, const PyroVec3& position) const noexcept;
+    void updateActiveTiles();
     void applyColliders();
     void applyCombustion(float deltaSeconds);
     void applyVorticityConfinement(float deltaSeconds);
@@ -318,13 +533,17 @@ private:
     bool saveCheckpointSnapshot(const PyroFieldSnapshot& snapshot, const std::filesystem::path& path) const;
     bool loadCheckpointSnapshot(PyroFieldSnapshot& snapshot, const std::filesystem::path& path) const;
     bool restoreCheckpoint(std::uint64_t frameIndex);
+    void prefetchCheckpointsAround(std::uint64_t frameIndex);
     void computeDivergence();
     void solvePressure(int iterations);
+    void solvePressureRedBlack(const float* rhs, int iterations);
+    void solvePressureMultigridPCG(const float* rhs, int iterations);
     void projectVelocity();
 };
 
 [[nodiscard]] String toString(PyroBoundaryMode mode);
 [[nodiscard]] String toString(PyroBackendKind kind);
+[[nodiscard]] String toString(PyroPressureSolver solver);
 [[nodiscard]] String toString(PyroFieldChannel channel);
 [[nodiscard]] std::uint64_t hashSettings(const PyroSimulationSettings& settings) noexcept;
 [[nodiscard]] std::uint64_t estimatePyroMemoryBytes(const PyroResolution& resolution) noexcept;
@@ -63,6 +63,13 @@ export struct TaskFailedEvent {
 /// - 依存関係の解決
 /// - 同時実行数の制限
 /// - 結果のdispatch
+///
+/// 構成:
+/// - workerごとに優先度レーン付きのdequeを持ち、空になったworkerは
+///   他のworkerから盗む（全体で共有するキューロックは無い）
+/// - 依存関係は残り依存数のカウンタで管理し、完了時に後続taskを
+///   直接スケジュールする（待ちtaskの再走査はしない）
+/// - 状態・進捗はtaskごとのatomicに公開し、workerはロックを取らない
 /// </summary>
 export class BackgroundTaskWorkerPool {
 public:
@@ -80,6 +87,9 @@ public:
       config_.maxWorkers =
           std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
     }
+    for (int i = 0; i < config_.maxWorkers; ++i) {
+      queues_.push_back(std::make_unique<WorkerQueue>());
+    }
   }
 
   ~BackgroundTaskWorkerPool() { Shutdown(); }
@@ -99,14 +109,11 @@ public:
     for (int i = 0; i < config_.maxWorkers; ++i) {
       workers_.emplace_back(&BackgroundTaskWorkerPool::WorkerLoop, this, i);
     }
-
-    // Scheduler threadを起動
-    schedulerThread_ =
-        std::thread(&BackgroundTaskWorkerPool::SchedulerLoop, this);
   }
 
   /// <summary>
   /// Worker poolをシャットダウンする
+  /// 実行中のtaskは最後まで走り、キュー内のtaskは次のStart()まで残る。
   /// </summary>
   void Shutdown() {
     std::lock_guard<std::mutex> lifecycleLock(lifecycleMutex_);
@@ -115,7 +122,10 @@ public:
     }
 
     running_.store(false);
-    queueCV_.notify_all();
+    {
+      std::lock_guard<std::mutex> lock(idleMutex_);
+      idleCV_.notify_all();
+    }
 
     for (auto &worker : workers_) {
       if (worker.joinable()) {
@@ -127,56 +137,97 @@ public:
       }
     }
 
-    if (schedulerThread_.joinable()) {
-      if (schedulerThread_.get_id() == std::this_thread::get_id()) {
-        schedulerThread_.detach();
-      } else {
-        schedulerThread_.join();
-      }
-    }
-
     workers_.clear();
   }
 
   /// <summary>
   /// Taskをキューに追加する
+  /// 依存taskが未完了なら完了時に自動でスケジュールされる。依存taskが
+  /// 失敗・キャンセルされた場合、このtaskは実行されずCancelledになる。
   /// </summary>
   auto SubmitTask(SharedPtr<IBackgroundTask> task) -> TaskId {
-    std::lock_guard<std::mutex> lock(queueMutex_);
-
-    if (pendingTasks_.size() >= config_.maxPendingTasks) {
+    if (pendingCount_.load() >= config_.maxPendingTasks) {
       throw std::runtime_error("Task queue is full");
     }
 
     TaskId id = task->GetTaskId();
     task->InitializeSnapshot();
+    const TaskOptions options = task->GetOptions();
+
+    TaskNode *node = nullptr;
+    // 依存先は再submitで退避・回収されうるので、登録が終わるまで所有しておく
+    std::vector<std::shared_ptr<TaskNode>> dependencies;
     {
-      std::lock_guard<std::mutex> snapshotLock(snapshotsMutex_);
-      snapshots_[id] = task->GetSnapshot();
+      std::unique_lock<std::shared_mutex> lock(nodesMutex_);
+      auto &slot = nodes_[id];
+      if (!slot) {
+        slot = std::make_shared<TaskNode>();
+      } else if (slot->submitted) {
+        if (!IsTerminal(slot->state.load(std::memory_order_acquire))) {
+          throw std::runtime_error("Task already submitted");
+        }
+        // 再submit。古いnodeは他スレッドが参照している可能性があるので
+        // 退避しておき、手放された過去の退避分はここで回収する
+        ReclaimRetiredNodesLocked();
+        retiredNodes_.push_back(std::move(slot));
+        slot = std::make_shared<TaskNode>();
+      }
+      node = slot.get();
+      node->id = id;
+      node->task = std::move(task);
+      node->category = options.taskCategory;
+      node->priority = options.priority;
+      node->name = options.name;
+      node->submitted = true;
+
+      if (config_.enableDependencyResolution) {
+        for (const TaskId dependency : options.dependencies) {
+          if (dependency == id) {
+            continue;
+          }
+          // まだsubmitされていない依存先は受け皿のnodeを先に作っておく
+          auto &dependencySlot = nodes_[dependency];
+          if (!dependencySlot) {
+            dependencySlot = std::make_shared<TaskNode>();
+            dependencySlot->id = dependency;
+          }
+          dependencies.push_back(dependencySlot);
+        }
+      }
     }
-    pendingTasks_.push_back(std::move(task));
+    pendingCount_.fetch_add(1);
 
-    // EventBusに通知
-    TaskStateChangedEvent event{.taskId = id,
-                                .oldState = TaskState::Pending,
-                                .newState = TaskState::Pending,
-                                .snapshot = {}};
-    // if (eventBus_) {
-    //     eventBus_->Publish(event);
-    // } // EventBus module missing
+    PublishStateChange(*node, TaskState::Pending);
 
-    queueCV_.notify_one();
+    // remainingDependencies は1から始まり、登録が終わるまでtaskが走り出さない
+    for (const auto &dependency : dependencies) {
+      {
+        std::lock_guard<std::mutex> edgeLock(dependency->edgeMutex);
+        if (!dependency->finished) {
+          dependency->successors.push_back(node);
+          node->remainingDependencies.fetch_add(1);
+          continue;
+        }
+      }
+      if (dependency->state.load(std::memory_order_acquire) !=
+          TaskState::Completed) {
+        node->dependencyFailed.store(true);
+      }
+    }
+    if (ReleaseDependency(*node)) {
+      FinishTask(*node, TaskState::Cancelled, DependencyError());
+    }
     return id;
   }
 
   /// <summary>
   /// Taskをキャンセルする
+  /// キュー内・依存待ちのtaskは実行されずにCancelledになる。
   /// </summary>
   void CancelTask(TaskId taskId) {
-    std::lock_guard<std::mutex> lock(cancelMutex_);
-
-    if (auto it = cancelTokens_.find(taskId); it != cancelTokens_.end()) {
-      it->second.RequestCancel();
+    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
+    if (auto it = nodes_.find(taskId); it != nodes_.end()) {
+      it->second->cancelToken.RequestCancel();
     }
   }
 
@@ -184,12 +235,11 @@ public:
   /// 特定カテゴリのtaskをすべてキャンセルする
   /// </summary>
   void CancelTasksByCategory(TaskCategory category) {
-    std::lock_guard<std::mutex> lock(cancelMutex_);
-
-    for (auto &[id, token] : cancelTokens_) {
-      auto snapshot = GetTaskSnapshot(id);
-      if (snapshot.category == category) {
-        token.RequestCancel();
+    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
+    for (auto &[id, node] : nodes_) {
+      if (node->submitted && node->category == category &&
+          !IsTerminal(node->state.load(std::memory_order_acquire))) {
+        node->cancelToken.RequestCancel();
       }
     }
   }
@@ -198,9 +248,12 @@ public:
   /// 特定のtaskのスナップショットを取得する
   /// </summary>
   auto GetTaskSnapshot(TaskId taskId) const -> TaskSnapshot {
-    std::lock_guard<std::mutex> lock(snapshotsMutex_);
-    if (auto it = snapshots_.find(taskId); it != snapshots_.end()) {
-      return it->second;
+    // submitted / name などは SubmitTask が排他ロック下で書くので、
+    // 読み出しもロックを保持したまま行う
+    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
+    if (auto it = nodes_.find(taskId);
+        it != nodes_.end() && it->second->submitted) {
+      return BuildSnapshot(*it->second);
     }
     return TaskSnapshot{};
   }
@@ -209,11 +262,13 @@ public:
   /// すべてのtaskのスナップショットを取得する
   /// </summary>
   auto GetAllSnapshots() const -> std::vector<TaskSnapshot> {
-    std::lock_guard<std::mutex> lock(snapshotsMutex_);
+    std::shared_lock<std::shared_mutex> lock(nodesMutex_);
     NamedVector<TaskSnapshot> result;
-    result.reserve(snapshots_.size());
-    for (const auto &[id, snapshot] : snapshots_) {
-      result.push_back(snapshot);
+    result.reserve(nodes_.size());
+    for (const auto &[id, node] : nodes_) {
+      if (node->submitted) {
+        result.add(BuildSnapshot(*node));
+      }
     }
     return result.toStdVector();
   }
@@ -228,286 +283,373 @@ public:
   /// <summary>
   /// 実行中のtask数を取得する
   /// </summary>
-  auto GetRunningCount() const -> int {
-    std::lock_guard<std::mutex> lock(snapshotsMutex_);
-    int count = 0;
-    for (const auto &[id, snapshot] : snapshots_) {
-      if (snapshot.state == TaskState::Running) {
-        ++count;
-      }
-    }
-    return count;
-  }
+  auto GetRunningCount() const -> int { return runningCount_.load(); }
 
   /// <summary>
-  /// キュー待ちのtask数を取得する
+  /// キュー待ちのtask数を取得する（依存待ちを含む）
   /// </summary>
-  auto GetPendingCount() const -> int {
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    return static_cast<int>(pendingTasks_.size());
-  }
+  auto GetPendingCount() const -> int { return pendingCount_.load(); }
 
   /// <summary>
   /// キューをクリアする（実行中はキャンセル）
   /// </summary>
   void ClearQueue() {
-    std::lock_guard<std::mutex> lock(queueMutex_);
-    for (auto &task : pendingTasks_) {
-      CancelTask(task->GetTaskId());
+    {
+      std::shared_lock<std::shared_mutex> lock(nodesMutex_);
+      for (auto &[id, node] : nodes_) {
+        if (node->submitted &&
+            !IsTerminal(node->state.load(std::memory_order_acquire))) {
+          node->cancelToken.RequestCancel();
+        }
+      }
+    }
+
+    // レーンに積まれている分はここで確定させる。依存待ちの分は
+    // 依存先の完了時にキャンセル済みとして確定する。
+    for (auto &queue : queues_) {
+      std::vector<TaskNode *> drained;
+      {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        for (std::size_t lane = 0; lane < kLaneCount; ++lane) {
+          for (TaskNode *node : queue->lanes[lane]) {
+            drained.push_back(node);
+          }
+          laneCounts_[lane].fetch_sub(
+              static_cast<int>(queue->lanes[lane].size()));
+          readyCount_.fetch_sub(static_cast<int>(queue->lanes[lane].size()));
+          queue->lanes[lane].clear();
+        }
+      }
+      for (TaskNode *node : drained) {
+        pendingCount_.fetch_sub(1);
+        FinishTask(*node, TaskState::Cancelled, TaskError::None());
+      }
     }
-    pendingTasks_.clear();
   }
 
 private:
-  struct PrioritizedTask {
-    TaskPriority priority;
+  static constexpr std::size_t kLaneCount =
+      static_cast<std::size_t>(TaskPriority::Idle) + 1;
+
+  /// <summary>
+  /// Taskごとの実行状態と依存グラフの節点
+  /// submit前に依存先として参照されたtaskは task が空の受け皿になる。
+  /// </summary>
+  struct TaskNode {
+    TaskId id = TaskId::Invalid();
     SharedPtr<IBackgroundTask> task;
+    TaskCategory category = TaskCategory::Custom;
+    TaskPriority priority = TaskPriority::Normal;
+    QString name;
+    bool submitted = false;
+    CancelToken cancelToken;
 
-    auto operator<(const PrioritizedTask &other) const -> bool {
-      return priority > other.priority; // 値が小さいほど高優先度
-    }
+    // 公開される状態。state を release で書く前に時刻とエラーを書く。
+    std::atomic<TaskState> state{TaskState::Pending};
+    std::atomic<std::shared_ptr<const TaskProgress>> progress;
+    std::chrono::steady_clock::time_point startTime{};
+    std::chrono::steady_clock::time_point endTime{};
+    TaskError error;
+
+    // 依存グラフ
+    std::atomic<int> remainingDependencies{1};
+    std::atomic<bool> dependencyFailed{false};
+    std::mutex edgeMutex;
+    bool finished = false;
+    std::vector<TaskNode *> successors;
+    // FinishTask がこのnodeに触れ終えたら立つ。退避nodeの回収条件。
+    std::atomic<bool> released{false};
   };
 
   /// <summary>
-  /// Worker threadのメインループ
+  /// Workerごとのキュー。優先度ごとにレーンを分ける。
+  /// 持ち主は先頭から、他のworkerは末尾から取る。
   /// </summary>
-  void WorkerLoop(int workerId) {
-    while (running_.load()) {
-      SharedPtr<IBackgroundTask> task;
+  struct alignas(64) WorkerQueue {
+    std::mutex mutex;
+    std::array<std::deque<TaskNode *>, kLaneCount> lanes;
+  };
 
-      // Taskを取得
-      {
-        std::unique_lock<std::mutex> lock(queueMutex_);
-        queueCV_.wait(lock, [this] {
-          return !pendingTasks_.empty() || !running_.load();
-        });
+  static auto IsTerminal(TaskState state) -> bool {
+    return state == TaskState::Completed || state == TaskState::Cancelled ||
+           state == TaskState::Failed;
+  }
 
-        if (!running_.load()) {
-          return;
-        }
+  static auto LaneOf(TaskPriority priority) -> std::size_t {
+    const auto lane = static_cast<std::size_t>(priority);
+    return lane < kLaneCount ? lane : kLaneCount - 1;
+  }
 
-        // 優先度でソートして最も高いものを取り出す
-        std::sort(pendingTasks_.begin(), pendingTasks_.end(),
-                  [](const auto &a, const auto &b) {
-                    return a->GetOptions().priority < b->GetOptions().priority;
-                  });
+  /// <summary>
+  /// 退避したnodeのうち、FinishTaskが手放し他に所有者がいないものを解放する
+  /// nodesMutex_ を排他で保持して呼ぶこと。
+  /// </summary>
+  void ReclaimRetiredNodesLocked() {
+    std::erase_if(retiredNodes_, [](const std::shared_ptr<TaskNode> &node) {
+      return node->released.load(std::memory_order_acquire) &&
+             node.use_count() == 1;
+    });
+  }
 
-        task = std::move(pendingTasks_.front());
-        pendingTasks_.pop_front();
-      }
+  static auto BuildSnapshot(const TaskNode &node) -> TaskSnapshot {
+    const TaskState state = node.state.load(std::memory_order_acquire);
+    TaskSnapshot snapshot{.id = node.id,
+                          .state = state,
+                          .category = node.category,
+                          .priority = node.priority,
+                          .progress = {},
+                          .error = TaskError::None(),
+                          .name = node.name,
+                          .startTime = {},
+                          .endTime = {}};
+    if (const auto progress = node.progress.load(std::memory_order_acquire)) {
+      snapshot.progress = *progress;
+    }
+    if (state == TaskState::Running || IsTerminal(state)) {
+      snapshot.startTime = node.startTime;
+    }
+    if (IsTerminal(state)) {
+      snapshot.endTime = node.endTime;
+      snapshot.error = node.error;
+    }
+    return snapshot;
+  }
 
-      if (!task) {
-        continue;
-      }
+  void PublishStateChange(const TaskNode &node, TaskState oldState) {
+    // TaskStateChangedEvent / TaskCompletedEvent / TaskFailedEvent は
+    // BuildSnapshot(node) から組み立てる。
+    // if (eventBus_) {
+    //     eventBus_->Publish(TaskStateChangedEvent{...});
+    // } // EventBus module missing
+  }
 
-      if (config_.enableDependencyResolution && !DependenciesCompleted(task)) {
-        {
-          std::lock_guard<std::mutex> lock(queueMutex_);
-          pendingTasks_.push_back(std::move(task));
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(2));
-        continue;
-      }
+  static auto DependencyError() -> TaskError {
+    return TaskError::FromException(
+        QStringLiteral("Dependency failed or was cancelled"), "dependency");
+  }
+
+  /// <summary>
+  /// 依存を1つ解消する。最後の1つならtaskをスケジュールする。
+  /// 依存先が失敗していた場合は true を返し、呼び出し側がCancelledで確定させる。
+  /// </summary>
+  auto ReleaseDependency(TaskNode &node) -> bool {
+    if (node.remainingDependencies.fetch_sub(1, std::memory_order_acq_rel) !=
+        1) {
+      return false;
+    }
+    if (node.dependencyFailed.load()) {
+      pendingCount_.fetch_sub(1);
+      return true;
+    }
+    Schedule(node);
+    return false;
+  }
 
-      // Taskを実行
-      ExecuteTask(task, workerId);
+  /// <summary>
+  /// 実行可能になったtaskをworkerのレーンに積む
+  /// worker上から呼ばれた場合（後続taskなど）は自分のキューに積む。
+  /// </summary>
+  void Schedule(TaskNode &node) {
+    node.state.store(TaskState::Scheduled, std::memory_order_release);
+    PublishStateChange(node, TaskState::Pending);
+
+    const std::size_t workerCount = queues_.size();
+    const std::size_t target =
+        tCurrentPool_ == this
+            ? static_cast<std::size_t>(tWorkerIndex_)
+            : submitCursor_.fetch_add(1, std::memory_order_relaxed) %
+                  workerCount;
+    const std::size_t lane = LaneOf(node.priority);
+    {
+      std::lock_guard<std::mutex> lock(queues_[target]->mutex);
+      queues_[target]->lanes[lane].push_back(&node);
+      laneCounts_[lane].fetch_add(1);
+    }
+    readyCount_.fetch_add(1);
+    if (sleepers_.load() > 0) {
+      std::lock_guard<std::mutex> lock(idleMutex_);
+      idleCV_.notify_one();
     }
   }
 
-  bool DependenciesCompleted(const SharedPtr<IBackgroundTask>& task) const {
-    for (const TaskId dependency : task->GetOptions().dependencies) {
-      const auto snapshot = GetTaskSnapshot(dependency);
-      if (snapshot.state == TaskState::Failed ||
-          snapshot.state == TaskState::Cancelled) {
-        return false;
+  /// <summary>
+  /// 高い優先度のレーンから順に、自分のキュー→他workerの順で探す
+  /// </summary>
+  auto FindWork(int workerId) -> TaskNode * {
+    const std::size_t workerCount = queues_.size();
+    for (std::size_t lane = 0; lane < kLaneCount; ++lane) {
+      if (laneCounts_[lane].load(std::memory_order_relaxed) <= 0) {
+        continue;
       }
-      if (snapshot.state != TaskState::Completed) {
-        return false;
+      for (std::size_t k = 0; k < workerCount; ++k) {
+        const std::size_t victim =
+            (static_cast<std::size_t>(workerId) + k) % workerCount;
+        WorkerQueue &queue = *queues_[victim];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        auto &deque = queue.lanes[lane];
+        if (deque.empty()) {
+          continue;
+        }
+        TaskNode *node = nullptr;
+        if (k == 0) {
+          node = deque.front();
+          deque.pop_front();
+        } else {
+          node = deque.back();
+          deque.pop_back();
+        }
+        laneCounts_[lane].fetch_sub(1);
+        readyCount_.fetch_sub(1);
+        return node;
       }
     }
-    return true;
+    return nullptr;
   }
 
   /// <summary>
-  /// Scheduler threadのメインループ（依存関係の解決）
+  /// Worker threadのメインループ
   /// </summary>
-  void SchedulerLoop() {
-    while (running_.load()) {
-      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  void WorkerLoop(int workerId) {
+    tCurrentPool_ = this;
+    tWorkerIndex_ = workerId;
 
-      if (config_.enableDependencyResolution) {
-        ResolveDependencies();
+    while (running_.load()) {
+      if (TaskNode *node = FindWork(workerId)) {
+        ExecuteTask(*node, workerId);
+        continue;
       }
+
+      std::unique_lock<std::mutex> lock(idleMutex_);
+      sleepers_.fetch_add(1);
+      idleCV_.wait(lock, [this] {
+        return readyCount_.load() > 0 || !running_.load();
+      });
+      sleepers_.fetch_sub(1);
     }
+
+    tCurrentPool_ = nullptr;
   }
 
   /// <summary>
   /// Taskを実行する
   /// </summary>
-  void ExecuteTask(SharedPtr<IBackgroundTask> task, int workerId) {
-    TaskId taskId = task->GetTaskId();
-    TaskState oldState = TaskState::Scheduled;
-    TaskState newState = TaskState::Running;
+  void ExecuteTask(TaskNode &node, int workerId) {
+    pendingCount_.fetch_sub(1);
 
-    // CancelTokenを登録
-    CancelToken cancelToken;
-    {
-      std::lock_guard<std::mutex> lock(cancelMutex_);
-      cancelTokens_.emplace(taskId, std::move(cancelToken));
+    if (node.cancelToken.IsCancelled()) {
+      FinishTask(node, TaskState::Cancelled, TaskError::None());
+      return;
     }
 
-    // Snapshot更新
-    TaskSnapshot snapshot{.id = taskId,
-                          .state = TaskState::Running,
-                          .category = task->GetOptions().taskCategory,
-                          .priority = task->GetOptions().priority,
-                          .progress = {},
-                          .error = TaskError::None(),
-                          .name = task->GetOptions().name,
-                          .startTime = std::chrono::steady_clock::now(),
-                          .endTime = {}};
+    node.startTime = std::chrono::steady_clock::now();
+    node.state.store(TaskState::Running, std::memory_order_release);
+    runningCount_.fetch_add(1);
+    PublishStateChange(node, TaskState::Scheduled);
 
-    {
-      std::lock_guard<std::mutex> lock(snapshotsMutex_);
-      snapshots_[taskId] = snapshot;
-    }
-
-    // EventBusに通知
-    TaskStateChangedEvent stateEvent{.taskId = taskId,
-                                     .oldState = oldState,
-                                     .newState = newState,
-                                     .snapshot = snapshot};
-    // if (eventBus_) {
-    //     eventBus_->Publish(stateEvent);
-    // }
+    TaskState finalState = TaskState::Completed;
+    TaskError error = TaskError::None();
 
     // Task実行
     try {
-      auto reportProgress = [this, taskId](TaskProgress progress) {
-        TaskProgressEvent event{.taskId = taskId, .progress = progress};
+      TaskNode *target = &node;
+      auto reportProgress = [target](TaskProgress progress) {
+        target->progress.store(
+            std::make_shared<const TaskProgress>(std::move(progress)),
+            std::memory_order_release);
         // if (eventBus_) {
-        //     eventBus_->Publish(event);
+        //     eventBus_->Publish(TaskProgressEvent{...});
         // }
-
-        std::lock_guard<std::mutex> lock(snapshotsMutex_);
-        if (auto it = snapshots_.find(taskId); it != snapshots_.end()) {
-          it->second.progress = progress;
-        }
       };
 
-      if (cancelToken.IsCancelled()) {
-        throw std::runtime_error("Task cancelled");
-      }
-      task->Execute(cancelToken, reportProgress);
-
-      // 完了
-      newState = TaskState::Completed;
-      snapshot.state = TaskState::Completed;
-      snapshot.endTime = std::chrono::steady_clock::now();
-
-      {
-        std::lock_guard<std::mutex> lock(snapshotsMutex_);
-        snapshots_[taskId] = snapshot;
-      }
-
-      TaskCompletedEvent completedEvent{.taskId = taskId, .snapshot = snapshot};
-      // if (eventBus_) {
-      //     eventBus_->Publish(completedEvent);
-      // }
-
+      node.task->Execute(node.cancelToken, reportProgress);
     } catch (const std::exception &e) {
       // キャンセルによる例外
-      if (cancelToken.IsCancelled()) {
-        newState = TaskState::Cancelled;
-        snapshot.state = TaskState::Cancelled;
-        } else {
+      if (node.cancelToken.IsCancelled()) {
+        finalState = TaskState::Cancelled;
+      } else {
         // その他のエラー
-        newState = TaskState::Failed;
-        snapshot.state = TaskState::Failed;
-        snapshot.error = TaskError::FromException(
-            QString::fromUtf8(e.what()), "runtime");
-      }
-
-      snapshot.endTime = std::chrono::steady_clock::now();
-
-      {
-        std::lock_guard<std::mutex> lock(snapshotsMutex_);
-        snapshots_[taskId] = snapshot;
-      }
-
-      if (snapshot.state == TaskState::Failed) {
-        TaskFailedEvent failedEvent{
-            .taskId = taskId, .error = snapshot.error, .snapshot = snapshot};
-        // if (eventBus_) {
-        //     eventBus_->Publish(failedEvent);
-        // }
+        finalState = TaskState::Failed;
+        error = TaskError::FromException(QString::fromUtf8(e.what()),
+                                         "runtime");
       }
+    } catch (...) {
+      finalState = TaskState::Failed;
+      error = TaskError::FromException(QStringLiteral("Unknown exception"),
+                                       "runtime");
     }
 
-    // 状態変更イベント
-    TaskStateChangedEvent finalStateEvent{.taskId = taskId,
-                                          .oldState = oldState,
-                                          .newState = newState,
-                                          .snapshot = snapshot};
-    // if (eventBus_) {
-    //     eventBus_->Publish(finalStateEvent);
-    // }
-
-    // CancelTokenを削除
-    {
-      std::lock_guard<std::mutex> lock(cancelMutex_);
-      cancelTokens_.erase(taskId);
-    }
+    runningCount_.fetch_sub(1);
+    FinishTask(node, finalState, std::move(error));
   }
 
   /// <summary>
-  /// 依存関係を解決する
+  /// Taskを終了状態にし、後続taskの依存を解消する
+  /// 失敗の連鎖で後続がキャンセルされる場合も再帰せずに処理する。
   /// </summary>
-  void ResolveDependencies() {
-    std::lock_guard<std::mutex> lock(queueMutex_);
-
-    for (auto it = pendingTasks_.begin(); it != pendingTasks_.end();) {
-      const auto &task = *it;
-      const auto &deps = task->GetOptions().dependencies;
-
-      // すべての依存taskが完了しているか確認
-      bool allDepsCompleted = true;
-      for (TaskId depId : deps) {
-        auto depSnapshot = GetTaskSnapshot(depId);
-        if (depSnapshot.state != TaskState::Completed) {
-          allDepsCompleted = false;
-          break;
+  void FinishTask(TaskNode &first, TaskState firstState, TaskError firstError) {
+    std::vector<TaskNode *> cancelled;
+    TaskNode *node = &first;
+    TaskState finalState = firstState;
+    TaskError error = std::move(firstError);
+
+    while (true) {
+      const TaskState oldState = node->state.load(std::memory_order_relaxed);
+      node->endTime = std::chrono::steady_clock::now();
+      node->error = std::move(error);
+      node->state.store(finalState, std::memory_order_release);
+      node->task = SharedPtr<IBackgroundTask>();
+      PublishStateChange(*node, oldState);
+
+      std::vector<TaskNode *> successors;
+      {
+        std::lock_guard<std::mutex> lock(node->edgeMutex);
+        node->finished = true;
+        successors.swap(node->successors);
+      }
+      for (TaskNode *successor : successors) {
+        if (finalState != TaskState::Completed) {
+          successor->dependencyFailed.store(true);
+        }
+        if (ReleaseDependency(*successor)) {
+          cancelled.push_back(successor);
         }
       }
+      node->released.store(true, std::memory_order_release);
 
-      if (allDepsCompleted) {
-        // 依存関係満たされた、実行可能
-        ++it;
-      } else {
-        // まだ依存関係が満たされていない、キューの後ろに移動
-        auto task = std::move(*it);
-        it = pendingTasks_.erase(it);
-        pendingTasks_.push_back(std::move(task));
+      if (cancelled.empty()) {
+        return;
       }
+      node = cancelled.back();
+      cancelled.pop_back();
+      finalState = TaskState::Cancelled;
+      error = DependencyError();
     }
   }
 
+  static inline thread_local BackgroundTaskWorkerPool *tCurrentPool_ = nullptr;
+  static inline thread_local int tWorkerIndex_ = 0;
+
   Config config_;
   std::atomic<bool> running_;
   std::mutex lifecycleMutex_;
 
   std::vector<std::thread> workers_;
-  std::thread schedulerThread_;
 
-  std::deque<SharedPtr<IBackgroundTask>> pendingTasks_;
-  mutable std::mutex queueMutex_;
-  std::condition_variable queueCV_;
+  std::vector<std::unique_ptr<WorkerQueue>> queues_;
+  std::array<std::atomic<int>, kLaneCount> laneCounts_{};
+  std::atomic<int> readyCount_{0};
+  std::atomic<std::size_t> submitCursor_{0};
+
+  std::mutex idleMutex_;
+  std::condition_variable idleCV_;
+  std::atomic<int> sleepers_{0};
 
-  std::unordered_map<TaskId, CancelToken> cancelTokens_;
-  std::mutex cancelMutex_;
+  std::atomic<int> pendingCount_{0};
+  std::atomic<int> runningCount_{0};
 
-  std::unordered_map<TaskId, TaskSnapshot> snapshots_;
-  mutable std::mutex snapshotsMutex_;
+  std::unordered_map<TaskId, std::shared_ptr<TaskNode>> nodes_;
+  std::vector<std::shared_ptr<TaskNode>> retiredNodes_;
+  mutable std::shared_mutex nodesMutex_;
 
   // SharedPtr<EventBus> eventBus_; // EventBus module missing
 };
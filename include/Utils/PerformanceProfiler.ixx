@@ -555,8 +555,19 @@ export struct AudioCallbackStats {
     int lastRequestedFrames = 0;
 };
 
+/// Per-bus DSP time reported by the mixer graph executor
+export struct AudioBusDspStats {
+    std::uint64_t busKey = 0;     ///< Caller-defined bus identity (AudioMixer uses the bus address)
+    double avgUs  = 0.0;          ///< Average process time per block (µs)
+    double maxUs  = 0.0;          ///< Peak process time per block (µs)
+    double lastUs = 0.0;          ///< Most recent block (µs)
+    std::int64_t blocks = 0;
+};
+
 export class AudioEngineProfiler {
 public:
+    static constexpr std::size_t kMaxBusSlots = 256;
+
     static AudioEngineProfiler& instance() {
         static AudioEngineProfiler inst;
         return inst;
@@ -598,6 +609,40 @@ public:
         bufferLevelPct_.store(v, std::memory_order_relaxed);
     }
 
+    // Lock-free: safe from mixer worker threads. Buses hash into a fixed
+    // table; when the probe window is full the home slot is taken over, so
+    // stale buses are recycled without allocation.
+    void recordBusProcess(std::uint64_t busKey, std::int64_t durationNs) {
+        if (busKey == 0) return;
+        BusSlot& slot = busSlotFor(busKey);
+        slot.count.fetch_add(1, std::memory_order_relaxed);
+        slot.sumNs.fetch_add(durationNs, std::memory_order_relaxed);
+        slot.lastNs.store(durationNs, std::memory_order_relaxed);
+        std::int64_t prevMax = slot.maxNs.load(std::memory_order_relaxed);
+        while (durationNs > prevMax) {
+            if (slot.maxNs.compare_exchange_weak(prevMax, durationNs,
+                    std::memory_order_relaxed)) break;
+        }
+    }
+
+    std::vector<AudioBusDspStats> busSnapshot() const {
+        std::vector<AudioBusDspStats> result;
+        for (const auto& slot : busSlots_) {
+            const std::uint64_t key = slot.key.load(std::memory_order_acquire);
+            const std::int64_t count = slot.count.load(std::memory_order_relaxed);
+            if (key == 0 || count <= 0) continue;
+            AudioBusDspStats stats;
+            stats.busKey = key;
+            stats.blocks = count;
+            stats.avgUs = static_cast<double>(slot.sumNs.load(std::memory_order_relaxed)) /
+                static_cast<double>(count) / 1000.0;
+            stats.maxUs = static_cast<double>(slot.maxNs.load(std::memory_order_relaxed)) / 1000.0;
+            stats.lastUs = static_cast<double>(slot.lastNs.load(std::memory_order_relaxed)) / 1000.0;
+            result.push_back(stats);
+        }
+        return result;
+    }
+
     AudioCallbackStats snapshot() const {
         AudioCallbackStats s;
         s.totalCallbacks  = callbackCount_.load(std::memory_order_relaxed);
@@ -634,9 +679,49 @@ public:
         fillMaxNs_      = 0;
         underflowCount_ = 0;
         bufferLevelPct_ = 0;
+        for (auto& slot : busSlots_) {
+            slot.key = 0;
+            slot.reset();
+        }
     }
 
 private:
+    struct alignas(64) BusSlot {
+        std::atomic<std::uint64_t> key{0};
+        std::atomic<std::int64_t> count{0};
+        std::atomic<std::int64_t> sumNs{0};
+        std::atomic<std::int64_t> maxNs{0};
+        std::atomic<std::int64_t> lastNs{0};
+
+        void reset() {
+            count.store(0, std::memory_order_relaxed);
+            sumNs.store(0, std::memory_order_relaxed);
+            maxNs.store(0, std::memory_order_relaxed);
+            lastNs.store(0, std::memory_order_relaxed);
+        }
+    };
+
+    BusSlot& busSlotFor(std::uint64_t busKey) {
+        constexpr std::size_t kProbe = 8;
+        std::uint64_t h = busKey * 0x9e3779b97f4a7c15ull;
+        const std::size_t home = static_cast<std::size_t>(h >> 32) % kMaxBusSlots;
+        for (std::size_t i = 0; i < kProbe; ++i) {
+            BusSlot& slot = busSlots_[(home + i) % kMaxBusSlots];
+            std::uint64_t current = slot.key.load(std::memory_order_acquire);
+            if (current == busKey) return slot;
+            if (current == 0 &&
+                (slot.key.compare_exchange_strong(current, busKey, std::memory_order_acq_rel) ||
+                 current == busKey)) {
+                return slot;
+            }
+        }
+        BusSlot& slot = busSlots_[home];
+        if (slot.key.exchange(busKey, std::memory_order_acq_rel) != busKey) {
+            slot.reset();
+        }
+        return slot;
+    }
+
     std::atomic<std::int64_t> callbackCount_{0};
     std::atomic<std::int64_t> callbackSumNs_{0};
     std::atomic<std::int64_t> callbackMaxNs_{0};
@@ -647,6 +732,7 @@ private:
     std::atomic<int>          bufferLevelPct_{0};
     std::atomic<int>          lastCallbackFrames_{0};
     std::atomic<int>          lastRequestedFrames_{0};
+    BusSlot                   busSlots_[kMaxBusSlots];
 };
 
 } // namespace ArtifactCore
@@ -37,6 +37,7 @@ module;
 module Analyze.Histgram;
 
 import Container.NamedVector;
+import Core.Parallel;
 
 namespace ArtifactCore {
 
@@ -53,41 +54,53 @@ void Histogram::Impl::calculate(const cv::Mat& image) {
         return;
     }
 
-    // Calculate histogram for each channel. Values are normalized to the
-    // public 256-bin range for all supported scalar image depths.
-    for (int ch = 0; ch < channels; ++ch) {
-        NamedVector<int> hist;
-        hist.resize(histSize_);
-        for (int y = 0; y < image.rows; ++y) {
-            for (int x = 0; x < image.cols; ++x) {
-                const int index = x * channels + ch;
-                int value = 0;
-                switch (image.depth()) {
-                case CV_8U:
-                    value = image.ptr<uchar>(y)[index];
-                    break;
-                case CV_16U:
-                    value = static_cast<int>(image.ptr<unsigned short>(y)[index] >> 8);
-                    break;
-                case CV_32F: {
-                    const float sample = image.ptr<float>(y)[index];
-                    value = static_cast<int>(std::lround(
-                        std::clamp(sample, 0.0f, 1.0f) * 255.0f));
-                    break;
-                }
-                case CV_64F: {
-                    const double sample = image.ptr<double>(y)[index];
-                    value = static_cast<int>(std::lround(
-                        std::clamp(sample, 0.0, 1.0) * 255.0));
-                    break;
-                }
-                default:
-                    break;
+    // Calculate histogram for every channel in one pass over row blocks.
+    // Values are normalized to the public 256-bin range for all supported
+    // scalar image depths.
+    const int depth = image.depth();
+    const int binCount = histSize_;
+    auto binOf = [depth](const cv::Mat& mat, int y, int index) {
+        switch (depth) {
+        case CV_8U:
+            return static_cast<int>(mat.ptr<uchar>(y)[index]);
+        case CV_16U:
+            return static_cast<int>(mat.ptr<unsigned short>(y)[index] >> 8);
+        case CV_32F: {
+            const float sample = mat.ptr<float>(y)[index];
+            return static_cast<int>(std::lround(std::clamp(sample, 0.0f, 1.0f) * 255.0f));
+        }
+        case CV_64F: {
+            const double sample = mat.ptr<double>(y)[index];
+            return static_cast<int>(std::lround(std::clamp(sample, 0.0, 1.0) * 255.0));
+        }
+        default:
+            return 0;
+        }
+    };
+
+    constexpr int kPixelsPerChunk = 16384;
+    const int rowsPerChunk = std::max(1, kPixelsPerChunk / std::max(1, image.cols));
+    std::vector<int> counts = Parallel::Reduce(0, image.rows, rowsPerChunk,
+        std::vector<int>(static_cast<size_t>(channels * binCount), 0),
+        [&](ParallelRange rows, std::vector<int> local) {
+            for (int y = rows.begin; y < rows.end; ++y) {
+                for (int x = 0; x < image.cols; ++x) {
+                    for (int ch = 0; ch < channels; ++ch) {
+                        const int value = binOf(image, y, x * channels + ch);
+                        ++local[static_cast<size_t>(ch * binCount + value)];
+                    }
                 }
-                ++hist[value];
             }
-        }
-        bins_[ch] = hist.toStdVector();
+            return local;
+        },
+        [](std::vector<int> lhs, const std::vector<int>& rhs) {
+            for (size_t i = 0; i < lhs.size(); ++i) lhs[i] += rhs[i];
+            return lhs;
+        });
+
+    for (int ch = 0; ch < channels; ++ch) {
+        const auto first = counts.begin() + static_cast<std::ptrdiff_t>(ch * binCount);
+        std::copy(first, first + binCount, bins_[ch].begin());
     }
 }
 
@@ -37,6 +37,8 @@ module;
 #include <random>
 module Analyze.Histogram;
 
+import Core.Parallel;
+
 namespace ArtifactCore {
 
 namespace {
@@ -53,6 +55,33 @@ struct RGBAccum {
     double b = 0.0;
 };
 
+constexpr int kAnalyzePixelsPerChunk = 16384;
+
+ChannelAccum combineChannelAccum(ChannelAccum lhs, const ChannelAccum& rhs) {
+    for (int i = 0; i < 256; ++i) {
+        lhs.histogram[i] += rhs.histogram[i];
+    }
+    lhs.min = std::min(lhs.min, rhs.min);
+    lhs.max = std::max(lhs.max, rhs.max);
+    return lhs;
+}
+
+template<typename Sample>
+ChannelAccum accumulateChannel(int total, Sample&& sample) {
+    return Parallel::Reduce(0, total, kAnalyzePixelsPerChunk, ChannelAccum{},
+        [&](ParallelRange range, ChannelAccum accum) {
+            for (int i = range.begin; i < range.end; ++i) {
+                const float val = std::clamp(sample(i), 0.0f, 1.0f);
+                accum.min = std::min(accum.min, val);
+                accum.max = std::max(accum.max, val);
+                const int bin = std::clamp(static_cast<int>(val * 255.0f), 0, 255);
+                ++accum.histogram[bin];
+            }
+            return accum;
+        },
+        combineChannelAccum);
+}
+
 }
 
 // ============================================================
@@ -117,14 +146,9 @@ ChannelStatistics ImageAnalyzer::analyzeChannel(const float* pixels, int width,
     stats.min = 1.0f;
     stats.max = 0.0f;
 
-    ChannelAccum accumulated{};
-    for (int i = 0; i < total; ++i) {
-        float val = std::clamp(pixels[i * 4 + channel], 0.0f, 1.0f);
-        accumulated.min = std::min(accumulated.min, val);
-        accumulated.max = std::max(accumulated.max, val);
-        int bin = std::clamp(static_cast<int>(val * 255.0f), 0, 255);
-        ++accumulated.histogram[bin];
-    }
+    const ChannelAccum accumulated = accumulateChannel(total, [&](int i) {
+        return pixels[i * 4 + channel];
+    });
     stats.min = accumulated.min;
     stats.max = accumulated.max;
     std::copy(accumulated.histogram, accumulated.histogram + 256, stats.rawHistogram);
@@ -140,17 +164,12 @@ ChannelStatistics ImageAnalyzer::analyzeLuminance(const float* pixels, int width
     stats.min = 1.0f;
     stats.max = 0.0f;
 
-    ChannelAccum accumulated{};
-    for (int i = 0; i < total; ++i) {
-        int idx = i * 4;
-        float lum = std::clamp(0.2126f * pixels[idx + 0] +
-                               0.7152f * pixels[idx + 1] +
-                               0.0722f * pixels[idx + 2], 0.0f, 1.0f);
-        accumulated.min = std::min(accumulated.min, lum);
-        accumulated.max = std::max(accumulated.max, lum);
-        int bin = std::clamp(static_cast<int>(lum * 255.0f), 0, 255);
-        ++accumulated.histogram[bin];
-    }
+    const ChannelAccum accumulated = accumulateChannel(total, [&](int i) {
+        const int idx = i * 4;
+        return 0.2126f * pixels[idx + 0] +
+               0.7152f * pixels[idx + 1] +
+               0.0722f * pixels[idx + 2];
+    });
     stats.min = accumulated.min;
     stats.max = accumulated.max;
     std::copy(accumulated.histogram, accumulated.histogram + 256, stats.rawHistogram);
@@ -172,13 +191,14 @@ ImageStatistics ImageAnalyzer::analyze(const float* pixels, int width, int heigh
 float ImageAnalyzer::autoExposureEV(const float* pixels, int width, int height) {
     // Calculate average luminance
     const int total = width * height;
-    double sumLum = 0.0;
-    for (int i = 0; i < total; ++i) {
-        int idx = i * 4;
-        float lum = 0.2126f * pixels[idx] + 0.7152f * pixels[idx + 1] +
-                    0.0722f * pixels[idx + 2];
-        sumLum += std::log2(std::max(lum, 0.0001f));
-    }
+    const double sumLum = Parallel::TransformReduce(0, total, kAnalyzePixelsPerChunk, 0.0,
+        [](double a, double b) { return a + b; },
+        [&](int i) {
+            const int idx = i * 4;
+            const float lum = 0.2126f * pixels[idx] + 0.7152f * pixels[idx + 1] +
+                              0.0722f * pixels[idx + 2];
+            return static_cast<double>(std::log2(std::max(lum, 0.0001f)));
+        });
 
     float avgLogLum = static_cast<float>(sumLum / total);
     float avgLum = std::pow(2.0f, avgLogLum);
@@ -195,13 +215,22 @@ std::array<float, 3> ImageAnalyzer::autoWhiteBalance(const float* pixels, int wi
     // Grey World assumption:
     // Average of all pixels should be grey → compute per-channel multipliers
     const int total = width * height;
-    RGBAccum sums{};
-    for (int i = 0; i < total; ++i) {
-        int idx = i * 4;
-        sums.r += pixels[idx + 0];
-        sums.g += pixels[idx + 1];
-        sums.b += pixels[idx + 2];
-    }
+    const RGBAccum sums = Parallel::Reduce(0, total, kAnalyzePixelsPerChunk, RGBAccum{},
+        [&](ParallelRange range, RGBAccum accum) {
+            for (int i = range.begin; i < range.end; ++i) {
+                const int idx = i * 4;
+                accum.r += pixels[idx + 0];
+                accum.g += pixels[idx + 1];
+                accum.b += pixels[idx + 2];
+            }
+            return accum;
+        },
+        [](RGBAccum lhs, const RGBAccum& rhs) {
+            lhs.r += rhs.r;
+            lhs.g += rhs.g;
+            lhs.b += rhs.b;
+            return lhs;
+        });
     const double sumR = sums.r;
     const double sumG = sums.g;
     const double sumB = sums.b;
@@ -11,11 +11,14 @@ module Audio.Analyze;
 
 
 import Container.NamedVector;
+import Core.Parallel;
+import Math.ArtifactMinMax;
 
 namespace ArtifactCore {
 
 namespace {
 constexpr int kMaxFFTSize = 1 << 20;
+constexpr int kMeterSamplesPerChunk = 16384;
 
 int normalizeFFTSize(int size) {
     size = std::clamp(size, 2, kMaxFFTSize);
@@ -151,9 +154,18 @@ AudioAnalyzer::AnalysisResult AudioAnalyzer::analyze(const AudioSegment& segment
             *monoData.at(static_cast<std::size_t>(i)) = std::isfinite(mixed)
                 ? mixed
                 : std::copysign(std::numeric_limits<float>::max(), mixed);
-            sumSq += static_cast<double>(s) * s;
-            maxAbs = std::max(maxAbs, std::abs(s));
         }
+
+        // Peak は非有限値を除いた min/max から、二乗和はチャンク順に畳み込んで求める
+        const MinMaxResult range = artifactMinMax(data, availableFrames, kMeterSamplesPerChunk);
+        maxAbs = std::max({maxAbs, static_cast<float>(std::fabs(range.min)),
+                           static_cast<float>(std::fabs(range.max))});
+        sumSq += Parallel::TransformReduce(0, availableFrames, kMeterSamplesPerChunk, 0.0,
+            [](double a, double b) { return a + b; },
+            [data](int i) {
+                const float s = data[i];
+                return std::isfinite(s) ? static_cast<double>(s) * s : 0.0;
+            });
     }
 
     const double sampleCount = static_cast<double>(frames) * channels;
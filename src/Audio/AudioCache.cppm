@@ -13,6 +13,274 @@ import std;
 namespace ArtifactCore
 {
 
+// 固定容量の PCM ブロック群
+// サンプル領域は構築時に一括確保し、以降の追加・参照では確保しない。
+// key -> slot の索引は線形探索のオープンアドレス表（削除は後方シフト）で、
+// AudioCache::lock_ の書き込みロック下でのみ変更される。読み取り側は
+// 読み取りロック下で索引を引き、ブロックのピンと参照ビットだけを原子的に更新する。
+class AudioCacheSlab
+{
+public:
+    static constexpr int64_t kEmptyKey = -1;
+    static constexpr int32_t kNoSlot = -1;
+
+    struct Slot {
+        int64_t key = kEmptyKey;     // 索引に載っているフレーム番号（未使用は kEmptyKey）
+        int64_t frameNumber = kEmptyKey;
+        int frames = 0;
+        int channels = 0;
+        int sampleRate = 0;
+        AudioChannelLayout layout = AudioChannelLayout::Stereo;
+        qint64 startFrame = 0;
+        std::atomic<uint32_t> pins{0};
+        std::atomic<bool> referenced{false};
+    };
+
+    AudioCacheSlab(const AudioCacheSlabConfig& config)
+        : config_(config),
+          slots_(static_cast<size_t>(config.slotCount)),
+          samples_(static_cast<size_t>(config.slotCount) *
+                   static_cast<size_t>(config.channels) *
+                   static_cast<size_t>(config.framesPerBlock), 0.0f)
+    {
+        size_t indexSize = 16;
+        while (indexSize < static_cast<size_t>(config.slotCount) * 2) {
+            indexSize <<= 1;
+        }
+        index_.assign(indexSize, kNoSlot);
+    }
+
+    const AudioCacheSlabConfig& config() const { return config_; }
+    int slotCount() const { return config_.slotCount; }
+    int size() const { return size_; }
+    size_t sampleBytes() const { return samples_.size() * sizeof(float); }
+
+    Slot& slot(int i) { return slots_[static_cast<size_t>(i)]; }
+    const Slot& slot(int i) const { return slots_[static_cast<size_t>(i)]; }
+
+    float* channel(int i, int ch)
+    {
+        return samples_.data() + (static_cast<size_t>(i) * config_.channels + ch) *
+            static_cast<size_t>(config_.framesPerBlock);
+    }
+    const float* channel(int i, int ch) const
+    {
+        return const_cast<AudioCacheSlab*>(this)->channel(i, ch);
+    }
+
+    bool fits(const AudioSegment& pcm) const
+    {
+        return pcm.channelCount() <= config_.channels &&
+            pcm.frameCount() <= config_.framesPerBlock;
+    }
+
+    // 読み取りロック下で呼んでよい
+    int find(int64_t key) const
+    {
+        const size_t mask = index_.size() - 1;
+        for (size_t pos = hashKey(key) & mask;; pos = (pos + 1) & mask) {
+            const int32_t i = index_[pos];
+            if (i == kNoSlot) return kNoSlot;
+            if (slots_[static_cast<size_t>(i)].key == key) return i;
+        }
+    }
+
+    void pin(int i) { slots_[static_cast<size_t>(i)].pins.fetch_add(1, std::memory_order_relaxed); }
+    void unpin(int i) { slots_[static_cast<size_t>(i)].pins.fetch_sub(1, std::memory_order_release); }
+
+    // 以下は書き込みロック下でのみ呼ぶ
+
+    // CLOCK: 参照ビットを落としながら進み、未参照かつ未ピンのブロックを返す。
+    // 2 周しても見つからない（全ブロックがピン留め）場合は kNoSlot。
+    int selectVictim(uint64_t& evictions, uint64_t& pinnedSkips)
+    {
+        const int count = slotCount();
+        for (int step = 0; step < count * 2; ++step) {
+            const int i = hand_;
+            hand_ = (hand_ + 1) % count;
+            Slot& s = slots_[static_cast<size_t>(i)];
+            // 索引から外れていてもハンドルが残っていれば再利用できない
+            if (s.pins.load(std::memory_order_acquire) != 0) {
+                ++pinnedSkips;
+                continue;
+            }
+            if (s.key == kEmptyKey) return i;
+            if (s.referenced.exchange(false, std::memory_order_relaxed)) continue;
+            unlink(i);
+            ++evictions;
+            return i;
+        }
+        return kNoSlot;
+    }
+
+    void store(int i, int64_t key, const AudioSegment& pcm)
+    {
+        Slot& s = slots_[static_cast<size_t>(i)];
+        const int frames = pcm.frameCount();
+        const int channels = pcm.channelCount();
+        for (int ch = 0; ch < channels; ++ch) {
+            std::copy_n(pcm.channelData[ch].constData(), frames, channel(i, ch));
+        }
+        s.frameNumber = key;
+        s.frames = frames;
+        s.channels = channels;
+        s.sampleRate = pcm.sampleRate;
+        s.layout = pcm.layout;
+        s.startFrame = pcm.startFrame;
+        s.referenced.store(false, std::memory_order_relaxed);
+        if (s.key == kEmptyKey) ++size_;
+        s.key = key;
+
+        const size_t mask = index_.size() - 1;
+        size_t pos = hashKey(key) & mask;
+        while (index_[pos] != kNoSlot) pos = (pos + 1) & mask;
+        index_[pos] = i;
+    }
+
+    void unlink(int i)
+    {
+        Slot& s = slots_[static_cast<size_t>(i)];
+        if (s.key == kEmptyKey) return;
+        const size_t mask = index_.size() - 1;
+        size_t pos = hashKey(s.key) & mask;
+        while (index_[pos] != i) pos = (pos + 1) & mask;
+
+        // 後方シフト削除: 探索列が途切れないよう後続要素を詰める
+        size_t next = (pos + 1) & mask;
+        while (index_[next] != kNoSlot) {
+            const size_t home = hashKey(slots_[static_cast<size_t>(index_[next])].key) & mask;
+            if (((next - home) & mask) >= ((next - pos) & mask)) {
+                index_[pos] = index_[next];
+                pos = next;
+            }
+            next = (next + 1) & mask;
+        }
+        index_[pos] = kNoSlot;
+        s.key = kEmptyKey;
+        --size_;
+    }
+
+private:
+    static size_t hashKey(int64_t key)
+    {
+        uint64_t x = static_cast<uint64_t>(key);
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdull;
+        x ^= x >> 33;
+        return static_cast<size_t>(x);
+    }
+
+    AudioCacheSlabConfig config_;
+    std::vector<Slot> slots_;
+    std::vector<float> samples_;
+    std::vector<int32_t> index_;
+    int hand_ = 0;
+    int size_ = 0;
+};
+
+AudioCacheHandle::AudioCacheHandle(std::shared_ptr<AudioCacheSlab> slab, int slot)
+    : slab_(std::move(slab)), slot_(slot)
+{
+}
+
+AudioCacheHandle::AudioCacheHandle(const AudioCacheHandle& other)
+    : slab_(other.slab_), slot_(other.slot_)
+{
+    if (slot_ >= 0) slab_->pin(slot_);
+}
+
+AudioCacheHandle::AudioCacheHandle(AudioCacheHandle&& other) noexcept
+    : slab_(std::move(other.slab_)), slot_(std::exchange(other.slot_, -1))
+{
+}
+
+AudioCacheHandle& AudioCacheHandle::operator=(const AudioCacheHandle& other)
+{
+    if (this != &other) {
+        AudioCacheHandle copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+AudioCacheHandle& AudioCacheHandle::operator=(AudioCacheHandle&& other) noexcept
+{
+    if (this != &other) {
+        reset();
+        slab_ = std::move(other.slab_);
+        slot_ = std::exchange(other.slot_, -1);
+    }
+    return *this;
+}
+
+AudioCacheHandle::~AudioCacheHandle()
+{
+    reset();
+}
+
+void AudioCacheHandle::reset()
+{
+    if (slot_ >= 0) {
+        slab_->unpin(slot_);
+    }
+    slot_ = -1;
+    slab_.reset();
+}
+
+int64_t AudioCacheHandle::frameNumber() const
+{
+    return isValid() ? slab_->slot(slot_).frameNumber : -1;
+}
+
+int AudioCacheHandle::sampleRate() const
+{
+    return isValid() ? slab_->slot(slot_).sampleRate : 0;
+}
+
+AudioChannelLayout AudioCacheHandle::layout() const
+{
+    return isValid() ? slab_->slot(slot_).layout : AudioChannelLayout::Stereo;
+}
+
+qint64 AudioCacheHandle::startFrame() const
+{
+    return isValid() ? slab_->slot(slot_).startFrame : 0;
+}
+
+int AudioCacheHandle::channelCount() const
+{
+    return isValid() ? slab_->slot(slot_).channels : 0;
+}
+
+int AudioCacheHandle::frameCount() const
+{
+    return isValid() ? slab_->slot(slot_).frames : 0;
+}
+
+const float* AudioCacheHandle::constData(int channelIdx) const
+{
+    if (!isValid() || channelIdx < 0 || channelIdx >= channelCount()) {
+        return nullptr;
+    }
+    return slab_->channel(slot_, channelIdx);
+}
+
+void AudioCacheHandle::copyTo(AudioSegment& out) const
+{
+    out.channelData.clear();
+    if (!isValid()) return;
+    const int frames = frameCount();
+    const int channels = channelCount();
+    out.channelData.resize(channels);
+    for (int ch = 0; ch < channels; ++ch) {
+        const float* src = constData(ch);
+        out.channelData[ch] = QVector<float>(src, src + frames);
+    }
+    out.sampleRate = sampleRate();
+    out.layout = layout();
+    out.startFrame = startFrame();
+}
+
 AudioCache::AudioCache()
 {
     qDebug() << "[AudioCache] Created with max frames:" << maxCacheFrames_;
@@ -20,18 +288,50 @@ AudioCache::AudioCache()
 
 bool AudioCache::getCached(int64_t frameNumber, AudioSegment& out)
 {
+    {
+        QReadLocker locker(&lock_);
+        if (mode_ == AudioCacheMode::Slab) {
+            locker.unlock();
+            const AudioCacheHandle handle = acquire(frameNumber);
+            if (!handle) return false;
+            handle.copyTo(out);
+            return true;
+        }
+    }
+
     QWriteLocker locker(&lock_);  // lastAccess mutation requires exclusive lock
     
     auto it = cache_.find(frameNumber);
     if (it != cache_.end()) {
         it->lastAccess = QDateTime::currentMSecsSinceEpoch();
         out = it->pcm;  // コピー
+        hits_.fetch_add(1, std::memory_order_relaxed);
         return true;
     }
     
+    misses_.fetch_add(1, std::memory_order_relaxed);
     return false;
 }
 
+AudioCacheHandle AudioCache::acquire(int64_t frameNumber)
+{
+    QReadLocker locker(&lock_);
+    if (mode_ != AudioCacheMode::Slab || !slab_) {
+        return {};
+    }
+    const int slot = slab_->find(frameNumber);
+    if (slot == AudioCacheSlab::kNoSlot) {
+        misses_.fetch_add(1, std::memory_order_relaxed);
+        return {};
+    }
+    // 書き込み側は書き込みロック下でしかブロックを再利用しないため、
+    // 読み取りロック中にピンを立てればロック解放後も内容は保たれる
+    slab_->pin(slot);
+    slab_->slot(slot).referenced.store(true, std::memory_order_relaxed);
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return AudioCacheHandle(slab_, slot);
+}
+
 void AudioCache::addCache(int64_t frameNumber, AudioSegment&& pcm)
 {
     if (frameNumber < 0 || pcm.sampleRate <= 0 || pcm.frameCount() <= 0 ||
@@ -45,6 +345,11 @@ void AudioCache::addCache(int64_t frameNumber, AudioSegment&& pcm)
         }
     }
     QWriteLocker locker(&lock_);
+
+    if (mode_ == AudioCacheMode::Slab) {
+        addSlab(frameNumber, pcm);
+        return;
+    }
     
     // 既存エントリがある場合は置き換え
     auto it = cache_.find(frameNumber);
@@ -57,6 +362,7 @@ void AudioCache::addCache(int64_t frameNumber, AudioSegment&& pcm)
     // 新規エントリ
     qint64 now = QDateTime::currentMSecsSinceEpoch();
     cache_.insert(frameNumber, CachedAudioFrame(frameNumber, std::move(pcm), now));
+    insertions_.fetch_add(1, std::memory_order_relaxed);
     
     // キャッシュサイズ超過時はクリーンアップ
     if (cache_.size() > maxCacheFrames_) {
@@ -64,6 +370,38 @@ void AudioCache::addCache(int64_t frameNumber, AudioSegment&& pcm)
     }
 }
 
+void AudioCache::addSlab(int64_t frameNumber, const AudioSegment& pcm)
+{
+    if (!slab_->fits(pcm)) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    int slot = slab_->find(frameNumber);
+    if (slot != AudioCacheSlab::kNoSlot) {
+        slab_->unlink(slot);
+        // 参照中のブロックは書き換えられないので、別ブロックへ入れ直す
+        if (slab_->slot(slot).pins.load(std::memory_order_acquire) != 0) {
+            slot = AudioCacheSlab::kNoSlot;
+        }
+    }
+
+    uint64_t evictions = 0;
+    uint64_t pinnedSkips = 0;
+    if (slot == AudioCacheSlab::kNoSlot) {
+        slot = slab_->selectVictim(evictions, pinnedSkips);
+    }
+    evictions_.fetch_add(evictions, std::memory_order_relaxed);
+    pinnedSkips_.fetch_add(pinnedSkips, std::memory_order_relaxed);
+    if (slot == AudioCacheSlab::kNoSlot) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    slab_->store(slot, frameNumber, pcm);
+    insertions_.fetch_add(1, std::memory_order_relaxed);
+}
+
 void AudioCache::prefetch(int64_t startFrame, int frameCount)
 {
     if (startFrame < 0 || frameCount <= 0) {
@@ -107,6 +445,21 @@ void AudioCache::setPrefetchProvider(PrefetchProvider provider)
 void AudioCache::clearExpired(qint64 maxAgeMs)
 {
     QWriteLocker locker(&lock_);
+
+    if (mode_ == AudioCacheMode::Slab) {
+        for (int i = 0; i < slab_->slotCount(); ++i) {
+            auto& slot = slab_->slot(i);
+            if (slot.key == AudioCacheSlab::kEmptyKey ||
+                slot.pins.load(std::memory_order_acquire) != 0) {
+                continue;
+            }
+            if (!slot.referenced.exchange(false, std::memory_order_relaxed)) {
+                slab_->unlink(i);
+            }
+        }
+        qDebug() << "[AudioCache] Cleared unreferenced slab blocks, remaining:" << slab_->size();
+        return;
+    }
     
     qint64 now = QDateTime::currentMSecsSinceEpoch();
     const qint64 safeAge = std::max<qint64>(0, maxAgeMs);
@@ -128,6 +481,9 @@ void AudioCache::clearExpired(qint64 maxAgeMs)
 size_t AudioCache::getCacheSize() const
 {
     QReadLocker locker(&lock_);
+    if (mode_ == AudioCacheMode::Slab) {
+        return static_cast<size_t>(slab_->size());
+    }
     return cache_.size();
 }
 
@@ -135,6 +491,10 @@ size_t AudioCache::getMemoryUsage() const
 {
     QReadLocker locker(&lock_);
 
+    if (mode_ == AudioCacheMode::Slab) {
+        return slab_->sampleBytes();
+    }
+
     size_t totalBytes = 0;
     for (const auto& entry : cache_) {
         // AudioSegment のメモリ使用量を概算
@@ -162,6 +522,10 @@ void AudioCache::setMaxCacheFrames(int maxFrames)
 {
     QWriteLocker locker(&lock_);
     maxCacheFrames_ = std::max(1, maxFrames);
+    if (mode_ == AudioCacheMode::Slab && slabConfig_.slotCount != maxCacheFrames_) {
+        slabConfig_.slotCount = maxCacheFrames_;
+        slab_ = std::make_shared<AudioCacheSlab>(slabConfig_);
+    }
 }
 
 int AudioCache::getMaxCacheFrames() const
@@ -174,9 +538,66 @@ void AudioCache::clear()
 {
     QWriteLocker locker(&lock_);
     cache_.clear();
+    if (slab_) {
+        // ピン留め中のブロックも索引から外す（内容はハンドル解放まで保持される）
+        for (int i = 0; i < slab_->slotCount(); ++i) {
+            slab_->unlink(i);
+        }
+    }
     qDebug() << "[AudioCache] Cache cleared";
 }
 
+AudioCacheStats AudioCache::stats() const
+{
+    AudioCacheStats out;
+    out.hits = hits_.load(std::memory_order_relaxed);
+    out.misses = misses_.load(std::memory_order_relaxed);
+    out.insertions = insertions_.load(std::memory_order_relaxed);
+    out.evictions = evictions_.load(std::memory_order_relaxed);
+    out.pinnedSkips = pinnedSkips_.load(std::memory_order_relaxed);
+    out.rejected = rejected_.load(std::memory_order_relaxed);
+    return out;
+}
+
+void AudioCache::resetStats()
+{
+    hits_.store(0, std::memory_order_relaxed);
+    misses_.store(0, std::memory_order_relaxed);
+    insertions_.store(0, std::memory_order_relaxed);
+    evictions_.store(0, std::memory_order_relaxed);
+    pinnedSkips_.store(0, std::memory_order_relaxed);
+    rejected_.store(0, std::memory_order_relaxed);
+}
+
+void AudioCache::setMode(AudioCacheMode mode, const AudioCacheSlabConfig& config)
+{
+    QWriteLocker locker(&lock_);
+    cache_.clear();
+    slab_.reset();
+    mode_ = mode;
+    if (mode_ == AudioCacheMode::Slab) {
+        slabConfig_.slotCount = std::max(1, config.slotCount);
+        slabConfig_.channels = std::max(1, config.channels);
+        slabConfig_.framesPerBlock = std::max(1, config.framesPerBlock);
+        maxCacheFrames_ = slabConfig_.slotCount;
+        slab_ = std::make_shared<AudioCacheSlab>(slabConfig_);
+    }
+    qDebug() << "[AudioCache] Mode:" << (mode_ == AudioCacheMode::Slab ? "slab" : "map")
+             << "max frames:" << maxCacheFrames_;
+}
+
+AudioCacheMode AudioCache::mode() const
+{
+    QReadLocker locker(&lock_);
+    return mode_;
+}
+
+AudioCacheSlabConfig AudioCache::slabConfig() const
+{
+    QReadLocker locker(&lock_);
+    return slabConfig_;
+}
+
 void AudioCache::cleanupLRU()
 {
     if (cache_.isEmpty()) return;
@@ -198,6 +619,7 @@ void AudioCache::cleanupLRU()
     for (int i = 0; i < mid; ++i) {
         cache_.remove(entries[i].key);
     }
+    evictions_.fetch_add(static_cast<uint64_t>(mid), std::memory_order_relaxed);
 }
 
 } // namespace ArtifactCore
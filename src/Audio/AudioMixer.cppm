@@ -1,12 +1,16 @@
 module;
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 #include <QJsonArray>
 #include <QJsonObject>
@@ -22,6 +26,7 @@ import Core.ArtifactString;
 import Utils.String.Like;
 import Memory.TrackedPtr;
 import Memory.SharedPtr;
+import ArtifactCore.Utils.PerformanceProfiler;
 
 namespace ArtifactCore {
 
@@ -57,6 +62,164 @@ AudioBusKind readBusKind(const QJsonObject& busObj, const QString& name)
     return static_cast<AudioBusKind>(value);
 }
 
+// バスグラフ実行用の常駐ワーカー
+// ブロックごとの起床は std::atomic の wait/notify のみで行い、実行中は
+// ロックもメモリ確保も行わない。キューはブロック内の各ノードが一度ずつしか
+// 投入されないことを利用した固定長配列で、プラン再構築時にだけ確保する。
+class AudioGraphWorkerPool {
+public:
+    using RunFn = void (*)(void* context, int node);
+
+    explicit AudioGraphWorkerPool(int workers)
+    {
+        threads_.reserve(static_cast<size_t>(workers));
+        for (int i = 0; i < workers; ++i) {
+            threads_.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~AudioGraphWorkerPool()
+    {
+        stop_.store(true, std::memory_order_seq_cst);
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        epoch_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    int workerCount() const { return static_cast<int>(threads_.size()); }
+
+    void reserve(int nodeCount)
+    {
+        if (nodeCount > capacity_) {
+            ready_ = std::make_unique<std::atomic<int>[]>(static_cast<size_t>(nodeCount));
+            capacity_ = nodeCount;
+        }
+    }
+
+    // 呼び出しスレッドも処理に参加し、全ノード完了まで戻らない。
+    // dependents / pending は呼び出し側が保持し、ブロック中は変更しないこと。
+    void run(int nodeCount, const std::vector<std::vector<int>>& dependents,
+             std::atomic<int>* pending, RunFn fn, void* context)
+    {
+        // 前ブロックから遅れて起きたワーカーが抜けるのを待つ
+        while (active_.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+
+        dependents_ = &dependents;
+        pending_ = pending;
+        fn_ = fn;
+        context_ = context;
+        for (int i = 0; i < nodeCount; ++i) {
+            ready_[i].store(-1, std::memory_order_relaxed);
+        }
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        remaining_.store(nodeCount, std::memory_order_relaxed);
+        for (int i = 0; i < nodeCount; ++i) {
+            if (pending[i].load(std::memory_order_relaxed) == 0) {
+                push(i);
+            }
+        }
+
+        open_.store(true, std::memory_order_seq_cst);
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        epoch_.notify_all();
+
+        drain();
+
+        open_.store(false, std::memory_order_seq_cst);
+        while (active_.load(std::memory_order_seq_cst) != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+private:
+    void push(int node)
+    {
+        const int index = tail_.fetch_add(1, std::memory_order_acq_rel);
+        ready_[index].store(node, std::memory_order_release);
+    }
+
+    int tryPop()
+    {
+        int head = head_.load(std::memory_order_acquire);
+        if (head >= tail_.load(std::memory_order_acquire)) {
+            return -1;
+        }
+        if (!head_.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel)) {
+            return -1;
+        }
+        // push は添字の確保と書き込みの間に割り込まれうるので、書き込みを待つ
+        int node = ready_[head].load(std::memory_order_acquire);
+        while (node < 0) {
+            std::this_thread::yield();
+            node = ready_[head].load(std::memory_order_acquire);
+        }
+        return node;
+    }
+
+    void drain()
+    {
+        while (remaining_.load(std::memory_order_acquire) > 0) {
+            const int node = tryPop();
+            if (node < 0) {
+                std::this_thread::yield();
+                continue;
+            }
+            fn_(context_, node);
+            for (const int dependent : (*dependents_)[node]) {
+                if (pending_[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    push(dependent);
+                }
+            }
+            remaining_.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    void workerLoop()
+    {
+        std::uint64_t seen = 0;
+        for (;;) {
+            epoch_.wait(seen, std::memory_order_acquire);
+            seen = epoch_.load(std::memory_order_acquire);
+            if (stop_.load(std::memory_order_acquire)) {
+                return;
+            }
+            active_.fetch_add(1, std::memory_order_seq_cst);
+            if (open_.load(std::memory_order_seq_cst)) {
+                drain();
+            }
+            active_.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::unique_ptr<std::atomic<int>[]> ready_;
+    int capacity_ = 0;
+
+    const std::vector<std::vector<int>>* dependents_ = nullptr;
+    std::atomic<int>* pending_ = nullptr;
+    RunFn fn_ = nullptr;
+    void* context_ = nullptr;
+
+    alignas(64) std::atomic<int> head_{0};
+    alignas(64) std::atomic<int> tail_{0};
+    alignas(64) std::atomic<int> remaining_{0};
+    alignas(64) std::atomic<std::uint64_t> epoch_{0};
+    std::atomic<int> active_{0};
+    std::atomic<bool> open_{false};
+    std::atomic<bool> stop_{false};
+};
+
+int defaultMixerWorkerCount()
+{
+    const unsigned hardware = std::thread::hardware_concurrency();
+    return hardware > 1 ? static_cast<int>(std::min(hardware - 1, 7u)) : 0;
+}
+
 }
 
 struct SideChainSend {
@@ -73,6 +236,38 @@ struct AudioMixer::Impl {
         makeNamedVector<SideChainSend>(ContainerName{"AudioMixerSideChainSendsState"})};
     std::map<const AudioBus*, AudioBusKind> busKinds;
 
+    // --- グラフ実行プラン（バス構成が変わるまで再利用） ---
+    // nodes はトポロジカル順。入力は常に順序の小さいノードから来るため、
+    // 各バスが入力を添字順に合算すれば直列実行と同じ結果になる。
+    struct GraphNode {
+        SharedPtr<AudioBus> bus;
+        int route = -1;                                  // 主出力先（後方も含む）
+        std::vector<int> primaryInputs;                  // 主入力元（前方のみ、昇順）
+        std::vector<std::pair<int, float>> sideChainInputs;
+        bool hasPrimaryInput = false;
+        bool isMaster = false;
+    };
+    std::vector<GraphNode> nodes;
+    std::vector<std::vector<int>> dependents;
+    std::vector<int> inputCounts;
+    bool parallelPlan = false;
+    bool topologyDirty = true;
+
+    // ブロックごとの作業領域（プラン構築時に確保）
+    std::unique_ptr<std::atomic<int>[]> pending;
+    std::vector<qint64> ownLatency;
+    std::vector<qint64> pathLatency;
+    std::vector<unsigned char> soloUpstream;
+    std::vector<unsigned char> feedsSolo;
+    bool blockHasSolo = false;
+    qint64 blockMaxLatency = 0;
+
+    int workers = defaultMixerWorkerCount();
+    std::unique_ptr<AudioGraphWorkerPool> pool;
+
+    // これ未満のバス数では起床コストが勝るため直列で処理する
+    static constexpr int kMinParallelBuses = 8;
+
     SharedPtr<AudioBus> resolveBus(const AudioBus* bus) const {
         if (!bus) {
             return nullptr;
@@ -124,6 +319,172 @@ struct AudioMixer::Impl {
 
         return result.toStdVector();
     }
+
+    void rebuildPlan(const AudioBus* master) {
+        const auto sorted = getSortedBuses();
+        std::map<const AudioBus*, int> indexOf;
+        for (int i = 0; i < static_cast<int>(sorted.size()); ++i) {
+            indexOf[sorted[i].get()] = i;
+        }
+        const int count = static_cast<int>(sorted.size());
+        nodes.assign(count, GraphNode{});
+        for (int i = 0; i < count; ++i) {
+            nodes[i].bus = sorted[i];
+            nodes[i].isMaster = sorted[i].get() == master;
+        }
+        // サイドチェーン送りが循環していると、送り先が送り元より先に並ぶ
+        // （後方への辺）。直列実行でもその出力は当該ブロックに届かないため、
+        // 入力・依存関係からは除外し、レイテンシとソロの経路にだけ使う。
+        for (const auto& [source, target] : routing) {
+            const auto s = indexOf.find(source);
+            const auto t = indexOf.find(target);
+            if (s == indexOf.end() || t == indexOf.end()) continue;
+            nodes[s->second].route = t->second;
+            nodes[t->second].hasPrimaryInput = true;
+            if (s->second < t->second) {
+                nodes[t->second].primaryInputs.push_back(s->second);
+            }
+        }
+        for (const auto& send : sends) {
+            const auto s = indexOf.find(send.source.get());
+            const auto t = indexOf.find(send.target.get());
+            if (s == indexOf.end() || t == indexOf.end() || s->second >= t->second) continue;
+            nodes[t->second].sideChainInputs.push_back({s->second, send.amount});
+        }
+
+        dependents.assign(count, {});
+        inputCounts.assign(count, 0);
+        std::vector<int> level(count, 0);
+        int widest = 0;
+        std::vector<int> levelWidth(count + 1, 0);
+        for (int i = 0; i < count; ++i) {
+            auto& node = nodes[i];
+            std::sort(node.primaryInputs.begin(), node.primaryInputs.end());
+            std::sort(node.sideChainInputs.begin(), node.sideChainInputs.end(),
+                      [](const auto& a, const auto& b) { return a.first < b.first; });
+            std::vector<int> inputs = node.primaryInputs;
+            for (const auto& [source, amount] : node.sideChainInputs) {
+                inputs.push_back(source);
+            }
+            std::sort(inputs.begin(), inputs.end());
+            inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+            inputCounts[i] = static_cast<int>(inputs.size());
+            for (const int source : inputs) {
+                dependents[source].push_back(i);
+                level[i] = std::max(level[i], level[source] + 1);
+            }
+            widest = std::max(widest, ++levelWidth[level[i]]);
+        }
+
+        pending = std::make_unique<std::atomic<int>[]>(static_cast<size_t>(std::max(count, 1)));
+        ownLatency.assign(count, 0);
+        pathLatency.assign(count, 0);
+        soloUpstream.assign(count, 0);
+        feedsSolo.assign(count, 0);
+        parallelPlan = workers > 0 && count >= kMinParallelBuses && widest >= 2;
+        if (parallelPlan) {
+            if (!pool || pool->workerCount() != workers) {
+                pool.reset();
+                pool = std::make_unique<AudioGraphWorkerPool>(workers);
+            }
+            pool->reserve(count);
+        }
+        topologyDirty = false;
+    }
+
+    // レイテンシ補正とソロ判定はバスの状態で変わるため毎ブロック求める。
+    // 主経路は非循環なので、各バスから route を辿るだけでよい（O(バス数 × 深さ)）。
+    void prepareBlock() {
+        const int count = static_cast<int>(nodes.size());
+        for (int i = 0; i < count; ++i) {
+            ownLatency[i] = std::max<qint64>(0, nodes[i].bus->latencySamples());
+            soloUpstream[i] = 0;
+            pending[i].store(inputCounts[i], std::memory_order_relaxed);
+        }
+
+        blockMaxLatency = 0;
+        blockHasSolo = false;
+        for (int i = 0; i < count; ++i) {
+            qint64 total = 0;
+            for (int cursor = i; cursor >= 0; cursor = nodes[cursor].route) {
+                if (ownLatency[cursor] > std::numeric_limits<qint64>::max() - total) {
+                    total = std::numeric_limits<qint64>::max();
+                    break;
+                }
+                total += ownLatency[cursor];
+            }
+            pathLatency[i] = total;
+            blockMaxLatency = std::max(blockMaxLatency, total);
+
+            bool feeds = false;
+            for (int cursor = nodes[i].route; cursor >= 0 && !nodes[cursor].isMaster;
+                 cursor = nodes[cursor].route) {
+                if (nodes[cursor].bus->isSolo()) {
+                    feeds = true;
+                    break;
+                }
+            }
+            feedsSolo[i] = feeds;
+
+            // ソロのバスとその下流（Master を除く）は上流にソロを持つ
+            if (!nodes[i].isMaster && nodes[i].bus->isSolo()) {
+                blockHasSolo = true;
+                for (int cursor = i; cursor >= 0 && !nodes[cursor].isMaster;
+                     cursor = nodes[cursor].route) {
+                    soloUpstream[cursor] = 1;
+                }
+            }
+        }
+    }
+
+    void runNode(int index) {
+        auto& node = nodes[index];
+        AudioBus& bus = *node.bus;
+        for (const int source : node.primaryInputs) {
+            bus.addInput(nodes[source].bus->getOutputBuffer());
+        }
+        for (const auto& [source, amount] : node.sideChainInputs) {
+            bus.addSideChain(nodes[source].bus->getOutputBuffer(), amount);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        // Solo is a graph-level decision. A bus remains audible when it is
+        // soloed, carries a soloed child, or feeds an explicitly soloed group.
+        // The last case keeps a group solo useful; it deliberately follows only
+        // the downstream primary route so a sibling of a soloed child stays muted.
+        // The Master bus must always process the surviving graph. Sidechain sends
+        // remain control inputs and do not make a primary route audible alone.
+        if (blockHasSolo && !node.isMaster && !soloUpstream[index] && !feedsSolo[index]) {
+            // Preserve the explicit mute state; solo is a temporary mix
+            // decision and must not be persisted as a mute mutation.
+            bus.getOutputBuffer().zero();
+        }
+        bus.process(bus.getOutputBuffer());
+
+        // Compensate only primary source buses. A group/master already
+        // contains aligned upstream material; delaying it again would double
+        // compensate the path. Sidechain sends remain control paths.
+        if (!node.isMaster) {
+            if (!node.hasPrimaryInput) {
+                const qint64 compensation = pathLatency[index] >= blockMaxLatency
+                    ? 0 : blockMaxLatency - pathLatency[index];
+                bus.applyLatencyCompensation(compensation);
+            } else {
+                // A bus can change from source to group after a routing edit;
+                // discard any old source delay history at that boundary.
+                bus.applyLatencyCompensation(0);
+            }
+        }
+
+        AudioEngineProfiler::instance().recordBusProcess(
+            static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&bus)),
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start).count());
+    }
+
+    static void runNodeThunk(void* context, int index) {
+        static_cast<Impl*>(context)->runNode(index);
+    }
 };
 
 AudioMixer::AudioMixer() : impl_(std::make_unique<Impl>()) {
@@ -384,6 +745,7 @@ bool AudioMixer::deserialize(const QJsonObject& data) {
     impl_->routing.clear();
     impl_->sends.clear();
     impl_->busKinds.clear();
+    impl_->topologyDirty = true;
     impl_->busKinds[masterBus_.get()] = AudioBusKind::Master;
     // Deserialization represents the complete mixer state. Remove buses that
     // are not present in the incoming document instead of merging stale buses
@@ -502,6 +864,7 @@ SharedPtr<AudioBus> AudioMixer::createBus(const String& name, AudioBusKind kind)
     bus->setName(name);
     impl_->buses.append(bus);
     impl_->busKinds[bus.get()] = kind;
+    impl_->topologyDirty = true;
     connect(bus, masterBus_);
     return bus;
 }
@@ -545,6 +908,7 @@ void AudioMixer::removeBus(SharedPtr<AudioBus> bus) {
         });
 
     impl_->buses.removeIf([&](const auto& candidate) { return candidate == bus; });
+    impl_->topologyDirty = true;
 }
 
 AudioRoutingResult AudioMixer::connect(SharedPtr<AudioBus> source, SharedPtr<AudioBus> target) {
@@ -563,14 +927,16 @@ AudioRoutingResult AudioMixer::connect(SharedPtr<AudioBus> source, SharedPtr<Aud
         cursor = it == impl_->routing.end() ? nullptr : it->second;
     }
     impl_->routing[source.get()] = target.get();
+    impl_->topologyDirty = true;
     return AudioRoutingResult::Applied;
 }
 
 AudioRoutingResult AudioMixer::disconnect(SharedPtr<AudioBus> source) {
     if (!source || !impl_->resolveBus(source.get())) return AudioRoutingResult::InvalidSource;
     if (source == masterBus_) return AudioRoutingResult::MasterSource;
-    return impl_->routing.erase(source.get()) > 0
-        ? AudioRoutingResult::Applied : AudioRoutingResult::NoRoute;
+    if (impl_->routing.erase(source.get()) == 0) return AudioRoutingResult::NoRoute;
+    impl_->topologyDirty = true;
+    return AudioRoutingResult::Applied;
 }
 
 AudioRoutingResult AudioMixer::addSideChainSend(SharedPtr<AudioBus> source, SharedPtr<AudioBus> target, float amount) {
@@ -586,9 +952,11 @@ AudioRoutingResult AudioMixer::addSideChainSend(SharedPtr<AudioBus> source, Shar
         });
     if (existing != impl_->sends.end()) {
         existing->amount = amount;
+        impl_->topologyDirty = true;
         return AudioRoutingResult::Applied;
     }
     impl_->sends.append({source, target, amount});
+    impl_->topologyDirty = true;
     return AudioRoutingResult::Applied;
 }
 
@@ -599,8 +967,9 @@ AudioRoutingResult AudioMixer::removeSideChainSend(SharedPtr<AudioBus> source, S
         [&](const auto& send) {
             return send.source == source && send.target == target;
         });
-    return removed != 0
-        ? AudioRoutingResult::Applied : AudioRoutingResult::NoSend;
+    if (removed == 0) return AudioRoutingResult::NoSend;
+    impl_->topologyDirty = true;
+    return AudioRoutingResult::Applied;
 }
 
 void AudioMixer::process(AudioSegment& finalOutput) {
@@ -620,128 +989,56 @@ void AudioMixer::process(AudioSegment& finalOutput) {
         }
     }
 
-    const auto sorted = impl_->getSortedBuses();
-
-    const auto primaryPathLatency = [this](const SharedPtr<AudioBus>& source) {
-        qint64 total = 0;
-        std::set<const AudioBus*> visited;
-        const AudioBus* cursor = source.get();
-        while (cursor && visited.insert(cursor).second) {
-            const auto resolved = impl_->resolveBus(cursor);
-            if (!resolved) break;
-            const qint64 value = std::max<qint64>(0, resolved->latencySamples());
-            if (value > 0 && total > std::numeric_limits<qint64>::max() - value) {
-                return std::numeric_limits<qint64>::max();
-            }
-            total += value;
-            const auto route = impl_->routing.find(cursor);
-            cursor = route == impl_->routing.end() ? nullptr : route->second;
-        }
-        return total;
-    };
-    qint64 maximumPathLatency = 0;
-    for (const auto& bus : sorted) {
-        if (bus) maximumPathLatency = std::max(
-            maximumPathLatency, primaryPathLatency(bus));
-    }
-
-    // Solo is a graph-level decision. A bus remains audible when it is
-    // soloed, carries a soloed child, or feeds an explicitly soloed group.
-    // The last case keeps a group solo useful; it deliberately follows only
-    // the downstream primary route so a sibling of a soloed child stays muted.
-    // The Master bus must always process the surviving graph. Sidechain sends
-    // remain control inputs and do not make a primary route audible alone.
-    const bool hasSolo = std::any_of(
-        impl_->buses.begin(), impl_->buses.end(),
-        [this](const SharedPtr<AudioBus>& bus) {
-            return bus && bus != masterBus_ && bus->isSolo();
-        });
-    const auto hasSoloUpstream = [this](const SharedPtr<AudioBus>& target) {
-        if (!target || target == masterBus_) {
-            return false;
-        }
-        std::set<const AudioBus*> visited;
-        std::function<bool(const AudioBus*)> visit = [&](const AudioBus* bus) {
-            if (!bus || !visited.insert(bus).second) {
-                return false;
-            }
-            if (bus->isSolo()) {
-                return true;
-            }
-            for (const auto& [source, destination] : impl_->routing) {
-                if (destination == bus && visit(source)) {
-                    return true;
-                }
-            }
-            return false;
-        };
-        return visit(target.get());
-    };
-    const auto feedsSoloGroup = [this](const SharedPtr<AudioBus>& source) {
-        if (!source || source == masterBus_) {
-            return false;
-        }
-        std::set<const AudioBus*> visited;
-        const AudioBus* cursor = source.get();
-        while (cursor && visited.insert(cursor).second) {
-            const auto it = impl_->routing.find(cursor);
-            if (it == impl_->routing.end() || !it->second ||
-                it->second == masterBus_.get()) {
-                return false;
-            }
-            cursor = it->second;
-            if (cursor->isSolo()) {
-                return true;
-            }
+    if (impl_->topologyDirty) {
+        impl_->rebuildPlan(masterBus_.get());
+    }
+    impl_->prepareBlock();
+
+    const int nodeCount = static_cast<int>(impl_->nodes.size());
+    if (impl_->parallelPlan && impl_->pool) {
+        impl_->pool->run(nodeCount, impl_->dependents, impl_->pending.get(),
+                         &Impl::runNodeThunk, impl_.get());
+    } else {
+        for (int i = 0; i < nodeCount; ++i) {
+            impl_->runNode(i);
         }
-        return false;
-    };
+    }
 
-    for (const auto& bus : sorted) {
-        if (hasSolo && bus != masterBus_ && !hasSoloUpstream(bus) &&
-            !feedsSoloGroup(bus)) {
-            // Preserve the explicit mute state; solo is a temporary mix
-            // decision and must not be persisted as a mute mutation.
-            bus->getOutputBuffer().zero();
-        }
-        bus->process(bus->getOutputBuffer());
+    finalOutput = masterBus_->getOutputBuffer();
+}
 
-        // Compensate only primary source buses. A group/master already
-        // contains aligned upstream material; delaying it again would double
-        // compensate the path. Sidechain sends remain control paths.
-        if (bus != masterBus_) {
-            const bool hasPrimaryInput = std::any_of(
-                impl_->routing.begin(), impl_->routing.end(),
-                [&bus](const auto& route) {
-                    return route.second == bus.get();
-                });
-            if (!hasPrimaryInput) {
-                const qint64 pathLatency = primaryPathLatency(bus);
-                const qint64 compensation = pathLatency >= maximumPathLatency
-                    ? 0 : maximumPathLatency - pathLatency;
-                bus->applyLatencyCompensation(compensation);
-            } else {
-                // A bus can change from source to group after a routing edit;
-                // discard any old source delay history at that boundary.
-                bus->applyLatencyCompensation(0);
-            }
-        }
+void AudioMixer::setWorkerCount(int workers) {
+    const int safeWorkers = std::clamp(workers, 0, 64);
+    if (safeWorkers == impl_->workers) {
+        return;
+    }
+    impl_->workers = safeWorkers;
+    impl_->pool.reset();
+    impl_->topologyDirty = true;
+}
 
-        auto it = impl_->routing.find(bus.get());
-        if (it != impl_->routing.end() && it->second) {
-            if (auto target = impl_->resolveBus(it->second)) {
-                target->addInput(bus->getOutputBuffer());
-            }
-        }
+int AudioMixer::workerCount() const {
+    return impl_->workers;
+}
 
-        for (const auto& send : impl_->sends) {
-            if (send.source == bus) {
-                send.target->addSideChain(bus->getOutputBuffer(), send.amount);
-            }
-        }
+std::vector<AudioMixerBusTiming> AudioMixer::busTimings() const {
+    const auto stats = AudioEngineProfiler::instance().busSnapshot();
+    std::vector<AudioMixerBusTiming> result;
+    for (const auto& bus : impl_->buses) {
+        if (!bus) continue;
+        const auto key = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(bus.get()));
+        const auto it = std::find_if(stats.begin(), stats.end(),
+            [key](const AudioBusDspStats& entry) { return entry.busKey == key; });
+        if (it == stats.end()) continue;
+        AudioMixerBusTiming timing;
+        timing.bus = bus;
+        timing.averageUs = it->avgUs;
+        timing.maximumUs = it->maxUs;
+        timing.lastUs = it->lastUs;
+        timing.blocks = it->blocks;
+        result.push_back(timing);
     }
-
-    finalOutput = masterBus_->getOutputBuffer();
+    return result;
 }
 
 } // namespace ArtifactCore
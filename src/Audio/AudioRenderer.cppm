@@ -47,6 +47,44 @@ AudioBackendFormat toBackendFormat(const QAudioFormat& format)
   return backendFormat;
 }
 
+// 非有限値を 0 に置き換えてから gain を掛け、[-1, 1] にクランプする。
+// 分岐を持たない単純ループなのでコンパイラがベクトル化できる。
+void applyGainClamp(float* dst, const float* src, size_t count, float gain)
+{
+  for (size_t i = 0; i < count; ++i) {
+    const float s = src[i];
+    const float finite = (s - s) == 0.0f ? s : 0.0f;  // NaN / Inf -> 0
+    dst[i] = std::min(std::max(finite * gain, -1.0f), 1.0f);
+  }
+}
+
+float sanitizeSample(float sample, float gain)
+{
+  if (!std::isfinite(sample)) {
+    sample = 0.0f;
+  }
+  return std::clamp(sample * gain, -1.0f, 1.0f);
+}
+
+// ring の frame 番目・channel 番目のサンプル（チャンネル不足時はモノラル複製 / 無音）
+float viewSample(const AudioRingReadView& view, size_t frame, int channel)
+{
+  const int source = view.channels > channel ? channel : (view.channels == 1 ? 0 : -1);
+  if (source < 0) {
+    return 0.0f;
+  }
+  if (view.layout == AudioRingLayout::Interleaved) {
+    const auto& span = view.interleaved;
+    const size_t stride = static_cast<size_t>(view.channels);
+    return frame < span.firstFrames
+        ? span.first[frame * stride + source]
+        : span.second[(frame - span.firstFrames) * stride + source];
+  }
+  const auto& span = view.planar[source];
+  return frame < span.firstFrames ? span.first[frame]
+                                  : span.second[frame - span.firstFrames];
+}
+
 } // namespace
 
 struct AudioRenderer::Impl {
@@ -57,11 +95,9 @@ struct AudioRenderer::Impl {
   QString deviceName;
 
   std::unique_ptr<AudioBackend> backend;
+  // PERF: デバイスを開いた時点でデバイスのチャンネル数の Interleaved 配置にする。
+  // コールバックは beginRead() の領域から出力バッファへ直接書き出し、中間バッファを持たない。
   std::unique_ptr<AudioRingBuffer> ringBuffer;
-  // PERF: コールバック毎に AudioSegment を新規生成すると QVector の heap アロケーションが発生するため、
-  // 再利用可能なバッファを保持する。resize() は同じサイズなら no-op、
-  // 部分読出し時は事前に zero-fill して未使用領域を無音に保つ。
-  AudioSegment readBuffer_;
   std::atomic<size_t> underflowCount{0};
   std::atomic<size_t> overflowCount{0};
   std::atomic<size_t> partialUnderflowCount{0};
@@ -137,7 +173,8 @@ struct AudioRenderer::Impl {
   // PERF: この関数は WASAPI レンダースレッド（TimeCritical）上で実行される。
   // - qWarning()/qDebug() は文字列フォーマット + ロック取得が伴うため RT コールバック内では禁止
   // - levelCallback は shared_ptr + atomic_load で lock-free に呼び出し
-  // - readBuffer_ を再利用し、heap アロケーションを排除
+  // - ring buffer の領域を beginRead() で直接参照し、コピー・heap アロケーションを排除
+  // - ring がデバイスと同じ Interleaved 配置なら gain + clamp の 1 パスで書き出す
   // - 音量/ミュートは atomic で読み取り、変化時のみ setMasterVolume/setMute を呼ぶ
   void audioCallback(float *buffer, int frames, int channelsRequested) {
     const auto cbStart = std::chrono::high_resolution_clock::now();
@@ -170,70 +207,43 @@ struct AudioRenderer::Impl {
       return;
     }
 
-    readBuffer_.sampleRate = sampleRate;
-    readBuffer_.channelData.resize(channels);
-    for (auto& ch : readBuffer_.channelData) {
-      ch.resize(frames);
-      ch.fill(0.0f);
+    const AudioRingReadView view = ringBuffer->beginRead(static_cast<size_t>(frames));
+    const int availableFrames = static_cast<int>(view.frames);
+    const size_t stride = static_cast<size_t>(channelsRequested);
+    const float gain = std::isfinite(volume) ? volume : 0.0f;
+
+    if (availableFrames > 0) {
+      if (view.layout == AudioRingLayout::Interleaved &&
+          view.channels == channelsRequested) {
+        const auto& span = view.interleaved;
+        applyGainClamp(buffer, span.first, span.firstFrames * stride, gain);
+        applyGainClamp(buffer + span.firstFrames * stride, span.second,
+                       span.secondFrames * stride, gain);
+      } else {
+        for (int i = 0; i < availableFrames; ++i) {
+          float* out = buffer + static_cast<size_t>(i) * stride;
+          for (int ch = 0; ch < channelsRequested; ++ch) {
+            out[ch] = sanitizeSample(viewSample(view, static_cast<size_t>(i), ch), gain);
+          }
+        }
+      }
     }
+    ringBuffer->endRead(view.frames);
 
-    const bool success = ringBuffer->read(readBuffer_, frames);
-    const int availableFrames = readBuffer_.frameCount();
+    const size_t writtenSamples = static_cast<size_t>(availableFrames) * stride;
+    std::memset(buffer + writtenSamples, 0, (outputSamples - writtenSamples) * sizeof(float));
 
-    std::memset(buffer, 0, outputBytes);
-    if (success && availableFrames > 0) {
+    if (availableFrames > 0) {
       if (availableFrames < frames) {
         ++partialUnderflowCount;
-      }
-
-      double leftSumSq = 0.0;
-      double rightSumSq = 0.0;
-      float leftPeakAbs = 0.0f;
-      float rightPeakAbs = 0.0f;
-      int leftCount = 0;
-      int rightCount = 0;
-
-      for (int i = 0; i < availableFrames; ++i) {
-        for (int ch = 0; ch < channelsRequested; ++ch) {
-          float sample = 0.0f;
-          if (readBuffer_.channelCount() > ch &&
-              i < readBuffer_.channelData[ch].size()) {
-            sample = readBuffer_.channelData[ch][i];
-          } else if (readBuffer_.channelCount() == 1 &&
-                     i < readBuffer_.channelData[0].size()) {
-            sample = readBuffer_.channelData[0][i];
-          }
-
-          if (!std::isfinite(sample)) {
-            sample = 0.0f;
-          }
-          sample *= std::isfinite(volume) ? volume : 0.0f;
-          sample = std::clamp(sample, -1.0f, 1.0f);
-
-          if (availableFrames < frames) {
-            const int fadeStart = std::max(0, availableFrames - 64);
-            if (i >= fadeStart) {
-              const float t = static_cast<float>(i - fadeStart) / static_cast<float>(availableFrames - fadeStart);
-              const float fadeGain = 0.5f * (1.0f + std::cos(3.14159265f * t));
-              sample *= fadeGain;
-            }
-          }
-
-          const size_t outputIndex = static_cast<size_t>(i) *
-                                     static_cast<size_t>(channelsRequested) +
-                                     static_cast<size_t>(ch);
-          buffer[outputIndex] = sample;
-
-          if (ch == 0) {
-            leftSumSq += static_cast<double>(sample) * sample;
-            const float absSample = std::abs(sample);
-            if (absSample > leftPeakAbs) leftPeakAbs = absSample;
-            ++leftCount;
-          } else if (ch == 1) {
-            rightSumSq += static_cast<double>(sample) * sample;
-            const float absSample = std::abs(sample);
-            if (absSample > rightPeakAbs) rightPeakAbs = absSample;
-            ++rightCount;
+        // 途中で途切れる場合は末尾 64 サンプルを cosine fade してクリックを防ぐ
+        const int fadeStart = std::max(0, availableFrames - 64);
+        for (int i = fadeStart; i < availableFrames; ++i) {
+          const float t = static_cast<float>(i - fadeStart) / static_cast<float>(availableFrames - fadeStart);
+          const float fadeGain = 0.5f * (1.0f + std::cos(3.14159265f * t));
+          float* out = buffer + static_cast<size_t>(i) * stride;
+          for (int ch = 0; ch < channelsRequested; ++ch) {
+            out[ch] *= fadeGain;
           }
         }
       }
@@ -241,15 +251,28 @@ struct AudioRenderer::Impl {
       const int callbackSlot = activeLevelCallbackSlot_.load(std::memory_order_acquire);
       auto cb = std::atomic_load_explicit(
           &levelCallbackSlots_[callbackSlot], std::memory_order_acquire);
-      if (cb && availableFrames > 0) {
+      if (cb) {
         const int counter = levelCallbackCounter.fetch_add(1, std::memory_order_relaxed) + 1;
         if (counter >= 4) {
           levelCallbackCounter.store(0, std::memory_order_relaxed);
+
+          double sumSq[2] = {0.0, 0.0};
+          float peakAbs[2] = {0.0f, 0.0f};
+          const int meteredChannels = std::min(channelsRequested, 2);
+          for (int i = 0; i < availableFrames; ++i) {
+            const float* out = buffer + static_cast<size_t>(i) * stride;
+            for (int ch = 0; ch < meteredChannels; ++ch) {
+              sumSq[ch] += static_cast<double>(out[ch]) * out[ch];
+              peakAbs[ch] = std::max(peakAbs[ch], std::abs(out[ch]));
+            }
+          }
+
           AudioLevelData levels;
-          levels.leftRms = (leftCount > 0) ? sampleToDb(static_cast<float>(std::sqrt(leftSumSq / leftCount))) : -60.0f;
-          levels.rightRms = (rightCount > 0) ? sampleToDb(static_cast<float>(std::sqrt(rightSumSq / rightCount))) : -60.0f;
-          levels.leftPeak = sampleToDb(leftPeakAbs);
-          levels.rightPeak = sampleToDb(rightPeakAbs);
+          levels.leftRms = sampleToDb(static_cast<float>(std::sqrt(sumSq[0] / availableFrames)));
+          levels.rightRms = meteredChannels > 1
+              ? sampleToDb(static_cast<float>(std::sqrt(sumSq[1] / availableFrames))) : -60.0f;
+          levels.leftPeak = sampleToDb(peakAbs[0]);
+          levels.rightPeak = sampleToDb(peakAbs[1]);
           (*cb)(levels);
         }
       }
@@ -342,6 +365,13 @@ bool AudioRenderer::openDevice(const QString &deviceName) {
       impl_->sampleRate = current.sampleRate;
       impl_->channels = current.channelCount;
     }
+    // デバイス形式に合わせた Interleaved 配置へ切り替える。出力はまだ開始していない。
+    // enqueue() と並行しても setLayout が生産側ロックで待たせ、キュー済みの音声は引き継がれる
+    if (impl_->ringBuffer &&
+        (impl_->ringBuffer->layout() != AudioRingLayout::Interleaved ||
+         impl_->ringBuffer->channelCount() != impl_->channels)) {
+      impl_->ringBuffer->setLayout(AudioRingLayout::Interleaved, impl_->channels);
+    }
     impl_->deviceOpen.store(true, std::memory_order_release);
     impl_->deviceName = device.description();
     qDebug() << "[AudioRenderer] openDevice success"
@@ -4,21 +4,37 @@ module;
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <mutex>
 #include <vector>
 module Audio.RingBuffer;
 
 import Audio.Segment;
 
 namespace ArtifactCore {
-    // Single-producer / single-consumer (SPSC) lock-free ring buffer.
-    // Producer = PlaybackEngine thread  (write, clear, available)
-    // Consumer = WASAPI render thread   (read)
+    // Multi-producer / single-consumer ring buffer.
+    // Producers = PlaybackEngine / UI threads (write, beginWrite/endWrite, clear)
+    // Consumer  = WASAPI render thread        (read, beginRead/endRead)
+    // 生産側は producerMutex_ で直列化する。消費側（RT スレッド）はロックを取らない。
+    // setLayout / setCapacity も同じロックの下で行うため、書き込み中の生産側と競合しない。
+    //
+    // Planar では channels_[ch][frame]、Interleaved では
+    // interleaved_[frame * channelCount_ + ch] に格納する。使わない側の配列は解放しておく。
     class AudioRingBuffer::Impl {
-        static constexpr int kMaxChannels = 10;
+        static constexpr int kMaxChannels = kAudioRingMaxChannels;
         std::vector<std::vector<float>> channels_;
+        std::vector<float> interleaved_;
+        AudioRingLayout layout_ = AudioRingLayout::Planar;
         std::size_t capacity_ = 48000 * 8;
         std::atomic<int> channelCount_{2};
 
+        // beginRead / beginWrite で渡した領域の大きさ（各側スレッド専用）
+        std::size_t pendingRead_ = 0;
+        std::size_t pendingWrite_ = 0;
+
+        // 生産側の排他。beginWrite から endWrite までは pendingWriteLock_ が保持する。
+        std::mutex producerMutex_;
+        std::unique_lock<std::mutex> pendingWriteLock_;
+
         // writeCount_ is exclusively written by the producer.
         // readCount_ is exclusively written by the consumer.
         // Placing them on separate cache lines prevents false sharing.
@@ -37,24 +53,160 @@ namespace ArtifactCore {
             return std::max(read, clearAt);
         }
 
+        void allocateStorage() {
+            channels_.resize(kMaxChannels);
+            if (layout_ == AudioRingLayout::Planar) {
+                for (auto& ch : channels_) ch.resize(capacity_);
+                std::vector<float>().swap(interleaved_);
+            } else {
+                for (auto& ch : channels_) std::vector<float>().swap(ch);
+                interleaved_.resize(capacity_ * static_cast<std::size_t>(
+                    channelCount_.load(std::memory_order_relaxed)));
+            }
+        }
+
+        void resetCounters() {
+            writeCount_.store(0, std::memory_order_relaxed);
+            readCount_.store(0, std::memory_order_relaxed);
+            clearWriteCount_.store(0, std::memory_order_relaxed);
+            pendingRead_ = 0;
+            pendingWrite_ = 0;
+            clearGeneration_.fetch_add(1, std::memory_order_release);
+        }
+
+        static AudioChannelLayout layoutForChannels(int channels) {
+            switch (channels) {
+            case 1:
+                return AudioChannelLayout::Mono;
+            case 6:
+                return AudioChannelLayout::Surround51;
+            case 8:
+                return AudioChannelLayout::Surround71;
+            case 10:
+                return AudioChannelLayout::Custom10ch;
+            default:
+                return AudioChannelLayout::Stereo;
+            }
+        }
+
+        template <typename View>
+        void fillView(View& view, std::uint64_t position, std::size_t frames) {
+            const int channels = channelCount_.load(std::memory_order_acquire);
+            const std::size_t index = static_cast<std::size_t>(position) % capacity_;
+            const std::size_t firstChunk = std::min(frames, capacity_ - index);
+            view.layout = layout_;
+            view.channels = channels;
+            view.frames = frames;
+            if (frames == 0) return;
+            if (layout_ == AudioRingLayout::Interleaved) {
+                const std::size_t stride = static_cast<std::size_t>(channels);
+                view.interleaved = {interleaved_.data() + index * stride, firstChunk,
+                                    interleaved_.data(), frames - firstChunk};
+                return;
+            }
+            for (int ch = 0; ch < channels; ++ch) {
+                view.planar[ch] = {channels_[ch].data() + index, firstChunk,
+                                   channels_[ch].data(), frames - firstChunk};
+            }
+        }
+
+        // [sourceOffset, sourceOffset + count) を interleaved_ の destination フレームへ書き込む
+        void interleaveFrom(const AudioSegment& data, std::size_t destination,
+                            std::size_t sourceOffset, std::size_t count, int channels) {
+            float* out = interleaved_.data() + destination * static_cast<std::size_t>(channels);
+            const int inputChannels = data.channelCount();
+            for (int ch = 0; ch < channels; ++ch) {
+                const int sourceChannel = inputChannels > ch ? ch : (inputChannels == 1 ? 0 : -1);
+                const std::size_t sourceLength = sourceChannel >= 0
+                    ? static_cast<std::size_t>(data.channelData[sourceChannel].size()) : 0;
+                const std::size_t copyFrames = sourceOffset < sourceLength
+                    ? std::min(count, sourceLength - sourceOffset) : 0;
+                const float* src = copyFrames > 0
+                    ? data.channelData[sourceChannel].constData() + sourceOffset : nullptr;
+                float* dst = out + ch;
+                for (std::size_t i = 0; i < copyFrames; ++i) {
+                    dst[i * channels] = src[i];
+                }
+                for (std::size_t i = copyFrames; i < count; ++i) {
+                    dst[i * channels] = 0.0f;
+                }
+            }
+        }
+
+        // 生産側ロック下で、まだ読まれていないフレームを現在の配置から取り出す
+        void copyBuffered(AudioSegment& out) const {
+            const std::uint64_t r = logicalReadCount();
+            const std::uint64_t w = writeCount_.load(std::memory_order_acquire);
+            const std::size_t frames = std::min(static_cast<std::size_t>(w - r), capacity_);
+            const int channels = channelCount_.load(std::memory_order_relaxed);
+            out.channelData.resize(channels);
+            for (int ch = 0; ch < channels; ++ch) {
+                out.channelData[ch].resize(static_cast<int>(frames));
+                float* dst = out.channelData[ch].data();
+                for (std::size_t i = 0; i < frames; ++i) {
+                    const std::size_t index = static_cast<std::size_t>(r + i) % capacity_;
+                    dst[i] = layout_ == AudioRingLayout::Interleaved
+                        ? interleaved_[index * static_cast<std::size_t>(channels) + ch]
+                        : channels_[ch][index];
+                }
+            }
+            out.layout = layoutForChannels(channels);
+        }
+
+        // 消費側: clear() 要求を検出したら破棄して true を返す
+        bool consumeClearRequest() {
+            const std::uint32_t gen = clearGeneration_.load(std::memory_order_acquire);
+            if (gen == lastClearGen_) return false;
+            // Discard only frames that existed when clear() was requested.
+            // The producer may already have written fresh audio after that
+            // point; advancing to the live writeCount would drop it too.
+            const auto clearAt = clearWriteCount_.load(std::memory_order_acquire);
+            const auto currentWrite = writeCount_.load(std::memory_order_acquire);
+            readCount_.store(std::min(clearAt, currentWrite),
+                             std::memory_order_release);
+            lastClearGen_ = gen;
+            return true;
+        }
+
     public:
         explicit Impl(std::size_t capacity = 48000 * 8)
             : capacity_(std::max<std::size_t>(capacity, 1)) {
-            channels_.resize(kMaxChannels);
-            for (auto& ch : channels_) ch.resize(capacity_);
+            allocateStorage();
         }
 
         // Must only be called while audio output is stopped.
         void setCapacity(std::size_t capacity) {
+            std::lock_guard<std::mutex> lock(producerMutex_);
             capacity_ = std::max<std::size_t>(capacity, 1);
-            for (auto& ch : channels_) ch.resize(capacity_);
-            channelCount_.store(2, std::memory_order_release);
-            writeCount_.store(0, std::memory_order_relaxed);
-            readCount_.store(0, std::memory_order_relaxed);
-            clearWriteCount_.store(0, std::memory_order_relaxed);
-            clearGeneration_.fetch_add(1, std::memory_order_release);
+            if (layout_ == AudioRingLayout::Planar) {
+                channelCount_.store(2, std::memory_order_release);
+            }
+            allocateStorage();
+            resetCounters();
         }
 
+        // Must only be called while audio output is stopped. Producers are held
+        // off by producerMutex_, and frames already queued are carried over into
+        // the new layout instead of being dropped.
+        void setLayout(AudioRingLayout layout, int channels) {
+            std::lock_guard<std::mutex> lock(producerMutex_);
+            AudioSegment pending;
+            copyBuffered(pending);
+            layout_ = layout;
+            channelCount_.store(layout == AudioRingLayout::Interleaved
+                                    ? std::clamp(channels, 1, kMaxChannels)
+                                    : 2,
+                                std::memory_order_release);
+            allocateStorage();
+            resetCounters();
+            if (pending.frameCount() > 0) {
+                writeLocked(pending);
+            }
+        }
+
+        AudioRingLayout layout() const { return layout_; }
+        int channelCount() const { return channelCount_.load(std::memory_order_acquire); }
+
         std::size_t capacity() const { return capacity_; }
 
         std::size_t available() const {
@@ -68,9 +220,14 @@ namespace ArtifactCore {
             return capacity_ > buffered ? capacity_ - buffered : 0;
         }
 
-        // PERF: PlaybackEngine スレッド (Producer) からのみ呼ばれる。
-        // writeCount_ はこの関数内でのみインクリメントされる (SPSC 保証)。
         bool write(const AudioSegment& data) {
+            std::lock_guard<std::mutex> lock(producerMutex_);
+            return writeLocked(data);
+        }
+
+        // PERF: 生産側ロックを保持したまま呼ばれる。
+        // writeCount_ を進めるのはロック保持者だけなので、消費側からは SPSC と同じに見える。
+        bool writeLocked(const AudioSegment& data) {
             const std::size_t frames = data.frameCount();
             if (frames == 0) return true;
             const std::uint64_t r = logicalReadCount();
@@ -81,6 +238,18 @@ namespace ArtifactCore {
                 return false;
             }
 
+            if (layout_ == AudioRingLayout::Interleaved) {
+                const int channels = channelCount_.load(std::memory_order_relaxed);
+                const std::size_t wIdx = static_cast<std::size_t>(w) % capacity_;
+                const std::size_t firstChunk = std::min(frames, capacity_ - wIdx);
+                interleaveFrom(data, wIdx, 0, firstChunk, channels);
+                if (firstChunk < frames) {
+                    interleaveFrom(data, 0, firstChunk, frames - firstChunk, channels);
+                }
+                writeCount_.store(w + frames, std::memory_order_release);
+                return true;
+            }
+
             const int inputChannels = data.channelCount();
             if (inputChannels > kMaxChannels) return false;
             // Keep the highest channel count seen so far. This avoids shrinking
@@ -146,16 +315,7 @@ namespace ArtifactCore {
         //   * heap アロケーション不可
         bool read(AudioSegment& data, std::size_t frames) {
             // Check whether the producer has requested a buffer clear.
-            const std::uint32_t gen = clearGeneration_.load(std::memory_order_acquire);
-            if (gen != lastClearGen_) {
-                // Discard only frames that existed when clear() was requested.
-                // The producer may already have written fresh audio after that
-                // point; advancing to the live writeCount would drop it too.
-                const auto clearAt = clearWriteCount_.load(std::memory_order_acquire);
-                const auto currentWrite = writeCount_.load(std::memory_order_acquire);
-                readCount_.store(std::min(clearAt, currentWrite),
-                                 std::memory_order_release);
-                lastClearGen_ = gen;
+            if (consumeClearRequest()) {
                 data.clear();
                 return false;
             }
@@ -175,41 +335,78 @@ namespace ArtifactCore {
 
             const std::size_t readFrames = std::min(frames, avail);
             const int readChannels = channelCount_.load(std::memory_order_acquire);
+            const std::size_t rIdx = static_cast<std::size_t>(r) % capacity_;
+            const std::size_t firstChunk = std::min(readFrames, capacity_ - rIdx);
             data.channelData.resize(readChannels);
             for (int ch = 0; ch < readChannels; ++ch) {
                 data.channelData[ch].resize(readFrames);
-                const std::size_t rIdx = static_cast<std::size_t>(r) % capacity_;
-                const std::size_t firstChunk = std::min(readFrames, capacity_ - rIdx);
-
-                std::memcpy(data.channelData[ch].data(), &channels_[ch][rIdx], firstChunk * sizeof(float));
+                float* dst = data.channelData[ch].data();
+                if (layout_ == AudioRingLayout::Interleaved) {
+                    const std::size_t stride = static_cast<std::size_t>(readChannels);
+                    const float* src = interleaved_.data() + rIdx * stride + ch;
+                    for (std::size_t i = 0; i < firstChunk; ++i) dst[i] = src[i * stride];
+                    src = interleaved_.data() + ch;
+                    for (std::size_t i = firstChunk; i < readFrames; ++i) {
+                        dst[i] = src[(i - firstChunk) * stride];
+                    }
+                    continue;
+                }
+                std::memcpy(dst, &channels_[ch][rIdx], firstChunk * sizeof(float));
                 if (firstChunk < readFrames) {
-                    std::memcpy(data.channelData[ch].data() + firstChunk, &channels_[ch][0], (readFrames - firstChunk) * sizeof(float));
+                    std::memcpy(dst + firstChunk, &channels_[ch][0], (readFrames - firstChunk) * sizeof(float));
                 }
             }
-            switch (readChannels) {
-            case 1:
-                data.layout = AudioChannelLayout::Mono;
-                break;
-            case 6:
-                data.layout = AudioChannelLayout::Surround51;
-                break;
-            case 8:
-                data.layout = AudioChannelLayout::Surround71;
-                break;
-            case 10:
-                data.layout = AudioChannelLayout::Custom10ch;
-                break;
-            default:
-                data.layout = AudioChannelLayout::Stereo;
-                break;
-            }
+            data.layout = layoutForChannels(readChannels);
             readCount_.store(r + readFrames, std::memory_order_release);
             return true;
         }
 
-        // Called by the producer to discard all buffered audio.
+        // PERF: WASAPI レンダースレッド (RT) 用。コピー・確保・ロックなし。
+        AudioRingReadView beginRead(std::size_t maxFrames) {
+            AudioRingReadView view;
+            pendingRead_ = 0;
+            if (consumeClearRequest()) {
+                view.layout = layout_;
+                return view;
+            }
+            const std::uint64_t r = readCount_.load(std::memory_order_relaxed);
+            const std::uint64_t w = writeCount_.load(std::memory_order_acquire);
+            pendingRead_ = std::min(maxFrames, static_cast<std::size_t>(w - r));
+            fillView(view, r, pendingRead_);
+            return view;
+        }
+
+        void endRead(std::size_t frames) {
+            const std::uint64_t r = readCount_.load(std::memory_order_relaxed);
+            readCount_.store(r + std::min(frames, pendingRead_), std::memory_order_release);
+            pendingRead_ = 0;
+        }
+
+        // Planar では現在のチャンネル数 (channelCount()) 分の領域を返す。
+        // 生産側ロックを取得し、endWrite まで保持する。
+        AudioRingWriteView beginWrite(std::size_t maxFrames) {
+            pendingWriteLock_ = std::unique_lock<std::mutex>(producerMutex_);
+            AudioRingWriteView view;
+            const std::uint64_t r = logicalReadCount();
+            const std::uint64_t w = writeCount_.load(std::memory_order_relaxed);
+            const std::size_t buffered = std::min(static_cast<std::size_t>(w - r), capacity_);
+            pendingWrite_ = std::min(maxFrames, capacity_ - buffered);
+            fillView(view, w, pendingWrite_);
+            return view;
+        }
+
+        void endWrite(std::size_t frames) {
+            if (!pendingWriteLock_.owns_lock()) return;
+            const std::uint64_t w = writeCount_.load(std::memory_order_relaxed);
+            writeCount_.store(w + std::min(frames, pendingWrite_), std::memory_order_release);
+            pendingWrite_ = 0;
+            pendingWriteLock_.unlock();
+        }
+
+        // Called from any non-RT thread to discard all buffered audio.
         // The consumer will detect the generation change on its next read().
         void clear() {
+            std::lock_guard<std::mutex> lock(producerMutex_);
             clearWriteCount_.store(writeCount_.load(std::memory_order_relaxed),
                                    std::memory_order_release);
             clearGeneration_.fetch_add(1, std::memory_order_release);
@@ -225,10 +422,17 @@ namespace ArtifactCore {
 
     void AudioRingBuffer::setCapacity(size_t capacity) { impl_->setCapacity(capacity); }
     size_t AudioRingBuffer::capacity() const { return impl_->capacity(); }
+    void AudioRingBuffer::setLayout(AudioRingLayout layout, int channels) { impl_->setLayout(layout, channels); }
+    AudioRingLayout AudioRingBuffer::layout() const { return impl_->layout(); }
+    int AudioRingBuffer::channelCount() const { return impl_->channelCount(); }
     bool AudioRingBuffer::write(const AudioSegment& data) { return impl_->write(data); }
     bool AudioRingBuffer::read(AudioSegment& data, size_t size) { return impl_->read(data, size); }
     size_t AudioRingBuffer::available() const { return impl_->available(); }
     size_t AudioRingBuffer::freeSpace() const { return impl_->freeSpace(); }
+    AudioRingReadView AudioRingBuffer::beginRead(size_t maxFrames) { return impl_->beginRead(maxFrames); }
+    void AudioRingBuffer::endRead(size_t frames) { impl_->endRead(frames); }
+    AudioRingWriteView AudioRingBuffer::beginWrite(size_t maxFrames) { return impl_->beginWrite(maxFrames); }
+    void AudioRingBuffer::endWrite(size_t frames) { impl_->endWrite(frames); }
     void AudioRingBuffer::clear() { impl_->clear(); }
     bool AudioRingBuffer::isEmpty() const { return impl_->isEmpty(); }
     bool AudioRingBuffer::isFull() const { return impl_->isFull(); }
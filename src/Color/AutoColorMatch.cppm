@@ -84,36 +84,17 @@ struct ChannelStats {
 static ChannelStats computeChannelStats(const float* data, int count) {
     ChannelStats s;
     constexpr int kChunkSize = 4096;
-    const int chunkCount = (count + kChunkSize - 1) / kChunkSize;
-    NamedVector<double> partialSums;
-    partialSums.resize(static_cast<size_t>(chunkCount));
-    Parallel::For(0, chunkCount, count, [&](int chunk) {
-        const int begin = chunk * kChunkSize;
-        const int end = std::min(count, begin + kChunkSize);
-        double sum = 0.0;
-        for (int i = begin; i < end; ++i) sum += data[i];
-        partialSums[static_cast<size_t>(chunk)] = sum;
-    });
+    const auto add = [](double a, double b) { return a + b; };
 
-    double sum = 0.0;
-    for (double partial : partialSums) sum += partial;
+    const double sum = Parallel::TransformReduce(0, count, kChunkSize, 0.0, add,
+        [&](int i) { return static_cast<double>(data[i]); });
     s.mean = sum / std::max(1, count);
 
-    NamedVector<double> partialSquaredSums;
-    partialSquaredSums.resize(static_cast<size_t>(chunkCount));
-    Parallel::For(0, chunkCount, count, [&](int chunk) {
-        const int begin = chunk * kChunkSize;
-        const int end = std::min(count, begin + kChunkSize);
-        double sqSum = 0.0;
-        for (int i = begin; i < end; ++i) {
+    const double sqSum = Parallel::TransformReduce(0, count, kChunkSize, 0.0, add,
+        [&](int i) {
             const double d = data[i] - s.mean;
-            sqSum += d * d;
-        }
-        partialSquaredSums[static_cast<size_t>(chunk)] = sqSum;
-    });
-
-    double sqSum = 0.0;
-    for (double partial : partialSquaredSums) sqSum += partial;
+            return d * d;
+        });
     s.stddev = std::sqrt(sqSum / std::max(1, count));
     if (s.stddev < 0.0001) s.stddev = 0.0001;
     return s;
@@ -229,26 +210,20 @@ void AutoColorMatcher::meanStddevMatch(float* srcPixels, int srcWidth, int srcHe
 
 static void buildCDF(const float* channel, int count, float cdf[256]) {
     constexpr int kChunkSize = 4096;
-    const int chunkCount = (count + kChunkSize - 1) / kChunkSize;
-    NamedVector<std::array<int, 256>> partialHist;
-    partialHist.resize(static_cast<size_t>(chunkCount));
-    Parallel::For(0, chunkCount, count, [&](int chunk) {
-        auto& hist = partialHist[static_cast<size_t>(chunk)];
-        hist.fill(0);
-        const int begin = chunk * kChunkSize;
-        const int end = std::min(count, begin + kChunkSize);
-        for (int i = begin; i < end; ++i) {
-            const int bin = std::clamp(static_cast<int>(channel[i] * 255.0f), 0, 255);
-            ++hist[static_cast<size_t>(bin)];
-        }
-    });
+    using Bins = std::array<int, 256>;
+    const Bins hist = Parallel::Reduce(0, count, kChunkSize, Bins{},
+        [&](ParallelRange range, Bins bins) {
+            for (int i = range.begin; i < range.end; ++i) {
+                const int bin = std::clamp(static_cast<int>(channel[i] * 255.0f), 0, 255);
+                ++bins[static_cast<size_t>(bin)];
+            }
+            return bins;
+        },
+        [](Bins lhs, const Bins& rhs) {
+            for (size_t bin = 0; bin < lhs.size(); ++bin) lhs[bin] += rhs[bin];
+            return lhs;
+        });
 
-    std::array<int, 256> hist{};
-    for (const auto& partial : partialHist) {
-        for (int bin = 0; bin < 256; ++bin) {
-            hist[static_cast<size_t>(bin)] += partial[static_cast<size_t>(bin)];
-        }
-    }
     float invCount = 1.0f / std::max(1, count);
     cdf[0] = hist[0] * invCount;
     for (int i = 1; i < 256; ++i) {
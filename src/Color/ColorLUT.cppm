@@ -3,6 +3,10 @@ module;
 #include <vector>
 #include <cmath>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <optional>
 #include <QString>
 #include <QStringList>
 #include <QByteArray>
@@ -22,6 +26,146 @@ import Container.NamedVector;
 
 namespace ArtifactCore {
 
+namespace {
+
+// 一括適用の処理単位。スタック上の SoA バッファに収まる大きさにする
+constexpr size_t kLUTBlock = 64;
+
+inline float sanitizeUnit(float value) {
+    return std::clamp(std::isfinite(value) ? value : 0.0f, 0.0f, 1.0f);
+}
+
+// 格子参照の前計算（軸ごとのスケールとストライド）。各寸法は 2 以上
+struct LatticeKernel {
+    const float* data = nullptr;
+    int maxX = 0, maxY = 0, maxZ = 0;           // 下側格子点インデックスの上限（dim - 2）
+    float scaleX = 0, scaleY = 0, scaleZ = 0;   // dim - 1
+    size_t strideY = 0, strideZ = 0;            // float 単位
+
+    // 入力は [0, 1] にクランプ済み。上端では下側格子点を dim - 2 に留め、
+    // 小数部 1.0 で上側格子点を参照するため範囲外アクセスは起きない
+    void locate(const float* r, const float* g, const float* b, size_t n,
+                uint32_t* base, float* dx, float* dy, float* dz) const {
+        for (size_t i = 0; i < n; ++i) {
+            const float fx = r[i] * scaleX;
+            const float fy = g[i] * scaleY;
+            const float fz = b[i] * scaleZ;
+            const int x0 = std::min(static_cast<int>(fx), maxX);
+            const int y0 = std::min(static_cast<int>(fy), maxY);
+            const int z0 = std::min(static_cast<int>(fz), maxZ);
+            dx[i] = fx - static_cast<float>(x0);
+            dy[i] = fy - static_cast<float>(y0);
+            dz[i] = fz - static_cast<float>(z0);
+            base[i] = static_cast<uint32_t>(x0 * 3 + y0 * strideY + z0 * strideZ);
+        }
+    }
+
+    // 小数部を降順に並べた軸順に c000 から c111 まで 4 点をたどる。
+    // 6 通りの四面体を比較・選択だけで決め、分岐予測ミスを避ける
+    void tetrahedral(uint32_t base, float dx, float dy, float dz, float* out) const {
+        float f0 = dx, f1 = dy, f2 = dz;
+        size_t s0 = 3, s1 = strideY, s2 = strideZ;
+        const auto order = [](float& fa, float& fb, size_t& sa, size_t& sb) {
+            const bool swap = fa < fb;
+            const float fHigh = swap ? fb : fa;
+            const float fLow = swap ? fa : fb;
+            const size_t sHigh = swap ? sb : sa;
+            const size_t sLow = swap ? sa : sb;
+            fa = fHigh; fb = fLow; sa = sHigh; sb = sLow;
+        };
+        order(f0, f1, s0, s1);
+        order(f1, f2, s1, s2);
+        order(f0, f1, s0, s1);
+        
+        const float w0 = 1.0f - f0;
+        const float w1 = f0 - f1;
+        const float w2 = f1 - f2;
+        const float w3 = f2;
+        const float* c0 = data + base;
+        const float* c1 = c0 + s0;
+        const float* c2 = c1 + s1;
+        const float* c3 = c2 + s2;
+        for (int ch = 0; ch < 3; ++ch) {
+            out[ch] = w0 * c0[ch] + w1 * c1[ch] + w2 * c2[ch] + w3 * c3[ch];
+        }
+    }
+
+    void trilinear(uint32_t base, float dx, float dy, float dz, float* out) const {
+        const float* c000 = data + base;
+        const float* c100 = c000 + 3;
+        const float* c010 = c000 + strideY;
+        const float* c110 = c010 + 3;
+        const float* c001 = c000 + strideZ;
+        const float* c101 = c001 + 3;
+        const float* c011 = c001 + strideY;
+        const float* c111 = c011 + 3;
+        for (int ch = 0; ch < 3; ++ch) {
+            const float c00 = c000[ch] + (c100[ch] - c000[ch]) * dx;
+            const float c10 = c010[ch] + (c110[ch] - c010[ch]) * dx;
+            const float c01 = c001[ch] + (c101[ch] - c001[ch]) * dx;
+            const float c11 = c011[ch] + (c111[ch] - c011[ch]) * dx;
+            const float c0 = c00 + (c10 - c00) * dy;
+            const float c1 = c01 + (c11 - c01) * dy;
+            out[ch] = c0 + (c1 - c0) * dz;
+        }
+    }
+};
+
+// LUTShaper を参照用に展開したもの
+struct ShaperKernel {
+    float domainMin = 0.0f;
+    float invRange = 1.0f;
+    std::array<const float*, 3> curve {};
+    std::array<int, 3> curveSegments {};  // サンプル数 - 1（0 ならカーブなし）
+
+    explicit ShaperKernel(const LUTShaper& shaper) {
+        const float range = shaper.domainMax - shaper.domainMin;
+        domainMin = shaper.domainMin;
+        invRange = (std::isfinite(range) && range > 0.0f) ? 1.0f / range : 1.0f;
+        for (int ch = 0; ch < 3; ++ch) {
+            if (shaper.curves[ch].size() >= 2) {
+                curve[ch] = shaper.curves[ch].data();
+                curveSegments[ch] = static_cast<int>(shaper.curves[ch].size()) - 1;
+            }
+        }
+    }
+
+    void apply(int ch, float* values, size_t n) const {
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = sanitizeUnit((values[i] - domainMin) * invRange);
+        }
+        if (!curve[ch]) {
+            return;
+        }
+        const float* c = curve[ch];
+        const int segments = curveSegments[ch];
+        for (size_t i = 0; i < n; ++i) {
+            const float p = values[i] * static_cast<float>(segments);
+            const int i0 = std::min(static_cast<int>(p), segments - 1);
+            const float t = p - static_cast<float>(i0);
+            values[i] = sanitizeUnit(c[i0] + (c[i0 + 1] - c[i0]) * t);
+        }
+    }
+
+    // 格子座標 u を入力値へ戻す（焼き込み用）
+    float inverse(int ch, float u) const {
+        float t = u;
+        if (curve[ch]) {
+            const float* c = curve[ch];
+            const int segments = curveSegments[ch];
+            const float* hit = std::upper_bound(c, c + segments + 1, u);
+            const int i1 = std::clamp(static_cast<int>(hit - c), 1, segments);
+            const int i0 = i1 - 1;
+            const float span = c[i1] - c[i0];
+            const float frac = span > 0.0f ? std::clamp((u - c[i0]) / span, 0.0f, 1.0f) : 0.0f;
+            t = (static_cast<float>(i0) + frac) / static_cast<float>(segments);
+        }
+        return domainMin + t / invRange;
+    }
+};
+
+}
+
 // ============================================================================
 // ColorLUT::Impl
 // ============================================================================
@@ -35,67 +179,86 @@ public:
     std::vector<float> data;  // RGBRGB... の順で格納
     bool valid = false;
     QString errorMessage;
+    LUTInterpolation interpolation = LUTInterpolation::Trilinear;
+    LUTShaper shaper;
     
     // インデックス計算
     size_t index(int x, int y, int z) const {
         return static_cast<size_t>((z * size.dimY + y) * size.dimX + x) * 3;
     }
     
-    // 三線形補間
-    QVector3D trilinearInterpolation(float r, float g, float b) const {
-        // 0.0-1.0をLUTインデックスに変換
-        float fx = r * (size.dimX - 1);
-        float fy = g * (size.dimY - 1);
-        float fz = b * (size.dimZ - 1);
-        
-        int x0 = static_cast<int>(std::floor(fx));
-        int y0 = static_cast<int>(std::floor(fy));
-        int z0 = static_cast<int>(std::floor(fz));
-        
-        int x1 = std::min(x0 + 1, size.dimX - 1);
-        int y1 = std::min(y0 + 1, size.dimY - 1);
-        int z1 = std::min(z0 + 1, size.dimZ - 1);
-        
-        x0 = std::clamp(x0, 0, size.dimX - 1);
-        y0 = std::clamp(y0, 0, size.dimY - 1);
-        z0 = std::clamp(z0, 0, size.dimZ - 1);
+    bool canSample() const {
+        return valid && size.dimX >= 2 && size.dimY >= 2 && size.dimZ >= 2 &&
+               data.size() >= static_cast<size_t>(size.totalPoints()) * 3u;
+    }
+    
+    LatticeKernel kernel() const {
+        LatticeKernel k;
+        k.data = data.data();
+        k.maxX = size.dimX - 2;
+        k.maxY = size.dimY - 2;
+        k.maxZ = size.dimZ - 2;
+        k.scaleX = static_cast<float>(size.dimX - 1);
+        k.scaleY = static_cast<float>(size.dimY - 1);
+        k.scaleZ = static_cast<float>(size.dimZ - 1);
+        k.strideY = static_cast<size_t>(size.dimX) * 3u;
+        k.strideZ = static_cast<size_t>(size.dimX) * size.dimY * 3u;
+        return k;
+    }
+    
+    // SoA ブロック（n <= kLUTBlock）に適用。canSample() が前提。
+    // 正規化・シェーパー・格子位置計算はチャンネルごとの連続ループで行い
+    // 自動ベクトル化させ、格子点の参照と補間だけを画素ごとに行う
+    void applyBlock(const LatticeKernel& k, float* r, float* g, float* b, size_t n,
+                    bool useShaper) const {
+        if (useShaper && !shaper.isIdentity()) {
+            const ShaperKernel shaperKernel(shaper);
+            shaperKernel.apply(0, r, n);
+            shaperKernel.apply(1, g, n);
+            shaperKernel.apply(2, b, n);
+        } else {
+            for (size_t i = 0; i < n; ++i) r[i] = sanitizeUnit(r[i]);
+            for (size_t i = 0; i < n; ++i) g[i] = sanitizeUnit(g[i]);
+            for (size_t i = 0; i < n; ++i) b[i] = sanitizeUnit(b[i]);
+        }
         
-        float dx = fx - x0;
-        float dy = fy - y0;
-        float dz = fz - z0;
+        uint32_t base[kLUTBlock];
+        float dx[kLUTBlock], dy[kLUTBlock], dz[kLUTBlock];
+        k.locate(r, g, b, n, base, dx, dy, dz);
         
-        // 8点をサンプリング
-        auto getVal = [this](int x, int y, int z) -> QVector3D {
-            size_t idx = index(x, y, z);
-            if (idx + 2 < data.size()) {
-                return QVector3D(data[idx], data[idx + 1], data[idx + 2]);
+        float out[3];
+        if (interpolation == LUTInterpolation::Tetrahedral) {
+            for (size_t i = 0; i < n; ++i) {
+                k.tetrahedral(base[i], dx[i], dy[i], dz[i], out);
+                r[i] = out[0]; g[i] = out[1]; b[i] = out[2];
             }
-            return QVector3D(0, 0, 0);
-        };
-        
-        QVector3D c000 = getVal(x0, y0, z0);
-        QVector3D c100 = getVal(x1, y0, z0);
-        QVector3D c010 = getVal(x0, y1, z0);
-        QVector3D c110 = getVal(x1, y1, z0);
-        QVector3D c001 = getVal(x0, y0, z1);
-        QVector3D c101 = getVal(x1, y0, z1);
-        QVector3D c011 = getVal(x0, y1, z1);
-        QVector3D c111 = getVal(x1, y1, z1);
-        
-        // 三線形補間
-        auto lerp = [](const QVector3D& a, const QVector3D& b, float t) {
-            return a + (b - a) * t;
-        };
-        
-        QVector3D c00 = lerp(c000, c100, dx);
-        QVector3D c01 = lerp(c001, c101, dx);
-        QVector3D c10 = lerp(c010, c110, dx);
-        QVector3D c11 = lerp(c011, c111, dx);
-        
-        QVector3D c0 = lerp(c00, c10, dy);
-        QVector3D c1 = lerp(c01, c11, dy);
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                k.trilinear(base[i], dx[i], dy[i], dz[i], out);
+                r[i] = out[0]; g[i] = out[1]; b[i] = out[2];
+            }
+        }
         
-        return lerp(c0, c1, dz);
+        for (size_t i = 0; i < n; ++i) r[i] = sanitizeUnit(r[i]);
+        for (size_t i = 0; i < n; ++i) g[i] = sanitizeUnit(g[i]);
+        for (size_t i = 0; i < n; ++i) b[i] = sanitizeUnit(b[i]);
+    }
+    
+    void applyPlanar(float* r, float* g, float* b, size_t pixelCount) const {
+        const LatticeKernel k = kernel();
+        for (size_t offset = 0; offset < pixelCount; offset += kLUTBlock) {
+            const size_t n = std::min(kLUTBlock, pixelCount - offset);
+            applyBlock(k, r + offset, g + offset, b + offset, n, true);
+        }
+    }
+    
+    // 単一画素。useShaper = false なら格子座標として直接参照する
+    QVector3D sampleOne(float r, float g, float b, bool useShaper = true) const {
+        if (!canSample()) {
+            return QVector3D(0, 0, 0);
+        }
+        applyBlock(kernel(), &r, &g, &b, 1, useShaper);
+        return QVector3D(r, g, b);
     }
 };
 
@@ -164,6 +327,7 @@ bool ColorLUT::load(const QString& filePath) {
     impl_->valid = false;
     impl_->data.clear();
     impl_->errorMessage.clear();
+    impl_->shaper = {};
     
     // 拡張子でフォーマット判定
     QString ext = QFileInfo(filePath).suffix().toLower();
@@ -191,11 +355,30 @@ bool ColorLUT::loadFromCube(const QString& filePath) {
     
     impl_->format = LUTFormat::Cube;
     impl_->name = QFileInfo(filePath).baseName();
+    impl_->shaper = {};
     
     QTextStream in(&file);
     NamedVector<float> values;
     
     int dimX = 0, dimY = 0, dimZ = 0;
+    // Resolve 形式のシェーパー付き CUBE: 1D テーブルが 3D テーブルの前に並ぶ
+    int shaperSize = 0;
+    float shaperRange[2] = {0.0f, 1.0f};
+    float latticeRange[2] = {0.0f, 1.0f};
+    const auto parseRange = [](const QString& line, float range[2]) {
+        const QStringList parts = line.split(QRegularExpression("\\s+"), Qt::SkipEmptyParts);
+        bool okMin = false;
+        bool okMax = false;
+        const float minValue = parts.size() >= 3 ? parts[1].toFloat(&okMin) : 0.0f;
+        const float maxValue = parts.size() >= 3 ? parts[2].toFloat(&okMax) : 0.0f;
+        if (!okMin || !okMax || !std::isfinite(minValue) || !std::isfinite(maxValue) ||
+            !(maxValue > minValue)) {
+            return false;
+        }
+        range[0] = minValue;
+        range[1] = maxValue;
+        return true;
+    };
     
     while (!in.atEnd()) {
         QString line = in.readLine().trimmed();
@@ -217,8 +400,21 @@ bool ColorLUT::loadFromCube(const QString& filePath) {
             continue;
         }
         
-        if (line.startsWith("LUT_3D_INPUT_RANGE", Qt::CaseInsensitive)) {
-            // 範囲指定（今回は無視）
+        if (line.startsWith("LUT_1D_SIZE", Qt::CaseInsensitive)) {
+            QStringList parts = line.split(QRegularExpression("\\s+"));
+            if (parts.size() >= 2) {
+                shaperSize = parts[1].toInt();
+            }
+            continue;
+        }
+        
+        if (line.startsWith("LUT_3D_INPUT_RANGE", Qt::CaseInsensitive) ||
+            line.startsWith("LUT_1D_INPUT_RANGE", Qt::CaseInsensitive)) {
+            const bool is3D = line.startsWith("LUT_3D", Qt::CaseInsensitive);
+            if (!parseRange(line, is3D ? latticeRange : shaperRange)) {
+                impl_->errorMessage = "Invalid CUBE input range: " + line;
+                return false;
+            }
             continue;
         }
         
@@ -235,6 +431,35 @@ bool ColorLUT::loadFromCube(const QString& filePath) {
     
     file.close();
     
+    // 1D シェーパー部分を取り出す（3D テーブルなしの 1D LUT は扱わない）
+    LUTShaper shaper;
+    if (shaperSize != 0) {
+        const size_t shaperValues = static_cast<size_t>(shaperSize) * 3u;
+        const std::vector<float> all = values.toStdVector();
+        if (dimX <= 0 || shaperSize < 2 || shaperSize > 65536 || all.size() < shaperValues) {
+            impl_->data.clear();
+            impl_->errorMessage = "Unsupported or incomplete CUBE shaper";
+            return false;
+        }
+        // 1D の出力は 3D の入力範囲で格子座標へ正規化する
+        const float latticeScale = 1.0f / (latticeRange[1] - latticeRange[0]);
+        for (int ch = 0; ch < 3; ++ch) {
+            auto& curve = shaper.curves[ch];
+            curve.resize(static_cast<size_t>(shaperSize));
+            for (int i = 0; i < shaperSize; ++i) {
+                const float value = all[static_cast<size_t>(i) * 3u + ch];
+                curve[static_cast<size_t>(i)] = (value - latticeRange[0]) * latticeScale;
+            }
+        }
+        shaper.domainMin = shaperRange[0];
+        shaper.domainMax = shaperRange[1];
+        values = NamedVector<float>::fromStdVector(
+            values.name(), std::vector<float>(all.begin() + static_cast<std::ptrdiff_t>(shaperValues), all.end()));
+    } else {
+        shaper.domainMin = latticeRange[0];
+        shaper.domainMax = latticeRange[1];
+    }
+    
     // サイズ設定
     if (dimX > 0 && dimY > 0 && dimZ > 0) {
         impl_->size = {dimX, dimY, dimZ};
@@ -263,6 +488,7 @@ bool ColorLUT::loadFromCube(const QString& filePath) {
     
     // データコピー
     impl_->data = values.toStdVector();
+    impl_->shaper = shaper;
     impl_->valid = !impl_->data.empty();
     
     return impl_->valid;
@@ -511,7 +737,43 @@ bool ColorLUT::saveToCube(const QString& filePath) const {
     QTextStream out(&file);
     out << "TITLE \"" << impl_->name << "\"\n";
     out << "# Created by Artifact\n";
-    out << "LUT_3D_SIZE " << impl_->size.dimX << "\n";
+    
+    // シェーパーは Resolve 形式で書き出す。カーブがなければ入力範囲だけで表せる
+    const LUTShaper& shaper = impl_->shaper;
+    const bool hasCurves = !shaper.curves[0].empty() || !shaper.curves[1].empty() ||
+                           !shaper.curves[2].empty();
+    if (hasCurves) {
+        size_t shaperSize = 2;
+        for (const auto& curve : shaper.curves) {
+            shaperSize = std::max(shaperSize, curve.size());
+        }
+        out << "LUT_1D_SIZE " << shaperSize << "\n";
+        out << "LUT_1D_INPUT_RANGE " << shaper.domainMin << " " << shaper.domainMax << "\n";
+        out << "LUT_3D_SIZE " << impl_->size.dimX << "\n";
+        out << "\n";
+        // サンプル数の異なるチャンネルは線形補間でそろえ、空のチャンネルは恒等カーブにする
+        for (size_t i = 0; i < shaperSize; ++i) {
+            const float t = static_cast<float>(i) / static_cast<float>(shaperSize - 1);
+            float row[3];
+            for (int ch = 0; ch < 3; ++ch) {
+                const auto& curve = shaper.curves[ch];
+                if (curve.size() < 2) {
+                    row[ch] = t;
+                    continue;
+                }
+                const float p = t * static_cast<float>(curve.size() - 1);
+                const size_t i0 = std::min(static_cast<size_t>(p), curve.size() - 2);
+                const float frac = p - static_cast<float>(i0);
+                row[ch] = curve[i0] + (curve[i0 + 1] - curve[i0]) * frac;
+            }
+            out << row[0] << " " << row[1] << " " << row[2] << "\n";
+        }
+    } else {
+        out << "LUT_3D_SIZE " << impl_->size.dimX << "\n";
+        if (!shaper.isIdentity()) {
+            out << "LUT_3D_INPUT_RANGE " << shaper.domainMin << " " << shaper.domainMax << "\n";
+        }
+    }
     out << "\n";
     
     for (int z = 0; z < impl_->size.dimZ; ++z) {
@@ -568,39 +830,52 @@ QColor ColorLUT::apply(const QColor& color) const {
 void ColorLUT::apply(float& r, float& g, float& b) const {
     if (!impl_->valid) return;
     
-    // クランプ
-    r = std::clamp(std::isfinite(r) ? r : 0.0f, 0.0f, 1.0f);
-    g = std::clamp(std::isfinite(g) ? g : 0.0f, 0.0f, 1.0f);
-    b = std::clamp(std::isfinite(b) ? b : 0.0f, 0.0f, 1.0f);
-    
-    // 三線形補間でサンプリング
-    QVector3D result = impl_->trilinearInterpolation(r, g, b);
-    
-    r = std::clamp(std::isfinite(result.x()) ? result.x() : 0.0f, 0.0f, 1.0f);
-    g = std::clamp(std::isfinite(result.y()) ? result.y() : 0.0f, 0.0f, 1.0f);
-    b = std::clamp(std::isfinite(result.z()) ? result.z() : 0.0f, 0.0f, 1.0f);
+    if (!impl_->canSample()) {
+        r = g = b = 0.0f;
+        return;
+    }
+    impl_->applyBlock(impl_->kernel(), &r, &g, &b, 1, true);
 }
 
 QImage ColorLUT::applyToImage(const QImage& source) const {
     if (!impl_->valid) return source;
     
+    // float 画像はそのまま一括適用（8bit への量子化をしない）
+    if (source.format() == QImage::Format_RGBA32FPx4 ||
+        source.format() == QImage::Format_RGBX32FPx4) {
+        QImage result = source.copy();
+        for (int y = 0; y < result.height(); ++y) {
+            applyToSpan(reinterpret_cast<float*>(result.scanLine(y)),
+                        static_cast<size_t>(result.width()), 4);
+        }
+        return result;
+    }
+    
     QImage result = source.convertToFormat(QImage::Format_ARGB32);
     
+    const size_t width = static_cast<size_t>(result.width());
+    std::vector<float> planes(width * 3u);
+    float* red = planes.data();
+    float* green = red + width;
+    float* blue = green + width;
+    
     auto* resultBits = result.bits();
     const int resultStride = result.bytesPerLine();
     for (int y = 0; y < result.height(); ++y) {
         QRgb* line = reinterpret_cast<QRgb*>(resultBits + y * resultStride);
-        for (int x = 0; x < result.width(); ++x) {
-            float r = qRed(line[x]) / 255.0f;
-            float g = qGreen(line[x]) / 255.0f;
-            float b = qBlue(line[x]) / 255.0f;
+        for (size_t x = 0; x < width; ++x) {
+            red[x] = qRed(line[x]) / 255.0f;
+            green[x] = qGreen(line[x]) / 255.0f;
+            blue[x] = qBlue(line[x]) / 255.0f;
+        }
 
-            apply(r, g, b);
+        applyToSpan(red, green, blue, width);
 
+        for (size_t x = 0; x < width; ++x) {
             line[x] = qRgba(
-                static_cast<int>(r * 255),
-                static_cast<int>(g * 255),
-                static_cast<int>(b * 255),
+                static_cast<int>(red[x] * 255),
+                static_cast<int>(green[x] * 255),
+                static_cast<int>(blue[x] * 255),
                 qAlpha(line[x]));
         }
     }
@@ -608,6 +883,79 @@ QImage ColorLUT::applyToImage(const QImage& source) const {
     return result;
 }
 
+void ColorLUT::applyToSpan(float* pixels, size_t pixelCount, int channels) const {
+    if (!impl_->valid || !pixels || channels < 3) return;
+    
+    if (!impl_->canSample()) {
+        for (size_t i = 0; i < pixelCount; ++i) {
+            float* px = pixels + i * static_cast<size_t>(channels);
+            px[0] = px[1] = px[2] = 0.0f;
+        }
+        return;
+    }
+    
+    // ブロック単位でプレーナに並べ替えてから処理する
+    const LatticeKernel k = impl_->kernel();
+    const size_t stride = static_cast<size_t>(channels);
+    float r[kLUTBlock], g[kLUTBlock], b[kLUTBlock];
+    for (size_t offset = 0; offset < pixelCount; offset += kLUTBlock) {
+        const size_t n = std::min(kLUTBlock, pixelCount - offset);
+        float* block = pixels + offset * stride;
+        for (size_t i = 0; i < n; ++i) {
+            r[i] = block[i * stride];
+            g[i] = block[i * stride + 1];
+            b[i] = block[i * stride + 2];
+        }
+        impl_->applyBlock(k, r, g, b, n, true);
+        for (size_t i = 0; i < n; ++i) {
+            block[i * stride] = r[i];
+            block[i * stride + 1] = g[i];
+            block[i * stride + 2] = b[i];
+        }
+    }
+}
+
+void ColorLUT::applyToSpan(float* r, float* g, float* b, size_t pixelCount) const {
+    if (!impl_->valid || !r || !g || !b) return;
+    
+    if (!impl_->canSample()) {
+        std::fill(r, r + pixelCount, 0.0f);
+        std::fill(g, g + pixelCount, 0.0f);
+        std::fill(b, b + pixelCount, 0.0f);
+        return;
+    }
+    impl_->applyPlanar(r, g, b, pixelCount);
+}
+
+LUTInterpolation ColorLUT::interpolation() const { return impl_->interpolation; }
+void ColorLUT::setInterpolation(LUTInterpolation interpolation) { impl_->interpolation = interpolation; }
+
+const LUTShaper& ColorLUT::shaper() const { return impl_->shaper; }
+void ColorLUT::setShaper(const LUTShaper& shaper) { impl_->shaper = shaper; }
+
+LUTShaper LUTShaper::fromFunction(const std::function<float(float)>& fn,
+                                  float domainMin, float domainMax, int samples) {
+    LUTShaper shaper;
+    shaper.domainMin = domainMin;
+    shaper.domainMax = domainMax;
+    if (!fn || samples < 2) {
+        return shaper;
+    }
+    
+    std::vector<float> curve(static_cast<size_t>(samples));
+    const float range = domainMax - domainMin;
+    float previous = 0.0f;
+    for (int i = 0; i < samples; ++i) {
+        const float t = i / float(samples - 1);
+        // 逆変換（焼き込み）のため単調非減少に揃える
+        const float value = std::max(sanitizeUnit(fn(domainMin + t * range)), previous);
+        curve[static_cast<size_t>(i)] = value;
+        previous = value;
+    }
+    shaper.curves = {curve, curve, curve};
+    return shaper;
+}
+
 QColor ColorLUT::applyWithIntensity(const QColor& color, float intensity) const {
     QColor original = color;
     QColor transformed = apply(color);
@@ -658,29 +1006,52 @@ ColorLUT ColorLUT::createIdentity(int size) {
 ColorLUT ColorLUT::combine(const ColorLUT& other) const {
     if (!impl_->valid || !other.isValid()) return *this;
     
-    ColorLUT result = createIdentity(impl_->size.dimX);
-    
-    for (int z = 0; z < result.impl_->size.dimZ; ++z) {
-        for (int y = 0; y < result.impl_->size.dimY; ++y) {
-            for (int x = 0; x < result.impl_->size.dimX; ++x) {
-                size_t idx = result.impl_->index(x, y, z);
-
-                float r = impl_->data[idx];
-                float g = impl_->data[idx + 1];
-                float b = impl_->data[idx + 2];
-
-                QVector3D v1 = impl_->trilinearInterpolation(
-                    x / float(result.impl_->size.dimX - 1),
-                    y / float(result.impl_->size.dimY - 1),
-                    z / float(result.impl_->size.dimZ - 1)
-                );
-
-                float r2 = v1.x(), g2 = v1.y(), b2 = v1.z();
-                other.apply(r2, g2, b2);
+    return bake({LUTBakeStage::fromLUT(*this), LUTBakeStage::fromLUT(other)},
+                impl_->size.dimX, impl_->shaper);
+}
 
-                result.impl_->data[idx] = r2;
-                result.impl_->data[idx + 1] = g2;
-                result.impl_->data[idx + 2] = b2;
+ColorLUT ColorLUT::bake(const std::vector<LUTBakeStage>& stages, int size,
+                        const LUTShaper& shaper) {
+    ColorLUT result = createIdentity(size);
+    result.impl_->name = QStringLiteral("Baked");
+    result.impl_->shaper = shaper;
+    
+    const int dim = result.impl_->size.dimX;
+    const ShaperKernel shaperKernel(shaper);
+    std::vector<float> domain(static_cast<size_t>(dim) * 3u);
+    for (int i = 0; i < dim; ++i) {
+        const float u = i / float(dim - 1);
+        for (int ch = 0; ch < 3; ++ch) {
+            domain[static_cast<size_t>(ch) * dim + i] = shaperKernel.inverse(ch, u);
+        }
+    }
+    
+    // 1 行（x 方向）ずつプレーナで各ステージに通す
+    std::vector<float> row(static_cast<size_t>(dim) * 3u);
+    float* r = row.data();
+    float* g = r + dim;
+    float* b = g + dim;
+    for (int z = 0; z < dim; ++z) {
+        for (int y = 0; y < dim; ++y) {
+            for (int x = 0; x < dim; ++x) {
+                r[x] = domain[static_cast<size_t>(x)];
+                g[x] = domain[static_cast<size_t>(dim) + y];
+                b[x] = domain[static_cast<size_t>(dim) * 2u + z];
+            }
+            for (const auto& stage : stages) {
+                if (stage.lut) {
+                    stage.lut->applyToSpan(r, g, b, static_cast<size_t>(dim));
+                } else if (stage.transform) {
+                    for (int x = 0; x < dim; ++x) {
+                        stage.transform(r[x], g[x], b[x]);
+                    }
+                }
+            }
+            float* out = result.impl_->data.data() + result.impl_->index(0, y, z);
+            for (int x = 0; x < dim; ++x) {
+                out[x * 3] = sanitizeUnit(r[x]);
+                out[x * 3 + 1] = sanitizeUnit(g[x]);
+                out[x * 3 + 2] = sanitizeUnit(b[x]);
             }
         }
     }
@@ -692,11 +1063,25 @@ ColorLUT ColorLUT::withIntensity(float intensity) const {
     if (!impl_->valid) return *this;
     intensity = std::isfinite(intensity) ? std::clamp(intensity, 0.0f, 1.0f) : 1.0f;
     ColorLUT result = *this;
-    ColorLUT identity = createIdentity(impl_->size.dimX);
     
-    for (size_t i = 0; i < result.impl_->data.size(); ++i) {
-        result.impl_->data[i] = identity.impl_->data[i] * (1.0f - intensity) +
-                                result.impl_->data[i] * intensity;
+    // 単位変換の値はシェーパーを戻した入力値（シェーパーなしなら格子座標そのもの）
+    const ShaperKernel shaperKernel(impl_->shaper);
+    const LUTSize& size = impl_->size;
+    for (int z = 0; z < size.dimZ; ++z) {
+        for (int y = 0; y < size.dimY; ++y) {
+            for (int x = 0; x < size.dimX; ++x) {
+                const size_t idx = impl_->index(x, y, z);
+                if (idx + 2 >= result.impl_->data.size()) continue;
+                const float identity[3] = {
+                    sanitizeUnit(shaperKernel.inverse(0, x / float(size.dimX - 1))),
+                    sanitizeUnit(shaperKernel.inverse(1, y / float(size.dimY - 1))),
+                    sanitizeUnit(shaperKernel.inverse(2, z / float(size.dimZ - 1)))};
+                for (int ch = 0; ch < 3; ++ch) {
+                    float& value = result.impl_->data[idx + ch];
+                    value = identity[ch] * (1.0f - intensity) + value * intensity;
+                }
+            }
+        }
     }
     
     return result;
@@ -720,8 +1105,8 @@ ColorLUT ColorLUT::inverted() const {
                     z / float(result.impl_->size.dimZ - 1));
                 QVector3D candidate = target;
                 for (int iteration = 0; iteration < 8; ++iteration) {
-                    const QVector3D mapped = impl_->trilinearInterpolation(
-                        candidate.x(), candidate.y(), candidate.z());
+                    const QVector3D mapped = impl_->sampleOne(
+                        candidate.x(), candidate.y(), candidate.z(), false);
                     candidate += target - mapped;
                     candidate.setX(std::clamp(candidate.x(), 0.0f, 1.0f));
                     candidate.setY(std::clamp(candidate.y(), 0.0f, 1.0f));
@@ -771,18 +1156,10 @@ float* ColorLUT::rawData() { return impl_->data.data(); }
 size_t ColorLUT::dataSize() const { return impl_->data.size() * sizeof(float); }
 
 QVector3D ColorLUT::sample(float r, float g, float b) const {
-    if (!impl_->valid || impl_->size.dimX < 2 || impl_->size.dimY < 2 ||
-        impl_->size.dimZ < 2) {
+    if (!impl_->canSample()) {
         return QVector3D();
     }
-    const auto safe = [](float value) {
-        return std::clamp(std::isfinite(value) ? value : 0.0f, 0.0f, 1.0f);
-    };
-    const QVector3D result = impl_->trilinearInterpolation(safe(r), safe(g), safe(b));
-    return QVector3D(
-        std::clamp(std::isfinite(result.x()) ? result.x() : 0.0f, 0.0f, 1.0f),
-        std::clamp(std::isfinite(result.y()) ? result.y() : 0.0f, 0.0f, 1.0f),
-        std::clamp(std::isfinite(result.z()) ? result.z() : 0.0f, 0.0f, 1.0f));
+    return impl_->sampleOne(r, g, b);
 }
 
 // ============================================================================
@@ -0,0 +1,169 @@
+module;
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+export module Core.ArtifactHashMap.Test;
+
+import Core.ArtifactHashMap;
+
+namespace ArtifactCore::HashMapTest {
+
+bool insertFindEraseContractTest()
+{
+  ArtifactHashMap<int, int> map;
+  for (int i = 0; i < 1000; ++i) {
+    if (!map.tryEmplace(i, i * 3).second) return false;
+  }
+  if (map.tryEmplace(7, -1).second || map.at(7) != 21 || map.size() != 1000) return false;
+
+  for (int i = 0; i < 1000; i += 2) {
+    if (map.erase(i) != 1) return false;
+  }
+  if (map.erase(0) != 0 || map.size() != 500) return false;
+
+  std::size_t visited = 0;
+  for (const auto& [key, value] : map) {
+    if (key % 2 == 0 || value != key * 3) return false;
+    ++visited;
+  }
+  for (int i = 0; i < 1000; ++i) {
+    if (map.contains(i) != (i % 2 == 1)) return false;
+  }
+  map.insertOrAssign(1, 100);
+  return visited == 500 && map.at(1) == 100 && map.find(2) == map.end();
+}
+
+// Insert/erase churn leaves tombstones behind. They must be reclaimed in
+// place instead of growing the table, and must never hide a live key.
+bool tombstoneChurnContractTest()
+{
+  ArtifactHashMap<std::uint64_t, std::uint64_t> map;
+  map.reserve(64);
+  const std::size_t capacity = map.capacity();
+  std::uint64_t next = 0;
+  std::vector<std::uint64_t> live;
+  for (int round = 0; round < 20000; ++round) {
+    live.push_back(next);
+    map[next] = next ^ 0x5a5a5a5aull;
+    ++next;
+    if (live.size() > 40) {
+      if (map.erase(live.front()) != 1) return false;
+      live.erase(live.begin());
+    }
+  }
+  if (map.capacity() != capacity || map.size() != live.size()) return false;
+  for (const std::uint64_t key : live) {
+    const auto it = map.find(key);
+    if (it == map.end() || it->second != (key ^ 0x5a5a5a5aull)) return false;
+  }
+  return !map.contains(live.front() - 1);
+}
+
+// Growth, explicit rehash, copy and move keep every element, and a
+// non-trivial value type is destroyed exactly once.
+bool rehashContractTest()
+{
+  auto alive = std::make_shared<int>(0);
+  struct Tracked {
+    std::shared_ptr<int> counter;
+    int value = 0;
+    Tracked(std::shared_ptr<int> c, int v) : counter(std::move(c)), value(v) { ++*counter; }
+    Tracked(Tracked&& other) noexcept : counter(other.counter), value(other.value) { ++*counter; }
+    Tracked(const Tracked& other) : counter(other.counter), value(other.value) { ++*counter; }
+    ~Tracked() { --*counter; }
+  };
+  {
+    ArtifactHashMap<std::string, Tracked> map;
+    for (int i = 0; i < 5000; ++i) {
+      map.tryEmplace("layer/property_" + std::to_string(i), alive, i);
+    }
+    if (map.load_factor() > 0.875f || *alive != 5000) return false;
+    for (int i = 0; i < 5000; i += 3) map.erase("layer/property_" + std::to_string(i));
+    map.rehash(0);
+    const auto shrunk = map.capacity();
+    map.rehash(100000);
+    if (map.capacity() <= shrunk) return false;
+
+    ArtifactHashMap<std::string, Tracked> copy(map);
+    ArtifactHashMap<std::string, Tracked> moved(std::move(copy));
+    if (!copy.empty() || moved.size() != map.size() || *alive != static_cast<int>(map.size() * 2)) {
+      return false;
+    }
+    for (int i = 0; i < 5000; ++i) {
+      const auto it = moved.find("layer/property_" + std::to_string(i));
+      if ((i % 3 == 0) != (it == moved.end())) return false;
+      if (it != moved.end() && it->second.value != i) return false;
+    }
+    map.clear();
+    if (!map.empty() || *alive != static_cast<int>(moved.size())) return false;
+  }
+  return *alive == 0;
+}
+
+bool transparentLookupContractTest()
+{
+  ArtifactHashMap<std::string, int, ArtifactTransparentHash> map;
+  map["opacity"] = 1;
+  map["position"] = 2;
+  const std::string_view key = "position";
+  return map.contains(key) && map.find(key)->second == 2 &&
+         !map.contains(std::string_view("scale")) && map.erase(std::string_view("opacity")) == 1 &&
+         map.size() == 1;
+}
+
+// Randomized insert/erase/lookup against std::unordered_map.
+bool referenceModelContractTest()
+{
+  ArtifactHashMap<std::uint32_t, std::uint32_t> map;
+  std::unordered_map<std::uint32_t, std::uint32_t> reference;
+  std::uint64_t state = 0x9E3779B97F4A7C15ull;
+  const auto random = [&state]() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return static_cast<std::uint32_t>(state);
+  };
+  for (int step = 0; step < 200000; ++step) {
+    const std::uint32_t key = random() % 4096;
+    switch (random() % 3) {
+    case 0:
+      map[key] = static_cast<std::uint32_t>(step);
+      reference[key] = static_cast<std::uint32_t>(step);
+      break;
+    case 1:
+      if (map.erase(key) != reference.erase(key)) return false;
+      break;
+    default: {
+      const auto it = map.find(key);
+      const auto expected = reference.find(key);
+      if ((it == map.end()) != (expected == reference.end())) return false;
+      if (it != map.end() && it->second != expected->second) return false;
+    }
+    }
+  }
+  std::size_t visited = 0;
+  for (const auto& [key, value] : map) {
+    const auto expected = reference.find(key);
+    if (expected == reference.end() || expected->second != value) return false;
+    ++visited;
+  }
+  return visited == reference.size() && map.size() == reference.size();
+}
+
+export bool runAllArtifactHashMapTests()
+{
+  return insertFindEraseContractTest() &&
+         tombstoneChurnContractTest() &&
+         rehashContractTest() &&
+         transparentLookupContractTest() &&
+         referenceModelContractTest();
+}
+
+} // namespace ArtifactCore::HashMapTest
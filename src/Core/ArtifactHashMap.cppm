@@ -1,20 +1,58 @@
 module;
 
-#include <algorithm>
+#include <bit>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iterator>
-#include <list>
-#include <mutex>
+#include <new>
 #include <stdexcept>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARTIFACT_HASHMAP_SSE2 1
+#endif
+
 export module Core.ArtifactHashMap;
 
-namespace ArtifactCore {
+export namespace ArtifactCore {
+
+// 既定のハッシュ。std::hash があればそれを、無ければ ADL で qHash (Id 系など) を使う。
+template<typename K>
+struct ArtifactHash {
+    std::size_t operator()(const K& key) const {
+        if constexpr (requires(const K& k) { std::hash<K>{}(k); }) {
+            return std::hash<K>{}(key);
+        } else {
+            return static_cast<std::size_t>(qHash(key, 0u));
+        }
+    }
+};
+
+// 異種キー検索用。QString と QStringView、std::string と std::string_view のように
+// 同じ値に同じハッシュを返す型同士で find / contains / erase できる。
+struct ArtifactTransparentHash {
+    using is_transparent = void;
+
+    template<typename Q>
+    std::size_t operator()(const Q& key) const {
+        if constexpr (requires(const Q& q) { qHash(q, 0u); }) {
+            return static_cast<std::size_t>(qHash(key, 0u));
+        } else {
+            return std::hash<Q>{}(key);
+        }
+    }
+};
 
-template<typename K, typename V, typename Hasher = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+// SwissTable 方式のオープンアドレス法ハッシュマップ。
+// 16 スロットを 1 グループとし、制御バイト (空 / 削除済み / ハッシュ下位 7bit) を
+// SSE2 で一括比較してから要素を比較する。要素は連続したスロット配列に直接置く。
+// 最大負荷率は 7/8。reserve(n) 後は n 要素まで再ハッシュしない。
+template<typename K, typename V, typename Hasher = ArtifactHash<K>, typename KeyEqual = std::equal_to<>>
 class ArtifactHashMap {
 public:
     using key_type = K;
@@ -24,304 +62,532 @@ public:
     using difference_type = ptrdiff_t;
     using hasher = Hasher;
     using key_equal = KeyEqual;
-    
+
 private:
-    static constexpr size_type kInitialBucketCount = 16;
-    static constexpr float kMaxLoadFactor = 0.75f;
-    
-    struct Node {
-        value_type data;
-        size_type hash;
-        Node* next;
-        
-        template<typename... Args>
-        explicit Node(size_type h, Args&&... args) 
-            : data(std::forward<Args>(args)...), hash(h), next(nullptr) {}
+    using ctrl_t = std::int8_t;
+
+    static constexpr ctrl_t kEmpty = -128;
+    static constexpr ctrl_t kDeleted = -2;
+    static constexpr ctrl_t kSentinel = -1;
+    static constexpr size_type kGroupWidth = 16;
+    static constexpr size_type kSlotAlign = alignof(value_type) > kGroupWidth ? alignof(value_type) : kGroupWidth;
+
+    static constexpr bool kTransparent = requires {
+        typename Hasher::is_transparent;
+        typename KeyEqual::is_transparent;
     };
-    
-    std::unique_ptr<Node*[]> buckets_;
-    size_type bucketCount_;
-    size_type size_;
+
+    struct Group {
+#if defined(ARTIFACT_HASHMAP_SSE2)
+        __m128i ctrl;
+
+        explicit Group(const ctrl_t* pos) noexcept
+            : ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(pos))) {}
+
+        std::uint32_t match(ctrl_t h2) const noexcept {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+        }
+
+        std::uint32_t matchEmpty() const noexcept { return match(kEmpty); }
+
+        // 空と削除済みは符号ビットが立っている (番兵はグループに入らない)。
+        std::uint32_t matchEmptyOrDeleted() const noexcept {
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+        }
+#else
+        const ctrl_t* ctrl;
+
+        explicit Group(const ctrl_t* pos) noexcept : ctrl(pos) {}
+
+        std::uint32_t match(ctrl_t h2) const noexcept {
+            std::uint32_t mask = 0;
+            for (size_type i = 0; i < kGroupWidth; ++i) {
+                mask |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+            }
+            return mask;
+        }
+
+        std::uint32_t matchEmpty() const noexcept { return match(kEmpty); }
+
+        std::uint32_t matchEmptyOrDeleted() const noexcept {
+            std::uint32_t mask = 0;
+            for (size_type i = 0; i < kGroupWidth; ++i) {
+                mask |= static_cast<std::uint32_t>(ctrl[i] < 0) << i;
+            }
+            return mask;
+        }
+#endif
+    };
+
+    // グループ単位の三角数プロービング。グループ数が 2 の冪なので全グループを一巡する。
+    struct ProbeSeq {
+        size_type mask;
+        size_type group;
+        size_type step = 0;
+
+        ProbeSeq(size_type hash1, size_type groupMask) noexcept : mask(groupMask), group(hash1 & groupMask) {}
+
+        size_type offset() const noexcept { return group * kGroupWidth; }
+
+        void next() noexcept {
+            ++step;
+            group = (group + step) & mask;
+        }
+    };
+
+    ctrl_t* ctrl_ = nullptr;
+    value_type* slots_ = nullptr;
+    size_type capacity_ = 0;
+    size_type size_ = 0;
+    size_type growthLeft_ = 0;
     hasher hasher_;
     key_equal keyEqual_;
-    
-public:
-    class iterator {
+
+    template<bool Const>
+    class IteratorBase {
     public:
         using iterator_category = std::forward_iterator_tag;
         using value_type = typename ArtifactHashMap::value_type;
         using difference_type = typename ArtifactHashMap::difference_type;
-        using pointer = typename ArtifactHashMap::value_type*;
-        using reference = typename ArtifactHashMap::value_type&;
-        
-        iterator() noexcept : node_(nullptr), bucketsEnd_(nullptr) {}
-        
-        iterator(Node* node, Node** current, Node** end) 
-            : node_(node), currentBucket_(current), bucketsEnd_(end) {}
-        
-        reference operator*() const noexcept { return node_->data; }
-        pointer operator->() const noexcept { return &node_->data; }
-        
-        iterator& operator++() {
-            ++currentBucket_;
-            advanceToNext();
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+        IteratorBase() noexcept = default;
+
+        template<bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+        IteratorBase(const IteratorBase<OtherConst>& other) noexcept
+            : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+        reference operator*() const noexcept { return *slot_; }
+        pointer operator->() const noexcept { return slot_; }
+
+        IteratorBase& operator++() noexcept {
+            ++ctrl_;
+            ++slot_;
+            skipEmpty();
             return *this;
         }
-        
-        iterator operator++(int) {
-            iterator tmp = *this;
+
+        IteratorBase operator++(int) noexcept {
+            IteratorBase tmp = *this;
             ++(*this);
             return tmp;
         }
-        
-        bool operator==(const iterator& other) const noexcept {
-            return node_ == other.node_ && currentBucket_ == other.currentBucket_;
-        }
-        
-        bool operator!=(const iterator& other) const noexcept {
-            return !(*this == other);
+
+        template<bool OtherConst>
+        bool operator==(const IteratorBase<OtherConst>& other) const noexcept {
+            return ctrl_ == other.ctrl_;
         }
-        
+
     private:
-        Node* node_;
-        Node** currentBucket_;
-        Node** bucketsEnd_;
-        
-        void advanceToNext() {
-            while (currentBucket_ != bucketsEnd_) {
-                if (*currentBucket_ != nullptr) {
-                    node_ = *currentBucket_;
-                    return;
-                }
-                ++currentBucket_;
+        friend class ArtifactHashMap;
+        template<bool> friend class IteratorBase;
+
+        IteratorBase(const ctrl_t* ctrl, value_type* slot) noexcept
+            : ctrl_(ctrl), slot_(slot) {}
+
+        void skipEmpty() noexcept {
+            while (*ctrl_ < 0 && *ctrl_ != kSentinel) {
+                ++ctrl_;
+                ++slot_;
             }
-            node_ = nullptr;
         }
-        
-        friend class ArtifactHashMap;
+
+        const ctrl_t* ctrl_ = nullptr;
+        value_type* slot_ = nullptr;
     };
-    
-    ArtifactHashMap() : bucketCount_(kInitialBucketCount), size_(0) {
-        buckets_ = std::make_unique<Node*[]>(bucketCount_);
-        for (size_type i = 0; i < bucketCount_; ++i) {
-            buckets_[i] = nullptr;
-        }
+
+public:
+    using iterator = IteratorBase<false>;
+    using const_iterator = IteratorBase<true>;
+
+    ArtifactHashMap() noexcept = default;
+
+    explicit ArtifactHashMap(size_type bucketCount) {
+        reserve(bucketCount);
+    }
+
+    ~ArtifactHashMap() {
+        destroyAll();
+        deallocate(ctrl_, capacity_);
     }
-    
-    ArtifactHashMap(size_type bucketCount) : bucketCount_(bucketCount), size_(0) {
-        buckets_ = std::make_unique<Node*[]>(bucketCount_);
-        for (size_type i = 0; i < bucketCount_; ++i) {
-            buckets_[i] = nullptr;
+
+    ArtifactHashMap(const ArtifactHashMap& other)
+        : hasher_(other.hasher_), keyEqual_(other.keyEqual_) {
+        reserve(other.size_);
+        for (const auto& value : other) {
+            const size_type hash = hashOf(value.first);
+            const size_type index = findInsertSlot(hash);
+            ::new (static_cast<void*>(slots_ + index)) value_type(value);
+            setCtrl(index, hash2(hash));
+            --growthLeft_;
+            ++size_;
         }
     }
-    
-    ~ArtifactHashMap() {
-        clear();
+
+    ArtifactHashMap& operator=(const ArtifactHashMap& other) {
+        if (this != &other) {
+            ArtifactHashMap copy(other);
+            swap(copy);
+        }
+        return *this;
     }
-    
-    ArtifactHashMap(const ArtifactHashMap&) = delete;
-    ArtifactHashMap& operator=(const ArtifactHashMap&) = delete;
-    
+
     ArtifactHashMap(ArtifactHashMap&& other) noexcept
-        : buckets_(std::move(other.buckets_)), 
-          bucketCount_(other.bucketCount_), 
-          size_(other.size_),
+        : ctrl_(std::exchange(other.ctrl_, nullptr)),
+          slots_(std::exchange(other.slots_, nullptr)),
+          capacity_(std::exchange(other.capacity_, 0)),
+          size_(std::exchange(other.size_, 0)),
+          growthLeft_(std::exchange(other.growthLeft_, 0)),
           hasher_(std::move(other.hasher_)),
-          keyEqual_(std::move(other.keyEqual_)) {
-        other.bucketCount_ = kInitialBucketCount;
-        other.size_ = 0;
-    }
-    
+          keyEqual_(std::move(other.keyEqual_)) {}
+
     ArtifactHashMap& operator=(ArtifactHashMap&& other) noexcept {
-        clear();
-        buckets_ = std::move(other.buckets_);
-        bucketCount_ = other.bucketCount_;
-        size_ = other.size_;
-        hasher_ = std::move(other.hasher_);
-        keyEqual_ = std::move(other.keyEqual_);
-        other.bucketCount_ = kInitialBucketCount;
-        other.size_ = 0;
+        if (this != &other) {
+            ArtifactHashMap moved(std::move(other));
+            swap(moved);
+        }
         return *this;
     }
-    
+
+    void swap(ArtifactHashMap& other) noexcept {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growthLeft_, other.growthLeft_);
+        swap(hasher_, other.hasher_);
+        swap(keyEqual_, other.keyEqual_);
+    }
+
     iterator begin() noexcept {
-        Node** bucket = buckets_.get();
-        Node** end = bucket + bucketCount_;
-        
-        Node** first = bucket;
-        while (first != end && *first == nullptr) ++first;
-        
-        iterator it;
-        if (first != end) {
-            it = iterator(*first, first, end);
-        } else {
-            it = iterator(nullptr, end, end);
-        }
+        if (size_ == 0) return end();
+        iterator it(ctrl_, slots_);
+        it.skipEmpty();
         return it;
     }
-    
+
     iterator end() noexcept {
-        return iterator(nullptr, buckets_.get() + bucketCount_, buckets_.get() + bucketCount_);
+        return iterator(ctrl_ + capacity_, slots_ + capacity_);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_cast<ArtifactHashMap*>(this)->begin();
+    }
+
+    const_iterator end() const noexcept {
+        return const_cast<ArtifactHashMap*>(this)->end();
     }
-    
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
     size_type size() const noexcept { return size_; }
     bool empty() const noexcept { return size_ == 0; }
-    size_type bucket_count() const noexcept { return bucketCount_; }
-    
+    size_type bucket_count() const noexcept { return capacity_; }
+    size_type capacity() const noexcept { return capacity_; }
+
+    float load_factor() const noexcept {
+        return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_);
+    }
+
+    // count 要素まで再ハッシュなしで挿入できる容量を一度に確保する。
+    void reserve(size_type count) {
+        if (count > size_ + growthLeft_) {
+            resize(capacityFor(count));
+        }
+    }
+
+    // 0 を渡すと現在の要素数に見合う最小容量へ詰める。
+    void rehash(size_type count) {
+        const size_type target = capacityFor(count > size_ ? count : size_);
+        if (size_ == 0 && count == 0) {
+            destroyAll();
+            deallocate(ctrl_, capacity_);
+            ctrl_ = nullptr;
+            slots_ = nullptr;
+            capacity_ = 0;
+            growthLeft_ = 0;
+        } else if (target != capacity_) {
+            resize(target);
+        }
+    }
+
     V& operator[](const K& key) {
         return tryEmplace(key).first->second;
     }
-    
-    V& at(const K& key) {
-        Node* node = findNode(key);
-        if (!node) throw std::out_of_range("ArtifactHashMap::at");
-        return node->data.second;
-    }
-    
-    const V& at(const K& key) const {
-        const Node* node = findNode(key);
-        if (!node) throw std::out_of_range("ArtifactHashMap::at");
-        return node->data.second;
+
+    V& operator[](K&& key) {
+        return tryEmplace(std::move(key)).first->second;
     }
-    
-    std::pair<iterator, bool> tryEmplace(const K& key, const V& value) {
-        return emplaceImpl(key, value);
+
+    template<typename Q>
+    V& at(const Q& key) {
+        const size_type index = lookup(key);
+        if (index == capacity_) throw std::out_of_range("ArtifactHashMap::at");
+        return slots_[index].second;
     }
-    
-    std::pair<iterator, bool> tryEmplace(const K& key, V&& value) {
-        return emplaceImpl(key, std::move(value));
+
+    template<typename Q>
+    const V& at(const Q& key) const {
+        const size_type index = lookup(key);
+        if (index == capacity_) throw std::out_of_range("ArtifactHashMap::at");
+        return slots_[index].second;
     }
-    
+
+    // 既にキーがあれば何もしない (値を上書きしない)。
     template<typename... Args>
     std::pair<iterator, bool> tryEmplace(const K& key, Args&&... args) {
-        return emplaceImpl(key, V(std::forward<Args>(args)...));
+        return emplaceKey(key, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> tryEmplace(K&& key, Args&&... args) {
+        return emplaceKey(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        return emplaceKey(key, std::forward<Args>(args)...);
+    }
+
+    template<typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+        return emplaceKey(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template<typename M>
+    std::pair<iterator, bool> insertOrAssign(const K& key, M&& value) {
+        auto result = emplaceKey(key, std::forward<M>(value));
+        if (!result.second) result.first->second = std::forward<M>(value);
+        return result;
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value) {
+        return emplaceKey(value.first, value.second);
     }
-    
+
+    std::pair<iterator, bool> insert(value_type&& value) {
+        return emplaceKey(value.first, std::move(value.second));
+    }
+
     template<typename... Args>
     std::pair<iterator, bool> emplace(Args&&... args) {
-        return emplaceImpl(std::forward<Args>(args)...);
-    }
-    
-    size_type erase(const K& key) {
-        const size_type hash = hasher_(key);
-        const size_type bucketIdx = hash % bucketCount_;
-        
-        Node* prev = nullptr;
-        Node* curr = buckets_[bucketIdx];
-        
-        while (curr) {
-            if (curr->hash == hash && keyEqual_(curr->data.first, key)) {
-                if (prev) {
-                    prev->next = curr->next;
-                } else {
-                    buckets_[bucketIdx] = curr->next;
-                }
-                delete curr;
-                --size_;
-                return 1;
-            }
-            prev = curr;
-            curr = curr->next;
-        }
-        return 0;
+        value_type value(std::forward<Args>(args)...);
+        return emplaceKey(value.first, std::move(value.second));
     }
-    
+
+    template<typename Q>
+    size_type erase(const Q& key) {
+        const size_type index = lookup(key);
+        if (index == capacity_) return 0;
+        eraseAt(index);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) {
+        const size_type index = static_cast<size_type>(pos.ctrl_ - ctrl_);
+        eraseAt(index);
+        iterator next(ctrl_ + index, slots_ + index);
+        next.skipEmpty();
+        return next;
+    }
+
+    iterator erase(iterator pos) {
+        return erase(const_iterator(pos));
+    }
+
+    // 容量は保持する。
     void clear() noexcept {
-        for (size_type i = 0; i < bucketCount_; ++i) {
-            Node* curr = buckets_[i];
-            while (curr) {
-                Node* next = curr->next;
-                delete curr;
-                curr = next;
-            }
-            buckets_[i] = nullptr;
+        destroyAll();
+        if (capacity_ != 0) {
+            std::memset(ctrl_, static_cast<unsigned char>(kEmpty), capacity_);
         }
         size_ = 0;
+        growthLeft_ = maxLoad(capacity_);
     }
-    
-    iterator find(const K& key) noexcept {
-        const size_type hash = hasher_(key);
-        const size_type bucketIdx = hash % bucketCount_;
-        
-        Node* curr = buckets_[bucketIdx];
-        while (curr) {
-            if (curr->hash == hash && keyEqual_(curr->data.first, key)) {
-                return iterator(curr, buckets_.get() + bucketIdx, buckets_.get() + bucketCount_);
-            }
-            curr = curr->next;
-        }
-        return end();
+
+    template<typename Q>
+    iterator find(const Q& key) noexcept {
+        const size_type index = lookup(key);
+        return iterator(ctrl_ + index, slots_ + index);
+    }
+
+    template<typename Q>
+    const_iterator find(const Q& key) const noexcept {
+        return const_cast<ArtifactHashMap*>(this)->find(key);
     }
-    
-    size_type count(const K& key) const noexcept {
-        return findNode(key) ? 1 : 0;
+
+    template<typename Q>
+    size_type count(const Q& key) const noexcept {
+        return lookup(key) != capacity_ ? 1 : 0;
     }
-    
-    bool contains(const K& key) const noexcept {
-        return count(key) > 0;
+
+    template<typename Q>
+    bool contains(const Q& key) const noexcept {
+        return lookup(key) != capacity_;
     }
-    
+
 private:
-    template<typename U>
-    std::pair<iterator, bool> emplaceImpl(const K& key, U&& value) {
-        const size_type hash = hasher_(key);
-        const size_type bucketIdx = hash % bucketCount_;
-        
-        Node* curr = buckets_[bucketIdx];
-        while (curr) {
-            if (curr->hash == hash && keyEqual_(curr->data.first, key)) {
-                curr->data.second = std::forward<U>(value);
-                return {iterator(curr, buckets_.get() + bucketIdx, buckets_.get() + bucketCount_), false};
+    static constexpr size_type maxLoad(size_type capacity) noexcept {
+        return capacity - capacity / 8;
+    }
+
+    static size_type capacityFor(size_type count) noexcept {
+        if (count == 0) return 0;
+        size_type capacity = kGroupWidth;
+        while (maxLoad(capacity) < count) capacity *= 2;
+        return capacity;
+    }
+
+    // std::hash<int> のような恒等ハッシュでも H1 / H2 の両方に散るよう混ぜる。
+    static size_type mix(std::size_t hash) noexcept {
+        std::uint64_t h = static_cast<std::uint64_t>(hash);
+        h ^= h >> 32;
+        h *= 0x9E3779B97F4A7C15ull;
+        h ^= h >> 29;
+        return static_cast<size_type>(h);
+    }
+
+    static size_type hash1(size_type hash) noexcept { return hash >> 7; }
+    static ctrl_t hash2(size_type hash) noexcept { return static_cast<ctrl_t>(hash & 0x7F); }
+
+    template<typename Q>
+    size_type hashOf(const Q& key) const {
+        return mix(hasher_(key));
+    }
+
+    // 透過的でない Hasher / KeyEqual では一度だけ K に変換してから探す。
+    template<typename Q>
+    size_type lookup(const Q& key) const {
+        if constexpr (kTransparent || std::is_same_v<Q, K>) {
+            return findIndex(key);
+        } else {
+            return findIndex<K>(key);
+        }
+    }
+
+    void setCtrl(size_type index, ctrl_t value) noexcept {
+        ctrl_[index] = value;
+    }
+
+    template<typename Q>
+    size_type findIndex(const Q& key) const {
+        if (size_ == 0) return capacity_;
+        return findIndex(key, hashOf(key));
+    }
+
+    template<typename Q>
+    size_type findIndex(const Q& key, size_type hash) const {
+        if (size_ == 0) return capacity_;
+        const ctrl_t h2 = hash2(hash);
+        ProbeSeq seq(hash1(hash), capacity_ / kGroupWidth - 1);
+        while (true) {
+            const Group group(ctrl_ + seq.offset());
+            for (std::uint32_t mask = group.match(h2); mask != 0; mask &= mask - 1) {
+                const size_type index = seq.offset() + static_cast<size_type>(std::countr_zero(mask));
+                if (keyEqual_(slots_[index].first, key)) return index;
             }
-            curr = curr->next;
+            if (group.matchEmpty() != 0) return capacity_;
+            seq.next();
+        }
+    }
+
+    size_type findInsertSlot(size_type hash) const noexcept {
+        ProbeSeq seq(hash1(hash), capacity_ / kGroupWidth - 1);
+        while (true) {
+            const std::uint32_t mask = Group(ctrl_ + seq.offset()).matchEmptyOrDeleted();
+            if (mask != 0) return seq.offset() + static_cast<size_type>(std::countr_zero(mask));
+            seq.next();
         }
-        
-        if (static_cast<float>(size_ + 1) > static_cast<float>(bucketCount_) * kMaxLoadFactor) {
-            rehash(bucketCount_ * 2);
-            return emplaceImpl(key, std::forward<U>(value));
+    }
+
+    template<typename KeyArg, typename... Args>
+    std::pair<iterator, bool> emplaceKey(KeyArg&& key, Args&&... args) {
+        const size_type hash = hashOf(key);
+        const size_type existing = findIndex(key, hash);
+        if (existing != capacity_) {
+            return {iterator(ctrl_ + existing, slots_ + existing), false};
         }
-        
-        Node* newNode = new Node(hash, key, std::forward<U>(value));
-        newNode->next = buckets_[bucketIdx];
-        buckets_[bucketIdx] = newNode;
-        ++size_;
-        
-        return {iterator(newNode, buckets_.get() + bucketIdx, buckets_.get() + bucketCount_), true};
-    }
-    
-    Node* findNode(const K& key) const {
-        const size_type hash = hasher_(key);
-        const size_type bucketIdx = hash % bucketCount_;
-        
-        Node* curr = buckets_[bucketIdx];
-        while (curr) {
-            if (curr->hash == hash && keyEqual_(curr->data.first, key)) {
-                return curr;
-            }
-            curr = curr->next;
+        if (capacity_ == 0) {
+            resize(kGroupWidth);
         }
-        return nullptr;
+        size_type index = findInsertSlot(hash);
+        if (growthLeft_ == 0 && ctrl_[index] == kEmpty) {
+            // 削除済みが多ければ同容量で詰め直し、そうでなければ倍にする。
+            resize(size_ + 1 <= maxLoad(capacity_) / 2 ? capacity_ : capacity_ * 2);
+            index = findInsertSlot(hash);
+        }
+        ::new (static_cast<void*>(slots_ + index)) value_type(
+            std::piecewise_construct,
+            std::forward_as_tuple(std::forward<KeyArg>(key)),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        if (ctrl_[index] == kEmpty) --growthLeft_;
+        setCtrl(index, hash2(hash));
+        ++size_;
+        return {iterator(ctrl_ + index, slots_ + index), true};
     }
-    
-    void rehash(size_type newBucketCount) {
-        auto newBuckets = std::make_unique<Node*[]>(newBucketCount);
-        for (size_type i = 0; i < newBucketCount; ++i) {
-            newBuckets[i] = nullptr;
+
+    void eraseAt(size_type index) noexcept {
+        slots_[index].~value_type();
+        --size_;
+        // グループに空きが残っていれば、ここを越えて探索したキーは存在しない。
+        const size_type groupStart = index & ~(kGroupWidth - 1);
+        if (Group(ctrl_ + groupStart).matchEmpty() != 0) {
+            setCtrl(index, kEmpty);
+            ++growthLeft_;
+        } else {
+            setCtrl(index, kDeleted);
         }
-        
-        for (size_type i = 0; i < bucketCount_; ++i) {
-            Node* curr = buckets_[i];
-            while (curr) {
-                Node* next = curr->next;
-                const size_type newIdx = curr->hash % newBucketCount;
-                curr->next = newBuckets[newIdx];
-                newBuckets[newIdx] = curr;
-                curr = next;
+    }
+
+    void destroyAll() noexcept {
+        if constexpr (!std::is_trivially_destructible_v<value_type>) {
+            for (size_type i = 0; i < capacity_ && size_ != 0; ++i) {
+                if (ctrl_[i] >= 0) slots_[i].~value_type();
             }
         }
-        
-        buckets_ = std::move(newBuckets);
-        bucketCount_ = newBucketCount;
+    }
+
+    static size_type slotOffset(size_type capacity) noexcept {
+        // 制御バイト + 番兵。スロット配列はその後ろにアラインして置く。
+        return (capacity + kGroupWidth + kSlotAlign - 1) & ~(kSlotAlign - 1);
+    }
+
+    static void deallocate(ctrl_t* ctrl, size_type capacity) noexcept {
+        if (ctrl == nullptr) return;
+        ::operator delete(static_cast<void*>(ctrl),
+            slotOffset(capacity) + capacity * sizeof(value_type),
+            std::align_val_t{kSlotAlign});
+    }
+
+    void resize(size_type newCapacity) {
+        const size_type bytes = slotOffset(newCapacity) + newCapacity * sizeof(value_type);
+        auto* memory = static_cast<unsigned char*>(::operator new(bytes, std::align_val_t{kSlotAlign}));
+        auto* newCtrl = reinterpret_cast<ctrl_t*>(memory);
+        auto* newSlots = reinterpret_cast<value_type*>(memory + slotOffset(newCapacity));
+        std::memset(newCtrl, static_cast<unsigned char>(kEmpty), newCapacity);
+        std::memset(newCtrl + newCapacity, static_cast<unsigned char>(kSentinel), kGroupWidth);
+
+        ctrl_t* oldCtrl = ctrl_;
+        value_type* oldSlots = slots_;
+        const size_type oldCapacity = capacity_;
+        ctrl_ = newCtrl;
+        slots_ = newSlots;
+        capacity_ = newCapacity;
+        growthLeft_ = maxLoad(newCapacity) - size_;
+
+        // 再配置では const K をコピーする。キーのコピーが重い型は reserve で避ける。
+        for (size_type i = 0; i < oldCapacity; ++i) {
+            if (oldCtrl[i] < 0) continue;
+            const size_type hash = hashOf(oldSlots[i].first);
+            const size_type index = findInsertSlot(hash);
+            ::new (static_cast<void*>(newSlots + index)) value_type(std::move(oldSlots[i]));
+            setCtrl(index, hash2(hash));
+            oldSlots[i].~value_type();
+        }
+        deallocate(oldCtrl, oldCapacity);
     }
 };
 
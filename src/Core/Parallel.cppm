@@ -1,13 +1,70 @@
 module;
+#include <algorithm>
+#include <tbb/blocked_range.h>
 #include <tbb/parallel_for.h>
+#include <tbb/partitioner.h>
+#include <tbb/task_arena.h>
 
 module Core.Parallel;
 
 namespace ArtifactCore {
 
-void Parallel::ForErased(int start, int end, const std::function<void(int)>& func) {
-    if (start >= end || !func) return;
-    tbb::parallel_for(start, end, func);
+namespace {
+
+thread_local int tParallelDepth = 0;
+
+struct ParallelDepthScope {
+    ParallelDepthScope() { ++tParallelDepth; }
+    ~ParallelDepthScope() { --tParallelDepth; }
+};
+
+}
+
+bool Parallel::IsInParallelRegion() {
+    return tParallelDepth > 0;
+}
+
+void Parallel::ForChunksErased(int begin, int end, int grain, ParallelOptions options,
+                               ChunkFunction function, void* context) {
+    if (begin >= end || !function) return;
+    grain = std::max(1, grain);
+
+    if (options.nesting == ParallelNesting::SerialWhenNested && tParallelDepth > 0) {
+        function(context, begin, end);
+        return;
+    }
+
+    auto run = [&]() {
+        if (options.schedule == ParallelSchedule::Static) {
+            // チャンク境界はスレッド数に依存せず grain だけで決まる
+            const int count = end - begin;
+            const int chunkCount = (count + grain - 1) / grain;
+            tbb::parallel_for(tbb::blocked_range<int>(0, chunkCount, 1),
+                [&](const tbb::blocked_range<int>& chunks) {
+                    ParallelDepthScope scope;
+                    for (int c = chunks.begin(); c < chunks.end(); ++c) {
+                        const int chunkBegin = begin + c * grain;
+                        const int chunkEnd = std::min(end, chunkBegin + grain);
+                        function(context, chunkBegin, chunkEnd);
+                    }
+                },
+                tbb::static_partitioner());
+            return;
+        }
+
+        tbb::parallel_for(tbb::blocked_range<int>(begin, end, static_cast<size_t>(grain)),
+            [&](const tbb::blocked_range<int>& range) {
+                ParallelDepthScope scope;
+                function(context, range.begin(), range.end());
+            },
+            tbb::auto_partitioner());
+    };
+
+    if (options.nesting == ParallelNesting::Isolate) {
+        tbb::this_task_arena::isolate(run);
+    } else {
+        run();
+    }
 }
 
 }
@@ -16,9 +16,14 @@ module;
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <cstdio>
+#include <cstring>
 #include <cstdarg>
 #include <chrono>
 #include <thread>
+#include <condition_variable>
+#include <memory>
+#include <array>
+#include <limits>
 #include <algorithm>
 #include <functional>
 #include <wobjectimpl.h>
@@ -76,27 +81,305 @@ static void myMessageOutput(QtMsgType type, const QMessageLogContext &context, c
         break;
     }
     
-    QString ctxStr;
-    if (context.file || context.line || context.function) {
-        ctxStr = QString("%1:%2 %3")
-            .arg(context.file ? context.file : "")
-            .arg(context.line)
-            .arg(context.function ? context.function : "");
+    Logger* logger = Logger::instance();
+    if (type == QtFatalMsg) {
+        // The process aborts after this handler returns; nothing may stay queued.
+        logger->flush();
     }
-
-    Logger::instance()->appendLog(level, msg, ctxStr);
+    logger->appendQtMessage(level, msg, context.file, context.line, context.function);
+    if (type == QtFatalMsg) logger->flush();
 
     if (s_originalHandler) {
         s_originalHandler(type, context, msg);
     }
 }
 
+static QString qtContextString(const char* file, int line, const char* function)
+{
+    if (!file && !line && !function) return {};
+    return QString("%1:%2 %3")
+        .arg(file ? file : "")
+        .arg(line)
+        .arg(function ? function : "");
+}
+
+static QString categoryName(LogCategory category);
+
+namespace {
+
+constexpr std::size_t kThreadQueueCapacity = 256;
+constexpr std::chrono::milliseconds kDrainInterval{10};
+
+struct AsyncLogRecord {
+    enum class Kind : std::uint8_t { Message, QtMessage, Text, Deferred };
+
+    Kind kind = Kind::Message;
+    LogLevel level = LogLevel::Info;
+    LogCategory category = LogCategory::General;
+    std::uint32_t frame = 0xffffffffu;
+    std::int64_t wallMs = 0;
+    std::uint64_t steadyTicks = 0;
+    QString message;
+    QString context;
+    const char* file = nullptr;
+    const char* function = nullptr;
+    int line = 0;
+    const LogFormatSite* site = nullptr;
+    std::uint8_t argCount = 0;
+    std::uint16_t textLength = 0;
+    std::array<LogArg, Logger::kMaxLogArgs> args{};
+    std::array<char, 192> text{};
+};
+
+// Single-producer (the owning thread) / single-consumer (the drain side) ring.
+struct ThreadLogQueue {
+    std::array<AsyncLogRecord, kThreadQueueCapacity> records;
+    alignas(64) std::atomic<std::uint64_t> head{0};
+    std::uint64_t cachedTail = 0; // producer's last view of tail
+    std::atomic<std::uint64_t> dropped{0};
+    std::uint32_t threadId = 0;
+    alignas(64) std::atomic<std::uint64_t> tail{0};
+    std::atomic<bool> retired{false};
+};
+
+struct ThreadQueueHandle {
+    std::shared_ptr<ThreadLogQueue> queue;
+    ~ThreadQueueHandle() {
+        if (queue) queue->retired.store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadQueueHandle t_logQueue;
+// Set while this thread runs AsyncBackend::drain(). Logging from inside a
+// drain (a logAdded slot, a fatal handler) must not queue or drain again.
+thread_local bool t_draining = false;
+
+std::uint64_t steadyTicks()
+{
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+std::int64_t wallClockMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+QString argText(const LogArg& arg)
+{
+    switch (arg.type) {
+    case LogArg::Type::Int: return QString::number(static_cast<qlonglong>(arg.i));
+    case LogArg::Type::UInt: return QString::number(static_cast<qulonglong>(arg.u));
+    case LogArg::Type::Double: return QString::number(arg.d, 'g', 6);
+    case LogArg::Type::Bool: return arg.b ? QStringLiteral("true") : QStringLiteral("false");
+    case LogArg::Type::Text: return QString::fromUtf8(arg.text, arg.length);
+    }
+    return {};
+}
+
+}
+
+class Logger::AsyncBackend {
+public:
+    mutable std::mutex queuesMutex;
+    std::vector<std::shared_ptr<ThreadLogQueue>> queues;
+    // Counts carried over from queues whose threads exited.
+    std::uint64_t retiredEnqueued = 0;
+    std::uint64_t retiredDropped = 0;
+
+    // Only one drainer at a time: the drain thread, flush() or drainFastLogs().
+    std::mutex drainMutex;
+    std::atomic<std::uint64_t> drained{0};
+    std::uint64_t reportedDrops = 0;
+
+    std::thread thread;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;
+    std::atomic<bool> running{false};
+    std::atomic<bool> wakeRequested{false};
+
+    ThreadLogQueue* localQueue() {
+        if (!t_logQueue.queue) {
+            auto queue = std::make_shared<ThreadLogQueue>();
+            queue->threadId = static_cast<std::uint32_t>(
+                std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            std::lock_guard<std::mutex> lock(queuesMutex);
+            queues.push_back(queue);
+            t_logQueue.queue = std::move(queue);
+        }
+        return t_logQueue.queue.get();
+    }
+
+    // Lock-free on every call after a thread's first. Returns false when the
+    // thread's ring is full; the record counts as dropped unless the caller
+    // will log it another way (countDrop == false).
+    template <typename Fill>
+    bool enqueue(Fill&& fill, bool countDrop = true) noexcept {
+        ThreadLogQueue* queue = nullptr;
+        try {
+            queue = localQueue();
+        } catch (...) {
+            return false;
+        }
+        const std::uint64_t head = queue->head.load(std::memory_order_relaxed);
+        if (head - queue->cachedTail >= kThreadQueueCapacity) {
+            queue->cachedTail = queue->tail.load(std::memory_order_acquire);
+            if (head - queue->cachedTail >= kThreadQueueCapacity) {
+                if (countDrop) queue->dropped.fetch_add(1, std::memory_order_relaxed);
+                requestDrain();
+                return false;
+            }
+        }
+        auto& record = queue->records[head % kThreadQueueCapacity];
+        record.wallMs = wallClockMs();
+        record.steadyTicks = steadyTicks();
+        fill(record);
+        queue->head.store(head + 1, std::memory_order_release);
+        if (head + 1 - queue->cachedTail == kThreadQueueCapacity / 2) requestDrain();
+        return true;
+    }
+
+    void requestDrain() noexcept {
+        if (running.load(std::memory_order_relaxed)
+            && !wakeRequested.exchange(true, std::memory_order_acq_rel))
+            wakeCv.notify_one();
+    }
+
+    static LogMessage format(AsyncLogRecord& record, std::uint32_t threadId) {
+        LogMessage message;
+        message.timestamp = QDateTime::fromMSecsSinceEpoch(record.wallMs);
+        message.level = record.level;
+        switch (record.kind) {
+        case AsyncLogRecord::Kind::Message:
+            message.message = std::move(record.message);
+            message.context = std::move(record.context);
+            return message;
+        case AsyncLogRecord::Kind::QtMessage:
+            message.message = std::move(record.message);
+            message.context = qtContextString(record.file, record.line, record.function);
+            return message;
+        case AsyncLogRecord::Kind::Text:
+            message.message = QString::fromUtf8(record.text.data(), record.textLength);
+            break;
+        case AsyncLogRecord::Kind::Deferred:
+            message.message = QString::fromUtf8(record.site->format);
+            for (std::uint8_t i = 0; i < record.argCount; ++i)
+                message.message = message.message.arg(argText(record.args[i]));
+            break;
+        }
+        message.context = QStringLiteral("category=%1 thread=%2 frame=%3")
+            .arg(categoryName(record.category))
+            .arg(threadId)
+            .arg(record.frame == 0xffffffffu ? -1 : static_cast<qint64>(record.frame));
+        return message;
+    }
+
+    std::size_t drain(Logger& logger, std::size_t maxRecords) {
+        // A flush() from inside commitLogs() would re-lock drainMutex.
+        if (t_draining) return 0;
+        struct DrainingScope {
+            DrainingScope() { t_draining = true; }
+            ~DrainingScope() { t_draining = false; }
+        } drainingScope;
+        std::lock_guard<std::mutex> drainLock(drainMutex);
+        std::vector<std::shared_ptr<ThreadLogQueue>> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(queuesMutex);
+            snapshot = queues;
+        }
+
+        struct Pending {
+            std::uint64_t ticks;
+            LogMessage message;
+        };
+        std::vector<Pending> batch;
+        for (const auto& queue : snapshot) {
+            std::uint64_t tail = queue->tail.load(std::memory_order_relaxed);
+            const std::uint64_t head = queue->head.load(std::memory_order_acquire);
+            for (; tail < head && batch.size() < maxRecords; ++tail) {
+                auto& record = queue->records[tail % kThreadQueueCapacity];
+                batch.push_back({ record.steadyTicks, format(record, queue->threadId) });
+                record.message = QString();
+                record.context = QString();
+            }
+            queue->tail.store(tail, std::memory_order_release);
+        }
+        std::uint64_t dropped = 0;
+        {
+            // Exited threads' rings go once they are empty. Their drops move
+            // into retiredDropped, so count the live rings only after this.
+            std::lock_guard<std::mutex> lock(queuesMutex);
+            std::erase_if(queues, [this](const std::shared_ptr<ThreadLogQueue>& queue) {
+                if (!queue->retired.load(std::memory_order_acquire)
+                    || queue->tail.load(std::memory_order_relaxed)
+                           != queue->head.load(std::memory_order_acquire))
+                    return false;
+                retiredEnqueued += queue->head.load(std::memory_order_relaxed);
+                retiredDropped += queue->dropped.load(std::memory_order_relaxed);
+                return true;
+            });
+            dropped = retiredDropped;
+            for (const auto& queue : queues)
+                dropped += queue->dropped.load(std::memory_order_relaxed);
+        }
+
+        // Each ring is in order; interleave threads by enqueue time.
+        std::stable_sort(batch.begin(), batch.end(),
+            [](const Pending& a, const Pending& b) { return a.ticks < b.ticks; });
+        std::vector<LogMessage> messages;
+        messages.reserve(batch.size() + 1);
+        for (auto& pending : batch) messages.push_back(std::move(pending.message));
+        if (dropped > reportedDrops) {
+            LogMessage warning;
+            warning.timestamp = QDateTime::currentDateTime();
+            warning.level = LogLevel::Warning;
+            warning.message = QStringLiteral("%1 log records dropped (thread log queue full)")
+                .arg(dropped - reportedDrops);
+            warning.context = QStringLiteral("category=Diagnostics");
+            messages.push_back(std::move(warning));
+            reportedDrops = dropped;
+        }
+        drained.fetch_add(batch.size(), std::memory_order_relaxed);
+        if (!messages.empty()) logger.commitLogs(messages);
+        return batch.size();
+    }
+
+    AsyncLogStats stats() const {
+        AsyncLogStats result;
+        std::lock_guard<std::mutex> lock(queuesMutex);
+        result.enqueued = retiredEnqueued;
+        result.dropped = retiredDropped;
+        for (const auto& queue : queues) {
+            result.enqueued += queue->head.load(std::memory_order_relaxed);
+            result.dropped += queue->dropped.load(std::memory_order_relaxed);
+        }
+        result.drained = drained.load(std::memory_order_relaxed);
+        result.threadQueues = queues.size();
+        return result;
+    }
+
+    void run(Logger& logger) {
+        while (running.load(std::memory_order_acquire)) {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wakeCv.wait_for(lock, kDrainInterval, [this]() {
+                    return wakeRequested.load(std::memory_order_acquire)
+                        || !running.load(std::memory_order_acquire);
+                });
+            }
+            wakeRequested.store(false, std::memory_order_release);
+            drain(logger, std::numeric_limits<std::size_t>::max());
+        }
+        drain(logger, std::numeric_limits<std::size_t>::max());
+    }
+};
+
 Logger* Logger::instance() {
     static Logger logger;
     return &logger;
 }
 
-Logger::Logger(QObject* parent) : QObject(parent) {
+Logger::Logger(QObject* parent) : QObject(parent), async_(std::make_unique<AsyncBackend>()) {
     for (auto& enabled : categoryEnabled_) enabled.store(true, std::memory_order_relaxed);
 }
 
@@ -104,30 +387,80 @@ Logger::~Logger() {
     uninstall();
 }
 
-void Logger::install() {
+void Logger::startAsyncBackend() {
+    std::lock_guard<std::mutex> lock(async_->wakeMutex);
+    if (async_->running.exchange(true)) return;
+    async_->thread = std::thread([this]() { async_->run(*this); });
+}
+
+void Logger::stopAsyncBackend() {
+    {
+        std::lock_guard<std::mutex> lock(async_->wakeMutex);
+        if (!async_->running.exchange(false)) return;
+    }
+    async_->wakeCv.notify_one();
+    if (async_->thread.joinable()) async_->thread.join();
+}
+
+bool Logger::asyncBackendRunning() const noexcept {
+    return async_->running.load(std::memory_order_acquire);
+}
+
+void Logger::flush() {
+    async_->drain(*this, std::numeric_limits<std::size_t>::max());
     std::lock_guard<std::mutex> lock(mutex_);
-    if (!installed_) {
-        // Install Qt message handler
-        s_originalHandler = qInstallMessageHandler(myMessageOutput);
-        ensureLogFileReady();
-        if (fileLoggingEnabled_ && logFile_.isOpen()) {
-            const QString appName = QCoreApplication::applicationName().isEmpty()
-                                        ? QStringLiteral("Artifact")
-                                        : QCoreApplication::applicationName();
-            const QString header = QStringLiteral("=== %1 log session started at %2 ===")
-                                       .arg(appName,
-                                            QDateTime::currentDateTime().toString(
-                                                QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")));
-            writeLineToLogFile(header);
-            if (!logFilePath_.isEmpty()) {
-                writeLineToLogFile(QStringLiteral("Log file: %1").arg(logFilePath_));
+    if (logFile_.isOpen()) logFile_.flush();
+}
+
+AsyncLogStats Logger::asyncStats() const noexcept {
+    return async_->stats();
+}
+
+bool Logger::enqueueDeferred(const LogFormatSite& site, std::uint32_t frame,
+                             const LogArg* args, std::size_t argCount) noexcept {
+    if (!site.format || !isCategoryEnabled(site.category)) return false;
+    argCount = std::min(argCount, kMaxLogArgs);
+    return async_->enqueue([&](AsyncLogRecord& record) {
+        record.kind = AsyncLogRecord::Kind::Deferred;
+        record.level = site.level;
+        record.category = site.category;
+        record.frame = frame;
+        record.site = &site;
+        record.argCount = static_cast<std::uint8_t>(argCount);
+        std::copy(args, args + argCount, record.args.begin());
+    });
+}
+
+void Logger::install() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!installed_) {
+            // Install Qt message handler
+            s_originalHandler = qInstallMessageHandler(myMessageOutput);
+            ensureLogFileReady();
+            if (fileLoggingEnabled_ && logFile_.isOpen()) {
+                const QString appName = QCoreApplication::applicationName().isEmpty()
+                                            ? QStringLiteral("Artifact")
+                                            : QCoreApplication::applicationName();
+                const QString header = QStringLiteral("=== %1 log session started at %2 ===")
+                                           .arg(appName,
+                                                QDateTime::currentDateTime().toString(
+                                                    QStringLiteral("yyyy-MM-dd HH:mm:ss.zzz")));
+                writeLineToLogFile(header);
+                if (!logFilePath_.isEmpty()) {
+                    writeLineToLogFile(QStringLiteral("Log file: %1").arg(logFilePath_));
+                }
+                logFile_.flush();
             }
+            installed_ = true;
         }
-        installed_ = true;
     }
+    startAsyncBackend();
 }
 
 void Logger::uninstall() {
+    // The drain thread commits under mutex_, so it is stopped first.
+    stopAsyncBackend();
     std::lock_guard<std::mutex> lock(mutex_);
     if (installed_) {
         if (fileLoggingEnabled_ && logFile_.isOpen()) {
@@ -160,36 +493,72 @@ void Logger::clearLogs() {
 }
 
 void Logger::appendLog(LogLevel level, const QString& message, const QString& context) {
-    LogMessage logMsg;
-    logMsg.timestamp = QDateTime::currentDateTime();
-    logMsg.level = level;
-    logMsg.message = message;
-    logMsg.context = context;
+    // Under overload debug/info records are dropped; warnings and errors fall
+    // back to the synchronous path below rather than being lost.
+    const bool mayDrop = level < LogLevel::Warning;
+    if (asyncBackendRunning() && !t_draining
+        && (async_->enqueue([&](AsyncLogRecord& record) {
+               record.kind = AsyncLogRecord::Kind::Message;
+               record.level = level;
+               record.message = message;
+               record.context = context;
+           }, mayDrop) || mayDrop))
+        return;
 
+    std::vector<LogMessage> messages(1);
+    messages.front().timestamp = QDateTime::currentDateTime();
+    messages.front().level = level;
+    messages.front().message = message;
+    messages.front().context = context;
+    commitLogs(messages);
+}
+
+void Logger::appendQtMessage(LogLevel level, const QString& message, const char* file,
+                             int line, const char* function) {
+    const bool mayDrop = level < LogLevel::Warning;
+    if (asyncBackendRunning() && !t_draining
+        && (async_->enqueue([&](AsyncLogRecord& record) {
+               record.kind = AsyncLogRecord::Kind::QtMessage;
+               record.level = level;
+               record.message = message;
+               record.file = file;
+               record.line = line;
+               record.function = function;
+           }, mayDrop) || mayDrop))
+        return;
+    appendLog(level, message, qtContextString(file, line, function));
+}
+
+void Logger::commitLogs(std::vector<LogMessage>& messages) {
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        logs_.push_back(logMsg);
-        
+        logs_.insert(logs_.end(), messages.begin(), messages.end());
         if (logs_.size() > 5000) {
-            logs_.erase(logs_.begin(), logs_.begin() + 1000);
+            logs_.erase(logs_.begin(), logs_.end() - 4000);
         }
 
         if (fileLoggingEnabled_) {
-            if (logFileFormat_ == LogFileFormat::JsonLines) {
-                QJsonObject json;
-                json.insert(QStringLiteral("timestamp"), logMsg.timestamp.toString(Qt::ISODateWithMs));
-                json.insert(QStringLiteral("level"), levelName(logMsg.level));
-                json.insert(QStringLiteral("message"), logMsg.message);
-                if (!logMsg.context.isEmpty()) json.insert(QStringLiteral("context"), logMsg.context);
-                writeLineToLogFile(QString::fromUtf8(
-                    QJsonDocument(json).toJson(QJsonDocument::Compact)));
-            } else {
-                writeLineToLogFile(formatLogLine(logMsg));
+            for (const auto& logMsg : messages) {
+                if (logFileFormat_ == LogFileFormat::JsonLines) {
+                    QJsonObject json;
+                    json.insert(QStringLiteral("timestamp"), logMsg.timestamp.toString(Qt::ISODateWithMs));
+                    json.insert(QStringLiteral("level"), levelName(logMsg.level));
+                    json.insert(QStringLiteral("message"), logMsg.message);
+                    if (!logMsg.context.isEmpty()) json.insert(QStringLiteral("context"), logMsg.context);
+                    writeLineToLogFile(QString::fromUtf8(
+                        QJsonDocument(json).toJson(QJsonDocument::Compact)));
+                } else {
+                    writeLineToLogFile(formatLogLine(logMsg));
+                }
             }
+            // One flush per batch rather than per line.
+            if (logFile_.isOpen()) logFile_.flush();
         }
     }
 
-    Q_EMIT logAdded(static_cast<int>(level), message, context, logMsg.timestamp);
+    for (const auto& logMsg : messages) {
+        Q_EMIT logAdded(static_cast<int>(logMsg.level), logMsg.message, logMsg.context, logMsg.timestamp);
+    }
 }
 
 void Logger::setFileLoggingEnabled(bool enabled)
@@ -268,31 +637,15 @@ bool Logger::tryFastLog(LogLevel level, LogCategory category, const char* messag
 {
     if (!message) return false;
     if (!isCategoryEnabled(category)) return false;
-    while (fastLogProducerLock_.test_and_set(std::memory_order_acquire)) {
-        std::this_thread::yield();
-    }
-    const auto write = fastLogWrite_.load(std::memory_order_relaxed);
-    const auto read = fastLogRead_.load(std::memory_order_acquire);
-    if (write - read >= fastLogCapacity_) {
-        fastLogDropped_.fetch_add(1, std::memory_order_relaxed);
-        fastLogProducerLock_.clear(std::memory_order_release);
-        return false;
-    }
-
-    auto& record = fastLogBuffer_[write % fastLogCapacity_];
-    record.timestampTicks = static_cast<std::uint64_t>(
-        std::chrono::steady_clock::now().time_since_epoch().count());
-    record.category = static_cast<std::uint32_t>(category);
-    record.threadId = static_cast<std::uint32_t>(
-        std::hash<std::thread::id>{}(std::this_thread::get_id()));
-    record.frame = frame;
-    record.level = static_cast<std::uint16_t>(level);
-    const int written = std::snprintf(record.message.data(), record.message.size(), "%s", message);
-    record.length = static_cast<std::uint16_t>(written > 0
-        ? std::min<int>(written, static_cast<int>(record.message.size() - 1)) : 0);
-    fastLogWrite_.store(write + 1, std::memory_order_release);
-    fastLogProducerLock_.clear(std::memory_order_release);
-    return true;
+    return async_->enqueue([&](AsyncLogRecord& record) {
+        record.kind = AsyncLogRecord::Kind::Text;
+        record.level = level;
+        record.category = category;
+        record.frame = frame;
+        const std::size_t length = std::strlen(message);
+        record.textLength = static_cast<std::uint16_t>(std::min(length, record.text.size()));
+        std::memcpy(record.text.data(), message, record.textLength);
+    });
 }
 
 bool Logger::tryFastLogFormat(LogLevel level, LogCategory category, std::uint32_t frame,
@@ -326,26 +679,12 @@ bool Logger::isCategoryEnabled(LogCategory category) const noexcept
 
 std::size_t Logger::drainFastLogs(std::size_t maxRecords)
 {
-    std::size_t drained = 0;
-    while (drained < maxRecords) {
-        const auto read = fastLogRead_.load(std::memory_order_relaxed);
-        const auto write = fastLogWrite_.load(std::memory_order_acquire);
-        if (read >= write) break;
-        const auto& record = fastLogBuffer_[read % fastLogCapacity_];
-        const QString message = QString::fromUtf8(record.message.data(), record.length);
-        const QString context = QStringLiteral("category=%1 thread=%2 frame=%3")
-            .arg(categoryName(static_cast<LogCategory>(record.category)))
-            .arg(record.threadId).arg(record.frame == 0xffffffffu ? -1 : record.frame);
-        appendLog(static_cast<LogLevel>(record.level), message, context);
-        fastLogRead_.store(read + 1, std::memory_order_release);
-        ++drained;
-    }
-    return drained;
+    return async_->drain(*this, maxRecords);
 }
 
 std::uint64_t Logger::droppedFastLogCount() const noexcept
 {
-    return fastLogDropped_.load(std::memory_order_relaxed);
+    return async_->stats().dropped;
 }
 
 void Logger::appendDiagnostic(const DiagnosticEvent& event)
@@ -474,8 +813,6 @@ void Logger::writeLineToLogFile(const QString& line)
     if (logFile_.write(utf8) < 0 || logFile_.write("\n") < 0) {
         fileLoggingEnabled_ = false;
         logFile_.close();
-    } else {
-        logFile_.flush();
     }
 }
 
@@ -1,8 +1,9 @@
 module;
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
-#include <deque>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -17,73 +18,229 @@ module;
 module Event.Bus;
 
 import Memory.SharedPtr;
-import Container.NamedVector;
 
 namespace ArtifactCore {
 
 struct EventBus::Impl {
-    struct Entry {
-        mutable std::mutex mutex;
-        NamedVector<SharedPtr<SubscriberRecord>> subscribers;
+    // Subscribers and type names are published RCU style: readers take an
+    // atomic snapshot and never lock, writers copy, modify and swap the
+    // snapshot under writeMutex. Subscribing is rare; publishing is not.
+    using SubscriberList = std::vector<SharedPtr<SubscriberRecord>>;
+    using Registry = std::unordered_map<std::type_index, std::shared_ptr<const SubscriberList>>;
+    using TypeNames = std::unordered_map<std::type_index, std::string>;
+
+    mutable std::mutex writeMutex;
+    std::shared_ptr<const Registry> registry = std::make_shared<const Registry>();
+    std::shared_ptr<const TypeNames> typeNames = std::make_shared<const TypeNames>();
+
+    std::atomic_size_t nextSubscriberId { 1 };
+
+    // Debug hook (only set while a debugger is attached)
+    std::shared_ptr<const EventBus::PublishHook> publishHook;
+
+    // --- Deferred events ---
+    // Multi-producer / single-consumer. Producers push onto a per-priority
+    // Treiber stack with one CAS. The consumer detaches a whole stack with
+    // one exchange, reverses it back to FIFO order and appends it to its
+    // private list, so posting never waits for drain().
+    static constexpr int kPriorityLevels = 4;
+    static constexpr std::size_t kDrainBatch = 64;
+
+    struct CoalesceSlot {
+        QueuedEvent latest;
+        bool queued = false;
     };
 
-    mutable std::mutex registryMutex;
-    std::unordered_map<std::type_index, SharedPtr<Entry>> registry;
+    struct QueueNode {
+        QueueNode* next = nullptr;
+        QueuedEvent event;
+        std::shared_ptr<CoalesceSlot> coalesced;  // postLatest: payload lives in the slot
+        std::uint64_t coalescedKey = 0;
+    };
 
-    mutable std::mutex queueMutex;
-    std::deque<QueuedEvent> queue;
+    std::array<std::atomic<QueueNode*>, kPriorityLevels> incoming {};
+    std::atomic_size_t pending { 0 };
+    std::atomic_size_t coalesced { 0 };
+
+    mutable std::mutex drainMutex;  // consumer side only
+    std::array<QueueNode*, kPriorityLevels> localHead {};
+    std::array<QueueNode*, kPriorityLevels> localTail {};
+
+    // Coalescing slots are keyed by (type, key) and spread over shards so
+    // unrelated producers do not share a lock. A slot exists only while its
+    // event is queued, which keeps the maps bounded by the queue length.
+    struct CoalesceKey {
+        std::type_index type;
+        std::uint64_t key;
+        bool operator==(const CoalesceKey& other) const { return type == other.type && key == other.key; }
+    };
+    struct CoalesceKeyHash {
+        std::size_t operator()(const CoalesceKey& k) const {
+            return k.type.hash_code() ^ (static_cast<std::size_t>(k.key) * 0x9e3779b97f4a7c15ull);
+        }
+    };
+    struct alignas(64) CoalesceShard {
+        std::mutex mutex;
+        std::unordered_map<CoalesceKey, std::shared_ptr<CoalesceSlot>, CoalesceKeyHash> slots;
+    };
+    static constexpr std::size_t kCoalesceShards = 16;
+    std::array<CoalesceShard, kCoalesceShards> coalesceShards;
 
-    std::atomic_size_t nextSubscriberId { 1 };
+    ~Impl()
+    {
+        deleteChain(detachAll());
+    }
 
-    // Debug hooks (only active when a debugger is attached)
-    mutable std::mutex hookMutex;
-    EventBus::PublishHook publishHook;
-    mutable std::mutex namesMutex;
-    std::unordered_map<std::type_index, std::string> typeNames;
-};
+    std::shared_ptr<const Registry> loadRegistry() const
+    {
+        return std::atomic_load_explicit(&registry, std::memory_order_acquire);
+    }
 
-static void pruneInactive(NamedVector<SharedPtr<EventBus::SubscriberRecord>>& subscribers)
-{
-    subscribers.removeIf(
-        [](const SharedPtr<EventBus::SubscriberRecord>& record) {
-            return !record || !record->active.load(std::memory_order_acquire);
-        });
-}
+    void storeRegistry(std::shared_ptr<const Registry> next)
+    {
+        std::atomic_store_explicit(&registry, std::move(next), std::memory_order_release);
+    }
 
-static void disconnectRecordFromImpl(EventBus::Impl& impl, std::type_index type, std::size_t id)
-{
-    SharedPtr<EventBus::Impl::Entry> entry;
+    static int priorityIndex(EventPriority priority)
     {
-        std::lock_guard<std::mutex> lock(impl.registryMutex);
-        auto it = impl.registry.find(type);
-        if (it == impl.registry.end()) {
-            return;
+        return std::clamp(static_cast<int>(priority), 0, kPriorityLevels - 1);
+    }
+
+    // Counts the node before publishing it: once the CAS succeeds a drain may
+    // pop it and decrement straight away, which must not wrap the counter.
+    // The loop only retries, so there is no path that needs to undo the count.
+    void push(QueueNode* node)
+    {
+        pending.fetch_add(1, std::memory_order_relaxed);
+        auto& head = incoming[priorityIndex(node->event.priority)];
+        node->next = head.load(std::memory_order_relaxed);
+        while (!head.compare_exchange_weak(node->next, node,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed)) {
         }
-        entry = it->second;
     }
 
-    if (!entry) {
-        return;
+    // drainMutex held
+    void collectIncoming()
+    {
+        for (int level = 0; level < kPriorityLevels; ++level) {
+            QueueNode* stack = incoming[level].exchange(nullptr, std::memory_order_acquire);
+            if (!stack) {
+                continue;
+            }
+            // Reverse LIFO -> FIFO
+            QueueNode* fifoHead = nullptr;
+            QueueNode* fifoTail = stack;
+            while (stack) {
+                QueueNode* next = stack->next;
+                stack->next = fifoHead;
+                fifoHead = stack;
+                stack = next;
+            }
+            if (localTail[level]) {
+                localTail[level]->next = fifoHead;
+            } else {
+                localHead[level] = fifoHead;
+            }
+            localTail[level] = fifoTail;
+        }
+    }
+
+    // drainMutex held
+    QueueNode* popLocal()
+    {
+        for (int level = kPriorityLevels - 1; level >= 0; --level) {
+            QueueNode* node = localHead[level];
+            if (!node) {
+                continue;
+            }
+            localHead[level] = node->next;
+            if (!localHead[level]) {
+                localTail[level] = nullptr;
+            }
+            node->next = nullptr;
+            pending.fetch_sub(1, std::memory_order_relaxed);
+            return node;
+        }
+        return nullptr;
+    }
+
+    // drainMutex held (or the bus is being destroyed)
+    QueueNode* detachAll()
+    {
+        collectIncoming();
+        QueueNode* chain = nullptr;
+        for (int level = 0; level < kPriorityLevels; ++level) {
+            if (localTail[level]) {
+                localTail[level]->next = chain;
+                chain = localHead[level];
+            }
+            localHead[level] = nullptr;
+            localTail[level] = nullptr;
+        }
+        return chain;
     }
 
-    bool entryEmpty = false;
+    static void deleteChain(QueueNode* node)
     {
-        std::lock_guard<std::mutex> lock(entry->mutex);
-        auto& subscribers = entry->subscribers;
-        subscribers.removeIf(
-            [id](const SharedPtr<EventBus::SubscriberRecord>& candidate) {
-                return !candidate || candidate->id == id || !candidate->active.load(std::memory_order_acquire);
-            });
-        entryEmpty = subscribers.empty();
-    }
-
-    if (entryEmpty) {
-        std::lock_guard<std::mutex> registryLock(impl.registryMutex);
-        auto it = impl.registry.find(type);
-        if (it != impl.registry.end() && it->second == entry) {
-            impl.registry.erase(it);
+        while (node) {
+            QueueNode* next = node->next;
+            delete node;
+            node = next;
         }
     }
+
+    CoalesceShard& shardFor(const CoalesceKey& key)
+    {
+        return coalesceShards[CoalesceKeyHash{}(key) % kCoalesceShards];
+    }
+
+    // Takes the latest payload out of a coalescing slot; later posts start a new slot.
+    QueuedEvent takeCoalesced(const QueueNode& node)
+    {
+        const CoalesceKey key { node.event.type, node.coalescedKey };
+        CoalesceShard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        QueuedEvent event = std::move(node.coalesced->latest);
+        node.coalesced->queued = false;
+        auto it = shard.slots.find(key);
+        if (it != shard.slots.end() && it->second == node.coalesced) {
+            shard.slots.erase(it);
+        }
+        return event;
+    }
+};
+
+static std::shared_ptr<const EventBus::Impl::SubscriberList> withoutRecord(
+    const EventBus::Impl::SubscriberList& subscribers, std::size_t id)
+{
+    auto next = std::make_shared<EventBus::Impl::SubscriberList>();
+    next->reserve(subscribers.size());
+    for (const auto& candidate : subscribers) {
+        if (candidate && candidate->id != id && candidate->active.load(std::memory_order_acquire)) {
+            next->push_back(candidate);
+        }
+    }
+    return next;
+}
+
+static void disconnectRecordFromImpl(EventBus::Impl& impl, std::type_index type, std::size_t id)
+{
+    std::lock_guard<std::mutex> lock(impl.writeMutex);
+    const auto current = impl.loadRegistry();
+    auto it = current->find(type);
+    if (it == current->end() || !it->second) {
+        return;
+    }
+
+    auto next = std::make_shared<EventBus::Impl::Registry>(*current);
+    auto subscribers = withoutRecord(*it->second, id);
+    if (subscribers->empty()) {
+        next->erase(type);
+    } else {
+        (*next)[type] = std::move(subscribers);
+    }
+    impl.storeRegistry(std::move(next));
 }
 
 EventBus::Subscription::Subscription(WeakPtr<Impl> impl, SharedPtr<SubscriberRecord> record) noexcept
@@ -147,20 +304,23 @@ EventBus::Subscription EventBus::subscribeRaw(std::type_index type, std::functio
     record->type = type;
     record->callback = std::move(callback);
 
-    SharedPtr<Impl::Entry> entry;
     {
-        std::lock_guard<std::mutex> lock(impl->registryMutex);
-        auto& slot = impl->registry[type];
-        if (!slot) {
-            slot = makeShared<Impl::Entry>();
+        std::lock_guard<std::mutex> lock(impl->writeMutex);
+        const auto current = impl->loadRegistry();
+        auto subscribers = std::make_shared<Impl::SubscriberList>();
+        if (auto it = current->find(type); it != current->end() && it->second) {
+            subscribers->reserve(it->second->size() + 1);
+            for (const auto& existing : *it->second) {
+                if (existing && existing->active.load(std::memory_order_acquire)) {
+                    subscribers->push_back(existing);
+                }
+            }
         }
-        entry = slot;
-    }
+        subscribers->push_back(record);
 
-    {
-        std::lock_guard<std::mutex> lock(entry->mutex);
-        pruneInactive(entry->subscribers);
-        entry->subscribers.push_back(record);
+        auto next = std::make_shared<Impl::Registry>(*current);
+        (*next)[type] = std::move(subscribers);
+        impl->storeRegistry(std::move(next));
     }
 
     return Subscription { impl, std::move(record) };
@@ -174,52 +334,35 @@ std::size_t EventBus::publishRaw(std::type_index type, const void* payload,
         return 0;
     }
 
-    SharedPtr<Impl::Entry> entry;
-    {
-        std::lock_guard<std::mutex> lock(impl->registryMutex);
-        auto it = impl->registry.find(type);
-        if (it == impl->registry.end()) {
-            return 0;
-        }
-        entry = it->second;
-    }
-
-    NamedVector<SharedPtr<SubscriberRecord>> snapshot{
-        makeNamedVector<SharedPtr<SubscriberRecord>>(ContainerName{"EventBusSubscriberSnapshot"})};
-    {
-        std::lock_guard<std::mutex> lock(entry->mutex);
-        snapshot.reserve(entry->subscribers.size());
-        for (const auto& subscriber : entry->subscribers) snapshot.append(subscriber);
+    // Lock-free: the snapshot keeps the subscriber list alive even if
+    // another thread subscribes or disconnects during dispatch.
+    const auto registry = impl->loadRegistry();
+    auto it = registry->find(type);
+    if (it == registry->end() || !it->second) {
+        return 0;
     }
+    const auto subscribers = it->second;
 
     const auto dispatchStart = std::chrono::high_resolution_clock::now();
     std::size_t delivered = 0;
-    for (const auto& record : snapshot) {
+    for (const auto& record : *subscribers) {
         if (!record || !record->active.load(std::memory_order_acquire) || !record->callback) {
             continue;
         }
         record->callback(payload);
         ++delivered;
     }
-    const std::int64_t dispatchNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::high_resolution_clock::now() - dispatchStart).count();
 
-    // Fire debug hook if attached (copy both to avoid holding locks during callback)
-    {
-        PublishHook hook_copy;
-        {
-            std::lock_guard<std::mutex> lock(impl->hookMutex);
-            hook_copy = impl->publishHook;
-        }
-        if (hook_copy) {
-            std::string name_copy;
-            {
-                std::lock_guard<std::mutex> lock(impl->namesMutex);
-                auto it = impl->typeNames.find(type);
-                if (it != impl->typeNames.end()) name_copy = it->second;
-            }
-            hook_copy(type, name_copy, delivered, dispatchNs, origin);
-        }
+    // Fire debug hook if attached
+    const auto hook = std::atomic_load_explicit(&impl->publishHook, std::memory_order_acquire);
+    if (hook && *hook) {
+        const std::int64_t dispatchNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now() - dispatchStart).count();
+        const auto names = std::atomic_load_explicit(&impl->typeNames, std::memory_order_acquire);
+        auto nameIt = names->find(type);
+        const std::string_view name = nameIt != names->end() ? std::string_view(nameIt->second)
+                                                             : std::string_view();
+        (*hook)(type, name, delivered, dispatchNs, origin);
     }
 
     return delivered;
@@ -235,13 +378,40 @@ void EventBus::enqueueRaw(std::type_index type, SharedPtr<const void> payload,
         return;
     }
 
-    std::lock_guard<std::mutex> lock(impl->queueMutex);
-    // Insert in sorted position (high priority first)
-    auto pos = impl->queue.begin();
-    while (pos != impl->queue.end() && static_cast<int>(pos->priority) >= static_cast<int>(priority)) {
-        ++pos;
+    auto* node = new Impl::QueueNode;
+    node->event = QueuedEvent { type, std::move(payload), dispatch, priority, origin };
+    impl->push(node);
+}
+
+void EventBus::enqueueLatestRaw(std::type_index type, std::uint64_t key, SharedPtr<const void> payload,
+                                void (*dispatch)(EventBus&, const void*, std::source_location),
+                                EventPriority priority, std::source_location origin)
+{
+    auto impl = impl_;
+    if (!impl) {
+        return;
     }
-    impl->queue.insert(pos, QueuedEvent { type, std::move(payload), dispatch, priority, origin });
+
+    const Impl::CoalesceKey slotKey { type, key };
+    auto& shard = impl->shardFor(slotKey);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto& slot = shard.slots[slotKey];
+    if (!slot) {
+        slot = std::make_shared<Impl::CoalesceSlot>();
+    }
+    slot->latest = QueuedEvent { type, std::move(payload), dispatch, priority, origin };
+    if (slot->queued) {
+        impl->coalesced.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    slot->queued = true;
+    auto* node = new Impl::QueueNode;
+    node->event.type = type;
+    node->event.priority = priority;
+    node->coalesced = slot;
+    node->coalescedKey = key;
+    impl->push(node);
 }
 
 std::size_t EventBus::subscriberCountRaw(std::type_index type) const noexcept
@@ -251,19 +421,14 @@ std::size_t EventBus::subscriberCountRaw(std::type_index type) const noexcept
         return 0;
     }
 
-    SharedPtr<Impl::Entry> entry;
-    {
-        std::lock_guard<std::mutex> lock(impl->registryMutex);
-        auto it = impl->registry.find(type);
-        if (it == impl->registry.end()) {
-            return 0;
-        }
-        entry = it->second;
+    const auto registry = impl->loadRegistry();
+    auto it = registry->find(type);
+    if (it == registry->end() || !it->second) {
+        return 0;
     }
 
-    std::lock_guard<std::mutex> lock(entry->mutex);
     std::size_t count = 0;
-    for (const auto& record : entry->subscribers) {
+    for (const auto& record : *it->second) {
         if (record && record->active.load(std::memory_order_acquire)) {
             ++count;
         }
@@ -275,24 +440,41 @@ void EventBus::registerTypeNameRaw(std::type_index type, const char* name)
 {
     auto impl = impl_;
     if (!impl || !name) return;
-    std::lock_guard<std::mutex> lock(impl->namesMutex);
-    impl->typeNames.emplace(type, name);  // no-op if already present
+
+    // Fast path on every publish: the name is almost always known already.
+    const auto names = std::atomic_load_explicit(&impl->typeNames, std::memory_order_acquire);
+    if (names->find(type) != names->end()) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(impl->writeMutex);
+    const auto current = std::atomic_load_explicit(&impl->typeNames, std::memory_order_acquire);
+    if (current->find(type) != current->end()) {
+        return;
+    }
+    auto next = std::make_shared<Impl::TypeNames>(*current);
+    next->emplace(type, name);
+    std::atomic_store_explicit(&impl->typeNames, std::shared_ptr<const Impl::TypeNames>(std::move(next)),
+                               std::memory_order_release);
 }
 
 void EventBus::setPublishHook(PublishHook hook)
 {
     auto impl = impl_;
     if (!impl) return;
-    std::lock_guard<std::mutex> lock(impl->hookMutex);
-    impl->publishHook = std::move(hook);
+    std::shared_ptr<const PublishHook> next;
+    if (hook) {
+        next = std::make_shared<const PublishHook>(std::move(hook));
+    }
+    std::atomic_store_explicit(&impl->publishHook, std::move(next), std::memory_order_release);
 }
 
 void EventBus::clearPublishHook()
 {
     auto impl = impl_;
     if (!impl) return;
-    std::lock_guard<std::mutex> lock(impl->hookMutex);
-    impl->publishHook = nullptr;
+    std::atomic_store_explicit(&impl->publishHook, std::shared_ptr<const PublishHook>{},
+                               std::memory_order_release);
 }
 
 void EventBus::forEachRegisteredType(
@@ -302,34 +484,17 @@ void EventBus::forEachRegisteredType(
     auto impl = impl_;
     if (!impl) return;
 
-    // Snapshot registry to avoid holding locks while calling fn
-    NamedVector<std::pair<std::type_index, SharedPtr<Impl::Entry>>> snapshot{
-        makeNamedVector<std::pair<std::type_index, SharedPtr<Impl::Entry>>>(
-            ContainerName{"EventBusRegisteredTypeSnapshot"})};
-    {
-        std::lock_guard<std::mutex> lock(impl->registryMutex);
-        snapshot.reserve(impl->registry.size());
-        for (const auto& [t, entry] : impl->registry) {
-            snapshot.make(t, entry);
-        }
-    }
-
-    for (const auto& [type, entry] : snapshot) {
-        if (!entry) continue;
+    // Snapshots are immutable, so fn may subscribe or publish freely.
+    const auto registry = impl->loadRegistry();
+    const auto names = std::atomic_load_explicit(&impl->typeNames, std::memory_order_acquire);
+    for (const auto& [type, subscribers] : *registry) {
+        if (!subscribers) continue;
         std::size_t count = 0;
-        {
-            std::lock_guard<std::mutex> lock(entry->mutex);
-            for (const auto& rec : entry->subscribers) {
-                if (rec && rec->active.load(std::memory_order_acquire)) ++count;
-            }
-        }
-        std::string name_str;
-        {
-            std::lock_guard<std::mutex> lock(impl->namesMutex);
-            auto it = impl->typeNames.find(type);
-            if (it != impl->typeNames.end()) name_str = it->second;
+        for (const auto& rec : *subscribers) {
+            if (rec && rec->active.load(std::memory_order_acquire)) ++count;
         }
-        fn(type, name_str, count);
+        auto nameIt = names->find(type);
+        fn(type, nameIt != names->end() ? std::string_view(nameIt->second) : std::string_view(), count);
     }
 }
 
@@ -340,27 +505,50 @@ std::size_t EventBus::drain(std::size_t maxEvents)
         return 0;
     }
 
+    // Deletes whatever is left of a batch if a subscriber throws.
+    struct BatchGuard {
+        Impl::QueueNode* rest = nullptr;
+        ~BatchGuard() { Impl::deleteChain(rest); }
+    };
+
     std::size_t processed = 0;
     while (processed < maxEvents) {
-        std::deque<QueuedEvent> batch;
+        BatchGuard batch;
+        Impl::QueueNode* batchTail = nullptr;
+        std::size_t batchSize = 0;
         {
-            std::lock_guard<std::mutex> lock(impl->queueMutex);
-            while (!impl->queue.empty() && processed < maxEvents) {
-                batch.push_back(std::move(impl->queue.front()));
-                impl->queue.pop_front();
-                ++processed;
+            std::lock_guard<std::mutex> lock(impl->drainMutex);
+            impl->collectIncoming();
+            while (batchSize < Impl::kDrainBatch && processed + batchSize < maxEvents) {
+                Impl::QueueNode* node = impl->popLocal();
+                if (!node) {
+                    break;
+                }
+                if (batchTail) {
+                    batchTail->next = node;
+                } else {
+                    batch.rest = node;
+                }
+                batchTail = node;
+                ++batchSize;
             }
         }
 
-        if (batch.empty()) {
+        if (batchSize == 0) {
             break;
         }
-
-        for (const auto& queued : batch) {
-            if (!queued.dispatch || !queued.payload) {
+        processed += batchSize;
+
+        while (batch.rest) {
+            std::unique_ptr<Impl::QueueNode> node(batch.rest);
+            batch.rest = node->next;
+            QueuedEvent event = node->coalesced
+                ? impl->takeCoalesced(*node)
+                : std::move(node->event);
+            if (!event.dispatch || !event.payload) {
                 continue;
             }
-            queued.dispatch(*this, queued.payload.get(), queued.origin);
+            event.dispatch(*this, event.payload.get(), event.origin);
         }
     }
 
@@ -375,21 +563,20 @@ void EventBus::clear()
     }
 
     {
-        std::lock_guard<std::mutex> lock(impl->registryMutex);
-        for (auto& [type, entry] : impl->registry) {
+        std::lock_guard<std::mutex> lock(impl->writeMutex);
+        const auto current = impl->loadRegistry();
+        for (const auto& [type, subscribers] : *current) {
             (void)type;
-            if (!entry) {
+            if (!subscribers) {
                 continue;
             }
-            std::lock_guard<std::mutex> entryLock(entry->mutex);
-            for (auto& record : entry->subscribers) {
+            for (const auto& record : *subscribers) {
                 if (record) {
                     record->active.store(false, std::memory_order_release);
                 }
             }
-            entry->subscribers.clear();
         }
-        impl->registry.clear();
+        impl->storeRegistry(std::make_shared<const Impl::Registry>());
     }
 
     clearQueue();
@@ -402,8 +589,19 @@ void EventBus::clearQueue()
         return;
     }
 
-    std::lock_guard<std::mutex> lock(impl->queueMutex);
-    impl->queue.clear();
+    Impl::QueueNode* chain = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(impl->drainMutex);
+        chain = impl->detachAll();
+        for (Impl::QueueNode* node = chain; node; node = node->next) {
+            impl->pending.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+    for (auto& shard : impl->coalesceShards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.slots.clear();
+    }
+    Impl::deleteChain(chain);
 }
 
 std::size_t EventBus::pendingCount() const noexcept
@@ -412,9 +610,16 @@ std::size_t EventBus::pendingCount() const noexcept
     if (!impl) {
         return 0;
     }
+    return impl->pending.load(std::memory_order_relaxed);
+}
 
-    std::lock_guard<std::mutex> lock(impl->queueMutex);
-    return impl->queue.size();
+std::size_t EventBus::coalescedCount() const noexcept
+{
+    auto impl = impl_;
+    if (!impl) {
+        return 0;
+    }
+    return impl->coalesced.load(std::memory_order_relaxed);
 }
 
 EventBus& globalEventBus()
@@ -32,12 +32,17 @@ void PosterizeEffect::process(VideoFrame& frame, const CreativeEffectContext& co
     float* gData = g_ch->data();
     float* bData = b_ch->data();
 
-    Parallel::For(0, w * h, w * h, [&](int i) {
+    const float steps = n - 1.0f;
+    const float invSteps = 1.0f / steps;
+    constexpr int kPixelsPerChunk = 16384;
+    Parallel::ForRange(0, w * h, kPixelsPerChunk, [&](ParallelRange range) {
         // 階調を減らす (Quantization)
         // [0.0, 1.0] -> [0.0, n-1] -> floor -> [0.0, 1.0]
-        rData[i] = std::floor(rData[i] * (n - 1.0f) + 0.5f) / (n - 1.0f);
-        gData[i] = std::floor(gData[i] * (n - 1.0f) + 0.5f) / (n - 1.0f);
-        bData[i] = std::floor(bData[i] * (n - 1.0f) + 0.5f) / (n - 1.0f);
+        for (int i = range.begin; i < range.end; ++i) {
+            rData[i] = std::floor(rData[i] * steps + 0.5f) * invSteps;
+            gData[i] = std::floor(gData[i] * steps + 0.5f) * invSteps;
+            bData[i] = std::floor(bData[i] * steps + 0.5f) * invSteps;
+        }
     });
 }
 
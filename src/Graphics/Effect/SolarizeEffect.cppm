@@ -23,13 +23,17 @@ void SolarizeEffect::process(VideoFrame& frame, const CreativeEffectContext&) {
     const int h = frame.height();
     const float th = std::clamp(threshold(), 0.0f, 1.0f);
 
+    const float invRange = 1.0f / std::max(1e-5f, 1.0f - th);
+    constexpr int kPixelsPerChunk = 16384;
     auto apply = [&](float* data) {
-        Parallel::For(0, w * h, w * h, [&](int i) {
-            float v = data[i];
-            if (v > th) {
-                v = 1.0f - (v - th) / std::max(1e-5f, 1.0f - th);
+        Parallel::ForRange(0, w * h, kPixelsPerChunk, [&](ParallelRange range) {
+            for (int i = range.begin; i < range.end; ++i) {
+                float v = data[i];
+                if (v > th) {
+                    v = 1.0f - (v - th) * invRange;
+                }
+                data[i] = std::clamp(v, 0.0f, 1.0f);
             }
-            data[i] = std::clamp(v, 0.0f, 1.0f);
         });
     };
 
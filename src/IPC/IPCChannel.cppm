@@ -5,7 +5,9 @@ module;
 #include <QHostAddress>
 #include <QProcess>
 #include <QElapsedTimer>
+#include <algorithm>
 #include <cstring>
+#include <deque>
 
 module IPC.IPCChannel;
 
@@ -13,10 +15,22 @@ import IPC.SharedMemoryRingBuffer;
 
 namespace ArtifactCore::IPC {
 
+namespace {
+// Ring entry flag: the payload is several messages, each prefixed with its
+// 32-bit length, coalesced between beginStream() and endStream().
+constexpr std::uint32_t kBatchEntryFlag = 0x1u;
+constexpr std::size_t kBatchLengthSize = sizeof(std::uint32_t);
+}
+
 class IPCChannel::Impl {
 public:
     IPCChannelConfig config;
-    std::unique_ptr<SharedMemoryRingBuffer> shared;
+    // Shared memory is one ring per direction: the creator writes "<name>_out"
+    // and reads "<name>_in", the opening side the reverse.
+    std::unique_ptr<SharedMemoryRingBuffer> outbound;
+    std::unique_ptr<SharedMemoryRingBuffer> inbound;
+    QByteArray batch;
+    std::deque<QByteArray> unpacked;
     std::unique_ptr<QLocalSocket> local;
     std::unique_ptr<QTcpSocket> tcp;
     std::unique_ptr<QProcess> pipe;
@@ -34,6 +48,58 @@ public:
         if (tcp) return tcp.get();
         return pipe.get();
     }
+
+    // Blocks up to the channel timeout while the peer's ring is full.
+    bool writeShared(const std::uint8_t* data, std::size_t size, std::uint32_t flags) {
+        if (size > config.bufferSize) return false;
+        return outbound->writeBlocking(data, size, flags, config.timeoutMs).success;
+    }
+
+    bool flushBatch() {
+        if (batch.isEmpty()) return true;
+        const bool written = writeShared(reinterpret_cast<const std::uint8_t*>(batch.constData()),
+                                         static_cast<std::size_t>(batch.size()), kBatchEntryFlag);
+        batch.clear();
+        return written;
+    }
+
+    bool appendToBatch(const std::uint8_t* data, std::size_t size) {
+        if (size == 0) return false;
+        if (size + kBatchLengthSize > config.bufferSize) {
+            return flushBatch() && writeShared(data, size, 0);
+        }
+        if (static_cast<std::size_t>(batch.size()) + kBatchLengthSize + size > config.bufferSize &&
+            !flushBatch()) {
+            return false;
+        }
+        const auto length = static_cast<std::uint32_t>(size);
+        batch.append(reinterpret_cast<const char*>(&length), static_cast<qsizetype>(kBatchLengthSize));
+        batch.append(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size));
+        return true;
+    }
+
+    QByteArray takeShared(SharedMemoryRingBuffer::ReadResult&& entry) {
+        if (!entry.success) return {};
+        if ((entry.flags & kBatchEntryFlag) == 0) return std::move(entry.data);
+        const char* cursor = entry.data.constData();
+        const char* const end = cursor + entry.data.size();
+        while (end - cursor >= static_cast<std::ptrdiff_t>(kBatchLengthSize)) {
+            std::uint32_t length = 0;
+            std::memcpy(&length, cursor, kBatchLengthSize);
+            cursor += kBatchLengthSize;
+            if (length > static_cast<std::size_t>(end - cursor)) break;
+            unpacked.emplace_back(cursor, static_cast<qsizetype>(length));
+            cursor += length;
+        }
+        return popUnpacked();
+    }
+
+    QByteArray popUnpacked() {
+        if (unpacked.empty()) return {};
+        QByteArray message = std::move(unpacked.front());
+        unpacked.pop_front();
+        return message;
+    }
 };
 
 IPCChannel::IPCChannel(std::unique_ptr<Impl> impl) : impl_(std::move(impl)) {}
@@ -43,14 +109,22 @@ std::unique_ptr<IPCChannel> IPCChannel::create(const IPCChannelConfig& config) {
     if (config.name.trimmed().isEmpty()) return {};
     auto impl = std::make_unique<Impl>(config);
     if (config.transport == IPCTransport::SharedMemory) {
+        const QString creatorOut = config.name + QStringLiteral("_out");
+        const QString creatorIn = config.name + QStringLiteral("_in");
         SharedMemoryRingBuffer::Config ring;
-        ring.name = config.name;
         ring.totalSize = std::max<std::size_t>(config.bufferSize * 4, 4096);
         ring.maxEntrySize = config.bufferSize;
         ring.create = config.create;
-        impl->shared = config.create ? SharedMemoryRingBuffer::create(ring)
-                                     : SharedMemoryRingBuffer::open(config.name);
-        if (!impl->shared) {
+        if (config.create) {
+            ring.name = creatorOut;
+            impl->outbound = SharedMemoryRingBuffer::create(ring);
+            ring.name = creatorIn;
+            impl->inbound = SharedMemoryRingBuffer::create(ring);
+        } else {
+            impl->outbound = SharedMemoryRingBuffer::open(creatorIn);
+            impl->inbound = SharedMemoryRingBuffer::open(creatorOut);
+        }
+        if (!impl->outbound || !impl->inbound) {
             IPCChannelConfig fallback = config;
             fallback.transport = IPCTransport::LocalSocket;
             return create(fallback);
@@ -80,7 +154,11 @@ std::unique_ptr<IPCChannel> IPCChannel::create(const IPCChannelConfig& config) {
 
 bool IPCChannel::send(const QByteArray& message) {
     if (!impl_) return false;
-    if (impl_->shared) return impl_->shared->write(message).success;
+    if (impl_->outbound) {
+        const auto* data = reinterpret_cast<const std::uint8_t*>(message.constData());
+        const auto size = static_cast<std::size_t>(message.size());
+        return impl_->streaming ? impl_->appendToBatch(data, size) : impl_->writeShared(data, size, 0);
+    }
     if (!impl_->device()) return false;
     QByteArray framed;
     QDataStream stream(&framed, QIODevice::WriteOnly);
@@ -95,9 +173,9 @@ bool IPCChannel::send(const QByteArray& message) {
 
 QByteArray IPCChannel::receive() {
     if (!impl_) return {};
-    if (impl_->shared) {
-        const auto result = impl_->shared->read();
-        return result.success ? result.data : QByteArray();
+    if (impl_->inbound) {
+        if (!impl_->unpacked.empty()) return impl_->popUnpacked();
+        return impl_->takeShared(impl_->inbound->read());
     }
     if (!impl_->device()) return {};
     impl_->receiveBuffer.append(impl_->device()->readAll());
@@ -113,10 +191,12 @@ QByteArray IPCChannel::receive() {
 }
 
 QByteArray IPCChannel::receiveBlocking(int timeoutMs) {
-    if (!impl_ || impl_->shared) {
-        return impl_ && impl_->shared ? impl_->shared->readBlocking(timeoutMs).data : QByteArray();
-    }
+    if (!impl_) return {};
     const int timeout = timeoutMs < 0 ? impl_->config.timeoutMs : timeoutMs;
+    if (impl_->inbound) {
+        if (!impl_->unpacked.empty()) return impl_->popUnpacked();
+        return impl_->takeShared(impl_->inbound->readBlocking(timeout));
+    }
     const bool ready = impl_->local ? impl_->local->waitForReadyRead(timeout)
                        : impl_->tcp ? impl_->tcp->waitForReadyRead(timeout)
                                     : impl_->pipe->waitForReadyRead(timeout);
@@ -125,7 +205,9 @@ QByteArray IPCChannel::receiveBlocking(int timeoutMs) {
 }
 
 bool IPCChannel::sendZeroCopy(const std::uint8_t* data, std::size_t size) {
-    if (impl_ && impl_->shared) return impl_->shared->write(data, size).success;
+    if (impl_ && impl_->outbound) {
+        return impl_->streaming ? impl_->appendToBatch(data, size) : impl_->writeShared(data, size, 0);
+    }
     return send(QByteArray(reinterpret_cast<const char*>(data), static_cast<qsizetype>(size)));
 }
 
@@ -139,10 +221,15 @@ bool IPCChannel::receiveZeroCopy(std::uint8_t* buffer, std::size_t maxSize, std:
 }
 
 bool IPCChannel::beginStream() { if (impl_) impl_->streaming = true; return isConnected(); }
-bool IPCChannel::endStream() { if (impl_) impl_->streaming = false; return isConnected(); }
+bool IPCChannel::endStream() {
+    if (!impl_) return false;
+    impl_->streaming = false;
+    const bool flushed = !impl_->outbound || impl_->flushBatch();
+    return flushed && isConnected();
+}
 bool IPCChannel::isConnected() const {
     if (!impl_) return false;
-    if (impl_->shared) return impl_->shared->isOpen();
+    if (impl_->outbound) return impl_->outbound->isOpen() && impl_->inbound->isOpen();
     return impl_->local ? impl_->local->state() == QLocalSocket::ConnectedState
          : impl_->tcp ? impl_->tcp->state() == QAbstractSocket::ConnectedState
                       : impl_->pipe && impl_->pipe->state() == QProcess::Running;
@@ -150,12 +237,20 @@ bool IPCChannel::isConnected() const {
 IPCTransport IPCChannel::transport() const { return impl_ ? impl_->config.transport : IPCTransport::Pipe; }
 std::size_t IPCChannel::pendingBytes() const {
     if (!impl_) return 0;
-    if (impl_->shared) return static_cast<std::size_t>(impl_->shared->availableForRead());
+    if (impl_->inbound) {
+        std::size_t unpackedBytes = 0;
+        for (const auto& message : impl_->unpacked) unpackedBytes += static_cast<std::size_t>(message.size());
+        return static_cast<std::size_t>(impl_->inbound->availableForRead()) + unpackedBytes;
+    }
     return static_cast<std::size_t>(impl_->device() ? impl_->device()->bytesAvailable() : 0);
 }
 void IPCChannel::disconnect() {
     if (!impl_) return;
-    if (impl_->shared) impl_->shared->close();
+    if (impl_->outbound) {
+        if (impl_->outbound->isOpen()) impl_->flushBatch();
+        impl_->outbound->close();
+        impl_->inbound->close();
+    }
     if (impl_->local) impl_->local->disconnectFromServer();
     if (impl_->tcp) impl_->tcp->disconnectFromHost();
     if (impl_->pipe) {
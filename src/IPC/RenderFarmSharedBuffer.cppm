@@ -1,119 +1,569 @@
 module;
-#include <cstring>
-#include <QByteArray>
+#include <QSharedMemory>
 #include <QString>
+#include <QThread>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <span>
+#include <utility>
 
 module IPC.RenderFarmSharedBuffer;
 
-import IPC.SharedMemoryRingBuffer;
-
 namespace ArtifactCore::IPC {
 
 namespace {
-constexpr std::uint32_t kFramePacketMagic = 0x41524650; // ARFP
-struct FramePacketHeader {
-    std::uint32_t magic = kFramePacketMagic;
+constexpr std::uint32_t kFramePoolMagic = 0x41524650; // ARFP
+constexpr std::uint32_t kFramePoolVersion = 2;
+constexpr std::size_t kSlotAlignment = 4096;
+
+enum SlotState : std::uint32_t {
+    SlotFree = 0,
+    SlotWriting = 1,
+    SlotReady = 2,
+    SlotReading = 3
+};
+
+// Lives at the start of the segment; the slot table follows, then the
+// page-aligned slot payloads.
+struct alignas(64) FramePoolHeader {
+    std::uint32_t magic = kFramePoolMagic;
+    std::uint32_t version = kFramePoolVersion;
+    std::uint32_t slotCount = 0;
+    std::uint32_t pixelFormat = 0;
+    std::uint32_t tileSize = 0;
+    std::uint32_t maxWidth = 0;
+    std::uint32_t maxHeight = 0;
+    std::uint32_t reserved = 0;
+    std::uint64_t slotBytes = 0;
+    std::uint64_t dataOffset = 0;
+    std::uint64_t createdNs = 0;
+    alignas(64) std::atomic<std::uint64_t> publishSequence{0};
+    std::atomic<std::uint64_t> producedFrames{0};
+    std::atomic<std::uint64_t> consumedFrames{0};
+};
+
+struct alignas(64) FrameSlotHeader {
+    std::atomic<std::uint32_t> state{SlotFree};
     std::uint32_t width = 0;
     std::uint32_t height = 0;
-    std::uint32_t flags = 0;
+    std::uint32_t reserved = 0;
     std::int64_t frameNumber = 0;
+    std::uint64_t sequence = 0;
+    std::uint64_t timestampNs = 0;
 };
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free
+              && std::atomic<std::uint64_t>::is_always_lock_free,
+              "slot states are shared between processes");
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::uint64_t monotonicNs() {
+    // steady_clock is system-wide, so producer and consumer timestamps compare.
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+float halfToFloat(std::uint16_t value) noexcept {
+    const std::uint32_t sign = (value & 0x8000u) << 16u;
+    const std::uint32_t exponent = (value >> 10u) & 0x1fu;
+    const std::uint32_t mantissa = value & 0x3ffu;
+    std::uint32_t bits = sign;
+    if (exponent == 0) {
+        if (mantissa != 0) {
+            const float result = static_cast<float>(mantissa) * (1.0f / 16777216.0f);
+            return sign != 0 ? -result : result;
+        }
+    } else if (exponent == 0x1fu) {
+        bits |= 0x7f800000u | (mantissa << 13u);
+    } else {
+        bits |= ((exponent + 112u) << 23u) | (mantissa << 13u);
+    }
+    float result = 0.0f;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+std::uint16_t floatToHalf(float value) noexcept {
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const std::uint32_t sign = (bits >> 16u) & 0x8000u;
+    const std::uint32_t exponent = (bits >> 23u) & 0xffu;
+    const std::uint32_t mantissa = bits & 0x7fffffu;
+    if (exponent == 0xffu) return static_cast<std::uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u : 0u));
+    const int halfExponent = static_cast<int>(exponent) - 127 + 15;
+    if (halfExponent >= 31) return static_cast<std::uint16_t>(sign | 0x7c00u);
+    if (halfExponent <= 0) {
+        if (halfExponent < -10) return static_cast<std::uint16_t>(sign);
+        const auto shifted = (mantissa | 0x800000u) >> (1 - halfExponent);
+        return static_cast<std::uint16_t>(sign | ((shifted + 0x1000u) >> 13u));
+    }
+    return static_cast<std::uint16_t>(sign |
+        (static_cast<std::uint32_t>(halfExponent) << 10u) |
+        ((mantissa + 0x1000u) >> 13u));
+}
+
+// Calls fn(x, y, count, elementIndex) for every run of pixels that is
+// contiguous both in a scanline image and in the slot layout.
+template <typename Fn>
+void forEachRun(const SharedFrameLayout& layout, Fn&& fn) {
+    if (layout.tileSize == 0) {
+        fn(0u, 0u, layout.pixelCount(), std::size_t{0});
+        return;
+    }
+    const std::uint32_t tile = layout.tileSize;
+    std::size_t element = 0;
+    for (std::uint32_t ty = 0; ty < layout.height; ty += tile) {
+        const std::uint32_t th = std::min(tile, layout.height - ty);
+        for (std::uint32_t tx = 0; tx < layout.width; tx += tile) {
+            const std::uint32_t tw = std::min(tile, layout.width - tx);
+            for (std::uint32_t row = 0; row < th; ++row) {
+                fn(tx, ty + row, std::size_t{tw}, element);
+                element += static_cast<std::size_t>(tw) * 4u;
+            }
+        }
+    }
+}
+
+void storePixels(const SharedFrameLayout& layout, const float* source, std::byte* slot) {
+    forEachRun(layout, [&](std::uint32_t x, std::uint32_t y, std::size_t count, std::size_t element) {
+        const float* in = source + (static_cast<std::size_t>(y) * layout.width + x) * 4u;
+        if (layout.format == SharedFrameFormat::RGBA32F) {
+            std::memcpy(reinterpret_cast<float*>(slot) + element, in, count * 4u * sizeof(float));
+            return;
+        }
+        std::uint16_t* out = reinterpret_cast<std::uint16_t*>(slot) + element;
+        for (std::size_t i = 0; i < count * 4u; ++i) out[i] = floatToHalf(in[i]);
+    });
+}
+
+void loadPixels(const SharedFrameLayout& layout, const std::byte* slot, float* target) {
+    forEachRun(layout, [&](std::uint32_t x, std::uint32_t y, std::size_t count, std::size_t element) {
+        float* out = target + (static_cast<std::size_t>(y) * layout.width + x) * 4u;
+        if (layout.format == SharedFrameFormat::RGBA32F) {
+            std::memcpy(out, reinterpret_cast<const float*>(slot) + element, count * 4u * sizeof(float));
+            return;
+        }
+        const std::uint16_t* in = reinterpret_cast<const std::uint16_t*>(slot) + element;
+        for (std::size_t i = 0; i < count * 4u; ++i) out[i] = halfToFloat(in[i]);
+    });
+}
+}
+
+std::size_t SharedFrameLayout::elementIndex(std::uint32_t x, std::uint32_t y) const {
+    if (tileSize == 0) return (static_cast<std::size_t>(y) * width + x) * 4u;
+    const std::uint32_t tileX = x / tileSize * tileSize;
+    const std::uint32_t tileY = y / tileSize * tileSize;
+    const std::uint32_t tileWidth = std::min(tileSize, width - tileX);
+    const std::uint32_t tileHeight = std::min(tileSize, height - tileY);
+    const std::size_t bandStart = static_cast<std::size_t>(tileY) * width;
+    const std::size_t tileStart = bandStart + static_cast<std::size_t>(tileX) * tileHeight;
+    return (tileStart + static_cast<std::size_t>(y - tileY) * tileWidth + (x - tileX)) * 4u;
 }
 
 class RenderFarmSharedBuffer::Impl {
 public:
     Config config;
-    std::unique_ptr<SharedMemoryRingBuffer> ring;
+    QSharedMemory memory;
+    FramePoolHeader* header = nullptr;
+    FrameSlotHeader* slots = nullptr;
+    std::byte* data = nullptr;
     bool consumer = false;
 
-    explicit Impl(const Config& value, bool isConsumer) : config(value), consumer(isConsumer) {}
+    Impl(const Config& value, bool isConsumer)
+        : config(value), memory(value.bufferName), consumer(isConsumer) {}
+
+    static std::size_t tableBytes(std::uint32_t slotCount) {
+        return alignUp(sizeof(FramePoolHeader) + sizeof(FrameSlotHeader) * slotCount, kSlotAlignment);
+    }
+
+    bool bind() {
+        if (!memory.isAttached() || memory.size() < static_cast<qsizetype>(sizeof(FramePoolHeader)))
+            return false;
+        auto* base = static_cast<std::byte*>(memory.data());
+        header = reinterpret_cast<FramePoolHeader*>(base);
+        if (header->magic != kFramePoolMagic || header->version != kFramePoolVersion
+            || header->slotCount == 0
+            || header->dataOffset < tableBytes(header->slotCount)
+            || header->dataOffset + header->slotBytes * header->slotCount
+                   > static_cast<std::uint64_t>(memory.size())) {
+            header = nullptr;
+            return false;
+        }
+        slots = reinterpret_cast<FrameSlotHeader*>(base + sizeof(FramePoolHeader));
+        data = base + header->dataOffset;
+        config.pixelFormat = static_cast<SharedFrameFormat>(header->pixelFormat);
+        config.tileSize = header->tileSize;
+        config.maxFrameWidth = header->maxWidth;
+        config.maxFrameHeight = header->maxHeight;
+        config.slotCount = header->slotCount;
+        return true;
+    }
+
+    std::byte* slotData(std::uint32_t slot) const {
+        return data + static_cast<std::size_t>(slot) * header->slotBytes;
+    }
+
+    SharedFrameLayout layoutFor(std::uint32_t width, std::uint32_t height) const {
+        SharedFrameLayout layout;
+        layout.width = width;
+        layout.height = height;
+        layout.format = static_cast<SharedFrameFormat>(header->pixelFormat);
+        layout.tileSize = header->tileSize;
+        return layout;
+    }
+
+    bool tryAcquire(std::uint32_t slot, std::uint32_t from, std::uint32_t to) {
+        std::uint32_t expected = from;
+        return slots[slot].state.compare_exchange_strong(
+            expected, to, std::memory_order_acquire, std::memory_order_relaxed);
+    }
+
+    // Free slots are claimed first-come; the consumer takes the oldest ready one.
+    int claimFreeSlot() {
+        for (std::uint32_t i = 0; i < header->slotCount; ++i) {
+            if (slots[i].state.load(std::memory_order_relaxed) == SlotFree
+                && tryAcquire(i, SlotFree, SlotWriting))
+                return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    int claimOldestReadySlot() {
+        for (;;) {
+            int oldest = -1;
+            std::uint64_t oldestSequence = std::numeric_limits<std::uint64_t>::max();
+            for (std::uint32_t i = 0; i < header->slotCount; ++i) {
+                if (slots[i].state.load(std::memory_order_acquire) != SlotReady) continue;
+                if (slots[i].sequence < oldestSequence) {
+                    oldestSequence = slots[i].sequence;
+                    oldest = static_cast<int>(i);
+                }
+            }
+            if (oldest < 0) return -1;
+            if (tryAcquire(static_cast<std::uint32_t>(oldest), SlotReady, SlotReading))
+                return oldest;
+        }
+    }
+
+    void releaseSlot(std::uint32_t slot) {
+        slots[slot].state.store(SlotFree, std::memory_order_release);
+    }
+
+    template <typename Claim>
+    int claimWithTimeout(Claim&& claim, int timeoutMs) {
+        int slot = claim();
+        if (slot >= 0 || timeoutMs <= 0) return slot;
+        QElapsedTimer timer;
+        timer.start();
+        while (slot < 0 && timer.elapsed() < timeoutMs) {
+            QThread::usleep(100);
+            slot = claim();
+        }
+        return slot;
+    }
+
+    std::uint64_t rate(std::uint64_t frames) const {
+        const std::uint64_t elapsed = monotonicNs() - header->createdNs;
+        return elapsed == 0 ? 0 : frames * 1000000000ull / elapsed;
+    }
 };
 
+// -- WriteSlot --
+
+RenderFarmSharedBuffer::WriteSlot::WriteSlot(WriteSlot&& other) noexcept { *this = std::move(other); }
+
+RenderFarmSharedBuffer::WriteSlot& RenderFarmSharedBuffer::WriteSlot::operator=(WriteSlot&& other) noexcept {
+    if (this != &other) {
+        if (owner_) owner_->releaseSlot(slot_);
+        owner_ = std::exchange(other.owner_, nullptr);
+        slot_ = other.slot_;
+        data_ = std::exchange(other.data_, nullptr);
+        layout_ = other.layout_;
+        frameNumber_ = other.frameNumber_;
+    }
+    return *this;
+}
+
+RenderFarmSharedBuffer::WriteSlot::~WriteSlot() {
+    if (owner_) owner_->releaseSlot(slot_);
+}
+
+std::span<float> RenderFarmSharedBuffer::WriteSlot::rgba32f() {
+    if (!owner_ || layout_.format != SharedFrameFormat::RGBA32F) return {};
+    return {reinterpret_cast<float*>(data_), layout_.pixelCount() * 4u};
+}
+
+std::span<std::uint16_t> RenderFarmSharedBuffer::WriteSlot::rgba16f() {
+    if (!owner_ || layout_.format != SharedFrameFormat::RGBA16F) return {};
+    return {reinterpret_cast<std::uint16_t*>(data_), layout_.pixelCount() * 4u};
+}
+
+std::span<std::byte> RenderFarmSharedBuffer::WriteSlot::bytes() {
+    if (!owner_) return {};
+    return {data_, layout_.byteSize()};
+}
+
+bool RenderFarmSharedBuffer::WriteSlot::storeFrom(const ImageF32x4_RGBA& frame) {
+    if (!owner_ || frame.isEmpty() || !frame.rgba32fData()
+        || static_cast<std::uint32_t>(frame.width()) != layout_.width
+        || static_cast<std::uint32_t>(frame.height()) != layout_.height)
+        return false;
+    storePixels(layout_, frame.rgba32fData(), data_);
+    return true;
+}
+
+RenderFarmSharedBuffer::FrameWriteResult RenderFarmSharedBuffer::WriteSlot::publish() {
+    if (!owner_) return {false, 0, QStringLiteral("Slot is not acquired")};
+    auto& header = *owner_->header;
+    auto& slot = owner_->slots[slot_];
+    slot.width = layout_.width;
+    slot.height = layout_.height;
+    slot.frameNumber = frameNumber_;
+    slot.timestampNs = monotonicNs();
+    slot.sequence = header.publishSequence.fetch_add(1, std::memory_order_relaxed) + 1;
+    header.producedFrames.fetch_add(1, std::memory_order_relaxed);
+    const std::uint64_t sequence = slot.sequence;
+    slot.state.store(SlotReady, std::memory_order_release);
+    owner_ = nullptr;
+    data_ = nullptr;
+    return {true, sequence, {}};
+}
+
+// -- FrameView --
+
+RenderFarmSharedBuffer::FrameView::FrameView(FrameView&& other) noexcept { *this = std::move(other); }
+
+RenderFarmSharedBuffer::FrameView& RenderFarmSharedBuffer::FrameView::operator=(FrameView&& other) noexcept {
+    if (this != &other) {
+        release();
+        owner_ = std::exchange(other.owner_, nullptr);
+        slot_ = other.slot_;
+        data_ = std::exchange(other.data_, nullptr);
+        layout_ = other.layout_;
+        frameNumber_ = other.frameNumber_;
+        sequence_ = other.sequence_;
+        timestampNs_ = other.timestampNs_;
+    }
+    return *this;
+}
+
+RenderFarmSharedBuffer::FrameView::~FrameView() { release(); }
+
+std::span<const float> RenderFarmSharedBuffer::FrameView::rgba32f() const {
+    if (!owner_ || layout_.format != SharedFrameFormat::RGBA32F) return {};
+    return {reinterpret_cast<const float*>(data_), layout_.pixelCount() * 4u};
+}
+
+std::span<const std::uint16_t> RenderFarmSharedBuffer::FrameView::rgba16f() const {
+    if (!owner_ || layout_.format != SharedFrameFormat::RGBA16F) return {};
+    return {reinterpret_cast<const std::uint16_t*>(data_), layout_.pixelCount() * 4u};
+}
+
+std::span<const std::byte> RenderFarmSharedBuffer::FrameView::bytes() const {
+    if (!owner_) return {};
+    return {data_, layout_.byteSize()};
+}
+
+bool RenderFarmSharedBuffer::FrameView::copyTo(ImageF32x4_RGBA& frame) const {
+    if (!owner_ || layout_.pixelCount() == 0) return false;
+    if (layout_.format == SharedFrameFormat::RGBA32F && layout_.tileSize == 0) {
+        frame.setFromRGBA32F(reinterpret_cast<const float*>(data_),
+                             static_cast<int>(layout_.width), static_cast<int>(layout_.height));
+        return true;
+    }
+    frame.resize(static_cast<int>(layout_.width), static_cast<int>(layout_.height));
+    if (!frame.rgba32fData()) return false;
+    loadPixels(layout_, data_, frame.rgba32fData());
+    return true;
+}
+
+void RenderFarmSharedBuffer::FrameView::release() {
+    if (!owner_) return;
+    owner_->header->consumedFrames.fetch_add(1, std::memory_order_relaxed);
+    owner_->releaseSlot(slot_);
+    owner_ = nullptr;
+    data_ = nullptr;
+}
+
+// -- RenderFarmSharedBuffer --
+
 RenderFarmSharedBuffer::RenderFarmSharedBuffer(std::unique_ptr<Impl> impl)
     : impl_(std::move(impl)) {}
 RenderFarmSharedBuffer::~RenderFarmSharedBuffer() { close(); }
 
 std::unique_ptr<RenderFarmSharedBuffer> RenderFarmSharedBuffer::createConsumer(const Config& config) {
-    if (config.bufferName.trimmed().isEmpty() || config.totalSizeMB == 0) return {};
-    SharedMemoryRingBuffer::Config ringConfig;
-    ringConfig.name = config.bufferName;
-    ringConfig.totalSize = config.totalSizeMB * 1024ull * 1024ull;
-    ringConfig.maxEntrySize = sizeof(FramePacketHeader) +
-        static_cast<std::size_t>(config.maxFrameWidth) * config.maxFrameHeight * 4u * sizeof(float);
-    ringConfig.create = true;
-    auto ring = SharedMemoryRingBuffer::create(ringConfig);
-    if (!ring) return {};
+    if (config.bufferName.trimmed().isEmpty() || config.totalSizeMB == 0
+        || config.maxFrameWidth == 0 || config.maxFrameHeight == 0)
+        return {};
+    SharedFrameLayout maxLayout;
+    maxLayout.width = config.maxFrameWidth;
+    maxLayout.height = config.maxFrameHeight;
+    maxLayout.format = config.pixelFormat;
+    const std::size_t slotBytes = alignUp(maxLayout.byteSize(), kSlotAlignment);
+    const std::size_t budget = config.totalSizeMB * 1024ull * 1024ull;
+    const std::uint32_t slotCount = config.slotCount > 0
+        ? config.slotCount
+        : static_cast<std::uint32_t>(std::max<std::size_t>(2, budget / slotBytes));
+    const std::size_t dataOffset = Impl::tableBytes(slotCount);
+    const std::size_t totalBytes = dataOffset + slotBytes * slotCount;
+
     auto impl = std::make_unique<Impl>(config, true);
-    impl->ring = std::move(ring);
+    if (!impl->memory.create(static_cast<qsizetype>(totalBytes))) return {};
+    auto* base = static_cast<std::byte*>(impl->memory.data());
+    // Only the header and slot table need clearing; payloads are written before use.
+    std::memset(base, 0, dataOffset);
+    auto* header = reinterpret_cast<FramePoolHeader*>(base);
+    header->magic = kFramePoolMagic;
+    header->version = kFramePoolVersion;
+    header->slotCount = slotCount;
+    header->pixelFormat = static_cast<std::uint32_t>(config.pixelFormat);
+    header->tileSize = config.tileSize;
+    header->maxWidth = config.maxFrameWidth;
+    header->maxHeight = config.maxFrameHeight;
+    header->slotBytes = slotBytes;
+    header->dataOffset = dataOffset;
+    header->createdNs = monotonicNs();
+    if (!impl->bind()) return {};
     return std::unique_ptr<RenderFarmSharedBuffer>(new RenderFarmSharedBuffer(std::move(impl)));
 }
 
 std::unique_ptr<RenderFarmSharedBuffer> RenderFarmSharedBuffer::openProducer(const QString& bufferName) {
-    auto ring = SharedMemoryRingBuffer::open(bufferName);
-    if (!ring) return {};
+    if (bufferName.trimmed().isEmpty()) return {};
     Config config;
     config.bufferName = bufferName;
-    config.totalSizeMB = ring->capacity() / (1024ull * 1024ull);
     auto impl = std::make_unique<Impl>(config, false);
-    impl->ring = std::move(ring);
+    if (!impl->memory.attach(QSharedMemory::ReadWrite) || !impl->bind()) return {};
+    impl->config.totalSizeMB = static_cast<std::size_t>(impl->memory.size()) / (1024ull * 1024ull);
     return std::unique_ptr<RenderFarmSharedBuffer>(new RenderFarmSharedBuffer(std::move(impl)));
 }
 
+RenderFarmSharedBuffer::WriteSlot RenderFarmSharedBuffer::acquireWriteSlot(
+    std::int64_t frameNumber, std::uint32_t width, std::uint32_t height, int timeoutMs) {
+    WriteSlot result;
+    if (!impl_ || !impl_->header || impl_->consumer || width == 0 || height == 0
+        || width > impl_->header->maxWidth || height > impl_->header->maxHeight)
+        return result;
+    const int slot = impl_->claimWithTimeout([this]() { return impl_->claimFreeSlot(); }, timeoutMs);
+    if (slot < 0) return result;
+    result.owner_ = impl_.get();
+    result.slot_ = static_cast<std::uint32_t>(slot);
+    result.data_ = impl_->slotData(result.slot_);
+    result.layout_ = impl_->layoutFor(width, height);
+    result.frameNumber_ = frameNumber;
+    return result;
+}
+
+RenderFarmSharedBuffer::FrameView RenderFarmSharedBuffer::acquireNextFrame(int timeoutMs) {
+    FrameView result;
+    if (!impl_ || !impl_->header || !impl_->consumer) return result;
+    const int slot = impl_->claimWithTimeout([this]() { return impl_->claimOldestReadySlot(); }, timeoutMs);
+    if (slot < 0) return result;
+    const auto& header = impl_->slots[slot];
+    result.owner_ = impl_.get();
+    result.slot_ = static_cast<std::uint32_t>(slot);
+    result.data_ = impl_->slotData(result.slot_);
+    result.layout_ = impl_->layoutFor(header.width, header.height);
+    result.frameNumber_ = header.frameNumber;
+    result.sequence_ = header.sequence;
+    result.timestampNs_ = header.timestampNs;
+    return result;
+}
+
 RenderFarmSharedBuffer::FrameWriteResult RenderFarmSharedBuffer::writeFrame(
     std::int64_t frameNumber, const ImageF32x4_RGBA& frame, std::uint32_t compressionFlags) {
-    if (!impl_ || !impl_->ring || impl_->consumer || frame.isEmpty()) return {false, 0, QStringLiteral("Invalid producer or frame")};
-    const std::size_t pixelBytes = static_cast<std::size_t>(frame.width()) * frame.height() * 4u * sizeof(float);
-    if (pixelBytes > impl_->ring->capacity()) return {false, 0, QStringLiteral("Frame exceeds shared buffer capacity")};
-    FramePacketHeader header;
-    header.width = static_cast<std::uint32_t>(frame.width());
-    header.height = static_cast<std::uint32_t>(frame.height());
-    header.flags = compressionFlags;
-    header.frameNumber = frameNumber;
-    QByteArray packet(static_cast<qsizetype>(sizeof(header) + pixelBytes), Qt::Uninitialized);
-    std::memcpy(packet.data(), &header, sizeof(header));
-    std::memcpy(packet.data() + sizeof(header), frame.rgba32fData(), pixelBytes);
-    const auto result = impl_->ring->write(packet);
-    return {result.success, result.sequenceNumber, result.error};
+    (void)compressionFlags;
+    if (!impl_ || !impl_->header || impl_->consumer || frame.isEmpty())
+        return {false, 0, QStringLiteral("Invalid producer or frame")};
+    if (static_cast<std::uint32_t>(frame.width()) > impl_->header->maxWidth
+        || static_cast<std::uint32_t>(frame.height()) > impl_->header->maxHeight)
+        return {false, 0, QStringLiteral("Frame exceeds shared buffer capacity")};
+    WriteSlot slot = acquireWriteSlot(frameNumber, static_cast<std::uint32_t>(frame.width()),
+                                      static_cast<std::uint32_t>(frame.height()));
+    if (!slot.isValid()) return {false, 0, QStringLiteral("Buffer full")};
+    if (!slot.storeFrom(frame)) return {false, 0, QStringLiteral("Invalid frame pixels")};
+    return slot.publish();
 }
 
 RenderFarmSharedBuffer::FrameReadResult RenderFarmSharedBuffer::readNextFrame() {
-    if (!impl_ || !impl_->ring || !impl_->consumer) return {false, 0, {}, 0, QStringLiteral("Invalid consumer")};
-    const auto result = impl_->ring->read();
-    if (!result.success) return {false, 0, {}, 0, result.error};
-    if (result.data.size() < static_cast<qsizetype>(sizeof(FramePacketHeader))) return {false, 0, {}, result.timestampNs, QStringLiteral("Invalid frame packet")};
-    FramePacketHeader header{};
-    std::memcpy(&header, result.data.constData(), sizeof(header));
-    const std::size_t expected = sizeof(header) + static_cast<std::size_t>(header.width) * header.height * 4u * sizeof(float);
-    if (header.magic != kFramePacketMagic || expected != static_cast<std::size_t>(result.data.size())) return {false, 0, {}, result.timestampNs, QStringLiteral("Invalid frame dimensions")};
+    if (!impl_ || !impl_->header || !impl_->consumer)
+        return {false, 0, {}, 0, QStringLiteral("Invalid consumer")};
+    FrameView view = acquireNextFrame();
+    if (!view.isValid()) return {false, 0, {}, 0, QStringLiteral("Buffer is empty")};
     auto frame = std::make_unique<ImageF32x4_RGBA>();
-    frame->setFromRGBA32F(reinterpret_cast<const float*>(result.data.constData() + sizeof(header)),
-                          static_cast<int>(header.width), static_cast<int>(header.height));
-    return {true, header.frameNumber, std::move(frame), result.timestampNs, {}};
+    if (!view.copyTo(*frame))
+        return {false, view.frameNumber(), {}, view.timestampNs(), QStringLiteral("Invalid frame dimensions")};
+    return {true, view.frameNumber(), std::move(frame), view.timestampNs(), {}};
 }
 
 RenderFarmSharedBuffer::FrameReadResult RenderFarmSharedBuffer::readFrame(std::int64_t frameNumber) {
+    // Older frames are released without conversion.
     for (;;) {
-        auto result = readNextFrame();
-        if (!result.success || result.frameNumber >= frameNumber) return result;
+        FrameView view = acquireNextFrame();
+        if (!view.isValid()) return {false, 0, {}, 0, QStringLiteral("Buffer is empty")};
+        if (view.frameNumber() < frameNumber) continue;
+        auto frame = std::make_unique<ImageF32x4_RGBA>();
+        if (!view.copyTo(*frame))
+            return {false, view.frameNumber(), {}, view.timestampNs(), QStringLiteral("Invalid frame dimensions")};
+        return {true, view.frameNumber(), std::move(frame), view.timestampNs(), {}};
     }
 }
 
+SharedFrameFormat RenderFarmSharedBuffer::pixelFormat() const {
+    return impl_ ? impl_->config.pixelFormat : SharedFrameFormat::RGBA32F;
+}
+std::uint32_t RenderFarmSharedBuffer::tileSize() const { return impl_ ? impl_->config.tileSize : 0; }
+std::uint32_t RenderFarmSharedBuffer::slotCount() const {
+    return impl_ && impl_->header ? impl_->header->slotCount : 0;
+}
+
 int RenderFarmSharedBuffer::pendingFrameCount() const {
-    return impl_ && impl_->ring ? static_cast<int>(impl_->ring->availableForRead() > 0 ? 1 : 0) : 0;
+    if (!impl_ || !impl_->header) return 0;
+    int pending = 0;
+    for (std::uint32_t i = 0; i < impl_->header->slotCount; ++i)
+        pending += impl_->slots[i].state.load(std::memory_order_relaxed) == SlotReady ? 1 : 0;
+    return pending;
 }
 std::size_t RenderFarmSharedBuffer::usedMemoryMB() const {
-    if (!impl_ || !impl_->ring) return 0;
-    return static_cast<std::size_t>((impl_->ring->capacity() - impl_->ring->availableForWrite()) / (1024ull * 1024ull));
+    if (!impl_ || !impl_->header) return 0;
+    std::size_t used = 0;
+    for (std::uint32_t i = 0; i < impl_->header->slotCount; ++i) {
+        if (impl_->slots[i].state.load(std::memory_order_relaxed) != SlotFree)
+            used += impl_->header->slotBytes;
+    }
+    return used / (1024ull * 1024ull);
 }
 std::size_t RenderFarmSharedBuffer::totalMemoryMB() const {
-    return impl_ && impl_->ring ? impl_->ring->capacity() / (1024ull * 1024ull) : 0;
+    return impl_ && impl_->header
+        ? static_cast<std::size_t>(impl_->header->slotBytes * impl_->header->slotCount) / (1024ull * 1024ull)
+        : 0;
 }
 float RenderFarmSharedBuffer::memoryPressure() const {
-    const auto total = totalMemoryMB();
-    return total == 0 ? 0.0f : static_cast<float>(usedMemoryMB()) / static_cast<float>(total);
+    if (!impl_ || !impl_->header) return 0.0f;
+    return static_cast<float>(impl_->header->slotCount - static_cast<std::uint32_t>(
+        std::count_if(impl_->slots, impl_->slots + impl_->header->slotCount, [](const FrameSlotHeader& slot) {
+            return slot.state.load(std::memory_order_relaxed) == SlotFree;
+        }))) / static_cast<float>(impl_->header->slotCount);
+}
+// Average frames per second since the buffer was created.
+std::uint64_t RenderFarmSharedBuffer::consumerFrameRate() const {
+    return impl_ && impl_->header ? impl_->rate(impl_->header->consumedFrames.load(std::memory_order_relaxed)) : 0;
+}
+std::uint64_t RenderFarmSharedBuffer::producerFrameRate() const {
+    return impl_ && impl_->header ? impl_->rate(impl_->header->producedFrames.load(std::memory_order_relaxed)) : 0;
+}
+void RenderFarmSharedBuffer::close() {
+    if (!impl_) return;
+    if (impl_->memory.isAttached()) impl_->memory.detach();
+    impl_->header = nullptr;
+    impl_->slots = nullptr;
+    impl_->data = nullptr;
 }
-std::uint64_t RenderFarmSharedBuffer::consumerFrameRate() const { return 0; }
-std::uint64_t RenderFarmSharedBuffer::producerFrameRate() const { return 0; }
-void RenderFarmSharedBuffer::close() { if (impl_ && impl_->ring) impl_->ring->close(); }
 
 }
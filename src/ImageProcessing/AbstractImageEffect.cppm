@@ -46,6 +46,11 @@ void AbstractImageEffect::chainProcess(ImageF32x4_RGBA& image) {
     }
 }
 
+void AbstractImageEffect::chainProcess(ImageF32x4_RGBA& image, FrameArenaPool& frameArenas) {
+    FrameArenaScope arenaScope(frameArenas);
+    chainProcess(image);
+}
+
 bool AbstractImageEffect::findParamIndex(const std::string& name, size_t& idx) const {
     const auto& params = const_cast<AbstractImageEffect*>(this)->parameters();
     if (params.empty()) return false;
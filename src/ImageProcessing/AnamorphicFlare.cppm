@@ -2,11 +2,13 @@ module;
 #include <algorithm>
 #include <cmath>
 #include <vector>
+#include <memory_resource>
 module ImageProcessing;
 import :AnamorphicFlare;
 import Particle;
 import Image.ImageF32x4_RGBA;
 import Core.Parallel;
+import Memory.ArtifactAllocators;
 
 namespace ArtifactCore {
 
@@ -14,8 +16,8 @@ void AnamorphicFlare::process(float4* buffer, int width, int height, const Anamo
     if (!buffer || width <= 0 || height <= 0) return;
 
     size_t total_pixels = static_cast<size_t>(width * height);
-    std::vector<float4> original(buffer, buffer + total_pixels);
-    std::vector<float4> highlights(total_pixels, float4{0.0f, 0.0f, 0.0f, 0.0f});
+    PmrVector<float4> original(buffer, buffer + total_pixels, frameScratchResource());
+    PmrVector<float4> highlights(total_pixels, float4{0.0f, 0.0f, 0.0f, 0.0f}, frameScratchResource());
 
     float threshold = std::clamp(settings.threshold, 0.0f, 1.0f);
     float decay = std::clamp(settings.flareLength * 0.95f + 0.04f, 0.0f, 0.99f); // Scaled for aesthetic falloff
@@ -34,7 +36,7 @@ void AnamorphicFlare::process(float4* buffer, int width, int height, const Anamo
                 }
     });
 
-    std::vector<float4> streaks(total_pixels, float4{0.0f, 0.0f, 0.0f, 0.0f});
+    PmrVector<float4> streaks(total_pixels, float4{0.0f, 0.0f, 0.0f, 0.0f}, frameScratchResource());
 
     // 2. Horizontal streak propagation pass (O(N) left-to-right & right-to-left decay sweep)
     // Rows are independent - each row processes its own scanline
@@ -2,11 +2,13 @@ module;
 #include <algorithm>
 #include <cmath>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
 module ImageProcessing;
 import :EdgeEcho;
 import Core.Parallel;
+import Memory.ArtifactAllocators;
 
 import Particle;
 import Image.ImageF32x4_RGBA;
@@ -40,7 +42,7 @@ void EdgeEcho::process(float4* buffer, int width, int height, const EdgeEchoSett
     if (!buffer || width <= 0 || height <= 0) return;
 
     size_t total_pixels = static_cast<size_t>(width * height);
-    std::vector<float4> original(buffer, buffer + total_pixels);
+    PmrVector<float4> original(buffer, buffer + total_pixels, frameScratchResource());
 
     // 1. Initialize or resize history buffer
     if (!impl_->has_history || impl_->history.width() != width || impl_->history.height() != height) {
@@ -52,7 +54,7 @@ void EdgeEcho::process(float4* buffer, int width, int height, const EdgeEchoSett
     float* history_raw = impl_->history.rgba32fData();
     if (!history_raw) return;
 
-    std::vector<float> current_edges(total_pixels, 0.0f);
+    PmrVector<float> current_edges(total_pixels, 0.0f, frameScratchResource());
     float edge_thresh = std::max(settings.edgeThreshold, 0.001f);
 
     // 2. Sobel edge detection pass (on luminance of current frame)
@@ -85,12 +87,12 @@ void EdgeEcho::process(float4* buffer, int width, int height, const EdgeEchoSett
     });
 
     // Temporary buffer to calculate the warped new history
-    std::vector<float> next_history(total_pixels, 0.0f);
+    PmrVector<float> next_history(total_pixels, 0.0f, frameScratchResource());
     float decay = std::clamp(settings.decay, 0.0f, 1.0f);
     float wave_amp = settings.waveAmp;
     float wave_freq = settings.waveFreq;
     float time_val = settings.timeEvolution;
-    std::vector<float> waveOffsets(static_cast<std::size_t>(width));
+    PmrVector<float> waveOffsets(static_cast<std::size_t>(width), frameScratchResource());
     for (int x = 0; x < width; ++x) {
         waveOffsets[static_cast<std::size_t>(x)] =
             wave_amp * std::sin(kTwoPi * wave_freq *
@@ -1,12 +1,14 @@
 module;
 #include <utility>
 #include <vector>
+#include <memory_resource>
 #include <cmath>
 #include <algorithm>
 
 module ImageProcessing.FluidVisualizer;
 
 import Core.Parallel;
+import Memory.ArtifactAllocators;
 
 namespace ArtifactCore {
 
@@ -37,7 +39,7 @@ float4 FluidVisualizer::sampleGradient(float t, const Style& style) {
 void FluidVisualizer::render(float4* buffer, int width, int height, const FluidSolver2D& fluid, const Style& style) {
     if (!buffer || width <= 0 || height <= 0) return;
 
-    std::vector<float4> source(buffer, buffer + width * height);
+    PmrVector<float4> source(buffer, buffer + width * height, frameScratchResource());
     
     float gx = static_cast<float>(fluid.width()) / width;
     float gy = static_cast<float>(fluid.height()) / height;
@@ -3,11 +3,13 @@ module;
 #include <cmath>
 #include <vector>
 #include <array>
+#include <memory_resource>
 module ImageProcessing;
 import :Halftone;
 import Particle;
 import Image.ImageF32x4_RGBA;
 import Core.Parallel;
+import Memory.ArtifactAllocators;
 
 namespace ArtifactCore {
 
@@ -96,7 +98,7 @@ namespace {
 void Halftone::process(float4* buffer, int width, int height, const HalftoneSettings& settings) {
     if (!buffer || width <= 0 || height <= 0) return;
 
-    std::vector<float4> original(buffer, buffer + width * height);
+    PmrVector<float4> original(buffer, buffer + width * height, frameScratchResource());
     float dotSize = std::max(settings.dotSize, 2.0f);
     float halfDot = dotSize * 0.5f;
 
@@ -142,7 +144,7 @@ void Halftone::process(float4* buffer, int width, int height, const HalftoneSett
         // CMYK: 4 separations, each with its own angle
         // Convert RGB → CMYK (naive inverse)
         // Assume src is sRGB 0-1
-        std::vector<std::array<float, 4>> cmyk(width * height);
+        PmrVector<std::array<float, 4>> cmyk(width * height, frameScratchResource());
         for (int y = 0; y < height; ++y) {
             for (int x = 0; x < width; ++x) {
                 const int i = y * width + x;
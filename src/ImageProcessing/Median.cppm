@@ -2,10 +2,12 @@ module;
 #include <algorithm>
 #include <cmath>
 #include <vector>
+#include <memory_resource>
 
 module ImageProcessing;
 import :Median;
 import Core.Parallel;
+import Memory.ArtifactAllocators;
 
 import Particle;
 import Image.ImageF32x4_RGBA;
@@ -52,7 +54,8 @@ void Median::process(float4* buffer, int width, int height, const MedianSettings
     const int r = std::max(1, settings.radius);
 
     if (r == 1) {
-        std::vector<float4> tmp(static_cast<size_t>(width) * static_cast<size_t>(height));
+        PmrVector<float4> tmp(static_cast<size_t>(width) * static_cast<size_t>(height),
+                              frameScratchResource());
         median3x3(buffer, tmp.data(), width, height);
         std::copy(tmp.begin(), tmp.end(), buffer);
     }
@@ -2,18 +2,20 @@ module;
 #include <algorithm>
 #include <random>
 #include <vector>
+#include <memory_resource>
 
 module ImageProcessing;
 import :Scatter;
 import Core.Parallel;
+import Memory.ArtifactAllocators;
 
 namespace ArtifactCore {
 
 void Scatter::process(float4* buffer, int width, int height, const ScatterSettings& s) {
     const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
-    std::vector<float4> tmp(pixelCount);
+    PmrVector<float4> tmp(pixelCount, frameScratchResource());
     std::copy_n(buffer, pixelCount, tmp.data());
-    std::vector<size_t> sourceIndices(pixelCount);
+    PmrVector<size_t> sourceIndices(pixelCount, frameScratchResource());
     std::mt19937 rng(static_cast<unsigned>(s.seed));
     float inv = 1.0f / 65535.0f;
     for (int y = 0; y < height; ++y) {
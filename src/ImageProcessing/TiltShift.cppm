@@ -2,6 +2,7 @@ module;
 #include <algorithm>
 #include <cmath>
 #include <vector>
+#include <memory_resource>
 
 module ImageProcessing;
 import :TiltShift;
@@ -9,18 +10,19 @@ import :TiltShift;
 import Particle;
 import Image.ImageF32x4_RGBA;
 import Core.Parallel;
+import Memory.ArtifactAllocators;
 
 namespace ArtifactCore {
 
 namespace {
     // A fast horizontal and vertical box-blur pass to create the blurred reference image
-    void fastBlur(const std::vector<float4>& src, std::vector<float4>& dst, int w, int h, int radius) {
+    void fastBlur(const PmrVector<float4>& src, PmrVector<float4>& dst, int w, int h, int radius) {
         if (radius <= 0) {
             dst = src;
             return;
         }
 
-        std::vector<float4> temp(w * h);
+        PmrVector<float4> temp(w * h, frameScratchResource());
 
         // Horizontal pass — each row is independent
         Parallel::For(0, h, w * h, [&](int y) {
@@ -64,8 +66,8 @@ void TiltShift::process(float4* buffer, int width, int height, const TiltShiftSe
     if (!buffer || width <= 0 || height <= 0) return;
 
     // 1. Create blurred copy
-    std::vector<float4> original(buffer, buffer + width * height);
-    std::vector<float4> blurred(width * height);
+    PmrVector<float4> original(buffer, buffer + width * height, frameScratchResource());
+    PmrVector<float4> blurred(width * height, frameScratchResource());
 
     // Box blur radius depends on image size for aesthetic balance, clamped to a reasonable range
     int blur_radius = std::clamp(std::max(width, height) / 100, 3, 20);
@@ -44,6 +44,7 @@ module;
 module Math.Noise;
 
 import Container.NamedVector;
+import Script.Expression.MemoCache;
 
 namespace ArtifactCore {
 
@@ -51,7 +52,7 @@ namespace ArtifactCore {
 static int p[512];
 static bool isInitialized = false;
 
-void NoiseGenerator::setSeed(unsigned int seed) {
+static void buildPermutation(unsigned int seed) {
     NamedVector<int> permutation;
     permutation.resize(256);
     std::iota(permutation.begin(), permutation.end(), 0);
@@ -64,9 +65,15 @@ void NoiseGenerator::setSeed(unsigned int seed) {
     isInitialized = true;
 }
 
+void NoiseGenerator::setSeed(unsigned int seed) {
+    buildPermutation(seed);
+    // noise() / wiggle() の memo 結果は旧テーブルに基づくので破棄する
+    ExpressionMemoCache::shared().invalidateAll();
+}
+
 static void ensureInitialized() {
     if (!isInitialized) {
-        NoiseGenerator::setSeed(42); // Default seed
+        buildPermutation(42); // Default seed
     }
 }
 
@@ -87,7 +94,10 @@ float NoiseGenerator::grad(int hash, float x, float y, float z) {
 
 float NoiseGenerator::perlin(float x, float y, float z) {
     ensureInitialized();
+    return perlinUnchecked(x, y, z);
+}
 
+float NoiseGenerator::perlinUnchecked(float x, float y, float z) {
     int X = static_cast<int>(std::floor(x)) & 255;
     int Y = static_cast<int>(std::floor(y)) & 255;
     int Z = static_cast<int>(std::floor(z)) & 255;
@@ -135,6 +145,39 @@ float NoiseGenerator::fractal(float x, float y, float z, int octaves, float pers
     return total / maxValue;
 }
 
+void NoiseGenerator::perlinBatch(const float* x, const float* y, const float* z, float* out, int count) {
+    if (!x || !out || count <= 0) return;
+    ensureInitialized();
+    for (int i = 0; i < count; ++i) {
+        out[i] = perlinUnchecked(x[i], y ? y[i] : 0.0f, z ? z[i] : 0.0f);
+    }
+}
+
+void NoiseGenerator::fractalBatch(const float* x, const float* y, const float* z, float* out, int count,
+                                  int octaves, float persistence, float lacunarity) {
+    if (!x || !out || count <= 0) return;
+    ensureInitialized();
+
+    // オクターブを外側に回し、各レーンの演算順序はスカラー版と同じに保つ
+    std::fill(out, out + count, 0.0f);
+    float frequency = 1;
+    float amplitude = 1;
+    float maxValue = 0;
+    for (int octave = 0; octave < octaves; octave++) {
+        for (int i = 0; i < count; ++i) {
+            out[i] += perlinUnchecked(x[i] * frequency,
+                                      (y ? y[i] : 0.0f) * frequency,
+                                      (z ? z[i] : 0.0f) * frequency) * amplitude;
+        }
+        maxValue += amplitude;
+        amplitude *= persistence;
+        frequency *= lacunarity;
+    }
+    for (int i = 0; i < count; ++i) {
+        out[i] /= maxValue;
+    }
+}
+
 float NoiseGenerator::worley(float x, float y, float z) {
     int xi = static_cast<int>(std::floor(x));
     int yi = static_cast<int>(std::floor(y));
@@ -1,11 +1,13 @@
 module;
 #include <memory>
+#include <vector>
 #include <algorithm>
 #include <functional>
 #include <QString>
 #include <QByteArray>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QTimer>
 #include <QtNetwork/QTcpSocket>
 #include <QtNetwork/QSslSocket>
@@ -17,6 +19,8 @@ module;
 
 module NetworkRPCClient;
 
+import Network.RpcWire;
+
 namespace ArtifactCore {
 
 class NetworkRPCClient::Impl {
@@ -35,12 +39,22 @@ public:
     qint64 heartbeatRttMs_ = -1;
     bool tlsEnabled_ = false;
     QString caCertificateFile_;
+    bool binaryProtocolEnabled_ = true;
+    bool wireBinary_ = false;
+    bool wireCompress_ = false;
+    std::vector<RpcFrameReport> pendingReports_;
+    bool reportFlushScheduled_ = false;
 
     JobAssignedCallback onJobAssigned_;
+    JobRevisedCallback onJobRevised_;
     DisconnectedCallback onDisconnected_;
 
     // Heartbeat interval (same as server's check interval)
     static constexpr qint64 HEARTBEAT_INTERVAL_MS = 5000;
+    // Binary mode batches frame reports: a batch is sent when full, when any
+    // other message goes out, or after this delay.
+    static constexpr size_t MAX_REPORT_BATCH = 64;
+    static constexpr int REPORT_FLUSH_DELAY_MS = 10;
 
     Impl() {
         socket_ = new QSslSocket();
@@ -57,6 +71,9 @@ public:
         if (connected_) return false;
         workerId_ = workerId;
         readBuffer_.clear();
+        wireBinary_ = false;
+        wireCompress_ = false;
+        pendingReports_.clear();
 
         if (!signalConnectionsInstalled_) {
             QObject::connect(socket_, &QTcpSocket::connected, [this]() {
@@ -94,6 +111,7 @@ public:
     }
 
     void disconnectInternal() {
+        flushReports();
         if (heartbeatTimer_) heartbeatTimer_->stop();
         if (socket_) {
             socket_->disconnectFromHost();
@@ -102,6 +120,8 @@ public:
         }
         connected_ = false;
         readBuffer_.clear();
+        wireBinary_ = false;
+        pendingReports_.clear();
     }
 
     void sendRegistration() {
@@ -109,6 +129,10 @@ public:
         params["workerId"] = workerId_;
         if (!authToken_.isEmpty()) params["authToken"] = authToken_;
         params["capabilities"] = capabilities_;
+        if (binaryProtocolEnabled_) {
+            params["wireProtocols"] = QJsonArray{RpcWireCodec::protocolName()};
+            params["compression"] = QJsonArray{RpcWireCodec::compressionName()};
+        }
         sendMessage(QStringLiteral("register"), params);
         connected_ = true;
 
@@ -134,16 +158,32 @@ public:
 
     void sendMessage(const QString& method, const QJsonObject& params) {
         if (!socket_ || !connected_) return;
+        // Queued frame reports go first so later messages (requestFrames) cannot overtake them.
+        flushReports();
         QJsonObject msg;
         msg["jsonrpc"] = "2.0";
         msg["method"] = method;
         msg["params"] = params;
         msg["id"] = static_cast<qint64>(nextRpcId_++);
-        QByteArray data = QJsonDocument(msg).toJson(QJsonDocument::Compact) + "\n";
+        const QByteArray data = wireBinary_
+            ? RpcWireCodec::encodeFrame(RpcWireType::Envelope,
+                                        RpcWireCodec::encodeEnvelope(msg), wireCompress_)
+            : QJsonDocument(msg).toJson(QJsonDocument::Compact) + "\n";
         socket_->write(data);
         socket_->flush();
     }
 
+    void flushReports() {
+        if (pendingReports_.empty()) return;
+        if (socket_ && connected_ && wireBinary_) {
+            socket_->write(RpcWireCodec::encodeFrame(
+                RpcWireType::FrameReports,
+                RpcWireCodec::encodeFrameReports(workerId_, pendingReports_), wireCompress_));
+            socket_->flush();
+        }
+        pendingReports_.clear();
+    }
+
     void onData() {
         readBuffer_.append(socket_->readAll());
         constexpr qsizetype kMaxRpcMessageBytes = 16 * 1024 * 1024;
@@ -151,18 +191,33 @@ public:
             disconnectInternal();
             return;
         }
-        // Process complete JSON lines
+        // JSON lines until registration is answered, binary frames afterwards
+        // when both sides support them.
+        qsizetype offset = 0;
+        RpcWireMessage frame;
+        QByteArray line;
         while (true) {
-            const qsizetype nl = readBuffer_.indexOf('\n');
-            if (nl < 0) break;
-            QByteArray line = readBuffer_.left(nl).trimmed();
-            readBuffer_.remove(0, nl + 1);
-            if (line.isEmpty()) continue;
-            QJsonParseError parseError;
-            const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
-            if (parseError.error != QJsonParseError::NoError || !doc.isObject()) continue;
-            handleMessage(doc.object());
+            const RpcWireStatus status = RpcWireCodec::takeMessage(
+                readBuffer_, offset, kMaxRpcMessageBytes, frame, line);
+            if (status == RpcWireStatus::NeedMore) break;
+            if (status == RpcWireStatus::Error) {
+                disconnectInternal();
+                return;
+            }
+            QJsonObject msg;
+            if (status == RpcWireStatus::Frame) {
+                if (frame.type != RpcWireType::Envelope
+                    || !RpcWireCodec::decodeEnvelope(frame.payload, msg)) continue;
+            } else {
+                if (line.isEmpty()) continue;
+                QJsonParseError parseError;
+                const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+                if (parseError.error != QJsonParseError::NoError || !doc.isObject()) continue;
+                msg = doc.object();
+            }
+            handleMessage(msg);
         }
+        readBuffer_.remove(0, offset);
     }
 
     void handleMessage(const QJsonObject& msg) {
@@ -170,8 +225,18 @@ public:
         if (method == QStringLiteral("assignJob")) {
             QJsonObject params = msg["params"].toObject();
             if (onJobAssigned_) onJobAssigned_(params);
+        } else if (method == QStringLiteral("reviseJob")) {
+            QJsonObject params = msg["params"].toObject();
+            if (onJobRevised_) onJobRevised_(params);
         }
         const QJsonObject result = msg["result"].toObject();
+        if (binaryProtocolEnabled_
+            && result.value(QStringLiteral("status")).toString() == QStringLiteral("registered")
+            && result.value(QStringLiteral("wire")).toString() == RpcWireCodec::protocolName()) {
+            wireBinary_ = true;
+            wireCompress_ = result.value(QStringLiteral("compression")).toString()
+                == RpcWireCodec::compressionName();
+        }
         if (result.value(QStringLiteral("status")).toString() == QStringLiteral("heartbeat")
             && heartbeatSentAtMs_ > 0) {
             heartbeatRttMs_ = std::max<qint64>(0,
@@ -182,6 +247,23 @@ public:
 
     bool sendFrameResult(const QString& method, int frame, const QString& error) {
         if (!connected_) return false;
+        if (wireBinary_) {
+            RpcFrameReport report;
+            report.frame = frame;
+            report.success = method == QStringLiteral("frameCompleted");
+            report.error = error;
+            pendingReports_.push_back(std::move(report));
+            if (pendingReports_.size() >= MAX_REPORT_BATCH) {
+                flushReports();
+            } else if (!reportFlushScheduled_) {
+                reportFlushScheduled_ = true;
+                QTimer::singleShot(REPORT_FLUSH_DELAY_MS, socket_, [this]() {
+                    reportFlushScheduled_ = false;
+                    flushReports();
+                });
+            }
+            return true;
+        }
         QJsonObject params;
         params["workerId"] = workerId_;
         params["frame"] = frame;
@@ -228,10 +310,22 @@ void NetworkRPCClient::setTlsEnabled(bool enabled, const QString& caCertificateF
     impl_->caCertificateFile_ = caCertificateFile;
 }
 
+void NetworkRPCClient::setBinaryProtocolEnabled(bool enabled) {
+    impl_->binaryProtocolEnabled_ = enabled;
+}
+
+bool NetworkRPCClient::binaryProtocolActive() const {
+    return impl_->wireBinary_;
+}
+
 void NetworkRPCClient::setOnJobAssigned(JobAssignedCallback cb) {
     impl_->onJobAssigned_ = std::move(cb);
 }
 
+void NetworkRPCClient::setOnJobRevised(JobRevisedCallback cb) {
+    impl_->onJobRevised_ = std::move(cb);
+}
+
 void NetworkRPCClient::setOnDisconnected(DisconnectedCallback cb) {
     impl_->onDisconnected_ = std::move(cb);
 }
@@ -257,6 +351,14 @@ bool NetworkRPCClient::sendWorkerProgress(int completedFrames, int failedFrames,
     return true;
 }
 
+bool NetworkRPCClient::requestFrames() {
+    if (!impl_->connected_) return false;
+    QJsonObject params;
+    params[QStringLiteral("workerId")] = impl_->workerId_;
+    impl_->sendMessage(QStringLiteral("requestFrames"), params);
+    return true;
+}
+
 bool NetworkRPCClient::sendWorkerLog(const QString& severity, const QString& message, int frame) {
     if (!impl_->connected_) return false;
     QJsonObject params;
@@ -28,6 +28,7 @@ module;
 module NetworkRPCServer;
 
 import Container.NamedVector;
+import Network.RpcWire;
 
 namespace ArtifactCore {
 
@@ -56,6 +57,12 @@ protected:
     }
 };
 
+// Per-connection encoding agreed at registration.
+struct SocketWireMode {
+    bool binary = false;
+    bool compress = false;
+};
+
 class NetworkPCServer::Impl {
 public:
     FarmTcpServer* server_ = nullptr;
@@ -68,6 +75,7 @@ public:
     std::map<QTcpSocket*, RemoteWorkerInfo> workers_;
     std::map<QString, QTcpSocket*> workerSockets_;
     std::map<QTcpSocket*, QByteArray> readBuffers_;
+    std::map<QTcpSocket*, SocketWireMode> wireModes_;
     QJsonArray workerLogs_;
     mutable std::mutex mutex_;
 
@@ -81,6 +89,7 @@ public:
     QSslCertificate tlsCertificate_;
     QSslKey tlsPrivateKey_;
     bool tlsEnabled_ = false;
+    bool binaryProtocolEnabled_ = true;
 
     // Heartbeat: timer-based dead detection via QObject::connect + singleShot chain
     static constexpr qint64 HEARTBEAT_TIMEOUT_MS = 30000;
@@ -149,24 +158,68 @@ public:
             socket->disconnectFromHost();
             return;
         }
+        // JSON lines and binary frames may be interleaved: a worker switches
+        // to binary as soon as its registration is answered.
+        qsizetype offset = 0;
+        RpcWireMessage frame;
+        QByteArray line;
         while (true) {
-            const qsizetype newline = buffer.indexOf('\n');
-            if (newline < 0) break;
-            const QByteArray line = buffer.left(newline).trimmed();
-            buffer.remove(0, newline + 1);
-            if (line.isEmpty()) continue;
-            QJsonParseError parseError;
-            const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
-            if (parseError.error != QJsonParseError::NoError || !doc.isObject()) continue;
-            const QJsonObject msg = doc.object();
-            const QString method = msg["method"].toString();
-            if (method == "register") {
-                handleRegister(socket, msg);
-            } else if (method == "heartbeat") {
-                handleHeartbeat(socket, msg);
-            } else {
-                handleRpc(socket, msg);
+            const RpcWireStatus status = RpcWireCodec::takeMessage(
+                buffer, offset, kMaxRpcMessageBytes, frame, line);
+            if (status == RpcWireStatus::NeedMore) break;
+            if (status == RpcWireStatus::Error) {
+                qWarning() << "[Farm] Malformed RPC frame:" << socket->peerAddress().toString();
+                socket->disconnectFromHost();
+                return;
+            }
+            if (status == RpcWireStatus::Frame) {
+                if (frame.type == RpcWireType::FrameReports) {
+                    handleFrameReports(socket, frame.payload);
+                } else {
+                    QJsonObject msg;
+                    if (RpcWireCodec::decodeEnvelope(frame.payload, msg))
+                        dispatchMessage(socket, msg);
+                }
+            } else if (!line.isEmpty()) {
+                QJsonParseError parseError;
+                const QJsonDocument doc = QJsonDocument::fromJson(line, &parseError);
+                if (parseError.error == QJsonParseError::NoError && doc.isObject())
+                    dispatchMessage(socket, doc.object());
             }
+            // A handler may have dropped the connection and its buffer.
+            if (!readBuffers_.contains(socket)) return;
+        }
+        buffer.remove(0, offset);
+    }
+
+    void dispatchMessage(QTcpSocket* socket, const QJsonObject& msg) {
+        const QString method = msg["method"].toString();
+        if (method == "register") {
+            handleRegister(socket, msg);
+        } else if (method == "heartbeat") {
+            handleHeartbeat(socket, msg);
+        } else {
+            handleRpc(socket, msg);
+        }
+    }
+
+    // Batched frameCompleted / frameFailed reports. They are fire-and-forget:
+    // no response is sent per frame.
+    void handleFrameReports(QTcpSocket* socket, const QByteArray& payload) {
+        QString workerId;
+        std::vector<RpcFrameReport> reports;
+        if (!RpcWireCodec::decodeFrameReports(payload, workerId, reports)) {
+            qWarning() << "[Farm] Ignoring malformed frame report batch";
+            return;
+        }
+        for (const auto& report : reports) {
+            QJsonObject params{
+                {QStringLiteral("workerId"), workerId},
+                {QStringLiteral("frame"), report.frame}
+            };
+            if (!report.error.isEmpty()) params[QStringLiteral("error")] = report.error;
+            dispatchRpc(socket, report.success ? QStringLiteral("frameCompleted")
+                                               : QStringLiteral("frameFailed"), params);
         }
     }
 
@@ -191,6 +244,7 @@ public:
             if (existingSocket != workerSockets_.end() && existingSocket->second != socket) {
                 qWarning() << "[Farm] Replacing stale worker connection:" << workerId;
                 readBuffers_.erase(existingSocket->second);
+                wireModes_.erase(existingSocket->second);
                 workers_.erase(existingSocket->second);
                 existingSocket->second->disconnectFromHost();
                 workerSockets_.erase(existingSocket);
@@ -206,11 +260,28 @@ public:
             }
         }
 
+        // Binary framing is offered by the worker and enabled here once the
+        // (still JSON) registration response is on its way.
+        SocketWireMode wireMode;
+        if (binaryProtocolEnabled_
+            && params["wireProtocols"].toArray().contains(RpcWireCodec::protocolName())) {
+            wireMode.binary = true;
+            wireMode.compress = params["compression"].toArray().contains(RpcWireCodec::compressionName());
+        }
+        QJsonObject result{{"status", "registered"}};
+        if (wireMode.binary) {
+            result["wire"] = RpcWireCodec::protocolName();
+            if (wireMode.compress) result["compression"] = RpcWireCodec::compressionName();
+        }
         QJsonObject resp;
         resp["jsonrpc"] = "2.0";
         resp["id"] = msg["id"];
-        resp["result"] = QJsonObject{{"status", "registered"}};
+        resp["result"] = result;
         sendJson(socket, resp);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            wireModes_[socket] = wireMode;
+        }
 
         if (onWorkerConnected_) {
             onWorkerConnected_(NetworkPCServer::instance().workerInfo(workerId));
@@ -249,11 +320,20 @@ public:
     }
 
     void handleRpc(QTcpSocket* socket, const QJsonObject& msg) {
-        QString method = msg["method"].toString();
-        QJsonObject params = msg["params"].toObject();
+        const QJsonObject result = dispatchRpc(
+            socket, msg["method"].toString(), msg["params"].toObject());
+        QJsonObject resp;
+        resp["jsonrpc"] = "2.0";
+        resp["id"] = msg["id"];
+        resp["result"] = result;
+        sendJson(socket, resp);
+    }
+
+    QJsonObject dispatchRpc(QTcpSocket* socket, const QString& method, const QJsonObject& params) {
         const bool workerScopedRequest = method == QStringLiteral("workerProgress")
             || method == QStringLiteral("frameCompleted")
             || method == QStringLiteral("frameFailed")
+            || method == QStringLiteral("requestFrames")
             || method == QStringLiteral("workerLog");
         bool workerIdentityValid = true;
         if (workerScopedRequest) {
@@ -328,12 +408,7 @@ public:
             result[QStringLiteral("status")] = QStringLiteral("rejected");
         } else if (onRequest_)
             result = onRequest_(method, params);
-
-        QJsonObject resp;
-        resp["jsonrpc"] = "2.0";
-        resp["id"] = msg["id"];
-        resp["result"] = result;
-        sendJson(socket, resp);
+        return result;
     }
 
     void onDisconnect(QTcpSocket* socket) {
@@ -347,6 +422,7 @@ public:
                 workers_.erase(it);
             }
             readBuffers_.erase(socket);
+            wireModes_.erase(socket);
         }
         if (!workerId.isEmpty() && onWorkerDisconnected_)
             onWorkerDisconnected_(workerId);
@@ -370,7 +446,16 @@ public:
     }
 
     void sendJson(QTcpSocket* socket, const QJsonObject& obj) {
-        QByteArray data = QJsonDocument(obj).toJson(QJsonDocument::Compact) + "\n";
+        SocketWireMode wireMode;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            const auto it = wireModes_.find(socket);
+            if (it != wireModes_.end()) wireMode = it->second;
+        }
+        const QByteArray data = wireMode.binary
+            ? RpcWireCodec::encodeFrame(RpcWireType::Envelope,
+                                        RpcWireCodec::encodeEnvelope(obj), wireMode.compress)
+            : QJsonDocument(obj).toJson(QJsonDocument::Compact) + "\n";
         socket->write(data);
         socket->flush();
     }
@@ -386,6 +471,7 @@ public:
             workers_.clear();
             workerSockets_.clear();
             readBuffers_.clear();
+            wireModes_.clear();
         }
         if (server_->isListening())
             server_->close();
@@ -1512,6 +1598,30 @@ bool NetworkPCServer::sendJobAssignment(const QString& wid, const QJsonObject& j
     return true;
 }
 
+bool NetworkPCServer::sendJobRevision(const QString& wid, const QJsonObject& revision, int withdrawnFrames) {
+    QTcpSocket* s = impl_->findSocket(wid);
+    if (!s) return false;
+    QJsonObject msg;
+    msg["jsonrpc"] = "2.0"; msg["method"] = "reviseJob"; msg["params"] = revision;
+    msg["id"] = static_cast<qint64>(impl_->nextRpcId_++);
+    impl_->sendJson(s, msg);
+    if (withdrawnFrames <= 0) return true;
+    {
+        std::lock_guard<std::mutex> lock(impl_->mutex_);
+        auto it = impl_->workerSockets_.find(wid);
+        if (it != impl_->workerSockets_.end()) {
+            auto wit = impl_->workers_.find(it->second);
+            if (wit != impl_->workers_.end())
+            {
+                wit->second.assignedFrames = std::max(0, wit->second.assignedFrames - withdrawnFrames);
+                if (wit->second.assignedFrames == 0 && wit->second.state == QStringLiteral("Rendering"))
+                    wit->second.state = QStringLiteral("Idle");
+            }
+        }
+    }
+    return true;
+}
+
 QJsonObject NetworkPCServer::requestWorkerStatus(const QString& wid) {
     QTcpSocket* s = impl_->findSocket(wid);
     if (!s) return {{"error", "not found"}};
@@ -1529,6 +1639,7 @@ void NetworkPCServer::setHttpStatusProvider(HttpStatusProvider provider) {
     impl_->httpStatusProvider_ = std::move(provider);
 }
 void NetworkPCServer::setAuthToken(const QString& token) { impl_->authToken_ = token; }
+void NetworkPCServer::setBinaryProtocolEnabled(bool enabled) { impl_->binaryProtocolEnabled_ = enabled; }
 
 bool NetworkPCServer::setWorkerMaintenance(const QString& workerId, bool maintenance) {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
@@ -0,0 +1,173 @@
+module;
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <QString>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QCborValue>
+#include <QtEndian>
+
+module Network.RpcWire;
+
+namespace ArtifactCore {
+
+namespace {
+
+// Largest error text carried per report; longer messages are truncated.
+constexpr qsizetype kMaxReportErrorBytes = 1024;
+// frame (4) + flags (1) + error length (2)
+constexpr qsizetype kReportFixedBytes = 7;
+
+template <typename T>
+void appendLE(QByteArray& out, T value) {
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+bool readLE(const QByteArray& in, qsizetype& offset, T& value) {
+    if (in.size() - offset < static_cast<qsizetype>(sizeof(T))) return false;
+    value = qFromLittleEndian<T>(in.constData() + offset);
+    offset += sizeof(T);
+    return true;
+}
+
+void appendShortString(QByteArray& out, const QByteArray& utf8) {
+    const auto size = static_cast<std::uint16_t>(
+        std::min<qsizetype>(utf8.size(), std::numeric_limits<std::uint16_t>::max()));
+    appendLE(out, size);
+    out.append(utf8.constData(), size);
+}
+
+bool readShortString(const QByteArray& in, qsizetype& offset, QString& value) {
+    std::uint16_t size = 0;
+    if (!readLE(in, offset, size) || in.size() - offset < size) return false;
+    value = QString::fromUtf8(in.constData() + offset, size);
+    offset += size;
+    return true;
+}
+
+}
+
+QByteArray RpcWireCodec::encodeFrame(RpcWireType type, const QByteArray& payload, bool allowCompression) {
+    std::uint8_t flags = 0;
+    QByteArray body;
+    if (allowCompression && payload.size() >= kCompressThreshold) {
+        // Level 1: frame reports and job JSON are repetitive; speed matters more.
+        body = qCompress(payload, 1);
+        if (body.size() < payload.size())
+            flags |= kFlagCompressed;
+        else
+            body.clear();
+    }
+    const QByteArray& data = (flags & kFlagCompressed) ? body : payload;
+
+    QByteArray frame;
+    frame.reserve(kHeaderBytes + data.size());
+    frame.append(kFrameMagic);
+    frame.append(static_cast<char>(flags));
+    frame.append(static_cast<char>(type));
+    frame.append('\0');
+    appendLE(frame, static_cast<std::uint32_t>(data.size()));
+    frame.append(data);
+    return frame;
+}
+
+RpcWireStatus RpcWireCodec::takeMessage(const QByteArray& buffer, qsizetype& offset,
+                                        qsizetype maxPayloadBytes,
+                                        RpcWireMessage& frame, QByteArray& jsonLine) {
+    if (offset >= buffer.size()) return RpcWireStatus::NeedMore;
+
+    if (buffer.at(offset) != kFrameMagic) {
+        const qsizetype newline = buffer.indexOf('\n', offset);
+        if (newline < 0) return RpcWireStatus::NeedMore;
+        jsonLine = buffer.mid(offset, newline - offset).trimmed();
+        offset = newline + 1;
+        return RpcWireStatus::JsonLine;
+    }
+
+    if (buffer.size() - offset < kHeaderBytes) return RpcWireStatus::NeedMore;
+    const auto flags = static_cast<std::uint8_t>(buffer.at(offset + 1));
+    const auto type = static_cast<std::uint8_t>(buffer.at(offset + 2));
+    const auto size = qFromLittleEndian<std::uint32_t>(buffer.constData() + offset + 4);
+    if (static_cast<qsizetype>(size) > maxPayloadBytes
+        || (type != static_cast<std::uint8_t>(RpcWireType::Envelope)
+            && type != static_cast<std::uint8_t>(RpcWireType::FrameReports)))
+        return RpcWireStatus::Error;
+    if (buffer.size() - offset - kHeaderBytes < static_cast<qsizetype>(size))
+        return RpcWireStatus::NeedMore;
+
+    const char* data = buffer.constData() + offset + kHeaderBytes;
+    offset += kHeaderBytes + size;
+    frame.type = static_cast<RpcWireType>(type);
+    if (!(flags & kFlagCompressed)) {
+        frame.payload = QByteArray(data, size);
+        return RpcWireStatus::Frame;
+    }
+    // qCompress prefixes the uncompressed size (big-endian); check it before
+    // qUncompress allocates.
+    if (size < 4 || qFromBigEndian<std::uint32_t>(data) > static_cast<std::uint32_t>(maxPayloadBytes))
+        return RpcWireStatus::Error;
+    frame.payload = qUncompress(reinterpret_cast<const uchar*>(data), static_cast<qsizetype>(size));
+    return frame.payload.isEmpty() ? RpcWireStatus::Error : RpcWireStatus::Frame;
+}
+
+QByteArray RpcWireCodec::encodeEnvelope(const QJsonObject& message) {
+    return QCborValue::fromJsonValue(message).toCbor();
+}
+
+bool RpcWireCodec::decodeEnvelope(const QByteArray& payload, QJsonObject& message) {
+    QCborParserError error;
+    const QCborValue value = QCborValue::fromCbor(payload, &error);
+    if (error.error != QCborError::NoError || !value.isMap()) return false;
+    message = value.toJsonValue().toObject();
+    return true;
+}
+
+QByteArray RpcWireCodec::encodeFrameReports(const QString& workerId,
+                                            const std::vector<RpcFrameReport>& reports) {
+    const QByteArray worker = workerId.toUtf8();
+    QByteArray out;
+    out.reserve(2 + worker.size() + 4 + static_cast<qsizetype>(reports.size()) * kReportFixedBytes);
+    appendShortString(out, worker);
+    appendLE(out, static_cast<std::uint32_t>(reports.size()));
+    for (const auto& report : reports) {
+        appendLE(out, static_cast<std::int32_t>(report.frame));
+        out.append(static_cast<char>(report.success ? 0 : 1));
+        appendShortString(out, report.success ? QByteArray()
+                                              : report.error.toUtf8().left(kMaxReportErrorBytes));
+    }
+    return out;
+}
+
+bool RpcWireCodec::decodeFrameReports(const QByteArray& payload, QString& workerId,
+                                      std::vector<RpcFrameReport>& reports) {
+    qsizetype offset = 0;
+    std::uint32_t count = 0;
+    if (!readShortString(payload, offset, workerId) || !readLE(payload, offset, count))
+        return false;
+    // Reject counts the payload cannot possibly hold before reserving.
+    if (count > static_cast<std::uint32_t>((payload.size() - offset) / kReportFixedBytes))
+        return false;
+    reports.clear();
+    reports.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        RpcFrameReport report;
+        std::int32_t frame = 0;
+        std::uint8_t flags = 0;
+        if (!readLE(payload, offset, frame) || !readLE(payload, offset, flags)
+            || !readShortString(payload, offset, report.error))
+            return false;
+        report.frame = frame;
+        report.success = (flags & 1) == 0;
+        reports.push_back(std::move(report));
+    }
+    return offset == payload.size();
+}
+
+}
@@ -6,6 +6,13 @@ module;
 #include <string>
 #include <vector>
 #include <random>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ARTIFACT_PARTICLE_SSE2 1
+#endif
 
 #include <QList>
 
@@ -16,10 +23,218 @@ import Container.NamedVector;
 import Particle;
 import Mesh;
 import Math.Noise;
+import Math.SpatialGrid;
+import Core.Parallel;
 
 
 namespace ArtifactCore {
 
+namespace {
+
+ParticleColdData coldDataOf(const Particle& p) {
+    return {p.id, p.seed, p.flags, p.scale, p.size, p.mass, p.drag,
+            p.custom0, p.custom1, p.textureIndex, p.blendMode};
+}
+
+// SoA 用の配列カーネル。SSE2 で 4 要素ずつ処理し、端数はスカラーで片付ける
+
+// dst[k] += value * (scale ? scale[k] : 1)
+void addScaled(float* dst, float value, const float* scale, size_t count) {
+    size_t k = 0;
+#if defined(ARTIFACT_PARTICLE_SSE2)
+    const __m128 v = _mm_set1_ps(value);
+    if (scale) {
+        for (; k + 4 <= count; k += 4) {
+            _mm_storeu_ps(dst + k, _mm_add_ps(_mm_loadu_ps(dst + k), _mm_mul_ps(v, _mm_loadu_ps(scale + k))));
+        }
+    } else {
+        for (; k + 4 <= count; k += 4) {
+            _mm_storeu_ps(dst + k, _mm_add_ps(_mm_loadu_ps(dst + k), v));
+        }
+    }
+#endif
+    for (; k < count; ++k) dst[k] += value * (scale ? scale[k] : 1.0f);
+}
+
+// dst[k] += src[k] * factor
+void addProduct(float* dst, const float* src, float factor, size_t count) {
+    size_t k = 0;
+#if defined(ARTIFACT_PARTICLE_SSE2)
+    const __m128 f = _mm_set1_ps(factor);
+    for (; k + 4 <= count; k += 4) {
+        _mm_storeu_ps(dst + k, _mm_add_ps(_mm_loadu_ps(dst + k), _mm_mul_ps(_mm_loadu_ps(src + k), f)));
+    }
+#endif
+    for (; k < count; ++k) dst[k] += src[k] * factor;
+}
+
+// dst[k] *= factor
+void multiply(float* dst, float factor, size_t count) {
+    size_t k = 0;
+#if defined(ARTIFACT_PARTICLE_SSE2)
+    const __m128 f = _mm_set1_ps(factor);
+    for (; k + 4 <= count; k += 4) {
+        _mm_storeu_ps(dst + k, _mm_mul_ps(_mm_loadu_ps(dst + k), f));
+    }
+#endif
+    for (; k < count; ++k) dst[k] *= factor;
+}
+
+float stepFor(float dt, const float* dtScale, size_t k) {
+    return dtScale ? dt * dtScale[k] : dt;
+}
+
+// 添字とフレームの種から [-1, 1) の乱数を作る（スレッド間で状態を持たない）
+float hashedUnit(std::uint32_t seed, std::uint32_t index) {
+    std::uint32_t x = index * 0x9e3779b1u ^ seed;
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return static_cast<float>(x >> 8) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+// 寿命比からの不透明度と色
+void applyLifetimeStyle(const EmissionConfig& config, float lifeRatio, float& opacity, float4& color) {
+    opacity = config.startOpacity + (config.endOpacity - config.startOpacity) * lifeRatio;
+
+    if (config.colorGradients.empty()) {
+        color.x = config.colorStart.x + (config.colorEnd.x - config.colorStart.x) * lifeRatio;
+        color.y = config.colorStart.y + (config.colorEnd.y - config.colorStart.y) * lifeRatio;
+        color.z = config.colorStart.z + (config.colorEnd.z - config.colorStart.z) * lifeRatio;
+        color.w = config.colorStart.w + (config.colorEnd.w - config.colorStart.w) * lifeRatio;
+        return;
+    }
+
+    // Find the two stops to interpolate between
+    const auto& stops = config.colorGradients;
+    if (lifeRatio <= stops.front().time) {
+        color = stops.front().color;
+    } else if (lifeRatio >= stops.back().time) {
+        color = stops.back().color;
+    } else {
+        for (size_t k = 0; k < stops.size() - 1; ++k) {
+            if (lifeRatio >= stops[k].time && lifeRatio <= stops[k+1].time) {
+                float t = (lifeRatio - stops[k].time) / (stops[k+1].time - stops[k].time);
+                color.x = stops[k].color.x + (stops[k+1].color.x - stops[k].color.x) * t;
+                color.y = stops[k].color.y + (stops[k+1].color.y - stops[k].color.y) * t;
+                color.z = stops[k].color.z + (stops[k+1].color.z - stops[k].color.z) * t;
+                color.w = stops[k].color.w + (stops[k+1].color.w - stops[k].color.w) * t;
+                break;
+            }
+        }
+    }
+}
+
+}
+
+// ============================================================================
+// ParticleSoA Implementation
+// ============================================================================
+template<typename F>
+void ParticleSoA::forEachColumn(F&& f) {
+    f(positionX); f(positionY); f(positionZ);
+    f(prevPositionX); f(prevPositionY); f(prevPositionZ);
+    f(velocityX); f(velocityY); f(velocityZ);
+    f(accelerationX); f(accelerationY); f(accelerationZ);
+    f(rotationX); f(rotationY); f(rotationZ);
+    f(angularVelocityX); f(angularVelocityY); f(angularVelocityZ);
+    f(age); f(lifetime); f(lastSubEmitAge); f(opacity);
+    f(color);
+    f(emitterToken);
+    f(cold);
+}
+
+void ParticleSoA::clear() {
+    forEachColumn([](auto& column) { column.clear(); });
+}
+
+void ParticleSoA::reserve(size_t capacity) {
+    forEachColumn([capacity](auto& column) { column.reserve(capacity); });
+}
+
+size_t ParticleSoA::push(const Particle& p) {
+    const size_t index = size();
+    positionX.push_back(p.position.x); positionY.push_back(p.position.y); positionZ.push_back(p.position.z);
+    prevPositionX.push_back(p.prevPosition.x); prevPositionY.push_back(p.prevPosition.y); prevPositionZ.push_back(p.prevPosition.z);
+    velocityX.push_back(p.velocity.x); velocityY.push_back(p.velocity.y); velocityZ.push_back(p.velocity.z);
+    accelerationX.push_back(p.acceleration.x); accelerationY.push_back(p.acceleration.y); accelerationZ.push_back(p.acceleration.z);
+    rotationX.push_back(p.rotation.x); rotationY.push_back(p.rotation.y); rotationZ.push_back(p.rotation.z);
+    angularVelocityX.push_back(p.angularVelocity.x); angularVelocityY.push_back(p.angularVelocity.y); angularVelocityZ.push_back(p.angularVelocity.z);
+    age.push_back(p.age);
+    lifetime.push_back(p.lifetime);
+    lastSubEmitAge.push_back(p.lastSubEmitAge);
+    opacity.push_back(p.opacity);
+    color.push_back(p.color);
+    emitterToken.push_back(p.emitterToken);
+    cold.push_back(coldDataOf(p));
+    return index;
+}
+
+Particle ParticleSoA::get(size_t i) const {
+    const ParticleColdData& c = cold[i];
+    Particle p;
+    p.id = c.id;
+    p.seed = c.seed;
+    p.flags = c.flags;
+    p.scale = c.scale;
+    p.size = c.size;
+    p.mass = c.mass;
+    p.drag = c.drag;
+    p.custom0 = c.custom0;
+    p.custom1 = c.custom1;
+    p.textureIndex = c.textureIndex;
+    p.blendMode = c.blendMode;
+    p.position = {positionX[i], positionY[i], positionZ[i]};
+    p.prevPosition = {prevPositionX[i], prevPositionY[i], prevPositionZ[i]};
+    p.velocity = {velocityX[i], velocityY[i], velocityZ[i]};
+    p.acceleration = {accelerationX[i], accelerationY[i], accelerationZ[i]};
+    p.rotation = {rotationX[i], rotationY[i], rotationZ[i]};
+    p.angularVelocity = {angularVelocityX[i], angularVelocityY[i], angularVelocityZ[i]};
+    p.age = age[i];
+    p.lifetime = lifetime[i];
+    p.lastSubEmitAge = lastSubEmitAge[i];
+    p.opacity = opacity[i];
+    p.color = color[i];
+    p.emitterToken = emitterToken[i];
+    return p;
+}
+
+void ParticleSoA::set(size_t i, const Particle& p) {
+    positionX[i] = p.position.x; positionY[i] = p.position.y; positionZ[i] = p.position.z;
+    prevPositionX[i] = p.prevPosition.x; prevPositionY[i] = p.prevPosition.y; prevPositionZ[i] = p.prevPosition.z;
+    velocityX[i] = p.velocity.x; velocityY[i] = p.velocity.y; velocityZ[i] = p.velocity.z;
+    accelerationX[i] = p.acceleration.x; accelerationY[i] = p.acceleration.y; accelerationZ[i] = p.acceleration.z;
+    rotationX[i] = p.rotation.x; rotationY[i] = p.rotation.y; rotationZ[i] = p.rotation.z;
+    angularVelocityX[i] = p.angularVelocity.x; angularVelocityY[i] = p.angularVelocity.y; angularVelocityZ[i] = p.angularVelocity.z;
+    age[i] = p.age;
+    lifetime[i] = p.lifetime;
+    lastSubEmitAge[i] = p.lastSubEmitAge;
+    opacity[i] = p.opacity;
+    color[i] = p.color;
+    emitterToken[i] = p.emitterToken;
+    cold[i] = coldDataOf(p);
+}
+
+size_t ParticleSoA::compact(const std::uint8_t* alive) {
+    const size_t count = size();
+    size_t first = 0;
+    while (first < count && alive[first]) ++first;
+    if (first == count) return 0;
+
+    size_t kept = first;
+    forEachColumn([&](auto& column) {
+        size_t write = first;
+        for (size_t read = first; read < count; ++read) {
+            if (alive[read]) column[write++] = std::move(column[read]);
+        }
+        column.resize(write);
+        kept = write;
+    });
+    return count - kept;
+}
+
 // ============================================================================
 // ForceField Implementation
 // ============================================================================
@@ -65,6 +280,205 @@ float ForceField::computeFalloff(const float3& p) const {
     }
 }
 
+bool ForceField::computeFalloffBatch(const ParticleSoA& particles, size_t begin, size_t end, float* out) const {
+    if (shape_ == FieldShape::Infinite) return false;
+    for (size_t i = begin; i < end; ++i) {
+        out[i - begin] = computeFalloff(particles.position(i));
+    }
+    return true;
+}
+
+void ForceField::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double deltaTime,
+                            const float* dtScale) {
+    for (size_t i = begin; i < end; ++i) {
+        const double step = dtScale ? deltaTime * dtScale[i - begin] : deltaTime;
+        if (dtScale && dtScale[i - begin] <= 0.0f) continue;
+        Particle p = particles.get(i);
+        apply(p, step);
+        particles.set(i, p);
+    }
+}
+
+void GravityForce::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                              const float* dtScale) {
+    const size_t count = end - begin;
+    const float step = static_cast<float>(dt);
+    addScaled(particles.velocityX.data() + begin, gravity_.x * step, dtScale, count);
+    addScaled(particles.velocityY.data() + begin, gravity_.y * step, dtScale, count);
+    addScaled(particles.velocityZ.data() + begin, gravity_.z * step, dtScale, count);
+}
+
+void WindForce::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                           const float* dtScale) {
+    const size_t count = end - begin;
+    const float step = strength_ * static_cast<float>(dt);
+    addScaled(particles.velocityX.data() + begin, direction_.x * step, dtScale, count);
+    addScaled(particles.velocityY.data() + begin, direction_.y * step, dtScale, count);
+    addScaled(particles.velocityZ.data() + begin, direction_.z * step, dtScale, count);
+}
+
+void TurbulenceForce::prepareBatch(double) {
+    batchSeed_ = static_cast<std::uint32_t>(rng_());
+}
+
+void TurbulenceForce::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                                 const float* dtScale) {
+    float* vx = particles.velocityX.data();
+    float* vy = particles.velocityY.data();
+    float* vz = particles.velocityZ.data();
+    const float base = strength_ * static_cast<float>(dt);
+    for (size_t i = begin; i < end; ++i) {
+        const float strength = dtScale ? base * dtScale[i - begin] : base;
+        const auto index = static_cast<std::uint32_t>(i) * 3u;
+        vx[i] += hashedUnit(batchSeed_, index) * strength;
+        vy[i] += hashedUnit(batchSeed_, index + 1u) * strength;
+        vz[i] += hashedUnit(batchSeed_, index + 2u) * strength;
+    }
+}
+
+void VortexForce::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                             const float* dtScale) {
+    const float* px = particles.positionX.data();
+    const float* py = particles.positionY.data();
+    const float* pz = particles.positionZ.data();
+    float* vx = particles.velocityX.data();
+    float* vz = particles.velocityZ.data();
+    const float step = static_cast<float>(dt);
+    for (size_t i = begin; i < end; ++i) {
+        const float dx = px[i] - center_.x;
+        const float dy = py[i] - center_.y;
+        const float dz = pz[i] - center_.z;
+        const float dist = std::sqrt(dx*dx + dy*dy + dz*dz);
+        // 接線方向の力
+        const float factor = dist > 0.001f ? strength_ * stepFor(step, dtScale, i - begin) / dist : 0.0f;
+        vx[i] += -dz * factor;
+        vz[i] += dx * factor;
+    }
+}
+
+void AttractorForce::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                                const float* dtScale) {
+    const float* px = particles.positionX.data();
+    const float* py = particles.positionY.data();
+    const float* pz = particles.positionZ.data();
+    float* vx = particles.velocityX.data();
+    float* vy = particles.velocityY.data();
+    float* vz = particles.velocityZ.data();
+    const float step = static_cast<float>(dt);
+    for (size_t i = begin; i < end; ++i) {
+        const float dx = center_.x - px[i];
+        const float dy = center_.y - py[i];
+        const float dz = center_.z - pz[i];
+        const float distSq = dx*dx + dy*dy + dz*dz;
+        const float force = distSq > 0.0001f ? strength_ * stepFor(step, dtScale, i - begin) / distSq : 0.0f;
+        vx[i] += dx * force;
+        vy[i] += dy * force;
+        vz[i] += dz * force;
+    }
+}
+
+void DragForce::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                           const float* dtScale) {
+    const size_t count = end - begin;
+    const float step = static_cast<float>(dt);
+    if (!dtScale) {
+        const float factor = std::max(0.0f, 1.0f - drag_ * step);
+        multiply(particles.velocityX.data() + begin, factor, count);
+        multiply(particles.velocityY.data() + begin, factor, count);
+        multiply(particles.velocityZ.data() + begin, factor, count);
+        return;
+    }
+    float* vx = particles.velocityX.data() + begin;
+    float* vy = particles.velocityY.data() + begin;
+    float* vz = particles.velocityZ.data() + begin;
+    for (size_t k = 0; k < count; ++k) {
+        const float factor = std::max(0.0f, 1.0f - drag_ * step * dtScale[k]);
+        vx[k] *= factor;
+        vy[k] *= factor;
+        vz[k] *= factor;
+    }
+}
+
+void AudioForce::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                            const float* dtScale) {
+    const size_t count = end - begin;
+    const float strength = audioValue_ * multiplier_ * static_cast<float>(dt);
+    addScaled(particles.velocityX.data() + begin, direction_.x * strength, dtScale, count);
+    addScaled(particles.velocityY.data() + begin, direction_.y * strength, dtScale, count);
+    addScaled(particles.velocityZ.data() + begin, direction_.z * strength, dtScale, count);
+}
+
+void FluidField::applyBatch(ParticleSoA& particles, size_t begin, size_t end, double dt,
+                            const float* dtScale) {
+    const float* px = particles.positionX.data();
+    const float* py = particles.positionY.data();
+    float* vx = particles.velocityX.data();
+    float* vy = particles.velocityY.data();
+    const float step = strength_ * static_cast<float>(dt);
+    for (size_t i = begin; i < end; ++i) {
+        const int ix = static_cast<int>((px[i] - center_.x + size_.x * 0.5f) / size_.x * solver_.width());
+        const int iy = static_cast<int>((py[i] - center_.y + size_.y * 0.5f) / size_.y * solver_.height());
+        float fx, fy;
+        solver_.getVelocity(ix, iy, fx, fy);
+        const float s = stepFor(step, dtScale, i - begin);
+        vx[i] += fx * s;
+        vy[i] += fy * s;
+    }
+}
+
+// ============================================================================
+// ParticleCollider Implementation
+// ============================================================================
+void ParticleCollider::collideBatch(ParticleSoA& particles, size_t begin, size_t end, double dt) {
+    for (size_t i = begin; i < end; ++i) {
+        Particle p = particles.get(i);
+        if (collide(p, dt)) particles.set(i, p);
+    }
+}
+
+void PlaneCollider::collideBatch(ParticleSoA& particles, size_t begin, size_t end, double) {
+    float* py = particles.positionY.data();
+    float* vx = particles.velocityX.data();
+    float* vy = particles.velocityY.data();
+    float* vz = particles.velocityZ.data();
+    const float keep = 1.0f - friction_;
+    for (size_t i = begin; i < end; ++i) {
+        if (py[i] < height_ && vy[i] < 0.0f) {
+            py[i] = height_;
+            vy[i] = -vy[i] * restitution_;
+            vx[i] *= keep;
+            vz[i] *= keep;
+        }
+    }
+}
+
+void SphereCollider::collideBatch(ParticleSoA& particles, size_t begin, size_t end, double) {
+    float* px = particles.positionX.data();
+    float* py = particles.positionY.data();
+    float* pz = particles.positionZ.data();
+    float* vx = particles.velocityX.data();
+    float* vy = particles.velocityY.data();
+    float* vz = particles.velocityZ.data();
+    for (size_t i = begin; i < end; ++i) {
+        const float dx = px[i] - center_.x;
+        const float dy = py[i] - center_.y;
+        const float dz = pz[i] - center_.z;
+        const float dist = std::sqrt(dx*dx + dy*dy + dz*dz);
+        if (!(dist < radius_)) continue;
+
+        const float norm = dist > 0.0f ? dist : 1.0f;
+        const float nx = dx / norm, ny = dy / norm, nz = dz / norm;
+        px[i] = center_.x + nx * radius_;
+        py[i] = center_.y + ny * radius_;
+        pz[i] = center_.z + nz * radius_;
+
+        const float dot = vx[i]*nx + vy[i]*ny + vz[i]*nz;
+        vx[i] = (vx[i] - 2.0f*dot*nx) * restitution_;
+        vy[i] = (vy[i] - 2.0f*dot*ny) * restitution_;
+        vz[i] = (vz[i] - 2.0f*dot*nz) * restitution_;
+    }
+}
+
 // ============================================================================
 // ParticleEmitter Implementation
 // ============================================================================
@@ -301,6 +715,39 @@ public:
     std::vector<SharedPtr<ForceField>> forceFields_;
     std::vector<SharedPtr<ParticleCollider>> colliders_;
     std::vector<SharedPtr<ParticleConstraint>> constraints_;
+
+    // 拘束用の作業領域。容量はフレーム間で使い回す
+    std::vector<size_t> constraintIndices_;
+    std::vector<Particle> constraintParticles_;
+    ParticleNeighborSet neighbors_;
+
+    // SoA モード
+    ParticleStorageMode storageMode_ = ParticleStorageMode::AoS;
+    ParticleSoA soa_;
+    ParticlePool<> staging_{0};  // エミッターの出力を受けてから soa_ へ移す
+    std::vector<std::uint8_t> alive_;
+
+    // サブエミッターの発生要求。並列パス中はチャンクごとに溜め、パスの後にチャンク順で処理する
+    struct SpawnRequest {
+        size_t route;
+        float3 position;
+    };
+    // Trails / Death を持つサブエミッター。子エミッターは childEmitters_[route] をフレーム間で使い回す
+    struct SubEmitterRoute {
+        std::uint64_t token;
+        const SubEmitterConfig* sub;
+    };
+    static constexpr size_t kChunkSize = 4096;
+    struct ChunkScratch {
+        std::vector<SpawnRequest> spawns;
+        std::vector<float> falloff;
+        std::vector<float> noiseU, noiseV, noiseW;
+        std::vector<float> noise[3];
+        size_t killed = 0;
+    };
+    std::vector<ChunkScratch> chunks_;
+    std::vector<SubEmitterRoute> routes_;
+    std::vector<std::unique_ptr<ParticleEmitter>> childEmitters_;
     
     size_t maxParticles_ = 100000;
     double simulationSpeed_ = 1.0;
@@ -311,8 +758,229 @@ public:
     Impl() {
         pool_.reserve(maxParticles_);
     }
+
+    size_t appendStaging();
+    void buildRoutes();
+    void updateChunk(ChunkScratch& scratch, size_t begin, size_t end, double dt,
+                     const EmissionConfig& config);
+    void integrateRange(ChunkScratch& scratch, size_t begin, size_t end, double dt,
+                        const EmissionConfig& config);
+    void updateSoA(double dt, const EmissionConfig& config);
 };
 
+size_t ParticleSystem::Impl::appendStaging() {
+    // staging_ は毎回空にするので空きスロットはない
+    const size_t count = staging_.size();
+    for (size_t i = 0; i < count; ++i) {
+        soa_.push(staging_[i]);
+    }
+    staging_.clear();
+    return count;
+}
+
+void ParticleSystem::Impl::buildRoutes() {
+    routes_.clear();
+    for (const auto& emitter : emitters_) {
+        for (const auto& sub : emitter->getSubEmitters()) {
+            if (sub.trigger == SubEmitterConfig::Trigger::Birth || sub.count <= 0) continue;
+            if (routes_.size() == childEmitters_.size()) {
+                childEmitters_.push_back(std::make_unique<ParticleEmitter>());
+            }
+            childEmitters_[routes_.size()]->setConfig(sub.config);
+            routes_.push_back({emitter->emitterToken(), &sub});
+        }
+    }
+}
+
+void ParticleSystem::Impl::updateChunk(ChunkScratch& scratch, size_t begin, size_t end, double dt,
+                                       const EmissionConfig& config) {
+    ParticleSoA& s = soa_;
+    const size_t count = end - begin;
+    const float step = static_cast<float>(dt);
+    scratch.spawns.clear();
+    scratch.killed = 0;
+
+    // Update previous position for motion blur, then age
+    std::copy_n(s.positionX.data() + begin, count, s.prevPositionX.data() + begin);
+    std::copy_n(s.positionY.data() + begin, count, s.prevPositionY.data() + begin);
+    std::copy_n(s.positionZ.data() + begin, count, s.prevPositionZ.data() + begin);
+    addScaled(s.age.data() + begin, step, nullptr, count);
+
+    // サブエミッター (Trails / Death) と寿命判定
+    std::uint8_t* alive = alive_.data();
+    for (size_t i = begin; i < end; ++i) {
+        const bool expired = s.age[i] >= s.lifetime[i];
+        alive[i] = expired ? 0 : 1;
+        scratch.killed += expired ? 1 : 0;
+        for (size_t r = 0; r < routes_.size(); ++r) {
+            const SubEmitterRoute& route = routes_[r];
+            if (route.token != s.emitterToken[i]) continue;
+            if (route.sub->trigger == SubEmitterConfig::Trigger::Trails) {
+                const float interval = std::isfinite(route.sub->interval)
+                    ? std::max(0.0f, route.sub->interval) : 0.0f;
+                if (s.age[i] - s.lastSubEmitAge[i] >= interval) {
+                    scratch.spawns.push_back({r, s.position(i)});
+                    s.lastSubEmitAge[i] = s.age[i];
+                }
+            } else if (expired) {
+                scratch.spawns.push_back({r, s.position(i)});
+            }
+        }
+    }
+
+    // 寿命が尽きた粒子は compact で消えるので、生きている連続区間にだけ
+    // 力場・積分・衝突を回す
+    size_t runBegin = begin;
+    while (runBegin < end) {
+        while (runBegin < end && !alive[runBegin]) ++runBegin;
+        size_t runEnd = runBegin;
+        while (runEnd < end && alive[runEnd]) ++runEnd;
+        if (runBegin < runEnd) integrateRange(scratch, runBegin, runEnd, dt, config);
+        runBegin = runEnd;
+    }
+}
+
+void ParticleSystem::Impl::integrateRange(ChunkScratch& scratch, size_t begin, size_t end, double dt,
+                                          const EmissionConfig& config) {
+    ParticleSoA& s = soa_;
+    const size_t count = end - begin;
+    const float step = static_cast<float>(dt);
+
+    // Apply forces（力場ごとに配列単位で）
+    for (auto& field : forceFields_) {
+        if (!field->isEnabled()) continue;
+        scratch.falloff.resize(count);
+        const bool bounded = field->computeFalloffBatch(s, begin, end, scratch.falloff.data());
+        field->applyBatch(s, begin, end, dt, bounded ? scratch.falloff.data() : nullptr);
+    }
+
+    // Integrate velocity and position
+    addProduct(s.velocityX.data() + begin, s.accelerationX.data() + begin, step, count);
+    addProduct(s.velocityY.data() + begin, s.accelerationY.data() + begin, step, count);
+    addProduct(s.velocityZ.data() + begin, s.accelerationZ.data() + begin, step, count);
+    addProduct(s.positionX.data() + begin, s.velocityX.data() + begin, step, count);
+    addProduct(s.positionY.data() + begin, s.velocityY.data() + begin, step, count);
+    addProduct(s.positionZ.data() + begin, s.velocityZ.data() + begin, step, count);
+
+    // Apply Noise Distortion（3 成分とも現在位置から求めてから加える）
+    if (config.noiseStrength.x > 0.0f || config.noiseStrength.y > 0.0f || config.noiseStrength.z > 0.0f) {
+        const float freq = config.noiseFrequency;
+        const float* axes[3] = {s.positionX.data() + begin, s.positionY.data() + begin, s.positionZ.data() + begin};
+        scratch.noiseU.resize(count);
+        scratch.noiseV.resize(count);
+        scratch.noiseW.resize(count);
+        for (int c = 0; c < 3; ++c) {
+            const float* u = axes[c];
+            const float* v = axes[(c + 1) % 3];
+            const float* t = s.age.data() + begin;
+            for (size_t k = 0; k < count; ++k) {
+                scratch.noiseU[k] = u[k] * freq;
+                scratch.noiseV[k] = v[k] * freq;
+                scratch.noiseW[k] = t[k] + static_cast<float>(c);
+            }
+            scratch.noise[c].resize(count);
+            NoiseGenerator::perlinBatch(scratch.noiseU.data(), scratch.noiseV.data(), scratch.noiseW.data(),
+                                        scratch.noise[c].data(), static_cast<int>(count));
+        }
+        addProduct(s.positionX.data() + begin, scratch.noise[0].data(), config.noiseStrength.x * step, count);
+        addProduct(s.positionY.data() + begin, scratch.noise[1].data(), config.noiseStrength.y * step, count);
+        addProduct(s.positionZ.data() + begin, scratch.noise[2].data(), config.noiseStrength.z * step, count);
+    }
+
+    // Integrate rotation
+    addProduct(s.rotationX.data() + begin, s.angularVelocityX.data() + begin, step, count);
+    addProduct(s.rotationY.data() + begin, s.angularVelocityY.data() + begin, step, count);
+    addProduct(s.rotationZ.data() + begin, s.angularVelocityZ.data() + begin, step, count);
+
+    // Collision detection
+    for (auto& collider : colliders_) {
+        collider->collideBatch(s, begin, end, dt);
+    }
+
+    for (size_t i = begin; i < end; ++i) {
+        const float lifeRatio = std::clamp(s.age[i] / s.lifetime[i], 0.0f, 1.0f);
+        applyLifetimeStyle(config, lifeRatio, s.opacity[i], s.color[i]);
+    }
+}
+
+void ParticleSystem::Impl::updateSoA(double dt, const EmissionConfig& config) {
+    // Emit new particles。上限に達しているフレームはエミッターを進めない
+    size_t spawned = 0;
+    for (auto& emitter : emitters_) {
+        if (!emitter->isEnabled() || soa_.size() >= maxParticles_) continue;
+        emitter->update(dt, staging_, maxParticles_ - soa_.size());
+        spawned += appendStaging();
+    }
+
+    // Update Fluid Fields
+    for (auto& field : forceFields_) {
+        if (field->isEnabled() && field->getType() == ForceField::Type::Fluid) {
+            static_cast<FluidField*>(field.get())->update(static_cast<float>(dt));
+        }
+        if (field->isEnabled()) field->prepareBatch(dt);
+    }
+    buildRoutes();
+
+    // 粒子を kChunkSize ごとのチャンクに分けて並列に更新する
+    const size_t count = soa_.size();
+    const size_t chunkCount = (count + kChunkSize - 1) / kChunkSize;
+    if (chunks_.size() < chunkCount) chunks_.resize(chunkCount);
+    alive_.resize(count);
+    Parallel::ForRange(0, static_cast<int>(chunkCount), 1, [&](ParallelRange range) {
+        for (int c = range.begin; c < range.end; ++c) {
+            const size_t begin = static_cast<size_t>(c) * kChunkSize;
+            updateChunk(chunks_[c], begin, std::min(count, begin + kChunkSize), dt, config);
+        }
+    });
+
+    size_t killed = 0;
+    for (size_t c = 0; c < chunkCount; ++c) killed += chunks_[c].killed;
+    if (killed > 0) soa_.compact(alive_.data());
+
+    // 拘束の解決（AoS と同じく、近傍拘束ごとに現在位置からセルを作り直す）
+    if (!constraints_.empty() && !soa_.empty()) {
+        float cellSize = 0.0f;
+        for (auto& constraint : constraints_) {
+            cellSize = std::max(cellSize, constraint->interactionRadius());
+        }
+        bool gathered = false;
+        for (auto& constraint : constraints_) {
+            if (constraint->interactionRadius() > 0.0f) {
+                if (gathered) neighbors_.scatter(soa_);
+                neighbors_.gather(soa_, cellSize);
+                gathered = true;
+                constraint->resolve(neighbors_, dt);
+                continue;
+            }
+            if (gathered) {
+                neighbors_.scatter(soa_);
+                gathered = false;
+            }
+            auto& active = constraintParticles_;
+            active.clear();
+            for (size_t i = 0; i < soa_.size(); ++i) active.push_back(soa_.get(i));
+            constraint->resolve(active, dt);
+            for (size_t i = 0; i < active.size(); ++i) soa_.set(i, active[i]);
+        }
+        if (gathered) neighbors_.scatter(soa_);
+    }
+
+    // サブエミッターの要求をチャンク順に処理する（スレッド数によらず同じ順序になる）
+    for (size_t c = 0; c < chunkCount; ++c) {
+        for (const auto& request : chunks_[c].spawns) {
+            if (soa_.size() >= maxParticles_) break;
+            ParticleEmitter& child = *childEmitters_[request.route];
+            child.setPosition(request.position.x, request.position.y, request.position.z);
+            child._emit(staging_, static_cast<size_t>(routes_[request.route].sub->count),
+                        maxParticles_ - soa_.size());
+            spawned += appendStaging();
+        }
+    }
+
+    stats_.spawnedThisFrame = spawned;
+    stats_.killedThisFrame = killed;
+}
+
 // ============================================================================
 // ParticleSystem Implementation
 // ============================================================================
@@ -395,6 +1063,16 @@ void ParticleSystem::update(double deltaTime) {
     
     impl_->stats_.spawnedThisFrame = 0;
     impl_->stats_.killedThisFrame = 0;
+
+    if (impl_->storageMode_ == ParticleStorageMode::SoA) {
+        impl_->updateSoA(dt, config_);
+        auto endTime = std::chrono::high_resolution_clock::now();
+        impl_->stats_.simulationTimeMs = std::chrono::duration<double, std::milli>(endTime - startTime).count();
+        impl_->stats_.activeParticles = activeParticleCount();
+        impl_->stats_.totalParticles = totalParticleCount();
+        return;
+    }
+
     const size_t activeParticlesAtFrameStart = impl_->pool_.activeCount();
     
     // Emit new particles
@@ -525,24 +1203,45 @@ void ParticleSystem::update(double deltaTime) {
     
     // 拘束の解決（流体・パーティクル間衝突など）
     if (!impl_->constraints_.empty()) {
-        // 現在のアクティブなパーティクルを取得して解決
-        std::vector<Particle> activeParticles;
-        NamedVector<size_t> indices;
-        for (size_t i = 0; i < impl_->pool_.size(); ++i) {
-            if (!isFree[i]) {
-                activeParticles.push_back(impl_->pool_[i]);
-                indices.push_back(i);
-            }
+        auto& indices = impl_->constraintIndices_;
+        indices.clear();
+        for (size_t i = 0; i < particleCountAtFrameStart; ++i) {
+            if (!isFree[i]) indices.push_back(i);
         }
-        
+        Particle* particles = indices.empty() ? nullptr : &impl_->pool_[0];
+
+        // セルは近傍拘束の最大半径で切る（半径以上なら隣接セルだけ見れば足りる）
+        float cellSize = 0.0f;
         for (auto& constraint : impl_->constraints_) {
-            constraint->resolve(activeParticles, dt);
+            cellSize = std::max(cellSize, constraint->interactionRadius());
         }
-        
-        // 解決した値をプールに戻す
-        for (size_t k = 0; k < activeParticles.size(); ++k) {
-            impl_->pool_[indices[k]] = activeParticles[k];
+
+        bool gathered = false;
+        for (auto& constraint : impl_->constraints_) {
+            if (constraint->interactionRadius() > 0.0f) {
+                // 近傍拘束: 位置・速度・質量だけをセル順に集めて解く。
+                // 前の拘束が動かした位置でセルを作り直すため、毎回書き戻してから集め直す
+                if (gathered) impl_->neighbors_.scatter(particles, indices.data());
+                impl_->neighbors_.gather(particles, indices.data(), indices.size(), cellSize);
+                gathered = true;
+                constraint->resolve(impl_->neighbors_, dt);
+                continue;
+            }
+
+            // 近傍を使わない拘束は従来どおりパーティクル配列で解く
+            if (gathered) {
+                impl_->neighbors_.scatter(particles, indices.data());
+                gathered = false;
+            }
+            auto& active = impl_->constraintParticles_;
+            active.clear();
+            for (size_t index : indices) active.push_back(impl_->pool_[index]);
+            constraint->resolve(active, dt);
+            for (size_t k = 0; k < active.size(); ++k) {
+                impl_->pool_[indices[k]] = active[k];
+            }
         }
+        if (gathered) impl_->neighbors_.scatter(particles, indices.data());
     }
     
     // 更新ループの最後で色などを適用
@@ -552,40 +1251,13 @@ void ParticleSystem::update(double deltaTime) {
         
         float lifeRatio = std::clamp(p.age / p.lifetime, 0.0f, 1.0f);
         
-        // Opacity interpolation
-        p.opacity = config_.startOpacity + (config_.endOpacity - config_.startOpacity) * lifeRatio;
-        
         // Size scale interpolation
         float currentScale = config_.startSizeScale + (config_.endSizeScale - config_.startSizeScale) * lifeRatio;
         // p.size 自体にスケールをかけるか、Rendering時に反映するか
         // ここでは p.size をベース値とし、スケールで動的に変える
         
-        // Interpolate color (Configuration based)
-        if (config_.colorGradients.empty()) {
-            p.color.x = config_.colorStart.x + (config_.colorEnd.x - config_.colorStart.x) * lifeRatio;
-            p.color.y = config_.colorStart.y + (config_.colorEnd.y - config_.colorStart.y) * lifeRatio;
-            p.color.z = config_.colorStart.z + (config_.colorEnd.z - config_.colorStart.z) * lifeRatio;
-            p.color.w = config_.colorStart.w + (config_.colorEnd.w - config_.colorStart.w) * lifeRatio;
-        } else {
-            // Find the two stops to interpolate between
-            const auto& stops = config_.colorGradients;
-            if (lifeRatio <= stops.front().time) {
-                p.color = stops.front().color;
-            } else if (lifeRatio >= stops.back().time) {
-                p.color = stops.back().color;
-            } else {
-                for (size_t k = 0; k < stops.size() - 1; ++k) {
-                    if (lifeRatio >= stops[k].time && lifeRatio <= stops[k+1].time) {
-                        float t = (lifeRatio - stops[k].time) / (stops[k+1].time - stops[k].time);
-                        p.color.x = stops[k].color.x + (stops[k+1].color.x - stops[k].color.x) * t;
-                        p.color.y = stops[k].color.y + (stops[k+1].color.y - stops[k].color.y) * t;
-                        p.color.z = stops[k].color.z + (stops[k+1].color.z - stops[k].color.z) * t;
-                        p.color.w = stops[k].color.w + (stops[k+1].color.w - stops[k].color.w) * t;
-                        break;
-                    }
-                }
-            }
-        }
+        // Opacity / color interpolation (Configuration based)
+        applyLifetimeStyle(config_, lifeRatio, p.opacity, p.color);
     }
     
     auto endTime = std::chrono::high_resolution_clock::now();
@@ -603,14 +1275,17 @@ void ParticleSystem::update(double deltaTime) {
 
 void ParticleSystem::reset() {
     impl_->pool_.clear();
+    impl_->soa_.clear();
     impl_->stats_ = Statistics{};
 }
 
 size_t ParticleSystem::activeParticleCount() const {
+    if (impl_->storageMode_ == ParticleStorageMode::SoA) return impl_->soa_.size();
     return impl_->pool_.activeCount();
 }
 
 size_t ParticleSystem::totalParticleCount() const {
+    if (impl_->storageMode_ == ParticleStorageMode::SoA) return impl_->soa_.size();
     return impl_->pool_.size();
 }
 
@@ -618,9 +1293,43 @@ ParticlePool<>& ParticleSystem::getPool() {
     return impl_->pool_;
 }
 
+ParticleSoA& ParticleSystem::getSoA() {
+    return impl_->soa_;
+}
+
+void ParticleSystem::setStorageMode(ParticleStorageMode mode) {
+    if (mode == impl_->storageMode_) return;
+    auto& pool = impl_->pool_;
+    auto& soa = impl_->soa_;
+    if (mode == ParticleStorageMode::SoA) {
+        std::vector<bool> isFree(pool.size(), false);
+        for (size_t idx : pool.getFreeIndices()) isFree[idx] = true;
+        soa.clear();
+        soa.reserve(std::max(impl_->maxParticles_, pool.activeCount()));
+        for (size_t i = 0; i < pool.size(); ++i) {
+            if (!isFree[i]) soa.push(pool[i]);
+        }
+        pool.clear();
+    } else {
+        pool.clear();
+        pool.reserve(std::max(impl_->maxParticles_, soa.size()));
+        for (size_t i = 0; i < soa.size(); ++i) {
+            pool[pool.spawn()] = soa.get(i);
+        }
+        soa.clear();
+    }
+    impl_->storageMode_ = mode;
+}
+
+ParticleStorageMode ParticleSystem::storageMode() const { return impl_->storageMode_; }
+
 void ParticleSystem::setMaxParticles(size_t maxParticles) {
     impl_->maxParticles_ = std::max<size_t>(1, maxParticles);
-    impl_->pool_.reserve(impl_->maxParticles_);
+    if (impl_->storageMode_ == ParticleStorageMode::SoA) {
+        impl_->soa_.reserve(impl_->maxParticles_);
+    } else {
+        impl_->pool_.reserve(impl_->maxParticles_);
+    }
 }
 
 size_t ParticleSystem::maxParticles() const { return impl_->maxParticles_; }
@@ -636,45 +1345,187 @@ bool ParticleSystem::isPaused() const { return impl_->paused_; }
 ParticleSystem::Statistics ParticleSystem::getStatistics() const { return impl_->stats_; }
 
 // ============================================================================
-// FluidConstraint Implementation (Simple PBD Fluid)
+// ParticleNeighborSet Implementation
+// ============================================================================
+void ParticleNeighborSet::gather(const Particle* particles, const size_t* indices, size_t count, float cellSize) {
+    sourcePositions_.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        sourcePositions_[k] = particles[indices ? indices[k] : k].position;
+    }
+    cells.build(sourcePositions_.data(), count, cellSize);
+
+    const auto& order = cells.order();
+    positions.resize(order.size());
+    velocities.resize(order.size());
+    masses.resize(order.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        const Particle& p = particles[indices ? indices[order[k]] : order[k]];
+        positions[k] = p.position;
+        velocities[k] = p.velocity;
+        masses[k] = p.mass;
+    }
+}
+
+void ParticleNeighborSet::scatter(Particle* particles, const size_t* indices) const {
+    const auto& order = cells.order();
+    for (size_t k = 0; k < order.size(); ++k) {
+        Particle& p = particles[indices ? indices[order[k]] : order[k]];
+        p.position = positions[k];
+        p.velocity = velocities[k];
+    }
+}
+
+void ParticleNeighborSet::gather(const ParticleSoA& particles, float cellSize) {
+    const size_t count = particles.size();
+    sourcePositions_.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        sourcePositions_[k] = particles.position(k);
+    }
+    cells.build(sourcePositions_.data(), count, cellSize);
+
+    const auto& order = cells.order();
+    positions.resize(order.size());
+    velocities.resize(order.size());
+    masses.resize(order.size());
+    for (size_t k = 0; k < order.size(); ++k) {
+        positions[k] = particles.position(order[k]);
+        velocities[k] = particles.velocity(order[k]);
+        masses[k] = particles.cold[order[k]].mass;
+    }
+}
+
+void ParticleNeighborSet::scatter(ParticleSoA& particles) const {
+    const auto& order = cells.order();
+    for (size_t k = 0; k < order.size(); ++k) {
+        particles.setPosition(order[k], positions[k]);
+        particles.setVelocity(order[k], velocities[k]);
+    }
+}
+
+// ============================================================================
+// FluidConstraint Implementation
 // ============================================================================
 void FluidConstraint::resolve(std::vector<Particle>& particles, double dt) {
-    if (particles.size() < 2) return;
-    
-    float rSq = radius_ * radius_;
-    
-    // 非常にシンプルな近接排斥（擬似流体）
-    // 本来は密度計算が必要だが、ここではパフォーマンス重視で排斥のみ
-    for (size_t i = 0; i < particles.size(); ++i) {
-        for (size_t j = i + 1; j < particles.size(); ++j) {
-            float3 diff{
-                particles[i].position.x - particles[j].position.x,
-                particles[i].position.y - particles[j].position.y,
-                particles[i].position.z - particles[j].position.z
-            };
-            
-            float distSq = diff.x*diff.x + diff.y*diff.y + diff.z*diff.z;
-            if (distSq > 0.0001f && distSq < rSq) {
-                float dist = std::sqrt(distSq);
-                float overlap = radius_ - dist;
-                
-                // 押し出しベクトル
-                float factor = (overlap / dist) * 0.5f;
-                float3 push{ diff.x * factor, diff.y * factor, diff.z * factor };
-                
-                particles[i].position.x += push.x;
-                particles[i].position.y += push.y;
-                particles[i].position.z += push.z;
-                
-                particles[j].position.x -= push.x;
-                particles[j].position.y -= push.y;
-                particles[j].position.z -= push.z;
-                
-                // 速度の減衰（粘性）
-                particles[i].velocity.x *= 0.99f;
-                particles[j].velocity.x *= 0.99f;
-            }
+    if (particles.size() < 2 || !(radius_ > 0.0f)) return;
+    scratch_.gather(particles.data(), nullptr, particles.size(), radius_);
+    resolve(scratch_, dt);
+    scratch_.scatter(particles.data(), nullptr);
+}
+
+void FluidConstraint::resolve(ParticleNeighborSet& neighbors, double dt) {
+    if (neighbors.size() < 2 || !(radius_ > 0.0f) || neighbors.cells.cellSize() < radius_) return;
+    if (mode_ == Mode::SPH) {
+        resolveSph(neighbors, static_cast<float>(dt));
+    } else {
+        resolveRepulsion(neighbors);
+    }
+}
+
+void FluidConstraint::resolveRepulsion(ParticleNeighborSet& neighbors) {
+    const float radius = radius_;
+    const float rSq = radius * radius;
+    float3* positions = neighbors.positions.data();
+    float3* velocities = neighbors.velocities.data();
+
+    // 近接排斥（擬似流体）。各ペアを 1 回だけ見て両側を動かす
+    auto visit = [=](uint32_t a, uint32_t b) {
+        const float3 diff = positions[a] - positions[b];
+        const float distSq = diff.x*diff.x + diff.y*diff.y + diff.z*diff.z;
+        if (distSq > 0.0001f && distSq < rSq) {
+            const float dist = std::sqrt(distSq);
+            const float overlap = radius - dist;
+
+            // 押し出しベクトル
+            const float3 push = diff * ((overlap / dist) * 0.5f);
+            positions[a] += push;
+            positions[b] -= push;
+
+            // 速度の減衰（粘性）
+            velocities[a].x *= 0.99f;
+            velocities[b].x *= 0.99f;
         }
+    };
+    if (parallel_) {
+        neighbors.cells.forEachPairParallel(visit);
+    } else {
+        neighbors.cells.forEachPair(visit);
+    }
+}
+
+void FluidConstraint::resolveSph(ParticleNeighborSet& neighbors, float dt) {
+    if (!(dt > 0.0f)) return;
+    const size_t count = neighbors.size();
+    const float h = radius_;
+    const float hSq = h * h;
+    const float pi = std::numbers::pi_v<float>;
+    const float poly6 = 315.0f / (64.0f * pi * std::pow(h, 9.0f));
+    const float spikyGrad = 45.0f / (pi * std::pow(h, 6.0f));
+    const float viscosityLaplacian = 45.0f / (pi * std::pow(h, 6.0f));
+    const float restDensity = std::max(targetDensity_, 1e-6f);
+    const float stiffness = stiffness_;
+    const float viscosity = viscosity_;
+
+    const float3* positions = neighbors.positions.data();
+    float3* velocities = neighbors.velocities.data();
+    const float* masses = neighbors.masses.data();
+    auto massOf = [masses](uint32_t i) { return masses[i] > 0.0f ? masses[i] : 1.0f; };
+
+    // 1. 密度（自分自身の寄与 + 近傍ペアを 1 回ずつ）
+    densities_.resize(count);
+    const float selfWeight = poly6 * hSq * hSq * hSq;
+    for (size_t i = 0; i < count; ++i) {
+        densities_[i] = massOf(static_cast<uint32_t>(i)) * selfWeight;
+    }
+    float* densities = densities_.data();
+    auto accumulateDensity = [=](uint32_t a, uint32_t b) {
+        const float3 diff = positions[a] - positions[b];
+        const float distSq = diff.x*diff.x + diff.y*diff.y + diff.z*diff.z;
+        if (distSq >= hSq) return;
+        const float t = hSq - distSq;
+        const float w = poly6 * t * t * t;
+        densities[a] += massOf(b) * w;
+        densities[b] += massOf(a) * w;
+    };
+
+    // 2. 圧力（引っ張りは作らない）と粘性。作用反作用で両側へ加える
+    forces_.assign(count, float3{});
+    float3* forces = forces_.data();
+    auto accumulateForce = [=](uint32_t a, uint32_t b) {
+        const float3 diff = positions[a] - positions[b];
+        const float distSq = diff.x*diff.x + diff.y*diff.y + diff.z*diff.z;
+        if (distSq >= hSq || distSq < 1e-12f) return;
+        const float dist = std::sqrt(distSq);
+        const float massProduct = massOf(a) * massOf(b);
+        const float pressureA = std::max(0.0f, stiffness * (densities[a] - restDensity));
+        const float pressureB = std::max(0.0f, stiffness * (densities[b] - restDensity));
+        const float falloff = h - dist;
+        const float pressure = massProduct *
+            (pressureA / (densities[a] * densities[a]) + pressureB / (densities[b] * densities[b])) *
+            spikyGrad * falloff * falloff / dist;
+        const float viscous = viscosity * massProduct * viscosityLaplacian * falloff /
+            (densities[a] * densities[b]);
+        const float3 force = diff * pressure + (velocities[b] - velocities[a]) * viscous;
+        forces[a] += force;
+        forces[b] -= force;
+    };
+
+    if (parallel_) {
+        neighbors.cells.forEachPairParallel(accumulateDensity);
+        neighbors.cells.forEachPairParallel(accumulateForce);
+    } else {
+        neighbors.cells.forEachPair(accumulateDensity);
+        neighbors.cells.forEachPair(accumulateForce);
+    }
+
+    // 3. 速度と位置へ反映。1 ステップの移動は半径の半分までに抑える
+    const float maxStep = 0.5f * h;
+    float3* mutablePositions = neighbors.positions.data();
+    for (size_t i = 0; i < count; ++i) {
+        float3 dv = forces[i] * (dt / massOf(static_cast<uint32_t>(i)));
+        const float step = std::sqrt(dv.x*dv.x + dv.y*dv.y + dv.z*dv.z) * dt;
+        if (step > maxStep) dv *= maxStep / step;
+        velocities[i] += dv;
+        mutablePositions[i] += dv * dt;
     }
 }
 
@@ -39,8 +39,22 @@ module;
 #include <random>
 module Property.LinkManager;
 
+import Script.Expression.MemoCache;
+
 namespace ArtifactCore {
 
+namespace {
+
+// 式からはプロパティ名の変数として参照されるため、その変数を読む評価結果だけを無効化する
+void invalidateMemoFor(const AbstractProperty* property) {
+    if (!property) return;
+    const std::string name = property->getName().toStdString();
+    auto& cache = ExpressionMemoCache::shared();
+    cache.invalidate(ExpressionMemoCache::dependencyHash(name));
+}
+
+}
+
 PropertyLinkManager& PropertyLinkManager::instance() {
     static PropertyLinkManager instance;
     return instance;
@@ -52,10 +66,12 @@ void PropertyLinkManager::addLink(AbstractProperty* source, AbstractProperty* ta
     link.target = target;
     link.type = type;
     links_.push_back(link);
+    invalidateMemoFor(target);
 }
 
 void PropertyLinkManager::addLink(const PropertyLink& link) {
     links_.push_back(link);
+    invalidateMemoFor(link.target);
 }
 
 void PropertyLinkManager::updateTargets(AbstractProperty* source) {
@@ -98,6 +114,8 @@ void PropertyLinkManager::updateTargets(AbstractProperty* source) {
 
             if (targetValue.isValid()) {
                 link.target->setValue(targetValue);
+                // 式の評価結果はリンク先の値に依存しうるため、そのプロパティを読む結果だけ無効化する
+                invalidateMemoFor(link.target);
             }
         }
     }
@@ -108,6 +126,9 @@ const std::vector<PropertyLink>& PropertyLinkManager::links() const {
 }
 
 void PropertyLinkManager::clear() {
+    for (const auto& link : links_) {
+        invalidateMemoFor(link.target);
+    }
     links_.clear();
 }
 
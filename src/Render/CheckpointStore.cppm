@@ -6,6 +6,16 @@ module;
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <map>
+#include <vector>
+#include <cstdint>
+#include <bit>
+#include <algorithm>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 #include <QString>
 #include <QDir>
 #include <QFile>
@@ -13,6 +23,10 @@ module;
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDateTime>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QElapsedTimer>
+#include <QtEndian>
 
 module Render.Farm.Checkpoint;
 
@@ -29,6 +43,197 @@ bool isSafeCheckpointJobId(const QString& jobId)
            !jobId.contains(QChar('/')) && !jobId.contains(QChar('\\')) &&
            !jobId.contains(QChar(':'));
 }
+
+// checkpoint.journal: a 32-byte header followed by 8-byte record headers,
+// all little-endian. Completed frames are bare record headers; compaction
+// rewrites the file as bitmap records plus one record per failure.
+constexpr std::uint32_t kJournalMagic = 0x4A435241; // "ARCJ"
+constexpr std::uint16_t kJournalVersion = 1;
+constexpr qsizetype kJournalHeaderBytes = 32;
+constexpr qsizetype kRecordHeaderBytes = 8;
+constexpr int kBitmapWordsPerRecord = 8190; // payload stays below 64 KiB
+
+enum class JournalRecord : std::uint8_t {
+    FrameCompleted = 1,
+    FrameFailed = 2,
+    CompletedBitmap = 3
+};
+
+template <typename T>
+void appendLE(QByteArray& out, T value) {
+    char bytes[sizeof(T)];
+    qToLittleEndian(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+template <typename T>
+T readLE(const char* data) {
+    return qFromLittleEndian<T>(data);
+}
+
+void appendRecord(QByteArray& out, JournalRecord type, std::uint8_t flags, int frame,
+                  const QByteArray& payload = {}) {
+    out.append(static_cast<char>(type));
+    out.append(static_cast<char>(flags));
+    appendLE(out, static_cast<std::uint16_t>(payload.size()));
+    appendLE(out, static_cast<std::int32_t>(frame));
+    out.append(payload);
+}
+
+QByteArray encodeJournalHeader(const CheckpointJournalState& state) {
+    QByteArray out;
+    out.reserve(kJournalHeaderBytes);
+    appendLE(out, kJournalMagic);
+    appendLE(out, kJournalVersion);
+    appendLE(out, static_cast<std::uint16_t>(kJournalHeaderBytes));
+    appendLE(out, static_cast<std::int32_t>(state.completed.range.startFrame));
+    appendLE(out, static_cast<std::int32_t>(state.completed.range.endFrame));
+    appendLE(out, static_cast<std::int32_t>(state.completed.range.step));
+    appendLE(out, static_cast<std::int32_t>(state.totalFrames));
+    appendLE(out, static_cast<std::int64_t>(state.createdAt.toMSecsSinceEpoch()));
+    return out;
+}
+
+QByteArray encodeFailure(const FailedFrameRecord& record) {
+    QByteArray payload;
+    appendLE(payload, static_cast<std::int32_t>(record.attempt));
+    payload.append(record.errorMessage.toUtf8().left(4096));
+    QByteArray out;
+    appendRecord(out, JournalRecord::FrameFailed, record.held ? 1 : 0, record.frame, payload);
+    return out;
+}
+
+void applyFailure(FailureManifest& failures, const FailedFrameRecord& record) {
+    for (auto& existing : failures.failedFrames) {
+        if (existing.frame == record.frame) {
+            existing = record;
+            return;
+        }
+    }
+    failures.failedFrames.push_back(record);
+}
+
+// Replays a journal into state. validEnd is the offset after the last intact
+// record; anything past it is a torn write.
+bool parseJournal(const QByteArray& data, CheckpointJournalState& state, qsizetype& validEnd) {
+    validEnd = 0;
+    if (data.size() < kJournalHeaderBytes) return false;
+    const char* p = data.constData();
+    if (readLE<std::uint32_t>(p) != kJournalMagic
+        || readLE<std::uint16_t>(p + 4) != kJournalVersion
+        || readLE<std::uint16_t>(p + 6) != kJournalHeaderBytes)
+        return false;
+    RenderFrameRange range;
+    range.startFrame = readLE<std::int32_t>(p + 8);
+    range.endFrame = readLE<std::int32_t>(p + 12);
+    range.step = readLE<std::int32_t>(p + 16);
+    state.completed.reset(range);
+    state.totalFrames = readLE<std::int32_t>(p + 20);
+    state.createdAt = QDateTime::fromMSecsSinceEpoch(readLE<std::int64_t>(p + 24));
+    state.failures = {};
+    state.recordCount = 0;
+
+    qsizetype offset = kJournalHeaderBytes;
+    while (data.size() - offset >= kRecordHeaderBytes) {
+        const auto type = static_cast<JournalRecord>(static_cast<std::uint8_t>(p[offset]));
+        const auto flags = static_cast<std::uint8_t>(p[offset + 1]);
+        const qsizetype payloadBytes = readLE<std::uint16_t>(p + offset + 2);
+        const int frame = readLE<std::int32_t>(p + offset + 4);
+        if (data.size() - offset - kRecordHeaderBytes < payloadBytes) break;
+        const char* payload = p + offset + kRecordHeaderBytes;
+
+        if (type == JournalRecord::FrameCompleted && payloadBytes == 0) {
+            state.completed.insert(frame);
+        } else if (type == JournalRecord::FrameFailed && payloadBytes >= 4) {
+            FailedFrameRecord record;
+            record.frame = frame;
+            record.attempt = readLE<std::int32_t>(payload);
+            record.errorMessage = QString::fromUtf8(payload + 4, payloadBytes - 4);
+            record.held = (flags & 1) != 0;
+            applyFailure(state.failures, record);
+        } else if (type == JournalRecord::CompletedBitmap && payloadBytes % 8 == 0
+                   && frame >= 0
+                   && static_cast<std::size_t>(frame) + payloadBytes / 8 <= state.completed.words.size()) {
+            const int total = state.completed.range.count();
+            for (qsizetype i = 0; i < payloadBytes / 8; ++i) {
+                const std::size_t w = static_cast<std::size_t>(frame + i);
+                auto& word = state.completed.words[w];
+                // Bits past the last frame are never set by the writer.
+                const int validBits = std::min(64, total - static_cast<int>(w * 64));
+                const std::uint64_t mask = validBits >= 64 ? ~std::uint64_t{0}
+                                                           : (std::uint64_t{1} << validBits) - 1;
+                const std::uint64_t added = readLE<std::uint64_t>(payload + i * 8) & mask & ~word;
+                word |= added;
+                state.completed.count += std::popcount(added);
+            }
+        } else {
+            break;
+        }
+        offset += kRecordHeaderBytes + payloadBytes;
+        ++state.recordCount;
+    }
+    validEnd = offset;
+    return true;
+}
+
+bool syncFile(QFile& file) {
+    if (!file.flush()) return false;
+#if defined(_WIN32)
+    return _commit(file.handle()) == 0;
+#else
+    return ::fsync(file.handle()) == 0;
+#endif
+}
+
+struct OpenJournal {
+    std::unique_ptr<QFile> file;
+    CheckpointJournalState state;
+    int unsyncedRecords = 0;
+    int recordsSinceCompaction = 0;
+    QElapsedTimer sinceSync;
+};
+}
+
+void CompletedFrameSet::reset(const RenderFrameRange& frameRange) {
+    range = frameRange;
+    range.step = std::max(1, frameRange.step);
+    words.assign((static_cast<std::size_t>(range.count()) + 63) / 64, 0);
+    count = 0;
+}
+
+int CompletedFrameSet::indexOf(int frame) const {
+    if (!range.contains(frame)) return -1;
+    const long long offset = static_cast<long long>(frame) - range.startFrame;
+    return offset % range.step == 0 ? static_cast<int>(offset / range.step) : -1;
+}
+
+bool CompletedFrameSet::containsIndex(int index) const {
+    if (index < 0 || static_cast<std::size_t>(index) / 64 >= words.size()) return false;
+    return (words[static_cast<std::size_t>(index) / 64] >> (index % 64)) & 1u;
+}
+
+bool CompletedFrameSet::contains(int frame) const {
+    return containsIndex(indexOf(frame));
+}
+
+bool CompletedFrameSet::insert(int frame) {
+    const int index = indexOf(frame);
+    if (index < 0 || containsIndex(index)) return false;
+    words[static_cast<std::size_t>(index) / 64] |= std::uint64_t{1} << (index % 64);
+    ++count;
+    return true;
+}
+
+int CompletedFrameSet::completedPrefixEnd() const {
+    const int total = range.count();
+    for (std::size_t w = 0; w < words.size(); ++w) {
+        if (words[w] == ~std::uint64_t{0}) continue;
+        const int index = static_cast<int>(w * 64) + std::countr_one(words[w]);
+        if (index >= total) break;
+        return static_cast<int>(static_cast<long long>(range.startFrame)
+                                + static_cast<long long>(index) * range.step);
+    }
+    return range.endFrame;
 }
 
 class CheckpointStore::Impl {
@@ -99,6 +304,93 @@ public:
         }
         return true;
     }
+
+    // -- Journal --
+    CheckpointJournalPolicy journalPolicy_;
+    std::map<QString, std::unique_ptr<OpenJournal>> journals_;
+
+    QString journalPath(const QString& jobId) const {
+        const QString dir = jobDir(jobId);
+        return dir.isEmpty() ? QString() : dir + QDir::separator() + "checkpoint.journal";
+    }
+
+    OpenJournal* openJournal(const QString& jobId) const {
+        const auto it = journals_.find(jobId);
+        return it == journals_.end() ? nullptr : it->second.get();
+    }
+
+    bool readJournal(const QString& jobId, CheckpointJournalState& state, qsizetype* validEnd = nullptr) const {
+        QFile file(journalPath(jobId));
+        if (!file.open(QIODevice::ReadOnly)) return false;
+        qsizetype end = 0;
+        if (!parseJournal(file.readAll(), state, end)) return false;
+        state.jobId = jobId;
+        if (validEnd) *validEnd = end;
+        return true;
+    }
+
+    // Rewrites the journal as header + bitmap + failures and reopens it for
+    // appending. The old file stays intact until the new one is committed.
+    bool writeSnapshot(const QString& jobId, OpenJournal& journal) {
+        QByteArray out = encodeJournalHeader(journal.state);
+        const auto& words = journal.state.completed.words;
+        for (std::size_t first = 0; first < words.size(); first += kBitmapWordsPerRecord) {
+            const std::size_t end = std::min(words.size(), first + kBitmapWordsPerRecord);
+            std::size_t lo = first;
+            while (lo < end && words[lo] == 0) ++lo;
+            if (lo == end) continue;
+            QByteArray payload;
+            payload.reserve(static_cast<qsizetype>((end - lo) * 8));
+            for (std::size_t w = lo; w < end; ++w) appendLE(payload, words[w]);
+            appendRecord(out, JournalRecord::CompletedBitmap, 0, static_cast<int>(lo), payload);
+        }
+        for (const auto& failure : journal.state.failures.failedFrames)
+            out.append(encodeFailure(failure));
+
+        if (journal.file) journal.file->close();
+        QSaveFile saveFile(journalPath(jobId));
+        bool ok = saveFile.open(QIODevice::WriteOnly)
+            && saveFile.write(out) == out.size()
+            && saveFile.commit();
+
+        journal.file = std::make_unique<QFile>(journalPath(jobId));
+        if (!journal.file->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+            return false;
+        journal.unsyncedRecords = 0;
+        journal.recordsSinceCompaction = 0;
+        journal.sinceSync.start();
+        return ok;
+    }
+
+    bool sync(OpenJournal& journal) {
+        if (journal.unsyncedRecords == 0) return true;
+        journal.unsyncedRecords = 0;
+        journal.sinceSync.start();
+        return syncFile(*journal.file);
+    }
+
+    bool append(const QString& jobId, OpenJournal& journal, const QByteArray& record) {
+        if (journal.file->write(record) != record.size()) return false;
+        ++journal.state.recordCount;
+        ++journal.unsyncedRecords;
+        if (++journal.recordsSinceCompaction >= journalPolicy_.compactEveryRecords)
+            return writeSnapshot(jobId, journal);
+        if (journal.unsyncedRecords >= journalPolicy_.syncEveryRecords
+            || journal.sinceSync.elapsed() >= journalPolicy_.syncIntervalMs)
+            return sync(journal);
+        return true;
+    }
+
+    CheckpointInfo infoFromJournal(const CheckpointJournalState& state) const {
+        CheckpointInfo info;
+        info.jobId = state.jobId;
+        info.completedUpToFrame = state.completed.completedPrefixEnd();
+        info.totalFrames = state.totalFrames;
+        info.failures = state.failures;
+        info.createdAt = state.createdAt;
+        info.updatedAt = QFileInfo(journalPath(state.jobId)).lastModified();
+        return info;
+    }
 };
 
 CheckpointStore::CheckpointStore()
@@ -107,7 +399,11 @@ CheckpointStore::CheckpointStore()
     impl_->basePath_ = defaultBasePath();
 }
 
-CheckpointStore::~CheckpointStore() = default;
+CheckpointStore::~CheckpointStore() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    for (auto& [jobId, journal] : impl_->journals_)
+        impl_->sync(*journal);
+}
 
 void CheckpointStore::setBasePath(const QString& path) {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
@@ -142,7 +438,17 @@ Optional<CheckpointInfo> CheckpointStore::load(const QString& jobId) {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
     QString path = impl_->filePath(jobId);
     QFile file(path);
-    if (!file.open(QIODevice::ReadOnly)) return {};
+    if (!file.open(QIODevice::ReadOnly)) {
+        // Journal-only jobs resume from the contiguous completed prefix here;
+        // loadJournal() gives the exact frame set.
+        CheckpointJournalState state;
+        if (const auto* journal = impl_->openJournal(jobId)) {
+            state = journal->state;
+        } else if (!impl_->readJournal(jobId, state)) {
+            return {};
+        }
+        return impl_->infoFromJournal(state);
+    }
 
     QByteArray data = file.readAll();
     file.close();
@@ -156,8 +462,10 @@ Optional<CheckpointInfo> CheckpointStore::load(const QString& jobId) {
 
 bool CheckpointStore::remove(const QString& jobId) {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
-    QString path = impl_->filePath(jobId);
-    return QFile::remove(path);
+    impl_->journals_.erase(jobId);
+    const bool removedSnapshot = QFile::remove(impl_->filePath(jobId));
+    const bool removedJournal = QFile::remove(impl_->journalPath(jobId));
+    return removedSnapshot || removedJournal;
 }
 
 QStringList CheckpointStore::listCheckpoints() const {
@@ -168,7 +476,8 @@ QStringList CheckpointStore::listCheckpoints() const {
     QStringList entries = dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
     QStringList results;
     for (const auto& entry : entries) {
-        if (QFile::exists(checkpointFilePath(impl_->basePath_, entry))) {
+        if (QFile::exists(checkpointFilePath(impl_->basePath_, entry))
+            || QFile::exists(journalFilePath(impl_->basePath_, entry))) {
             results.append(entry);
         }
     }
@@ -177,7 +486,109 @@ QStringList CheckpointStore::listCheckpoints() const {
 
 bool CheckpointStore::checkpointExists(const QString& jobId) const {
     std::lock_guard<std::mutex> lock(impl_->mutex_);
-    return QFile::exists(impl_->filePath(jobId));
+    return QFile::exists(impl_->filePath(jobId)) || QFile::exists(impl_->journalPath(jobId));
+}
+
+void CheckpointStore::setJournalPolicy(const CheckpointJournalPolicy& policy) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->journalPolicy_ = policy;
+    impl_->journalPolicy_.syncEveryRecords = std::max(1, policy.syncEveryRecords);
+    impl_->journalPolicy_.syncIntervalMs = std::max(0, policy.syncIntervalMs);
+    impl_->journalPolicy_.compactEveryRecords = std::max(1, policy.compactEveryRecords);
+}
+
+CheckpointJournalPolicy CheckpointStore::journalPolicy() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->journalPolicy_;
+}
+
+bool CheckpointStore::openJournal(const QString& jobId, const RenderFrameRange& range, int totalFrames) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (!isSafeCheckpointJobId(jobId)) return false;
+    RenderFrameRange normalized = range;
+    normalized.step = std::max(1, range.step);
+    const auto sameRange = [&](const RenderFrameRange& other) {
+        return other.startFrame == normalized.startFrame && other.endFrame == normalized.endFrame
+            && other.step == normalized.step;
+    };
+    if (auto* journal = impl_->openJournal(jobId))
+        return sameRange(journal->state.completed.range);
+    if (!impl_->ensureDir(impl_->jobDir(jobId))) return false;
+
+    auto journal = std::make_unique<OpenJournal>();
+    qsizetype validEnd = 0;
+    if (impl_->readJournal(jobId, journal->state, &validEnd) && sameRange(journal->state.completed.range)) {
+        journal->file = std::make_unique<QFile>(impl_->journalPath(jobId));
+        if (!journal->file->open(QIODevice::ReadWrite | QIODevice::Unbuffered)) return false;
+        // Drop a record torn by a crash so new records follow intact ones.
+        if (journal->file->size() != validEnd && !journal->file->resize(validEnd)) return false;
+        journal->file->close();
+        if (!journal->file->open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+            return false;
+        journal->sinceSync.start();
+    } else {
+        journal->state = {};
+        journal->state.jobId = jobId;
+        journal->state.totalFrames = totalFrames;
+        journal->state.createdAt = QDateTime::currentDateTime();
+        journal->state.completed.reset(normalized);
+        if (!impl_->writeSnapshot(jobId, *journal)) return false;
+    }
+    impl_->journals_[jobId] = std::move(journal);
+    return true;
+}
+
+bool CheckpointStore::appendFrameCompleted(const QString& jobId, int frame) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto* journal = impl_->openJournal(jobId);
+    if (!journal) return false;
+    if (!journal->state.completed.insert(frame)) return true;
+    QByteArray record;
+    appendRecord(record, JournalRecord::FrameCompleted, 0, frame);
+    return impl_->append(jobId, *journal, record);
+}
+
+bool CheckpointStore::appendFrameFailed(const QString& jobId, const FailedFrameRecord& record) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto* journal = impl_->openJournal(jobId);
+    if (!journal) return false;
+    applyFailure(journal->state.failures, record);
+    return impl_->append(jobId, *journal, encodeFailure(record));
+}
+
+bool CheckpointStore::syncJournal(const QString& jobId) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto* journal = impl_->openJournal(jobId);
+    return journal && impl_->sync(*journal);
+}
+
+bool CheckpointStore::compactJournal(const QString& jobId) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto* journal = impl_->openJournal(jobId);
+    return journal && impl_->writeSnapshot(jobId, *journal);
+}
+
+bool CheckpointStore::closeJournal(const QString& jobId) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto* journal = impl_->openJournal(jobId);
+    if (!journal) return false;
+    const bool ok = journal->recordsSinceCompaction > 0
+        ? impl_->writeSnapshot(jobId, *journal) : impl_->sync(*journal);
+    impl_->journals_.erase(jobId);
+    return ok;
+}
+
+Optional<CheckpointJournalState> CheckpointStore::loadJournal(const QString& jobId) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    if (const auto* journal = impl_->openJournal(jobId)) return journal->state;
+    CheckpointJournalState state;
+    if (!impl_->readJournal(jobId, state)) return {};
+    return state;
+}
+
+bool CheckpointStore::journalExists(const QString& jobId) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->openJournal(jobId) || QFile::exists(impl_->journalPath(jobId));
 }
 
 QString CheckpointStore::defaultBasePath() {
@@ -189,4 +600,9 @@ QString CheckpointStore::checkpointFilePath(const QString& basePath, const QStri
     return basePath + QDir::separator() + jobId + QDir::separator() + "checkpoint.json";
 }
 
+QString CheckpointStore::journalFilePath(const QString& basePath, const QString& jobId) {
+    if (!isSafeCheckpointJobId(jobId)) return {};
+    return basePath + QDir::separator() + jobId + QDir::separator() + "checkpoint.journal";
+}
+
 }
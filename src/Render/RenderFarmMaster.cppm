@@ -1,6 +1,7 @@
 module;
 #include <utility>
 #include <vector>
+#include <cstdint>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -9,11 +10,11 @@ module;
 #include <atomic>
 #include <chrono>
 #include <random>
-#include <unordered_set>
 #include <map>
 #include <deque>
 #include <string>
 #include <condition_variable>
+#include <optional>
 #include <QString>
 #include <QStringList>
 #include <QJsonObject>
@@ -41,6 +42,7 @@ import Container.NamedVector;
 
 import Render.Farm.Types;
 import Render.Farm.Checkpoint;
+import Render.Farm.Scheduler;
 import Core.ThreadPool;
 import NetworkRPCServer;
 
@@ -77,14 +79,8 @@ struct WorkerProgress {
     }
 };
 
-struct RemoteJobSlice {
-    QString workerId;
-    RenderFrameRange range;
-    bool assigned = false;
-    bool completed = false;
-    int framesCompleted_ = 0;  // how many individual frames reported done
-    std::unordered_set<int> reportedFrames;
-};
+// Local render threads pull chunks under this prefix plus their index.
+const QString kLocalWorkerPrefix = QStringLiteral("local:");
 
 class RenderFarmMaster::Impl {
 public:
@@ -173,10 +169,9 @@ public:
     std::atomic<bool> allowRemote_{ false };
     std::atomic<unsigned short> rpcPort_{ 0 };
     std::atomic<bool> rpcRunning_{ false };
-    NamedVector<RemoteJobSlice> remoteSlices_;
+    RenderFrameScheduler scheduler_;
     std::mutex remoteMutex_;
-    std::atomic<int> remoteCompleted_{0};
-    std::atomic<int> totalRemoteFrames_{ 0 };
+    std::optional<RenderJobRequest> activeRequest_;  // guarded by remoteMutex_
     std::mutex remoteWaitMutex_;
     std::condition_variable remoteCv_;
     std::function<void(const QString&, int, bool)> onRemoteFrameResult_;
@@ -370,26 +365,6 @@ public:
         }
     }
 
-    NamedVector<RenderFrameRange> splitRange(const RenderFrameRange& range, int parts) const {
-        NamedVector<RenderFrameRange> subRanges;
-        if (parts <= 0 || range.count() <= 0) return subRanges;
-
-        int totalFrames = range.count();
-        int baseChunk = std::max(1, totalFrames / parts);
-        int remainder = totalFrames - baseChunk * parts;
-        int current = range.startFrame;
-
-        for (int i = 0; i < parts && current < range.endFrame; ++i) {
-            int chunkSize = baseChunk + (i < remainder ? 1 : 0);
-            const long long candidateEnd = static_cast<long long>(current) +
-                                           static_cast<long long>(chunkSize) * range.step;
-            int chunkEnd = static_cast<int>(std::min<long long>(candidateEnd, range.endFrame));
-            subRanges.push_back({ current, chunkEnd, range.step });
-            current = chunkEnd;
-        }
-        return subRanges;
-    }
-
     bool shouldRetry(int frame, int currentAttempt) const {
         if (retryPolicy_.maxAttempts <= 0) return false;
         return currentAttempt < retryPolicy_.maxAttempts;
@@ -626,8 +601,11 @@ public:
     }
 
     void recordFrameFailure(int frame) {
-        std::lock_guard<std::mutex> lock(resultMutex_);
-        finalResult_.failures.addFailure(frame, 1, "Render failed");
+        {
+            std::lock_guard<std::mutex> lock(resultMutex_);
+            finalResult_.failures.addFailure(frame, 1, "Render failed");
+        }
+        journalFrameFailure(frame);
     }
 
     void markFrameFailed(int frame) {
@@ -635,6 +613,37 @@ public:
         recordFrameFailure(frame);
     }
 
+    bool journalEnabled() const {
+        return checkpointPolicy_.mode != CheckpointPolicy::Mode::Disabled
+            && checkpointPolicy_.format == CheckpointPolicy::Format::Journal;
+    }
+
+    QString currentJobId() const {
+        std::lock_guard<std::mutex> lock(jobStateMutex_);
+        return currentJobId_;
+    }
+
+    // Journal records are appended as frames are accepted, so the checkpoint
+    // never has to be rebuilt from the whole job state.
+    void journalFrameCompleted(int frame) {
+        if (!journalEnabled()) return;
+        checkpointStore_->appendFrameCompleted(currentJobId(), frame);
+    }
+
+    void journalFrameFailure(int frame) {
+        if (!journalEnabled()) return;
+        FailedFrameRecord record;
+        {
+            std::lock_guard<std::mutex> lock(resultMutex_);
+            const auto& failed = finalResult_.failures.failedFrames;
+            const auto it = std::find_if(failed.begin(), failed.end(),
+                [frame](const FailedFrameRecord& f) { return f.frame == frame; });
+            if (it == failed.end()) return;
+            record = *it;
+        }
+        checkpointStore_->appendFrameFailed(currentJobId(), record);
+    }
+
     void saveCheckpoint(int baseFrame = 0) {
         if (checkpointPolicy_.mode == CheckpointPolicy::Mode::Disabled) return;
         QString jobId;
@@ -645,6 +654,10 @@ public:
             totalFrames = totalFrames_;
         }
         if (jobId.isEmpty()) return;
+        if (checkpointPolicy_.format == CheckpointPolicy::Format::Journal) {
+            checkpointStore_->syncJournal(jobId);
+            return;
+        }
 
         int completed = totalProgress_.completed.load();
         if (completed <= 0) return;
@@ -665,12 +678,25 @@ public:
         checkpointStore_->save(cp);
     }
 
+    // Reports a locally rendered frame to the scheduler. Returns false when
+    // another worker already reported it, in which case it is not counted.
+    bool reportLocalFrame(const FrameChunk* chunk, int frame, bool success) {
+        if (!chunk) return true;
+        const FrameReportResult report = scheduler_.reportFrame(chunk->workerId, frame, success);
+        flushChunkRevisions();
+        if (report.accepted) remoteCv_.notify_all();
+        return report.accepted;
+    }
+
     // -- Local rendering --
     void executeLocalRange(const RenderJobRequest& request, const RenderFrameRange& subRange,
-                           std::atomic<int>& checkpointCounter) {
+                           std::atomic<int>& checkpointCounter,
+                           const FrameChunk* chunk = nullptr) {
         for (int frame = subRange.startFrame; frame < subRange.endFrame;
              frame = frame > std::numeric_limits<int>::max() - subRange.step
                  ? subRange.endFrame : frame + subRange.step) {
+            // Stolen, withdrawn or already rendered by a speculative copy.
+            if (chunk && !scheduler_.shouldRender(chunk->id, frame)) continue;
             {
                 std::unique_lock<std::mutex> lock(pauseMutex_);
                 pauseCv_.wait(lock, [this]() { return !paused_.load() || cancelled_.load(); });
@@ -686,7 +712,10 @@ public:
             if (!existingFramePath.isEmpty()) {
                 const QFileInfo existingFrame(existingFramePath);
                 if (existingFrame.isFile() && existingFrame.size() > 0) {
-                    totalProgress_.completed.fetch_add(1);
+                    if (reportLocalFrame(chunk, frame, true)) {
+                        totalProgress_.completed.fetch_add(1);
+                        journalFrameCompleted(frame);
+                    }
                     if (checkpointPolicy_.mode == CheckpointPolicy::Mode::EveryNFrames) {
                         int c = ++checkpointCounter;
                         if (c >= checkpointPolicy_.interval) {
@@ -727,8 +756,11 @@ public:
                 }
 
                 if (ok) {
-                    totalProgress_.completed.fetch_add(1);
-                    emitProgress();
+                    if (reportLocalFrame(chunk, frame, true)) {
+                        totalProgress_.completed.fetch_add(1);
+                        journalFrameCompleted(frame);
+                        emitProgress();
+                    }
                     break;
                 }
 
@@ -736,11 +768,13 @@ public:
                 recordFrameFailure(frame);
 
                 if (!shouldRetry(frame, attempt)) {
+                    if (!reportLocalFrame(chunk, frame, false)) break;
                     totalProgress_.failed.fetch_add(1);
                     {
                         std::lock_guard<std::mutex> lock(resultMutex_);
                         finalResult_.failures.setHeld(frame, true);
                     }
+                    journalFrameFailure(frame);
                     emitProgress();
                     break;
                 }
@@ -759,68 +793,117 @@ public:
         }
     }
 
+    // Pulls chunks for one local render thread until every frame is
+    // reported. With nothing left to hand out the thread waits briefly: a
+    // disconnecting worker may return frames, or a straggler may become worth
+    // stealing from or duplicating.
+    void executeLocalChunks(const RenderJobRequest& request, const QString& workerId,
+                            std::atomic<int>& checkpointCounter) {
+        while (!cancelled_ && !scheduler_.finished()) {
+            if (deadlineReached()) {
+                timedOut_ = true;
+                cancelled_ = true;
+                break;
+            }
+            const FrameChunk chunk = scheduler_.requestChunk(workerId);
+            if (chunk.isValid()) {
+                flushChunkRevisions();
+                executeLocalRange(request, chunk.range, checkpointCounter, &chunk);
+                continue;
+            }
+            std::unique_lock<std::mutex> waitLock(remoteWaitMutex_);
+            remoteCv_.wait_for(waitLock, std::chrono::milliseconds(100), [this]() {
+                return cancelled_.load() || scheduler_.finished() || scheduler_.hasWork();
+            });
+        }
+    }
+
     // -- Remote rendering --
-    void assignRemoteSlices(const RenderJobRequest& request) {
+    QJsonObject remoteJobJson(const RenderJobRequest& request, const FrameChunk& chunk) const {
+        QJsonObject jobJson;
+        jobJson["jobId"] = currentJobIdSnapshot();
+        jobJson["chunkId"] = chunk.id;
+        jobJson["speculative"] = chunk.speculative;
+        jobJson["compositionId"] = request.compositionId.toString();
+        jobJson["compositionName"] = request.compositionName;
+        jobJson["startFrame"] = chunk.range.startFrame;
+        jobJson["endFrame"] = chunk.range.endFrame;
+        jobJson["step"] = chunk.range.step;
+        jobJson["outputPath"] = request.outputPath;
+        jobJson["autoVersionOutput"] = request.autoVersionOutput;
+        jobJson["enableAudio"] = request.enableAudio;
+        jobJson["priority"] = request.priority;
+        jobJson["jobPool"] = request.jobPool;
+        jobJson["allowedWorkerIds"] = QJsonArray::fromStringList(request.allowedWorkerIds);
+        jobJson["jobTimeoutMs"] = request.jobTimeoutMs;
+        jobJson["frameTimeoutMs"] = request.frameTimeoutMs;
+        jobJson["retryMaxAttempts"] = retryPolicy_.maxAttempts;
+        jobJson["retryInitialBackoffMs"] = retryPolicy_.initialBackoffMs;
+        if (!request.renderPayload.isEmpty())
+            jobJson["renderPayload"] = request.renderPayload;
+        if (!request.rendererExecutable.isEmpty())
+            jobJson["rendererExecutable"] = request.rendererExecutable;
+        return jobJson;
+    }
+
+    bool remoteWorkerEligible(const RemoteWorkerInfo& worker, const RenderJobRequest& request) const {
+        if (worker.workerId.isEmpty() || !worker.connected
+            || worker.workerId.startsWith(kLocalWorkerPrefix)
+            || worker.state == QStringLiteral("Maintenance"))
+            return false;
+        if (!request.allowedWorkerIds.isEmpty() && !request.allowedWorkerIds.contains(worker.workerId))
+            return false;
+        if (!workerMatches(worker, request.requiredCapabilities)) return false;
+        // Workers already on this job get their next chunk as soon as the
+        // previous one is done; others must be idle, as before.
+        if (scheduler_.isParticipant(worker.workerId))
+            return !scheduler_.hasActiveChunk(worker.workerId);
+        return worker.assignedFrames == 0 && worker.state == QStringLiteral("Idle");
+    }
+
+    // Hands the next chunk to a remote worker. Called when a job starts, when
+    // a worker connects, finishes its chunk or asks for frames.
+    bool dispatchRemoteChunk(const QString& workerId) {
+        if (!allowRemote_ || cancelled_) return false;
+        auto& rpc = NetworkPCServer::instance();
+        std::lock_guard<std::mutex> lock(remoteMutex_);
+        if (!activeRequest_) return false;
+        const RemoteWorkerInfo worker = rpc.workerInfo(workerId);
+        if (!remoteWorkerEligible(worker, *activeRequest_)) return false;
+        const FrameChunk chunk = scheduler_.requestChunk(
+            workerId, std::max<qint64>(0, worker.heartbeatLatencyMs));
+        if (!chunk.isValid()) return false;
+        flushChunkRevisions();
+        if (!rpc.sendJobAssignment(workerId, remoteJobJson(*activeRequest_, chunk))) {
+            scheduler_.releaseWorker(workerId);
+            return false;
+        }
+        return true;
+    }
+
+    void dispatchRemoteChunks() {
         if (!allowRemote_) return;
+        for (const auto& worker : NetworkPCServer::instance().connectedWorkers())
+            dispatchRemoteChunk(worker.workerId);
+    }
 
+    // Tells remote owners of shrunk chunks where to stop. Local threads
+    // notice through shouldRender() instead.
+    void flushChunkRevisions() {
+        const auto revisions = scheduler_.takeRevisions();
+        if (revisions.empty()) return;
         auto& rpc = NetworkPCServer::instance();
-        auto workers = rpc.connectedWorkers();
-        if (workers.empty()) return;
-
-        // Filter connected workers with valid IDs
-        NamedVector<RemoteWorkerInfo> activeWorkers;
-        for (const auto& w : workers) {
-            if (!w.workerId.isEmpty() && w.connected && w.assignedFrames == 0
-                && w.state == QStringLiteral("Idle")
-                && (request.allowedWorkerIds.isEmpty() || request.allowedWorkerIds.contains(w.workerId))
-                && workerMatches(w, request.requiredCapabilities))
-                activeWorkers.push_back(w);
-        }
-        if (activeWorkers.empty()) return;
-
-        // Split remaining range across remote workers
-        int localWorkers = workerCount_;
-        int totalParts = localWorkers + static_cast<int>(activeWorkers.size());
-        auto allRanges = splitRange(request.range, totalParts);
-
-        // Assign remote slices (last N parts go to remote)
-        int remoteStart = std::max(0, static_cast<int>(allRanges.size()) - static_cast<int>(activeWorkers.size()));
-        {
-            std::lock_guard<std::mutex> lock(remoteMutex_);
-            remoteSlices_.clear();
-            for (size_t i = 0; i < activeWorkers.size(); ++i) {
-                int idx = remoteStart + static_cast<int>(i);
-                if (idx < static_cast<int>(allRanges.size())) {
-                    QJsonObject jobJson;
-                    jobJson["compositionId"] = request.compositionId.toString();
-                    jobJson["compositionName"] = request.compositionName;
-                    jobJson["startFrame"] = allRanges[idx].startFrame;
-                    jobJson["endFrame"] = allRanges[idx].endFrame;
-                    jobJson["step"] = allRanges[idx].step;
-                    jobJson["outputPath"] = request.outputPath;
-                    jobJson["autoVersionOutput"] = request.autoVersionOutput;
-                    jobJson["enableAudio"] = request.enableAudio;
-                    jobJson["priority"] = request.priority;
-                    jobJson["jobPool"] = request.jobPool;
-                    jobJson["allowedWorkerIds"] = QJsonArray::fromStringList(request.allowedWorkerIds);
-                    jobJson["jobTimeoutMs"] = request.jobTimeoutMs;
-                    jobJson["frameTimeoutMs"] = request.frameTimeoutMs;
-                    jobJson["retryMaxAttempts"] = retryPolicy_.maxAttempts;
-                    jobJson["retryInitialBackoffMs"] = retryPolicy_.initialBackoffMs;
-                    if (!request.renderPayload.isEmpty())
-                        jobJson["renderPayload"] = request.renderPayload;
-                    if (!request.rendererExecutable.isEmpty())
-                        jobJson["rendererExecutable"] = request.rendererExecutable;
-
-                    rpc.sendJobAssignment(activeWorkers[i].workerId, jobJson);
-
-                    RemoteJobSlice slice;
-                    slice.workerId = activeWorkers[i].workerId;
-                    slice.range = allRanges[idx];
-                    slice.assigned = true;
-                    remoteSlices_.push_back(slice);
-                }
-            }
+        const QString jobId = currentJobIdSnapshot();
+        for (const auto& revision : revisions) {
+            if (revision.workerId.startsWith(kLocalWorkerPrefix)) continue;
+            const QJsonObject params{
+                {QStringLiteral("jobId"), jobId},
+                {QStringLiteral("chunkId"), revision.chunkId},
+                {QStringLiteral("startFrame"), revision.range.startFrame},
+                {QStringLiteral("endFrame"), revision.range.endFrame},
+                {QStringLiteral("step"), revision.range.step}
+            };
+            rpc.sendJobRevision(revision.workerId, params, revision.withdrawnFrames);
         }
     }
 
@@ -859,14 +942,6 @@ public:
             }
         }
 
-        // Clear remote state from previous job
-        {
-            std::lock_guard<std::mutex> lock(remoteMutex_);
-            remoteSlices_.clear();
-        }
-        remoteCompleted_ = 0;
-        totalRemoteFrames_ = 0;
-
         {
             std::lock_guard<std::mutex> lock(jobStateMutex_);
             currentJobId_ = request.jobId.isEmpty()
@@ -897,7 +972,25 @@ public:
             std::lock_guard<std::mutex> lock(jobStateMutex_);
             jobId = currentJobId_;
         }
-        if (checkpointPolicy_.mode != CheckpointPolicy::Mode::Disabled && !jobId.isEmpty()) {
+        RenderFrameRange journalRange = request.range;
+        journalRange.step = std::max(1, request.range.step);
+        std::vector<std::uint8_t> journalDone;
+        if (journalEnabled() && !jobId.isEmpty()) {
+            // The journal knows exactly which frames finished, including ones
+            // completed out of order by other chunks.
+            auto journal = checkpointStore_->loadJournal(jobId);
+            const auto& range = journal ? journal->completed.range : RenderFrameRange{};
+            if (journal && range.startFrame == journalRange.startFrame
+                && range.endFrame == journalRange.endFrame && range.step == journalRange.step) {
+                journalDone.resize(static_cast<size_t>(total));
+                for (int i = 0; i < total; ++i)
+                    journalDone[static_cast<size_t>(i)] = journal->completed.containsIndex(i) ? 1 : 0;
+                totalProgress_.completed.store(journal->completed.count);
+                finalResult_.failures = journal->failures;
+            }
+        }
+        if (journalDone.empty() && checkpointPolicy_.mode != CheckpointPolicy::Mode::Disabled
+            && !jobId.isEmpty()) {
             auto existing = checkpointStore_->load(jobId);
             if (existing) {
                 restoreUpTo = std::clamp(existing->completedUpToFrame,
@@ -913,47 +1006,35 @@ public:
             }
         }
 
-        // Assign remote slices first
-        assignRemoteSlices(request);
-
-        // Determine local ranges by subtracting every remote slice. Do not
-        // assume that remote slices are adjacent or that one contiguous local
-        // range remains after remote assignment.
-        NamedVector<RenderFrameRange> localRanges;
-        localRanges.append(request.range);
+        // Every frame goes through the scheduler: remote workers and local
+        // threads pull chunks sized from their measured frame time, and idle
+        // ones steal from slow ones near the end of the job.
+        if (!journalDone.empty()) {
+            scheduler_.reset(request.range, journalDone);
+        } else {
+            scheduler_.reset(request.range, restoreUpTo > 0
+                ? restoreUpTo : std::numeric_limits<int>::min());
+        }
+        if (journalEnabled() && !jobId.isEmpty()
+            && checkpointStore_->openJournal(jobId, journalRange, total) && journalDone.empty()) {
+            // Carry a snapshot checkpoint's completed prefix into a new journal.
+            for (long long frame = request.range.startFrame; frame < restoreUpTo; frame += journalRange.step)
+                checkpointStore_->appendFrameCompleted(jobId, static_cast<int>(frame));
+        }
         {
             std::lock_guard<std::mutex> lock(remoteMutex_);
-            for (const auto& slice : remoteSlices_) {
-                NamedVector<RenderFrameRange> remaining;
-                for (const auto& candidate : localRanges) {
-                    const int overlapStart = std::max(candidate.startFrame, slice.range.startFrame);
-                    const int overlapEnd = std::min(candidate.endFrame, slice.range.endFrame);
-                    if (overlapStart >= overlapEnd) {
-                        remaining.push_back(candidate);
-                        continue;
-                    }
-                    if (candidate.startFrame < overlapStart)
-                        remaining.push_back({ candidate.startFrame, overlapStart, candidate.step });
-                    if (overlapEnd < candidate.endFrame)
-                        remaining.push_back({ overlapEnd, candidate.endFrame, candidate.step });
-                }
-                localRanges = std::move(remaining);
-            }
+            activeRequest_ = request;
         }
+        dispatchRemoteChunks();
 
         std::atomic<int> checkpointCounter{ 0 };
         NamedVector<std::thread> workers;
-        for (auto localRange : localRanges) {
-            if (restoreUpTo > 0 && restoreUpTo > localRange.startFrame)
-                localRange.startFrame = std::min(restoreUpTo, localRange.endFrame);
-            if (localRange.count() <= 0) continue;
-            auto subRanges = splitRange(localRange, workerCount_);
-            workers.reserve(workers.size() + subRanges.size());
-            for (const auto& subRange : subRanges) {
-                workers.emplace_back([this, request, subRange, &checkpointCounter]() {
-                    executeLocalRange(request, subRange, checkpointCounter);
-                });
-            }
+        workers.reserve(workerCount_);
+        for (int i = 0; i < workerCount_; ++i) {
+            const QString workerId = kLocalWorkerPrefix + QString::number(i);
+            workers.emplace_back([this, request, workerId, &checkpointCounter]() {
+                executeLocalChunks(request, workerId, checkpointCounter);
+            });
         }
         for (auto& worker : workers) {
             if (worker.joinable()) {
@@ -963,7 +1044,13 @@ public:
 
         // Collect remote results before checkpoint so the checkpoint includes remote progress
         collectRemoteResults();
+        {
+            std::lock_guard<std::mutex> lock(remoteMutex_);
+            activeRequest_.reset();
+        }
         saveCheckpoint(request.range.startFrame);
+        if (journalEnabled() && !jobId.isEmpty())
+            checkpointStore_->closeJournal(jobId);
 
         if (!cancelled_ && totalProgress_.failed.load() == 0) {
             const QString outputError = validateOutputArtifact(request.outputPath, request.range);
@@ -1007,62 +1094,27 @@ public:
     }
 
     void collectRemoteResults() {
-        {
-            std::lock_guard<std::mutex> lock(remoteMutex_);
-            if (remoteSlices_.empty()) return;
-        }
-
-        int totalRemote = 0;
-        {
-            std::lock_guard<std::mutex> lock(remoteMutex_);
-            for (const auto& slice : remoteSlices_)
-                totalRemote += slice.range.count();
-        }
-        totalRemoteFrames_ = totalRemote;
-        remoteCompleted_ = 0;
-
-        const auto waitDuration = remainingJobTime();
-        const auto markUnreportedFrames = [this](const RemoteJobSlice& slice) {
-            for (int frame = slice.range.startFrame; frame < slice.range.endFrame;
-                 frame += slice.range.step) {
-                if (!slice.reportedFrames.contains(frame))
-                    markFrameFailed(frame);
-            }
-        };
+        // Local threads return once every frame is reported, or on cancel or
+        // deadline; only frames still out on remote workers are waited for.
         {
             std::unique_lock<std::mutex> waitLock(remoteWaitMutex_);
-            if (!remoteCv_.wait_for(waitLock,
-                    waitDuration,
-                    [this]() {
-                        return remoteCompleted_.load() >= totalRemoteFrames_ ||
-                               cancelled_.load();
-                    })) {
-                // Timeout: mark all incomplete as failures (skip already-reported)
-                std::lock_guard<std::mutex> lock(remoteMutex_);
-                for (auto& slice : remoteSlices_) {
-                    markUnreportedFrames(slice);
-                }
-                return;
-            }
+            remoteCv_.wait_for(waitLock, remainingJobTime(), [this]() {
+                return scheduler_.finished() || cancelled_.load();
+            });
         }
 
-        // Mark any uncompleted remote frames as failures.
-        // Frames already reported via onRemoteFrameResult_ are already counted
-        // in totalProgress_.completed, so we only charge the remainder.
-        int failCount = 0;
-        {
-            std::lock_guard<std::mutex> lock(remoteMutex_);
-            for (const auto& slice : remoteSlices_) {
-                int remaining = slice.range.count() - static_cast<int>(slice.reportedFrames.size());
-                if (remaining > 0) {
-                    markUnreportedFrames(slice);
-                    failCount += remaining;
-                }
+        // Charge whatever nobody reported as failures.
+        if (!cancelled_ || timedOut_) {
+            const auto unreported = scheduler_.unreportedFrames();
+            for (int frame : unreported)
+                markFrameFailed(frame);
+            if (!unreported.empty()) {
+                std::lock_guard<std::mutex> lock(resultMutex_);
+                finalResult_.errorMessage += QStringLiteral("; %1 frames were never reported")
+                    .arg(unreported.size());
             }
         }
-        if (failCount > 0) {
-            finalResult_.errorMessage += QStringLiteral("; %1 remote frames failed").arg(failCount);
-        }
+        scheduler_.clear();
     }
 };
 
@@ -1602,32 +1654,24 @@ bool RenderFarmMaster::startRpcServer(unsigned short port) {
     if (rpc.isRunning()) return true;
 
     // Handle worker registration
-    rpc.setOnWorkerConnected([this](const RemoteWorkerInfo&) {
-        // Remote worker registered - will be used on next job
+    rpc.setOnWorkerConnected([this](const RemoteWorkerInfo& worker) {
+        // Late joiners start pulling chunks from a job already running.
+        impl_->dispatchRemoteChunk(worker.workerId);
     });
 
     rpc.setOnWorkerDisconnected([this](const QString& workerId) {
-        // Unblock collectRemoteResults by accounting for remaining frames from the dead worker.
-        // collectRemoteResults will mark incomplete slices as failures.
-        int unreportedFrames = 0;
-        {
-            std::lock_guard<std::mutex> lock(impl_->remoteMutex_);
-            for (auto& slice : impl_->remoteSlices_) {
-                if (slice.workerId == workerId && !slice.completed) {
-                    int remaining = slice.range.count() - slice.framesCompleted_;
-                    if (remaining > 0)
-                        impl_->remoteCompleted_.fetch_add(remaining);
-                    unreportedFrames += std::max(0, remaining);
-                }
-            }
-        }
+        // The worker's unreported frames go back to the pool; remote workers
+        // and local threads pick them up instead of failing them.
+        const int requeuedFrames = impl_->scheduler_.releaseWorker(workerId);
+        if (requeuedFrames > 0)
+            impl_->dispatchRemoteChunks();
         impl_->remoteCv_.notify_all();
-        if (unreportedFrames > 0
+        if (requeuedFrames > 0
             && (impl_->alertCallback() || impl_->webhookConfigured())) {
             RenderJobResult alertResult;
             alertResult.success = false;
-            alertResult.failedFrames = unreportedFrames;
-            alertResult.errorMessage = QStringLiteral("Remote worker disconnected: %1").arg(workerId);
+            alertResult.errorMessage = QStringLiteral("Remote worker disconnected: %1 (%2 frames requeued)")
+                .arg(workerId).arg(requeuedFrames);
             {
                 std::lock_guard<std::mutex> lock(impl_->callbackMutex_);
                 impl_->lastAlertType_ = QStringLiteral("worker_disconnected");
@@ -1644,33 +1688,21 @@ bool RenderFarmMaster::startRpcServer(unsigned short port) {
 
     // Handle incoming RPC from workers: frameCompleted / frameFailed
     impl_->onRemoteFrameResult_ = [this](const QString& workerId, int frame, bool success) {
-        {
-            std::lock_guard<std::mutex> lock(impl_->remoteMutex_);
-            bool accepted = false;
-            for (auto& slice : impl_->remoteSlices_) {
-                if (slice.workerId == workerId &&
-                    frame >= slice.range.startFrame &&
-                    frame < slice.range.endFrame &&
-                    ((frame - slice.range.startFrame) % slice.range.step) == 0) {
-                    accepted = slice.reportedFrames.insert(frame).second;
-                    if (accepted) {
-                        ++slice.framesCompleted_;
-                        if (slice.framesCompleted_ >= slice.range.count())
-                            slice.completed = true;
-                    }
-                    break;
-                }
+        // The first report of a frame wins; late copies from a stolen or
+        // speculative chunk are dropped by the scheduler.
+        const FrameReportResult report = impl_->scheduler_.reportFrame(workerId, frame, success);
+        if (report.accepted) {
+            if (success) {
+                impl_->totalProgress_.completed.fetch_add(1);
+                impl_->journalFrameCompleted(frame);
+            } else {
+                impl_->markFrameFailed(frame);
             }
-            if (!accepted) return;
+            impl_->emitProgress();
         }
-        if (success) {
-            impl_->totalProgress_.completed.fetch_add(1);
-        } else {
-            impl_->markFrameFailed(frame);
-        }
-        impl_->remoteCompleted_.fetch_add(1);
-        impl_->emitProgress();
-        // Mark the slice that contains this frame as completed
+        impl_->flushChunkRevisions();
+        if (report.workerIdle)
+            impl_->dispatchRemoteChunk(workerId);
         impl_->remoteCv_.notify_all();
     };
 
@@ -1934,6 +1966,12 @@ bool RenderFarmMaster::startRpcServer(unsigned short port) {
                 impl_->onRemoteFrameResult_(workerId, frame, true);
             return {{"status", "ok"}};
         }
+        if (method == QStringLiteral("requestFrames")) {
+            const QString workerId = params["workerId"].toString();
+            if (!impl_->dispatchRemoteChunk(workerId))
+                return {{"status", "no_work"}};
+            return {{"status", "assigned"}};
+        }
         if (method == QStringLiteral("frameFailed")) {
             QString workerId = params["workerId"].toString();
             int frame = params["frame"].toInt(-1);
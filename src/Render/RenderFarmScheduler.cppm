@@ -0,0 +1,536 @@
+module;
+#include <utility>
+#include <memory>
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <mutex>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <cstdint>
+#include <QString>
+#include <QtGlobal>
+
+module Render.Farm.Scheduler;
+
+import Render.Farm.Types;
+
+namespace ArtifactCore {
+
+class RenderFrameScheduler::Impl {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Frame spans are kept as indices into the job range: [begin, end).
+    struct Span {
+        int begin = 0;
+        int end = 0;
+        int count() const { return std::max(0, end - begin); }
+        bool contains(int index) const { return index >= begin && index < end; }
+    };
+
+    struct Chunk {
+        int id = -1;
+        QString workerId;
+        Span span;
+        bool speculative = false;
+        int twin = -1;          // chunk covering the same frames speculatively
+        int unreported = 0;     // frames in span nobody has reported yet
+        int ownReports = 0;     // reports sent by the owner for frames in span
+        Clock::time_point lastProgress;
+    };
+
+    struct WorkerStats {
+        double frameMs = -1.0;  // EWMA of per-frame wall time
+        qint64 rttMs = 0;
+    };
+
+    static constexpr double kFrameMsSmoothing = 0.3;
+
+    mutable std::mutex mutex_;
+    FrameSchedulerPolicy policy_;
+    RenderFrameRange range_;
+    int total_ = 0;
+    int reportedCount_ = 0;
+    std::vector<std::uint8_t> reported_;
+    std::deque<Span> pool_;
+    std::map<int, Chunk> chunks_;
+    std::map<QString, WorkerStats> workers_;
+    std::set<QString> participants_;
+    std::vector<FrameChunkRevision> revisions_;
+    FrameSchedulerStats stats_;
+    double globalFrameMs_ = -1.0;
+    int nextChunkId_ = 0;
+
+    // Clears per-job state for range; reset() then marks resumed frames.
+    void begin(const RenderFrameRange& range);
+
+    int frameAt(int index) const {
+        const long long frame = static_cast<long long>(range_.startFrame)
+            + static_cast<long long>(index) * range_.step;
+        return static_cast<int>(std::min<long long>(frame, range_.endFrame));
+    }
+
+    int indexOf(int frame) const {
+        if (total_ <= 0 || frame < range_.startFrame || frame >= range_.endFrame) return -1;
+        const long long offset = static_cast<long long>(frame) - range_.startFrame;
+        if (offset % range_.step != 0) return -1;
+        const long long index = offset / range_.step;
+        return index < total_ ? static_cast<int>(index) : -1;
+    }
+
+    RenderFrameRange toRange(const Span& span) const {
+        return { frameAt(span.begin), frameAt(span.end), range_.step };
+    }
+
+    FrameChunk toPublic(const Chunk& chunk) const {
+        FrameChunk out;
+        out.id = chunk.id;
+        out.workerId = chunk.workerId;
+        out.range = toRange(chunk.span);
+        out.speculative = chunk.speculative;
+        return out;
+    }
+
+    int firstUnreported(const Span& span) const {
+        for (int i = span.begin; i < span.end; ++i) {
+            if (!reported_[static_cast<size_t>(i)]) return i;
+        }
+        return span.end;
+    }
+
+    int countUnreported(const Span& span) const {
+        int count = 0;
+        for (int i = span.begin; i < span.end; ++i) {
+            count += reported_[static_cast<size_t>(i)] ? 0 : 1;
+        }
+        return count;
+    }
+
+    int poolFrames() const {
+        int frames = 0;
+        for (const auto& span : pool_) frames += span.count();
+        return frames;
+    }
+
+    double frameMsFor(const QString& workerId) const {
+        const auto it = workers_.find(workerId);
+        if (it != workers_.end() && it->second.frameMs > 0.0) return it->second.frameMs;
+        return globalFrameMs_;
+    }
+
+    qint64 rttFor(const QString& workerId) const {
+        const auto it = workers_.find(workerId);
+        return it != workers_.end() ? it->second.rttMs : 0;
+    }
+
+    bool hasActiveChunk(const QString& workerId) const {
+        for (const auto& [id, chunk] : chunks_) {
+            if (chunk.workerId == workerId) return true;
+        }
+        return false;
+    }
+
+    int chunkSizeFor(const QString& workerId) const {
+        const int minFrames = std::max(1, policy_.minChunkFrames);
+        const int maxFrames = std::max(minFrames, policy_.maxChunkFrames);
+        const int workers = std::max<int>(1, static_cast<int>(participants_.size()));
+        const int available = poolFrames();
+
+        // Guided self-scheduling: never take more than a share of what is
+        // left, so the tail of the job is split finely across workers.
+        const int guided = std::max(minFrames,
+            static_cast<int>(std::ceil(available / (2.0 * workers))));
+
+        const double frameMs = frameMsFor(workerId);
+        int frames = 0;
+        if (frameMs <= 0.0) {
+            // No timing yet: small chunks so every worker gets measured early.
+            frames = std::max(minFrames, available / (4 * workers));
+        } else {
+            frames = static_cast<int>(policy_.targetChunkMs / frameMs);
+            const qint64 rttMs = rttFor(workerId);
+            if (rttMs > 0) {
+                frames = std::max(frames, static_cast<int>(
+                    std::ceil(rttMs * policy_.rttOverheadFactor / frameMs)));
+            }
+        }
+        return std::clamp(std::min(frames, guided), minFrames, maxFrames);
+    }
+
+    FrameChunk issue(const QString& workerId, const Span& span, bool speculative, int twin = -1) {
+        Chunk chunk;
+        chunk.id = nextChunkId_++;
+        chunk.workerId = workerId;
+        chunk.span = span;
+        chunk.speculative = speculative;
+        chunk.twin = twin;
+        chunk.unreported = countUnreported(span);
+        chunk.lastProgress = Clock::now();
+        if (twin >= 0) {
+            auto it = chunks_.find(twin);
+            if (it != chunks_.end()) it->second.twin = chunk.id;
+        }
+        chunks_[chunk.id] = chunk;
+        ++stats_.chunksIssued;
+        if (speculative) ++stats_.speculativeChunks;
+        return toPublic(chunk);
+    }
+
+    FrameChunk takeFromPool(const QString& workerId) {
+        const int size = chunkSizeFor(workerId);
+        while (!pool_.empty()) {
+            Span& head = pool_.front();
+            // Requeued spans may start with frames reported since.
+            while (head.begin < head.end && reported_[static_cast<size_t>(head.begin)])
+                ++head.begin;
+            if (head.count() <= 0) {
+                pool_.pop_front();
+                continue;
+            }
+            const Span span{ head.begin, std::min(head.end, head.begin + size) };
+            head.begin = span.end;
+            if (head.count() <= 0) pool_.pop_front();
+            return issue(workerId, span, false);
+        }
+        return {};
+    }
+
+    FrameChunk stealTail(const QString& workerId) {
+        const qint64 rttMs = rttFor(workerId);
+        const double thiefMs = frameMsFor(workerId);
+        Chunk* victim = nullptr;
+        double victimRemainingMs = 0.0;
+        int victimStolen = 0;
+
+        for (auto& [id, chunk] : chunks_) {
+            if (chunk.workerId == workerId || chunk.speculative || chunk.twin >= 0) continue;
+            // Leave the frame the owner is rendering right now.
+            const int inFlight = firstUnreported(chunk.span);
+            const int tail = chunk.span.end - (inFlight + 1);
+            const int stolen = static_cast<int>(tail * policy_.stealFraction);
+            if (stolen < std::max(1, policy_.minStealFrames)) continue;
+
+            double ownerMs = frameMsFor(chunk.workerId);
+            if (ownerMs <= 0.0) ownerMs = 1.0;
+            const double remainingMs = (tail + 1) * ownerMs;
+            const double thiefFinishMs = stolen * (thiefMs > 0.0 ? thiefMs : ownerMs)
+                + static_cast<double>(rttMs);
+            if (thiefFinishMs >= remainingMs) continue;
+            if (!victim || remainingMs > victimRemainingMs) {
+                victim = &chunk;
+                victimRemainingMs = remainingMs;
+                victimStolen = stolen;
+            }
+        }
+        if (!victim) return {};
+
+        const Span stolenSpan{ victim->span.end - victimStolen, victim->span.end };
+        victim->span.end = stolenSpan.begin;
+        victim->unreported = countUnreported(victim->span);
+
+        FrameChunkRevision revision;
+        revision.chunkId = victim->id;
+        revision.workerId = victim->workerId;
+        revision.range = toRange(victim->span);
+        revision.withdrawnFrames = stolenSpan.count();
+        revisions_.push_back(revision);
+        ++stats_.steals;
+        return issue(workerId, stolenSpan, false);
+    }
+
+    FrameChunk speculate(const QString& workerId) {
+        const int remaining = total_ - reportedCount_;
+        const int tailFrames = std::max(1, static_cast<int>(
+            std::ceil(total_ * policy_.speculativeTailFraction)));
+        if (remaining <= 0 || remaining > tailFrames) return {};
+
+        const auto now = Clock::now();
+        Chunk* straggler = nullptr;
+        double worstRatio = 0.0;
+        for (auto& [id, chunk] : chunks_) {
+            if (chunk.workerId == workerId || chunk.speculative || chunk.twin >= 0
+                || chunk.unreported <= 0) continue;
+            const double expectedMs = frameMsFor(chunk.workerId);
+            if (expectedMs <= 0.0) continue;
+            const double stalledMs = std::chrono::duration<double, std::milli>(
+                now - chunk.lastProgress).count();
+            const double ratio = stalledMs / expectedMs;
+            if (ratio > policy_.stragglerFactor && ratio > worstRatio) {
+                straggler = &chunk;
+                worstRatio = ratio;
+            }
+        }
+        if (!straggler) return {};
+
+        const Span span{ firstUnreported(straggler->span), straggler->span.end };
+        return issue(workerId, span, true, straggler->id);
+    }
+
+    void recordTiming(Chunk& chunk, Clock::time_point now) {
+        const double elapsedMs = std::chrono::duration<double, std::milli>(
+            now - chunk.lastProgress).count();
+        chunk.lastProgress = now;
+        auto& worker = workers_[chunk.workerId];
+        worker.frameMs = worker.frameMs > 0.0
+            ? worker.frameMs + (elapsedMs - worker.frameMs) * kFrameMsSmoothing
+            : elapsedMs;
+        globalFrameMs_ = globalFrameMs_ > 0.0
+            ? globalFrameMs_ + (elapsedMs - globalFrameMs_) * kFrameMsSmoothing
+            : elapsedMs;
+    }
+
+    // Drops chunks every frame of which has been reported. An owner that did
+    // not render all of them itself (its twin won) is told to stop.
+    void retireFinishedChunks() {
+        for (auto it = chunks_.begin(); it != chunks_.end();) {
+            const Chunk& chunk = it->second;
+            if (chunk.unreported > 0) {
+                ++it;
+                continue;
+            }
+            if (chunk.ownReports < chunk.span.count()) {
+                FrameChunkRevision revision;
+                revision.chunkId = chunk.id;
+                revision.workerId = chunk.workerId;
+                revision.range = toRange(Span{ chunk.span.begin, chunk.span.begin });
+                revision.withdrawnFrames = chunk.span.count() - chunk.ownReports;
+                revisions_.push_back(revision);
+            }
+            if (chunk.twin >= 0) {
+                auto twin = chunks_.find(chunk.twin);
+                if (twin != chunks_.end()) twin->second.twin = -1;
+            }
+            it = chunks_.erase(it);
+        }
+    }
+};
+
+RenderFrameScheduler::RenderFrameScheduler()
+    : impl_(std::make_unique<Impl>()) {}
+
+RenderFrameScheduler::~RenderFrameScheduler() = default;
+
+void RenderFrameScheduler::setPolicy(const FrameSchedulerPolicy& policy) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    impl_->policy_ = policy;
+    impl_->policy_.minChunkFrames = std::max(1, policy.minChunkFrames);
+    impl_->policy_.maxChunkFrames = std::max(impl_->policy_.minChunkFrames, policy.maxChunkFrames);
+    impl_->policy_.targetChunkMs = std::max<qint64>(1, policy.targetChunkMs);
+    impl_->policy_.stealFraction = std::clamp(policy.stealFraction, 0.0, 1.0);
+    impl_->policy_.speculativeTailFraction = std::clamp(policy.speculativeTailFraction, 0.0, 1.0);
+}
+
+FrameSchedulerPolicy RenderFrameScheduler::policy() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->policy_;
+}
+
+void RenderFrameScheduler::reset(const RenderFrameRange& range, int resumeFrom) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto& d = *impl_;
+    d.begin(range);
+
+    int first = 0;
+    if (resumeFrom > d.range_.startFrame) {
+        const long long done = (static_cast<long long>(resumeFrom) - d.range_.startFrame
+                                + d.range_.step - 1) / d.range_.step;
+        first = static_cast<int>(std::min<long long>(done, d.total_));
+    }
+    for (int i = 0; i < first; ++i) d.reported_[static_cast<size_t>(i)] = 1;
+    d.reportedCount_ = first;
+    if (first < d.total_) d.pool_.push_back({ first, d.total_ });
+}
+
+void RenderFrameScheduler::reset(const RenderFrameRange& range, const std::vector<std::uint8_t>& done) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto& d = *impl_;
+    d.begin(range);
+
+    // Every gap between completed frames becomes a pool span.
+    int spanBegin = -1;
+    for (int i = 0; i < d.total_; ++i) {
+        const bool isDone = static_cast<size_t>(i) < done.size() && done[static_cast<size_t>(i)];
+        if (isDone) {
+            d.reported_[static_cast<size_t>(i)] = 1;
+            ++d.reportedCount_;
+            if (spanBegin >= 0) d.pool_.push_back({ spanBegin, i });
+            spanBegin = -1;
+        } else if (spanBegin < 0) {
+            spanBegin = i;
+        }
+    }
+    if (spanBegin >= 0) d.pool_.push_back({ spanBegin, d.total_ });
+}
+
+void RenderFrameScheduler::Impl::begin(const RenderFrameRange& range) {
+    auto& d = *this;
+    d.range_ = range;
+    d.range_.step = std::max(1, range.step);
+    d.total_ = d.range_.count();
+    d.reported_.assign(static_cast<size_t>(d.total_), 0);
+    d.reportedCount_ = 0;
+    d.pool_.clear();
+    d.chunks_.clear();
+    d.participants_.clear();
+    d.revisions_.clear();
+    d.stats_ = {};
+    d.nextChunkId_ = 0;
+    // Worker timings carry over between jobs; the global estimate does not.
+    d.globalFrameMs_ = -1.0;
+}
+
+void RenderFrameScheduler::clear() {
+    reset({}, std::numeric_limits<int>::min());
+}
+
+FrameChunk RenderFrameScheduler::requestChunk(const QString& workerId, qint64 rttMs) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto& d = *impl_;
+    if (d.total_ <= 0 || d.reportedCount_ >= d.total_ || workerId.isEmpty()) return {};
+    d.participants_.insert(workerId);
+    if (rttMs > 0) d.workers_[workerId].rttMs = rttMs;
+
+    FrameChunk chunk = d.takeFromPool(workerId);
+    if (!chunk.isValid()) chunk = d.stealTail(workerId);
+    if (!chunk.isValid()) chunk = d.speculate(workerId);
+    return chunk;
+}
+
+bool RenderFrameScheduler::shouldRender(int chunkId, int frame) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    const int index = impl_->indexOf(frame);
+    if (index < 0) return false;
+    const auto it = impl_->chunks_.find(chunkId);
+    if (it == impl_->chunks_.end() || !it->second.span.contains(index)) return false;
+    return !impl_->reported_[static_cast<size_t>(index)];
+}
+
+FrameReportResult RenderFrameScheduler::reportFrame(const QString& workerId, int frame, bool success) {
+    (void)success;  // first report wins either way; failures are retried by the worker
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto& d = *impl_;
+    FrameReportResult result;
+    const int index = d.indexOf(frame);
+    if (index < 0 || !d.participants_.contains(workerId)) return result;
+
+    const auto now = Impl::Clock::now();
+    for (auto& [id, chunk] : d.chunks_) {
+        if (chunk.workerId == workerId && chunk.span.contains(index)) {
+            ++chunk.ownReports;
+            d.recordTiming(chunk, now);
+            break;
+        }
+    }
+
+    if (d.reported_[static_cast<size_t>(index)]) {
+        ++d.stats_.duplicateReports;
+    } else {
+        d.reported_[static_cast<size_t>(index)] = 1;
+        ++d.reportedCount_;
+        result.accepted = true;
+        for (auto& [id, chunk] : d.chunks_) {
+            if (chunk.span.contains(index)) --chunk.unreported;
+        }
+        d.retireFinishedChunks();
+    }
+    result.workerIdle = !d.hasActiveChunk(workerId);
+    return result;
+}
+
+int RenderFrameScheduler::releaseWorker(const QString& workerId) {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    auto& d = *impl_;
+    int released = 0;
+    for (auto it = d.chunks_.begin(); it != d.chunks_.end();) {
+        Impl::Chunk& chunk = it->second;
+        if (chunk.workerId != workerId) {
+            ++it;
+            continue;
+        }
+        auto twin = chunk.twin >= 0 ? d.chunks_.find(chunk.twin) : d.chunks_.end();
+        if (twin != d.chunks_.end()) {
+            // The other copy keeps going on its own.
+            twin->second.twin = -1;
+        } else {
+            const Impl::Span tail{ d.firstUnreported(chunk.span), chunk.span.end };
+            const int frames = d.countUnreported(tail);
+            if (frames > 0) {
+                d.pool_.push_front(tail);
+                released += frames;
+            }
+        }
+        it = d.chunks_.erase(it);
+    }
+    d.participants_.erase(workerId);
+    d.stats_.framesRequeued += released;
+    return released;
+}
+
+std::vector<FrameChunkRevision> RenderFrameScheduler::takeRevisions() {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    std::vector<FrameChunkRevision> out;
+    out.swap(impl_->revisions_);
+    return out;
+}
+
+bool RenderFrameScheduler::hasWork() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    for (const auto& span : impl_->pool_) {
+        if (impl_->countUnreported(span) > 0) return true;
+    }
+    return false;
+}
+
+bool RenderFrameScheduler::finished() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->reportedCount_ >= impl_->total_;
+}
+
+bool RenderFrameScheduler::isParticipant(const QString& workerId) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->participants_.contains(workerId);
+}
+
+bool RenderFrameScheduler::hasActiveChunk(const QString& workerId) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->hasActiveChunk(workerId);
+}
+
+int RenderFrameScheduler::remainingFrames() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->total_ - impl_->reportedCount_;
+}
+
+std::vector<int> RenderFrameScheduler::unreportedFrames() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    std::vector<int> frames;
+    for (int i = 0; i < impl_->total_; ++i) {
+        if (!impl_->reported_[static_cast<size_t>(i)]) frames.push_back(impl_->frameAt(i));
+    }
+    return frames;
+}
+
+std::vector<FrameChunk> RenderFrameScheduler::activeChunks() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    std::vector<FrameChunk> out;
+    out.reserve(impl_->chunks_.size());
+    for (const auto& [id, chunk] : impl_->chunks_) out.push_back(impl_->toPublic(chunk));
+    return out;
+}
+
+double RenderFrameScheduler::averageFrameMs(const QString& workerId) const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    const auto it = impl_->workers_.find(workerId);
+    return it != impl_->workers_.end() ? it->second.frameMs : -1.0;
+}
+
+FrameSchedulerStats RenderFrameScheduler::stats() const {
+    std::lock_guard<std::mutex> lock(impl_->mutex_);
+    return impl_->stats_;
+}
+
+}
@@ -0,0 +1,1518 @@
+module;
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+module Script.Expression.Bytecode;
+
+import Memory.SharedPtr;
+import Script.Expression.Value;
+import Script.Expression.Parser;
+import Math.Noise;
+
+namespace ArtifactCore {
+
+// ============================================================
+// ExprVmValue
+// ============================================================
+
+ExprVmValue ExprVmValue::null() {
+  return ExprVmValue{};
+}
+
+ExprVmValue ExprVmValue::number(double value) {
+  ExprVmValue out;
+  out.type = ExprValueType::Number;
+  out.v[0] = value;
+  return out;
+}
+
+ExprVmValue ExprVmValue::vector(const double* components, int count) {
+  ExprVmValue out;
+  switch (count) {
+  case 2: out.type = ExprValueType::Vec2; break;
+  case 3: out.type = ExprValueType::Vec3; break;
+  case 4: out.type = ExprValueType::Vec4; break;
+  default: return out;
+  }
+  for (int i = 0; i < count; ++i) out.v[i] = components[i];
+  return out;
+}
+
+int ExprVmValue::dimension() const {
+  switch (type) {
+  case ExprValueType::Number: return 1;
+  case ExprValueType::Vec2: return 2;
+  case ExprValueType::Vec3: return 3;
+  case ExprValueType::Vec4: return 4;
+  default: return 0;
+  }
+}
+
+double ExprVmValue::asNumber() const {
+  return (isNumber() || isVector()) ? v[0] : 0.0;
+}
+
+bool toVmValue(const ExpressionValue& value, ExprVmValue& out) {
+  switch (value.type()) {
+  case ExprValueType::Null:
+    out = ExprVmValue::null();
+    return true;
+  case ExprValueType::Number:
+    out = ExprVmValue::number(value.asNumber());
+    return true;
+  case ExprValueType::Vec2:
+  case ExprValueType::Vec3:
+  case ExprValueType::Vec4: {
+    const double components[4] = {value.x(), value.y(), value.z(), value.w()};
+    const int count = value.type() == ExprValueType::Vec2 ? 2
+                    : value.type() == ExprValueType::Vec3 ? 3 : 4;
+    out = ExprVmValue::vector(components, count);
+    return true;
+  }
+  default:
+    return false;
+  }
+}
+
+ExpressionValue fromVmValue(const ExprVmValue& value) {
+  switch (value.type) {
+  case ExprValueType::Number: return ExpressionValue(value.v[0]);
+  case ExprValueType::Vec2: return ExpressionValue(value.v[0], value.v[1]);
+  case ExprValueType::Vec3: return ExpressionValue(value.v[0], value.v[1], value.v[2]);
+  case ExprValueType::Vec4:
+    return ExpressionValue(value.v[0], value.v[1], value.v[2], value.v[3]);
+  default: return ExpressionValue();
+  }
+}
+
+int ExpressionProgram::findSlot(const std::string& name) const {
+  for (size_t i = 0; i < slots_.size(); ++i) {
+    if (slots_[i].name == name) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+// ============================================================
+// Compiler
+// ============================================================
+
+namespace {
+
+struct BuiltinEntry {
+  ExprBuiltinId id;
+  bool readsTime;
+};
+
+const std::unordered_map<std::string, BuiltinEntry>& builtinTable() {
+  static const std::unordered_map<std::string, BuiltinEntry> table = {
+      {"sin", {ExprBuiltinId::Sin, false}},
+      {"cos", {ExprBuiltinId::Cos, false}},
+      {"tan", {ExprBuiltinId::Tan, false}},
+      {"degToRad", {ExprBuiltinId::DegToRad, false}},
+      {"radToDeg", {ExprBuiltinId::RadToDeg, false}},
+      {"sqrt", {ExprBuiltinId::Sqrt, false}},
+      {"pow", {ExprBuiltinId::Pow, false}},
+      {"abs", {ExprBuiltinId::Abs, false}},
+      {"floor", {ExprBuiltinId::Floor, false}},
+      {"ceil", {ExprBuiltinId::Ceil, false}},
+      {"round", {ExprBuiltinId::Round, false}},
+      {"min", {ExprBuiltinId::Min, false}},
+      {"max", {ExprBuiltinId::Max, false}},
+      {"clamp", {ExprBuiltinId::Clamp, false}},
+      {"length", {ExprBuiltinId::Length, false}},
+      {"distance", {ExprBuiltinId::Distance, false}},
+      {"normalize", {ExprBuiltinId::Normalize, false}},
+      {"dot", {ExprBuiltinId::Dot, false}},
+      {"cross", {ExprBuiltinId::Cross, false}},
+      {"linear", {ExprBuiltinId::Linear, false}},
+      {"ease", {ExprBuiltinId::Ease, false}},
+      {"easeIn", {ExprBuiltinId::EaseIn, false}},
+      {"easeOut", {ExprBuiltinId::EaseOut, false}},
+      {"noise", {ExprBuiltinId::Noise, false}},
+      {"wiggle", {ExprBuiltinId::Wiggle, true}},
+      {"sum", {ExprBuiltinId::Sum, false}},
+      {"average", {ExprBuiltinId::Average, false}},
+  };
+  return table;
+}
+
+bool binaryOpCode(const std::string& op, ExprOpCode& out) {
+  if (op == "+") { out = ExprOpCode::Add; return true; }
+  if (op == "-") { out = ExprOpCode::Sub; return true; }
+  if (op == "*") { out = ExprOpCode::Mul; return true; }
+  if (op == "/") { out = ExprOpCode::Div; return true; }
+  if (op == "**") { out = ExprOpCode::Pow; return true; }
+  if (op == "//") { out = ExprOpCode::FloorDiv; return true; }
+  if (op == "==") { out = ExprOpCode::Equal; return true; }
+  if (op == "!=") { out = ExprOpCode::NotEqual; return true; }
+  if (op == "<") { out = ExprOpCode::Less; return true; }
+  if (op == "<=") { out = ExprOpCode::LessEqual; return true; }
+  if (op == ">") { out = ExprOpCode::Greater; return true; }
+  if (op == ">=") { out = ExprOpCode::GreaterEqual; return true; }
+  if (op == "&&" || op == "and") { out = ExprOpCode::LogicalAnd; return true; }
+  if (op == "||" || op == "or") { out = ExprOpCode::LogicalOr; return true; }
+  return false;
+}
+
+// FNV-1a over the raw bytes of trivially copyable values
+class Fingerprint {
+public:
+  template<typename T>
+  void add(const T& value) {
+    const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+    for (size_t i = 0; i < sizeof(T); ++i) {
+      hash_ = (hash_ ^ bytes[i]) * 1099511628211ull;
+    }
+  }
+
+  void add(const std::string& text) {
+    add(text.size());
+    for (const char c : text) add(c);
+  }
+
+  std::uint64_t value() const { return hash_; }
+
+private:
+  std::uint64_t hash_ = 14695981039346656037ull;
+};
+
+int componentIndex(const std::string& prop) {
+  if (prop == "x" || prop == "r") return 0;
+  if (prop == "y" || prop == "g") return 1;
+  if (prop == "z" || prop == "b") return 2;
+  if (prop == "w" || prop == "a") return 3;
+  return -1;
+}
+
+}
+
+class ExpressionCompiler::Impl {
+public:
+  std::unordered_set<std::string> excludedFunctions_;
+  std::string error_;
+
+  ExpressionProgram* program_ = nullptr;
+  int stackDepth_ = 0;
+
+  void emit(ExprOpCode op, std::int32_t operand = 0, int count = 0, int stackDelta = 0) {
+    program_->code_.push_back(ExprInstruction{op, static_cast<std::uint8_t>(count), operand});
+    stackDepth_ += stackDelta;
+    program_->maxStackDepth_ = std::max(program_->maxStackDepth_, stackDepth_);
+  }
+
+  int slotFor(const std::string& name, bool optional) {
+    const int existing = program_->findSlot(name);
+    if (existing >= 0) {
+      // A slot referenced explicitly must exist; keep the stricter binding.
+      if (!optional) program_->slots_[static_cast<size_t>(existing)].optional = false;
+      return existing;
+    }
+    program_->slots_.push_back(ExprSlot{name, optional});
+    return static_cast<int>(program_->slots_.size() - 1);
+  }
+
+  bool fail(const std::string& message) {
+    error_ = message;
+    return false;
+  }
+
+  bool compileNode(const SharedPtr<ExprNode>& node, int depth) {
+    if (!node) return fail("Null AST node");
+    ++program_->nodeCount_;
+    program_->treeDepth_ = std::max(program_->treeDepth_, depth);
+
+    switch (node->type()) {
+    case ExprNodeType::Number: {
+      program_->constants_.push_back(ExprVmValue::number(node->numberValue()));
+      emit(ExprOpCode::PushConst, static_cast<std::int32_t>(program_->constants_.size() - 1), 0, 1);
+      return true;
+    }
+
+    case ExprNodeType::Variable:
+      emit(ExprOpCode::LoadSlot, slotFor(node->stringValue(), false), 0, 1);
+      return true;
+
+    case ExprNodeType::Vector: {
+      const size_t count = node->childCount();
+      if (count < 2 || count > 4) return fail("Unsupported vector arity");
+      for (size_t i = 0; i < count; ++i) {
+        if (!compileNode(node->child(i), depth + 1)) return false;
+      }
+      emit(ExprOpCode::MakeVector, 0, static_cast<int>(count), 1 - static_cast<int>(count));
+      return true;
+    }
+
+    case ExprNodeType::ArrayAccess: {
+      if (node->childCount() < 2) return fail("Invalid array access");
+      if (!compileNode(node->child(0), depth + 1)) return false;
+      if (!compileNode(node->child(1), depth + 1)) return false;
+      emit(ExprOpCode::Index, 0, 0, -1);
+      return true;
+    }
+
+    case ExprNodeType::PropertyAccess: {
+      if (node->childCount() < 1) return fail("Invalid property access");
+      const int component = componentIndex(node->stringValue());
+      if (component < 0) return fail("Property access is not a vector component");
+      if (!compileNode(node->child(0), depth + 1)) return false;
+      emit(ExprOpCode::Component, component);
+      return true;
+    }
+
+    case ExprNodeType::BinaryOp: {
+      if (node->childCount() < 2) return fail("Binary operator requires two operands");
+      ExprOpCode op;
+      if (!binaryOpCode(node->operatorSymbol(), op)) return fail("Unknown binary operator");
+      if (!compileNode(node->child(0), depth + 1)) return false;
+      if (!compileNode(node->child(1), depth + 1)) return false;
+      emit(op, 0, 0, -1);
+      return true;
+    }
+
+    case ExprNodeType::UnaryOp: {
+      if (node->childCount() == 0) return fail("Unary operator requires one operand");
+      const auto op = node->operatorSymbol();
+      ExprOpCode code;
+      if (op == "-") code = ExprOpCode::Negate;
+      else if (op == "!" || op == "not") code = ExprOpCode::LogicalNot;
+      else return fail("Unknown unary operator");
+      if (!compileNode(node->child(0), depth + 1)) return false;
+      emit(code);
+      return true;
+    }
+
+    case ExprNodeType::FunctionCall: {
+      const auto name = node->stringValue();
+      if (excludedFunctions_.count(name) != 0) return fail("Function is host-defined: " + name);
+      const auto& table = builtinTable();
+      const auto it = table.find(name);
+      if (it == table.end()) return fail("Function has no native implementation: " + name);
+
+      const int argc = static_cast<int>(node->childCount());
+      for (int i = 0; i < argc; ++i) {
+        if (!compileNode(node->child(static_cast<size_t>(i)), depth + 1)) return false;
+      }
+      int callArgc = argc;
+      if (it->second.readsTime) {
+        emit(ExprOpCode::LoadSlot, slotFor("time", true), 0, 1);
+        ++callArgc;
+      }
+      if (callArgc > 255) return fail("Too many arguments");
+      emit(ExprOpCode::CallBuiltin, static_cast<std::int32_t>(it->second.id), callArgc,
+           1 - callArgc);
+      return true;
+    }
+
+    case ExprNodeType::Conditional: {
+      if (node->childCount() < 3) return fail("Ternary operator requires three operands");
+      if (!compileNode(node->child(0), depth + 1)) return false;
+      const size_t jumpToElse = program_->code_.size();
+      emit(ExprOpCode::JumpIfFalse, 0, 0, -1);
+      if (!compileNode(node->child(1), depth + 1)) return false;
+      const size_t jumpToEnd = program_->code_.size();
+      emit(ExprOpCode::Jump);
+      // Only one branch leaves a value on the stack at run time.
+      stackDepth_ -= 1;
+      program_->code_[jumpToElse].operand = static_cast<std::int32_t>(program_->code_.size());
+      if (!compileNode(node->child(2), depth + 1)) return false;
+      program_->code_[jumpToEnd].operand = static_cast<std::int32_t>(program_->code_.size());
+      return true;
+    }
+
+    default:
+      return fail("Node type is not supported by the bytecode VM");
+    }
+  }
+};
+
+ExpressionCompiler::ExpressionCompiler() : impl_(new Impl()) {}
+
+ExpressionCompiler::~ExpressionCompiler() { delete impl_; }
+
+void ExpressionCompiler::setExcludedFunctions(const std::vector<std::string>& names) {
+  impl_->excludedFunctions_ = std::unordered_set<std::string>(names.begin(), names.end());
+}
+
+SharedPtr<ExpressionProgram> ExpressionCompiler::compile(const SharedPtr<ExprNode>& root) {
+  impl_->error_.clear();
+  auto program = makeShared<ExpressionProgram>();
+  impl_->program_ = program.get();
+  impl_->stackDepth_ = 0;
+
+  const bool ok = impl_->compileNode(root, 1);
+  impl_->program_ = nullptr;
+  if (!ok) return nullptr;
+
+  program->code_.push_back(ExprInstruction{ExprOpCode::Return, 0, 0});
+  if (program->maxStackDepth_ > ExpressionVM::kMaxStackDepth) {
+    impl_->error_ = "Expression exceeds VM stack depth";
+    return nullptr;
+  }
+
+  for (const auto& ins : program->code_) {
+    int cost = 1;
+    if (ins.op == ExprOpCode::CallBuiltin) {
+      const auto id = static_cast<ExprBuiltinId>(ins.operand);
+      cost = id == ExprBuiltinId::Wiggle ? 64 : id == ExprBuiltinId::Noise ? 16 : 4;
+    }
+    program->estimatedCost_ += cost;
+  }
+
+  Fingerprint fingerprint;
+  for (const auto& ins : program->code_) {
+    fingerprint.add(ins.op);
+    fingerprint.add(ins.count);
+    fingerprint.add(ins.operand);
+  }
+  for (const auto& constant : program->constants_) {
+    fingerprint.add(constant.type);
+    for (const double component : constant.v) fingerprint.add(component);
+  }
+  for (const auto& slot : program->slots_) {
+    fingerprint.add(slot.name);
+    fingerprint.add(slot.optional);
+  }
+  program->fingerprint_ = fingerprint.value();
+  return program;
+}
+
+std::string ExpressionCompiler::getError() const { return impl_->error_; }
+
+// ============================================================
+// VM
+// ============================================================
+
+namespace {
+
+ExprVmValue vmVector(const double* components, int count) {
+  return ExprVmValue::vector(components, count);
+}
+
+// Mirrors ExpressionValue's arithmetic operators exactly, including the
+// Null results for unsupported operand combinations.
+ExprVmValue vmAdd(const ExprVmValue& a, const ExprVmValue& b, double sign) {
+  if (a.isNumber() && b.isNumber()) return ExprVmValue::number(a.v[0] + sign * b.v[0]);
+  if (a.isVector() && b.isVector()) {
+    const int size = std::min(a.dimension(), b.dimension());
+    double out[4];
+    for (int i = 0; i < size; ++i) out[i] = a.v[i] + sign * b.v[i];
+    return vmVector(out, size);
+  }
+  return ExprVmValue::null();
+}
+
+ExprVmValue vmMul(const ExprVmValue& a, const ExprVmValue& b) {
+  if (a.isNumber() && b.isNumber()) return ExprVmValue::number(a.v[0] * b.v[0]);
+  if (a.isNumber() && b.isVector()) {
+    double out[4];
+    for (int i = 0; i < b.dimension(); ++i) out[i] = b.v[i] * a.v[0];
+    return vmVector(out, b.dimension());
+  }
+  if (a.isVector() && b.isNumber()) {
+    double out[4];
+    for (int i = 0; i < a.dimension(); ++i) out[i] = a.v[i] * b.v[0];
+    return vmVector(out, a.dimension());
+  }
+  if (a.isVector() && b.isVector()) {
+    const int size = std::min(a.dimension(), b.dimension());
+    double out[4];
+    for (int i = 0; i < size; ++i) out[i] = a.v[i] * b.v[i];
+    return vmVector(out, size);
+  }
+  return ExprVmValue::null();
+}
+
+ExprVmValue vmDiv(const ExprVmValue& a, const ExprVmValue& b) {
+  if (a.isNumber() && b.isNumber() && b.v[0] != 0.0) {
+    return ExprVmValue::number(a.v[0] / b.v[0]);
+  }
+  if (a.isVector() && b.isNumber() && b.v[0] != 0.0) {
+    double out[4];
+    for (int i = 0; i < a.dimension(); ++i) out[i] = a.v[i] / b.v[0];
+    return vmVector(out, a.dimension());
+  }
+  return ExprVmValue::null();
+}
+
+bool vmEqual(const ExprVmValue& a, const ExprVmValue& b) {
+  if (a.type != b.type) return false;
+  if (a.isNumber()) return a.v[0] == b.v[0];
+  if (a.isVector()) {
+    for (int i = 0; i < a.dimension(); ++i) {
+      if (a.v[i] != b.v[i]) return false;
+    }
+    return true;
+  }
+  return false;
+}
+
+bool vmLess(const ExprVmValue& a, const ExprVmValue& b) {
+  return a.isNumber() && b.isNumber() && a.v[0] < b.v[0];
+}
+
+ExprVmValue vmBool(bool value) {
+  return ExprVmValue::number(value ? 1.0 : 0.0);
+}
+
+double vmEaseCurve(double t) {
+  t = std::clamp(t, 0.0, 1.0);
+  return t * t * (3.0 - 2.0 * t);
+}
+
+double vmEaseInCurve(double t) {
+  t = std::clamp(t, 0.0, 1.0);
+  return t * t;
+}
+
+double vmEaseOutCurve(double t) {
+  t = std::clamp(t, 0.0, 1.0);
+  return 1.0 - (1.0 - t) * (1.0 - t);
+}
+
+ExprVmValue vmInterpolate(const ExprVmValue& from, const ExprVmValue& to, double t) {
+  if (from.isVector() && to.isVector()) {
+    const int size = std::min(from.dimension(), to.dimension());
+    double out[4];
+    for (int i = 0; i < size; ++i) out[i] = from.v[i] + t * (to.v[i] - from.v[i]);
+    return vmVector(out, size);
+  }
+  const double a = from.asNumber();
+  const double b = to.asNumber();
+  return ExprVmValue::number(a + t * (b - a));
+}
+
+template<typename Curve>
+ExprVmValue vmInterpolateBuiltin(const ExprVmValue* args, int argc, Curve curve, bool clampLinear) {
+  if (argc == 3) {
+    return vmInterpolate(args[1], args[2], curve(args[0].asNumber()));
+  }
+  if (argc >= 5) {
+    const double t = args[0].asNumber();
+    const double tMin = args[1].asNumber();
+    const double tMax = args[2].asNumber();
+    const double range = tMax - tMin;
+    if (std::abs(range) < 1e-12) return args[3];
+    const double raw = (t - tMin) / range;
+    const double alpha = clampLinear ? std::clamp(raw, 0.0, 1.0) : curve(raw);
+    return vmInterpolate(args[3], args[4], alpha);
+  }
+  return ExprVmValue::null();
+}
+
+// ExpressionValue::asVector(): vector components, or {n} for numbers.
+int vmAsVector(const ExprVmValue& value, double out[4]) {
+  if (value.isVector()) {
+    for (int i = 0; i < value.dimension(); ++i) out[i] = value.v[i];
+    return value.dimension();
+  }
+  if (value.isNumber()) {
+    out[0] = value.v[0];
+    return 1;
+  }
+  return 0;
+}
+
+}
+
+ExprVmValue ExpressionVM::callBuiltin(ExprBuiltinId id, const ExprVmValue* args, int argc) {
+  auto unary = [&](double (*fn)(double)) {
+    if (argc < 1) return ExprVmValue::null();
+    return ExprVmValue::number(fn(args[0].asNumber()));
+  };
+
+  switch (id) {
+  case ExprBuiltinId::Sin: return unary([](double x) { return std::sin(x); });
+  case ExprBuiltinId::Cos: return unary([](double x) { return std::cos(x); });
+  case ExprBuiltinId::Tan: return unary([](double x) { return std::tan(x); });
+  case ExprBuiltinId::DegToRad:
+    return unary([](double x) { return x * (std::acos(-1.0) / 180.0); });
+  case ExprBuiltinId::RadToDeg:
+    return unary([](double x) { return x * (180.0 / std::acos(-1.0)); });
+  case ExprBuiltinId::Sqrt: return unary([](double x) { return std::sqrt(x); });
+  case ExprBuiltinId::Abs: return unary([](double x) { return std::abs(x); });
+  case ExprBuiltinId::Floor: return unary([](double x) { return std::floor(x); });
+  case ExprBuiltinId::Ceil: return unary([](double x) { return std::ceil(x); });
+  case ExprBuiltinId::Round: return unary([](double x) { return std::round(x); });
+
+  case ExprBuiltinId::Pow:
+    if (argc < 2) return ExprVmValue::null();
+    return ExprVmValue::number(std::pow(args[0].asNumber(), args[1].asNumber()));
+
+  case ExprBuiltinId::Min:
+  case ExprBuiltinId::Max: {
+    if (argc < 1) return ExprVmValue::null();
+    double m = args[0].asNumber();
+    for (int i = 1; i < argc; ++i) {
+      m = id == ExprBuiltinId::Min ? std::min(m, args[i].asNumber())
+                                   : std::max(m, args[i].asNumber());
+    }
+    return ExprVmValue::number(m);
+  }
+
+  case ExprBuiltinId::Clamp:
+    if (argc < 3) return ExprVmValue::null();
+    return ExprVmValue::number(
+        std::clamp(args[0].asNumber(), args[1].asNumber(), args[2].asNumber()));
+
+  case ExprBuiltinId::Length: {
+    if (argc < 1) return ExprVmValue::number(0.0);
+    if (args[0].isVector()) {
+      double sumSq = 0.0;
+      for (int i = 0; i < args[0].dimension(); ++i) sumSq += args[0].v[i] * args[0].v[i];
+      return ExprVmValue::number(std::sqrt(sumSq));
+    }
+    return ExprVmValue::number(std::abs(args[0].asNumber()));
+  }
+
+  case ExprBuiltinId::Distance: {
+    if (argc < 2) return ExprVmValue::number(0.0);
+    if (args[0].isVector() && args[1].isVector()) {
+      const int size = std::min(args[0].dimension(), args[1].dimension());
+      double sumSq = 0.0;
+      for (int i = 0; i < size; ++i) {
+        const double delta = args[0].v[i] - args[1].v[i];
+        sumSq += delta * delta;
+      }
+      return ExprVmValue::number(std::sqrt(sumSq));
+    }
+    return ExprVmValue::number(std::abs(args[0].asNumber() - args[1].asNumber()));
+  }
+
+  case ExprBuiltinId::Normalize: {
+    if (argc < 1) return ExprVmValue::null();
+    const ExprVmValue& value = args[0];
+    if (!value.isVector()) return value;
+    double lenSq = 0.0;
+    for (int i = 0; i < value.dimension(); ++i) lenSq += value.v[i] * value.v[i];
+    const double len = std::sqrt(lenSq);
+    if (len < 1e-12) return value;
+    double out[4];
+    for (int i = 0; i < value.dimension(); ++i) out[i] = value.v[i] / len;
+    return vmVector(out, value.dimension());
+  }
+
+  case ExprBuiltinId::Dot: {
+    if (argc < 2) return ExprVmValue::number(0.0);
+    double a[4];
+    double b[4];
+    const int size = std::min(vmAsVector(args[0], a), vmAsVector(args[1], b));
+    double sum = 0.0;
+    for (int i = 0; i < size; ++i) sum += a[i] * b[i];
+    return ExprVmValue::number(sum);
+  }
+
+  case ExprBuiltinId::Cross: {
+    if (argc < 2) return ExprVmValue::null();
+    double a[4];
+    double b[4];
+    if (vmAsVector(args[0], a) < 3 || vmAsVector(args[1], b) < 3) return ExprVmValue::null();
+    const double out[3] = {a[1] * b[2] - a[2] * b[1],
+                           a[2] * b[0] - a[0] * b[2],
+                           a[0] * b[1] - a[1] * b[0]};
+    return vmVector(out, 3);
+  }
+
+  case ExprBuiltinId::Linear:
+    return vmInterpolateBuiltin(args, argc, [](double t) { return t; }, true);
+  case ExprBuiltinId::Ease:
+    return vmInterpolateBuiltin(args, argc, vmEaseCurve, false);
+  case ExprBuiltinId::EaseIn:
+    return vmInterpolateBuiltin(args, argc, vmEaseInCurve, false);
+  case ExprBuiltinId::EaseOut:
+    return vmInterpolateBuiltin(args, argc, vmEaseOutCurve, false);
+
+  case ExprBuiltinId::Noise: {
+    if (argc < 1) return ExprVmValue::number(0.0);
+    const double x = args[0].asNumber();
+    const double y = argc > 1 ? args[1].asNumber() : 0.0;
+    const double z = argc > 2 ? args[2].asNumber() : 0.0;
+    return ExprVmValue::number(static_cast<double>(NoiseGenerator::perlin(
+        static_cast<float>(x), static_cast<float>(y), static_cast<float>(z))));
+  }
+
+  case ExprBuiltinId::Wiggle: {
+    // The trailing argument is the implicit `time` slot.
+    const int userArgc = argc - 1;
+    if (userArgc < 2) return ExprVmValue::number(0.0);
+    const double freq = args[0].asNumber();
+    const double amp = args[1].asNumber();
+    const double time = args[argc - 1].asNumber();
+    int octaves = 4;
+    double persistence = 0.5;
+    double lacunarity = 2.0;
+    if (userArgc >= 3) octaves = static_cast<int>(args[2].asNumber());
+    if (userArgc >= 4) persistence = args[3].asNumber();
+    if (userArgc >= 5) lacunarity = args[4].asNumber();
+    const double noise = NoiseGenerator::fractal(static_cast<float>(time * freq), 0.0f, 0.0f,
+                                                 octaves, static_cast<float>(persistence),
+                                                 static_cast<float>(lacunarity));
+    return ExprVmValue::number(noise * amp);
+  }
+
+  case ExprBuiltinId::Sum:
+  case ExprBuiltinId::Average: {
+    if (id == ExprBuiltinId::Average && argc < 1) return ExprVmValue::number(0.0);
+    double total = 0.0;
+    for (int i = 0; i < argc; ++i) total += args[i].asNumber();
+    return ExprVmValue::number(id == ExprBuiltinId::Sum ? total : total / argc);
+  }
+  }
+  return ExprVmValue::null();
+}
+
+ExprVmStatus ExpressionVM::run(const ExpressionProgram& program,
+                               const ExprVmValue* slots,
+                               ExprVmValue& result) {
+  ExprVmValue stack[kMaxStackDepth];
+  int sp = 0;
+  const ExprInstruction* code = program.code().data();
+  const ExprVmValue* constants = program.constants().data();
+  size_t pc = 0;
+
+  for (;;) {
+    const ExprInstruction& ins = code[pc++];
+    switch (ins.op) {
+    case ExprOpCode::PushConst:
+      stack[sp++] = constants[ins.operand];
+      break;
+
+    case ExprOpCode::LoadSlot:
+      stack[sp++] = slots[ins.operand];
+      break;
+
+    case ExprOpCode::MakeVector: {
+      const int count = ins.count;
+      double components[4];
+      for (int i = 0; i < count; ++i) components[i] = stack[sp - count + i].asNumber();
+      sp -= count;
+      stack[sp++] = ExprVmValue::vector(components, count);
+      break;
+    }
+
+    case ExprOpCode::Add:
+    case ExprOpCode::Sub:
+    case ExprOpCode::Mul:
+    case ExprOpCode::Div:
+    case ExprOpCode::Pow:
+    case ExprOpCode::FloorDiv:
+    case ExprOpCode::Equal:
+    case ExprOpCode::NotEqual:
+    case ExprOpCode::Less:
+    case ExprOpCode::LessEqual:
+    case ExprOpCode::Greater:
+    case ExprOpCode::GreaterEqual:
+    case ExprOpCode::LogicalAnd:
+    case ExprOpCode::LogicalOr: {
+      const ExprVmValue rhs = stack[--sp];
+      const ExprVmValue lhs = stack[--sp];
+      ExprVmValue out;
+      switch (ins.op) {
+      case ExprOpCode::Add: out = vmAdd(lhs, rhs, 1.0); break;
+      case ExprOpCode::Sub: out = vmAdd(lhs, rhs, -1.0); break;
+      case ExprOpCode::Mul: out = vmMul(lhs, rhs); break;
+      case ExprOpCode::Div: out = vmDiv(lhs, rhs); break;
+      case ExprOpCode::Pow:
+        out = ExprVmValue::number(std::pow(lhs.asNumber(), rhs.asNumber()));
+        break;
+      case ExprOpCode::FloorDiv: {
+        const double divisor = rhs.asNumber();
+        out = divisor != 0.0 ? ExprVmValue::number(std::floor(lhs.asNumber() / divisor))
+                             : ExprVmValue::null();
+        break;
+      }
+      case ExprOpCode::Equal: out = vmBool(vmEqual(lhs, rhs)); break;
+      case ExprOpCode::NotEqual: out = vmBool(!vmEqual(lhs, rhs)); break;
+      case ExprOpCode::Less: out = vmBool(vmLess(lhs, rhs)); break;
+      case ExprOpCode::LessEqual: out = vmBool(vmLess(lhs, rhs) || vmEqual(lhs, rhs)); break;
+      case ExprOpCode::Greater: out = vmBool(!(vmLess(lhs, rhs) || vmEqual(lhs, rhs))); break;
+      case ExprOpCode::GreaterEqual: out = vmBool(!vmLess(lhs, rhs)); break;
+      case ExprOpCode::LogicalAnd:
+        out = vmBool(lhs.asNumber() != 0.0 && rhs.asNumber() != 0.0);
+        break;
+      case ExprOpCode::LogicalOr:
+        out = vmBool(lhs.asNumber() != 0.0 || rhs.asNumber() != 0.0);
+        break;
+      default: break;
+      }
+      stack[sp++] = out;
+      break;
+    }
+
+    case ExprOpCode::Negate:
+      stack[sp - 1] = ExprVmValue::number(-stack[sp - 1].asNumber());
+      break;
+
+    case ExprOpCode::LogicalNot:
+      stack[sp - 1] = vmBool(stack[sp - 1].asNumber() == 0.0);
+      break;
+
+    case ExprOpCode::Component: {
+      const ExprVmValue& base = stack[sp - 1];
+      // Non-vector bases are an "Unsupported property access" error in the AST.
+      if (!base.isVector()) return ExprVmStatus::Fallback;
+      const int index = ins.operand;
+      stack[sp - 1] = ExprVmValue::number(index < base.dimension() ? base.v[index] : 0.0);
+      break;
+    }
+
+    case ExprOpCode::Index: {
+      const ExprVmValue index = stack[--sp];
+      const ExprVmValue& base = stack[sp - 1];
+      const double position = index.asNumber();
+      if (base.isVector() && position >= 0.0 && position < base.dimension()) {
+        stack[sp - 1] = ExprVmValue::number(base.v[static_cast<int>(position)]);
+      } else {
+        stack[sp - 1] = ExprVmValue::null();
+      }
+      break;
+    }
+
+    case ExprOpCode::Jump:
+      pc = static_cast<size_t>(ins.operand);
+      break;
+
+    case ExprOpCode::JumpIfFalse:
+      if (stack[--sp].asNumber() == 0.0) pc = static_cast<size_t>(ins.operand);
+      break;
+
+    case ExprOpCode::CallBuiltin: {
+      const int argc = ins.count;
+      const ExprVmValue out = callBuiltin(static_cast<ExprBuiltinId>(ins.operand),
+                                          stack + sp - argc, argc);
+      sp -= argc;
+      stack[sp++] = out;
+      break;
+    }
+
+    case ExprOpCode::Return:
+      result = sp > 0 ? stack[sp - 1] : ExprVmValue::null();
+      return ExprVmStatus::Ok;
+    }
+  }
+}
+
+
+// ============================================================
+// Batch VM
+// ============================================================
+
+ExprBatchBinding ExprBatchBinding::uniformValue(const ExprVmValue& value) {
+  ExprBatchBinding binding;
+  binding.uniform = value;
+  return binding;
+}
+
+ExprBatchBinding ExprBatchBinding::varying(ExprValueType type, const double* x,
+                                           const double* y, const double* z,
+                                           const double* w) {
+  ExprBatchBinding binding;
+  binding.varyingType = type;
+  binding.components[0] = x;
+  binding.components[1] = y;
+  binding.components[2] = z;
+  binding.components[3] = w;
+  return binding;
+}
+
+ExprVmValue ExprBatchBinding::lane(int index) const {
+  if (!isVarying()) return uniform;
+  ExprVmValue out;
+  out.type = varyingType;
+  const int dim = out.dimension();
+  for (int c = 0; c < dim; ++c) out.v[c] = components[c] ? components[c][index] : 0.0;
+  return out;
+}
+
+void ExprBatchResult::store(int lane, const ExprVmValue& value, ExprVmStatus laneStatus) {
+  types[lane] = value.type;
+  const int dim = value.dimension();
+  for (int c = 0; c < 4; ++c) {
+    if (components[c]) components[c][lane] = c < dim ? value.v[c] : 0.0;
+  }
+  if (status) status[lane] = laneStatus;
+}
+
+namespace {
+
+constexpr int kLanes = ExpressionVM::kBatchLanes;
+
+// One operand-stack entry for a block of lanes. The type is shared by every
+// lane; c[k][lane] holds component k. Null registers keep c[0] at 0 so that
+// asNumber() is simply c[0].
+struct BatchRegister {
+  ExprValueType type = ExprValueType::Null;
+  double c[4][kLanes];
+};
+
+enum class BlockStatus { Ok, Diverged };
+
+int typeDimension(ExprValueType type) {
+  ExprVmValue probe;
+  probe.type = type;
+  return probe.dimension();
+}
+
+bool isVectorType(ExprValueType type) {
+  return type == ExprValueType::Vec2 || type == ExprValueType::Vec3 ||
+         type == ExprValueType::Vec4;
+}
+
+ExprValueType vectorType(int dim) {
+  return dim == 2 ? ExprValueType::Vec2 : dim == 3 ? ExprValueType::Vec3 : ExprValueType::Vec4;
+}
+
+void setNull(BatchRegister& r) {
+  r.type = ExprValueType::Null;
+  for (int i = 0; i < kLanes; ++i) r.c[0][i] = 0.0;
+}
+
+void setBool(BatchRegister& r, const bool (&mask)[kLanes]) {
+  r.type = ExprValueType::Number;
+  for (int i = 0; i < kLanes; ++i) r.c[0][i] = mask[i] ? 1.0 : 0.0;
+}
+
+// Lanes that all agree: +1 all true, 0 all false, -1 mixed
+int uniformMask(const bool (&mask)[kLanes]) {
+  int count = 0;
+  for (int i = 0; i < kLanes; ++i) count += mask[i] ? 1 : 0;
+  return count == kLanes ? 1 : count == 0 ? 0 : -1;
+}
+
+ExprVmValue laneValue(const BatchRegister& r, int lane) {
+  ExprVmValue out;
+  out.type = r.type;
+  const int dim = typeDimension(r.type);
+  for (int k = 0; k < dim; ++k) out.v[k] = r.c[k][lane];
+  return out;
+}
+
+void loadBinding(const ExprBatchBinding& binding, int base, int active, BatchRegister& r) {
+  if (!binding.isVarying()) {
+    r.type = binding.uniform.type;
+    const int dim = std::max(1, binding.uniform.dimension());
+    for (int k = 0; k < dim; ++k) {
+      for (int i = 0; i < kLanes; ++i) r.c[k][i] = binding.uniform.v[k];
+    }
+    if (binding.uniform.isNull()) setNull(r);
+    return;
+  }
+
+  r.type = binding.varyingType;
+  const int dim = typeDimension(r.type);
+  if (dim == 0) {
+    setNull(r);
+    return;
+  }
+  // Padding lanes replicate the last active lane so they never diverge.
+  for (int k = 0; k < dim; ++k) {
+    const double* source = binding.components[k];
+    for (int i = 0; i < kLanes; ++i) {
+      r.c[k][i] = source ? source[base + std::min(i, active - 1)] : 0.0;
+    }
+  }
+}
+
+void equalMask(const BatchRegister& a, const BatchRegister& b, bool (&mask)[kLanes]) {
+  if (a.type != b.type || a.type == ExprValueType::Null) {
+    for (int i = 0; i < kLanes; ++i) mask[i] = false;
+    return;
+  }
+  const int dim = typeDimension(a.type);
+  for (int i = 0; i < kLanes; ++i) {
+    bool equal = true;
+    for (int k = 0; k < dim; ++k) equal = equal && a.c[k][i] == b.c[k][i];
+    mask[i] = equal;
+  }
+}
+
+void lessMask(const BatchRegister& a, const BatchRegister& b, bool (&mask)[kLanes]) {
+  const bool numbers = a.type == ExprValueType::Number && b.type == ExprValueType::Number;
+  for (int i = 0; i < kLanes; ++i) mask[i] = numbers && a.c[0][i] < b.c[0][i];
+}
+
+BlockStatus batchBinary(ExprOpCode op, const BatchRegister& a, const BatchRegister& b,
+                        BatchRegister& out) {
+  const bool aNum = a.type == ExprValueType::Number;
+  const bool bNum = b.type == ExprValueType::Number;
+  const bool aVec = isVectorType(a.type);
+  const bool bVec = isVectorType(b.type);
+
+  switch (op) {
+  case ExprOpCode::Add:
+  case ExprOpCode::Sub: {
+    const double sign = op == ExprOpCode::Add ? 1.0 : -1.0;
+    if (aNum && bNum) {
+      out.type = ExprValueType::Number;
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = a.c[0][i] + sign * b.c[0][i];
+    } else if (aVec && bVec) {
+      const int dim = std::min(typeDimension(a.type), typeDimension(b.type));
+      out.type = vectorType(dim);
+      for (int k = 0; k < dim; ++k) {
+        for (int i = 0; i < kLanes; ++i) out.c[k][i] = a.c[k][i] + sign * b.c[k][i];
+      }
+    } else {
+      setNull(out);
+    }
+    return BlockStatus::Ok;
+  }
+
+  case ExprOpCode::Mul: {
+    if (aNum && bNum) {
+      out.type = ExprValueType::Number;
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = a.c[0][i] * b.c[0][i];
+    } else if (aNum && bVec) {
+      const int dim = typeDimension(b.type);
+      out.type = b.type;
+      for (int k = 0; k < dim; ++k) {
+        for (int i = 0; i < kLanes; ++i) out.c[k][i] = b.c[k][i] * a.c[0][i];
+      }
+    } else if (aVec && bNum) {
+      const int dim = typeDimension(a.type);
+      out.type = a.type;
+      for (int k = 0; k < dim; ++k) {
+        for (int i = 0; i < kLanes; ++i) out.c[k][i] = a.c[k][i] * b.c[0][i];
+      }
+    } else if (aVec && bVec) {
+      const int dim = std::min(typeDimension(a.type), typeDimension(b.type));
+      out.type = vectorType(dim);
+      for (int k = 0; k < dim; ++k) {
+        for (int i = 0; i < kLanes; ++i) out.c[k][i] = a.c[k][i] * b.c[k][i];
+      }
+    } else {
+      setNull(out);
+    }
+    return BlockStatus::Ok;
+  }
+
+  case ExprOpCode::Div: {
+    if (!(aNum || aVec) || !bNum) {
+      setNull(out);
+      return BlockStatus::Ok;
+    }
+    bool zero[kLanes];
+    for (int i = 0; i < kLanes; ++i) zero[i] = b.c[0][i] == 0.0;
+    const int zeroLanes = uniformMask(zero);
+    if (zeroLanes < 0) return BlockStatus::Diverged;
+    if (zeroLanes == 1) {
+      setNull(out);
+      return BlockStatus::Ok;
+    }
+    const int dim = typeDimension(a.type);
+    out.type = a.type;
+    for (int k = 0; k < dim; ++k) {
+      for (int i = 0; i < kLanes; ++i) out.c[k][i] = a.c[k][i] / b.c[0][i];
+    }
+    return BlockStatus::Ok;
+  }
+
+  case ExprOpCode::Pow:
+    out.type = ExprValueType::Number;
+    for (int i = 0; i < kLanes; ++i) out.c[0][i] = std::pow(a.c[0][i], b.c[0][i]);
+    return BlockStatus::Ok;
+
+  case ExprOpCode::FloorDiv: {
+    bool zero[kLanes];
+    for (int i = 0; i < kLanes; ++i) zero[i] = b.c[0][i] == 0.0;
+    const int zeroLanes = uniformMask(zero);
+    if (zeroLanes < 0) return BlockStatus::Diverged;
+    if (zeroLanes == 1) {
+      setNull(out);
+      return BlockStatus::Ok;
+    }
+    out.type = ExprValueType::Number;
+    for (int i = 0; i < kLanes; ++i) out.c[0][i] = std::floor(a.c[0][i] / b.c[0][i]);
+    return BlockStatus::Ok;
+  }
+
+  case ExprOpCode::Equal:
+  case ExprOpCode::NotEqual:
+  case ExprOpCode::Less:
+  case ExprOpCode::LessEqual:
+  case ExprOpCode::Greater:
+  case ExprOpCode::GreaterEqual: {
+    bool equal[kLanes];
+    bool less[kLanes];
+    bool result[kLanes];
+    equalMask(a, b, equal);
+    lessMask(a, b, less);
+    for (int i = 0; i < kLanes; ++i) {
+      switch (op) {
+      case ExprOpCode::Equal: result[i] = equal[i]; break;
+      case ExprOpCode::NotEqual: result[i] = !equal[i]; break;
+      case ExprOpCode::Less: result[i] = less[i]; break;
+      case ExprOpCode::LessEqual: result[i] = less[i] || equal[i]; break;
+      case ExprOpCode::Greater: result[i] = !(less[i] || equal[i]); break;
+      default: result[i] = !less[i]; break;
+      }
+    }
+    setBool(out, result);
+    return BlockStatus::Ok;
+  }
+
+  case ExprOpCode::LogicalAnd:
+  case ExprOpCode::LogicalOr: {
+    bool result[kLanes];
+    for (int i = 0; i < kLanes; ++i) {
+      const bool lhs = a.c[0][i] != 0.0;
+      const bool rhs = b.c[0][i] != 0.0;
+      result[i] = op == ExprOpCode::LogicalAnd ? (lhs && rhs) : (lhs || rhs);
+    }
+    setBool(out, result);
+    return BlockStatus::Ok;
+  }
+
+  default:
+    return BlockStatus::Diverged;
+  }
+}
+
+template<typename Fn>
+void batchUnary(const BatchRegister* args, int argc, BatchRegister& out, Fn fn) {
+  if (argc < 1) {
+    setNull(out);
+    return;
+  }
+  out.type = ExprValueType::Number;
+  for (int i = 0; i < kLanes; ++i) out.c[0][i] = fn(args[0].c[0][i]);
+}
+
+template<typename Curve>
+BlockStatus batchInterpolate(const BatchRegister* args, int argc, BatchRegister& out,
+                             Curve curve, bool clampLinear) {
+  if (argc != 3 && argc < 5) {
+    setNull(out);
+    return BlockStatus::Ok;
+  }
+
+  const BatchRegister& from = argc == 3 ? args[1] : args[3];
+  const BatchRegister& to = argc == 3 ? args[2] : args[4];
+  double alpha[kLanes];
+  bool degenerate[kLanes] = {};
+  if (argc == 3) {
+    for (int i = 0; i < kLanes; ++i) alpha[i] = curve(args[0].c[0][i]);
+  } else {
+    for (int i = 0; i < kLanes; ++i) {
+      const double range = args[2].c[0][i] - args[1].c[0][i];
+      degenerate[i] = std::abs(range) < 1e-12;
+      const double raw = (args[0].c[0][i] - args[1].c[0][i]) / range;
+      alpha[i] = clampLinear ? std::clamp(raw, 0.0, 1.0) : curve(raw);
+    }
+  }
+
+  // A degenerate time range returns `from` unchanged, which may have a
+  // different type than the interpolated value.
+  const bool vectors = isVectorType(from.type) && isVectorType(to.type);
+  const ExprValueType lerpType = vectors
+      ? vectorType(std::min(typeDimension(from.type), typeDimension(to.type)))
+      : ExprValueType::Number;
+  const int degenerateLanes = uniformMask(degenerate);
+  if (degenerateLanes == 1) {
+    out = from;
+    return BlockStatus::Ok;
+  }
+  if (degenerateLanes < 0 && lerpType != from.type) return BlockStatus::Diverged;
+
+  out.type = lerpType;
+  const int dim = typeDimension(lerpType);
+  for (int k = 0; k < dim; ++k) {
+    for (int i = 0; i < kLanes; ++i) {
+      // Numbers interpolate asNumber(), i.e. component 0 (0 for Null).
+      const double a = from.c[k][i];
+      const double b = to.c[k][i];
+      out.c[k][i] = degenerate[i] ? a : a + alpha[i] * (b - a);
+    }
+  }
+  return BlockStatus::Ok;
+}
+
+BlockStatus batchGenericBuiltin(ExprBuiltinId id, const BatchRegister* args, int argc,
+                                BatchRegister& out) {
+  ExprVmValue laneArgs[ExpressionVM::kMaxStackDepth];
+  ExprVmValue results[kLanes];
+  for (int i = 0; i < kLanes; ++i) {
+    for (int j = 0; j < argc; ++j) laneArgs[j] = laneValue(args[j], i);
+    results[i] = ExpressionVM::callBuiltin(id, laneArgs, argc);
+    if (results[i].type != results[0].type) return BlockStatus::Diverged;
+  }
+  out.type = results[0].type;
+  const int dim = results[0].dimension();
+  for (int k = 0; k < dim; ++k) {
+    for (int i = 0; i < kLanes; ++i) out.c[k][i] = results[i].v[k];
+  }
+  if (dim == 0) setNull(out);
+  return BlockStatus::Ok;
+}
+
+BlockStatus batchBuiltin(ExprBuiltinId id, const BatchRegister* args, int argc,
+                         BatchRegister& out) {
+  switch (id) {
+  case ExprBuiltinId::Sin: batchUnary(args, argc, out, [](double x) { return std::sin(x); }); break;
+  case ExprBuiltinId::Cos: batchUnary(args, argc, out, [](double x) { return std::cos(x); }); break;
+  case ExprBuiltinId::Tan: batchUnary(args, argc, out, [](double x) { return std::tan(x); }); break;
+  case ExprBuiltinId::DegToRad:
+    batchUnary(args, argc, out, [](double x) { return x * (std::acos(-1.0) / 180.0); });
+    break;
+  case ExprBuiltinId::RadToDeg:
+    batchUnary(args, argc, out, [](double x) { return x * (180.0 / std::acos(-1.0)); });
+    break;
+  case ExprBuiltinId::Sqrt: batchUnary(args, argc, out, [](double x) { return std::sqrt(x); }); break;
+  case ExprBuiltinId::Abs: batchUnary(args, argc, out, [](double x) { return std::abs(x); }); break;
+  case ExprBuiltinId::Floor: batchUnary(args, argc, out, [](double x) { return std::floor(x); }); break;
+  case ExprBuiltinId::Ceil: batchUnary(args, argc, out, [](double x) { return std::ceil(x); }); break;
+  case ExprBuiltinId::Round: batchUnary(args, argc, out, [](double x) { return std::round(x); }); break;
+
+  case ExprBuiltinId::Pow:
+    if (argc < 2) {
+      setNull(out);
+      break;
+    }
+    out.type = ExprValueType::Number;
+    for (int i = 0; i < kLanes; ++i) out.c[0][i] = std::pow(args[0].c[0][i], args[1].c[0][i]);
+    break;
+
+  case ExprBuiltinId::Min:
+  case ExprBuiltinId::Max: {
+    if (argc < 1) {
+      setNull(out);
+      break;
+    }
+    double m[kLanes];
+    for (int i = 0; i < kLanes; ++i) m[i] = args[0].c[0][i];
+    for (int j = 1; j < argc; ++j) {
+      for (int i = 0; i < kLanes; ++i) {
+        m[i] = id == ExprBuiltinId::Min ? std::min(m[i], args[j].c[0][i])
+                                        : std::max(m[i], args[j].c[0][i]);
+      }
+    }
+    out.type = ExprValueType::Number;
+    for (int i = 0; i < kLanes; ++i) out.c[0][i] = m[i];
+    break;
+  }
+
+  case ExprBuiltinId::Clamp:
+    if (argc < 3) {
+      setNull(out);
+      break;
+    }
+    out.type = ExprValueType::Number;
+    for (int i = 0; i < kLanes; ++i) {
+      out.c[0][i] = std::clamp(args[0].c[0][i], args[1].c[0][i], args[2].c[0][i]);
+    }
+    break;
+
+  case ExprBuiltinId::Length: {
+    out.type = ExprValueType::Number;
+    if (argc < 1) {
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = 0.0;
+      break;
+    }
+    if (isVectorType(args[0].type)) {
+      const int dim = typeDimension(args[0].type);
+      for (int i = 0; i < kLanes; ++i) {
+        double sumSq = 0.0;
+        for (int k = 0; k < dim; ++k) sumSq += args[0].c[k][i] * args[0].c[k][i];
+        out.c[0][i] = std::sqrt(sumSq);
+      }
+    } else {
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = std::abs(args[0].c[0][i]);
+    }
+    break;
+  }
+
+  case ExprBuiltinId::Distance: {
+    out.type = ExprValueType::Number;
+    if (argc < 2) {
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = 0.0;
+      break;
+    }
+    if (isVectorType(args[0].type) && isVectorType(args[1].type)) {
+      const int dim = std::min(typeDimension(args[0].type), typeDimension(args[1].type));
+      for (int i = 0; i < kLanes; ++i) {
+        double sumSq = 0.0;
+        for (int k = 0; k < dim; ++k) {
+          const double delta = args[0].c[k][i] - args[1].c[k][i];
+          sumSq += delta * delta;
+        }
+        out.c[0][i] = std::sqrt(sumSq);
+      }
+    } else {
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = std::abs(args[0].c[0][i] - args[1].c[0][i]);
+    }
+    break;
+  }
+
+  case ExprBuiltinId::Linear:
+    return batchInterpolate(args, argc, out, [](double t) { return t; }, true);
+  case ExprBuiltinId::Ease:
+    return batchInterpolate(args, argc, out, vmEaseCurve, false);
+  case ExprBuiltinId::EaseIn:
+    return batchInterpolate(args, argc, out, vmEaseInCurve, false);
+  case ExprBuiltinId::EaseOut:
+    return batchInterpolate(args, argc, out, vmEaseOutCurve, false);
+
+  case ExprBuiltinId::Noise: {
+    out.type = ExprValueType::Number;
+    if (argc < 1) {
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = 0.0;
+      break;
+    }
+    float x[kLanes];
+    float y[kLanes];
+    float z[kLanes];
+    float noise[kLanes];
+    for (int i = 0; i < kLanes; ++i) {
+      x[i] = static_cast<float>(args[0].c[0][i]);
+      y[i] = static_cast<float>(argc > 1 ? args[1].c[0][i] : 0.0);
+      z[i] = static_cast<float>(argc > 2 ? args[2].c[0][i] : 0.0);
+    }
+    NoiseGenerator::perlinBatch(x, y, z, noise, kLanes);
+    for (int i = 0; i < kLanes; ++i) out.c[0][i] = static_cast<double>(noise[i]);
+    break;
+  }
+
+  case ExprBuiltinId::Wiggle: {
+    const int userArgc = argc - 1;
+    out.type = ExprValueType::Number;
+    if (userArgc < 2) {
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = 0.0;
+      break;
+    }
+    // The fBm parameters drive the octave loop and must be shared by the block.
+    int octaves = 4;
+    float persistence = 0.5f;
+    float lacunarity = 2.0f;
+    if (userArgc >= 3) octaves = static_cast<int>(args[2].c[0][0]);
+    if (userArgc >= 4) persistence = static_cast<float>(args[3].c[0][0]);
+    if (userArgc >= 5) lacunarity = static_cast<float>(args[4].c[0][0]);
+    for (int i = 1; i < kLanes; ++i) {
+      if ((userArgc >= 3 && static_cast<int>(args[2].c[0][i]) != octaves) ||
+          (userArgc >= 4 && static_cast<float>(args[3].c[0][i]) != persistence) ||
+          (userArgc >= 5 && static_cast<float>(args[4].c[0][i]) != lacunarity)) {
+        return batchGenericBuiltin(id, args, argc, out);
+      }
+    }
+    float x[kLanes];
+    float noise[kLanes];
+    for (int i = 0; i < kLanes; ++i) {
+      x[i] = static_cast<float>(args[argc - 1].c[0][i] * args[0].c[0][i]);
+    }
+    NoiseGenerator::fractalBatch(x, nullptr, nullptr, noise, kLanes, octaves, persistence,
+                                 lacunarity);
+    for (int i = 0; i < kLanes; ++i) out.c[0][i] = noise[i] * args[1].c[0][i];
+    break;
+  }
+
+  case ExprBuiltinId::Sum:
+  case ExprBuiltinId::Average: {
+    out.type = ExprValueType::Number;
+    if (id == ExprBuiltinId::Average && argc < 1) {
+      for (int i = 0; i < kLanes; ++i) out.c[0][i] = 0.0;
+      break;
+    }
+    for (int i = 0; i < kLanes; ++i) {
+      double total = 0.0;
+      for (int j = 0; j < argc; ++j) total += args[j].c[0][i];
+      out.c[0][i] = id == ExprBuiltinId::Sum ? total : total / argc;
+    }
+    break;
+  }
+
+  default:
+    return batchGenericBuiltin(id, args, argc, out);
+  }
+  return BlockStatus::Ok;
+}
+
+BlockStatus runBlock(const ExpressionProgram& program, const ExprBatchBinding* slots,
+                     int base, int active, BatchRegister* stack, BatchRegister& result) {
+  const ExprInstruction* code = program.code().data();
+  const ExprVmValue* constants = program.constants().data();
+  BatchRegister scratch;
+  int sp = 0;
+  size_t pc = 0;
+
+  for (;;) {
+    const ExprInstruction& ins = code[pc++];
+    switch (ins.op) {
+    case ExprOpCode::PushConst:
+      loadBinding(ExprBatchBinding::uniformValue(constants[ins.operand]), base, active,
+                  stack[sp++]);
+      break;
+
+    case ExprOpCode::LoadSlot:
+      loadBinding(slots[ins.operand], base, active, stack[sp++]);
+      break;
+
+    case ExprOpCode::MakeVector: {
+      const int count = ins.count;
+      scratch.type = vectorType(count);
+      for (int k = 0; k < count; ++k) {
+        for (int i = 0; i < kLanes; ++i) scratch.c[k][i] = stack[sp - count + k].c[0][i];
+      }
+      sp -= count;
+      stack[sp++] = scratch;
+      break;
+    }
+
+    case ExprOpCode::Add:
+    case ExprOpCode::Sub:
+    case ExprOpCode::Mul:
+    case ExprOpCode::Div:
+    case ExprOpCode::Pow:
+    case ExprOpCode::FloorDiv:
+    case ExprOpCode::Equal:
+    case ExprOpCode::NotEqual:
+    case ExprOpCode::Less:
+    case ExprOpCode::LessEqual:
+    case ExprOpCode::Greater:
+    case ExprOpCode::GreaterEqual:
+    case ExprOpCode::LogicalAnd:
+    case ExprOpCode::LogicalOr:
+      if (batchBinary(ins.op, stack[sp - 2], stack[sp - 1], scratch) != BlockStatus::Ok) {
+        return BlockStatus::Diverged;
+      }
+      sp -= 2;
+      stack[sp++] = scratch;
+      break;
+
+    case ExprOpCode::Negate: {
+      BatchRegister& top = stack[sp - 1];
+      for (int i = 0; i < kLanes; ++i) top.c[0][i] = -top.c[0][i];
+      top.type = ExprValueType::Number;
+      break;
+    }
+
+    case ExprOpCode::LogicalNot: {
+      BatchRegister& top = stack[sp - 1];
+      for (int i = 0; i < kLanes; ++i) top.c[0][i] = top.c[0][i] == 0.0 ? 1.0 : 0.0;
+      top.type = ExprValueType::Number;
+      break;
+    }
+
+    case ExprOpCode::Component: {
+      BatchRegister& top = stack[sp - 1];
+      // The scalar VM reports Fallback for non-vector bases.
+      if (!isVectorType(top.type)) return BlockStatus::Diverged;
+      const int index = ins.operand;
+      if (index < typeDimension(top.type)) {
+        for (int i = 0; i < kLanes; ++i) top.c[0][i] = top.c[index][i];
+      } else {
+        for (int i = 0; i < kLanes; ++i) top.c[0][i] = 0.0;
+      }
+      top.type = ExprValueType::Number;
+      break;
+    }
+
+    case ExprOpCode::Index: {
+      const BatchRegister& index = stack[--sp];
+      BatchRegister& top = stack[sp - 1];
+      if (!isVectorType(top.type)) {
+        setNull(top);
+        break;
+      }
+      const int dim = typeDimension(top.type);
+      bool inRange[kLanes];
+      for (int i = 0; i < kLanes; ++i) {
+        inRange[i] = index.c[0][i] >= 0.0 && index.c[0][i] < dim;
+      }
+      const int lanesInRange = uniformMask(inRange);
+      if (lanesInRange < 0) return BlockStatus::Diverged;
+      if (lanesInRange == 0) {
+        setNull(top);
+        break;
+      }
+      for (int i = 0; i < kLanes; ++i) {
+        scratch.c[0][i] = top.c[static_cast<int>(index.c[0][i])][i];
+      }
+      for (int i = 0; i < kLanes; ++i) top.c[0][i] = scratch.c[0][i];
+      top.type = ExprValueType::Number;
+      break;
+    }
+
+    case ExprOpCode::Jump:
+      pc = static_cast<size_t>(ins.operand);
+      break;
+
+    case ExprOpCode::JumpIfFalse: {
+      const BatchRegister& condition = stack[--sp];
+      bool isFalse[kLanes];
+      for (int i = 0; i < kLanes; ++i) isFalse[i] = condition.c[0][i] == 0.0;
+      const int falseLanes = uniformMask(isFalse);
+      if (falseLanes < 0) return BlockStatus::Diverged;
+      if (falseLanes == 1) pc = static_cast<size_t>(ins.operand);
+      break;
+    }
+
+    case ExprOpCode::CallBuiltin: {
+      const int argc = ins.count;
+      if (batchBuiltin(static_cast<ExprBuiltinId>(ins.operand), stack + sp - argc, argc,
+                       scratch) != BlockStatus::Ok) {
+        return BlockStatus::Diverged;
+      }
+      sp -= argc;
+      stack[sp++] = scratch;
+      break;
+    }
+
+    case ExprOpCode::Return:
+      if (sp > 0) {
+        result = stack[sp - 1];
+      } else {
+        setNull(result);
+      }
+      return BlockStatus::Ok;
+    }
+  }
+}
+
+}
+
+int ExpressionVM::runBatch(const ExpressionProgram& program,
+                           const ExprBatchBinding* slots,
+                           int count,
+                           ExprBatchResult& result) {
+  if (count <= 0 || !result.types) return 0;
+
+  std::vector<BatchRegister> stack(static_cast<size_t>(std::max(1, program.maxStackDepth())));
+  std::vector<ExprVmValue> laneSlots(program.slots().size());
+  BatchRegister blockResult;
+  int fallbackLanes = 0;
+
+  for (int base = 0; base < count; base += kLanes) {
+    const int active = std::min(kLanes, count - base);
+    if (runBlock(program, slots, base, active, stack.data(), blockResult) == BlockStatus::Ok) {
+      const int dim = typeDimension(blockResult.type);
+      for (int i = 0; i < active; ++i) {
+        result.types[base + i] = blockResult.type;
+        if (result.status) result.status[base + i] = ExprVmStatus::Ok;
+      }
+      for (int k = 0; k < 4; ++k) {
+        double* out = result.components[k];
+        if (!out) continue;
+        for (int i = 0; i < active; ++i) out[base + i] = k < dim ? blockResult.c[k][i] : 0.0;
+      }
+      continue;
+    }
+
+    // Divergent block: run each lane through the scalar VM.
+    for (int i = 0; i < active; ++i) {
+      for (size_t s = 0; s < laneSlots.size(); ++s) laneSlots[s] = slots[s].lane(base + i);
+      ExprVmValue value;
+      const ExprVmStatus status = run(program, laneSlots.data(), value);
+      if (status != ExprVmStatus::Ok) {
+        ++fallbackLanes;
+        value = ExprVmValue::null();
+      }
+      result.store(base + i, value, status);
+    }
+  }
+  return fallbackLanes;
+}
+
+}
@@ -4,6 +4,7 @@ module;
 #include <limits>
 #include <random>
 #include <cstdint>
+#include <cstring>
 
 #include <algorithm>
 #include <any>
@@ -47,6 +48,8 @@ import Container.NamedVector;
 import Memory.SharedPtr;
 import Script.Expression.Value;
 import Script.Expression.Parser;
+import Script.Expression.Bytecode;
+import Script.Expression.MemoCache;
 import Core.ArtifactString;
 import Math.Noise;
 
@@ -69,8 +72,10 @@ public:
   int evaluationCount_ = 0;
 
   // Memoization
+  // Compiled results are memoized in a bounded cache shared across evaluators
+  // (and threads); the AST walker itself does not memoize.
   bool memoizationEnabled_ = true;
-  std::map<size_t, ExpressionValue> memoCache_;
+  ExpressionMemoCache* memoCache_ = &ExpressionMemoCache::shared();
 
   // Audio data for current context
   float audioRMS_ = 0.0f;
@@ -92,9 +97,222 @@ public:
   double adaptiveSpeedGain_  = 1.0;          // step = max/(1 + speed*gain) の gain
   mutable int lastAdaptiveSplitCount_ = 0;   // Phase 5 診断用
 
+  // Bytecode VM (Phase 4)
+  // Compiled programs are keyed by AST node; the entry pins the node so the
+  // address cannot be reused while cached. Slot pointers into variables_ are
+  // re-resolved only when a key is inserted or erased (std::map nodes are
+  // stable otherwise), so steady-state evaluation does no name lookups.
+  struct CompiledEntry {
+    SharedPtr<ExprNode> node;
+    SharedPtr<ExpressionProgram> program;
+    std::vector<const ExpressionValue*> boundSlots;
+    // ExpressionMemoCache::dependencyHash of each slot name
+    std::vector<std::uint64_t> slotDependencies;
+    std::uint64_t boundLayoutVersion = 0;
+    int timeSlot = -1;
+  };
+  static constexpr size_t kMaxCompiledEntries = 1024;
+  // Below this cost a cache lookup is slower than running the program.
+  static constexpr int kMemoMinProgramCost = 48;
+
+  bool bytecodeEnabled_ = true;
+  bool registeringStandardFunctions_ = false;
+  ExpressionCompiler compiler_;
+  std::vector<std::string> hostFunctionNames_;
+  std::unordered_map<const ExprNode*, CompiledEntry> compiledCache_;
+  std::unordered_map<std::string, SharedPtr<ExprNode>> parsedCache_;
+  std::vector<ExprVmValue> slotScratch_;
+  std::uint64_t variablesLayoutVersion_ = 1;
+
   ExpressionValue evaluateNode(const SharedPtr<ExprNode> &node);
+
+  SharedPtr<ExprNode> parseCached(const std::string& expression);
+  CompiledEntry* compiledEntry(const SharedPtr<ExprNode>& node);
+  void bindSlots(CompiledEntry& entry);
+  bool tryEvaluateCompiled(const SharedPtr<ExprNode>& node, const double* timeSec,
+                           ExprVmValue& out);
+  bool runCompiledBatch(const SharedPtr<ExprNode>& node,
+                        const std::map<std::string, ExprBatchBinding>& varying, int count,
+                        ExprBatchResult& out, std::vector<ExprVmStatus>& laneStatus);
 };
 
+SharedPtr<ExprNode>
+ExpressionEvaluator::Impl::parseCached(const std::string& expression) {
+  if (bytecodeEnabled_) {
+    const auto it = parsedCache_.find(expression);
+    if (it != parsedCache_.end()) return it->second;
+  }
+  auto ast = parser_.parse(expression);
+  if (parser_.hasError()) return nullptr;
+  if (bytecodeEnabled_) {
+    if (parsedCache_.size() >= kMaxCompiledEntries) parsedCache_.clear();
+    parsedCache_.emplace(expression, ast);
+  }
+  return ast;
+}
+
+ExpressionEvaluator::Impl::CompiledEntry*
+ExpressionEvaluator::Impl::compiledEntry(const SharedPtr<ExprNode>& node) {
+  if (!node) return nullptr;
+  auto it = compiledCache_.find(node.get());
+  if (it == compiledCache_.end()) {
+    if (compiledCache_.size() >= kMaxCompiledEntries) compiledCache_.clear();
+    CompiledEntry entry;
+    entry.node = node;
+    // A null program is cached as well so unsupported ASTs are not recompiled.
+    entry.program = compiler_.compile(node);
+    if (entry.program) {
+      entry.timeSlot = entry.program->findSlot("time");
+      for (const auto& slot : entry.program->slots()) {
+        entry.slotDependencies.push_back(ExpressionMemoCache::dependencyHash(slot.name));
+      }
+    }
+    it = compiledCache_.emplace(node.get(), std::move(entry)).first;
+  }
+  return &it->second;
+}
+
+void ExpressionEvaluator::Impl::bindSlots(CompiledEntry& entry) {
+  if (entry.boundLayoutVersion == variablesLayoutVersion_) return;
+  const auto& slots = entry.program->slots();
+  entry.boundSlots.resize(slots.size());
+  for (size_t i = 0; i < slots.size(); ++i) {
+    const auto found = variables_.find(slots[i].name);
+    entry.boundSlots[i] = found != variables_.end() ? &found->second : nullptr;
+  }
+  entry.boundLayoutVersion = variablesLayoutVersion_;
+}
+
+bool ExpressionEvaluator::Impl::tryEvaluateCompiled(const SharedPtr<ExprNode>& node,
+                                                    const double* timeSec,
+                                                    ExprVmValue& out) {
+  if (!bytecodeEnabled_) return false;
+  CompiledEntry* entry = compiledEntry(node);
+  if (!entry || !entry->program) return false;
+  const ExpressionProgram& program = *entry->program;
+
+  // Let the AST walker produce the exact limit errors.
+  if (program.treeDepth() > recursionDepthLimit_ ||
+      evaluationCount_ + program.nodeCount() > evaluationBudget_) {
+    return false;
+  }
+
+  const auto& slots = program.slots();
+  bindSlots(*entry);
+
+  if (slotScratch_.size() < slots.size()) slotScratch_.resize(slots.size());
+  for (size_t i = 0; i < slots.size(); ++i) {
+    if (timeSec && slots[i].name == "time") {
+      slotScratch_[i] = ExprVmValue::number(*timeSec);
+      continue;
+    }
+    const ExpressionValue* bound = entry->boundSlots[i];
+    if (!bound) {
+      // Undefined variables are reported by the AST walker.
+      if (!slots[i].optional) return false;
+      slotScratch_[i] = ExprVmValue::null();
+      continue;
+    }
+    if (!toVmValue(*bound, slotScratch_[i])) return false;
+  }
+
+  // Compiled programs are pure functions of their slot values, so the slot
+  // values (plus the cache generation and each variable's dependency version)
+  // fully identify the result.
+  ExprMemoKey memoKey;
+  const bool memoize = memoizationEnabled_ && memoCache_ &&
+                       program.estimatedCost() >= kMemoMinProgramCost;
+  if (memoize) {
+    std::uint64_t dependency = memoCache_->generation() * 0x9e3779b97f4a7c15ull;
+    for (size_t i = 0; i < slots.size(); ++i) {
+      const ExprVmValue& value = slotScratch_[i];
+      if (static_cast<int>(i) == entry->timeSlot && value.isNumber()) continue;
+      dependency = (dependency ^ memoCache_->dependencyVersion(entry->slotDependencies[i])) *
+                   0x100000001b3ull;
+      dependency = (dependency ^ static_cast<std::uint64_t>(value.type)) * 0x100000001b3ull;
+      for (int c = 0; c < value.dimension(); ++c) {
+        std::uint64_t bits = 0;
+        std::memcpy(&bits, &value.v[c], sizeof(bits));
+        dependency = (dependency ^ bits) * 0x100000001b3ull;
+      }
+    }
+    memoKey.program = program.fingerprint();
+    memoKey.time = entry->timeSlot >= 0 ? slotScratch_[entry->timeSlot].asNumber() : 0.0;
+    memoKey.dependency = dependency;
+    if (memoCache_->lookup(memoKey, out)) {
+      evaluationCount_ += program.nodeCount();
+      return true;
+    }
+  }
+
+  if (ExpressionVM::run(program, slotScratch_.data(), out) != ExprVmStatus::Ok) {
+    return false;
+  }
+  if (memoize) memoCache_->insert(memoKey, out);
+  evaluationCount_ += program.nodeCount();
+  return true;
+}
+
+bool ExpressionEvaluator::Impl::runCompiledBatch(
+    const SharedPtr<ExprNode>& node, const std::map<std::string, ExprBatchBinding>& varying,
+    int count, ExprBatchResult& out, std::vector<ExprVmStatus>& laneStatus) {
+  if (!bytecodeEnabled_ || count <= 0) return false;
+  CompiledEntry* entry = compiledEntry(node);
+  if (!entry || !entry->program) return false;
+  const ExpressionProgram& program = *entry->program;
+  if (program.treeDepth() > recursionDepthLimit_) return false;
+
+  // Lanes past the remaining budget go through the AST, which reports the limit.
+  const int nodeCount = std::max(1, program.nodeCount());
+  const int vmLanes = std::min(count, std::max(0, evaluationBudget_ - evaluationCount_) / nodeCount);
+  if (vmLanes == 0) return false;
+
+  const auto& slots = program.slots();
+  bindSlots(*entry);
+  std::vector<ExprBatchBinding> bindings(slots.size());
+  for (size_t i = 0; i < slots.size(); ++i) {
+    const auto overridden = varying.find(slots[i].name);
+    if (overridden != varying.end()) {
+      bindings[i] = overridden->second;
+      continue;
+    }
+    const ExpressionValue* bound = entry->boundSlots[i];
+    ExprVmValue value;
+    if (!bound) {
+      if (!slots[i].optional) return false;
+    } else if (!toVmValue(*bound, value)) {
+      return false;
+    }
+    bindings[i] = ExprBatchBinding::uniformValue(value);
+  }
+
+  laneStatus.assign(static_cast<size_t>(count), ExprVmStatus::Fallback);
+  ExprBatchResult result = out;
+  result.status = laneStatus.data();
+  const int fallbackLanes = ExpressionVM::runBatch(program, bindings.data(), vmLanes, result);
+  evaluationCount_ += program.nodeCount() * (vmLanes - fallbackLanes);
+  return true;
+}
+
+static void storeBatchValue(ExprBatchResult& out, int lane, const ExpressionValue& value) {
+  ExprVmValue compiled;
+  if (toVmValue(value, compiled)) {
+    out.store(lane, compiled);
+    return;
+  }
+  // Strings, arrays and objects keep their type; components read as 0.
+  out.store(lane, ExprVmValue::null());
+  out.types[lane] = value.type();
+}
+
+static ExprVmValue batchLaneValue(const ExprBatchResult& batch, int lane) {
+  ExprVmValue value;
+  value.type = batch.types[lane];
+  const int dim = value.dimension();
+  for (int c = 0; c < dim; ++c) value.v[c] = batch.components[c][lane];
+  return value;
+}
+
 // Helper to merge variables
 static std::map<std::string, ExpressionValue>
 mergeVariables(const std::map<std::string, ExpressionValue> &a,
@@ -169,16 +387,6 @@ ExpressionEvaluator::Impl::evaluateNode(const SharedPtr<ExprNode> &node) {
   ++currentDepth_;
   ++evaluationCount_;
 
-  // Memoization
-  if (memoizationEnabled_ && node) {
-    size_t nodeHash = reinterpret_cast<size_t>(node.get()) ^
-                      std::hash<std::string_view>{}(std::string_view{error_.data(), error_.length()});
-    auto memoIt = memoCache_.find(nodeHash);
-    if (memoIt != memoCache_.end()) {
-      return memoIt->second;
-    }
-  }
-
   // Access impl_ directly since we're in the implementation
   // access node impl via public API
   // Note: we use the ExprNode public accessors to avoid depending on Impl type
@@ -484,8 +692,8 @@ ExpressionEvaluator::~ExpressionEvaluator() { delete impl_; }
 
 ExpressionValue ExpressionEvaluator::evaluate(const std::string &expression) {
   impl_->error_.clear();
-  auto ast = impl_->parser_.parse(expression);
-  if (impl_->parser_.hasError()) {
+  auto ast = impl_->parseCached(expression);
+  if (!ast) {
     impl_->error_ = ZeroString(impl_->parser_.getError());
     return ExpressionValue();
   }
@@ -500,12 +708,20 @@ ExpressionValue
 ExpressionEvaluator::evaluateAST(const SharedPtr<ExprNode> &node) {
   impl_->error_.clear();
   impl_->cancelRequested_ = false;
+  ExprVmValue compiled;
+  if (impl_->tryEvaluateCompiled(node, nullptr, compiled)) return fromVmValue(compiled);
   return impl_->evaluateNode(node);
 }
 
 void ExpressionEvaluator::setVariable(const std::string &name,
                                       const ExpressionValue &value) {
-  impl_->variables_[name] = value;
+  auto it = impl_->variables_.find(name);
+  if (it != impl_->variables_.end()) {
+    it->second = value;
+    return;
+  }
+  impl_->variables_.emplace(name, value);
+  ++impl_->variablesLayoutVersion_;
 }
 
 std::map<std::string, ExpressionValue>
@@ -516,6 +732,7 @@ ExpressionEvaluator::getVariablesCopy() const {
 void ExpressionEvaluator::setVariables(
     const std::map<std::string, ExpressionValue> &vars) {
   impl_->variables_ = vars;
+  ++impl_->variablesLayoutVersion_;
 }
 
 void ExpressionEvaluator::requestCancel() { impl_->cancelRequested_ = true; }
@@ -535,7 +752,10 @@ bool ExpressionEvaluator::hasVariable(const std::string &name) const {
   return impl_->variables_.find(name) != impl_->variables_.end();
 }
 
-void ExpressionEvaluator::clearVariables() { impl_->variables_.clear(); }
+void ExpressionEvaluator::clearVariables() {
+  impl_->variables_.clear();
+  ++impl_->variablesLayoutVersion_;
+}
 
 void ExpressionEvaluator::setTemporalValueResolver(
     TemporalValueResolver resolver) {
@@ -551,10 +771,28 @@ ExpressionValue ExpressionEvaluator::resolveValueAtTime(
 void ExpressionEvaluator::registerFunction(const std::string &name,
                                            BuiltinFunction func) {
   impl_->functions_[name] = func;
+  if (impl_->registeringStandardFunctions_) return;
+
+  // A host function may shadow a builtin the VM implements natively.
+  auto& hostNames = impl_->hostFunctionNames_;
+  if (std::find(hostNames.begin(), hostNames.end(), name) == hostNames.end()) {
+    hostNames.push_back(name);
+    impl_->compiler_.setExcludedFunctions(hostNames);
+    impl_->compiledCache_.clear();
+  }
 }
 
 void ExpressionEvaluator::registerStandardFunctions() {
   using namespace BuiltinFunctions;
+  struct StandardRegistrationScope {
+    bool& flag;
+    ~StandardRegistrationScope() { flag = false; }
+  } scope{impl_->registeringStandardFunctions_};
+  impl_->registeringStandardFunctions_ = true;
+  impl_->hostFunctionNames_.clear();
+  impl_->compiler_.setExcludedFunctions({});
+  impl_->compiledCache_.clear();
+
   registerFunction("sin", Sin);
   registerFunction("cos", Cos);
   registerFunction("tan", Tan);
@@ -625,7 +863,35 @@ int ExpressionEvaluator::currentEvaluationCount() const {
 
 void ExpressionEvaluator::setMemoizationEnabled(bool enabled) {
     impl_->memoizationEnabled_ = enabled;
-    if (!enabled) impl_->memoCache_.clear();
+}
+
+void ExpressionEvaluator::setMemoCache(ExpressionMemoCache* cache) {
+    impl_->memoCache_ = cache ? cache : &ExpressionMemoCache::shared();
+}
+
+ExpressionMemoCache& ExpressionEvaluator::memoCache() const {
+    return *impl_->memoCache_;
+}
+
+void ExpressionEvaluator::setBytecodeEnabled(bool enabled) {
+    impl_->bytecodeEnabled_ = enabled;
+    if (!enabled) clearCompiledCache();
+}
+
+bool ExpressionEvaluator::bytecodeEnabled() const {
+    return impl_->bytecodeEnabled_;
+}
+
+void ExpressionEvaluator::clearCompiledCache() {
+    impl_->compiledCache_.clear();
+    impl_->parsedCache_.clear();
+}
+
+SharedPtr<ExpressionProgram>
+ExpressionEvaluator::compiledProgram(const SharedPtr<ExprNode>& node) {
+    if (!impl_->bytecodeEnabled_) return nullptr;
+    auto* entry = impl_->compiledEntry(node);
+    return entry ? entry->program : nullptr;
 }
 
 bool ExpressionEvaluator::memoizationEnabled() const {
@@ -633,7 +899,7 @@ bool ExpressionEvaluator::memoizationEnabled() const {
 }
 
 void ExpressionEvaluator::clearMemoCache() {
-    impl_->memoCache_.clear();
+    impl_->memoCache_->clear();
 }
 
 ZeroString ExpressionEvaluator::getErrorZero() const { return impl_->error_; }
@@ -744,8 +1010,8 @@ double ExpressionEvaluator::estimateSpeedAtTime(const std::string& expression, d
 
 ExpressionValue ExpressionEvaluator::evaluateAtTime(const std::string& expression, double timeSec) {
     impl_->error_.clear();
-    auto ast = impl_->parser_.parse(expression);
-    if (impl_->parser_.hasError()) {
+    auto ast = impl_->parseCached(expression);
+    if (!ast) {
         impl_->error_ = ZeroString(impl_->parser_.getError());
         return ExpressionValue();
     }
@@ -756,12 +1022,17 @@ ExpressionValue ExpressionEvaluator::evaluateASTAtTime(const SharedPtr<ExprNode>
     impl_->error_.clear();
     impl_->cancelRequested_ = false;
 
+    // The compiled path binds `time` directly and leaves variables_ untouched.
+    ExprVmValue compiled;
+    if (impl_->tryEvaluateCompiled(node, &timeSec, compiled)) return fromVmValue(compiled);
+
     // Save and override time variable
     auto timeIt = impl_->variables_.find("time");
     bool hadTime = (timeIt != impl_->variables_.end());
     ExpressionValue savedTime;
     if (hadTime) savedTime = timeIt->second;
     impl_->variables_["time"] = ExpressionValue(timeSec);
+    if (!hadTime) ++impl_->variablesLayoutVersion_;
 
     ExpressionValue result = impl_->evaluateNode(node);
 
@@ -770,11 +1041,119 @@ ExpressionValue ExpressionEvaluator::evaluateASTAtTime(const SharedPtr<ExprNode>
         impl_->variables_["time"] = savedTime;
     } else {
         impl_->variables_.erase("time");
+        ++impl_->variablesLayoutVersion_;
     }
 
     return result;
 }
 
+void ExpressionEvaluator::evaluateASTAtTimes(const SharedPtr<ExprNode>& node,
+                                             const double* times, int count,
+                                             ExprBatchResult& out) {
+    impl_->error_.clear();
+    impl_->cancelRequested_ = false;
+    if (!times || count <= 0 || !out.types) return;
+
+    const std::map<std::string, ExprBatchBinding> varying{
+        {"time", ExprBatchBinding::varying(ExprValueType::Number, times)}};
+    std::vector<ExprVmStatus> laneStatus;
+    const bool compiled = impl_->runCompiledBatch(node, varying, count, out, laneStatus);
+
+    ZeroString firstError;
+    for (int i = 0; i < count; ++i) {
+        if (compiled && laneStatus[static_cast<size_t>(i)] == ExprVmStatus::Ok) {
+            if (out.status) out.status[i] = ExprVmStatus::Ok;
+            continue;
+        }
+        storeBatchValue(out, i, evaluateASTAtTime(node, times[i]));
+        if (firstError.length() == 0) firstError = impl_->error_;
+    }
+    impl_->error_ = firstError;
+}
+
+std::vector<ExpressionValue>
+ExpressionEvaluator::evaluateASTAtTimes(const SharedPtr<ExprNode>& node,
+                                        const std::vector<double>& times) {
+    impl_->error_.clear();
+    impl_->cancelRequested_ = false;
+    const int count = static_cast<int>(times.size());
+    std::vector<ExpressionValue> results(times.size());
+    if (count == 0) return results;
+
+    std::vector<ExprValueType> types(times.size());
+    std::vector<double> components[4];
+    ExprBatchResult batch;
+    batch.types = types.data();
+    for (int c = 0; c < 4; ++c) {
+        components[c].resize(times.size());
+        batch.components[c] = components[c].data();
+    }
+
+    const std::map<std::string, ExprBatchBinding> varying{
+        {"time", ExprBatchBinding::varying(ExprValueType::Number, times.data())}};
+    std::vector<ExprVmStatus> laneStatus;
+    const bool compiled = impl_->runCompiledBatch(node, varying, count, batch, laneStatus);
+
+    ZeroString firstError;
+    for (int i = 0; i < count; ++i) {
+        const size_t lane = static_cast<size_t>(i);
+        if (compiled && laneStatus[lane] == ExprVmStatus::Ok) {
+            results[lane] = fromVmValue(batchLaneValue(batch, i));
+            continue;
+        }
+        // Non-representable results (strings, arrays) keep their full value here.
+        results[lane] = evaluateASTAtTime(node, times[lane]);
+        if (firstError.length() == 0) firstError = impl_->error_;
+    }
+    impl_->error_ = firstError;
+    return results;
+}
+
+void ExpressionEvaluator::evaluateASTBatch(
+    const SharedPtr<ExprNode>& node,
+    const std::map<std::string, ExprBatchBinding>& varying,
+    int count, ExprBatchResult& out) {
+    impl_->error_.clear();
+    impl_->cancelRequested_ = false;
+    if (count <= 0 || !out.types) return;
+
+    std::vector<ExprVmStatus> laneStatus;
+    const bool compiled = impl_->runCompiledBatch(node, varying, count, out, laneStatus);
+
+    // AST lanes see their per-lane values through variables_; restore afterwards.
+    std::vector<std::pair<std::string, std::optional<ExpressionValue>>> saved;
+    ZeroString firstError;
+    for (int i = 0; i < count; ++i) {
+        if (compiled && laneStatus[static_cast<size_t>(i)] == ExprVmStatus::Ok) {
+            if (out.status) out.status[i] = ExprVmStatus::Ok;
+            continue;
+        }
+        if (saved.empty()) {
+            for (const auto& [name, binding] : varying) {
+                const auto it = impl_->variables_.find(name);
+                saved.emplace_back(name, it != impl_->variables_.end()
+                                             ? std::optional<ExpressionValue>(it->second)
+                                             : std::nullopt);
+            }
+        }
+        for (const auto& [name, binding] : varying) {
+            setVariable(name, fromVmValue(binding.lane(i)));
+        }
+        storeBatchValue(out, i, evaluateAST(node));
+        if (firstError.length() == 0) firstError = impl_->error_;
+    }
+
+    for (const auto& [name, value] : saved) {
+        if (value) {
+            impl_->variables_[name] = *value;
+        } else {
+            impl_->variables_.erase(name);
+            ++impl_->variablesLayoutVersion_;
+        }
+    }
+    impl_->error_ = firstError;
+}
+
 std::vector<std::pair<double, ExpressionValue>>
 ExpressionEvaluator::evaluateOverRange(
     const std::string& expression,
@@ -784,14 +1163,29 @@ ExpressionEvaluator::evaluateOverRange(
 
     NamedVector<std::pair<double, ExpressionValue>> results;
 
+    // Fixed sample sets are evaluated as one batch over the parsed AST.
+    auto evaluateSamples = [&](const std::vector<double>& times) {
+        impl_->error_.clear();
+        auto ast = impl_->parseCached(expression);
+        if (!ast) {
+            impl_->error_ = ZeroString(impl_->parser_.getError());
+            for (const double t : times) results.emplace_back(t, ExpressionValue());
+            return;
+        }
+        const auto values = evaluateASTAtTimes(ast, times);
+        for (size_t i = 0; i < times.size(); ++i) results.emplace_back(times[i], values[i]);
+    };
+
     if (mode == EvaluationMode::FrameLocked) {
         // Evaluate at each frame time (current behavior)
         const double frameDur = 1.0 / impl_->frameRate_;
+        std::vector<double> times;
         double t = startTimeSec;
         while (t <= endTimeSec + 1e-12) {
-            results.emplace_back(t, evaluateAtTime(expression, t));
+            times.push_back(t);
             t += frameDur;
         }
+        evaluateSamples(times);
     }
     else if (mode == EvaluationMode::SubframeSampled) {
         // Evaluate at the exact start and end, plus interpolated midpoints
@@ -802,10 +1196,12 @@ ExpressionEvaluator::evaluateOverRange(
         // Subdivide the range into fixed substeps
         const int steps = impl_->substepCount_;
         const double stepSize = (endTimeSec - startTimeSec) / steps;
+        std::vector<double> times;
+        times.reserve(static_cast<size_t>(steps) + 1);
         for (int i = 0; i <= steps; ++i) {
-            const double t = startTimeSec + i * stepSize;
-            results.emplace_back(t, evaluateAtTime(expression, t));
+            times.push_back(startTimeSec + i * stepSize);
         }
+        evaluateSamples(times);
     }
     else if (mode == EvaluationMode::AdaptiveStep) {
         // Adaptive step with speed-aware sizing + half-step error estimation.
@@ -0,0 +1,245 @@
+module;
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+module Script.Expression.MemoCache;
+
+import Script.Expression.Bytecode;
+
+namespace ArtifactCore {
+
+namespace {
+
+std::uint64_t mixBits(std::uint64_t x) {
+  // splitmix64 finalizer
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+std::uint64_t timeBits(double time) {
+  std::uint64_t bits = 0;
+  std::memcpy(&bits, &time, sizeof(bits));
+  return bits;
+}
+
+struct KeyHash {
+  size_t operator()(const ExprMemoKey& key) const {
+    return static_cast<size_t>(
+        mixBits(key.program ^ mixBits(timeBits(key.time) ^ mixBits(key.dependency))));
+  }
+};
+
+}
+
+bool ExprMemoKey::operator==(const ExprMemoKey& other) const {
+  // Bitwise time comparison so NaN keys can still hit.
+  return program == other.program && dependency == other.dependency &&
+         timeBits(time) == timeBits(other.time);
+}
+
+class ExpressionMemoCache::Impl {
+public:
+  // Each shard is a set-associative table: a key maps to one bucket of kWays
+  // entries and CLOCK runs inside the bucket. Storage is allocated once per
+  // capacity change, so lookups and inserts never allocate.
+  static constexpr size_t kWays = 8;
+
+  struct Entry {
+    ExprMemoKey key;
+    ExprVmValue value;
+    bool used = false;
+    bool referenced = false;
+  };
+
+  struct alignas(64) Shard {
+    mutable std::mutex mutex;
+    std::vector<Entry> entries;
+    std::vector<std::uint8_t> hands;
+    size_t bucketCount = 0;
+    size_t size = 0;
+
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t insertions = 0;
+    std::uint64_t evictions = 0;
+
+    void reset(size_t buckets) {
+      bucketCount = buckets;
+      entries.assign(bucketCount * kWays, Entry{});
+      hands.assign(bucketCount, 0);
+      size = 0;
+    }
+
+    Entry* bucket(size_t hash) {
+      // The low bits pick the shard; use the high bits for the bucket.
+      return entries.data() + ((hash >> 32) % bucketCount) * kWays;
+    }
+  };
+
+  static constexpr size_t kDependencySlots = 1024;
+
+  std::array<Shard, kShardCount> shards_;
+  std::array<std::atomic<std::uint64_t>, kDependencySlots> dependencyVersions_{};
+  std::atomic<std::uint64_t> generation_ = 1;
+  std::atomic<std::uint64_t> invalidations_ = 0;
+  std::atomic<size_t> capacity_ = 0;
+
+  void configure(size_t capacity) {
+    const size_t bucketsPerShard =
+        std::max<size_t>(1, (capacity + kShardCount * kWays - 1) / (kShardCount * kWays));
+    capacity_.store(bucketsPerShard * kWays * kShardCount, std::memory_order_relaxed);
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      shard.reset(bucketsPerShard);
+    }
+  }
+};
+
+ExpressionMemoCache::ExpressionMemoCache(std::size_t capacity) : impl_(new Impl()) {
+  impl_->configure(capacity);
+}
+
+ExpressionMemoCache::~ExpressionMemoCache() { delete impl_; }
+
+ExpressionMemoCache& ExpressionMemoCache::shared() {
+  static ExpressionMemoCache cache;
+  return cache;
+}
+
+bool ExpressionMemoCache::lookup(const ExprMemoKey& key, ExprVmValue& out) {
+  const size_t hash = KeyHash{}(key);
+  auto& shard = impl_->shards_[hash % kShardCount];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  Impl::Entry* bucket = shard.bucket(hash);
+  for (size_t way = 0; way < Impl::kWays; ++way) {
+    Impl::Entry& entry = bucket[way];
+    if (entry.used && entry.key == key) {
+      entry.referenced = true;
+      out = entry.value;
+      ++shard.hits;
+      return true;
+    }
+  }
+  ++shard.misses;
+  return false;
+}
+
+void ExpressionMemoCache::insert(const ExprMemoKey& key, const ExprVmValue& value) {
+  const size_t hash = KeyHash{}(key);
+  auto& shard = impl_->shards_[hash % kShardCount];
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  Impl::Entry* bucket = shard.bucket(hash);
+
+  Impl::Entry* freeEntry = nullptr;
+  for (size_t way = 0; way < Impl::kWays; ++way) {
+    Impl::Entry& entry = bucket[way];
+    if (entry.used && entry.key == key) {
+      entry.value = value;
+      return;
+    }
+    if (!entry.used && !freeEntry) freeEntry = &entry;
+  }
+
+  ++shard.insertions;
+  if (!freeEntry) {
+    // CLOCK: clear reference bits until an unreferenced way comes round.
+    std::uint8_t& hand = shard.hands[static_cast<size_t>(bucket - shard.entries.data()) / Impl::kWays];
+    while (bucket[hand].referenced) {
+      bucket[hand].referenced = false;
+      hand = static_cast<std::uint8_t>((hand + 1) % Impl::kWays);
+    }
+    freeEntry = &bucket[hand];
+    hand = static_cast<std::uint8_t>((hand + 1) % Impl::kWays);
+    ++shard.evictions;
+  } else {
+    ++shard.size;
+  }
+  *freeEntry = Impl::Entry{key, value, true, false};
+}
+
+void ExpressionMemoCache::invalidateAll() {
+  impl_->generation_.fetch_add(1, std::memory_order_acq_rel);
+  impl_->invalidations_.fetch_add(1, std::memory_order_relaxed);
+  clear();
+}
+
+void ExpressionMemoCache::clear() {
+  for (auto& shard : impl_->shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    for (auto& entry : shard.entries) entry.used = false;
+    std::fill(shard.hands.begin(), shard.hands.end(), std::uint8_t{0});
+    shard.size = 0;
+  }
+}
+
+std::uint64_t ExpressionMemoCache::generation() const {
+  return impl_->generation_.load(std::memory_order_acquire);
+}
+
+std::uint64_t ExpressionMemoCache::dependencyHash(std::string_view variableName) {
+  // FNV-1a
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  for (const char c : variableName) {
+    hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3ull;
+  }
+  return mixBits(hash);
+}
+
+void ExpressionMemoCache::invalidate(std::uint64_t dependencyHash) {
+  impl_->dependencyVersions_[dependencyHash % Impl::kDependencySlots].fetch_add(
+      1, std::memory_order_acq_rel);
+  impl_->invalidations_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t ExpressionMemoCache::dependencyVersion(std::uint64_t dependencyHash) const {
+  return impl_->dependencyVersions_[dependencyHash % Impl::kDependencySlots].load(
+      std::memory_order_acquire);
+}
+
+void ExpressionMemoCache::setCapacity(std::size_t capacity) {
+  impl_->configure(capacity);
+}
+
+std::size_t ExpressionMemoCache::capacity() const {
+  return impl_->capacity_.load(std::memory_order_relaxed);
+}
+
+ExprMemoStats ExpressionMemoCache::stats() const {
+  ExprMemoStats out;
+  for (const auto& shard : impl_->shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    out.hits += shard.hits;
+    out.misses += shard.misses;
+    out.insertions += shard.insertions;
+    out.evictions += shard.evictions;
+    out.size += shard.size;
+  }
+  out.invalidations = impl_->invalidations_.load(std::memory_order_relaxed);
+  out.capacity = capacity();
+  return out;
+}
+
+void ExpressionMemoCache::resetStats() {
+  for (auto& shard : impl_->shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.hits = 0;
+    shard.misses = 0;
+    shard.insertions = 0;
+    shard.evictions = 0;
+  }
+  impl_->invalidations_.store(0, std::memory_order_relaxed);
+}
+
+}
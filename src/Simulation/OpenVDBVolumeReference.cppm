@@ -124,8 +124,7 @@ bool copyOpenVDBDensityToPyro(const OpenVDBScalarSnapshot& snapshot, PyroFieldSe
         return false;
     }
     fields.resize(PyroResolution{snapshot.width, snapshot.height, snapshot.depth});
-    fields.densityStorage() = snapshot.values;
-    return true;
+    return fields.importDense(PyroFieldChannel::Density, snapshot.values);
 }
 
 } // namespace ArtifactCore
@@ -0,0 +1,297 @@
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+export module Core.Simulation.PyroCache.Test;
+
+import Core.Simulation.Pyro;
+import Core.Simulation.PyroCacheCodec;
+
+namespace ArtifactCore::PyroCacheTest {
+
+using namespace PyroCacheCodec;
+
+// xorshift64, so every run sees the same data.
+struct TestRandom {
+    std::uint64_t state = 0x9E3779B97F4A7C15ull;
+
+    std::uint32_t next() noexcept {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return static_cast<std::uint32_t>(state >> 16);
+    }
+
+    float uniform(float low, float high) noexcept {
+        return low + (high - low) * static_cast<float>(next() & 0xffffffu) / 16777215.0f;
+    }
+};
+
+bool ransRoundTrips(const std::vector<std::uint8_t>& raw) {
+    const auto coded = ransEncode(raw);
+    std::vector<std::uint8_t> decoded(raw.size(), 0xA5);
+    return ransDecode(coded, decoded) && decoded == raw;
+}
+
+bool ransRoundTripContractTest() {
+    TestRandom random;
+    std::vector<std::uint8_t> single(4096, 0);
+    std::vector<std::uint8_t> uniform(8191);
+    for (auto& byte : uniform) {
+        byte = static_cast<std::uint8_t>(random.next());
+    }
+    // Mostly zero with a long tail, like the upper byte planes of predicted residuals.
+    std::vector<std::uint8_t> skewed(10000);
+    for (auto& byte : skewed) {
+        const auto roll = random.next() % 1000;
+        byte = roll < 900 ? 0 : static_cast<std::uint8_t>(roll < 990 ? 1 + roll % 4 : random.next());
+    }
+    if (!ransRoundTrips(single) || !ransRoundTrips(uniform) || !ransRoundTrips(skewed)
+        || !ransRoundTrips({7}) || !ransRoundTrips({1, 2, 3})) {
+        return false;
+    }
+    // Compresses what it should, and rejects a stream cut short of its frequency table.
+    const auto coded = ransEncode(skewed);
+    std::vector<std::uint8_t> decoded(skewed.size());
+    return coded.size() < skewed.size() / 2
+        && !ransDecode(std::span<const std::uint8_t>(coded.data(), 20), decoded);
+}
+
+template <typename T>
+bool lorenzoRoundTrips(TestRandom& random) {
+    std::array<T, kBrickCells> codes{};
+    for (auto& code : codes) {
+        code = static_cast<T>(random.next());
+    }
+    auto residuals = codes;
+    differenceBrick(residuals.data());
+    integrateBrick(residuals.data());
+    return residuals == codes;
+}
+
+bool lorenzoContractTest() {
+    TestRandom random;
+    if (!lorenzoRoundTrips<std::uint8_t>(random) || !lorenzoRoundTrips<std::uint16_t>(random)
+        || !lorenzoRoundTrips<std::uint32_t>(random)) {
+        return false;
+    }
+    // The predictor is exact for a linear field away from the brick's low faces.
+    std::array<std::uint16_t, kBrickCells> ramp{};
+    for (std::size_t i = 0; i < kBrickCells; ++i) {
+        ramp[i] = static_cast<std::uint16_t>(1000 + 3 * (i & 7u) + 5 * ((i >> 3u) & 7u) + 7 * (i >> 6u));
+    }
+    differenceBrick(ramp.data());
+    for (std::size_t i = 0; i < kBrickCells; ++i) {
+        const bool interior = (i & 7u) != 0 && ((i >> 3u) & 7u) != 0 && (i >> 6u) != 0;
+        if (interior && ramp[i] != 0) {
+            return false;
+        }
+    }
+    return zigzag(std::uint16_t{0}) == 0 && zigzag(static_cast<std::uint16_t>(-1)) == 1
+        && zigzag(std::uint16_t{1}) == 2 && unzigzag(zigzag(static_cast<std::uint32_t>(-12345))) == static_cast<std::uint32_t>(-12345);
+}
+
+bool halfErrorBoundContractTest() {
+    // Every finite half survives float and back unchanged.
+    for (std::uint32_t code = 0; code < 0x10000u; ++code) {
+        const auto half = static_cast<std::uint16_t>(code);
+        if ((half & 0x7c00u) == 0x7c00u && (half & 0x3ffu) != 0) {
+            continue;
+        }
+        if (floatToHalf(halfToFloat(half)) != half) {
+            return false;
+        }
+    }
+    // Normal range: round to nearest keeps the relative error within 2^-11.
+    TestRandom random;
+    for (int i = 0; i < 100000; ++i) {
+        const float value = std::ldexp(random.uniform(1.0f, 2.0f), static_cast<int>(random.next() % 29) - 14)
+            * ((random.next() & 1u) ? -1.0f : 1.0f);
+        const float decoded = halfToFloat(floatToHalf(value));
+        if (std::fabs(decoded - value) > std::fabs(value) * 0x1p-11f) {
+            return false;
+        }
+    }
+    // Subnormals keep an absolute error of half a step; overflow saturates to infinity.
+    for (int i = 0; i < 10000; ++i) {
+        const float value = random.uniform(-6.0e-5f, 6.0e-5f);
+        if (std::fabs(halfToFloat(floatToHalf(value)) - value) > 0x1p-25f) {
+            return false;
+        }
+    }
+    return std::isinf(halfToFloat(floatToHalf(1.0e6f))) && std::isnan(halfToFloat(floatToHalf(std::nanf(""))))
+        && std::bit_cast<std::uint32_t>(halfToFloat(floatToHalf(-0.0f))) == 0x80000000u;
+}
+
+bool quantized8ErrorBoundContractTest() {
+    TestRandom random;
+    std::array<float, kBrickCells> values{};
+    std::array<std::uint8_t, kBrickCells> codes{};
+    std::array<float, kBrickCells> decoded{};
+    for (int brick = 0; brick < 64; ++brick) {
+        const float low = random.uniform(-10.0f, 0.0f);
+        const float high = low + random.uniform(1e-3f, 20.0f);
+        for (auto& value : values) {
+            value = random.uniform(low, high);
+        }
+        float storedLow = 0.0f;
+        float storedHigh = 0.0f;
+        quantizeBrick(values.data(), codes.data(), storedLow, storedHigh);
+        dequantizeBrick(codes.data(), storedLow, storedHigh, decoded.data());
+        const float range = storedHigh - storedLow;
+        const float bound = range / 510.0f + range * 1e-5f;
+        for (std::size_t i = 0; i < kBrickCells; ++i) {
+            if (std::fabs(decoded[i] - values[i]) > bound) {
+                return false;
+            }
+        }
+        // The brick minimum comes back exactly.
+        const auto lowest = std::min_element(values.begin(), values.end()) - values.begin();
+        if (decoded[static_cast<std::size_t>(lowest)] != values[static_cast<std::size_t>(lowest)]) {
+            return false;
+        }
+    }
+    // A constant brick is exact.
+    values.fill(0.25f);
+    float storedLow = 0.0f;
+    float storedHigh = 0.0f;
+    quantizeBrick(values.data(), codes.data(), storedLow, storedHigh);
+    dequantizeBrick(codes.data(), storedLow, storedHigh, decoded.data());
+    return std::all_of(decoded.begin(), decoded.end(), [](float value) { return value == 0.25f; });
+}
+
+std::filesystem::path testFile(const char* name) {
+    return std::filesystem::temp_directory_path() / name;
+}
+
+PyroFieldSnapshot makeSnapshot(TestRandom& random) {
+    PyroFieldSnapshot snapshot;
+    snapshot.resolution = {16, 16, 8};
+    snapshot.activeTiles = {0, 3};
+    const std::size_t cells = snapshot.activeTiles.size() * kBrickCells;
+    for (auto* field : {&snapshot.density, &snapshot.temperature, &snapshot.fuel, &snapshot.pressure, &snapshot.divergence}) {
+        field->resize(cells);
+        for (auto& value : *field) {
+            value = random.uniform(-1.0f, 4.0f);
+        }
+    }
+    // The second brick stays zero so the occupancy mask is exercised too.
+    std::fill(snapshot.density.begin() + kBrickCells, snapshot.density.end(), 0.0f);
+    snapshot.velocity.resize(cells);
+    for (auto& value : snapshot.velocity) {
+        value = {random.uniform(-3.0f, 3.0f), random.uniform(-3.0f, 3.0f), random.uniform(-3.0f, 3.0f)};
+    }
+    return snapshot;
+}
+
+bool sameBits(std::span<const float> a, std::span<const float> b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](float x, float y) {
+        return std::bit_cast<std::uint32_t>(x) == std::bit_cast<std::uint32_t>(y);
+    });
+}
+
+bool sameBits(const std::vector<PyroVec3>& a, const std::vector<PyroVec3>& b) {
+    return sameBits(std::span<const float>(reinterpret_cast<const float*>(a.data()), a.size() * 3),
+        std::span<const float>(reinterpret_cast<const float*>(b.data()), b.size() * 3));
+}
+
+bool sameSnapshot(const PyroFieldSnapshot& a, const PyroFieldSnapshot& b) {
+    return a.resolution.width == b.resolution.width && a.resolution.height == b.resolution.height
+        && a.resolution.depth == b.resolution.depth && a.activeTiles == b.activeTiles
+        && sameBits(a.density, b.density) && sameBits(a.temperature, b.temperature) && sameBits(a.fuel, b.fuel)
+        && sameBits(a.pressure, b.pressure) && sameBits(a.divergence, b.divergence) && sameBits(a.velocity, b.velocity);
+}
+
+// Default settings must restore simulation state bit for bit.
+bool defaultCacheIsLosslessContractTest() {
+    TestRandom random;
+    const auto snapshot = makeSnapshot(random);
+    const auto path = testFile("artifact_pyro_cache_test_v3.pyro");
+    PyroFieldSnapshot loaded;
+    bool ok = writePyroCacheFile(path, snapshot, PyroCacheSettings{});
+    {
+        PyroCacheFile file;
+        ok = ok && file.open(path) && file.version() == 3 && file.read(PyroFieldMask::All, loaded);
+    }
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    return ok && sameSnapshot(snapshot, loaded);
+}
+
+template <typename T>
+void appendRaw(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void appendArray(std::ofstream& out, const std::vector<T>& values) {
+    appendRaw(out, static_cast<std::uint64_t>(values.size()));
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+// Versions 1 and 2: magic, version, resolution, (v2: u64 tile count and the tiles), then each
+// channel as a u64 element count and raw values, in density..velocity order.
+bool writeLegacyFile(const std::filesystem::path& path, std::uint32_t version, const PyroFieldSnapshot& snapshot) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    appendRaw(out, std::uint32_t{0x5059524Fu});
+    appendRaw(out, version);
+    appendRaw(out, snapshot.resolution);
+    if (version == 2) {
+        appendArray(out, snapshot.activeTiles);
+    }
+    appendArray(out, snapshot.density);
+    appendArray(out, snapshot.temperature);
+    appendArray(out, snapshot.fuel);
+    appendArray(out, snapshot.pressure);
+    appendArray(out, snapshot.divergence);
+    appendArray(out, snapshot.velocity);
+    return static_cast<bool>(out);
+}
+
+bool legacyVersionReadContractTest() {
+    TestRandom random;
+    PyroFieldSnapshot bricked = makeSnapshot(random);
+    PyroFieldSnapshot dense = bricked;
+    dense.resolution = {8, 8, 16};
+    dense.activeTiles.clear();
+
+    bool ok = true;
+    for (const std::uint32_t version : {1u, 2u}) {
+        const auto& expected = version == 1 ? dense : bricked;
+        const auto path = testFile(version == 1 ? "artifact_pyro_cache_test_v1.pyro" : "artifact_pyro_cache_test_v2.pyro");
+        PyroFieldSnapshot loaded;
+        PyroFieldSnapshot densityOnly;
+        ok = ok && writeLegacyFile(path, version, expected);
+        {
+            PyroCacheFile file;
+            ok = ok && file.open(path) && file.version() == version && file.read(PyroFieldMask::All, loaded)
+                && file.read(PyroFieldMask::Density, densityOnly);
+        }
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        ok = ok && sameSnapshot(expected, loaded) && sameBits(expected.density, densityOnly.density)
+            && densityOnly.velocity.empty();
+    }
+    return ok;
+}
+
+export bool runAllPyroCacheTests() {
+    return ransRoundTripContractTest() &&
+        lorenzoContractTest() &&
+        halfErrorBoundContractTest() &&
+        quantized8ErrorBoundContractTest() &&
+        defaultCacheIsLosslessContractTest() &&
+        legacyVersionReadContractTest();
+}
+
+} // namespace ArtifactCore::PyroCacheTest
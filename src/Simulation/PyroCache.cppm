@@ -0,0 +1,924 @@
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+module Core.Simulation.Pyro;
+
+import Core.Parallel;
+import Core.Simulation.PyroCacheCodec;
+
+namespace ArtifactCore {
+
+namespace {
+
+using namespace PyroCacheCodec;
+
+// Version 3 layout, little-endian:
+//   u32 magic, u32 version, PyroResolution, u32 brick count, u32 field count,
+//   u32 tile index per brick, then per field {u8 channel, u8 encoding, u16 0, u32 0, u64 offset, u64 bytes}.
+// A field blob is u32 segment count and the u64 end offset of each segment, followed by the
+// segments. A segment covers up to kSegmentBricks bricks: u32 brick count, one bit per brick
+// that is stored (all-zero bricks are not), the (min, max) pairs of each stored brick for
+// Quantized8, then one stream per byte plane of the predicted codes.
+constexpr std::uint32_t kCacheMagic = 0x5059524Fu; // PYRO
+constexpr std::uint32_t kCacheVersion = 3;
+static_assert(kBrickCells == PyroTileGrid::kTileCells);
+constexpr std::size_t kSegmentBricks = 128;
+
+constexpr std::array<PyroFieldChannel, 6> kCachedChannels{
+    PyroFieldChannel::Density, PyroFieldChannel::Temperature, PyroFieldChannel::Fuel,
+    PyroFieldChannel::Pressure, PyroFieldChannel::Divergence, PyroFieldChannel::Velocity};
+
+PyroFieldMask fieldMask(PyroFieldChannel channel) noexcept {
+    return static_cast<PyroFieldMask>(1u << static_cast<std::uint32_t>(channel));
+}
+
+bool isCachedChannel(std::uint8_t channel) noexcept {
+    return channel <= static_cast<std::uint8_t>(PyroFieldChannel::Velocity);
+}
+
+int componentCount(PyroFieldChannel channel) noexcept {
+    return channel == PyroFieldChannel::Velocity ? 3 : 1;
+}
+
+int planeCount(PyroCacheEncoding encoding) noexcept {
+    switch (encoding) {
+    case PyroCacheEncoding::Quantized8: return 1;
+    case PyroCacheEncoding::Half: return 2;
+    case PyroCacheEncoding::Float32: return 4;
+    }
+    return 0;
+}
+
+std::vector<float>* scalarField(PyroFieldSnapshot& snapshot, PyroFieldChannel channel) noexcept {
+    switch (channel) {
+    case PyroFieldChannel::Density: return &snapshot.density;
+    case PyroFieldChannel::Temperature: return &snapshot.temperature;
+    case PyroFieldChannel::Fuel: return &snapshot.fuel;
+    case PyroFieldChannel::Pressure: return &snapshot.pressure;
+    case PyroFieldChannel::Divergence: return &snapshot.divergence;
+    default: return nullptr;
+    }
+}
+
+const std::vector<float>* scalarField(const PyroFieldSnapshot& snapshot, PyroFieldChannel channel) noexcept {
+    return scalarField(const_cast<PyroFieldSnapshot&>(snapshot), channel);
+}
+
+std::size_t fieldSize(const PyroFieldSnapshot& snapshot, PyroFieldChannel channel) noexcept {
+    const auto* scalar = scalarField(snapshot, channel);
+    return scalar ? scalar->size() : snapshot.velocity.size();
+}
+
+float& component(PyroVec3& value, int index) noexcept {
+    return index == 0 ? value.x : (index == 1 ? value.y : value.z);
+}
+
+float component(const PyroVec3& value, int index) noexcept {
+    return index == 0 ? value.x : (index == 1 ? value.y : value.z);
+}
+
+template <typename T>
+void appendResiduals(const T* codes, std::vector<std::vector<std::uint8_t>>& planes) {
+    std::array<T, kBrickCells> residuals;
+    std::copy_n(codes, kBrickCells, residuals.begin());
+    differenceBrick(residuals.data());
+    for (std::size_t plane = 0; plane < sizeof(T); ++plane) {
+        auto& out = planes[plane];
+        const auto at = out.size();
+        out.resize(at + kBrickCells);
+        for (std::size_t i = 0; i < kBrickCells; ++i) {
+            out[at + i] = static_cast<std::uint8_t>(zigzag(residuals[i]) >> (plane * 8u));
+        }
+    }
+}
+
+template <typename T>
+void readResiduals(const std::vector<std::vector<std::uint8_t>>& planes, std::size_t offset, T* codes) noexcept {
+    std::fill_n(codes, kBrickCells, T{0});
+    for (std::size_t plane = 0; plane < sizeof(T); ++plane) {
+        const std::uint8_t* in = planes[plane].data() + offset;
+        for (std::size_t i = 0; i < kBrickCells; ++i) {
+            codes[i] = static_cast<T>(codes[i] | static_cast<T>(static_cast<T>(in[i]) << (plane * 8u)));
+        }
+    }
+    for (std::size_t i = 0; i < kBrickCells; ++i) {
+        codes[i] = unzigzag(codes[i]);
+    }
+    integrateBrick(codes);
+}
+
+// Stream: u8 mode (0 = stored, 1 = rANS), u32 raw size, and for rANS a u32 coded size.
+void appendStream(std::vector<std::uint8_t>& out, std::span<const std::uint8_t> raw, bool entropyCoding) {
+    if (entropyCoding && !raw.empty()) {
+        const auto coded = ransEncode(raw);
+        if (coded.size() < raw.size()) {
+            append(out, std::uint8_t{1});
+            append(out, static_cast<std::uint32_t>(raw.size()));
+            append(out, static_cast<std::uint32_t>(coded.size()));
+            out.insert(out.end(), coded.begin(), coded.end());
+            return;
+        }
+    }
+    append(out, std::uint8_t{0});
+    append(out, static_cast<std::uint32_t>(raw.size()));
+    out.insert(out.end(), raw.begin(), raw.end());
+}
+
+bool readStream(ByteReader& in, std::vector<std::uint8_t>& raw, std::size_t expectedBytes) {
+    std::uint8_t mode = 0;
+    std::uint32_t rawBytes = 0;
+    if (!in.read(mode) || !in.read(rawBytes) || rawBytes != expectedBytes) {
+        return false;
+    }
+    raw.resize(rawBytes);
+    if (mode == 0) {
+        const auto* bytes = in.take(rawBytes);
+        if (!bytes) {
+            return false;
+        }
+        std::copy_n(bytes, rawBytes, raw.begin());
+        return true;
+    }
+    std::uint32_t codedBytes = 0;
+    if (mode != 1 || !in.read(codedBytes)) {
+        return false;
+    }
+    const auto* coded = in.take(codedBytes);
+    return coded && ransDecode({coded, codedBytes}, raw);
+}
+
+// One field of a snapshot seen as bricks of per-component values.
+struct FieldColumns {
+    const float* scalar = nullptr;
+    const PyroVec3* vector = nullptr;
+
+    void load(std::size_t brick, int index, float* out) const noexcept {
+        const std::size_t base = brick * kBrickCells;
+        for (std::size_t i = 0; i < kBrickCells; ++i) {
+            out[i] = scalar ? scalar[base + i] : component(vector[base + i], index);
+        }
+    }
+};
+
+struct MutableFieldColumns {
+    float* scalar = nullptr;
+    PyroVec3* vector = nullptr;
+
+    void store(std::size_t brick, int index, const float* in) const noexcept {
+        const std::size_t base = brick * kBrickCells;
+        for (std::size_t i = 0; i < kBrickCells; ++i) {
+            if (scalar) {
+                scalar[base + i] = in[i];
+            } else {
+                component(vector[base + i], index) = in[i];
+            }
+        }
+    }
+};
+
+std::vector<std::uint8_t> encodeSegment(const FieldColumns& field, int components, std::size_t firstBrick,
+    std::size_t brickCount, PyroCacheEncoding encoding, bool entropyCoding) {
+    const int planes = planeCount(encoding);
+    std::vector<std::uint8_t> occupancy((brickCount + 7) / 8, 0);
+    std::vector<float> ranges;
+    std::vector<std::vector<std::uint8_t>> planeBytes(static_cast<std::size_t>(planes));
+    std::vector<float> values(static_cast<std::size_t>(components) * kBrickCells);
+    std::array<std::uint8_t, kBrickCells> bytes{};
+    std::array<std::uint16_t, kBrickCells> halves{};
+    std::array<std::uint32_t, kBrickCells> words{};
+
+    for (std::size_t b = 0; b < brickCount; ++b) {
+        for (int c = 0; c < components; ++c) {
+            field.load(firstBrick + b, c, values.data() + static_cast<std::size_t>(c) * kBrickCells);
+        }
+        if (std::all_of(values.begin(), values.end(), [](float value) { return std::bit_cast<std::uint32_t>(value) == 0u; })) {
+            continue;
+        }
+        occupancy[b >> 3u] |= static_cast<std::uint8_t>(1u << (b & 7u));
+
+        for (int c = 0; c < components; ++c) {
+            const float* in = values.data() + static_cast<std::size_t>(c) * kBrickCells;
+            switch (encoding) {
+            case PyroCacheEncoding::Quantized8: {
+                float low = 0.0f;
+                float high = 0.0f;
+                quantizeBrick(in, bytes.data(), low, high);
+                ranges.push_back(low);
+                ranges.push_back(high);
+                appendResiduals(bytes.data(), planeBytes);
+                break;
+            }
+            case PyroCacheEncoding::Half:
+                for (std::size_t i = 0; i < kBrickCells; ++i) {
+                    halves[i] = floatToHalf(in[i]);
+                }
+                appendResiduals(halves.data(), planeBytes);
+                break;
+            case PyroCacheEncoding::Float32:
+                for (std::size_t i = 0; i < kBrickCells; ++i) {
+                    words[i] = std::bit_cast<std::uint32_t>(in[i]);
+                }
+                appendResiduals(words.data(), planeBytes);
+                break;
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> out;
+    append(out, static_cast<std::uint32_t>(brickCount));
+    out.insert(out.end(), occupancy.begin(), occupancy.end());
+    const auto* rangeBytes = reinterpret_cast<const std::uint8_t*>(ranges.data());
+    out.insert(out.end(), rangeBytes, rangeBytes + ranges.size() * sizeof(float));
+    for (const auto& plane : planeBytes) {
+        appendStream(out, plane, entropyCoding);
+    }
+    return out;
+}
+
+bool decodeSegment(ByteReader in, const MutableFieldColumns& field, int components, std::size_t firstBrick,
+    std::size_t brickCount, PyroCacheEncoding encoding) {
+    std::uint32_t storedCount = 0;
+    if (!in.read(storedCount) || storedCount != brickCount) {
+        return false;
+    }
+    const auto* occupancy = in.take((brickCount + 7) / 8);
+    if (!occupancy) {
+        return false;
+    }
+    std::size_t stored = 0;
+    for (std::size_t b = 0; b < brickCount; ++b) {
+        stored += (occupancy[b >> 3u] >> (b & 7u)) & 1u;
+    }
+    const std::size_t rangeCount = encoding == PyroCacheEncoding::Quantized8 ? stored * static_cast<std::size_t>(components) * 2 : 0;
+    const auto* ranges = in.take(rangeCount * sizeof(float));
+    std::vector<std::vector<std::uint8_t>> planes(static_cast<std::size_t>(planeCount(encoding)));
+    if (!ranges) {
+        return false;
+    }
+    for (auto& plane : planes) {
+        if (!readStream(in, plane, stored * static_cast<std::size_t>(components) * kBrickCells)) {
+            return false;
+        }
+    }
+
+    std::array<float, kBrickCells> values{};
+    std::array<std::uint8_t, kBrickCells> bytes{};
+    std::array<std::uint16_t, kBrickCells> halves{};
+    std::array<std::uint32_t, kBrickCells> words{};
+    std::size_t block = 0;
+    for (std::size_t b = 0; b < brickCount; ++b) {
+        if (((occupancy[b >> 3u] >> (b & 7u)) & 1u) == 0) {
+            continue;
+        }
+        for (int c = 0; c < components; ++c, ++block) {
+            const std::size_t offset = block * kBrickCells;
+            switch (encoding) {
+            case PyroCacheEncoding::Quantized8: {
+                float low = 0.0f;
+                float high = 0.0f;
+                std::memcpy(&low, ranges + block * 2 * sizeof(float), sizeof(float));
+                std::memcpy(&high, ranges + (block * 2 + 1) * sizeof(float), sizeof(float));
+                readResiduals(planes, offset, bytes.data());
+                dequantizeBrick(bytes.data(), low, high, values.data());
+                break;
+            }
+            case PyroCacheEncoding::Half:
+                readResiduals(planes, offset, halves.data());
+                for (std::size_t i = 0; i < kBrickCells; ++i) {
+                    values[i] = halfToFloat(halves[i]);
+                }
+                break;
+            case PyroCacheEncoding::Float32:
+                readResiduals(planes, offset, words.data());
+                for (std::size_t i = 0; i < kBrickCells; ++i) {
+                    values[i] = std::bit_cast<float>(words[i]);
+                }
+                break;
+            }
+            field.store(firstBrick + b, c, values.data());
+        }
+    }
+    return true;
+}
+
+std::vector<std::uint8_t> encodeField(const PyroFieldSnapshot& snapshot, PyroFieldChannel channel,
+    PyroCacheEncoding encoding, bool entropyCoding) {
+    FieldColumns field{};
+    if (const auto* scalar = scalarField(snapshot, channel)) {
+        field.scalar = scalar->data();
+    } else {
+        field.vector = snapshot.velocity.data();
+    }
+    const int components = componentCount(channel);
+    const std::size_t bricks = snapshot.activeTiles.size();
+    const std::size_t segments = (bricks + kSegmentBricks - 1) / kSegmentBricks;
+
+    std::vector<std::vector<std::uint8_t>> encoded(segments);
+    Parallel::ForRange(0, static_cast<int>(segments), 1, [&](ParallelRange range) {
+        for (int segment = range.begin; segment < range.end; ++segment) {
+            const std::size_t first = static_cast<std::size_t>(segment) * kSegmentBricks;
+            encoded[static_cast<std::size_t>(segment)] =
+                encodeSegment(field, components, first, std::min(kSegmentBricks, bricks - first), encoding, entropyCoding);
+        }
+    });
+
+    std::vector<std::uint8_t> blob;
+    append(blob, static_cast<std::uint32_t>(segments));
+    std::uint64_t end = 0;
+    for (const auto& segment : encoded) {
+        end += segment.size();
+        append(blob, end);
+    }
+    for (const auto& segment : encoded) {
+        blob.insert(blob.end(), segment.begin(), segment.end());
+    }
+    return blob;
+}
+
+}
+
+PyroCacheEncoding PyroCacheSettings::encoding(PyroFieldChannel channel) const noexcept {
+    switch (channel) {
+    case PyroFieldChannel::Density: return density;
+    case PyroFieldChannel::Temperature: return temperature;
+    case PyroFieldChannel::Fuel: return fuel;
+    case PyroFieldChannel::Pressure: return pressure;
+    case PyroFieldChannel::Divergence: return divergence;
+    case PyroFieldChannel::Velocity: return velocity;
+    case PyroFieldChannel::Color: break;
+    }
+    return PyroCacheEncoding::Float32;
+}
+
+bool writePyroCacheFile(const std::filesystem::path& path, const PyroFieldSnapshot& snapshot,
+    const PyroCacheSettings& settings) {
+    // Dense (version 1) snapshots are cut into bricks first.
+    const PyroFieldSnapshot* source = &snapshot;
+    PyroFieldSnapshot bricked;
+    if (snapshot.activeTiles.empty() && !snapshot.density.empty()) {
+        PyroFieldSet fields;
+        if (!fields.restore(snapshot)) {
+            return false;
+        }
+        bricked = fields.capture();
+        source = &bricked;
+    }
+    const std::size_t bricks = source->activeTiles.size();
+    for (const auto channel : kCachedChannels) {
+        if (fieldSize(*source, channel) != bricks * kBrickCells) {
+            return false;
+        }
+    }
+
+    std::vector<std::vector<std::uint8_t>> blobs;
+    blobs.reserve(kCachedChannels.size());
+    for (const auto channel : kCachedChannels) {
+        blobs.push_back(encodeField(*source, channel, settings.encoding(channel), settings.entropyCoding));
+    }
+
+    std::vector<std::uint8_t> header;
+    append(header, kCacheMagic);
+    append(header, kCacheVersion);
+    append(header, source->resolution);
+    append(header, static_cast<std::uint32_t>(bricks));
+    append(header, static_cast<std::uint32_t>(kCachedChannels.size()));
+    for (const auto tile : source->activeTiles) {
+        append(header, tile);
+    }
+    std::uint64_t offset = header.size() + kCachedChannels.size() * 24;
+    for (std::size_t i = 0; i < kCachedChannels.size(); ++i) {
+        append(header, static_cast<std::uint8_t>(kCachedChannels[i]));
+        append(header, static_cast<std::uint8_t>(settings.encoding(kCachedChannels[i])));
+        append(header, std::uint16_t{0});
+        append(header, std::uint32_t{0});
+        append(header, offset);
+        append(header, static_cast<std::uint64_t>(blobs[i].size()));
+        offset += blobs[i].size();
+    }
+
+    auto temporary = path;
+    temporary += ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+        for (const auto& blob : blobs) {
+            out.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+        }
+        if (!out) {
+            out.close();
+            std::error_code ec;
+            std::filesystem::remove(temporary, ec);
+            return false;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temporary, path, ec);
+    if (ec) {
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    return true;
+}
+
+PyroCacheFile::~PyroCacheFile() { close(); }
+
+PyroCacheFile::PyroCacheFile(PyroCacheFile&& other) noexcept { *this = std::move(other); }
+
+PyroCacheFile& PyroCacheFile::operator=(PyroCacheFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+        version_ = std::exchange(other.version_, 0);
+        resolution_ = std::exchange(other.resolution_, {});
+        activeTiles_ = std::move(other.activeTiles_);
+        entries_ = std::move(other.entries_);
+    }
+    return *this;
+}
+
+bool PyroCacheFile::open(const std::filesystem::path& path) {
+    close();
+#if defined(_WIN32)
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0) {
+        CloseHandle(file);
+        return false;
+    }
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    data_ = static_cast<const std::uint8_t*>(view);
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    mapping_ = mapping;
+#else
+    const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) {
+        return false;
+    }
+    struct stat info {};
+    if (::fstat(file, &info) != 0 || info.st_size <= 0) {
+        ::close(file);
+        return false;
+    }
+    void* view = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+    data_ = static_cast<const std::uint8_t*>(view);
+    size_ = static_cast<std::size_t>(info.st_size);
+#endif
+    if (!parse()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PyroCacheFile::close() noexcept {
+    if (data_) {
+#if defined(_WIN32)
+        UnmapViewOfFile(data_);
+        CloseHandle(static_cast<HANDLE>(mapping_));
+#else
+        ::munmap(const_cast<std::uint8_t*>(data_), size_);
+#endif
+    }
+    data_ = nullptr;
+    size_ = 0;
+    mapping_ = nullptr;
+    version_ = 0;
+    resolution_ = {};
+    activeTiles_.clear();
+    entries_.clear();
+}
+
+bool PyroCacheFile::parse() {
+    ByteReader in{data_, size_};
+    std::uint32_t magic = 0;
+    if (!in.read(magic) || !in.read(version_) || magic != kCacheMagic
+        || version_ < 1 || version_ > kCacheVersion || !in.read(resolution_)) {
+        return false;
+    }
+    if (resolution_.width < 0 || resolution_.height < 0 || resolution_.depth < 0) {
+        return false;
+    }
+
+    const auto readTiles = [&](std::uint64_t count) {
+        if (count > (in.size - in.at) / sizeof(std::uint32_t)) {
+            return false;
+        }
+        activeTiles_.resize(static_cast<std::size_t>(count));
+        const auto* tiles = in.take(count * sizeof(std::uint32_t));
+        if (count > 0) {
+            std::memcpy(activeTiles_.data(), tiles, activeTiles_.size() * sizeof(std::uint32_t));
+        }
+        return true;
+    };
+
+    if (version_ < 3) {
+        // Versions 1 and 2 hold raw arrays in channel order; version 1 has no tile list and
+        // dense fields.
+        std::uint64_t tileCount = 0;
+        if (version_ == 2 && (!in.read(tileCount) || !readTiles(tileCount))) {
+            return false;
+        }
+        for (const auto channel : kCachedChannels) {
+            const std::size_t element = channel == PyroFieldChannel::Velocity ? sizeof(PyroVec3) : sizeof(float);
+            std::uint64_t count = 0;
+            if (!in.read(count) || count > (in.size - in.at) / element) {
+                return false;
+            }
+            Entry entry{};
+            entry.channel = channel;
+            entry.raw = true;
+            entry.offset = in.at;
+            entry.bytes = count * element;
+            in.take(entry.bytes);
+            entries_.push_back(entry);
+        }
+        return true;
+    }
+
+    std::uint32_t brickCount = 0;
+    std::uint32_t fieldCount = 0;
+    if (!in.read(brickCount) || !in.read(fieldCount) || !readTiles(brickCount)) {
+        return false;
+    }
+    for (std::uint32_t i = 0; i < fieldCount; ++i) {
+        std::uint8_t channel = 0;
+        std::uint8_t encoding = 0;
+        std::uint16_t reserved16 = 0;
+        std::uint32_t reserved32 = 0;
+        Entry entry{};
+        if (!in.read(channel) || !in.read(encoding) || !in.read(reserved16) || !in.read(reserved32)
+            || !in.read(entry.offset) || !in.read(entry.bytes)) {
+            return false;
+        }
+        if (!isCachedChannel(channel) || encoding > static_cast<std::uint8_t>(PyroCacheEncoding::Quantized8)
+            || entry.offset > size_ || entry.bytes > size_ - entry.offset) {
+            return false;
+        }
+        entry.channel = static_cast<PyroFieldChannel>(channel);
+        entry.encoding = static_cast<PyroCacheEncoding>(encoding);
+        entries_.push_back(entry);
+    }
+    return true;
+}
+
+PyroFieldMask PyroCacheFile::availableFields() const noexcept {
+    PyroFieldMask fields = PyroFieldMask::None;
+    for (const auto& entry : entries_) {
+        fields |= fieldMask(entry.channel);
+    }
+    return fields;
+}
+
+std::uint64_t PyroCacheFile::fieldBytes(PyroFieldChannel channel) const noexcept {
+    for (const auto& entry : entries_) {
+        if (entry.channel == channel) {
+            return entry.bytes;
+        }
+    }
+    return 0;
+}
+
+bool PyroCacheFile::read(PyroFieldMask fields, PyroFieldSnapshot& snapshot) const {
+    if (!isOpen()) {
+        return false;
+    }
+    snapshot.resolution = resolution_;
+    snapshot.activeTiles = activeTiles_;
+    for (const auto channel : kCachedChannels) {
+        if (auto* scalar = scalarField(snapshot, channel)) {
+            scalar->clear();
+        }
+    }
+    snapshot.velocity.clear();
+    for (const auto& entry : entries_) {
+        if ((fields & fieldMask(entry.channel)) != PyroFieldMask::None && !decode(entry, snapshot)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool PyroCacheFile::decode(const Entry& entry, PyroFieldSnapshot& snapshot) const {
+    auto* scalar = scalarField(snapshot, entry.channel);
+    const auto* bytes = data_ + entry.offset;
+    if (entry.raw) {
+        if (scalar) {
+            scalar->resize(static_cast<std::size_t>(entry.bytes / sizeof(float)));
+        } else {
+            snapshot.velocity.resize(static_cast<std::size_t>(entry.bytes / sizeof(PyroVec3)));
+        }
+        if (entry.bytes > 0) {
+            std::memcpy(scalar ? static_cast<void*>(scalar->data()) : static_cast<void*>(snapshot.velocity.data()),
+                bytes, static_cast<std::size_t>(entry.bytes));
+        }
+        return true;
+    }
+
+    const std::size_t bricks = activeTiles_.size();
+    MutableFieldColumns field{};
+    if (scalar) {
+        scalar->assign(bricks * kBrickCells, 0.0f);
+        field.scalar = scalar->data();
+    } else {
+        snapshot.velocity.assign(bricks * kBrickCells, PyroVec3{});
+        field.vector = snapshot.velocity.data();
+    }
+
+    ByteReader in{bytes, static_cast<std::size_t>(entry.bytes)};
+    std::uint32_t segments = 0;
+    if (!in.read(segments) || segments != (bricks + kSegmentBricks - 1) / kSegmentBricks) {
+        return false;
+    }
+    const auto* ends = in.take(static_cast<std::uint64_t>(segments) * sizeof(std::uint64_t));
+    if (!ends) {
+        return false;
+    }
+    const auto* base = bytes + in.at;
+    const std::size_t available = in.size - in.at;
+    std::vector<std::uint8_t> decoded(segments, 0);
+    Parallel::ForRange(0, static_cast<int>(segments), 1, [&](ParallelRange range) {
+        for (int segment = range.begin; segment < range.end; ++segment) {
+            std::uint64_t begin = 0;
+            std::uint64_t end = 0;
+            if (segment > 0) {
+                std::memcpy(&begin, ends + (segment - 1) * sizeof(std::uint64_t), sizeof(begin));
+            }
+            std::memcpy(&end, ends + segment * sizeof(std::uint64_t), sizeof(end));
+            if (begin > end || end > available) {
+                continue;
+            }
+            const std::size_t first = static_cast<std::size_t>(segment) * kSegmentBricks;
+            decoded[static_cast<std::size_t>(segment)] = decodeSegment(
+                ByteReader{base + begin, static_cast<std::size_t>(end - begin)}, field, componentCount(entry.channel),
+                first, std::min(kSegmentBricks, bricks - first), entry.encoding) ? 1 : 0;
+        }
+    });
+    return std::all_of(decoded.begin(), decoded.end(), [](std::uint8_t ok) { return ok != 0; });
+}
+
+// Decodes the checkpoints next to a seek() target on a worker thread so the following seek
+// finds them ready. request() replaces the queue, so only the latest scrub position counts.
+struct PyroSimulation::CachePrefetch {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::vector<std::filesystem::path> queue;
+    std::vector<std::pair<std::filesystem::path, PyroFieldSnapshot>> ready;
+    std::filesystem::path loading;
+    bool stopping = false;
+    std::thread worker;
+
+    ~CachePrefetch() {
+        {
+            const std::scoped_lock lock(mutex);
+            stopping = true;
+        }
+        changed.notify_all();
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    void request(std::vector<std::filesystem::path> paths) {
+        {
+            const std::scoped_lock lock(mutex);
+            std::erase_if(ready, [&](const auto& entry) {
+                return std::find(paths.begin(), paths.end(), entry.first) == paths.end();
+            });
+            std::erase_if(paths, [&](const auto& path) {
+                return path == loading || std::any_of(ready.begin(), ready.end(), [&](const auto& entry) { return entry.first == path; });
+            });
+            queue = std::move(paths);
+            if (!worker.joinable() && !queue.empty()) {
+                worker = std::thread([this] { run(); });
+            }
+        }
+        changed.notify_all();
+    }
+
+    // Hands over a decoded checkpoint, waiting if the worker is decoding that file right now.
+    bool take(const std::filesystem::path& path, PyroFieldSnapshot& snapshot) {
+        std::unique_lock lock(mutex);
+        changed.wait(lock, [&] { return loading != path; });
+        std::erase(queue, path);
+        const auto it = std::find_if(ready.begin(), ready.end(), [&](const auto& entry) { return entry.first == path; });
+        if (it == ready.end()) {
+            return false;
+        }
+        snapshot = std::move(it->second);
+        ready.erase(it);
+        return true;
+    }
+
+    // Drops anything decoded from a file that is about to be rewritten.
+    void forget(const std::filesystem::path& path) {
+        std::unique_lock lock(mutex);
+        changed.wait(lock, [&] { return loading != path; });
+        std::erase(queue, path);
+        std::erase_if(ready, [&](const auto& entry) { return entry.first == path; });
+    }
+
+    void run() {
+        std::unique_lock lock(mutex);
+        for (;;) {
+            changed.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (stopping) {
+                return;
+            }
+            loading = queue.front();
+            queue.erase(queue.begin());
+            const auto path = loading;
+            lock.unlock();
+
+            PyroFieldSnapshot snapshot{};
+            PyroCacheFile file;
+            const bool loaded = file.open(path) && file.read(PyroFieldMask::All, snapshot);
+
+            lock.lock();
+            loading.clear();
+            if (loaded) {
+                ready.emplace_back(path, std::move(snapshot));
+            }
+            changed.notify_all();
+        }
+    }
+};
+
+std::filesystem::path PyroSimulation::checkpointPath(std::uint64_t frameIndex) const {
+    return cacheDirectory_ / (std::to_string(frameIndex) + ".pyroc");
+}
+
+void PyroSimulation::storeCheckpoint() {
+    checkpointCache_[frameIndex_] = fields_.capture();
+    if (!cacheDirectory_.empty()) {
+        saveCheckpointSnapshot(checkpointCache_[frameIndex_], checkpointPath(frameIndex_));
+    }
+}
+
+bool PyroSimulation::saveCheckpointSnapshot(const PyroFieldSnapshot& snapshot, const std::filesystem::path& path) const {
+    std::error_code ec;
+    if (!path.parent_path().empty()) {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    if (cachePrefetch_) {
+        cachePrefetch_->forget(path);
+    }
+    return writePyroCacheFile(path, snapshot, cacheSettings_);
+}
+
+bool PyroSimulation::loadCheckpointSnapshot(PyroFieldSnapshot& snapshot, const std::filesystem::path& path) const {
+    PyroCacheFile file;
+    return file.open(path) && file.read(PyroFieldMask::All, snapshot);
+}
+
+PyroCacheStatus PyroSimulation::saveCheckpointToDisk(std::uint64_t frameIndex) const {
+    PyroCacheStatus status{};
+    status.supported = !cacheDirectory_.empty();
+    if (!status.supported) {
+        status.reason = "cache directory is empty";
+        return status;
+    }
+
+    const auto it = checkpointCache_.find(frameIndex);
+    if (it == checkpointCache_.end()) {
+        status.reason = "checkpoint not found in memory";
+        return status;
+    }
+
+    status.loaded = saveCheckpointSnapshot(it->second, checkpointPath(frameIndex));
+    if (!status.loaded) {
+        status.reason = "failed to write checkpoint";
+    }
+    return status;
+}
+
+PyroCacheStatus PyroSimulation::loadCheckpointFromDisk(std::uint64_t frameIndex) {
+    PyroCacheStatus status{};
+    status.supported = !cacheDirectory_.empty();
+    if (!status.supported) {
+        status.reason = "cache directory is empty";
+        return status;
+    }
+
+    PyroFieldSnapshot snapshot{};
+    const auto path = checkpointPath(frameIndex);
+    status.loaded = (cachePrefetch_ && cachePrefetch_->take(path, snapshot)) || loadCheckpointSnapshot(snapshot, path);
+    if (!status.loaded) {
+        status.reason = "failed to read checkpoint";
+        return status;
+    }
+
+    if (!fields_.restore(snapshot)) {
+        fields_.resize(domain_.resolution());
+        status.loaded = false;
+        status.reason = "checkpoint does not match its tile list";
+        return status;
+    }
+    frameIndex_ = frameIndex;
+    checkpointCache_[frameIndex] = fields_.capture();
+    return status;
+}
+
+bool PyroSimulation::restoreCheckpoint(std::uint64_t frameIndex) {
+    const auto it = checkpointCache_.find(frameIndex);
+    if (it == checkpointCache_.end()) {
+        if (cacheDirectory_.empty()) {
+            return false;
+        }
+        auto status = loadCheckpointFromDisk(frameIndex);
+        return status.loaded;
+    }
+    if (!fields_.restore(it->second)) {
+        fields_.resize(domain_.resolution());
+        return false;
+    }
+    frameIndex_ = frameIndex;
+    return true;
+}
+
+void PyroSimulation::prefetchCheckpointsAround(std::uint64_t frameIndex) {
+    if (cacheDirectory_.empty() || cacheSettings_.prefetchRadius <= 0) {
+        return;
+    }
+
+    // Nearest first: the checkpoint at or below the target, then alternating forward and back.
+    std::vector<std::filesystem::path> paths;
+    const auto add = [&](std::uint64_t frame) {
+        if (checkpointCache_.contains(frame)) {
+            return;
+        }
+        auto path = checkpointPath(frame);
+        std::error_code ec;
+        if (std::filesystem::exists(path, ec)) {
+            paths.push_back(std::move(path));
+        }
+    };
+    const std::uint64_t base = frameIndex - frameIndex % cacheInterval_;
+    if (base != frameIndex) {
+        add(base);
+    }
+    for (int k = 1; k <= cacheSettings_.prefetchRadius; ++k) {
+        const std::uint64_t offset = cacheInterval_ * static_cast<std::uint64_t>(k);
+        add(base + offset);
+        if (base >= offset) {
+            add(base - offset);
+        }
+    }
+
+    if (paths.empty() && !cachePrefetch_) {
+        return;
+    }
+    if (!cachePrefetch_) {
+        cachePrefetch_ = std::make_shared<CachePrefetch>();
+    }
+    cachePrefetch_->request(std::move(paths));
+}
+
+}
@@ -0,0 +1,94 @@
+module;
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+export module Core.Simulation.Pyro.Test;
+
+import Core.Simulation.Pyro;
+
+namespace ArtifactCore::PyroSimulationTest {
+
+// 12 x 10 x 9 cells, so the last tile on every axis is partial.
+PyroDomain makeDomain() {
+    PyroDomain domain;
+    domain.max = {3.0f, 2.5f, 2.25f};
+    domain.voxelSize = 0.25f;
+    return domain;
+}
+
+std::size_t denseIndex(const PyroResolution& resolution, int x, int y, int z) {
+    return static_cast<std::size_t>(x)
+        + static_cast<std::size_t>(resolution.width)
+            * (static_cast<std::size_t>(y) + static_cast<std::size_t>(resolution.height) * static_cast<std::size_t>(z));
+}
+
+// Every cell is stored and zero, and a host can seed it before the first step.
+bool seedsBeforeStepping(PyroSimulation& simulation) {
+    auto& fields = simulation.fields();
+    const auto resolution = fields.resolution();
+    if (fields.empty() || fields.activeCellCount() < fields.cellCount()
+        || simulation.snapshot().density.values.size() < fields.cellCount()) {
+        return false;
+    }
+    try {
+        const auto density = fields.densityView();
+        const auto velocity = fields.velocityView();
+        for (int z = 0; z < resolution.depth; ++z) {
+            for (int y = 0; y < resolution.height; ++y) {
+                for (int x = 0; x < resolution.width; ++x) {
+                    if (density.at(x, y, z) != 0.0f || velocity.at(x, y, z).y != 0.0f) {
+                        return false;
+                    }
+                }
+            }
+        }
+        density.at(resolution.width - 1, resolution.height - 1, resolution.depth - 1) = 2.0f;
+    } catch (const std::out_of_range&) {
+        return false;
+    }
+    const auto dense = fields.exportDense(PyroFieldChannel::Density);
+    return dense.size() == fields.cellCount() && dense.back() == 2.0f;
+}
+
+bool fieldsAreStoredBeforeFirstStepContractTest() {
+    PyroSimulation simulation(makeDomain());
+    if (!seedsBeforeStepping(simulation)) return false;
+
+    simulation.reset();
+    if (!seedsBeforeStepping(simulation)) return false;
+
+    PyroDomain smaller = makeDomain();
+    smaller.max = {1.0f, 1.0f, 1.0f};
+    simulation.setDomain(smaller);
+    return seedsBeforeStepping(simulation);
+}
+
+// Views index bricks, exportDense / importDense use x-fastest order; both agree per cell.
+bool denseLayoutContractTest() {
+    PyroSimulation simulation(makeDomain());
+    auto& fields = simulation.fields();
+    const auto resolution = fields.resolution();
+    std::vector<float> dense(fields.cellCount());
+    for (std::size_t i = 0; i < dense.size(); ++i) {
+        dense[i] = static_cast<float>(i + 1);
+    }
+    if (!fields.importDense(PyroFieldChannel::Temperature, dense)) return false;
+
+    const auto view = fields.temperatureView();
+    for (int z = 0; z < resolution.depth; ++z) {
+        for (int y = 0; y < resolution.height; ++y) {
+            for (int x = 0; x < resolution.width; ++x) {
+                if (view.value(x, y, z) != dense[denseIndex(resolution, x, y, z)]) return false;
+            }
+        }
+    }
+    return fields.exportDense(PyroFieldChannel::Temperature) == dense;
+}
+
+export bool runAllPyroSimulationTests() {
+    return fieldsAreStoredBeforeFirstStepContractTest() &&
+        denseLayoutContractTest();
+}
+
+} // namespace ArtifactCore::PyroSimulationTest
@@ -1,12 +1,17 @@
 module;
 #include <algorithm>
+#include <array>
 #include <bit>
+#include <chrono>
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
-#include <fstream>
+#include <span>
+#include <stdexcept>
 #include <utility>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 module Core.Simulation.Pyro;
 
@@ -18,6 +23,10 @@ namespace {
 
 constexpr std::uint64_t kFnvOffset = 1469598103934665603ull;
 constexpr std::uint64_t kFnvPrime = 1099511628211ull;
+// Bumped whenever the default solver path changes results, so hashSettings() stops
+// matching caches written by the old path. 2: red-black ordering, mean removal on
+// closed domains, early stop at pressureTolerance and the advection fix.
+constexpr std::uint64_t kSolverRevision = 2;
 
 inline void hashAppend(std::uint64_t& seed, std::uint64_t value) noexcept {
     seed ^= value;
@@ -50,6 +59,738 @@ inline float cellToWorldStep(const PyroResolution& resolution, float domainExten
     return domainExtent / static_cast<float>(cells);
 }
 
+inline double elapsedMs(std::chrono::steady_clock::time_point start) noexcept {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline std::size_t cellCountOf(const PyroResolution& resolution) noexcept {
+    return static_cast<std::size_t>(resolution.width)
+        * static_cast<std::size_t>(resolution.height)
+        * static_cast<std::size_t>(resolution.depth);
+}
+
+inline bool sameResolution(const PyroResolution& lhs, const PyroResolution& rhs) noexcept {
+    return lhs.width == rhs.width && lhs.height == rhs.height && lhs.depth == rhs.depth;
+}
+
+constexpr int kTileShift = PyroTileGrid::kTileShift;
+constexpr int kTileSize = PyroTileGrid::kTileSize;
+constexpr int kTileMask = kTileSize - 1;
+constexpr std::size_t kTileCells = PyroTileGrid::kTileCells;
+constexpr std::size_t kStrideY = static_cast<std::size_t>(kTileSize);
+constexpr std::size_t kStrideZ = kStrideY * kStrideY;
+constexpr int kBricksPerReduceChunk = 8;
+
+inline std::size_t localIndex(int lx, int ly, int lz) noexcept {
+    return static_cast<std::size_t>(lx | (ly << kTileShift) | (lz << (2 * kTileShift)));
+}
+
+// Origin and in-domain extent of a brick. Tiles on the upper walls can be partial; their
+// padding cells hold zeros and are never written.
+struct BrickBox {
+    int x0 = 0;
+    int y0 = 0;
+    int z0 = 0;
+    int nx = 0;
+    int ny = 0;
+    int nz = 0;
+};
+
+inline BrickBox brickBox(const PyroTileGrid& grid, std::size_t brick) noexcept {
+    const auto tile = static_cast<int>(grid.active[brick]);
+    BrickBox box;
+    box.x0 = (tile % grid.tiles.width) << kTileShift;
+    box.y0 = ((tile / grid.tiles.width) % grid.tiles.height) << kTileShift;
+    box.z0 = (tile / (grid.tiles.width * grid.tiles.height)) << kTileShift;
+    box.nx = std::min(kTileSize, grid.resolution.width - box.x0);
+    box.ny = std::min(kTileSize, grid.resolution.height - box.y0);
+    box.nz = std::min(kTileSize, grid.resolution.depth - box.z0);
+    return box;
+}
+
+template <typename Body>
+void forEachBrick(const PyroTileGrid& grid, Body&& body) {
+    Parallel::For(0, static_cast<int>(grid.brickCount()), static_cast<int>(kTileCells), [&](int brick) {
+        body(static_cast<std::size_t>(brick));
+    });
+}
+
+// Point-wise passes run over whole bricks; they all map zero to zero, so padding stays zero.
+template <typename Body>
+void forEachStoredCell(const PyroTileGrid& grid, Body&& body) {
+    forEachBrick(grid, [&](std::size_t brick) {
+        const std::size_t begin = brick * kTileCells;
+        for (std::size_t idx = begin; idx < begin + kTileCells; ++idx) {
+            body(idx);
+        }
+    });
+}
+
+template <typename Body>
+inline void forEachBrickCell(const BrickBox& box, Body&& body) {
+    for (int lz = 0; lz < box.nz; ++lz) {
+        for (int ly = 0; ly < box.ny; ++ly) {
+            for (int lx = 0; lx < box.nx; ++lx) {
+                body(lx, ly, lz, localIndex(lx, ly, lz));
+            }
+        }
+    }
+}
+
+template <typename Body>
+inline void forEachBrickRow(const BrickBox& box, Body&& body) {
+    for (int lz = 0; lz < box.nz; ++lz) {
+        for (int ly = 0; ly < box.ny; ++ly) {
+            body(ly, lz, localIndex(0, ly, lz));
+        }
+    }
+}
+
+template <typename T>
+const T* zeroRow() noexcept {
+    static const std::array<T, kTileSize> row{};
+    return row.data();
+}
+
+// The face neighbours of one brick row, resolved once per row. ym/yp/zm/zp are the rows next
+// to it, xm/xp the cells across the x faces of the brick. count is how many of the four rows
+// lie inside the grid; xmInside/xpInside say the same for xm/xp. Neighbours in inactive tiles
+// read the zero row. Walls read the zero row for the pressure operator, or repeat the cell
+// itself for the central differences, as the dense loops did. Pointers are only dereferenced
+// when used, so red-black sweeps never touch cells of the colour being written.
+template <typename T>
+struct StencilRow {
+    const T* row = nullptr;
+    const T* ym = nullptr;
+    const T* yp = nullptr;
+    const T* zm = nullptr;
+    const T* zp = nullptr;
+    const T* xm = nullptr;
+    const T* xp = nullptr;
+    int count = 0;
+    bool xmInside = false;
+    bool xpInside = false;
+};
+
+template <typename T>
+StencilRow<T> stencilRow(const PyroTileGrid& grid, const T* pool, std::size_t brick, const BrickBox& box, int ly, int lz, bool wallsRepeat) noexcept {
+    const std::int32_t* links = grid.links.data() + brick * 6;
+    StencilRow<T> s;
+    s.row = pool + brick * kTileCells + localIndex(0, ly, lz);
+    const auto across = [&](std::int32_t link, std::size_t local, const T* wall, bool& inside) -> const T* {
+        inside = link != PyroTileGrid::kOutside;
+        if (link >= 0) {
+            return pool + static_cast<std::size_t>(link) * kTileCells + local;
+        }
+        return inside || !wallsRepeat ? zeroRow<T>() : wall;
+    };
+    const auto row = [&](bool local, std::ptrdiff_t step, std::int32_t link, std::size_t remote) {
+        bool inside = true;
+        const T* neighbour = local ? s.row + step : across(link, remote, s.row, inside);
+        s.count += inside ? 1 : 0;
+        return neighbour;
+    };
+    if (ly > 0 && ly + 1 < box.ny && lz > 0 && lz + 1 < box.nz) {
+        s.ym = s.row - kStrideY;
+        s.yp = s.row + kStrideY;
+        s.zm = s.row - kStrideZ;
+        s.zp = s.row + kStrideZ;
+        s.count = 4;
+    } else {
+        s.ym = row(ly > 0, -static_cast<std::ptrdiff_t>(kStrideY), links[2], localIndex(0, kTileMask, lz));
+        s.yp = row(ly + 1 < box.ny, static_cast<std::ptrdiff_t>(kStrideY), links[3], localIndex(0, 0, lz));
+        s.zm = row(lz > 0, -static_cast<std::ptrdiff_t>(kStrideZ), links[4], localIndex(0, ly, kTileMask));
+        s.zp = row(lz + 1 < box.nz, static_cast<std::ptrdiff_t>(kStrideZ), links[5], localIndex(0, ly, 0));
+    }
+    s.xm = across(links[0], localIndex(kTileMask, ly, lz), s.row, s.xmInside);
+    s.xp = across(links[1], localIndex(0, ly, lz), s.row + box.nx - 1, s.xpInside);
+    return s;
+}
+
+template <typename T>
+struct FaceValues {
+    T xm{};
+    T xp{};
+    T ym{};
+    T yp{};
+    T zm{};
+    T zp{};
+};
+
+template <typename T>
+inline FaceValues<T> faceValues(const StencilRow<T>& s, int lx, int nx) noexcept {
+    return {
+        lx > 0 ? s.row[lx - 1] : *s.xm,
+        lx + 1 < nx ? s.row[lx + 1] : *s.xp,
+        s.ym[lx], s.yp[lx], s.zm[lx], s.zp[lx]
+    };
+}
+
+// Trilinear weights with the storage offsets of the eight corners, shared by every field that
+// advection samples at the same point. Corners in inactive tiles have offset -1.
+struct TrilinearTaps {
+    std::int64_t offset[8]{};
+    float weight[8]{};
+
+    [[nodiscard]] float sample(const float* pool) const noexcept {
+        float sum = 0.0f;
+        for (int i = 0; i < 8; ++i) {
+            if (offset[i] >= 0) {
+                sum += weight[i] * pool[offset[i]];
+            }
+        }
+        return sum;
+    }
+
+    [[nodiscard]] PyroVec3 sample(const PyroVec3* pool) const noexcept {
+        PyroVec3 sum{};
+        for (int i = 0; i < 8; ++i) {
+            if (offset[i] >= 0) {
+                const PyroVec3& v = pool[offset[i]];
+                sum.x += weight[i] * v.x;
+                sum.y += weight[i] * v.y;
+                sum.z += weight[i] * v.z;
+            }
+        }
+        return sum;
+    }
+};
+
+// Same clamping as PyroFieldSet::sampleScalar; returns false where an open boundary reads zero.
+inline bool trilinearTaps(const PyroTileGrid& grid, const PyroVec3& position, PyroBoundaryMode boundaryMode, TrilinearTaps& taps) noexcept {
+    const auto& r = grid.resolution;
+    if (boundaryMode == PyroBoundaryMode::Open
+        && (position.x < 0.0f || position.y < 0.0f || position.z < 0.0f
+            || position.x > static_cast<float>(r.width - 1)
+            || position.y > static_cast<float>(r.height - 1)
+            || position.z > static_cast<float>(r.depth - 1))) {
+        return false;
+    }
+    const float fx = std::clamp(position.x, 0.0f, static_cast<float>(r.width - 1));
+    const float fy = std::clamp(position.y, 0.0f, static_cast<float>(r.height - 1));
+    const float fz = std::clamp(position.z, 0.0f, static_cast<float>(r.depth - 1));
+    const int x0 = static_cast<int>(std::floor(fx));
+    const int y0 = static_cast<int>(std::floor(fy));
+    const int z0 = static_cast<int>(std::floor(fz));
+    const int xs[2] = {x0, std::min(x0 + 1, r.width - 1)};
+    const int ys[2] = {y0, std::min(y0 + 1, r.height - 1)};
+    const int zs[2] = {z0, std::min(z0 + 1, r.depth - 1)};
+    const float tx = fx - static_cast<float>(x0);
+    const float ty = fy - static_cast<float>(y0);
+    const float tz = fz - static_cast<float>(z0);
+    const float wx[2] = {1.0f - tx, tx};
+    const float wy[2] = {1.0f - ty, ty};
+    const float wz[2] = {1.0f - tz, tz};
+    for (int i = 0; i < 8; ++i) {
+        const int cx = i & 1;
+        const int cy = (i >> 1) & 1;
+        const int cz = i >> 2;
+        taps.offset[i] = grid.offsetOf(xs[cx], ys[cy], zs[cz]);
+        taps.weight[i] = wx[cx] * wy[cy] * wz[cz];
+    }
+    return true;
+}
+
+// Copies the block of (nx, ny, nz) cells at (x0, y0, z0), x fastest, into out. Cells outside the
+// grid or in inactive tiles read as zero.
+void gatherBlock(const PyroTileGrid& grid, const float* pool, int x0, int y0, int z0, int nx, int ny, int nz, float* out) noexcept {
+    const auto& r = grid.resolution;
+    for (int z = 0; z < nz; ++z) {
+        const int gz = z0 + z;
+        for (int y = 0; y < ny; ++y) {
+            const int gy = y0 + y;
+            float* row = out + (static_cast<std::size_t>(z) * ny + y) * nx;
+            if (gz < 0 || gz >= r.depth || gy < 0 || gy >= r.height) {
+                std::fill(row, row + nx, 0.0f);
+                continue;
+            }
+            int x = 0;
+            while (x < nx) {
+                const int gx = x0 + x;
+                if (gx < 0 || gx >= r.width) {
+                    row[x++] = 0.0f;
+                    continue;
+                }
+                const int run = std::min({nx - x, kTileSize - (gx & kTileMask), r.width - gx});
+                const auto offset = grid.offsetOf(gx, gy, gz);
+                if (offset < 0) {
+                    std::fill(row + x, row + x + run, 0.0f);
+                } else {
+                    std::copy(pool + offset, pool + offset + run, row + x);
+                }
+                x += run;
+            }
+        }
+    }
+}
+
+// The pressure system is the one the original lexicographic relaxation converged to:
+// n_i * p_i - sum(p_neighbour) = b_i, where n_i counts the neighbours inside the grid
+// (clamped neighbours cancel out). A neighbour in an inactive tile still counts in n_i but
+// holds p = 0: the quiet air around the active region is an open boundary. Every pass runs
+// over bricks, and every reduction sums per-brick partials in brick order, so results do not
+// depend on the thread count.
+
+inline float pressureNeighbours(const StencilRow<float>& s, int lx, int nx, int& count) noexcept {
+    float sum = s.ym[lx] + s.yp[lx] + s.zm[lx] + s.zp[lx];
+    count = s.count;
+    if (lx > 0) {
+        sum += s.row[lx - 1];
+        ++count;
+    } else if (s.xmInside) {
+        sum += *s.xm;
+        ++count;
+    }
+    if (lx + 1 < nx) {
+        sum += s.row[lx + 1];
+        ++count;
+    } else if (s.xpInside) {
+        sum += *s.xp;
+        ++count;
+    }
+    return sum;
+}
+
+// Runs cell(lx, sum, count) along one brick row, starting at first and stepping by step. The
+// cells between the two x faces take the branch-free path.
+template <typename Cell>
+inline void forEachPressureCell(const StencilRow<float>& s, int nx, int first, int step, Cell&& cell) {
+    int lx = first;
+    int count = 0;
+    if (lx == 0) {
+        const float sum = pressureNeighbours(s, 0, nx, count);
+        cell(0, sum, count);
+        lx += step;
+    }
+    const int inner = s.count + 2;
+    for (; lx + 1 < nx; lx += step) {
+        cell(lx, s.ym[lx] + s.yp[lx] + s.zm[lx] + s.zp[lx] + s.row[lx - 1] + s.row[lx + 1], inner);
+    }
+    if (lx < nx) {
+        const float sum = pressureNeighbours(s, lx, nx, count);
+        cell(lx, sum, count);
+    }
+}
+
+void applyPressureOperator(const PyroTileGrid& grid, const float* p, float* out) {
+    forEachBrick(grid, [&](std::size_t brick) {
+        const auto box = brickBox(grid, brick);
+        const std::size_t base = brick * kTileCells;
+        forEachBrickRow(box, [&](int ly, int lz, std::size_t rowStart) {
+            const auto s = stencilRow(grid, p, brick, box, ly, lz, false);
+            float* o = out + base + rowStart;
+            forEachPressureCell(s, box.nx, 0, 1, [&](int lx, float sum, int count) {
+                o[lx] = static_cast<float>(count) * s.row[lx] - sum;
+            });
+        });
+    });
+}
+
+void computePressureResidual(const PyroTileGrid& grid, const float* b, const float* p, float* out) {
+    forEachBrick(grid, [&](std::size_t brick) {
+        const auto box = brickBox(grid, brick);
+        const std::size_t base = brick * kTileCells;
+        forEachBrickRow(box, [&](int ly, int lz, std::size_t rowStart) {
+            const auto s = stencilRow(grid, p, brick, box, ly, lz, false);
+            const float* rhs = b + base + rowStart;
+            float* o = out + base + rowStart;
+            forEachPressureCell(s, box.nx, 0, 1, [&](int lx, float sum, int count) {
+                o[lx] = rhs[lx] - (static_cast<float>(count) * s.row[lx] - sum);
+            });
+        });
+    });
+}
+
+// One Gauss-Seidel pass over the cells with (x + y + z) % 2 == color. Cells of one color
+// only read the other color, so the bricks can run in any order. Brick origins are multiples
+// of 8, so the local coordinates have the same parity as the global ones.
+void relaxPressureColor(const PyroTileGrid& grid, const float* b, float* p, int color) {
+    forEachBrick(grid, [&](std::size_t brick) {
+        const auto box = brickBox(grid, brick);
+        const std::size_t base = brick * kTileCells;
+        forEachBrickRow(box, [&](int ly, int lz, std::size_t rowStart) {
+            const auto s = stencilRow(grid, static_cast<const float*>(p), brick, box, ly, lz, false);
+            const float* rhs = b + base + rowStart;
+            float* row = p + base + rowStart;
+            const auto edge = [&](int lx) {
+                int count = 0;
+                const float sum = pressureNeighbours(s, lx, box.nx, count);
+                if (count > 0) {
+                    row[lx] = (rhs[lx] + sum) / static_cast<float>(count);
+                }
+            };
+            int lx = (ly + lz + color) & 1;
+            if (lx == 0) {
+                edge(0);
+                lx = 2;
+            }
+            const float inverse = 1.0f / static_cast<float>(s.count + 2);
+            for (; lx + 1 < box.nx; lx += 2) {
+                row[lx] = (rhs[lx] + (s.ym[lx] + s.yp[lx] + s.zm[lx] + s.zp[lx] + row[lx - 1] + row[lx + 1])) * inverse;
+            }
+            if (lx < box.nx) {
+                edge(lx);
+            }
+        });
+    });
+}
+
+template <typename Body>
+double sumOverBricks(const PyroTileGrid& grid, Body&& body) {
+    return Parallel::Reduce(0, static_cast<int>(grid.brickCount()), kBricksPerReduceChunk, 0.0,
+        [&](ParallelRange range, double accumulator) {
+            for (int brick = range.begin; brick < range.end; ++brick) {
+                const std::size_t begin = static_cast<std::size_t>(brick) * kTileCells;
+                accumulator += body(begin, begin + kTileCells);
+            }
+            return accumulator;
+        },
+        [](double lhs, double rhs) { return lhs + rhs; });
+}
+
+double dotProduct(const PyroTileGrid& grid, const float* a, const float* b) {
+    return sumOverBricks(grid, [&](std::size_t begin, std::size_t end) {
+        double sum = 0.0;
+        for (std::size_t i = begin; i < end; ++i) {
+            sum += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+        }
+        return sum;
+    });
+}
+
+std::size_t domainCellCount(const PyroTileGrid& grid) noexcept {
+    std::size_t count = 0;
+    for (std::size_t brick = 0; brick < grid.brickCount(); ++brick) {
+        const auto box = brickBox(grid, brick);
+        count += static_cast<std::size_t>(box.nx) * static_cast<std::size_t>(box.ny) * static_cast<std::size_t>(box.nz);
+    }
+    return count;
+}
+
+// With closed walls on every side the operator is singular (constant pressure is free),
+// so right-hand sides and search directions are kept at zero mean. Only needed while every
+// tile is active; an open face pins the pressure to zero there.
+void removeMean(const PyroTileGrid& grid, float* values) {
+    const double sum = sumOverBricks(grid, [&](std::size_t begin, std::size_t end) {
+        double partial = 0.0;
+        for (std::size_t i = begin; i < end; ++i) {
+            partial += values[i];
+        }
+        return partial;
+    });
+    const float mean = static_cast<float>(sum / static_cast<double>(domainCellCount(grid)));
+    forEachBrick(grid, [&](std::size_t brick) {
+        float* cells = values + brick * kTileCells;
+        forEachBrickCell(brickBox(grid, brick), [&](int, int, int, std::size_t local) {
+            cells[local] -= mean;
+        });
+    });
+}
+
+// Cell-centred linear interpolation along one axis: fine cell f takes 3/4 of coarse cell f/2
+// and 1/4 of the coarse cell on the far side of f (clamped at the walls).
+inline int prolongationNeighbour(int fine, int coarseCount) noexcept {
+    const int coarse = fine >> 1;
+    return std::clamp((fine & 1) ? coarse + 1 : coarse - 1, 0, coarseCount - 1);
+}
+
+inline float restrictionWeight(int fine, int coarse, int coarseCount) noexcept {
+    float weight = (fine >> 1) == coarse ? 0.75f : 0.0f;
+    if (prolongationNeighbour(fine, coarseCount) == coarse) {
+        weight += 0.25f;
+    }
+    return weight;
+}
+
+struct RestrictionTaps {
+    int index[4]{};
+    float weight[4]{};
+    int count = 0;
+};
+
+inline RestrictionTaps restrictionTaps(int coarse, int fineCount, int coarseCount) noexcept {
+    RestrictionTaps taps;
+    for (int fine = std::max(0, 2 * coarse - 1); fine <= std::min(fineCount - 1, 2 * coarse + 2); ++fine) {
+        const float weight = restrictionWeight(fine, coarse, coarseCount);
+        if (weight > 0.0f) {
+            taps.index[taps.count] = fine;
+            taps.weight[taps.count] = weight;
+            ++taps.count;
+        }
+    }
+    return taps;
+}
+
+// coarse = P^T fine / 2. P^T sums to 8 per interior cell, so this is 4x the weighted average,
+// which accounts for the doubled cell size in the coarse operator. Each coarse brick gathers
+// its fine footprint (up to 18^3 cells) and applies the separable weights one axis at a time.
+void restrictResidual(const PyroTileGrid& fine, const float* fineValues, const PyroTileGrid& coarse, float* coarseValues) {
+    constexpr int kSpan = 2 * kTileSize + 2;
+    forEachBrick(coarse, [&](std::size_t brick) {
+        const auto box = brickBox(coarse, brick);
+        const int fx0 = 2 * box.x0 - 1;
+        const int fy0 = 2 * box.y0 - 1;
+        const int fz0 = 2 * box.z0 - 1;
+        const int sx = 2 * box.nx + 2;
+        const int sy = 2 * box.ny + 2;
+        const int sz = 2 * box.nz + 2;
+        std::array<float, kSpan * kSpan * kSpan> block;
+        gatherBlock(fine, fineValues, fx0, fy0, fz0, sx, sy, sz, block.data());
+
+        std::array<RestrictionTaps, kTileSize> xTaps;
+        std::array<RestrictionTaps, kTileSize> yTaps;
+        std::array<RestrictionTaps, kTileSize> zTaps;
+        for (int i = 0; i < kTileSize; ++i) {
+            xTaps[i] = i < box.nx ? restrictionTaps(box.x0 + i, fine.resolution.width, coarse.resolution.width) : RestrictionTaps{};
+            yTaps[i] = i < box.ny ? restrictionTaps(box.y0 + i, fine.resolution.height, coarse.resolution.height) : RestrictionTaps{};
+            zTaps[i] = i < box.nz ? restrictionTaps(box.z0 + i, fine.resolution.depth, coarse.resolution.depth) : RestrictionTaps{};
+        }
+
+        // x: (sz, sy, sx) -> (sz, sy, 8); y: -> (sz, 8, 8); z: -> (8, 8, 8).
+        std::array<float, kSpan * kSpan * kTileSize> alongX;
+        for (int fz = 0; fz < sz; ++fz) {
+            for (int fy = 0; fy < sy; ++fy) {
+                const float* in = block.data() + (static_cast<std::size_t>(fz) * sy + fy) * sx;
+                float* outRow = alongX.data() + (static_cast<std::size_t>(fz) * sy + fy) * kTileSize;
+                for (int lx = 0; lx < box.nx; ++lx) {
+                    const auto& t = xTaps[lx];
+                    float sum = 0.0f;
+                    for (int i = 0; i < t.count; ++i) {
+                        sum += t.weight[i] * in[t.index[i] - fx0];
+                    }
+                    outRow[lx] = sum;
+                }
+            }
+        }
+        std::array<float, kSpan * kTileSize * kTileSize> alongY;
+        for (int fz = 0; fz < sz; ++fz) {
+            for (int ly = 0; ly < box.ny; ++ly) {
+                const auto& t = yTaps[ly];
+                float* outRow = alongY.data() + (static_cast<std::size_t>(fz) * kTileSize + ly) * kTileSize;
+                std::fill(outRow, outRow + kTileSize, 0.0f);
+                for (int i = 0; i < t.count; ++i) {
+                    const float* in = alongX.data() + (static_cast<std::size_t>(fz) * sy + (t.index[i] - fy0)) * kTileSize;
+                    for (int lx = 0; lx < box.nx; ++lx) {
+                        outRow[lx] += t.weight[i] * in[lx];
+                    }
+                }
+            }
+        }
+        float* out = coarseValues + brick * kTileCells;
+        for (int lz = 0; lz < box.nz; ++lz) {
+            const auto& t = zTaps[lz];
+            for (int ly = 0; ly < box.ny; ++ly) {
+                float* outRow = out + localIndex(0, ly, lz);
+                float sum[kTileSize]{};
+                for (int i = 0; i < t.count; ++i) {
+                    const float* in = alongY.data() + (static_cast<std::size_t>(t.index[i] - fz0) * kTileSize + ly) * kTileSize;
+                    for (int lx = 0; lx < box.nx; ++lx) {
+                        sum[lx] += t.weight[i] * in[lx];
+                    }
+                }
+                for (int lx = 0; lx < box.nx; ++lx) {
+                    outRow[lx] = sum[lx] * 0.5f;
+                }
+            }
+        }
+    });
+}
+
+// Trilinear prolongation, also separable: the coarse neighbourhood of a fine brick (at most
+// 6^3 cells) is interpolated along x, then y, then z.
+void prolongateAdd(const PyroTileGrid& coarse, const float* coarseValues, const PyroTileGrid& fine, float* fineValues) {
+    constexpr int kSpan = kTileSize / 2 + 2;
+    const auto& cr = coarse.resolution;
+    forEachBrick(fine, [&](std::size_t brick) {
+        const auto box = brickBox(fine, brick);
+        const int cx0 = std::max(0, (box.x0 >> 1) - 1);
+        const int cy0 = std::max(0, (box.y0 >> 1) - 1);
+        const int cz0 = std::max(0, (box.z0 >> 1) - 1);
+        const int sx = std::min(cr.width - 1, ((box.x0 + box.nx - 1) >> 1) + 1) - cx0 + 1;
+        const int sy = std::min(cr.height - 1, ((box.y0 + box.ny - 1) >> 1) + 1) - cy0 + 1;
+        const int sz = std::min(cr.depth - 1, ((box.z0 + box.nz - 1) >> 1) + 1) - cz0 + 1;
+        std::array<float, kSpan * kSpan * kSpan> block;
+        gatherBlock(coarse, coarseValues, cx0, cy0, cz0, sx, sy, sz, block.data());
+
+        // Near / far coarse cells per fine coordinate, relative to the gathered block.
+        int xNear[kTileSize]{};
+        int xFar[kTileSize]{};
+        int yNear[kTileSize]{};
+        int yFar[kTileSize]{};
+        int zNear[kTileSize]{};
+        int zFar[kTileSize]{};
+        for (int i = 0; i < box.nx; ++i) {
+            xNear[i] = ((box.x0 + i) >> 1) - cx0;
+            xFar[i] = prolongationNeighbour(box.x0 + i, cr.width) - cx0;
+        }
+        for (int i = 0; i < box.ny; ++i) {
+            yNear[i] = ((box.y0 + i) >> 1) - cy0;
+            yFar[i] = prolongationNeighbour(box.y0 + i, cr.height) - cy0;
+        }
+        for (int i = 0; i < box.nz; ++i) {
+            zNear[i] = ((box.z0 + i) >> 1) - cz0;
+            zFar[i] = prolongationNeighbour(box.z0 + i, cr.depth) - cz0;
+        }
+
+        std::array<float, kSpan * kSpan * kTileSize> alongX;
+        for (int cz = 0; cz < sz; ++cz) {
+            for (int cy = 0; cy < sy; ++cy) {
+                const float* in = block.data() + (static_cast<std::size_t>(cz) * sy + cy) * sx;
+                float* outRow = alongX.data() + (static_cast<std::size_t>(cz) * sy + cy) * kTileSize;
+                for (int lx = 0; lx < box.nx; ++lx) {
+                    outRow[lx] = 0.75f * in[xNear[lx]] + 0.25f * in[xFar[lx]];
+                }
+            }
+        }
+        std::array<float, kSpan * kTileSize * kTileSize> alongY;
+        for (int cz = 0; cz < sz; ++cz) {
+            for (int ly = 0; ly < box.ny; ++ly) {
+                const float* near = alongX.data() + (static_cast<std::size_t>(cz) * sy + yNear[ly]) * kTileSize;
+                const float* far = alongX.data() + (static_cast<std::size_t>(cz) * sy + yFar[ly]) * kTileSize;
+                float* outRow = alongY.data() + (static_cast<std::size_t>(cz) * kTileSize + ly) * kTileSize;
+                for (int lx = 0; lx < box.nx; ++lx) {
+                    outRow[lx] = 0.75f * near[lx] + 0.25f * far[lx];
+                }
+            }
+        }
+        float* out = fineValues + brick * kTileCells;
+        for (int lz = 0; lz < box.nz; ++lz) {
+            for (int ly = 0; ly < box.ny; ++ly) {
+                const float* near = alongY.data() + (static_cast<std::size_t>(zNear[lz]) * kTileSize + ly) * kTileSize;
+                const float* far = alongY.data() + (static_cast<std::size_t>(zFar[lz]) * kTileSize + ly) * kTileSize;
+                float* outRow = out + localIndex(0, ly, lz);
+                for (int lx = 0; lx < box.nx; ++lx) {
+                    outRow[lx] += 0.75f * near[lx] + 0.25f * far[lx];
+                }
+            }
+        }
+    });
+}
+
+// A coarse tile covers 2x2x2 fine tiles and is active when any of them is.
+void coarsenTiles(const PyroTileGrid& fine, PyroResolution resolution, PyroTileGrid& coarse) {
+    coarse.reset(resolution);
+    std::vector<std::uint8_t> mask(coarse.tileCount(), 0);
+    const int tilesXY = fine.tiles.width * fine.tiles.height;
+    for (const auto tile : fine.active) {
+        const int tx = static_cast<int>(tile) % fine.tiles.width;
+        const int ty = (static_cast<int>(tile) / fine.tiles.width) % fine.tiles.height;
+        const int tz = static_cast<int>(tile) / tilesXY;
+        mask[coarse.tileIndex(tx >> 1, ty >> 1, tz >> 1)] = 1;
+    }
+    coarse.assign(mask);
+}
+
+// The active set can change every step, so the hierarchy is rebuilt for each solve. Only the
+// tile tables and brick-sized buffers are touched; their capacity carries over.
+void buildPressureLevels(PyroPressureWorkspace& workspace, const PyroTileGrid& tiles) {
+    std::size_t levelCount = 1;
+    PyroResolution current = tiles.resolution;
+    while (std::min({current.width, current.height, current.depth}) >= 4 && levelCount < 16) {
+        current = {(current.width + 1) / 2, (current.height + 1) / 2, (current.depth + 1) / 2};
+        ++levelCount;
+    }
+    workspace.levels.resize(levelCount);
+
+    auto& fine = workspace.levels.front();
+    fine.resolution = tiles.resolution;
+    fine.tiles = tiles;
+    fine.solution.clear();
+    fine.rhs.clear();
+    fine.residual.assign(tiles.brickCount() * kTileCells, 0.0f);
+    for (std::size_t i = 1; i < levelCount; ++i) {
+        const auto& parent = workspace.levels[i - 1].resolution;
+        auto& level = workspace.levels[i];
+        level.resolution = {(parent.width + 1) / 2, (parent.height + 1) / 2, (parent.depth + 1) / 2};
+        coarsenTiles(workspace.levels[i - 1].tiles, level.resolution, level.tiles);
+        const auto count = level.tiles.brickCount() * kTileCells;
+        level.solution.assign(count, 0.0f);
+        level.rhs.assign(count, 0.0f);
+        level.residual.assign(count, 0.0f);
+    }
+    const auto count = tiles.brickCount() * kTileCells;
+    workspace.residual.assign(count, 0.0f);
+    workspace.preconditioned.assign(count, 0.0f);
+    workspace.direction.assign(count, 0.0f);
+    workspace.product.assign(count, 0.0f);
+}
+
+// Symmetric V-cycle: red-black pre-smoothing, then the same sweeps in reverse order after the
+// coarse correction, so it can precondition conjugate gradients.
+void pressureVCycle(PyroPressureWorkspace& workspace, std::size_t levelIndex, const float* b, float* x) {
+    auto& level = workspace.levels[levelIndex];
+    const auto& grid = level.tiles;
+    const auto& r = level.resolution;
+    std::fill(x, x + grid.brickCount() * kTileCells, 0.0f);
+
+    if (levelIndex + 1 == workspace.levels.size()) {
+        const int sweeps = std::clamp(2 * std::max({r.width, r.height, r.depth}), 8, 64);
+        for (int i = 0; i < sweeps; ++i) {
+            relaxPressureColor(grid, b, x, 0);
+            relaxPressureColor(grid, b, x, 1);
+        }
+        for (int i = 0; i < sweeps; ++i) {
+            relaxPressureColor(grid, b, x, 1);
+            relaxPressureColor(grid, b, x, 0);
+        }
+        return;
+    }
+
+    for (int i = 0; i < 2; ++i) {
+        relaxPressureColor(grid, b, x, 0);
+        relaxPressureColor(grid, b, x, 1);
+    }
+    computePressureResidual(grid, b, x, level.residual.data());
+    auto& coarse = workspace.levels[levelIndex + 1];
+    restrictResidual(grid, level.residual.data(), coarse.tiles, coarse.rhs.data());
+    pressureVCycle(workspace, levelIndex + 1, coarse.rhs.data(), coarse.solution.data());
+    prolongateAdd(coarse.tiles, coarse.solution.data(), grid, x);
+    for (int i = 0; i < 2; ++i) {
+        relaxPressureColor(grid, b, x, 1);
+        relaxPressureColor(grid, b, x, 0);
+    }
+}
+
+// Dense <-> brick copies for import, export and version 1 cache files.
+template <typename T>
+void copyBricksToDense(const PyroTileGrid& grid, const std::vector<T>& pool, std::vector<T>& dense) {
+    const auto& r = grid.resolution;
+    forEachBrick(grid, [&](std::size_t brick) {
+        const auto box = brickBox(grid, brick);
+        const T* cells = pool.data() + brick * kTileCells;
+        forEachBrickCell(box, [&](int lx, int ly, int lz, std::size_t local) {
+            dense[indexOf(r, box.x0 + lx, box.y0 + ly, box.z0 + lz)] = cells[local];
+        });
+    });
+}
+
+template <typename T>
+void copyDenseToBricks(const PyroTileGrid& grid, std::span<const T> dense, std::vector<T>& pool) {
+    const auto& r = grid.resolution;
+    forEachBrick(grid, [&](std::size_t brick) {
+        const auto box = brickBox(grid, brick);
+        T* cells = pool.data() + brick * kTileCells;
+        forEachBrickCell(box, [&](int lx, int ly, int lz, std::size_t local) {
+            cells[local] = dense[indexOf(r, box.x0 + lx, box.y0 + ly, box.z0 + lz)];
+        });
+    });
+}
+
+template <typename T, typename IsSet>
+void markTilesHolding(const PyroResolution& r, std::span<const T> dense, IsSet&& isSet, const PyroTileGrid& grid, std::vector<std::uint8_t>& mask) {
+    for (int z = 0; z < r.depth; ++z) {
+        for (int y = 0; y < r.height; ++y) {
+            const T* row = dense.data() + indexOf(r, 0, y, z);
+            for (int x = 0; x < r.width; ++x) {
+                if (isSet(row[x])) {
+                    mask[grid.tileIndex(x >> kTileShift, y >> kTileShift, z >> kTileShift)] = 1;
+                    x |= kTileMask;
+                }
+            }
+        }
+    }
+}
+
 }
 
 PyroResolution PyroDomain::resolution() const noexcept {
@@ -67,42 +808,147 @@ float PyroDomain::width() const noexcept { return std::max(0.0f, max.x - min.x);
 float PyroDomain::height() const noexcept { return std::max(0.0f, max.y - min.y); }
 float PyroDomain::depth() const noexcept { return std::max(0.0f, max.z - min.z); }
 
+void PyroTileGrid::reset(PyroResolution cells) {
+    resolution = cells;
+    const auto tilesAlong = [](int count) { return count > 0 ? (count + kTileSize - 1) >> kTileShift : 0; };
+    tiles = {tilesAlong(cells.width), tilesAlong(cells.height), tilesAlong(cells.depth)};
+    slots.assign(tileCount(), kInactive);
+    active.clear();
+    links.clear();
+    openFaces = false;
+}
+
+void PyroTileGrid::assign(std::span<const std::uint8_t> mask) {
+    std::fill(slots.begin(), slots.end(), kInactive);
+    active.clear();
+    for (std::size_t tile = 0; tile < slots.size() && tile < mask.size(); ++tile) {
+        if (mask[tile] != 0) {
+            slots[tile] = static_cast<std::int32_t>(active.size());
+            active.push_back(static_cast<std::uint32_t>(tile));
+        }
+    }
+
+    links.resize(active.size() * 6);
+    openFaces = false;
+    const int tilesXY = tiles.width * tiles.height;
+    for (std::size_t brick = 0; brick < active.size(); ++brick) {
+        const int tile = static_cast<int>(active[brick]);
+        const int t[3] = {tile % tiles.width, (tile / tiles.width) % tiles.height, tile / tilesXY};
+        const int counts[3] = {tiles.width, tiles.height, tiles.depth};
+        for (int face = 0; face < 6; ++face) {
+            const int axis = face >> 1;
+            int n[3] = {t[0], t[1], t[2]};
+            n[axis] += (face & 1) ? 1 : -1;
+            std::int32_t link = kOutside;
+            if (n[axis] >= 0 && n[axis] < counts[axis]) {
+                link = slots[tileIndex(n[0], n[1], n[2])];
+                openFaces = openFaces || link == kInactive;
+            }
+            links[brick * 6 + static_cast<std::size_t>(face)] = link;
+        }
+    }
+}
+
+std::size_t PyroTileGrid::tileCount() const noexcept {
+    return static_cast<std::size_t>(tiles.width) * static_cast<std::size_t>(tiles.height) * static_cast<std::size_t>(tiles.depth);
+}
+
+std::uint32_t PyroTileGrid::tileIndex(int tx, int ty, int tz) const noexcept {
+    return static_cast<std::uint32_t>(tx + tiles.width * (ty + tiles.height * tz));
+}
+
+std::int64_t PyroTileGrid::offsetOf(int x, int y, int z) const noexcept {
+    if (x < 0 || y < 0 || z < 0 || x >= resolution.width || y >= resolution.height || z >= resolution.depth) {
+        return -1;
+    }
+    const auto slot = slots[tileIndex(x >> kTileShift, y >> kTileShift, z >> kTileShift)];
+    if (slot < 0) {
+        return -1;
+    }
+    return static_cast<std::int64_t>(static_cast<std::size_t>(slot) * kTileCells + localIndex(x & kTileMask, y & kTileMask, z & kTileMask));
+}
+
+namespace {
+
+template <typename View>
+inline std::int64_t viewOffset(const View& view, int x, int y, int z) noexcept {
+    if (view.tiles != nullptr) {
+        return view.tiles->offsetOf(x, y, z);
+    }
+    const auto& r = view.resolution;
+    if (x < 0 || y < 0 || z < 0 || x >= r.width || y >= r.height || z >= r.depth) {
+        return -1;
+    }
+    return static_cast<std::int64_t>(indexOf(r, x, y, z));
+}
+
+// at() hands out a reference, so a cell in an inactive tile (or outside the domain) has
+// nothing to refer to. Writing through it must not silently land elsewhere.
+template <typename View>
+std::size_t storedOffset(const View& view, int x, int y, int z) {
+    const auto offset = viewOffset(view, x, y, z);
+    if (offset < 0 || static_cast<std::size_t>(offset) >= view.values.size()) {
+        throw std::out_of_range("Pyro field cell is not stored");
+    }
+    return static_cast<std::size_t>(offset);
+}
+
+}
+
 bool PyroScalarFieldView::empty() const noexcept { return values.empty(); }
 std::size_t PyroScalarFieldView::size() const noexcept { return values.size(); }
-float& PyroScalarFieldView::at(int x, int y, int z) const { return values[indexOf(resolution, x, y, z)]; }
+bool PyroScalarFieldView::contains(int x, int y, int z) const noexcept { return viewOffset(*this, x, y, z) >= 0; }
+float& PyroScalarFieldView::at(int x, int y, int z) const { return values[storedOffset(*this, x, y, z)]; }
+float PyroScalarFieldView::value(int x, int y, int z) const noexcept {
+    const auto offset = viewOffset(*this, x, y, z);
+    return offset < 0 ? 0.0f : values[static_cast<std::size_t>(offset)];
+}
 
 bool PyroConstScalarFieldView::empty() const noexcept { return values.empty(); }
 std::size_t PyroConstScalarFieldView::size() const noexcept { return values.size(); }
-const float& PyroConstScalarFieldView::at(int x, int y, int z) const { return values[indexOf(resolution, x, y, z)]; }
+bool PyroConstScalarFieldView::contains(int x, int y, int z) const noexcept { return viewOffset(*this, x, y, z) >= 0; }
+const float& PyroConstScalarFieldView::at(int x, int y, int z) const { return values[storedOffset(*this, x, y, z)]; }
+float PyroConstScalarFieldView::value(int x, int y, int z) const noexcept {
+    const auto offset = viewOffset(*this, x, y, z);
+    return offset < 0 ? 0.0f : values[static_cast<std::size_t>(offset)];
+}
 
 bool PyroVectorFieldView::empty() const noexcept { return values.empty(); }
 std::size_t PyroVectorFieldView::size() const noexcept { return values.size(); }
-PyroVec3& PyroVectorFieldView::at(int x, int y, int z) const { return values[indexOf(resolution, x, y, z)]; }
+bool PyroVectorFieldView::contains(int x, int y, int z) const noexcept { return viewOffset(*this, x, y, z) >= 0; }
+PyroVec3& PyroVectorFieldView::at(int x, int y, int z) const { return values[storedOffset(*this, x, y, z)]; }
+PyroVec3 PyroVectorFieldView::value(int x, int y, int z) const noexcept {
+    const auto offset = viewOffset(*this, x, y, z);
+    return offset < 0 ? PyroVec3{} : values[static_cast<std::size_t>(offset)];
+}
 
 bool PyroConstVectorFieldView::empty() const noexcept { return values.empty(); }
 std::size_t PyroConstVectorFieldView::size() const noexcept { return values.size(); }
-const PyroVec3& PyroConstVectorFieldView::at(int x, int y, int z) const { return values[indexOf(resolution, x, y, z)]; }
+bool PyroConstVectorFieldView::contains(int x, int y, int z) const noexcept { return viewOffset(*this, x, y, z) >= 0; }
+const PyroVec3& PyroConstVectorFieldView::at(int x, int y, int z) const { return values[storedOffset(*this, x, y, z)]; }
+PyroVec3 PyroConstVectorFieldView::value(int x, int y, int z) const noexcept {
+    const auto offset = viewOffset(*this, x, y, z);
+    return offset < 0 ? PyroVec3{} : values[static_cast<std::size_t>(offset)];
+}
 
 void PyroFieldSet::resize(PyroResolution resolution) {
-    resolution_ = resolution;
-    const auto count = cellCount();
-    density_.assign(count, 0.0f);
-    temperature_.assign(count, 0.0f);
-    fuel_.assign(count, 0.0f);
-    pressure_.assign(count, 0.0f);
-    divergence_.assign(count, 0.0f);
-    velocity_.assign(count, {});
+    releaseTiles(resolution);
+    activateAll();
 }
 
-void PyroFieldSet::clear() {
-    std::fill(density_.begin(), density_.end(), 0.0f);
-    std::fill(temperature_.begin(), temperature_.end(), 0.0f);
-    std::fill(fuel_.begin(), fuel_.end(), 0.0f);
-    std::fill(pressure_.begin(), pressure_.end(), 0.0f);
-    std::fill(divergence_.begin(), divergence_.end(), 0.0f);
-    std::fill(velocity_.begin(), velocity_.end(), PyroVec3{});
+void PyroFieldSet::releaseTiles(PyroResolution resolution) {
+    resolution_ = resolution;
+    tiles_.reset(cellCount() > 0 ? resolution : PyroResolution{});
+    density_.clear();
+    temperature_.clear();
+    fuel_.clear();
+    pressure_.clear();
+    divergence_.clear();
+    velocity_.clear();
 }
 
+void PyroFieldSet::clear() { resize(resolution_); }
+
 std::size_t PyroFieldSet::cellCount() const noexcept {
     if (resolution_.width <= 0 || resolution_.height <= 0 || resolution_.depth <= 0) {
         return 0;
@@ -112,21 +958,174 @@ std::size_t PyroFieldSet::cellCount() const noexcept {
         * static_cast<std::size_t>(resolution_.depth);
 }
 
-PyroScalarFieldView PyroFieldSet::densityView() noexcept { return {std::span<float>(density_), resolution_}; }
-PyroConstScalarFieldView PyroFieldSet::densityView() const noexcept { return {std::span<const float>(density_), resolution_}; }
-PyroScalarFieldView PyroFieldSet::temperatureView() noexcept { return {std::span<float>(temperature_), resolution_}; }
-PyroConstScalarFieldView PyroFieldSet::temperatureView() const noexcept { return {std::span<const float>(temperature_), resolution_}; }
-PyroScalarFieldView PyroFieldSet::fuelView() noexcept { return {std::span<float>(fuel_), resolution_}; }
-PyroConstScalarFieldView PyroFieldSet::fuelView() const noexcept { return {std::span<const float>(fuel_), resolution_}; }
-PyroScalarFieldView PyroFieldSet::pressureView() noexcept { return {std::span<float>(pressure_), resolution_}; }
-PyroConstScalarFieldView PyroFieldSet::pressureView() const noexcept { return {std::span<const float>(pressure_), resolution_}; }
-PyroScalarFieldView PyroFieldSet::divergenceView() noexcept { return {std::span<float>(divergence_), resolution_}; }
-PyroConstScalarFieldView PyroFieldSet::divergenceView() const noexcept { return {std::span<const float>(divergence_), resolution_}; }
-PyroVectorFieldView PyroFieldSet::velocityView() noexcept { return {std::span<PyroVec3>(velocity_), resolution_}; }
-PyroConstVectorFieldView PyroFieldSet::velocityView() const noexcept { return {std::span<const PyroVec3>(velocity_), resolution_}; }
+std::size_t PyroFieldSet::activeCellCount() const noexcept { return tiles_.brickCount() * kTileCells; }
+
+void PyroFieldSet::activateAll() {
+    const std::vector<std::uint8_t> mask(tiles_.tileCount(), 1);
+    setActiveTiles(mask);
+}
+
+void PyroFieldSet::setActiveTiles(std::span<const std::uint8_t> mask) {
+    if (mask.size() != tiles_.tileCount()) {
+        return;
+    }
+    PyroTileGrid next = tiles_;
+    next.assign(mask);
+    if (next.active == tiles_.active) {
+        return;
+    }
+
+    const auto remap = [&](auto& pool) {
+        std::remove_reference_t<decltype(pool)> remapped(next.brickCount() * kTileCells);
+        forEachBrick(next, [&](std::size_t brick) {
+            const auto previous = tiles_.slots[next.active[brick]];
+            if (previous >= 0) {
+                const auto source = pool.begin() + static_cast<std::ptrdiff_t>(static_cast<std::size_t>(previous) * kTileCells);
+                std::copy(source, source + static_cast<std::ptrdiff_t>(kTileCells), remapped.begin() + static_cast<std::ptrdiff_t>(brick * kTileCells));
+            }
+        });
+        pool = std::move(remapped);
+    };
+    remap(density_);
+    remap(temperature_);
+    remap(fuel_);
+    remap(pressure_);
+    remap(divergence_);
+    remap(velocity_);
+    tiles_ = std::move(next);
+}
+
+std::vector<float>* PyroFieldSet::scalarStorage(PyroFieldChannel channel) noexcept {
+    return const_cast<std::vector<float>*>(std::as_const(*this).scalarStorage(channel));
+}
+
+const std::vector<float>* PyroFieldSet::scalarStorage(PyroFieldChannel channel) const noexcept {
+    switch (channel) {
+    case PyroFieldChannel::Density: return &density_;
+    case PyroFieldChannel::Temperature: return &temperature_;
+    case PyroFieldChannel::Fuel: return &fuel_;
+    case PyroFieldChannel::Pressure: return &pressure_;
+    case PyroFieldChannel::Divergence: return &divergence_;
+    case PyroFieldChannel::Velocity:
+    case PyroFieldChannel::Color: break;
+    }
+    return nullptr;
+}
+
+bool PyroFieldSet::importDense(PyroFieldChannel channel, std::span<const float> values) {
+    if (scalarStorage(channel) == nullptr || values.size() != cellCount()) {
+        return false;
+    }
+    std::vector<std::uint8_t> mask(tiles_.tileCount(), 0);
+    for (const auto tile : tiles_.active) {
+        mask[tile] = 1;
+    }
+    markTilesHolding(resolution_, values, [](float v) { return v != 0.0f; }, tiles_, mask);
+    setActiveTiles(mask);
+    copyDenseToBricks(tiles_, values, *scalarStorage(channel));
+    return true;
+}
+
+bool PyroFieldSet::importDenseVelocity(std::span<const PyroVec3> values) {
+    if (values.size() != cellCount()) {
+        return false;
+    }
+    std::vector<std::uint8_t> mask(tiles_.tileCount(), 0);
+    for (const auto tile : tiles_.active) {
+        mask[tile] = 1;
+    }
+    markTilesHolding(resolution_, values, [](const PyroVec3& v) { return v.x != 0.0f || v.y != 0.0f || v.z != 0.0f; }, tiles_, mask);
+    setActiveTiles(mask);
+    copyDenseToBricks(tiles_, values, velocity_);
+    return true;
+}
+
+std::vector<float> PyroFieldSet::exportDense(PyroFieldChannel channel) const {
+    std::vector<float> dense;
+    if (const auto* pool = scalarStorage(channel)) {
+        dense.assign(cellCount(), 0.0f);
+        copyBricksToDense(tiles_, *pool, dense);
+    }
+    return dense;
+}
+
+std::vector<PyroVec3> PyroFieldSet::exportDenseVelocity() const {
+    std::vector<PyroVec3> dense(cellCount());
+    copyBricksToDense(tiles_, velocity_, dense);
+    return dense;
+}
+
+PyroFieldSnapshot PyroFieldSet::capture() const {
+    PyroFieldSnapshot snapshot{};
+    snapshot.resolution = resolution_;
+    snapshot.activeTiles = tiles_.active;
+    snapshot.density = density_;
+    snapshot.temperature = temperature_;
+    snapshot.fuel = fuel_;
+    snapshot.pressure = pressure_;
+    snapshot.divergence = divergence_;
+    snapshot.velocity = velocity_;
+    return snapshot;
+}
+
+bool PyroFieldSet::restore(const PyroFieldSnapshot& snapshot) {
+    if (snapshot.activeTiles.empty() && !snapshot.density.empty()) {
+        resize(snapshot.resolution);
+        const auto count = cellCount();
+        if (snapshot.density.size() != count || snapshot.temperature.size() != count || snapshot.fuel.size() != count
+            || snapshot.pressure.size() != count || snapshot.divergence.size() != count || snapshot.velocity.size() != count) {
+            return false;
+        }
+        return importDense(PyroFieldChannel::Density, snapshot.density)
+            && importDense(PyroFieldChannel::Temperature, snapshot.temperature)
+            && importDense(PyroFieldChannel::Fuel, snapshot.fuel)
+            && importDense(PyroFieldChannel::Pressure, snapshot.pressure)
+            && importDense(PyroFieldChannel::Divergence, snapshot.divergence)
+            && importDenseVelocity(snapshot.velocity);
+    }
+
+    releaseTiles(snapshot.resolution);
+    const auto count = snapshot.activeTiles.size() * kTileCells;
+    if (snapshot.density.size() != count || snapshot.temperature.size() != count || snapshot.fuel.size() != count
+        || snapshot.pressure.size() != count || snapshot.divergence.size() != count || snapshot.velocity.size() != count) {
+        return false;
+    }
+    std::vector<std::uint8_t> mask(tiles_.tileCount(), 0);
+    for (const auto tile : snapshot.activeTiles) {
+        if (tile >= mask.size()) {
+            return false;
+        }
+        mask[tile] = 1;
+    }
+    tiles_.assign(mask);
+    if (tiles_.active != snapshot.activeTiles) {
+        tiles_.reset(resolution_);
+        return false;
+    }
+    density_ = snapshot.density;
+    temperature_ = snapshot.temperature;
+    fuel_ = snapshot.fuel;
+    pressure_ = snapshot.pressure;
+    divergence_ = snapshot.divergence;
+    velocity_ = snapshot.velocity;
+    return true;
+}
+
+PyroScalarFieldView PyroFieldSet::densityView() noexcept { return {std::span<float>(density_), resolution_, &tiles_}; }
+PyroConstScalarFieldView PyroFieldSet::densityView() const noexcept { return {std::span<const float>(density_), resolution_, &tiles_}; }
+PyroScalarFieldView PyroFieldSet::temperatureView() noexcept { return {std::span<float>(temperature_), resolution_, &tiles_}; }
+PyroConstScalarFieldView PyroFieldSet::temperatureView() const noexcept { return {std::span<const float>(temperature_), resolution_, &tiles_}; }
+PyroScalarFieldView PyroFieldSet::fuelView() noexcept { return {std::span<float>(fuel_), resolution_, &tiles_}; }
+PyroConstScalarFieldView PyroFieldSet::fuelView() const noexcept { return {std::span<const float>(fuel_), resolution_, &tiles_}; }
+PyroScalarFieldView PyroFieldSet::pressureView() noexcept { return {std::span<float>(pressure_), resolution_, &tiles_}; }
+PyroConstScalarFieldView PyroFieldSet::pressureView() const noexcept { return {std::span<const float>(pressure_), resolution_, &tiles_}; }
+PyroScalarFieldView PyroFieldSet::divergenceView() noexcept { return {std::span<float>(divergence_), resolution_, &tiles_}; }
+PyroConstScalarFieldView PyroFieldSet::divergenceView() const noexcept { return {std::span<const float>(divergence_), resolution_, &tiles_}; }
+PyroVectorFieldView PyroFieldSet::velocityView() noexcept { return {std::span<PyroVec3>(velocity_), resolution_, &tiles_}; }
+PyroConstVectorFieldView PyroFieldSet::velocityView() const noexcept { return {std::span<const PyroVec3>(velocity_), resolution_, &tiles_}; }
 
 PyroMemoryEstimate PyroFieldSet::estimateMemory() const noexcept {
-    const auto count = cellCount();
+    const auto count = activeCellCount();
     PyroMemoryEstimate estimate{};
     estimate.resolution = resolution_;
     estimate.densityBytes = count * sizeof(float);
@@ -135,8 +1134,14 @@ PyroMemoryEstimate PyroFieldSet::estimateMemory() const noexcept {
     estimate.pressureBytes = count * sizeof(float);
     estimate.divergenceBytes = count * sizeof(float);
     estimate.velocityBytes = count * sizeof(PyroVec3);
+    estimate.tileTableBytes = tiles_.slots.size() * sizeof(std::int32_t)
+        + tiles_.active.size() * sizeof(std::uint32_t)
+        + tiles_.links.size() * sizeof(std::int32_t);
     estimate.totalBytes = estimate.densityBytes + estimate.temperatureBytes + estimate.fuelBytes +
-        estimate.pressureBytes + estimate.divergenceBytes + estimate.velocityBytes;
+        estimate.pressureBytes + estimate.divergenceBytes + estimate.velocityBytes + estimate.tileTableBytes;
+    estimate.activeTiles = tiles_.brickCount();
+    estimate.totalTiles = tiles_.tileCount();
+    estimate.denseBytes = static_cast<std::size_t>(estimatePyroMemoryBytes(resolution_));
     return estimate;
 }
 
@@ -163,7 +1168,7 @@ float PyroFieldSet::sampleScalar(const PyroConstScalarFieldView& view, const Pyr
     const float tx = fx - static_cast<float>(x0);
     const float ty = fy - static_cast<float>(y0);
     const float tz = fz - static_cast<float>(z0);
-    const auto sample = [&](int x, int y, int z) { return view.values[indexOf(view.resolution, x, y, z)]; };
+    const auto sample = [&](int x, int y, int z) { return view.value(x, y, z); };
     const float c000 = sample(x0, y0, z0);
     const float c100 = sample(x1, y0, z0);
     const float c010 = sample(x0, y1, z0);
@@ -204,7 +1209,7 @@ PyroVec3 PyroFieldSet::sampleVector(const PyroConstVectorFieldView& view, const
     const float tx = fx - static_cast<float>(x0);
     const float ty = fy - static_cast<float>(y0);
     const float tz = fz - static_cast<float>(z0);
-    const auto sample = [&](int x, int y, int z) { return view.values[indexOf(view.resolution, x, y, z)]; };
+    const auto sample = [&](int x, int y, int z) { return view.value(x, y, z); };
     const auto lerpVec = [](const PyroVec3& a, const PyroVec3& b, float t) {
         return PyroVec3{
             a.x + (b.x - a.x) * t,
@@ -299,12 +1304,11 @@ void PyroSimulation::reset() {
 }
 
 void PyroSimulation::seek(std::uint64_t frameIndex, double timeSeconds) {
-    if (restoreCheckpoint(frameIndex)) {
-        timeSeconds_ = timeSeconds;
-        return;
+    if (!restoreCheckpoint(frameIndex)) {
+        frameIndex_ = frameIndex;
     }
-    frameIndex_ = frameIndex;
     timeSeconds_ = timeSeconds;
+    prefetchCheckpointsAround(frameIndex);
 }
 
 bool PyroSimulation::isInsideDomain(const PyroVec3& position) const noexcept {
@@ -313,10 +1317,6 @@ bool PyroSimulation::isInsideDomain(const PyroVec3& position) const noexcept {
         && position.z >= domain_.min.z && position.z <= domain_.max.z;
 }
 
-std::size_t PyroSimulation::cellIndex(int x, int y, int z) const noexcept {
-    return indexOf(fields_.resolution(), x, y, z);
-}
-
 void PyroSimulation::setSources(std::span<const PyroSourceState> sources) {
     ownedSources_.assign(sources.begin(), sources.end());
     sources_ = ownedSources_;
@@ -327,174 +1327,6 @@ void PyroSimulation::setColliders(std::span<const PyroColliderState> colliders)
     colliders_ = ownedColliders_;
 }
 
-void PyroSimulation::storeCheckpoint() {
-    PyroFieldSnapshot snapshot{};
-    snapshot.resolution = fields_.resolution();
-    snapshot.density = fields_.densityStorage();
-    snapshot.temperature = fields_.temperatureStorage();
-    snapshot.fuel = fields_.fuelStorage();
-    snapshot.pressure = fields_.pressureStorage();
-    snapshot.divergence = fields_.divergenceStorage();
-    snapshot.velocity = fields_.velocityStorage();
-    checkpointCache_[frameIndex_] = std::move(snapshot);
-    if (!cacheDirectory_.empty()) {
-        const auto path = cacheDirectory_ / (std::to_string(frameIndex_) + ".pyroc");
-        saveCheckpointSnapshot(checkpointCache_[frameIndex_], path);
-    }
-}
-
-bool PyroSimulation::saveCheckpointSnapshot(const PyroFieldSnapshot& snapshot, const std::filesystem::path& path) const {
-    std::error_code ec;
-    if (!path.parent_path().empty()) {
-        std::filesystem::create_directories(path.parent_path(), ec);
-    }
-
-    std::ofstream out(path, std::ios::binary);
-    if (!out) {
-        return false;
-    }
-
-    const std::uint32_t magic = 0x5059524Fu; // PYRO
-    const std::uint32_t version = 1;
-    out.write(reinterpret_cast<const char*>(&magic), sizeof(magic));
-    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
-    out.write(reinterpret_cast<const char*>(&snapshot.resolution), sizeof(snapshot.resolution));
-    const auto writeVector = [&out](const auto& data) {
-        const std::uint64_t size = static_cast<std::uint64_t>(data.size());
-        out.write(reinterpret_cast<const char*>(&size), sizeof(size));
-        if (size > 0) {
-            out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(data[0])));
-        }
-    };
-
-    writeVector(snapshot.density);
-    writeVector(snapshot.temperature);
-    writeVector(snapshot.fuel);
-    writeVector(snapshot.pressure);
-    writeVector(snapshot.divergence);
-    writeVector(snapshot.velocity);
-    return static_cast<bool>(out);
-}
-
-bool PyroSimulation::loadCheckpointSnapshot(PyroFieldSnapshot& snapshot, const std::filesystem::path& path) const {
-    std::ifstream in(path, std::ios::binary);
-    if (!in) {
-        return false;
-    }
-
-    std::uint32_t magic = 0;
-    std::uint32_t version = 0;
-    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
-    in.read(reinterpret_cast<char*>(&version), sizeof(version));
-    if (!in || magic != 0x5059524Fu || version != 1) {
-        return false;
-    }
-
-    in.read(reinterpret_cast<char*>(&snapshot.resolution), sizeof(snapshot.resolution));
-    if (!in) {
-        return false;
-    }
-
-    const auto readVector = [&in](auto& data) {
-        std::uint64_t size = 0;
-        in.read(reinterpret_cast<char*>(&size), sizeof(size));
-        if (!in) {
-            return false;
-        }
-        data.resize(static_cast<std::size_t>(size));
-        if (size > 0) {
-            in.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size() * sizeof(data[0])));
-        }
-        return static_cast<bool>(in);
-    };
-
-    return readVector(snapshot.density)
-        && readVector(snapshot.temperature)
-        && readVector(snapshot.fuel)
-        && readVector(snapshot.pressure)
-        && readVector(snapshot.divergence)
-        && readVector(snapshot.velocity);
-}
-
-PyroCacheStatus PyroSimulation::saveCheckpointToDisk(std::uint64_t frameIndex) const {
-    PyroCacheStatus status{};
-    status.supported = !cacheDirectory_.empty();
-    if (!status.supported) {
-        status.reason = "cache directory is empty";
-        return status;
-    }
-
-    const auto it = checkpointCache_.find(frameIndex);
-    if (it == checkpointCache_.end()) {
-        status.reason = "checkpoint not found in memory";
-        return status;
-    }
-
-    const auto path = cacheDirectory_ / (std::to_string(frameIndex) + ".pyroc");
-    status.loaded = saveCheckpointSnapshot(it->second, path);
-    if (!status.loaded) {
-        status.reason = "failed to write checkpoint";
-    }
-    return status;
-}
-
-PyroCacheStatus PyroSimulation::loadCheckpointFromDisk(std::uint64_t frameIndex) {
-    PyroCacheStatus status{};
-    status.supported = !cacheDirectory_.empty();
-    if (!status.supported) {
-        status.reason = "cache directory is empty";
-        return status;
-    }
-
-    PyroFieldSnapshot snapshot{};
-    const auto path = cacheDirectory_ / (std::to_string(frameIndex) + ".pyroc");
-    status.loaded = loadCheckpointSnapshot(snapshot, path);
-    if (!status.loaded) {
-        status.reason = "failed to read checkpoint";
-        return status;
-    }
-
-    fields_.resize(snapshot.resolution);
-    fields_.densityStorage() = std::move(snapshot.density);
-    fields_.temperatureStorage() = std::move(snapshot.temperature);
-    fields_.fuelStorage() = std::move(snapshot.fuel);
-    fields_.pressureStorage() = std::move(snapshot.pressure);
-    fields_.divergenceStorage() = std::move(snapshot.divergence);
-    fields_.velocityStorage() = std::move(snapshot.velocity);
-    frameIndex_ = frameIndex;
-    checkpointCache_[frameIndex] = PyroFieldSnapshot{
-        .resolution = fields_.resolution(),
-        .density = fields_.densityStorage(),
-        .temperature = fields_.temperatureStorage(),
-        .fuel = fields_.fuelStorage(),
-        .pressure = fields_.pressureStorage(),
-        .divergence = fields_.divergenceStorage(),
-        .velocity = fields_.velocityStorage()
-    };
-    return status;
-}
-
-bool PyroSimulation::restoreCheckpoint(std::uint64_t frameIndex) {
-    const auto it = checkpointCache_.find(frameIndex);
-    if (it == checkpointCache_.end()) {
-        if (cacheDirectory_.empty()) {
-            return false;
-        }
-        auto status = loadCheckpointFromDisk(frameIndex);
-        return status.loaded;
-    }
-    const auto& snapshot = it->second;
-    fields_.resize(snapshot.resolution);
-    fields_.densityStorage() = snapshot.density;
-    fields_.temperatureStorage() = snapshot.temperature;
-    fields_.fuelStorage() = snapshot.fuel;
-    fields_.pressureStorage() = snapshot.pressure;
-    fields_.divergenceStorage() = snapshot.divergence;
-    fields_.velocityStorage() = snapshot.velocity;
-    frameIndex_ = frameIndex;
-    return true;
-}
-
 bool PyroSimulation::isInsideCollider(const PyroColliderState& collider, const PyroVec3& position) const noexcept {
     if (!collider.enabled) {
         return false;
@@ -515,6 +1347,7 @@ bool PyroSimulation::isInsideCollider(const PyroColliderState& collider, const P
 
 void PyroSimulation::applyColliders() {
     const auto resolution = fields_.resolution();
+    const auto& tiles = fields_.tiles();
     auto velocity = fields_.velocityView();
     auto density = fields_.densityView();
     auto temperature = fields_.temperatureView();
@@ -540,10 +1373,11 @@ void PyroSimulation::applyColliders() {
                         (static_cast<float>(y) + 0.5f) * domain_.voxelSize + domain_.min.y,
                         (static_cast<float>(z) + 0.5f) * domain_.voxelSize + domain_.min.z
                     };
-                    if (!isInsideCollider(collider, samplePos)) {
+                    const auto offset = tiles.offsetOf(x, y, z);
+                    if (offset < 0 || !isInsideCollider(collider, samplePos)) {
                         continue;
                     }
-                    const auto idx = cellIndex(x, y, z);
+                    const auto idx = static_cast<std::size_t>(offset);
                     density.values[idx] = 0.0f;
                     temperature.values[idx] = 0.0f;
                     fuel.values[idx] = 0.0f;
@@ -561,7 +1395,6 @@ void PyroSimulation::applyCombustion(float deltaSeconds) {
         return;
     }
 
-    const auto resolution = fields_.resolution();
     auto density = fields_.densityView();
     auto temperature = fields_.temperatureView();
     auto fuel = fields_.fuelView();
@@ -573,21 +1406,16 @@ void PyroSimulation::applyCombustion(float deltaSeconds) {
     const float heatRelease = 1.4f;
     const float smokeYield = 0.9f;
 
-    Parallel::For(0, resolution.depth, resolution.width * resolution.height, [&](int z) {
-        for (int y = 0; y < resolution.height; ++y) {
-            for (int x = 0; x < resolution.width; ++x) {
-                const auto idx = cellIndex(x, y, z);
-                const float ignite = std::clamp(temperature.values[idx] + fuel.values[idx] - ignitionThreshold, 0.0f, 1.0f);
-                const float burned = std::min(fuel.values[idx], burnRate * ignite * dt);
-                if (burned <= 0.0f) {
-                    continue;
-                }
-                fuel.values[idx] -= burned;
-                temperature.values[idx] += burned * heatRelease;
-                density.values[idx] += burned * smokeYield;
-                velocity.values[idx].y += burned * 0.15f;
-            }
+    forEachStoredCell(fields_.tiles(), [&](std::size_t idx) {
+        const float ignite = std::clamp(temperature.values[idx] + fuel.values[idx] - ignitionThreshold, 0.0f, 1.0f);
+        const float burned = std::min(fuel.values[idx], burnRate * ignite * dt);
+        if (burned <= 0.0f) {
+            return;
         }
+        fuel.values[idx] -= burned;
+        temperature.values[idx] += burned * heatRelease;
+        density.values[idx] += burned * smokeYield;
+        velocity.values[idx].y += burned * 0.15f;
     });
 }
 
@@ -596,24 +1424,22 @@ void PyroSimulation::applyVorticityConfinement(float deltaSeconds) {
         return;
     }
 
-    const auto resolution = fields_.resolution();
+    const auto& tiles = fields_.tiles();
     auto velocity = fields_.velocityView();
-    const auto curl = fields_.velocityView();
+    const PyroVec3* curl = velocity.values.data();
     const float dt = static_cast<float>(deltaSeconds);
 
-    for (int z = 0; z < resolution.depth; ++z) {
-        for (int y = 0; y < resolution.height; ++y) {
-            for (int x = 0; x < resolution.width; ++x) {
-                const auto idx = cellIndex(x, y, z);
-                const int xm = std::max(0, x - 1);
-                const int xp = std::min(resolution.width - 1, x + 1);
-                const int ym = std::max(0, y - 1);
-                const int yp = std::min(resolution.height - 1, y + 1);
-                const int zm = std::max(0, z - 1);
-                const int zp = std::min(resolution.depth - 1, z + 1);
-                const float wx = (curl.values[cellIndex(xp, y, z)].y - curl.values[cellIndex(xm, y, z)].y) * 0.5f;
-                const float wy = (curl.values[cellIndex(x, yp, z)].z - curl.values[cellIndex(x, ym, z)].z) * 0.5f;
-                const float wz = (curl.values[cellIndex(x, y, zp)].x - curl.values[cellIndex(x, y, zm)].x) * 0.5f;
+    for (std::size_t brick = 0; brick < tiles.brickCount(); ++brick) {
+        const auto box = brickBox(tiles, brick);
+        const std::size_t base = brick * kTileCells;
+        forEachBrickRow(box, [&](int ly, int lz, std::size_t rowStart) {
+            const auto s = stencilRow(tiles, curl, brick, box, ly, lz, true);
+            for (int lx = 0; lx < box.nx; ++lx) {
+                const auto idx = base + rowStart + static_cast<std::size_t>(lx);
+                const auto n = faceValues(s, lx, box.nx);
+                const float wx = (n.xp.y - n.xm.y) * 0.5f;
+                const float wy = (n.yp.z - n.ym.z) * 0.5f;
+                const float wz = (n.zp.x - n.zm.x) * 0.5f;
                 const float len = std::sqrt(wx * wx + wy * wy + wz * wz) + 1e-5f;
                 const float nx = wx / len;
                 const float ny = wy / len;
@@ -623,8 +1449,89 @@ void PyroSimulation::applyVorticityConfinement(float deltaSeconds) {
                 velocity.values[idx].y += (nz - nx) * strength;
                 velocity.values[idx].z += (nx - ny) * strength;
             }
+        });
+    }
+}
+
+void PyroSimulation::updateActiveTiles() {
+    if (!settings_.sparseTiles) {
+        if (fields_.tiles().brickCount() != fields_.tiles().tileCount()) {
+            fields_.activateAll();
         }
+        return;
     }
+
+    const auto& tiles = fields_.tiles();
+    const auto resolution = fields_.resolution();
+    const float threshold = std::max(0.0f, settings_.activityThreshold);
+    std::vector<std::uint8_t> live(tiles.tileCount(), 0);
+    const float* density = fields_.density_.data();
+    const float* temperature = fields_.temperature_.data();
+    const float* fuel = fields_.fuel_.data();
+    // Velocity is left out on purpose: the projection spreads a small flow over the whole
+    // domain, so a velocity test would keep every tile alive after a few frames.
+    forEachBrick(tiles, [&](std::size_t brick) {
+        const std::size_t begin = brick * kTileCells;
+        for (std::size_t i = begin; i < begin + kTileCells; ++i) {
+            if (density[i] > threshold || temperature[i] > threshold || fuel[i] > threshold) {
+                live[tiles.active[brick]] = 1;
+                return;
+            }
+        }
+    });
+
+    std::vector<std::uint8_t> mask(tiles.tileCount(), 0);
+    const auto markBox = [&](int x0, int y0, int z0, int x1, int y1, int z1) {
+        const auto tileRange = [](int lo, int hi, int count) {
+            return std::pair{std::clamp(lo, 0, count - 1), std::clamp(hi, 0, count - 1)};
+        };
+        const auto [tx0, tx1] = tileRange(x0, x1, tiles.tiles.width);
+        const auto [ty0, ty1] = tileRange(y0, y1, tiles.tiles.height);
+        const auto [tz0, tz1] = tileRange(z0, z1, tiles.tiles.depth);
+        for (int tz = tz0; tz <= tz1; ++tz) {
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    mask[tiles.tileIndex(tx, ty, tz)] = 1;
+                }
+            }
+        }
+    };
+    for (int tz = 0; tz < tiles.tiles.depth; ++tz) {
+        for (int ty = 0; ty < tiles.tiles.height; ++ty) {
+            for (int tx = 0; tx < tiles.tiles.width; ++tx) {
+                if (live[tiles.tileIndex(tx, ty, tz)] != 0) {
+                    markBox(tx - 1, ty - 1, tz - 1, tx + 1, ty + 1, tz + 1);
+                }
+            }
+        }
+    }
+
+    const float voxel = std::max(domain_.voxelSize, 1e-6f);
+    const auto markRegion = [&](const PyroVec3& center, const PyroVec3& extent) {
+        const auto cellRange = [&](float c, float e, float origin, int count) {
+            const int centerCell = static_cast<int>((c - origin) / domain_.voxelSize);
+            const int radius = std::max(0, static_cast<int>(std::ceil(e / voxel)));
+            return std::pair{std::clamp(centerCell - radius, 0, count - 1) >> kTileShift,
+                std::clamp(centerCell + radius, 0, count - 1) >> kTileShift};
+        };
+        const auto [x0, x1] = cellRange(center.x, extent.x, domain_.min.x, resolution.width);
+        const auto [y0, y1] = cellRange(center.y, extent.y, domain_.min.y, resolution.height);
+        const auto [z0, z1] = cellRange(center.z, extent.z, domain_.min.z, resolution.depth);
+        markBox(x0, y0, z0, x1, y1, z1);
+    };
+    for (const auto& source : sources_) {
+        if (source.enabled && isInsideDomain(source.position)) {
+            markRegion(source.position, source.extent);
+        }
+    }
+    // A moving no-slip collider pushes the air around it even where nothing is visible yet.
+    for (const auto& collider : colliders_) {
+        if (collider.enabled && collider.noSlip
+            && (collider.velocity.x != 0.0f || collider.velocity.y != 0.0f || collider.velocity.z != 0.0f)) {
+            markRegion(collider.center, collider.extent);
+        }
+    }
+    fields_.setActiveTiles(mask);
 }
 
 void PyroSimulation::integrateStep(float deltaSeconds) {
@@ -640,6 +1547,14 @@ void PyroSimulation::integrateStep(float deltaSeconds) {
         return;
     }
 
+    const auto stepStart = std::chrono::steady_clock::now();
+    auto stageStart = stepStart;
+    updateActiveTiles();
+    const auto& tiles = fields_.tiles();
+    stepStats_.activeTiles = tiles.brickCount();
+    stepStats_.tilesMs = elapsedMs(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
     const float dt = static_cast<float>(deltaSeconds);
     auto density = fields_.densityView();
     auto temperature = fields_.temperatureView();
@@ -648,25 +1563,15 @@ void PyroSimulation::integrateStep(float deltaSeconds) {
     auto divergence = fields_.divergenceView();
     auto velocity = fields_.velocityView();
 
-    const auto densityPrev = fields_.densityStorage();
-    const auto temperaturePrev = fields_.temperatureStorage();
-    const auto fuelPrev = fields_.fuelStorage();
-    const auto velocityPrev = fields_.velocityStorage();
-
-    Parallel::For(0, resolution.depth, resolution.width * resolution.height, [&](int z) {
-        for (int y = 0; y < resolution.height; ++y) {
-            for (int x = 0; x < resolution.width; ++x) {
-                const auto idx = cellIndex(x, y, z);
-                density.values[idx] = std::max(0.0f, density.values[idx] - settings_.dissipation * dt);
-                temperature.values[idx] = std::max(0.0f, temperature.values[idx] - settings_.coolingRate * dt);
-                fuel.values[idx] = std::max(0.0f, fuel.values[idx] - settings_.coolingRate * 0.5f * dt);
-                pressure.values[idx] = 0.0f;
-                divergence.values[idx] = 0.0f;
-                velocity.values[idx].x *= std::max(0.0f, 1.0f - settings_.dissipation * dt);
-                velocity.values[idx].y *= std::max(0.0f, 1.0f - settings_.dissipation * dt);
-                velocity.values[idx].z *= std::max(0.0f, 1.0f - settings_.dissipation * dt);
-            }
-        }
+    forEachStoredCell(tiles, [&](std::size_t idx) {
+        density.values[idx] = std::max(0.0f, density.values[idx] - settings_.dissipation * dt);
+        temperature.values[idx] = std::max(0.0f, temperature.values[idx] - settings_.coolingRate * dt);
+        fuel.values[idx] = std::max(0.0f, fuel.values[idx] - settings_.coolingRate * 0.5f * dt);
+        pressure.values[idx] = 0.0f;
+        divergence.values[idx] = 0.0f;
+        velocity.values[idx].x *= std::max(0.0f, 1.0f - settings_.dissipation * dt);
+        velocity.values[idx].y *= std::max(0.0f, 1.0f - settings_.dissipation * dt);
+        velocity.values[idx].z *= std::max(0.0f, 1.0f - settings_.dissipation * dt);
     });
 
     for (const auto& source : sources_) {
@@ -684,7 +1589,11 @@ void PyroSimulation::integrateStep(float deltaSeconds) {
         for (int z = std::max(0, centerZ - radiusZ); z <= std::min(resolution.depth - 1, centerZ + radiusZ); ++z) {
             for (int y = std::max(0, centerY - radiusY); y <= std::min(resolution.height - 1, centerY + radiusY); ++y) {
                 for (int x = std::max(0, centerX - radiusX); x <= std::min(resolution.width - 1, centerX + radiusX); ++x) {
-                    const auto idx = cellIndex(x, y, z);
+                    const auto offset = tiles.offsetOf(x, y, z);
+                    if (offset < 0) {
+                        continue;
+                    }
+                    const auto idx = static_cast<std::size_t>(offset);
                     const float dx = (static_cast<float>(x) + 0.5f) * domain_.voxelSize + domain_.min.x - source.position.x;
                     const float dy = (static_cast<float>(y) + 0.5f) * domain_.voxelSize + domain_.min.y - source.position.y;
                     const float dz = (static_cast<float>(z) + 0.5f) * domain_.voxelSize + domain_.min.z - source.position.z;
@@ -701,47 +1610,76 @@ void PyroSimulation::integrateStep(float deltaSeconds) {
         }
     }
 
+    stepStats_.sourcesMs = elapsedMs(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
     applyCombustion(dt);
+    stepStats_.combustionMs = elapsedMs(stageStart);
 
-    Parallel::For(0, resolution.depth, resolution.width * resolution.height, [&](int z) {
-        for (int y = 0; y < resolution.height; ++y) {
-            for (int x = 0; x < resolution.width; ++x) {
-                const auto idx = cellIndex(x, y, z);
-                velocity.values[idx].y += temperature.values[idx] * settings_.buoyancy * dt;
-            }
-        }
+    stageStart = std::chrono::steady_clock::now();
+    forEachStoredCell(tiles, [&](std::size_t idx) {
+        velocity.values[idx].y += temperature.values[idx] * settings_.buoyancy * dt;
     });
 
     applyVorticityConfinement(dt);
+    stepStats_.forcesMs = elapsedMs(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
+    const auto densityPrev = fields_.densityStorage();
+    const auto temperaturePrev = fields_.temperatureStorage();
+    const auto fuelPrev = fields_.fuelStorage();
+    const auto velocityPrev = fields_.velocityStorage();
 
-    Parallel::For(0, resolution.depth, resolution.width * resolution.height, [&](int z) {
-        for (int y = 0; y < resolution.height; ++y) {
-            for (int x = 0; x < resolution.width; ++x) {
-                const auto idx = cellIndex(x, y, z);
-                const PyroVec3 pos{
-                    static_cast<float>(x),
-                    static_cast<float>(y),
-                    static_cast<float>(z)
-                };
-                const PyroVec3 backtrace{
-                    pos.x - velocity.values[idx].x * dt,
-                    pos.y - velocity.values[idx].y * dt,
-                    pos.z - velocity.values[idx].z * dt
-                };
-                density.values[idx] = fields_.sampleScalar({std::span<const float>(densityPrev), resolution}, backtrace, domain_.boundaryMode);
-                temperature.values[idx] = fields_.sampleScalar({std::span<const float>(temperaturePrev), resolution}, backtrace, domain_.boundaryMode);
-                fuel.values[idx] = fields_.sampleScalar({std::span<const float>(fuelPrev), resolution}, backtrace, domain_.boundaryMode);
-                velocity.values[idx] = fields_.sampleVector({std::span<const PyroVec3>(velocityPrev), resolution}, backtrace, domain_.boundaryMode);
-                divergence.values[idx] = 0.0f;
-                pressure.values[idx] = 0.0f;
+    forEachBrick(tiles, [&](std::size_t brick) {
+        const auto box = brickBox(tiles, brick);
+        const std::size_t base = brick * kTileCells;
+        forEachBrickCell(box, [&](int lx, int ly, int lz, std::size_t local) {
+            const auto idx = base + local;
+            const PyroVec3 pos{
+                static_cast<float>(box.x0 + lx),
+                static_cast<float>(box.y0 + ly),
+                static_cast<float>(box.z0 + lz)
+            };
+            const PyroVec3 backtrace{
+                pos.x - velocity.values[idx].x * dt,
+                pos.y - velocity.values[idx].y * dt,
+                pos.z - velocity.values[idx].z * dt
+            };
+            TrilinearTaps taps;
+            if (trilinearTaps(tiles, backtrace, domain_.boundaryMode, taps)) {
+                density.values[idx] = taps.sample(densityPrev.data());
+                temperature.values[idx] = taps.sample(temperaturePrev.data());
+                fuel.values[idx] = taps.sample(fuelPrev.data());
+                velocity.values[idx] = taps.sample(velocityPrev.data());
+            } else {
+                density.values[idx] = 0.0f;
+                temperature.values[idx] = 0.0f;
+                fuel.values[idx] = 0.0f;
+                velocity.values[idx] = {};
             }
-        }
+            divergence.values[idx] = 0.0f;
+            pressure.values[idx] = 0.0f;
+        });
     });
 
+    stepStats_.advectionMs = elapsedMs(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
     computeDivergence();
+    stepStats_.divergenceMs = elapsedMs(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
     solvePressure(std::max(1, static_cast<int>(settings_.pressureIterations)));
+    stepStats_.pressureMs = elapsedMs(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
     projectVelocity();
+    stepStats_.projectionMs = elapsedMs(stageStart);
+
+    stageStart = std::chrono::steady_clock::now();
     applyColliders();
+    stepStats_.collidersMs = elapsedMs(stageStart);
+    stepStats_.totalMs = elapsedMs(stepStart);
 }
 
 void PyroSimulation::step(double deltaSeconds) {
@@ -765,85 +1703,159 @@ void PyroSimulation::step(double deltaSeconds) {
 }
 
 void PyroSimulation::computeDivergence() {
-    const auto resolution = fields_.resolution();
+    const auto& tiles = fields_.tiles();
     auto divergence = fields_.divergenceView();
-    const auto velocity = fields_.velocityView();
-
-    Parallel::For(0, resolution.depth, resolution.width * resolution.height, [&](int z) {
-        for (int y = 0; y < resolution.height; ++y) {
-            for (int x = 0; x < resolution.width; ++x) {
-                const auto idx = cellIndex(x, y, z);
-                const int xm = std::max(0, x - 1);
-                const int xp = std::min(resolution.width - 1, x + 1);
-                const int ym = std::max(0, y - 1);
-                const int yp = std::min(resolution.height - 1, y + 1);
-                const int zm = std::max(0, z - 1);
-                const int zp = std::min(resolution.depth - 1, z + 1);
-                const PyroVec3 vxm = velocity.values[cellIndex(xm, y, z)];
-                const PyroVec3 vxp = velocity.values[cellIndex(xp, y, z)];
-                const PyroVec3 vym = velocity.values[cellIndex(x, ym, z)];
-                const PyroVec3 vyp = velocity.values[cellIndex(x, yp, z)];
-                const PyroVec3 vzm = velocity.values[cellIndex(x, y, zm)];
-                const PyroVec3 vzp = velocity.values[cellIndex(x, y, zp)];
-                divergence.values[idx] = ((vxp.x - vxm.x) + (vyp.y - vym.y) + (vzp.z - vzm.z)) * 0.5f;
+    const PyroVec3* velocity = fields_.velocityStorage().data();
+
+    forEachBrick(tiles, [&](std::size_t brick) {
+        const auto box = brickBox(tiles, brick);
+        const std::size_t base = brick * kTileCells;
+        forEachBrickRow(box, [&](int ly, int lz, std::size_t rowStart) {
+            const auto s = stencilRow(tiles, velocity, brick, box, ly, lz, true);
+            float* out = divergence.values.data() + base + rowStart;
+            for (int lx = 0; lx < box.nx; ++lx) {
+                const auto v = faceValues(s, lx, box.nx);
+                out[lx] = ((v.xp.x - v.xm.x) + (v.yp.y - v.ym.y) + (v.zp.z - v.zm.z)) * 0.5f;
             }
-        }
+        });
     });
 }
 
 void PyroSimulation::solvePressure(int iterations) {
-    const auto resolution = fields_.resolution();
-    auto pressure = fields_.pressureView();
-    const auto divergence = fields_.divergenceView();
-
-    for (int i = 0; i < iterations; ++i) {
-        for (int z = 0; z < resolution.depth; ++z) {
-            for (int y = 0; y < resolution.height; ++y) {
-                for (int x = 0; x < resolution.width; ++x) {
-                    const auto idx = cellIndex(x, y, z);
-                    const int xm = std::max(0, x - 1);
-                    const int xp = std::min(resolution.width - 1, x + 1);
-                    const int ym = std::max(0, y - 1);
-                    const int yp = std::min(resolution.height - 1, y + 1);
-                    const int zm = std::max(0, z - 1);
-                    const int zp = std::min(resolution.depth - 1, z + 1);
-                    const float neighborSum =
-                        pressure.values[cellIndex(xm, y, z)] +
-                        pressure.values[cellIndex(xp, y, z)] +
-                        pressure.values[cellIndex(x, ym, z)] +
-                        pressure.values[cellIndex(x, yp, z)] +
-                        pressure.values[cellIndex(x, y, zm)] +
-                        pressure.values[cellIndex(x, y, zp)];
-                    pressure.values[idx] = (divergence.values[idx] + neighborSum) / 6.0f;
-                }
+    stepStats_.pressureIterations = 0;
+    stepStats_.pressureResidual = 0.0f;
+    stepStats_.pressureConverged = true;
+    if (fields_.activeCellCount() == 0) {
+        return;
+    }
+    const auto& divergence = fields_.divergenceStorage();
+    const float* rhs = divergence.data();
+    if (!fields_.tiles().openFaces) {
+        auto& zeroMean = pressureWorkspace_.rhs;
+        zeroMean.assign(divergence.begin(), divergence.end());
+        removeMean(fields_.tiles(), zeroMean.data());
+        rhs = zeroMean.data();
+    }
+    if (settings_.pressureSolver == PyroPressureSolver::RedBlackGaussSeidel) {
+        solvePressureRedBlack(rhs, iterations);
+    } else {
+        solvePressureMultigridPCG(rhs, iterations);
+    }
+}
+
+void PyroSimulation::solvePressureRedBlack(const float* divergence, int iterations) {
+    const auto& tiles = fields_.tiles();
+    float* pressure = fields_.pressureStorage().data();
+    auto& residual = pressureWorkspace_.residual;
+    residual.assign(fields_.activeCellCount(), 0.0f);
+
+    const double rhsNorm = std::sqrt(dotProduct(tiles, divergence, divergence));
+    if (rhsNorm <= 0.0) {
+        return;
+    }
+    const double tolerance = std::max(0.0f, settings_.pressureTolerance) * rhsNorm;
+    constexpr int kResidualCheckInterval = 4;
+    double residualNorm = rhsNorm;
+    int sweep = 0;
+    while (sweep < iterations) {
+        relaxPressureColor(tiles, divergence, pressure, 0);
+        relaxPressureColor(tiles, divergence, pressure, 1);
+        ++sweep;
+        if (sweep % kResidualCheckInterval == 0 || sweep == iterations) {
+            computePressureResidual(tiles, divergence, pressure, residual.data());
+            residualNorm = std::sqrt(dotProduct(tiles, residual.data(), residual.data()));
+            if (residualNorm <= tolerance) {
+                break;
             }
         }
     }
+    stepStats_.pressureIterations = sweep;
+    stepStats_.pressureResidual = static_cast<float>(residualNorm / rhsNorm);
+    stepStats_.pressureConverged = residualNorm <= tolerance;
+}
+
+void PyroSimulation::solvePressureMultigridPCG(const float* divergence, int iterations) {
+    const auto& tiles = fields_.tiles();
+    const std::size_t count = fields_.activeCellCount();
+    buildPressureLevels(pressureWorkspace_, tiles);
+    float* pressure = fields_.pressureStorage().data();
+    float* residual = pressureWorkspace_.residual.data();
+    float* preconditioned = pressureWorkspace_.preconditioned.data();
+    float* direction = pressureWorkspace_.direction.data();
+    float* product = pressureWorkspace_.product.data();
+    const bool singular = !tiles.openFaces;
+
+    computePressureResidual(tiles, divergence, pressure, residual);
+    const double rhsNorm = std::sqrt(dotProduct(tiles, divergence, divergence));
+    double residualNorm = std::sqrt(dotProduct(tiles, residual, residual));
+    if (rhsNorm <= 0.0) {
+        return;
+    }
+    const double tolerance = std::max(0.0f, settings_.pressureTolerance) * rhsNorm;
+
+    pressureVCycle(pressureWorkspace_, 0, residual, preconditioned);
+    if (singular) {
+        removeMean(tiles, preconditioned);
+    }
+    std::copy(preconditioned, preconditioned + count, direction);
+    double rho = dotProduct(tiles, residual, preconditioned);
+
+    int iteration = 0;
+    while (iteration < iterations && residualNorm > tolerance) {
+        applyPressureOperator(tiles, direction, product);
+        const double curvature = dotProduct(tiles, direction, product);
+        if (!(curvature > 0.0)) {
+            break;
+        }
+        const float alpha = static_cast<float>(rho / curvature);
+        residualNorm = std::sqrt(sumOverBricks(tiles, [&](std::size_t begin, std::size_t end) {
+            double sum = 0.0;
+            for (std::size_t i = begin; i < end; ++i) {
+                pressure[i] += alpha * direction[i];
+                residual[i] -= alpha * product[i];
+                sum += static_cast<double>(residual[i]) * static_cast<double>(residual[i]);
+            }
+            return sum;
+        }));
+        ++iteration;
+        if (residualNorm <= tolerance) {
+            break;
+        }
+
+        pressureVCycle(pressureWorkspace_, 0, residual, preconditioned);
+        if (singular) {
+            removeMean(tiles, preconditioned);
+        }
+        const double rhoNext = dotProduct(tiles, residual, preconditioned);
+        const float beta = static_cast<float>(rhoNext / rho);
+        rho = rhoNext;
+        forEachStoredCell(tiles, [&](std::size_t i) {
+            direction[i] = preconditioned[i] + beta * direction[i];
+        });
+    }
+    stepStats_.pressureIterations = iteration;
+    stepStats_.pressureResidual = static_cast<float>(residualNorm / rhsNorm);
+    stepStats_.pressureConverged = residualNorm <= tolerance;
 }
 
 void PyroSimulation::projectVelocity() {
-    const auto resolution = fields_.resolution();
-    auto pressure = fields_.pressureView();
+    const auto& tiles = fields_.tiles();
+    const float* pressure = fields_.pressureStorage().data();
     auto velocity = fields_.velocityView();
 
-    Parallel::For(0, resolution.depth, resolution.width * resolution.height, [&](int z) {
-        for (int y = 0; y < resolution.height; ++y) {
-            for (int x = 0; x < resolution.width; ++x) {
-                const auto idx = cellIndex(x, y, z);
-                const int xm = std::max(0, x - 1);
-                const int xp = std::min(resolution.width - 1, x + 1);
-                const int ym = std::max(0, y - 1);
-                const int yp = std::min(resolution.height - 1, y + 1);
-                const int zm = std::max(0, z - 1);
-                const int zp = std::min(resolution.depth - 1, z + 1);
-                const float gradX = pressure.values[cellIndex(xp, y, z)] - pressure.values[cellIndex(xm, y, z)];
-                const float gradY = pressure.values[cellIndex(x, yp, z)] - pressure.values[cellIndex(x, ym, z)];
-                const float gradZ = pressure.values[cellIndex(x, y, zp)] - pressure.values[cellIndex(x, y, zm)];
-                velocity.values[idx].x -= gradX * 0.5f;
-                velocity.values[idx].y -= gradY * 0.5f;
-                velocity.values[idx].z -= gradZ * 0.5f;
+    forEachBrick(tiles, [&](std::size_t brick) {
+        const auto box = brickBox(tiles, brick);
+        const std::size_t base = brick * kTileCells;
+        forEachBrickRow(box, [&](int ly, int lz, std::size_t rowStart) {
+            const auto s = stencilRow(tiles, pressure, brick, box, ly, lz, true);
+            PyroVec3* out = velocity.values.data() + base + rowStart;
+            for (int lx = 0; lx < box.nx; ++lx) {
+                const auto p = faceValues(s, lx, box.nx);
+                out[lx].x -= (p.xp - p.xm) * 0.5f;
+                out[lx].y -= (p.yp - p.ym) * 0.5f;
+                out[lx].z -= (p.zp - p.zm) * 0.5f;
             }
-        }
+        });
     });
 }
 
@@ -884,6 +1896,14 @@ String toString(PyroBackendKind kind) {
     return "unknown";
 }
 
+String toString(PyroPressureSolver solver) {
+    switch (solver) {
+    case PyroPressureSolver::RedBlackGaussSeidel: return "red-black-gauss-seidel";
+    case PyroPressureSolver::MultigridPCG: return "multigrid-pcg";
+    }
+    return "unknown";
+}
+
 String toString(PyroFieldChannel channel) {
     switch (channel) {
     case PyroFieldChannel::Density: return "density";
@@ -899,6 +1919,7 @@ String toString(PyroFieldChannel channel) {
 
 std::uint64_t hashSettings(const PyroSimulationSettings& settings) noexcept {
     std::uint64_t seed = kFnvOffset;
+    hashAppend(seed, kSolverRevision);
     hashAppendFloat(seed, settings.sourceDensity);
     hashAppendFloat(seed, settings.sourceTemperature);
     hashAppendFloat(seed, settings.sourceFuel);
@@ -908,6 +1929,10 @@ std::uint64_t hashSettings(const PyroSimulationSettings& settings) noexcept {
     hashAppendFloat(seed, settings.vorticity);
     hashAppendFloat(seed, settings.pressureIterations);
     hashAppendFloat(seed, settings.advectionClamp);
+    hashAppend(seed, static_cast<std::uint64_t>(settings.pressureSolver));
+    hashAppendFloat(seed, settings.pressureTolerance);
+    hashAppend(seed, settings.sparseTiles ? 1u : 0u);
+    hashAppendFloat(seed, settings.activityThreshold);
     return seed;
 }
 